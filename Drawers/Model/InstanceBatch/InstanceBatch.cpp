@@ -0,0 +1,62 @@
+#include "InstanceBatch.h"
+#include <algorithm>
+#include <memory>
+#include <bit>
+
+InstanceBatch::InstanceBatch() :
+	instances(),
+	spheres(),
+	visibleInstances()
+{}
+
+void InstanceBatch::Push(const Mat4x4& worldMat, const Vector4& color, const Sphere& localSphere) {
+	auto& instance = instances.emplace_back();
+	instance.worldMat = MakeMatrixTransepose(worldMat);
+	instance.color = color;
+
+	spheres.push_back(HoriTransformSphere(localSphere, worldMat));
+}
+
+void InstanceBatch::Clear() {
+	instances.clear();
+	spheres.clear();
+	visibleInstances.clear();
+}
+
+std::span<const InstanceBatch::InstanceData> InstanceBatch::Cull(const Frustum& frustum) {
+	visibleInstances.clear();
+	if (instances.empty()) {
+		return visibleInstances;
+	}
+
+	auto isVisible = std::make_unique_for_overwrite<bool[]>(spheres.size());
+	frustum.CullSpheres(spheres, std::span<bool>(isVisible.get(), spheres.size()));
+
+	visibleInstances.reserve(instances.size());
+	for (size_t i = 0; i < instances.size(); i++) {
+		if (isVisible[i]) {
+			visibleInstances.push_back(instances[i]);
+		}
+	}
+
+	return visibleInstances;
+}
+
+uint32_t InstanceBatch::Write(std::span<const InstanceData> source, std::span<InstanceData> destination) {
+	const size_t writeNum = std::min(source.size(), destination.size());
+	std::copy_n(source.begin(), writeNum, destination.begin());
+
+	return static_cast<uint32_t>(writeNum);
+}
+
+InstanceBatch::BufferRange InstanceBatch::Allocate(uint32_t capacity, uint32_t usedNum, uint32_t instanceNum) {
+	if (usedNum + instanceNum <= capacity) {
+		return { usedNum, 0u };
+	}
+	// このフレームで詰めた分も含めて確保する
+	return { 0u, CalcCapacity(usedNum + instanceNum) };
+}
+
+uint32_t InstanceBatch::CalcCapacity(uint32_t instanceNum) {
+	return std::max(std::bit_ceil(instanceNum), kMinCapacity);
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include "Utils/Math/Mat4x4.h"
+#include "Utils/Math/Vector4.h"
+#include "Utils/Math/Bounds.h"
+#include "Utils/Math/Frustum.h"
+#include <vector>
+#include <span>
+#include <cstdint>
+
+/// <summary>
+/// インスタンシング描画用にインスタンスごとのデータを詰める(GPUには触らない)
+/// </summary>
+class InstanceBatch {
+public:
+	/// <summary>
+	/// シェーダーのStructuredBufferと同じ並び
+	/// </summary>
+	struct InstanceData {
+		// シェーダーに渡すので縦ベクトル用(横ベクトル用の転置)
+		Mat4x4 worldMat;
+		Vector4 color;
+	};
+
+	/// <summary>
+	/// 1フレームに何回も描画する時の、インスタンスバッファ上の書き込み位置
+	/// </summary>
+	struct BufferRange {
+		uint32_t offset = 0;
+		// 0でなければこの容量でバッファを作り直す(offsetは新しいバッファの先頭になり、前のバッファはフレームの終わりまで残す)
+		uint32_t newCapacity = 0;
+	};
+
+public:
+	InstanceBatch();
+	InstanceBatch(const InstanceBatch&) = default;
+	InstanceBatch(InstanceBatch&&) noexcept = default;
+	~InstanceBatch() = default;
+
+	InstanceBatch& operator=(const InstanceBatch&) = default;
+	InstanceBatch& operator=(InstanceBatch&&) noexcept = default;
+
+public:
+	/// <summary>
+	/// インスタンスを追加する
+	/// </summary>
+	/// <param name="worldMat">横ベクトル用のワールド行列</param>
+	/// <param name="color">色</param>
+	/// <param name="localSphere">メッシュのローカル座標での境界球(カリング用)</param>
+	void Push(const Mat4x4& worldMat, const Vector4& color, const Sphere& localSphere);
+
+	/// <summary>
+	/// 追加したインスタンスを全て消す(毎フレーム呼ぶ)
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// 視錐台の中にあるインスタンスだけを追加した順に詰める
+	/// </summary>
+	/// <returns>描画するインスタンス</returns>
+	std::span<const InstanceData> Cull(const Frustum& frustum);
+
+	/// <summary>
+	/// 書き込み先に入るだけコピーする
+	/// </summary>
+	/// <param name="source">Cull()で受け取ったインスタンス</param>
+	/// <param name="destination">書き込み先(マップしたバッファ)</param>
+	/// <returns>コピーした数</returns>
+	static uint32_t Write(std::span<const InstanceData> source, std::span<InstanceData> destination);
+
+	/// <summary>
+	/// このフレームで先頭からusedNum個使っている、capacity個入るバッファにinstanceNum個を書く位置を決める
+	/// (前の描画が使っている所は上書きしない。入らなければ、次のフレームから1本に収まる容量で作り直させる)
+	/// </summary>
+	static BufferRange Allocate(uint32_t capacity, uint32_t usedNum, uint32_t instanceNum);
+
+	/// <summary>
+	/// instanceNum個入るバッファの要素数(2の累乗に切り上げて作り直す回数を減らす)
+	/// </summary>
+	static uint32_t CalcCapacity(uint32_t instanceNum);
+
+	uint32_t GetInstanceNum() const {
+		return static_cast<uint32_t>(instances.size());
+	}
+
+	std::span<const InstanceData> GetInstances() const {
+		return instances;
+	}
+
+public:
+	static constexpr uint32_t kMinCapacity = 16u;
+
+private:
+	std::vector<InstanceData> instances;
+	// ワールド座標での境界球(instancesと同じ並び)
+	std::vector<Sphere> spheres;
+
+	std::vector<InstanceData> visibleInstances;
+};
+
+static_assert(sizeof(InstanceBatch::InstanceData) == sizeof(float) * 20, "InstanceData must match the shader struct");
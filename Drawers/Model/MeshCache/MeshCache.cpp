@@ -0,0 +1,393 @@
+#include "MeshCache.h"
+#include "Utils/CacheFile/CacheFile.h"
+#include <filesystem>
+#include <array>
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+#include <limits>
+#include <cstddef>
+
+namespace {
+	constexpr std::array<char, 4> kMagic = { 'M', 'E', 'S', 'H' };
+
+	struct FileHeader {
+		std::array<char, 4> magic;
+		uint32_t version;
+
+		// 元ファイルの情報(キャッシュが古くなっていないかの判定用)
+		uint64_t sourceSize;
+		int64_t sourceTime;
+		uint64_t sourceHash;
+
+		uint32_t vertexStride;
+		uint32_t submeshNum;
+		uint32_t mtlFileNum;
+		uint32_t stringTableSize;
+		uint32_t lodNum;
+		uint32_t meshletNum;
+
+		AABB aabb;
+		Sphere sphere;
+	};
+
+	struct SubmeshHeader {
+		uint32_t nameOffset;
+		uint32_t nameSize;
+		uint32_t vertexNum;
+		uint32_t indexNum;
+		uint32_t indexSize;
+		uint32_t lodFirst;
+		uint32_t lodNum;
+		uint32_t meshletFirst;
+		uint32_t meshletNum;
+		VertexCacheStatistics sourceVertexCache;
+		VertexCacheStatistics vertexCache;
+		uint64_t vertexOffset;
+		uint64_t indexOffset;
+	};
+
+	struct StringHeader {
+		uint32_t offset;
+		uint32_t size;
+	};
+
+	static_assert(std::is_trivially_copyable_v<FileHeader>);
+	static_assert(std::is_trivially_copyable_v<SubmeshHeader>);
+	static_assert(std::is_trivially_copyable_v<MeshCache::Lod>);
+	static_assert(std::is_trivially_copyable_v<VertexCacheStatistics>);
+	static_assert(sizeof(SubmeshHeader) % alignof(uint64_t) == 0);
+
+	template<class T>
+	bool Read(std::span<const std::byte> image, size_t offset, T& out) {
+		if (image.size() < offset || image.size() - offset < sizeof(T)) {
+			return false;
+		}
+		std::memcpy(&out, image.data() + offset, sizeof(T));
+		return true;
+	}
+}
+
+MeshCache::MeshCache() :
+	sourceFileName(),
+	file(),
+	image(),
+	submeshes(),
+	lods(),
+	meshlets(),
+	aabb(),
+	sphere(),
+	mtlFileNames()
+{}
+
+bool MeshCache::Load(const std::string& sourceFileName_, uint32_t vertexStride) {
+	Close();
+	sourceFileName = sourceFileName_;
+
+	if (!file.Open(GetCacheFileName(sourceFileName))) {
+		return false;
+	}
+
+	FileHeader header{};
+	if (!Read(file.GetData(), 0, header) || header.magic != kMagic || header.version != kVersion) {
+		Close();
+		return false;
+	}
+
+	int64_t sourceTime = header.sourceTime;
+	if (!IsSameSourceFile(sourceFileName, { header.sourceSize, header.sourceTime, header.sourceHash }, &sourceTime)) {
+		Close();
+		return false;
+	}
+
+	// 更新日時だけ変わっていた(ハッシュは同じ)なら、毎回ハッシュを取らないようにヘッダーの日時を書き換えて開き直す
+	// 書き換えられなくても今回は使えるので、失敗はそのまま開き直すだけにする
+	if (sourceTime != header.sourceTime) {
+		file.Close();
+		PatchCacheFile(GetCacheFileName(sourceFileName), offsetof(FileHeader, sourceTime), std::as_bytes(std::span<const int64_t>(&sourceTime, 1)));
+		if (!file.Open(GetCacheFileName(sourceFileName))) {
+			Close();
+			return false;
+		}
+	}
+
+	if (!Parse(file.GetData(), vertexStride)) {
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+bool MeshCache::Create(
+	const std::string& sourceFileName_,
+	uint32_t vertexStride,
+	std::span<const SubmeshSource> submeshSources,
+	const AABB& aabb_,
+	const Sphere& sphere_,
+	const std::vector<std::string>& mtlFileNames_
+) {
+	Close();
+	sourceFileName = sourceFileName_;
+
+	FileHeader header{};
+	header.magic = kMagic;
+	header.version = kVersion;
+	SourceFileInfo sourceInfo;
+	if (!GetSourceFileInfo(sourceFileName, sourceInfo)) {
+		return false;
+	}
+	header.sourceSize = sourceInfo.size;
+	header.sourceTime = sourceInfo.time;
+	header.sourceHash = sourceInfo.hash;
+	header.vertexStride = vertexStride;
+	header.submeshNum = static_cast<uint32_t>(submeshSources.size());
+	header.mtlFileNum = static_cast<uint32_t>(mtlFileNames_.size());
+	header.aabb = aabb_;
+	header.sphere = sphere_;
+
+	// 文字列をまとめる
+	std::string stringTable;
+	std::vector<SubmeshHeader> submeshHeaders(submeshSources.size());
+	std::vector<StringHeader> mtlHeaders(mtlFileNames_.size());
+	for (size_t i = 0; i < submeshSources.size(); i++) {
+		submeshHeaders[i].nameOffset = static_cast<uint32_t>(stringTable.size());
+		submeshHeaders[i].nameSize = static_cast<uint32_t>(submeshSources[i].name.size());
+		stringTable += submeshSources[i].name;
+	}
+	for (size_t i = 0; i < mtlFileNames_.size(); i++) {
+		mtlHeaders[i].offset = static_cast<uint32_t>(stringTable.size());
+		mtlHeaders[i].size = static_cast<uint32_t>(mtlFileNames_[i].size());
+		stringTable += mtlFileNames_[i];
+	}
+	header.stringTableSize = static_cast<uint32_t>(stringTable.size());
+
+	// 詳細度をまとめる
+	std::vector<Lod> lodTable;
+	for (size_t i = 0; i < submeshSources.size(); i++) {
+		const auto& source = submeshSources[i];
+		submeshHeaders[i].lodFirst = static_cast<uint32_t>(lodTable.size());
+		if (source.lods.empty()) {
+			lodTable.push_back({ 0u, static_cast<uint32_t>(source.indices.size()), 0.0f });
+		}
+		else {
+			lodTable.insert(lodTable.end(), source.lods.begin(), source.lods.end());
+		}
+		submeshHeaders[i].lodNum = static_cast<uint32_t>(lodTable.size()) - submeshHeaders[i].lodFirst;
+	}
+	header.lodNum = static_cast<uint32_t>(lodTable.size());
+
+	std::vector<Meshlet> meshletTable;
+	for (size_t i = 0; i < submeshSources.size(); i++) {
+		submeshHeaders[i].meshletFirst = static_cast<uint32_t>(meshletTable.size());
+		submeshHeaders[i].meshletNum = static_cast<uint32_t>(submeshSources[i].meshlets.size());
+		meshletTable.insert(meshletTable.end(), submeshSources[i].meshlets.begin(), submeshSources[i].meshlets.end());
+	}
+	header.meshletNum = static_cast<uint32_t>(meshletTable.size());
+
+	// 頂点とインデックスの配置を決める
+	size_t offset = sizeof(FileHeader)
+		+ sizeof(SubmeshHeader) * submeshHeaders.size()
+		+ sizeof(Lod) * lodTable.size()
+		+ sizeof(Meshlet) * meshletTable.size()
+		+ sizeof(StringHeader) * mtlHeaders.size()
+		+ stringTable.size();
+	for (size_t i = 0; i < submeshSources.size(); i++) {
+		const auto& source = submeshSources[i];
+		auto& submeshHeader = submeshHeaders[i];
+
+		submeshHeader.vertexNum = source.vertexNum;
+		submeshHeader.indexNum = static_cast<uint32_t>(source.indices.size());
+		submeshHeader.indexSize = source.vertexNum <= std::numeric_limits<uint16_t>::max() ? sizeof(uint16_t) : sizeof(uint32_t);
+		submeshHeader.sourceVertexCache = source.sourceVertexCache;
+		submeshHeader.vertexCache = source.vertexCache;
+
+		offset = AlignUp(offset, kBlobAlignment);
+		submeshHeader.vertexOffset = offset;
+		offset += source.vertices.size();
+
+		offset = AlignUp(offset, kBlobAlignment);
+		submeshHeader.indexOffset = offset;
+		offset += static_cast<size_t>(submeshHeader.indexSize) * submeshHeader.indexNum;
+	}
+
+	// 書き込む
+	image.assign(offset, std::byte{ 0 });
+	size_t writeOffset = 0;
+	auto write = [this, &writeOffset](const void* src, size_t size) {
+		if (size != 0) {
+			std::memcpy(image.data() + writeOffset, src, size);
+		}
+		writeOffset += size;
+	};
+	write(&header, sizeof(header));
+	write(submeshHeaders.data(), sizeof(SubmeshHeader) * submeshHeaders.size());
+	write(lodTable.data(), sizeof(Lod) * lodTable.size());
+	write(meshletTable.data(), sizeof(Meshlet) * meshletTable.size());
+	write(mtlHeaders.data(), sizeof(StringHeader) * mtlHeaders.size());
+	write(stringTable.data(), stringTable.size());
+
+	for (size_t i = 0; i < submeshSources.size(); i++) {
+		const auto& source = submeshSources[i];
+		const auto& submeshHeader = submeshHeaders[i];
+
+		std::memcpy(image.data() + submeshHeader.vertexOffset, source.vertices.data(), source.vertices.size());
+
+		std::byte* indexDst = image.data() + submeshHeader.indexOffset;
+		if (submeshHeader.indexSize == sizeof(uint16_t)) {
+			for (size_t j = 0; j < source.indices.size(); j++) {
+				uint16_t index = static_cast<uint16_t>(source.indices[j]);
+				std::memcpy(indexDst + j * sizeof(uint16_t), &index, sizeof(uint16_t));
+			}
+		}
+		else {
+			std::memcpy(indexDst, source.indices.data(), source.indices.size_bytes());
+		}
+	}
+
+	if (!Parse(image, vertexStride)) {
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+bool MeshCache::Save() const {
+	return SaveCacheFile(GetCacheFileName(sourceFileName), image);
+}
+
+void MeshCache::Close() {
+	file.Close();
+	image.clear();
+	submeshes.clear();
+	lods.clear();
+	meshlets.clear();
+	aabb = AABB();
+	sphere = Sphere();
+	mtlFileNames.clear();
+}
+
+std::string MeshCache::GetCacheFileName(const std::string& sourceFileName) {
+	std::filesystem::path path = sourceFileName;
+	path.replace_extension(".mesh");
+	return path.string();
+}
+
+bool MeshCache::Parse(std::span<const std::byte> data, uint32_t vertexStride) {
+	FileHeader header{};
+	if (!Read(data, 0, header) || header.vertexStride != vertexStride) {
+		return false;
+	}
+
+	size_t offset = sizeof(FileHeader);
+	std::vector<SubmeshHeader> submeshHeaders(header.submeshNum);
+	for (auto& i : submeshHeaders) {
+		if (!Read(data, offset, i)) {
+			return false;
+		}
+		offset += sizeof(SubmeshHeader);
+	}
+	lods.resize(header.lodNum);
+	for (auto& i : lods) {
+		if (!Read(data, offset, i)) {
+			lods.clear();
+			return false;
+		}
+		offset += sizeof(Lod);
+	}
+	meshlets.resize(header.meshletNum);
+	for (auto& i : meshlets) {
+		if (!Read(data, offset, i)) {
+			lods.clear();
+			meshlets.clear();
+			return false;
+		}
+		offset += sizeof(Meshlet);
+	}
+	std::vector<StringHeader> mtlHeaders(header.mtlFileNum);
+	for (auto& i : mtlHeaders) {
+		if (!Read(data, offset, i)) {
+			return false;
+		}
+		offset += sizeof(StringHeader);
+	}
+
+	if (data.size() < offset || data.size() - offset < header.stringTableSize) {
+		return false;
+	}
+	std::string_view stringTable(reinterpret_cast<const char*>(data.data() + offset), header.stringTableSize);
+
+	auto isInside = [&data](uint64_t blobOffset, uint64_t blobSize) {
+		return blobOffset <= data.size() && blobSize <= data.size() - blobOffset;
+	};
+
+	submeshes.resize(header.submeshNum);
+	for (size_t i = 0; i < submeshHeaders.size(); i++) {
+		const auto& submeshHeader = submeshHeaders[i];
+		uint64_t vertexSize = static_cast<uint64_t>(submeshHeader.vertexNum) * vertexStride;
+		uint64_t indexSize = static_cast<uint64_t>(submeshHeader.indexNum) * submeshHeader.indexSize;
+		if (stringTable.size() < static_cast<uint64_t>(submeshHeader.nameOffset) + submeshHeader.nameSize
+			|| !isInside(submeshHeader.vertexOffset, vertexSize)
+			|| !isInside(submeshHeader.indexOffset, indexSize)
+			|| (submeshHeader.indexSize != sizeof(uint16_t) && submeshHeader.indexSize != sizeof(uint32_t))
+			|| submeshHeader.lodNum == 0
+			|| lods.size() < static_cast<uint64_t>(submeshHeader.lodFirst) + submeshHeader.lodNum
+			|| meshlets.size() < static_cast<uint64_t>(submeshHeader.meshletFirst) + submeshHeader.meshletNum
+		) {
+			submeshes.clear();
+			lods.clear();
+			meshlets.clear();
+			return false;
+		}
+
+		auto submeshLods = std::span<const Lod>(lods).subspan(submeshHeader.lodFirst, submeshHeader.lodNum);
+		for (auto& lod : submeshLods) {
+			if (submeshHeader.indexNum < static_cast<uint64_t>(lod.indexOffset) + lod.indexNum) {
+				submeshes.clear();
+				lods.clear();
+				meshlets.clear();
+				return false;
+			}
+		}
+
+		auto submeshMeshlets = std::span<const Meshlet>(meshlets).subspan(submeshHeader.meshletFirst, submeshHeader.meshletNum);
+		for (auto& meshlet : submeshMeshlets) {
+			if (submeshLods.front().indexNum < static_cast<uint64_t>(meshlet.indexOffset) + static_cast<uint64_t>(meshlet.triangleNum) * 3) {
+				submeshes.clear();
+				lods.clear();
+				meshlets.clear();
+				return false;
+			}
+		}
+
+		auto& submesh = submeshes[i];
+		submesh.name = stringTable.substr(submeshHeader.nameOffset, submeshHeader.nameSize);
+		submesh.vertices = data.subspan(static_cast<size_t>(submeshHeader.vertexOffset), static_cast<size_t>(vertexSize));
+		submesh.vertexNum = submeshHeader.vertexNum;
+		submesh.indices = data.subspan(static_cast<size_t>(submeshHeader.indexOffset), static_cast<size_t>(indexSize));
+		submesh.indexNum = submeshHeader.indexNum;
+		submesh.isIndex16 = submeshHeader.indexSize == sizeof(uint16_t);
+		submesh.lods = submeshLods;
+		submesh.meshlets = submeshMeshlets;
+		submesh.sourceVertexCache = submeshHeader.sourceVertexCache;
+		submesh.vertexCache = submeshHeader.vertexCache;
+	}
+
+	mtlFileNames.resize(header.mtlFileNum);
+	for (size_t i = 0; i < mtlHeaders.size(); i++) {
+		if (stringTable.size() < static_cast<uint64_t>(mtlHeaders[i].offset) + mtlHeaders[i].size) {
+			submeshes.clear();
+			lods.clear();
+			meshlets.clear();
+			mtlFileNames.clear();
+			return false;
+		}
+		mtlFileNames[i] = stringTable.substr(mtlHeaders[i].offset, mtlHeaders[i].size);
+	}
+
+	aabb = header.aabb;
+	sphere = header.sphere;
+
+	return true;
+}
@@ -0,0 +1,165 @@
+#pragma once
+#include "Utils/MappedFile/MappedFile.h"
+#include "Utils/Math/Bounds.h"
+#include "Utils/MeshOptimizer/Meshlet.h"
+#include "Utils/MeshOptimizer/MeshOptimizer.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <span>
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// objから変換したメッシュのバイナリキャッシュ
+/// ファイルの構成 : ヘッダー | サブメッシュ表 | LOD表 | メッシュレット表 | mtlファイル表 | 文字列 | 頂点、インデックス(それぞれkBlobAlignmentに揃える)
+/// 読み込み時はファイルをマップして、コピーせずに頂点とインデックスのspanを返す
+/// 元ファイルのサイズと更新日時が変わっていて、中身のハッシュも違う場合は無効になる
+/// </summary>
+class MeshCache {
+public:
+	/// <summary>
+	/// 詳細度ごとのインデックスの範囲(全ての詳細度で頂点は共有する)
+	/// </summary>
+	struct Lod {
+		uint32_t indexOffset = 0;
+		uint32_t indexNum = 0;
+		/// <summary>
+		/// 元の形状との誤差(ローカル座標の距離)
+		/// </summary>
+		float error = 0.0f;
+	};
+
+	/// <summary>
+	/// キャッシュに入っているサブメッシュ(マテリアルごとのメッシュ)
+	/// </summary>
+	struct Submesh {
+		std::string_view name;
+		std::span<const std::byte> vertices;
+		uint32_t vertexNum = 0;
+		std::span<const std::byte> indices;
+		uint32_t indexNum = 0;
+		bool isIndex16 = false;
+		// 0番が元の形状で、後ろほど粗い
+		std::span<const Lod> lods;
+		// 0番のLODを分けたもの(無ければ空)
+		std::span<const Meshlet> meshlets;
+		// 0番のLODの頂点キャッシュの効率(並び替える前と後)
+		VertexCacheStatistics sourceVertexCache;
+		VertexCacheStatistics vertexCache;
+	};
+
+	/// <summary>
+	/// キャッシュを作るためのサブメッシュ
+	/// </summary>
+	struct SubmeshSource {
+		std::string name;
+		std::span<const std::byte> vertices;
+		uint32_t vertexNum = 0;
+		// 全ての詳細度のインデックスをつなげたもの
+		std::span<const uint32_t> indices;
+		// 空ならindices全体を1つの詳細度にする
+		std::span<const Lod> lods;
+		// 0番のLODの範囲を分けたもの
+		std::span<const Meshlet> meshlets;
+		// 0番のLODの頂点キャッシュの効率(並び替える前と後)
+		VertexCacheStatistics sourceVertexCache;
+		VertexCacheStatistics vertexCache;
+	};
+
+public:
+	/// <summary>
+	/// 形式が変わったら上げる
+	/// </summary>
+	static constexpr uint32_t kVersion = 5;
+	/// <summary>
+	/// 頂点、インデックスの先頭の揃え(アップロードバッファにそのままコピーできるように)
+	/// </summary>
+	static constexpr size_t kBlobAlignment = 256;
+
+public:
+	MeshCache();
+	MeshCache(const MeshCache&) = delete;
+	MeshCache(MeshCache&&) noexcept = default;
+	~MeshCache() = default;
+
+	MeshCache& operator=(const MeshCache&) = delete;
+	MeshCache& operator=(MeshCache&&) noexcept = default;
+
+public:
+	/// <summary>
+	/// 元ファイルに対応するキャッシュファイルを開く
+	/// </summary>
+	/// <param name="sourceFileName">元のobjファイルパス</param>
+	/// <param name="vertexStride">1頂点のサイズ(違っていたら無効)</param>
+	/// <returns>有効なキャッシュが読めたか</returns>
+	bool Load(const std::string& sourceFileName, uint32_t vertexStride);
+
+	/// <summary>
+	/// メモリ上にキャッシュを作る(Save()でファイルに書き出せる)
+	/// </summary>
+	/// <param name="sourceFileName">元のobjファイルパス(更新日時とハッシュを記録する)</param>
+	/// <param name="vertexStride">1頂点のサイズ</param>
+	/// <param name="submeshes">サブメッシュ</param>
+	/// <param name="aabb">モデル全体のAABB</param>
+	/// <param name="sphere">モデル全体の境界球</param>
+	/// <param name="mtlFileNames">mtllibで指定されたファイル名</param>
+	/// <returns>成功したか</returns>
+	bool Create(
+		const std::string& sourceFileName,
+		uint32_t vertexStride,
+		std::span<const SubmeshSource> submeshes,
+		const AABB& aabb,
+		const Sphere& sphere,
+		const std::vector<std::string>& mtlFileNames
+	);
+
+	/// <summary>
+	/// Create()で作ったキャッシュをファイルに書き出す
+	/// </summary>
+	/// <returns>成功したか</returns>
+	bool Save() const;
+
+	void Close();
+
+public:
+	const std::vector<Submesh>& GetSubmeshes() const {
+		return submeshes;
+	}
+	const AABB& GetAABB() const {
+		return aabb;
+	}
+	const Sphere& GetSphere() const {
+		return sphere;
+	}
+	const std::vector<std::string>& GetMtlFileNames() const {
+		return mtlFileNames;
+	}
+
+	/// <summary>
+	/// 元ファイルに対応するキャッシュファイル名(拡張子を.meshにする)
+	/// </summary>
+	static std::string GetCacheFileName(const std::string& sourceFileName);
+
+private:
+	/// <summary>
+	/// ファイルの中身を解析してspanを作る
+	/// </summary>
+	bool Parse(std::span<const std::byte> image, uint32_t vertexStride);
+
+private:
+	std::string sourceFileName;
+
+	MappedFile file;
+	/// <summary>
+	/// Create()で作ったときのファイルの中身
+	/// </summary>
+	std::vector<std::byte> image;
+
+	std::vector<Submesh> submeshes;
+	std::vector<Lod> lods;
+	std::vector<Meshlet> meshlets;
+	AABB aabb;
+	Sphere sphere;
+	std::vector<std::string> mtlFileNames;
+};
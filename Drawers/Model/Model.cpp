@@ -1,16 +1,27 @@
 #include "Model.h"
 #include "Engine/Engine.h"
-#include <fstream>
-#include <sstream>
-#include <vector>
 #include <algorithm>
 #include <cassert>
 #include <numbers>
-#include <filesystem>
+#include <cmath>
 #include "Engine/ConvertString/ConvertString.h"
 #include "Engine/ShaderManager/ShaderManager.h"
 #include "externals/imgui/imgui.h"
 #include "Engine/ErrorCheck/ErrorCheck.h"
+#include "Utils/Math/Frustum.h"
+#include "Utils/MeshOptimizer/MeshSimplifier.h"
+#include "Engine/WinApp/WinApp.h"
+#include <chrono>
+#include <random>
+
+namespace {
+	/// <summary>
+	/// 境界球のカメラに一番近い所で、ローカル座標の1単位が画面上で何ピクセルになるか
+	/// </summary>
+	float CalcPixelPerLocalUnit(const Mat4x4& viewProjectionMat, const Sphere& localSphere, const Mat4x4& worldMat) {
+		return TextureStreamer::CalcPixelPerLocalUnit(viewProjectionMat, localSphere, worldMat, WinApp::GetInstance()->GetWindowSize().y);
+	}
+}
 
 
 Model::Model() :
@@ -19,19 +30,35 @@ Model::Model() :
 	scale(Vector3::identity),
 	color(0xffffffff),
 	parent(nullptr),
-	meshData(),
+	transform(),
+	mesh(nullptr),
+	lod(0u),
+	isMeshletCulling(true),
+	meshletNum(0u),
+	visibleMeshletNum(0u),
+	raycastPerSecond(0.0),
+	raycastHitRate(0.0f),
 	shader(),
 	pipeline(nullptr),
 	loadObjFlg(false),
 	loadShaderFlg(false),
 	createGPFlg(false),
+	createGPReserveFlg(false),
 	wvpData(),
 	dirLig(),
 	colorBuf(),
-	SRVHeap(),
-	tex(0),
 	drawIndexNumber(0),
-	maxDrawIndex(1)
+	maxDrawIndex(1),
+	instancingPipeline(nullptr),
+	instanceBatch(),
+	instanceBuffer(),
+	instanceMap(nullptr),
+	instanceCapacity(0u),
+	instanceOffset(0u),
+	retiredInstanceBuffers(),
+	instancingWvpData(1),
+	instancingDirLig(1),
+	instancingDrawIndex(0u)
 {
 	wvpData.resize(maxDrawIndex);
 	for (auto& i : wvpData) {
@@ -58,6 +85,11 @@ Model::Model() :
 		i.shaderRegister = 2;
 		*i = UintToVector4(color);
 	}
+
+	instancingWvpData.front().shaderRegister = 0;
+	instancingWvpData.front()->worldMat = MakeMatrixIndentity();
+	instancingWvpData.front()->viewProjectoionMat = MakeMatrixIndentity();
+	instancingDirLig.front().shaderRegister = 1;
 }
 
 Model::Model(UINT maxDrawIndex_) :
@@ -66,19 +98,35 @@ Model::Model(UINT maxDrawIndex_) :
 	scale(Vector3::identity),
 	color(0xffffffff),
 	parent(nullptr),
-	meshData(),
+	transform(),
+	mesh(nullptr),
+	lod(0u),
+	isMeshletCulling(true),
+	meshletNum(0u),
+	visibleMeshletNum(0u),
+	raycastPerSecond(0.0),
+	raycastHitRate(0.0f),
 	shader(),
 	pipeline(nullptr),
 	loadObjFlg(false),
 	loadShaderFlg(false),
 	createGPFlg(false),
+	createGPReserveFlg(false),
 	wvpData(),
 	dirLig(),
 	colorBuf(),
-	SRVHeap(),
-	tex(0),
 	drawIndexNumber(0),
-	maxDrawIndex(maxDrawIndex_)
+	maxDrawIndex(maxDrawIndex_),
+	instancingPipeline(nullptr),
+	instanceBatch(),
+	instanceBuffer(),
+	instanceMap(nullptr),
+	instanceCapacity(0u),
+	instanceOffset(0u),
+	retiredInstanceBuffers(),
+	instancingWvpData(1),
+	instancingDirLig(1),
+	instancingDrawIndex(0u)
 {
 	if (maxDrawIndex < 1) {
 		maxDrawIndex = 1;
@@ -109,184 +157,119 @@ Model::Model(UINT maxDrawIndex_) :
 		i.shaderRegister = 2;
 		*i = UintToVector4(color);
 	}
-}
-
-void Model::LoadObj(const std::string& fileName) {
-	if (!loadObjFlg) {
-		std::ifstream objFile(fileName);
-		assert(objFile);
-		if (!objFile) {
-			ErrorCheck::GetInstance()->ErrorTextBox("LoadObj() : Not found objFile : " + fileName, "Model");
-			return;
-		}
-
-		std::vector<Vector4> posDatas(0);
 
-		std::vector<Vector3> normalDatas(0);
-
-		std::vector<Vector2> uvDatas(0);
-
-		std::unordered_map<std::string, std::vector<IndexData>> indexDatas(0);
-		std::unordered_map<std::string, std::vector<IndexData>>::iterator indicesItr;
+	instancingWvpData.front().shaderRegister = 0;
+	instancingWvpData.front()->worldMat = MakeMatrixIndentity();
+	instancingWvpData.front()->viewProjectoionMat = MakeMatrixIndentity();
+	instancingDirLig.front().shaderRegister = 1;
+}
 
-		std::string lineBuf;
+Model::Model(const Model& right) :
+	pos(right.pos),
+	rotate(right.rotate),
+	scale(right.scale),
+	color(right.color),
+	parent(right.parent),
+	transform(right.transform),
+	mesh(nullptr),
+	lod(right.lod),
+	isMeshletCulling(right.isMeshletCulling),
+	meshletNum(0u),
+	visibleMeshletNum(0u),
+	raycastPerSecond(0.0),
+	raycastHitRate(0.0f),
+	shader(right.shader),
+	pipeline(right.pipeline),
+	loadObjFlg(false),
+	loadShaderFlg(right.loadShaderFlg),
+	createGPFlg(right.createGPFlg),
+	createGPReserveFlg(right.createGPReserveFlg),
+	wvpData(right.wvpData),
+	dirLig(right.dirLig),
+	colorBuf(right.colorBuf),
+	drawIndexNumber(right.drawIndexNumber),
+	maxDrawIndex(right.maxDrawIndex),
+	instancingPipeline(right.instancingPipeline),
+	instanceBatch(right.instanceBatch),
+	instanceBuffer(),
+	instanceMap(nullptr),
+	instanceCapacity(0u),
+	instanceOffset(0u),
+	retiredInstanceBuffers(),
+	instancingWvpData(1),
+	instancingDirLig(1),
+	instancingDrawIndex(0u)
+{
+	// 読み込み中でも待たずに同じメッシュを共有する
+	if (right.mesh) {
+		LoadObjAsync(right.mesh->GetFileName());
+	}
 
-		while (std::getline(objFile, lineBuf)) {
-			std::string identifier;
-			std::istringstream line(lineBuf);
-			line >> identifier;
-			if (identifier == "v") {
-				Vector4 buf;
-				line >> buf.vec.x >> buf.vec.y >> buf.vec.z;
-				buf.vec.x *= -1.0f;
-				buf.vec.w = 1.0f;
+	// インスタンスのバッファはDrawInstancing()で作る
+	instancingWvpData.front().shaderRegister = 0;
+	*instancingWvpData.front() = *right.instancingWvpData.front();
+	instancingDirLig.front().shaderRegister = 1;
+	*instancingDirLig.front() = *right.instancingDirLig.front();
+}
 
-				posDatas.push_back(buf);
-			}
-			else if (identifier == "vn") {
-				Vector3 buf;
-				line >> buf.x >> buf.y >> buf.z;
-				buf.x *= -1.0f;
-				normalDatas.push_back(buf);
-			}
-			else if (identifier == "vt") {
-				Vector2 buf;
-				line >> buf.x >> buf.y;
-				buf.y = 1.0f - buf.y;
-				uvDatas.push_back(buf);
-			}
-			else if (identifier == "f") {
-				std::string buf;
-				std::vector<float> posBuf(0);
-				std::array<IndexData, 3> indcoes;
-				auto idnexItr = indcoes.rbegin();
-				while (std::getline(line, buf, ' '))
-				{
-					/// 0:vertexNumber 1:textureCoordinate 2:NormalNumber
-					std::string num[3];
-					int32_t count = 0;
-					if (std::any_of(buf.cbegin(), buf.cend(), isdigit)) {
-						for (auto& ch : buf) {
-							if (ch == '/') {
-								count++;
-							}
-							else { num[count] += ch; }
-						}
-					}
-
-					// エラーチェック
-					if (idnexItr == indcoes.rend()) {
-						//assert(!"Obj Load Error : Cannot Load Rectangles or more");
-						ErrorCheck::GetInstance()->ErrorTextBox("LoadObj() : Not supported for rectangles or more", "Model");
-						objFile.close();
-						return;
-					}
-
-					if (count == 2) {
-						idnexItr->vertNum = static_cast<uint32_t>(std::stoi(num[0]) - 1);
-						idnexItr->uvNum = static_cast<uint32_t>(std::stoi(num[1]) - 1);
-						idnexItr->normalNum = static_cast<uint32_t>(std::stoi(num[2]) - 1);
-						idnexItr++;
-					}
-					else if (count == 1) {
-						idnexItr->vertNum = static_cast<uint32_t>(std::stoi(num[0]) - 1);
-						idnexItr->normalNum = static_cast<uint32_t>(std::stoi(num[1]) - 1);
-						idnexItr++;
-					}
-				}
-				for (auto& i : indcoes) {
-					indicesItr->second.push_back(i);
-				}
-			}
-			else if (identifier == "usemtl") {
-				std::string useMtlName;
-				line >> useMtlName;
-				indexDatas.insert({ useMtlName,std::vector<IndexData>(0) });
-				indicesItr = indexDatas.find(useMtlName);
-				meshData[useMtlName];
-			}
-			else if (identifier == "mtllib") {
-				std::string mtlFileName;
-				std::filesystem::path path = fileName;
+Model& Model::operator=(const Model& right) {
+	if (this == &right) {
+		return *this;
+	}
 
-				line >> mtlFileName;
+	// 先に参照を増やしてから手放す
+	Mesh* rightMesh = right.mesh ? MeshManager::GetInstance()->LoadObjAsync(right.mesh->GetFileName()) : nullptr;
+	if (mesh) {
+		MeshManager::GetInstance()->ReleaseObj(mesh);
+	}
+	mesh = rightMesh;
+	loadObjFlg = static_cast<bool>(mesh);
+	lod = right.lod;
+	isMeshletCulling = right.isMeshletCulling;
+
+	pos = right.pos;
+	rotate = right.rotate;
+	scale = right.scale;
+	color = right.color;
+	parent = right.parent;
+	transform = right.transform;
+	shader = right.shader;
+	pipeline = right.pipeline;
+	loadShaderFlg = right.loadShaderFlg;
+	createGPFlg = right.createGPFlg;
+	createGPReserveFlg = right.createGPReserveFlg;
+	wvpData = right.wvpData;
+	dirLig = right.dirLig;
+	colorBuf = right.colorBuf;
+	drawIndexNumber = right.drawIndexNumber;
+	maxDrawIndex = right.maxDrawIndex;
+	instancingPipeline = right.instancingPipeline;
+	instanceBatch = right.instanceBatch;
+	*instancingWvpData.front() = *right.instancingWvpData.front();
+	*instancingDirLig.front() = *right.instancingDirLig.front();
+
+	return *this;
+}
 
-				LoadMtl(path.parent_path().string() + "/" + mtlFileName);
-			}
+void Model::LoadObj(const std::string& fileName) {
+	if (!loadObjFlg) {
+		mesh = MeshManager::GetInstance()->LoadObj(fileName);
+		if (!mesh) {
+			return;
 		}
-		objFile.close();
-
-		for (auto i : indexDatas) {
-			meshData[i.first].vertexBuffer = Engine::CreateBufferResuorce(sizeof(VertData) * indexDatas[i.first].size());
-			assert(meshData[i.first].vertexBuffer);
-
-
-			// リソースの先頭のアドレスから使う
-			meshData[i.first].vertexView.BufferLocation = meshData[i.first].vertexBuffer->GetGPUVirtualAddress();
-			// 使用するリソースのサイズは頂点3つ分のサイズ
-			meshData[i.first].vertexView.SizeInBytes = static_cast<UINT>(sizeof(VertData) * indexDatas[i.first].size());
-			// 1頂点当たりのサイズ
-			meshData[i.first].vertexView.StrideInBytes = sizeof(VertData);
-
-			// 頂点リソースにデータを書き込む
-			meshData[i.first].vertexMap = nullptr;
-			// 書き込むためのアドレスを取得
-			meshData[i.first].vertexBuffer->Map(0, nullptr, reinterpret_cast<void**>(&meshData[i.first].vertexMap));
-
-			for (int32_t j = 0; j < indexDatas[i.first].size(); j++) {
-				meshData[i.first].vertexMap[j].position = posDatas[indexDatas[i.first][j].vertNum];
-				meshData[i.first].vertexMap[j].normal = normalDatas[indexDatas[i.first][j].normalNum];
-				if (!uvDatas.empty()) {
-					meshData[i.first].vertexMap[j].uv = uvDatas[indexDatas[i.first][j].uvNum];
-				}
-			}
-
 
-			meshData[i.first].vertNum = static_cast<uint32_t>(indexDatas[i.first].size());
-		}
 		loadObjFlg = true;
 	}
 }
 
-void Model::LoadMtl(const std::string fileName) {
-	std::ifstream file(fileName);
-	assert(file);
-	if (!file) { ErrorCheck::GetInstance()->ErrorTextBox("LoadMtl() : Not Found mtlFile", "Model"); }
-
-	std::string lineBuf;
-	std::unordered_map<std::string, Texture*>::iterator texItr;
-	std::unordered_map<std::string, ShaderResourceHeap>::iterator hepaItr;
-
-	std::string useMtlName;
-	while (std::getline(file, lineBuf)) {
-		std::string identifier;
-		std::istringstream line(lineBuf);
-
-		line >> identifier;
-		if (identifier == "map_Kd") {
-			std::string texName;
-			std::filesystem::path path = fileName;
-
-			line >> texName;
-
-			texItr->second = TextureManager::GetInstance()->LoadTexture(path.parent_path().string() + "/" + texName);
-			hepaItr->second.CreateTxtureView(texItr->second);
-		}
-		else if (identifier == "newmtl") {
-			line >> useMtlName;
-			tex.insert({ useMtlName, nullptr });
-			texItr = tex.find(useMtlName);
-			SRVHeap.insert({ useMtlName , ShaderResourceHeap() });
-			hepaItr = SRVHeap.find(useMtlName);
-			hepaItr->second.InitializeReset(16);
+void Model::LoadObjAsync(const std::string& fileName) {
+	if (!loadObjFlg) {
+		mesh = MeshManager::GetInstance()->LoadObjAsync(fileName);
+		if (!mesh) {
+			return;
 		}
-	}
 
-	for (auto& i : tex) {
-		if (i.second == nullptr || !(*i.second)) {
-			i.second = TextureManager::GetInstance()->GetWhiteTex();
-			SRVHeap[i.first].CreateTxtureView(i.second);
-		}
+		loadObjFlg = true;
 	}
 }
 
@@ -313,8 +296,15 @@ void Model::LoadShader(
 
 void Model::CreateGraphicsPipeline() {
 	if (loadShaderFlg && loadObjFlg) {
+		// ルートシグネチャにメッシュのテクスチャのパラメーターが要るので、読み込みが終わるまで後回しにする
+		if (!IsLoadObjFinish()) {
+			createGPReserveFlg = true;
+			return;
+		}
+		createGPReserveFlg = false;
+
 		std::array<D3D12_ROOT_PARAMETER, 4> paramates;
-		paramates[0] = SRVHeap.begin()->second.GetParameter();
+		paramates[0] = mesh->GetSRVParameter();
 		paramates[1] = wvpData.front().GetRoootParamater();
 		paramates[2] = dirLig.front().GetRoootParamater();
 		paramates[3] = colorBuf.front().GetRoootParamater();
@@ -332,25 +322,165 @@ void Model::CreateGraphicsPipeline() {
 
 		PipelineManager::StateReset();
 
+		// インスタンシング用(インスタンスのデータはルートパラメーターのSRVで渡す)
+		Shader instancingShader;
+		instancingShader.vertex = ShaderManager::LoadVertexShader("Shaders/ModelShader/ModelInstancing.VS.hlsl");
+		instancingShader.pixel = ShaderManager::LoadPixelShader("Shaders/ModelShader/ModelInstancing.PS.hlsl");
+
+		D3D12_ROOT_PARAMETER instanceParamater{};
+		instanceParamater.ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+		instanceParamater.ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+		instanceParamater.Descriptor.ShaderRegister = 1;
+
+		std::array<D3D12_ROOT_PARAMETER, 4> instancingParamates;
+		instancingParamates[0] = mesh->GetSRVParameter();
+		instancingParamates[1] = instancingWvpData.front().GetRoootParamater();
+		instancingParamates[2] = instancingDirLig.front().GetRoootParamater();
+		instancingParamates[3] = instanceParamater;
+		PipelineManager::CreateRootSgnature(instancingParamates.data(), instancingParamates.size(), true);
+
+		PipelineManager::SetShader(instancingShader);
+
+		PipelineManager::SetVertexInput("POSITION", 0u, DXGI_FORMAT_R32G32B32A32_FLOAT);
+		PipelineManager::SetVertexInput("NORMAL", 0u, DXGI_FORMAT_R32G32B32_FLOAT);
+		PipelineManager::SetVertexInput("TEXCOORD", 0u, DXGI_FORMAT_R32G32_FLOAT);
+
+		PipelineManager::SetState(Pipeline::Blend::None, Pipeline::SolidState::Solid);
+
+		instancingPipeline = PipelineManager::Create();
+
+		PipelineManager::StateReset();
+
 		createGPFlg = true;
 	}
 }
 
 void Model::Update() {
 	drawIndexNumber = 0;
+	instanceOffset = 0u;
+	instancingDrawIndex = 0u;
+	// 前のフレームの描画はFrameEnd()で待っているので解放してよい
+	for (auto& i : retiredInstanceBuffers) {
+		i->Release();
+	}
+	retiredInstanceBuffers.clear();
+	meshletNum = 0u;
+	visibleMeshletNum = 0u;
 }
 
-void Model::Draw(const Mat4x4& viewProjectionMat, const Vector3& cameraPos) {
+Mat4x4 Model::CalcWorldMatrix() {
+	transform.SetScale(scale);
+	transform.SetRotate(rotate);
+	transform.SetTranslate(pos);
+	Mat4x4 worldMat = transform.GetHoriMatrix();
+	if (parent) {
+		worldMat *= MakeMatrixTransepose(parent->wvpData.back()->worldMat);
+	}
+	return worldMat;
+}
+
+bool Model::PrepareDraw() {
+	if (!IsLoadObjFinish()) {
+		return false;
+	}
+	if (!createGPFlg && createGPReserveFlg) {
+		CreateGraphicsPipeline();
+	}
 	assert(createGPFlg);
+	return createGPFlg;
+}
+
+void Model::RequestTextureMip(float pixelPerUnit) {
+	auto textureManager = TextureManager::GetInstance();
+	if (!textureManager->IsStreaming() || !(0.0f < pixelPerUnit)) {
+		return;
+	}
+
+	for (auto& i : mesh->GetSubmeshes()) {
+		const Texture* texture = i.second.texture;
+		if (texture == nullptr || !texture->IsStreaming()) {
+			continue;
+		}
+		const Vector2& textureSize = texture->getSize();
+		textureManager->RequestMip(texture, TextureStreamer::CalcTexelPerPixel(std::max(textureSize.x, textureSize.y), i.second.uvDensity, pixelPerUnit));
+	}
+}
+
+void Model::SelectLod(const Camera& camera, float pixelThreshold) {
+	assert(mesh);
+	if (!IsLoadObjFinish()) {
+		return;
+	}
+	const Sphere& localSphere = mesh->GetBoundingSphere();
+	Sphere worldSphere = HoriTransformSphere(localSphere, CalcWorldMatrix());
+
+	// LODの誤差はローカル座標の距離なので拡大率をかける
+	float worldScale = 0.0f < localSphere.radius ? worldSphere.radius / localSphere.radius : 1.0f;
+
+	// 誤差が一番大きく見えるのは境界球のカメラに一番近い所
+	float distance = (worldSphere.center - camera.GetPos()).Length() - worldSphere.radius;
+
+	lod = ::SelectLod(mesh->GetLodErrors(), camera.CalcPixelPerUnit(distance) * worldScale, pixelThreshold);
+}
+
+bool Model::Raycast(const Ray& ray, RaycastHit& hit, float maxDistance) {
+	assert(mesh);
+	if (!IsLoadObjFinish()) {
+		return false;
+	}
+	const Mat4x4 inverseWorldMat = MakeMatrixInverse(CalcWorldMatrix());
+
+	// BVHはローカル座標なのでレイをローカル座標に持ってくる
+	// 向きは正規化しないので、ローカル座標でのtがそのままワールド座標でのtになる
+	const Ray localRay = {
+		ray.origin * inverseWorldMat,
+		(Vector4(ray.direction, 0.0f) * inverseWorldMat).GetVector3()
+	};
+	if (!mesh->GetBvh().Raycast(localRay, hit, maxDistance)) {
+		return false;
+	}
+
+	hit.position = ray.GetPoint(hit.distance);
+	// 法線はワールド行列の逆行列の転置で変換する(拡縮が軸ごとに違っても面に垂直で、反転していても元の面と同じ側を向く)
+	hit.normal = (Vector4(hit.normal, 0.0f) * MakeMatrixTransepose(inverseWorldMat)).GetVector3().Normalize();
+
+	return true;
+}
+
+void Model::Draw(const Mat4x4& viewProjectionMat, const Vector3& cameraPos) {
 	if (drawIndexNumber >= maxDrawIndex) {
 		drawIndexNumber = 0;
 	}
 
-	wvpData[drawIndexNumber]->worldMat.HoriAffin(scale, rotate, pos);
-	if (parent) {
-		wvpData[drawIndexNumber]->worldMat *= MakeMatrixTransepose(parent->wvpData.back()->worldMat);
+	Mat4x4 worldMat = CalcWorldMatrix();
+	// 子がこのモデルの行列を使うので、カリングされても読み込み中でも行列は更新しておく
+	wvpData[drawIndexNumber]->worldMat = MakeMatrixTransepose(worldMat);
+
+	// 非同期読み込みが終わるまでは描画しない
+	if (!PrepareDraw()) {
+		return;
+	}
+
+	// 視錐台の外なら描画しない
+	if (!Frustum(viewProjectionMat).IsVisible(HoriTransformSphere(mesh->GetBoundingSphere(), worldMat))) {
+		return;
 	}
-	wvpData[drawIndexNumber]->worldMat.Transepose();
+
+	RequestTextureMip(CalcPixelPerLocalUnit(viewProjectionMat, mesh->GetBoundingSphere(), worldMat));
+
+	// メッシュレットはローカル座標なので、視錐台とカメラをローカル座標に持ってくる
+	const Frustum localFrustum(viewProjectionMat * MakeMatrixTransepose(worldMat));
+	const Vector3 localCameraPos = cameraPos * MakeMatrixInverse(worldMat);
+	// 拡縮が軸ごとに違う、または反転している時は法線の向きが変わるので裏面カリングしない
+	const Vector3 axisX = worldMat[0].GetVector3();
+	const Vector3 axisY = worldMat[1].GetVector3();
+	const Vector3 axisZ = worldMat[2].GetVector3();
+	const float axisXLength = axisX.Length();
+	const bool isConeCulling =
+		0.0f < axisX.Cross(axisY).Dot(axisZ)
+		&& std::abs(axisY.Length() - axisXLength) <= axisXLength * 1.0e-3f
+		&& std::abs(axisZ.Length() - axisXLength) <= axisXLength * 1.0e-3f;
+
 	wvpData[drawIndexNumber]->viewProjectoionMat = viewProjectionMat;
 
 	*colorBuf[drawIndexNumber] = UintToVector4(color);
@@ -366,22 +496,145 @@ void Model::Draw(const Mat4x4& viewProjectionMat, const Vector3& cameraPos) {
 
 	[[maybe_unused]]size_t indexVertex = 0;
 
-	for (auto& i : meshData) {
+	for (auto& i : mesh->GetSubmeshes()) {
 		pipeline->Use();
-		SRVHeap[i.first].Use();
+		i.second.srvHeap->Use();
 
 		commandlist->IASetVertexBuffers(0, 1, &i.second.vertexView);
+		commandlist->IASetIndexBuffer(&i.second.indexView);
 
 		commandlist->SetGraphicsRootConstantBufferView(1, wvpData[drawIndexNumber].GetGPUVtlAdrs());
 		commandlist->SetGraphicsRootConstantBufferView(2, dirLig[drawIndexNumber].GetGPUVtlAdrs());
 		commandlist->SetGraphicsRootConstantBufferView(3, colorBuf[drawIndexNumber].GetGPUVtlAdrs());
 
-		commandlist->DrawInstanced(i.second.vertNum, 1, 0, 0);
+		const auto& lodRange = i.second.GetLod(lod);
+		if (!isMeshletCulling || &lodRange != &i.second.lods.front() || i.second.meshlets.empty()) {
+			commandlist->DrawIndexedInstanced(lodRange.indexNum, 1, lodRange.indexOffset, 0, 0);
+			continue;
+		}
+
+		// 見えるメッシュレットが続いている所はインデックスも続いているのでまとめて描画する
+		uint32_t runIndexOffset = 0;
+		uint32_t runIndexNum = 0;
+		for (auto& meshlet : i.second.meshlets) {
+			if (IsMeshletVisible(meshlet, localFrustum, localCameraPos, isConeCulling)) {
+				if (runIndexNum == 0) {
+					runIndexOffset = meshlet.indexOffset;
+				}
+				runIndexNum += meshlet.triangleNum * 3;
+				visibleMeshletNum++;
+			}
+			else if (runIndexNum != 0) {
+				commandlist->DrawIndexedInstanced(runIndexNum, 1, runIndexOffset, 0, 0);
+				runIndexNum = 0;
+			}
+		}
+		if (runIndexNum != 0) {
+			commandlist->DrawIndexedInstanced(runIndexNum, 1, runIndexOffset, 0, 0);
+		}
+		meshletNum += static_cast<uint32_t>(i.second.meshlets.size());
 	}
 
 	drawIndexNumber++;
 }
 
+void Model::PushInstance(const Vector3& pos_, const Vector3& rotate_, const Vector3& scale_, uint32_t color_) {
+	PushInstance(HoriMakeMatrixAffin(scale_, rotate_, pos_), color_);
+}
+
+void Model::PushInstance(const Mat4x4& worldMat, uint32_t color_) {
+	assert(mesh);
+	// 読み込み中は境界球が無いので追加しない
+	if (!IsLoadObjFinish()) {
+		return;
+	}
+	instanceBatch.Push(worldMat, UintToVector4(color_), mesh->GetBoundingSphere());
+}
+
+void Model::DrawInstancing(const Mat4x4& viewProjectionMat, const Vector3& cameraPos) {
+	if (!PrepareDraw()) {
+		instanceBatch.Clear();
+		return;
+	}
+
+	// 視錐台の外のインスタンスは詰めて除く
+	auto instances = instanceBatch.Cull(Frustum(viewProjectionMat));
+	const uint32_t instanceNum = static_cast<uint32_t>(instances.size());
+	if (instanceNum == 0u) {
+		instanceBatch.Clear();
+		return;
+	}
+
+	const InstanceBatch::BufferRange range = InstanceBatch::Allocate(instanceCapacity, instanceOffset, instanceNum);
+	if (range.newCapacity != 0u) {
+		// このフレームで前に呼んだ描画が使っているので、作り直す前のバッファは次のUpdate()まで残す
+		if (instanceBuffer) {
+			retiredInstanceBuffers.push_back(std::move(instanceBuffer));
+		}
+		// 次のフレームからは1本に収まるように、このフレームで詰めた分も含めて確保する
+		instanceCapacity = range.newCapacity;
+		instanceBuffer = Engine::CreateBufferResuorce(sizeof(InstanceBatch::InstanceData) * instanceCapacity);
+		assert(instanceBuffer);
+
+		instanceMap = nullptr;
+		instanceBuffer->Map(0, nullptr, reinterpret_cast<void**>(&instanceMap));
+	}
+	instanceOffset = range.offset;
+
+	InstanceBatch::Write(instances, std::span<InstanceBatch::InstanceData>(instanceMap + instanceOffset, instanceCapacity - instanceOffset));
+
+	// テクスチャは一番大きく見えるインスタンスに合わせる
+	if (TextureManager::GetInstance()->IsStreaming()) {
+		float pixelPerUnit = 0.0f;
+		for (auto& instance : instances) {
+			pixelPerUnit = std::max(pixelPerUnit, CalcPixelPerLocalUnit(viewProjectionMat, mesh->GetBoundingSphere(), MakeMatrixTransepose(instance.worldMat)));
+		}
+		RequestTextureMip(pixelPerUnit);
+	}
+	instanceBatch.Clear();
+
+	if (instancingWvpData.size() <= instancingDrawIndex) {
+		instancingWvpData.emplace_back().shaderRegister = 0;
+		instancingWvpData.back()->worldMat = MakeMatrixIndentity();
+		instancingDirLig.emplace_back().shaderRegister = 1;
+	}
+	auto& wvp = instancingWvpData[instancingDrawIndex];
+	auto& lig = instancingDirLig[instancingDrawIndex];
+	wvp->viewProjectoionMat = viewProjectionMat;
+	*lig = *dirLig.back();
+	lig->eyePos = cameraPos;
+
+
+	auto commandlist = Engine::GetCommandList();
+
+	if (!instancingPipeline) {
+		ErrorCheck::GetInstance()->ErrorTextBox("instancingPipeline is nullptr", "Model");
+		return;
+	}
+
+	// SV_InstanceIDはStartInstanceLocationを含まないので、SRVの先頭を今回書いた位置にずらす
+	const D3D12_GPU_VIRTUAL_ADDRESS instanceAdrs = instanceBuffer->GetGPUVirtualAddress() + sizeof(InstanceBatch::InstanceData) * instanceOffset;
+
+	for (auto& i : mesh->GetSubmeshes()) {
+		instancingPipeline->Use();
+		i.second.srvHeap->Use();
+
+		commandlist->IASetVertexBuffers(0, 1, &i.second.vertexView);
+		commandlist->IASetIndexBuffer(&i.second.indexView);
+
+		commandlist->SetGraphicsRootConstantBufferView(1, wvp.GetGPUVtlAdrs());
+		commandlist->SetGraphicsRootConstantBufferView(2, lig.GetGPUVtlAdrs());
+		commandlist->SetGraphicsRootShaderResourceView(3, instanceAdrs);
+
+		// メッシュごとに全インスタンスを1回で描画する
+		const auto& lodRange = i.second.GetLod(lod);
+		commandlist->DrawIndexedInstanced(lodRange.indexNum, instanceNum, lodRange.indexOffset, 0, 0);
+	}
+
+	instanceOffset += instanceNum;
+	instancingDrawIndex++;
+}
+
 void Model::Debug(const std::string& guiName) {
 	ImGui::Begin(guiName.c_str());
 	ImGui::DragFloat3("pos", &pos.x, 0.01f);
@@ -394,13 +647,76 @@ void Model::Debug(const std::string& guiName) {
 	ImGui::DragFloat3("ptPos", &dirLig.back()->ptPos.x, 0.01f);
 	ImGui::DragFloat3("ptColor", &dirLig.back()->ptColor.x, 0.01f);
 	ImGui::DragFloat("ptRange", &dirLig.back()->ptRange);
+	if (!IsLoadObjFinish()) {
+		ImGui::Text("loading : %s", mesh ? mesh->GetFileName().c_str() : "none");
+		ImGui::End();
+		return;
+	}
+	int lodNum = static_cast<int>(mesh->GetLodNum());
+	int lodTmp = static_cast<int>(lod);
+	ImGui::SliderInt("lod", &lodTmp, 0, lodNum - 1);
+	lod = static_cast<uint32_t>(lodTmp);
+	ImGui::Checkbox("meshletCulling", &isMeshletCulling);
+	if (meshletNum != 0u) {
+		ImGui::Text("meshlet : %u / %u (culled %.1f%%)", visibleMeshletNum, meshletNum,
+			static_cast<float>(meshletNum - visibleMeshletNum) * 100.0f / static_cast<float>(meshletNum));
+	}
+	else {
+		ImGui::Text("meshlet : %zu", mesh->GetMeshletNum());
+	}
+	const TriangleBvh& bvh = mesh->GetBvh();
+	ImGui::Text("bvh : node %zu, triangle %zu (%.2f MB)", bvh.GetNodeNum(), bvh.GetTriangleNum(), static_cast<float>(bvh.GetMemorySize()) / (1024.0f * 1024.0f));
+	if (ImGui::Button("raycastBenchmark") && !bvh.IsEmpty()) {
+		// 境界球の外側の球面から、中心付近に向かうレイを撃つ(ローカル座標)
+		constexpr uint32_t kRayNum = 100000;
+		const Sphere& sphere = mesh->GetBoundingSphere();
+		std::mt19937 randomEngine(0u);
+		std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+		auto randomVector = [&randomEngine, &distribution]() {
+			return Vector3(distribution(randomEngine), distribution(randomEngine), distribution(randomEngine));
+		};
+		std::vector<Ray> rays(kRayNum);
+		for (auto& ray : rays) {
+			Vector3 direction = randomVector().Normalize();
+			ray.origin = sphere.center + (direction == Vector3::zero ? Vector3::yIdy : direction) * (sphere.radius * 2.0f);
+			ray.direction = (sphere.center + randomVector() * (sphere.radius * 0.7f) - ray.origin).Normalize();
+		}
+
+		RaycastHit hit;
+		uint32_t hitNum = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (auto& ray : rays) {
+			hitNum += bvh.Raycast(ray, hit) ? 1u : 0u;
+		}
+		std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+		raycastPerSecond = 0.0 < time.count() ? static_cast<double>(kRayNum) / time.count() : 0.0;
+		raycastHitRate = static_cast<float>(hitNum) * 100.0f / static_cast<float>(kRayNum);
+	}
+	if (0.0 < raycastPerSecond) {
+		ImGui::Text("raycast : %.2f Mrays/s (hit %.1f%%)", raycastPerSecond * 1.0e-6, raycastHitRate);
+	}
+	for (auto& i : mesh->GetSubmeshes()) {
+		// 面の頂点数 -> 重複を取り除いた頂点数
+		ImGui::Text("%s : vertex %u -> %u", i.first.c_str(), i.second.lods.front().indexNum, i.second.vertNum);
+		ImGui::Text("  acmr : %.3f -> %.3f, atvr : %.3f -> %.3f",
+			i.second.sourceVertexCache.acmr, i.second.vertexCache.acmr, i.second.sourceVertexCache.atvr, i.second.vertexCache.atvr);
+		for (size_t level = 0; level < i.second.lods.size(); level++) {
+			ImGui::Text("  lod%zu : triangle %u", level, i.second.lods[level].indexNum / 3u);
+		}
+	}
 	ImGui::End();
 }
 
 Model::~Model() {
-	for (auto& i : meshData) {
-		if (i.second.vertexBuffer) {
-			i.second.vertexBuffer->Release();
-		}
+	if (instanceBuffer) {
+		instanceBuffer->Release();
+	}
+	for (auto& i : retiredInstanceBuffers) {
+		i->Release();
+	}
+
+	// MeshManagerが先に終了している時はMeshManagerが解放済み
+	if (mesh && MeshManager::GetInstance()) {
+		MeshManager::GetInstance()->ReleaseObj(mesh);
 	}
 }
\ No newline at end of file
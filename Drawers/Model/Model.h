@@ -3,49 +3,26 @@
 #include "Utils/Math/Mat4x4.h"
 #include "Utils/Math/Vector2.h"
 #include "Utils/Math/Vector4.h"
+#include "Utils/Transform/Transform.h"
+#include "Utils/Math/Bounds.h"
+#include "Utils/Math/Ray.h"
+#include "Utils/Camera/Camera.h"
+#include "Drawers/Model/InstanceBatch/InstanceBatch.h"
 #include <string>
 #include "Engine/ConstBuffer/ConstBuffer.h"
 #include "Engine/ShaderResource/ShaderResourceHeap.h"
 #include "Engine/RootSignature/RootSignature.h"
 #include "Engine/PipelineManager/PipelineManager.h"
 #include "TextureManager/TextureManager.h"
+#include "MeshManager/MeshManager.h"
 #include <unordered_map>
+#include <vector>
+#include <limits>
+#include <cassert>
 
 #include <wrl.h>
 
 class Model {
-public:
-	struct VertData {
-		Vector4 position;
-		Vector3 normal;
-		Vector2 uv;
-	};
-	struct IndexData {
-		uint32_t vertNum;
-		uint32_t uvNum;
-		uint32_t normalNum;
-
-		inline bool operator==(const IndexData& right) {
-			return vertNum == right.vertNum
-				&& uvNum == right.uvNum
-				&& normalNum == right.normalNum;
-		}
-		inline bool operator!=(const IndexData& right) {
-			return !(*this == right);
-		}
-	};
-
-	struct Mesh {
-		Microsoft::WRL::ComPtr<ID3D12Resource> vertexBuffer = nullptr;
-		// 頂点バッファビュー
-		D3D12_VERTEX_BUFFER_VIEW vertexView{};
-		// 頂点バッファマップ
-		VertData* vertexMap = nullptr;
-
-		// 頂点数
-		uint32_t vertNum = 0;
-	};
-
 private:
 	struct MatrixData {
 		Mat4x4 worldMat;
@@ -68,28 +45,82 @@ private:
 public:
 	Model();
 	Model(UINT maxDrawIndex_);
-	Model(const Model&) = default;
+	Model(const Model& right);
 	~Model();
 
-	Model& operator=(const Model&) = default;
+	Model& operator=(const Model& right);
 
 public:
+	/// <summary>
+	/// objを読み込む(同じファイルのメッシュはMeshManagerで共有する)
+	/// </summary>
 	void LoadObj(const std::string& fileName);
-private:
-	void LoadMtl(const std::string fileName);
 
-public:
+	/// <summary>
+	/// objの読み込みをワーカースレッドで始めてすぐに返す(同じファイルのメッシュはMeshManagerで共有する)
+	/// GPUへの転送はEngine::FrameEnd()で行い、それまでは描画やレイキャストをしても何もしない
+	/// </summary>
+	void LoadObjAsync(const std::string& fileName);
+
+	/// <summary>
+	/// メッシュの読み込みとGPUへの転送が終わったか
+	/// </summary>
+	bool IsLoadObjFinish() const {
+		return mesh && static_cast<bool>(*mesh);
+	}
+
+	/// <summary>
+	/// シェーダーを読み込む
+	/// 法線は読み込み時に作ってあるので、ジオメトリシェーダーは指定した時だけ使う(Model.GS.hlslで面法線を毎フレーム計算する)
+	/// </summary>
 	void LoadShader(const std::string& vertex = "Shaders/ModelShader/Model.VS.hlsl",
 		const std::string& pixel = "Shaders/ModelShader/Model.PS.hlsl",
-		const std::string& geometory = "Shaders/ModelShader/ModelNone.GS.hlsl",
+		const std::string& geometory = {},
 		const std::string& hull = {},
 		const std::string& domain = {}
 	);
 
 	void Update();
 
+	/// <summary>
+	/// 画面上の誤差がpixelThreshold以下に収まる一番粗いLODを選ぶ(Draw()の前に呼ぶ)
+	/// </summary>
+	/// <param name="camera">描画するカメラ(距離とfovから画面上の大きさを求める)</param>
+	/// <param name="pixelThreshold">許容する画面上の誤差(ピクセル)</param>
+	void SelectLod(const Camera& camera, float pixelThreshold = 1.0f);
+
+	/// <summary>
+	/// ワールド座標のレイと一番近い三角形の交差を求める(LOD0の形状。裏面にも当たる)
+	/// マウスで選ぶ時はCamera::ScreenPosToRay(Mouse::GetPos())のレイを渡す
+	/// </summary>
+	/// <param name="ray">ワールド座標のレイ</param>
+	/// <param name="hit">当たった時の結果(ワールド座標)</param>
+	/// <param name="maxDistance">これより遠い交差は無視する(レイのパラメーターt)</param>
+	/// <returns>当たったか</returns>
+	bool Raycast(const Ray& ray, RaycastHit& hit, float maxDistance = std::numeric_limits<float>::infinity());
+
 	void Draw(const Mat4x4& viewProjectionMat, const Vector3& cameraPos);
 
+	/// <summary>
+	/// インスタンシング描画するインスタンスを追加する(parentは反映しない)
+	/// </summary>
+	void PushInstance(const Vector3& pos_, const Vector3& rotate_, const Vector3& scale_, uint32_t color_);
+	/// <summary>
+	/// インスタンシング描画するインスタンスを追加する
+	/// </summary>
+	/// <param name="worldMat">横ベクトル用のワールド行列</param>
+	/// <param name="color_">色</param>
+	void PushInstance(const Mat4x4& worldMat, uint32_t color_);
+
+	/// <summary>
+	/// PushInstance()で追加したインスタンスを視錐台カリングして、メッシュごとに1回のドローコールで描画する
+	/// 追加したインスタンスはクリアされる(1フレームに何回呼んでもよい)
+	/// </summary>
+	void DrawInstancing(const Mat4x4& viewProjectionMat, const Vector3& cameraPos);
+
+	/// <summary>
+	/// パイプラインを作る(非同期読み込み中なら、読み込みが終わってから最初のDraw()で作る)
+	/// </summary>
 	void CreateGraphicsPipeline();
 
 	void Debug(const std::string& guiName);
@@ -98,6 +129,57 @@ public:
 		parent = parent_;
 	}
 
+	/// <summary>
+	/// 描画するLOD(0が元の形状。無い番号なら一番粗いLODになる)
+	/// インスタンシング描画も全インスタンスでこのLODを使う
+	/// </summary>
+	void SetLod(uint32_t lod_) {
+		lod = lod_;
+	}
+	uint32_t GetLod() const {
+		return lod;
+	}
+
+	/// <summary>
+	/// LOD0を描画する時に、視錐台の外と裏向きのメッシュレットを描画しないようにするか
+	/// </summary>
+	void SetMeshletCulling(bool isMeshletCulling_) {
+		isMeshletCulling = isMeshletCulling_;
+	}
+
+	/// <summary>
+	/// ローカル座標でのAABB(LoadObj時に計算)
+	/// </summary>
+	const AABB& GetAABB() const {
+		assert(mesh);
+		return mesh->GetAABB();
+	}
+	/// <summary>
+	/// ローカル座標での境界球(LoadObj時に計算)
+	/// </summary>
+	const Sphere& GetBoundingSphere() const {
+		assert(mesh);
+		return mesh->GetBoundingSphere();
+	}
+
+private:
+	/// <summary>
+	/// 横ベクトル用のワールド行列(親の行列も反映する)
+	/// </summary>
+	Mat4x4 CalcWorldMatrix();
+
+	/// <summary>
+	/// 非同期読み込みが終わっていれば、後回しにしたパイプラインを作る
+	/// </summary>
+	/// <returns>描画できるか</returns>
+	bool PrepareDraw();
+
+	/// <summary>
+	/// 画面上の大きさから、ストリーミングするテクスチャに必要なミップを伝える
+	/// </summary>
+	/// <param name="pixelPerUnit">ローカル座標の1単位が画面上で何ピクセルになるか</param>
+	void RequestTextureMip(float pixelPerUnit);
+
 public:
 	Vector3 pos;
 	Vector3 rotate;
@@ -108,9 +190,21 @@ public:
 
 
 private:
-	std::unordered_map<std::string, ShaderResourceHeap> SRVHeap;
+	Transform transform;
+
+	// MeshManagerが持っているメッシュ(参照数はMeshManagerで管理)
+	Mesh* mesh;
 
-	std::unordered_map<std::string, Mesh> meshData;
+	uint32_t lod;
+
+	bool isMeshletCulling;
+	// このフレームで判定したメッシュレットと、そのうち描画した数(Update()で0に戻す)
+	uint32_t meshletNum;
+	uint32_t visibleMeshletNum;
+
+	// Debug()で計ったレイキャストの速さ(1秒あたりの本数)と当たった割合
+	double raycastPerSecond;
+	float raycastHitRate;
 
 	Shader shader;
 
@@ -119,6 +213,8 @@ private:
 	bool loadObjFlg;
 	bool loadShaderFlg;
 	bool createGPFlg;
+	// 読み込み中にCreateGraphicsPipeline()を呼ばれた
+	bool createGPReserveFlg;
 
 	std::deque<ConstBuffer<MatrixData>> wvpData;
 
@@ -126,8 +222,24 @@ private:
 
 	std::deque<ConstBuffer<Vector4>> colorBuf;
 
-	std::unordered_map<std::string, Texture*> tex;
-
 	UINT drawIndexNumber;
 	UINT maxDrawIndex;
+
+	Pipeline* instancingPipeline;
+
+	InstanceBatch instanceBatch;
+
+	// インスタンスごとのデータ(StructuredBuffer)
+	// DrawInstancing()を呼ぶたびにinstanceOffsetから後ろへ詰め、Update()で先頭に戻す
+	Microsoft::WRL::ComPtr<ID3D12Resource> instanceBuffer;
+	InstanceBatch::InstanceData* instanceMap;
+	uint32_t instanceCapacity;
+	uint32_t instanceOffset;
+	// 作り直す前のバッファ(このフレームの描画が使っているので、FrameEnd()で待った後のUpdate()で解放する)
+	std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> retiredInstanceBuffers;
+
+	// DrawInstancing()ごとの定数バッファ(足りなければ増やす)
+	std::deque<ConstBuffer<MatrixData>> instancingWvpData;
+	std::deque<ConstBuffer<DirectionLight>> instancingDirLig;
+	UINT instancingDrawIndex;
 };
\ No newline at end of file
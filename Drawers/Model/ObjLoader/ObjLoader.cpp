@@ -0,0 +1,518 @@
+#include "ObjLoader.h"
+#include "Utils/MeshOptimizer/NormalGenerator.h"
+#include <fstream>
+#include <charconv>
+#include <algorithm>
+#include <array>
+#include <thread>
+
+namespace {
+	/// <summary>
+	/// 1スレッドに任せる最小のバイト数
+	/// </summary>
+	constexpr size_t kMinChunkSize = 1 << 20;
+
+	bool IsSpace(char ch) {
+		return ch == ' ' || ch == '\t' || ch == '\r';
+	}
+
+	std::string_view SkipSpace(std::string_view str) {
+		size_t pos = 0;
+		while (pos < str.size() && IsSpace(str[pos])) {
+			pos++;
+		}
+		return str.substr(pos);
+	}
+
+	/// <summary>
+	/// 先頭の空白を飛ばして、次の空白までを取り出す(strは取り出した後ろまで進む)
+	/// </summary>
+	std::string_view NextToken(std::string_view& str) {
+		str = SkipSpace(str);
+		size_t end = 0;
+		while (end < str.size() && !IsSpace(str[end])) {
+			end++;
+		}
+		std::string_view token = str.substr(0, end);
+		str = str.substr(end);
+		return token;
+	}
+
+	/// <summary>
+	/// 一行取り出す(textは次の行の先頭まで進む)
+	/// </summary>
+	std::string_view NextLine(std::string_view& text) {
+		size_t end = text.find('\n');
+		std::string_view line;
+		if (end == std::string_view::npos) {
+			line = text;
+			text = {};
+		}
+		else {
+			line = text.substr(0, end);
+			text = text.substr(end + 1);
+		}
+		return line;
+	}
+
+	float ParseFloat(std::string_view& str) {
+		str = SkipSpace(str);
+		if (!str.empty() && str.front() == '+') {
+			str.remove_prefix(1);
+		}
+		float result = 0.0f;
+		auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), result);
+		str.remove_prefix(static_cast<size_t>(ptr - str.data()));
+		return result;
+	}
+
+	int32_t ParseInt(std::string_view str) {
+		int32_t result = 0;
+		std::from_chars(str.data(), str.data() + str.size(), result);
+		return result;
+	}
+}
+
+size_t ObjLoader::IndexDataHash::operator()(const IndexData& indexData) const noexcept {
+	uint64_t hash = (static_cast<uint64_t>(indexData.vertNum) << 32) ^ (static_cast<uint64_t>(indexData.uvNum) << 16) ^ indexData.normalNum;
+	// splitmix64の最後の混ぜ方
+	hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ull;
+	hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebull;
+	return static_cast<size_t>(hash ^ (hash >> 31));
+}
+
+ObjLoader::ObjLoader() :
+	positions(),
+	normals(),
+	uvs(),
+	indices(),
+	mtlFileNames(),
+	errorText()
+{}
+
+bool ObjLoader::Load(const std::string& fileName, uint32_t threadNum) {
+	std::ifstream objFile(fileName, std::ios::binary | std::ios::ate);
+	if (!objFile) {
+		Clear();
+		errorText = "Load() : Not found objFile : " + fileName;
+		return false;
+	}
+
+	// 一括で読み込む
+	std::string text(static_cast<size_t>(objFile.tellg()), '\0');
+	objFile.seekg(0, std::ios::beg);
+	objFile.read(text.data(), static_cast<std::streamsize>(text.size()));
+	objFile.close();
+
+	return Parse(text, threadNum);
+}
+
+bool ObjLoader::Parse(std::string_view text, uint32_t threadNum) {
+	Clear();
+
+	if (threadNum == 0) {
+		threadNum = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+	// 小さいファイルはスレッドを作る方が遅いので分けない
+	threadNum = static_cast<uint32_t>(std::clamp<size_t>(text.size() / kMinChunkSize, 1, threadNum));
+
+	// 行の途中で切らないように区切る
+	std::vector<Chunk> chunks(threadNum);
+	for (size_t i = 0, start = 0; i < chunks.size(); i++) {
+		size_t end = text.size();
+		if (i + 1 < chunks.size()) {
+			end = std::max(start, text.size() * (i + 1) / chunks.size());
+			end = text.find('\n', end);
+			end = end == std::string_view::npos ? text.size() : end + 1;
+		}
+		chunks[i].text = text.substr(start, end - start);
+		start = end;
+	}
+
+	auto runParallel = [&chunks](auto func) {
+		if (chunks.size() == 1) {
+			func(chunks.front(), 0);
+			return;
+		}
+		std::vector<std::thread> threads;
+		threads.reserve(chunks.size());
+		for (size_t i = 0; i < chunks.size(); i++) {
+			threads.emplace_back(func, std::ref(chunks[i]), i);
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+	};
+
+	// 先に数えて、各区間の先頭までの要素数を求める
+	runParallel([](Chunk& chunk, size_t) { CountChunk(chunk); });
+
+	std::vector<size_t> positionBase(chunks.size(), 0);
+	std::vector<size_t> normalBase(chunks.size(), 0);
+	std::vector<size_t> uvBase(chunks.size(), 0);
+	for (size_t i = 1; i < chunks.size(); i++) {
+		positionBase[i] = positionBase[i - 1] + chunks[i - 1].positionNum;
+		normalBase[i] = normalBase[i - 1] + chunks[i - 1].normalNum;
+		uvBase[i] = uvBase[i - 1] + chunks[i - 1].uvNum;
+	}
+
+	runParallel(
+		[&positionBase, &normalBase, &uvBase](Chunk& chunk, size_t index) {
+			ParseChunk(chunk, positionBase[index], normalBase[index], uvBase[index]);
+		}
+	);
+
+	// 最初に失敗した区間のエラー、無ければファイル全体の要素数を超えるインデックスを探す
+	const char* parseErrorText = nullptr;
+	auto errorChunk = std::find_if(chunks.begin(), chunks.end(), [](const Chunk& chunk) { return chunk.errorText != nullptr; });
+	if (errorChunk != chunks.end()) {
+		parseErrorText = errorChunk->errorText;
+	}
+	else {
+		size_t positionNum = 0;
+		size_t normalNum = 0;
+		size_t uvNum = 0;
+		for (const auto& chunk : chunks) {
+			positionNum += chunk.positions.size();
+			normalNum += chunk.normals.size();
+			uvNum += chunk.uvs.size();
+		}
+		for (const auto& chunk : chunks) {
+			if (positionNum < chunk.usedPositionNum || normalNum < chunk.usedNormalNum || uvNum < chunk.usedUvNum) {
+				parseErrorText = "Index out of range";
+				break;
+			}
+		}
+	}
+	if (parseErrorText) {
+		Clear();
+		errorText = std::string("Parse() : ") + parseErrorText;
+		return false;
+	}
+
+	Merge(chunks);
+
+	return true;
+}
+
+void ObjLoader::Clear() {
+	positions.clear();
+	normals.clear();
+	uvs.clear();
+	indices.clear();
+	mtlFileNames.clear();
+	errorText.clear();
+}
+
+void ObjLoader::CountChunk(Chunk& chunk) {
+	std::string_view text = chunk.text;
+
+	while (!text.empty()) {
+		std::string_view line = SkipSpace(NextLine(text));
+		if (line.size() < 2) {
+			continue;
+		}
+
+		if (line[0] == 'v') {
+			if (IsSpace(line[1])) {
+				chunk.positionNum++;
+			}
+			else if (line[1] == 'n') {
+				chunk.normalNum++;
+			}
+			else if (line[1] == 't') {
+				chunk.uvNum++;
+			}
+		}
+		else if (line[0] == 'f' && IsSpace(line[1])) {
+			if (chunk.faceNums.empty()) {
+				chunk.faceNums.push_back(0);
+			}
+			chunk.faceNums.back()++;
+		}
+		else if (line.starts_with("usemtl") && (line.size() == 6 || IsSpace(line[6]))) {
+			chunk.faceNums.push_back(0);
+		}
+	}
+}
+
+void ObjLoader::ParseChunk(Chunk& chunk, size_t positionBase, size_t normalBase, size_t uvBase) {
+	chunk.positions.reserve(chunk.positionNum);
+	chunk.normals.reserve(chunk.normalNum);
+	chunk.uvs.reserve(chunk.uvNum);
+
+	// 負のインデックスはその行までに定義された要素数からの相対位置
+	// 0や定義より前を指すものは失敗。正のものはファイル全体の要素数と後で比べるので、使った数を覚えておく
+	auto toIndex = [](std::string_view str, size_t definedNum, size_t& usedNum, uint32_t& index) {
+		const int64_t num = ParseInt(str);
+		const int64_t result = num < 0 ? static_cast<int64_t>(definedNum) + num : num - 1;
+		if (num == 0 || result < 0) {
+			return false;
+		}
+		index = static_cast<uint32_t>(result);
+		usedNum = std::max(usedNum, static_cast<size_t>(result) + 1);
+		return true;
+	};
+
+	std::vector<IndexData>* currentIndices = nullptr;
+	std::string_view text = chunk.text;
+
+	auto reserveFaceGroup = [&chunk]() {
+		const size_t index = chunk.faceGroups.size() - 1;
+		if (index < chunk.faceNums.size()) {
+			chunk.faceGroups.back().corners.reserve(chunk.faceNums[index] * 3);
+		}
+	};
+
+	while (!text.empty()) {
+		std::string_view line = NextLine(text);
+		std::string_view identifier = NextToken(line);
+
+		if (identifier == "v") {
+			Vector4 buf;
+			buf.vec.x = ParseFloat(line);
+			buf.vec.y = ParseFloat(line);
+			buf.vec.z = ParseFloat(line);
+			buf.vec.x *= -1.0f;
+			buf.vec.w = 1.0f;
+
+			chunk.positions.push_back(buf);
+		}
+		else if (identifier == "vn") {
+			Vector3 buf;
+			buf.x = ParseFloat(line);
+			buf.y = ParseFloat(line);
+			buf.z = ParseFloat(line);
+			buf.x *= -1.0f;
+			chunk.normals.push_back(buf);
+		}
+		else if (identifier == "vt") {
+			Vector2 buf;
+			buf.x = ParseFloat(line);
+			buf.y = ParseFloat(line);
+			buf.y = 1.0f - buf.y;
+			chunk.uvs.push_back(buf);
+		}
+		else if (identifier == "f") {
+			const size_t positionNum = positionBase + chunk.positions.size();
+			const size_t normalNum = normalBase + chunk.normals.size();
+			const size_t uvNum = uvBase + chunk.uvs.size();
+
+			std::array<IndexData, 3> indcoes;
+			// 左手系にするので面の向きを反転する(後ろから詰める)
+			auto idnexItr = indcoes.rbegin();
+
+			for (std::string_view token = NextToken(line); !token.empty(); token = NextToken(line)) {
+				if (std::none_of(token.begin(), token.end(), [](char ch) { return '0' <= ch && ch <= '9'; })) {
+					continue;
+				}
+
+				// エラーチェック
+				if (idnexItr == indcoes.rend()) {
+					chunk.errorText = "Not supported for rectangles or more";
+					return;
+				}
+
+				/// 0:vertexNumber 1:textureCoordinate 2:NormalNumber
+				std::array<std::string_view, 3> num;
+				size_t count = 0;
+				for (size_t start = 0; count < num.size(); count++) {
+					size_t slash = token.find('/', start);
+					num[count] = token.substr(start, slash == std::string_view::npos ? std::string_view::npos : slash - start);
+					if (slash == std::string_view::npos) {
+						break;
+					}
+					start = slash + 1;
+				}
+
+				// v、v/vt、v//vn、v/vt/vn
+				// テクスチャ座標が無い場合は0番、法線が無い場合は後で作る
+				idnexItr->uvNum = 0u;
+				idnexItr->normalNum = chunk.missingNormal;
+				if (!toIndex(num[0], positionNum, chunk.usedPositionNum, idnexItr->vertNum)
+					|| (1 <= count && !num[1].empty() && !toIndex(num[1], uvNum, chunk.usedUvNum, idnexItr->uvNum))
+					|| (count == 2 && !num[2].empty() && !toIndex(num[2], normalNum, chunk.usedNormalNum, idnexItr->normalNum))
+				) {
+					chunk.errorText = "Index out of range";
+					return;
+				}
+				idnexItr++;
+			}
+
+			if (idnexItr != indcoes.rend()) {
+				chunk.errorText = "Face has less than 3 vertices";
+				return;
+			}
+
+			if (!currentIndices) {
+				currentIndices = &chunk.faceGroups.emplace_back().corners;
+				reserveFaceGroup();
+			}
+			currentIndices->insert(currentIndices->end(), indcoes.begin(), indcoes.end());
+		}
+		else if (identifier == "usemtl") {
+			auto& faceGroup = chunk.faceGroups.emplace_back();
+			faceGroup.isUseMtl = true;
+			faceGroup.mtlName = NextToken(line);
+			currentIndices = &faceGroup.corners;
+			reserveFaceGroup();
+		}
+		else if (identifier == "mtllib") {
+			chunk.mtlFileNames.emplace_back(NextToken(line));
+		}
+		else if (identifier == "s") {
+			std::string_view group = NextToken(line);
+			chunk.missingNormal = group.empty() || group == "off" || group == "0" ? IndexData::kFlatNormal : IndexData::kSmoothNormal;
+		}
+	}
+}
+
+void ObjLoader::Merge(std::vector<Chunk>& chunks) {
+	if (chunks.size() == 1) {
+		positions = std::move(chunks.front().positions);
+		normals = std::move(chunks.front().normals);
+		uvs = std::move(chunks.front().uvs);
+	}
+	else {
+		size_t positionNum = 0;
+		size_t normalNum = 0;
+		size_t uvNum = 0;
+		for (auto& chunk : chunks) {
+			positionNum += chunk.positions.size();
+			normalNum += chunk.normals.size();
+			uvNum += chunk.uvs.size();
+		}
+		positions.reserve(positionNum);
+		normals.reserve(normalNum);
+		uvs.reserve(uvNum);
+		for (auto& chunk : chunks) {
+			positions.insert(positions.end(), chunk.positions.begin(), chunk.positions.end());
+			normals.insert(normals.end(), chunk.normals.begin(), chunk.normals.end());
+			uvs.insert(uvs.end(), chunk.uvs.begin(), chunk.uvs.end());
+		}
+	}
+
+	// 区間の最初のsより前の面は前の区間の最後のsの続き(ファイルの最初はs off)
+	uint32_t missingNormal = IndexData::kFlatNormal;
+	for (auto& chunk : chunks) {
+		for (auto& faceGroup : chunk.faceGroups) {
+			for (auto& corner : faceGroup.corners) {
+				if (corner.normalNum == kInheritNormal) {
+					corner.normalNum = missingNormal;
+				}
+			}
+		}
+		if (chunk.missingNormal != kInheritNormal) {
+			missingNormal = chunk.missingNormal;
+		}
+	}
+
+	// usemtlの区切りを順番にたどって、同じマテリアルの面をまとめる
+	// 区間の最初のまとまりは前の区間の最後のマテリアルの続き
+	std::vector<std::vector<IndexData>*> destinations;
+	std::unordered_map<std::vector<IndexData>*, size_t> cornerNums;
+	std::vector<IndexData>* currentIndices = nullptr;
+	for (auto& chunk : chunks) {
+		for (auto& faceGroup : chunk.faceGroups) {
+			if (faceGroup.isUseMtl) {
+				currentIndices = &indices[faceGroup.mtlName];
+			}
+			else if (!currentIndices) {
+				currentIndices = &indices[std::string()];
+			}
+			destinations.push_back(currentIndices);
+			cornerNums[currentIndices] += faceGroup.corners.size();
+		}
+	}
+
+	auto destination = destinations.begin();
+	for (auto& chunk : chunks) {
+		for (auto& faceGroup : chunk.faceGroups) {
+			currentIndices = *destination++;
+			const size_t cornerNum = cornerNums[currentIndices];
+
+			// まとまりが1つだけならそのまま移す
+			if (currentIndices->empty() && cornerNum == faceGroup.corners.size()) {
+				*currentIndices = std::move(faceGroup.corners);
+				continue;
+			}
+
+			// 複数の区間にまたがる時は先に確保しておく
+			currentIndices->reserve(cornerNum);
+			currentIndices->insert(currentIndices->end(), faceGroup.corners.begin(), faceGroup.corners.end());
+		}
+
+		mtlFileNames.insert(mtlFileNames.end(),
+			std::make_move_iterator(chunk.mtlFileNames.begin()),
+			std::make_move_iterator(chunk.mtlFileNames.end())
+		);
+	}
+}
+
+void ObjLoader::Deduplicate(const std::vector<IndexData>& corners, std::vector<IndexData>& vertices, std::vector<uint32_t>& indices) {
+	vertices.clear();
+	indices.clear();
+	indices.reserve(corners.size());
+
+	std::unordered_map<IndexData, uint32_t, IndexDataHash> vertexIndices;
+	vertexIndices.reserve(corners.size());
+
+	for (auto& corner : corners) {
+		auto [itr, isInsert] = vertexIndices.try_emplace(corner, static_cast<uint32_t>(vertices.size()));
+		if (isInsert) {
+			vertices.push_back(corner);
+		}
+		indices.push_back(itr->second);
+	}
+}
+
+void ObjLoader::GenerateMissingNormals(float smoothAngle) {
+	std::vector<Vector3> vertexPositions(positions.size());
+	std::transform(positions.begin(), positions.end(), vertexPositions.begin(),
+		[](const Vector4& pos) {
+			return pos.GetVector3();
+		}
+	);
+
+	// 同じ法線は1つにまとめて、Deduplicate()で頂点が共有されるようにする
+	struct NormalHash {
+		size_t operator()(const Vector3& normal) const noexcept {
+			return std::hash<float>()(normal.x) ^ (std::hash<float>()(normal.y) << 1) ^ (std::hash<float>()(normal.z) << 2);
+		}
+	};
+	std::unordered_map<Vector3, uint32_t, NormalHash> normalIndices;
+
+	for (uint32_t missingNormal : { IndexData::kFlatNormal, IndexData::kSmoothNormal }) {
+		std::vector<uint32_t> faceIndices;
+		std::vector<IndexData*> faceCorners;
+		for (auto& [mtlName, corners] : indices) {
+			for (size_t i = 0; i + 3 <= corners.size(); i += 3) {
+				if (std::any_of(corners.begin() + i, corners.begin() + i + 3, [missingNormal](const IndexData& corner) { return corner.normalNum == missingNormal; })) {
+					for (size_t j = i; j < i + 3; j++) {
+						faceIndices.push_back(corners[j].vertNum);
+						faceCorners.push_back(&corners[j]);
+					}
+				}
+			}
+		}
+		if (faceIndices.empty()) {
+			continue;
+		}
+
+		auto generatedNormals = GenerateNormals(vertexPositions, faceIndices, missingNormal == IndexData::kSmoothNormal ? smoothAngle : 0.0f);
+		if (generatedNormals.size() != faceCorners.size()) {
+			return;
+		}
+
+		for (size_t i = 0; i < faceCorners.size(); i++) {
+			if (faceCorners[i]->normalNum != missingNormal) {
+				continue;
+			}
+			auto [itr, isInsert] = normalIndices.try_emplace(generatedNormals[i], static_cast<uint32_t>(normals.size()));
+			if (isInsert) {
+				normals.push_back(generatedNormals[i]);
+			}
+			faceCorners[i]->normalNum = itr->second;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,204 @@
+#pragma once
+#include "Utils/Math/Vector4.h"
+#include "Utils/Math/Vector3.h"
+#include "Utils/Math/Vector2.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <limits>
+
+/// <summary>
+/// Objファイルの読み込み(GPUリソースは作らない)
+/// ファイルを一括で読み込み、コピーせずにstd::from_charsで数値を取り出す
+/// ワーカースレッドから呼べるようにエラーウィンドウは出さず、失敗した理由はGetErrorText()で返す
+/// </summary>
+class ObjLoader {
+public:
+	struct IndexData {
+		/// <summary>
+		/// 法線が無い(v、v/vtの)面のnormalNum。GenerateMissingNormals()で面の向きから作る
+		/// s offの面はフラット、sでスムージンググループを指定した面はスムーズにする
+		/// </summary>
+		static constexpr uint32_t kFlatNormal = std::numeric_limits<uint32_t>::max();
+		static constexpr uint32_t kSmoothNormal = kFlatNormal - 1u;
+
+		uint32_t vertNum = 0;
+		uint32_t uvNum = 0;
+		uint32_t normalNum = 0;
+
+		inline bool operator==(const IndexData& right) const {
+			return vertNum == right.vertNum
+				&& uvNum == right.uvNum
+				&& normalNum == right.normalNum;
+		}
+		inline bool operator!=(const IndexData& right) const {
+			return !(*this == right);
+		}
+	};
+
+	struct IndexDataHash {
+		size_t operator()(const IndexData& indexData) const noexcept;
+	};
+
+public:
+	ObjLoader();
+	ObjLoader(const ObjLoader&) = default;
+	ObjLoader(ObjLoader&&) noexcept = default;
+	~ObjLoader() = default;
+
+	ObjLoader& operator=(const ObjLoader&) = default;
+	ObjLoader& operator=(ObjLoader&&) noexcept = default;
+
+public:
+	/// <summary>
+	/// ファイルを読み込む
+	/// </summary>
+	/// <param name="fileName">objファイルパス</param>
+	/// <param name="threadNum">解析に使うスレッド数(0ならハードウェアのスレッド数)</param>
+	/// <returns>成功したか</returns>
+	bool Load(const std::string& fileName, uint32_t threadNum = 0);
+
+	/// <summary>
+	/// メモリ上のobjテキストを解析する
+	/// 大きいファイルは行単位で区切って複数スレッドで解析する(結果は1スレッドの時と同じ)
+	/// 頂点が3つでない面や、0、範囲外を指すインデックスがあれば失敗する
+	/// </summary>
+	/// <param name="text">objファイルの中身</param>
+	/// <param name="threadNum">解析に使うスレッド数(0ならハードウェアのスレッド数)</param>
+	/// <returns>成功したか</returns>
+	bool Parse(std::string_view text, uint32_t threadNum = 0);
+
+	void Clear();
+
+	/// <summary>
+	/// 同じ(頂点座標,テクスチャ座標,法線)の組み合わせを1頂点にまとめる
+	/// </summary>
+	/// <param name="corners">面の頂点番号(GetIndices()の各要素)</param>
+	/// <param name="vertices">重複を取り除いた頂点(出現順)</param>
+	/// <param name="indices">verticesへのインデックス(cornersと同じ数)</param>
+	static void Deduplicate(const std::vector<IndexData>& corners, std::vector<IndexData>& vertices, std::vector<uint32_t>& indices);
+
+	/// <summary>
+	/// 法線が無い面の法線を作ってGetNormals()の後ろに足し、normalNumを書き換える
+	/// フラットの面とスムーズの面は互いに平均しない
+	/// </summary>
+	/// <param name="smoothAngle">スムーズの面で平均する面同士の角度の上限(ラジアン)</param>
+	void GenerateMissingNormals(float smoothAngle);
+
+public:
+	/// <summary>
+	/// 頂点座標(右手系から左手系にするためxを反転済み)
+	/// </summary>
+	const std::vector<Vector4>& GetPositions() const {
+		return positions;
+	}
+	/// <summary>
+	/// 法線(xを反転済み)
+	/// </summary>
+	const std::vector<Vector3>& GetNormals() const {
+		return normals;
+	}
+	/// <summary>
+	/// テクスチャ座標(yを反転済み)
+	/// </summary>
+	const std::vector<Vector2>& GetUvs() const {
+		return uvs;
+	}
+	/// <summary>
+	/// マテリアル名ごとの面の頂点番号(三角形ごとに裏表を反転済み)
+	/// </summary>
+	const std::unordered_map<std::string, std::vector<IndexData>>& GetIndices() const {
+		return indices;
+	}
+	/// <summary>
+	/// mtllibで指定されたファイル名(objファイルからの相対パス)
+	/// </summary>
+	const std::vector<std::string>& GetMtlFileNames() const {
+		return mtlFileNames;
+	}
+	/// <summary>
+	/// 最後のLoad()、Parse()が失敗した理由(成功していれば空)
+	/// </summary>
+	const std::string& GetErrorText() const {
+		return errorText;
+	}
+
+private:
+	/// <summary>
+	/// 区間の最初のsより前にある法線が無い面(前の区間のsの続き。Merge()で決める)
+	/// </summary>
+	static constexpr uint32_t kInheritNormal = IndexData::kFlatNormal - 2u;
+
+	/// <summary>
+	/// 並列に解析するときの1区間分のデータ
+	/// </summary>
+	struct Chunk {
+		/// <summary>
+		/// 面のまとまり(usemtlで区切る)
+		/// </summary>
+		struct FaceGroup {
+			// falseなら前の区間のマテリアルの続き
+			bool isUseMtl = false;
+			std::string mtlName;
+			std::vector<IndexData> corners;
+		};
+
+		std::string_view text;
+
+		// 区間内の要素数(数えるだけの解析で求める)
+		size_t positionNum = 0;
+		size_t normalNum = 0;
+		size_t uvNum = 0;
+		// faceGroupsと同じ区切りでの面の数
+		std::vector<size_t> faceNums;
+
+		std::vector<Vector4> positions;
+		std::vector<Vector3> normals;
+		std::vector<Vector2> uvs;
+		std::vector<FaceGroup> faceGroups;
+		std::vector<std::string> mtlFileNames;
+
+		// 区間の最後のsの状態(kInheritNormalならsが無く、前の区間の続き)
+		uint32_t missingNormal = kInheritNormal;
+
+		// 面が使った一番大きいインデックス+1(ファイル全体の要素数を超えていたら失敗)
+		size_t usedPositionNum = 0;
+		size_t usedNormalNum = 0;
+		size_t usedUvNum = 0;
+
+		// 失敗した理由(成功ならnullptr)
+		const char* errorText = nullptr;
+	};
+
+	/// <summary>
+	/// 区間内の要素数だけを数える
+	/// </summary>
+	static void CountChunk(Chunk& chunk);
+
+	/// <summary>
+	/// 区間を解析する(相対インデックスは前の区間までの要素数を足して絶対インデックスにする)
+	/// </summary>
+	/// <param name="chunk">区間</param>
+	/// <param name="positionBase">前の区間までの頂点座標の数</param>
+	/// <param name="normalBase">前の区間までの法線の数</param>
+	/// <param name="uvBase">前の区間までのテクスチャ座標の数</param>
+	static void ParseChunk(Chunk& chunk, size_t positionBase, size_t normalBase, size_t uvBase);
+
+	/// <summary>
+	/// 区間の結果を順番につなげる
+	/// </summary>
+	void Merge(std::vector<Chunk>& chunks);
+
+private:
+	std::vector<Vector4> positions;
+	std::vector<Vector3> normals;
+	std::vector<Vector2> uvs;
+
+	std::unordered_map<std::string, std::vector<IndexData>> indices;
+
+	std::vector<std::string> mtlFileNames;
+
+	std::string errorText;
+};
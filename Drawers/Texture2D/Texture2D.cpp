@@ -2,6 +2,7 @@
 #include "Engine/ShaderManager/ShaderManager.h"
 #include "externals/imgui/imgui.h"
 #include "Engine/ErrorCheck/ErrorCheck.h"
+#include "Utils/Math/Vector3Stream.h"
 #include <numeric>
 
 Texture2D::Texture2D() :
@@ -10,6 +11,7 @@ Texture2D::Texture2D() :
 	pos({ 0.0f,0.0f,0.01f }),
 	uvPibot(),
 	uvSize(Vector2::identity),
+	transform(),
 	SRVHeap(16),
 	SRVHandle{},
 	vertexView(),
@@ -19,6 +21,10 @@ Texture2D::Texture2D() :
 	shader(),
 	graphicsPipelineState(),
 	tex(nullptr),
+	loadId(TextureManager::kInvalidLoadId),
+	loadFileName(),
+	loadPriority(0),
+	regionSize(),
 	isFirstLoad(true),
 	isLoad(false),
 	color(std::numeric_limits<uint32_t>::max())
@@ -36,11 +42,16 @@ Texture2D::Texture2D(Texture2D&& right) noexcept :
 }
 
 Texture2D::~Texture2D() {
+	CancelLoad();
 	if (indexResource)indexResource->Release();
 	if (vertexResource)vertexResource->Release();
 }
 
 Texture2D& Texture2D::operator=(const Texture2D& right) {
+	if (this == &right) {
+		return *this;
+	}
+
 	scale = right.scale;
 	rotate = right.rotate;
 	pos = right.pos;
@@ -52,9 +63,13 @@ Texture2D& Texture2D::operator=(const Texture2D& right) {
 
 	worldPos = right.worldPos;
 
+	transform = right.transform;
+
 	SRVHeap.Reset();
 
+	CancelLoad();
 	tex = right.tex;
+	regionSize = right.regionSize;
 
 	shader = right.shader;
 
@@ -63,6 +78,11 @@ Texture2D& Texture2D::operator=(const Texture2D& right) {
 	*wvpMat = *right.wvpMat;
 	*colorBuf = *right.colorBuf;
 
+	// 読み込み中なら、同じファイルをこちらでも読み込む(callbackはthisを書き換えるので引き継げない)
+	if (right.loadId != TextureManager::kInvalidLoadId) {
+		ThreadLoadTexture(right.loadFileName, right.loadPriority);
+	}
+
 	return *this;
 }
 
@@ -117,14 +137,50 @@ void Texture2D::CreateGraphicsPipeline() {
 }
 
 void Texture2D::LoadTexture(const std::string& fileName) {
+	CancelLoad();
 	tex = TextureManager::GetInstance()->LoadTexture(fileName);
+	regionSize = Vector2();
 
 	isLoad = false;
 }
 
-void Texture2D::ThreadLoadTexture(const std::string& fileName) {
+void Texture2D::ThreadLoadTexture(const std::string& fileName, int32_t priority) {
+	CancelLoad();
 	tex = nullptr;
-	TextureManager::GetInstance()->LoadTexture(fileName, &tex);
+	regionSize = Vector2();
+	loadFileName = fileName;
+	loadPriority = priority;
+	loadId = TextureManager::GetInstance()->LoadTextureAsync(fileName, priority,
+		[this](Texture* texture) {
+			tex = texture;
+			loadId = TextureManager::kInvalidLoadId;
+		});
+	isLoad = false;
+}
+
+void Texture2D::CancelLoad() {
+	if (loadId != TextureManager::kInvalidLoadId) {
+		// TextureManagerが先に解放されていたら、読み込みも一緒に捨てられている
+		if (TextureManager::GetInstance()) {
+			TextureManager::GetInstance()->CancelLoad(loadId);
+		}
+		loadId = TextureManager::kInvalidLoadId;
+	}
+}
+
+void Texture2D::LoadTexture(const TextureAtlas& atlas, const std::string& regionName) {
+	const TextureAtlas::Region* region = atlas.GetRegion(regionName);
+	if (region == nullptr) {
+		ErrorCheck::GetInstance()->ErrorTextBox("LoadTexture() : This image is not in the atlas -> " + regionName, "Texture2D");
+		return;
+	}
+
+	CancelLoad();
+	tex = atlas.GetTexture(region->page);
+	uvPibot = region->uvPibot;
+	uvSize = region->uvSize;
+	regionSize = { static_cast<float>(region->rect.width), static_cast<float>(region->rect.height) };
+
 	isLoad = false;
 }
 
@@ -152,15 +208,15 @@ void Texture2D::Update() {
 			Vector3{ -0.5f, -0.5f, 0.1f },
 		};
 
-		std::copy(pv.begin(), pv.end(), worldPos.begin());
-		auto&& worldMat =
-			HoriMakeMatrixAffin(
-				Vector3(scale.x * tex->getSize().x, scale.y * tex->getSize().y, 1.0f),
-				rotate,
-				pos
-			);
-		for (auto& i : worldPos) {
-			i *= worldMat;
+		// アトラスならページ全体ではなく、画像の大きさにする
+		const Vector2& texSize = regionSize.x != 0.0f ? regionSize : tex->getSize();
+		transform.SetScale(Vector3(scale.x * texSize.x, scale.y * texSize.y, 1.0f));
+		transform.SetRotate(rotate);
+		transform.SetTranslate(pos);
+
+		// 前回から変わっていなければ頂点を計算し直さない
+		if (transform.IsDirty()) {
+			TransformPoints(transform.GetHoriMatrix(), pv, worldPos);
 		}
 	}
 }
@@ -169,6 +225,12 @@ void Texture2D::Draw(
 	const Mat4x4& viewProjection,
 	Pipeline::Blend blend
 ) {
+	// 読み込み中に描画しようとしたら、見えているものから先に読み込む
+	if (loadId != TextureManager::kInvalidLoadId) {
+		TextureManager::GetInstance()->SetLoadPriority(loadId, TextureManager::kVisibleLoadPriority);
+		loadPriority = TextureManager::kVisibleLoadPriority;
+	}
+
 	if (tex && isLoad) {
 		const Vector2& uv0 = { uvPibot.x, uvPibot.y + uvSize.y }; const Vector2& uv1 = uvSize + uvPibot;
 		const Vector2& uv2 = { uvPibot.x + uvSize.x, uvPibot.y }; const Vector2& uv3 = uvPibot;
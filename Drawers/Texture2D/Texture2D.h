@@ -1,5 +1,6 @@
 #pragma once
 #include "TextureManager/TextureManager.h"
+#include "TextureManager/TextureAtlas/TextureAtlas.h"
 #include "Engine/Engine.h"
 #include "Engine/ConstBuffer/ConstBuffer.h"
 #include "Engine/ShaderResource/ShaderResourceHeap.h"
@@ -9,8 +10,10 @@
 #include "Utils/Math/Mat4x4.h"
 #include "Utils/Math/Vector2.h"
 #include "Utils/Math/Vector4.h"
+#include "Utils/Transform/Transform.h"
 
 #include <array>
+#include <string>
 
 class Texture2D {
 public:
@@ -45,7 +48,26 @@ private:
 
 public:
 	void LoadTexture(const std::string& fileName);
-	void ThreadLoadTexture(const std::string& fileName);
+	/// <summary>
+	/// ワーカースレッドで読み込む(読み込み中に描画しようとすると優先度を上げる)
+	/// </summary>
+	/// <param name="fileName">ファイルパス</param>
+	/// <param name="priority">大きいほど先に読み込む</param>
+	void ThreadLoadTexture(const std::string& fileName, int32_t priority = 0);
+
+private:
+	/// <summary>
+	/// 読み込み中のテクスチャがあれば取り消す
+	/// </summary>
+	void CancelLoad();
+
+public:
+	/// <summary>
+	/// アトラスの中の画像を使う(uvPibotとuvSizeを画像の範囲にし、画像の大きさで描画する)
+	/// </summary>
+	/// <param name="atlas">CreateTextures()済みのアトラス</param>
+	/// <param name="regionName">アトラスに詰めた画像のファイル名</param>
+	void LoadTexture(const TextureAtlas& atlas, const std::string& regionName);
 
 public:
 	void Update();
@@ -73,6 +95,8 @@ public:
 	uint32_t color;
 
 private:
+	Transform transform;
+
 	ShaderResourceHeap SRVHeap;
 
 	uint32_t SRVHandle;
@@ -91,6 +115,19 @@ private:
 	ConstBuffer<Vector4> colorBuf;
 
 	Texture* tex;
+	/// <summary>
+	/// ThreadLoadTexture()で読み込み中の番号
+	/// </summary>
+	TextureManager::LoadId loadId;
+	/// <summary>
+	/// ThreadLoadTexture()で読み込み中のファイルと優先度(コピーしたときに読み込み直す)
+	/// </summary>
+	std::string loadFileName;
+	int32_t loadPriority;
+	/// <summary>
+	/// アトラスの画像の大きさ(アトラスを使わないなら0でテクスチャの大きさを使う)
+	/// </summary>
+	Vector2 regionSize;
 	bool isFirstLoad;
 	bool isLoad;
 };
\ No newline at end of file
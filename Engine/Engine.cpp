@@ -6,6 +6,7 @@
 #include "ShaderManager/ShaderManager.h"
 #include "ConvertString/ConvertString.h"
 #include "TextureManager/TextureManager.h"
+#include "MeshManager/MeshManager.h"
 #include "Input/KeyInput/KeyInput.h"
 #include "Input/Mouse/Mouse.h"
 #include "AudioManager/AudioManager.h"
@@ -135,6 +136,7 @@ bool Engine::Initialize(const std::string& windowName, Resolution resolution) {
 	Mouse::Initialize();
 	ShaderManager::Initialize();
 	TextureManager::Initialize();
+	MeshManager::Initialize();
 	AudioManager::Inititalize();
 	PipelineManager::Initialize();
 
@@ -144,6 +146,7 @@ bool Engine::Initialize(const std::string& windowName, Resolution resolution) {
 void Engine::Finalize() {
 	PipelineManager::Finalize();
 	AudioManager::Finalize();
+	MeshManager::Finalize();
 	TextureManager::Finalize();
 	ShaderManager::Finalize();
 	Mouse::Finalize();
@@ -721,6 +724,9 @@ void Engine::FrameStart() {
 	ImGui_ImplWin32_NewFrame();
 	ImGui::NewFrame();
 
+	// 前のフレームの要求からテクスチャのミップを入れ替える(前のフレームのGPUの処理は終わっているので、描画前ならすぐに入れ替えられる)
+	TextureManager::GetInstance()->UpdateStreaming();
+
 	// これから書き込むバックバッファのインデックスを取得
 	UINT backBufferIndex = engine->swapChain->GetCurrentBackBufferIndex();
 
@@ -750,6 +756,10 @@ void Engine::FrameEnd() {
 		return;
 	}
 
+	// 非同期読み込みが終わったメッシュとテクスチャを転送する(このフレームのコマンドリストで転送して、下でフェンスを待つ)
+	MeshManager::GetInstance()->UploadLoadedMeshes();
+	TextureManager::GetInstance()->UploadLoadedTextures();
+
 	// 描画先をRTVを設定する
 	UINT backBufferIndex = engine->swapChain->GetCurrentBackBufferIndex();
 	auto dsvH = engine->dsvHeap->GetCPUDescriptorHandleForHeapStart();
@@ -811,10 +821,6 @@ void Engine::FrameEnd() {
 	if (!SUCCEEDED(hr)) {
 		ErrorCheck::GetInstance()->ErrorTextBox("CommandList->Reset() Failed", "Engine");
 	}
-	
-	TextureManager::GetInstance()->ThreadLoadTexture();
-	TextureManager::GetInstance()->ResetCommandList();
-	
 
 	// このフレームで画像読み込みが発生していたら開放する
 	// またUnloadされていたらそれをコンテナから削除する
@@ -2,6 +2,7 @@
 #include "Engine/Engine.h"
 #include "Engine/ConvertString/ConvertString.h"
 #include <cassert>
+#include <algorithm>
 
 ShaderResourceHeap::ShaderResourceHeap() :
 	SRVHeap(),
@@ -9,7 +10,8 @@ ShaderResourceHeap::ShaderResourceHeap() :
 	descriptorRanges(0),
 	heapSize(4),
 	currentHadleIndex(),
-	heapHadles(0)
+	heapHadles(0),
+	textureViews()
 {
 	SRVHeap = Engine::CreateDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, heapSize, true);
 
@@ -40,7 +42,8 @@ ShaderResourceHeap::ShaderResourceHeap(uint16_t numDescriptor) :
 	descriptorRanges(0),
 	heapSize(numDescriptor),
 	currentHadleIndex(0),
-	heapHadles(0)
+	heapHadles(0),
+	textureViews()
 {
 	SRVHeap = Engine::CreateDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, numDescriptor, true);
 
@@ -71,6 +74,7 @@ ShaderResourceHeap& ShaderResourceHeap::operator=(const ShaderResourceHeap& righ
 
 	heapSize = right.heapSize;
 	currentHadleIndex = right.currentHadleIndex;
+	textureViews = right.textureViews;
 
 	heapHadles.clear();
 	heapHadles.reserve(heapSize);
@@ -95,6 +99,7 @@ ShaderResourceHeap& ShaderResourceHeap::operator=(ShaderResourceHeap&& right) no
 
 	heapSize = std::move(right.heapSize);
 	currentHadleIndex = std::move(right.currentHadleIndex);
+	textureViews = std::move(right.textureViews);
 
 	heapHadles.clear();
 	heapHadles.reserve(heapSize);
@@ -117,6 +122,7 @@ void ShaderResourceHeap::InitializeReset() {
 	heapOrder.clear();
 	descriptorRanges.clear();
 	heapHadles.clear();
+	textureViews.clear();
 	heapSize = 4;
 	currentHadleIndex = 0;
 
@@ -140,6 +146,7 @@ void ShaderResourceHeap::InitializeReset(uint32_t numDescriptor) {
 	heapOrder.clear();
 	descriptorRanges.clear();
 	heapHadles.clear();
+	textureViews.clear();
 	heapSize = numDescriptor;
 	currentHadleIndex = 0;
 
@@ -158,6 +165,7 @@ void ShaderResourceHeap::InitializeReset(uint32_t numDescriptor) {
 }
 
 void ShaderResourceHeap::Use() {
+	UpdateTextureViews();
 	auto commandlist = Engine::GetCommandList();
 	commandlist->SetDescriptorHeaps(1, SRVHeap.GetAddressOf());
 	auto SrvHandle = SRVHeap->GetGPUDescriptorHandleForHeapStart();
@@ -165,11 +173,36 @@ void ShaderResourceHeap::Use() {
 }
 
 void ShaderResourceHeap::Use(D3D12_GPU_DESCRIPTOR_HANDLE handle) {
+	UpdateTextureViews();
 	auto commandlist = Engine::GetCommandList();
 	commandlist->SetDescriptorHeaps(1, SRVHeap.GetAddressOf());
 	commandlist->SetGraphicsRootDescriptorTable(0, handle);
 }
 
+void ShaderResourceHeap::AddTextureView(Texture* tex, uint32_t heapIndex) {
+	auto view = std::find_if(textureViews.begin(), textureViews.end(),
+		[heapIndex](const TextureView& textureView) {
+			return textureView.heapIndex == heapIndex;
+		}
+	);
+	if (view == textureViews.end()) {
+		view = textureViews.insert(textureViews.end(), TextureView{});
+	}
+	view->texture = tex;
+	view->heapIndex = heapIndex;
+	view->viewVersion = tex->GetViewVersion();
+}
+
+void ShaderResourceHeap::UpdateTextureViews() {
+	// ストリーミングしないテクスチャはバージョンが変わらないので何もしない
+	for (auto& view : textureViews) {
+		if (view.viewVersion != view.texture->GetViewVersion()) {
+			view.texture->CreateSRVView(heapHadles[view.heapIndex].first);
+			view.viewVersion = view.texture->GetViewVersion();
+		}
+	}
+}
+
 D3D12_ROOT_PARAMETER ShaderResourceHeap::GetParameter() {
 	uint32_t descriptorNum = 1u;
 
@@ -253,4 +286,5 @@ void ShaderResourceHeap::Reset() {
 	currentHadleIndex = 0;
 	heapOrder.clear();
 	descriptorRanges.clear();
+	textureViews.clear();
 }
\ No newline at end of file
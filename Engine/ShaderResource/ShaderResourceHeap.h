@@ -16,6 +16,15 @@ private:
 		UAV
 	};
 
+	/// <summary>
+	/// テクスチャのビューを作った場所(ストリーミングでリソースが変わったらUse()で作り直す)
+	/// </summary>
+	struct TextureView {
+		Texture* texture = nullptr;
+		uint32_t heapIndex = 0u;
+		uint32_t viewVersion = 0u;
+	};
+
 public:
 	ShaderResourceHeap();
 	ShaderResourceHeap(const ShaderResourceHeap& right);
@@ -58,6 +67,7 @@ public:
 			ErrorCheck::GetInstance()->ErrorTextBox("CreateConstBufferView failed\nOver HeapSize", "ShaderResourceHeap");
 		}
 		tex->CreateSRVView(heapHadles[currentHadleIndex].first);
+		AddTextureView(tex, currentHadleIndex);
 		currentHadleIndex++;
 
 		heapOrder.push_back(HeapType::SRV);
@@ -71,6 +81,7 @@ public:
 			ErrorCheck::GetInstance()->ErrorTextBox("CreateConstBufferView failed\nOver HeapSize", "ShaderResourceHeap");
 		}
 		tex->CreateSRVView(heapHadles[heapIndex].first);
+		AddTextureView(tex, heapIndex);
 	}
 
 	D3D12_ROOT_PARAMETER GetParameter();
@@ -88,6 +99,14 @@ public:
 
 	void Reset();
 
+private:
+	void AddTextureView(Texture* tex, uint32_t heapIndex);
+
+	/// <summary>
+	/// リソースを作り直したテクスチャのビューを作り直す
+	/// </summary>
+	void UpdateTextureViews();
+
 private:
 	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> SRVHeap;
 
@@ -98,4 +117,6 @@ private:
 	std::vector<HeapType> heapOrder;
 
 	std::vector<D3D12_DESCRIPTOR_RANGE> descriptorRanges;
+
+	std::vector<TextureView> textureViews;
 };
\ No newline at end of file
@@ -0,0 +1,238 @@
+#include "Mesh.h"
+#include "Engine/Engine.h"
+#include "Engine/ErrorCheck/ErrorCheck.h"
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cassert>
+
+Mesh::Mesh() :
+	submeshes(),
+	SRVHeap(),
+	tex(),
+	aabb(),
+	boundingSphere(),
+	lodErrors(),
+	bvh(),
+	loadData(),
+	loadJob(),
+	textureLoadIds(),
+	fileName(),
+	refCount(0),
+	isLoad(false)
+{}
+
+Mesh::~Mesh() {
+	// 読み込みが終わった時にthisを使うので取り消す
+	CancelLoadTextures();
+	Unload();
+}
+
+void Mesh::Load(const std::string& objFileName) {
+	if (isLoad || IsLoading()) {
+		return;
+	}
+
+	fileName = objFileName;
+	loadData = MeshLoader::LoadCpuData(objFileName);
+	ReportLoadErrors();
+	if (loadData) {
+		LoadTextures();
+		Upload();
+	}
+}
+
+void Mesh::LoadTexturesAsync() {
+	assert(loadData);
+	auto textureManager = TextureManager::GetInstance();
+	std::vector<std::string> requestedFileNames;
+	for (auto& [mtlName, textureFileName] : loadData->materials) {
+		if (textureFileName.empty() ||
+			std::find(requestedFileNames.begin(), requestedFileNames.end(), textureFileName) != requestedFileNames.end()
+			) {
+			continue;
+		}
+		requestedFileNames.push_back(textureFileName);
+		textureLoadIds.push_back(textureManager->LoadTextureAsync(textureFileName, 0,
+			[this, textureFileName](Texture* texture) {
+				loadData->textures[textureFileName] = texture;
+			}
+		));
+	}
+}
+
+bool Mesh::IsLoadTexturesFinish() const {
+	auto textureManager = TextureManager::GetInstance();
+	return std::none_of(textureLoadIds.begin(), textureLoadIds.end(),
+		[textureManager](TextureManager::LoadId id) {
+			return textureManager->IsLoading(id);
+		}
+	);
+}
+
+void Mesh::LoadTextures() {
+	assert(loadData);
+	CancelLoadTextures();
+	auto textureManager = TextureManager::GetInstance();
+	for (auto& [mtlName, textureFileName] : loadData->materials) {
+		if (textureFileName.empty() || loadData->textures.contains(textureFileName)) {
+			continue;
+		}
+		// 読み込み済みならデコードしない
+		Texture* texture = textureManager->FindTexture(textureFileName);
+		if (texture == nullptr) {
+			texture = textureManager->LoadTexture(textureFileName, TextureManager::DecodeTexture(textureFileName));
+		}
+		loadData->textures[textureFileName] = texture;
+	}
+}
+
+void Mesh::CancelLoadTextures() {
+	// TextureManagerが先に終了している時は取り消すものが無い
+	auto textureManager = TextureManager::GetInstance();
+	if (textureManager) {
+		for (auto id : textureLoadIds) {
+			textureManager->CancelLoad(id);
+		}
+	}
+	textureLoadIds.clear();
+}
+
+void Mesh::ReportLoadErrors() {
+	assert(loadData);
+	for (auto& errorText : loadData->errorTexts) {
+		ErrorCheck::GetInstance()->ErrorTextBox(errorText, "Mesh");
+	}
+	loadData->errorTexts.clear();
+	if (!loadData->isSucceeded) {
+		loadData.reset();
+	}
+}
+
+void Mesh::Upload() {
+	assert(loadData);
+	if (!loadData || isLoad) {
+		return;
+	}
+
+	for (auto& [mtlName, textureFileName] : loadData->materials) {
+		auto& texture = tex[mtlName];
+		auto& heap = SRVHeap[mtlName];
+		heap.InitializeReset(16);
+
+		if (!textureFileName.empty()) {
+			auto loaded = loadData->textures.find(textureFileName);
+			texture = loaded != loadData->textures.end() ? loaded->second : nullptr;
+		}
+		if (texture == nullptr || !(*texture)) {
+			texture = TextureManager::GetInstance()->GetWhiteTex();
+		}
+		heap.CreateTxtureView(texture);
+	}
+
+	const MeshCache& meshCache = loadData->meshCache;
+	aabb = meshCache.GetAABB();
+	boundingSphere = meshCache.GetSphere();
+
+	for (auto& cacheSubmesh : meshCache.GetSubmeshes()) {
+		auto& submesh = submeshes[std::string(cacheSubmesh.name)];
+		submesh.vertexBuffer = Engine::CreateBufferResuorce(cacheSubmesh.vertices.size());
+		assert(submesh.vertexBuffer);
+
+
+		// リソースの先頭のアドレスから使う
+		submesh.vertexView.BufferLocation = submesh.vertexBuffer->GetGPUVirtualAddress();
+		// 使用するリソースのサイズは頂点数分のサイズ
+		submesh.vertexView.SizeInBytes = static_cast<UINT>(cacheSubmesh.vertices.size());
+		// 1頂点当たりのサイズ
+		submesh.vertexView.StrideInBytes = sizeof(VertData);
+
+		// 頂点リソースにデータを書き込む
+		submesh.vertexMap = nullptr;
+		// 書き込むためのアドレスを取得
+		submesh.vertexBuffer->Map(0, nullptr, reinterpret_cast<void**>(&submesh.vertexMap));
+		std::memcpy(submesh.vertexMap, cacheSubmesh.vertices.data(), cacheSubmesh.vertices.size());
+
+		submesh.vertNum = cacheSubmesh.vertexNum;
+
+
+		submesh.indexBuffer = Engine::CreateBufferResuorce(cacheSubmesh.indices.size());
+		assert(submesh.indexBuffer);
+
+		submesh.indexView.BufferLocation = submesh.indexBuffer->GetGPUVirtualAddress();
+		submesh.indexView.SizeInBytes = static_cast<UINT>(cacheSubmesh.indices.size());
+		submesh.indexView.Format = cacheSubmesh.isIndex16 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+
+		void* indexMap = nullptr;
+		submesh.indexBuffer->Map(0, nullptr, &indexMap);
+		std::memcpy(indexMap, cacheSubmesh.indices.data(), cacheSubmesh.indices.size());
+		submesh.indexBuffer->Unmap(0, nullptr);
+
+		submesh.indexNum = cacheSubmesh.indexNum;
+
+		submesh.lods.clear();
+		for (auto& cacheLod : cacheSubmesh.lods) {
+			submesh.lods.push_back({ cacheLod.indexOffset, cacheLod.indexNum });
+
+			const size_t level = submesh.lods.size() - 1;
+			if (lodErrors.size() <= level) {
+				lodErrors.resize(level + 1, 0.0f);
+			}
+			lodErrors[level] = std::max(lodErrors[level], cacheLod.error);
+		}
+		submesh.meshlets.assign(cacheSubmesh.meshlets.begin(), cacheSubmesh.meshlets.end());
+		submesh.sourceVertexCache = cacheSubmesh.sourceVertexCache;
+		submesh.vertexCache = cacheSubmesh.vertexCache;
+
+		submesh.srvHeap = &SRVHeap[std::string(cacheSubmesh.name)];
+		auto texItr = tex.find(std::string(cacheSubmesh.name));
+		submesh.texture = texItr != tex.end() ? texItr->second : nullptr;
+		submesh.uvDensity = loadData->uvDensities[std::string(cacheSubmesh.name)];
+	}
+	bvh = std::move(loadData->bvh);
+
+	// マップしたキャッシュはもう使わない
+	loadData.reset();
+	textureLoadIds.clear();
+
+	isLoad = true;
+}
+
+void Mesh::Unload() {
+	for (auto& i : submeshes) {
+		if (i.second.vertexBuffer) {
+			i.second.vertexBuffer->Release();
+		}
+		if (i.second.indexBuffer) {
+			i.second.indexBuffer->Release();
+		}
+	}
+	submeshes.clear();
+	SRVHeap.clear();
+	tex.clear();
+	lodErrors.clear();
+	bvh.Clear();
+	loadData.reset();
+
+	isLoad = false;
+}
+
+D3D12_ROOT_PARAMETER Mesh::GetSRVParameter() {
+	return SRVHeap.begin()->second.GetParameter();
+}
+
+size_t Mesh::GetMeshletNum() const {
+	size_t meshletNum = 0;
+	for (auto& i : submeshes) {
+		meshletNum += i.second.meshlets.size();
+	}
+	return meshletNum;
+}
+
+size_t Mesh::GetBufferSize() const {
+	size_t bufferSize = 0;
+	for (auto& i : submeshes) {
+		bufferSize += i.second.vertexView.SizeInBytes + i.second.indexView.SizeInBytes;
+	}
+	return bufferSize;
+}
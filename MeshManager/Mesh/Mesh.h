@@ -0,0 +1,234 @@
+#pragma once
+#include "MeshLoader.h"
+#include "Utils/Math/Bounds.h"
+#include "Utils/MeshOptimizer/Meshlet.h"
+#include "Utils/MeshOptimizer/MeshOptimizer.h"
+#include "Utils/Bvh/TriangleBvh.h"
+#include "Engine/ShaderResource/ShaderResourceHeap.h"
+#include "TextureManager/TextureManager.h"
+#include "Utils/AsyncLoader/AsyncLoader.h"
+
+#include <d3d12.h>
+#include <wrl.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <span>
+#include <memory>
+#include <cstdint>
+
+/// <summary>
+/// 読み込んでGPUに転送したモデルの形状(同じファイルのModelで共有する)
+/// </summary>
+class Mesh {
+	friend class MeshManager;
+
+public:
+	using VertData = MeshLoader::VertData;
+
+	/// <summary>
+	/// 詳細度ごとのインデックスバッファ上の範囲
+	/// </summary>
+	struct Lod {
+		uint32_t indexOffset = 0;
+		uint32_t indexNum = 0;
+	};
+
+	/// <summary>
+	/// マテリアルごとの頂点とインデックス
+	/// </summary>
+	struct Submesh {
+		Microsoft::WRL::ComPtr<ID3D12Resource> vertexBuffer = nullptr;
+		// 頂点バッファビュー
+		D3D12_VERTEX_BUFFER_VIEW vertexView{};
+		// 頂点バッファマップ
+		VertData* vertexMap = nullptr;
+
+		// 頂点数(重複を取り除いた数)
+		uint32_t vertNum = 0;
+
+		Microsoft::WRL::ComPtr<ID3D12Resource> indexBuffer = nullptr;
+		// インデックスバッファビュー(頂点数が65536未満なら16bit)
+		D3D12_INDEX_BUFFER_VIEW indexView{};
+
+		// インデックス数(面の頂点数)
+		uint32_t indexNum = 0;
+
+		// 0番が元の形状で、後ろほど粗い(頂点は共有する)
+		std::vector<Lod> lods;
+
+		// 0番のLODを分けたもの(インデックスはメッシュレットごとに連続している)
+		std::vector<Meshlet> meshlets;
+
+		// 0番のLODの頂点キャッシュの効率(objの順番と並び替えた後。Model::Debug()で表示する)
+		VertexCacheStatistics sourceVertexCache;
+		VertexCacheStatistics vertexCache;
+
+		// 無いLODを指定されたら一番粗いものを使う
+		inline const Lod& GetLod(uint32_t level) const {
+			return lods[level < lods.size() ? level : lods.size() - 1];
+		}
+
+		// マテリアルのテクスチャ
+		ShaderResourceHeap* srvHeap = nullptr;
+		Texture* texture = nullptr;
+
+		// 形状の1単位あたりのUVの大きさ(LOD0の面積の比の平方根)
+		float uvDensity = 0.0f;
+	};
+
+private:
+	/// <summary>
+	/// ワーカースレッドで読み込んで、Upload()でGPUに転送するまで持っておくデータ
+	/// </summary>
+	using LoadData = MeshLoader::LoadData;
+	using CpuDataLoader = AsyncLoader<std::shared_ptr<LoadData>>;
+
+public:
+	Mesh();
+	~Mesh();
+
+	Mesh(const Mesh&) = delete;
+	Mesh(Mesh&&) noexcept = delete;
+
+	Mesh& operator=(const Mesh&) = delete;
+	Mesh& operator=(Mesh&&) noexcept = delete;
+
+public:
+	inline explicit operator bool() const noexcept {
+		return isLoad;
+	}
+
+	inline bool operator!() const noexcept {
+		return !isLoad;
+	}
+
+private:
+	/// <summary>
+	/// MeshLoader::LoadCpuData()、LoadTextures()、Upload()を続けて呼ぶ
+	/// </summary>
+	void Load(const std::string& objFileName);
+	/// <summary>
+	/// MeshLoader::LoadCpuData()で起きたエラーを出し、形状を読み込めていなければloadDataを捨てる
+	/// エラーウィンドウを出すので、メインスレッドで結果を受け取った時に呼ぶ
+	/// </summary>
+	void ReportLoadErrors();
+	/// <summary>
+	/// マテリアルのテクスチャをTextureManager::LoadTextureAsync()で読み込み始める(読み込み済みのファイルはデコードしない)
+	/// </summary>
+	void LoadTexturesAsync();
+	/// <summary>
+	/// LoadTexturesAsync()で始めた読み込みが全て終わったか
+	/// </summary>
+	bool IsLoadTexturesFinish() const;
+	/// <summary>
+	/// 読み込みが終わっていないテクスチャをここで読み込む(非同期の読み込みは取り消す)
+	/// </summary>
+	void LoadTextures();
+	/// <summary>
+	/// 非同期のテクスチャの読み込みを取り消す
+	/// </summary>
+	void CancelLoadTextures();
+	/// <summary>
+	/// MeshLoader::LoadCpuData()で読み込んだデータと読み込んだテクスチャからバッファとビューを作る
+	/// メインスレッドでEngineのコマンドリストが開いている間に呼ぶ
+	/// </summary>
+	void Upload();
+	/// <summary>
+	/// 非同期読み込み中か(終わっていてもUpload()前ならtrue)
+	/// </summary>
+	inline bool IsLoading() const {
+		return loadJob || loadData;
+	}
+
+	void Unload();
+
+public:
+	/// <summary>
+	/// ルートシグネチャ用のテクスチャのパラメーター
+	/// </summary>
+	D3D12_ROOT_PARAMETER GetSRVParameter();
+
+	inline const std::unordered_map<std::string, Submesh>& GetSubmeshes() const {
+		return submeshes;
+	}
+
+	/// <summary>
+	/// ローカル座標でのAABB
+	/// </summary>
+	inline const AABB& GetAABB() const {
+		return aabb;
+	}
+	/// <summary>
+	/// ローカル座標での境界球
+	/// </summary>
+	inline const Sphere& GetBoundingSphere() const {
+		return boundingSphere;
+	}
+
+	/// <summary>
+	/// 各LODの元の形状との誤差(ローカル座標の距離、全サブメッシュの最大)
+	/// </summary>
+	inline std::span<const float> GetLodErrors() const {
+		return lodErrors;
+	}
+	inline uint32_t GetLodNum() const {
+		return static_cast<uint32_t>(lodErrors.size());
+	}
+
+	/// <summary>
+	/// 全サブメッシュのLOD0の三角形のBVH(ローカル座標。Load時に作る)
+	/// </summary>
+	inline const TriangleBvh& GetBvh() const {
+		return bvh;
+	}
+
+	/// <summary>
+	/// 全サブメッシュのメッシュレットの数
+	/// </summary>
+	size_t GetMeshletNum() const;
+
+	/// <summary>
+	/// GPUに確保している頂点とインデックスのバイト数
+	/// </summary>
+	size_t GetBufferSize() const;
+
+	inline const std::string& GetFileName() const {
+		return fileName;
+	}
+
+	/// <summary>
+	/// このメッシュを使っているModelの数
+	/// </summary>
+	inline uint32_t GetRefCount() const {
+		return refCount;
+	}
+
+private:
+	std::unordered_map<std::string, Submesh> submeshes;
+
+	std::unordered_map<std::string, ShaderResourceHeap> SRVHeap;
+	std::unordered_map<std::string, Texture*> tex;
+
+	AABB aabb;
+	Sphere boundingSphere;
+
+	std::vector<float> lodErrors;
+
+	TriangleBvh bvh;
+
+	std::shared_ptr<LoadData> loadData;
+	/// <summary>
+	/// MeshManagerのワーカースレッドでのMeshLoader::LoadCpuData()(終わったらMeshManagerがloadDataに移す)
+	/// </summary>
+	CpuDataLoader::Handle loadJob;
+	/// <summary>
+	/// 終わっていないテクスチャの非同期読み込み
+	/// </summary>
+	std::vector<TextureManager::LoadId> textureLoadIds;
+
+	std::string fileName;
+	uint32_t refCount;
+	bool isLoad;
+};
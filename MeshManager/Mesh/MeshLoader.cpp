@@ -0,0 +1,227 @@
+#include "MeshLoader.h"
+#include "Drawers/Model/ObjLoader/ObjLoader.h"
+#include "Utils/MeshOptimizer/MeshOptimizer.h"
+#include "Utils/MeshOptimizer/MeshSimplifier.h"
+#include "Utils/MeshOptimizer/Meshlet.h"
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <filesystem>
+#include <cstring>
+#include <cmath>
+
+std::shared_ptr<MeshLoader::LoadData> MeshLoader::LoadCpuData(const std::string& objFileName) {
+	auto data = std::make_shared<LoadData>();
+
+	// 変換済みのキャッシュがあればそれを使い、無ければobjから作って書き出す
+	MeshCache& meshCache = data->meshCache;
+	if (!meshCache.Load(objFileName, sizeof(VertData))) {
+		std::string errorText;
+		if (!CreateMeshCache(objFileName, meshCache, errorText)) {
+			data->errorTexts.push_back("LoadCpuData() : Failed to load objFile : " + objFileName + "\n" + errorText);
+			return data;
+		}
+		meshCache.Save();
+	}
+
+	for (auto& mtlFileName : meshCache.GetMtlFileNames()) {
+		std::filesystem::path path = objFileName;
+		const std::string mtlFilePath = path.parent_path().string() + "/" + mtlFileName;
+		if (!LoadMtl(mtlFilePath, data->materials)) {
+			data->errorTexts.push_back("LoadMtl() : Not Found mtlFile : " + mtlFilePath);
+		}
+	}
+
+	// レイキャスト用に全サブメッシュのLOD0の三角形を集めてBVHを作る
+	std::vector<Vector3> bvhPositions;
+	std::vector<uint32_t> bvhIndices;
+	for (auto& cacheSubmesh : meshCache.GetSubmeshes()) {
+		const uint32_t vertexOffset = static_cast<uint32_t>(bvhPositions.size());
+		const VertData* vertices = reinterpret_cast<const VertData*>(cacheSubmesh.vertices.data());
+		for (uint32_t i = 0; i < cacheSubmesh.vertexNum; i++) {
+			bvhPositions.push_back(vertices[i].position.GetVector3());
+		}
+		const MeshCache::Lod& lod0 = cacheSubmesh.lods.front();
+		const size_t indexOffset = bvhIndices.size();
+		for (uint32_t i = lod0.indexOffset; i < lod0.indexOffset + lod0.indexNum; i++) {
+			uint32_t index = 0;
+			if (cacheSubmesh.isIndex16) {
+				uint16_t index16 = 0;
+				std::memcpy(&index16, cacheSubmesh.indices.data() + i * sizeof(uint16_t), sizeof(uint16_t));
+				index = index16;
+			}
+			else {
+				std::memcpy(&index, cacheSubmesh.indices.data() + i * sizeof(uint32_t), sizeof(uint32_t));
+			}
+			bvhIndices.push_back(vertexOffset + index);
+		}
+
+		// テクスチャのストリーミングで画面上の大きさからミップを決めるために、UVの面積と形状の面積の比を求める
+		float uvArea = 0.0f;
+		float area = 0.0f;
+		for (size_t i = indexOffset; i + 2 < bvhIndices.size(); i += 3) {
+			const VertData& vertex0 = vertices[bvhIndices[i] - vertexOffset];
+			const VertData& vertex1 = vertices[bvhIndices[i + 1] - vertexOffset];
+			const VertData& vertex2 = vertices[bvhIndices[i + 2] - vertexOffset];
+			const Vector2 uvEdge1 = vertex1.uv - vertex0.uv;
+			const Vector2 uvEdge2 = vertex2.uv - vertex0.uv;
+			uvArea += std::abs(uvEdge1.x * uvEdge2.y - uvEdge1.y * uvEdge2.x);
+			area += (vertex1.position.GetVector3() - vertex0.position.GetVector3()).Cross(vertex2.position.GetVector3() - vertex0.position.GetVector3()).Length();
+		}
+		data->uvDensities[std::string(cacheSubmesh.name)] = 0.0f < area ? std::sqrt(uvArea / area) : 0.0f;
+	}
+	data->bvh.Build(bvhPositions, bvhIndices);
+	data->isSucceeded = true;
+
+	return data;
+}
+
+bool MeshLoader::CreateMeshCache(const std::string& objFileName, MeshCache& meshCache, std::string& errorText) {
+	ObjLoader objLoader;
+	if (!objLoader.Load(objFileName)) {
+		errorText = objLoader.GetErrorText();
+		return false;
+	}
+	// vnが無い面は面の向きから法線を作る
+	objLoader.GenerateMissingNormals(kNormalSmoothAngle);
+
+	const auto& posDatas = objLoader.GetPositions();
+	const auto& normalDatas = objLoader.GetNormals();
+	const auto& uvDatas = objLoader.GetUvs();
+	const auto& indexDatas = objLoader.GetIndices();
+
+	// カリング用の境界
+	std::vector<Vector3> positions(posDatas.size());
+	std::transform(posDatas.begin(), posDatas.end(), positions.begin(),
+		[](const Vector4& pos) {
+			return pos.GetVector3();
+		}
+	);
+	AABB meshAABB = MakeAABB(positions);
+	Sphere meshSphere = MakeSphere(meshAABB, positions);
+
+	std::vector<std::vector<VertData>> vertexDatas;
+	std::vector<std::vector<uint32_t>> indices;
+	std::vector<std::vector<MeshCache::Lod>> lods;
+	std::vector<std::vector<Meshlet>> meshlets;
+	vertexDatas.reserve(indexDatas.size());
+	indices.reserve(indexDatas.size());
+	lods.reserve(indexDatas.size());
+	meshlets.reserve(indexDatas.size());
+	std::vector<MeshCache::SubmeshSource> cacheSubmeshes;
+
+	std::vector<ObjLoader::IndexData> vertices;
+	std::vector<Vector3> meshPositions;
+	std::vector<uint32_t> lodIndices;
+	const float lodMaxError = meshSphere.radius * kLodMaxErrorRate;
+	for (auto& [mtlName, corners] : indexDatas) {
+		if (corners.empty()) {
+			continue;
+		}
+
+		// 同じ頂点をまとめてインデックスで描画する
+		auto& meshIndices = indices.emplace_back();
+		ObjLoader::Deduplicate(corners, vertices, meshIndices);
+		const VertexCacheStatistics sourceVertexCache = AnalyzeVertexCache(meshIndices, vertices.size());
+
+		// 頂点キャッシュ、オーバードローの順に並び替えてから、メッシュレットに分けて頂点フェッチ順に並び替える
+		// メッシュレットはその順番で隣から埋めていくので、並びがおおよそ保たれる
+		meshPositions.resize(vertices.size());
+		std::transform(vertices.begin(), vertices.end(), meshPositions.begin(),
+			[&posDatas](const ObjLoader::IndexData& vertex) {
+				return posDatas[vertex.vertNum].GetVector3();
+			}
+		);
+		OptimizeVertexCache(meshIndices, vertices.size());
+		OptimizeOverdraw(meshIndices, meshPositions);
+		auto& meshMeshlets = meshlets.emplace_back(BuildMeshlets(meshIndices, meshPositions, kMeshletMaxVertexNum, kMeshletMaxTriangleNum));
+		RemapVertices(vertices, OptimizeVertexFetch(meshIndices, vertices.size()));
+		const VertexCacheStatistics vertexCache = AnalyzeVertexCache(meshIndices, vertices.size());
+
+		auto& meshVertices = vertexDatas.emplace_back(vertices.size());
+		for (size_t j = 0; j < vertices.size(); j++) {
+			meshVertices[j].position = posDatas[vertices[j].vertNum];
+			meshVertices[j].normal = normalDatas[vertices[j].normalNum];
+			if (!uvDatas.empty()) {
+				meshVertices[j].uv = uvDatas[vertices[j].uvNum];
+			}
+		}
+
+		// 三角形を減らしたLODを作って、同じ頂点を使うインデックスとして後ろにつなげる
+		std::transform(meshVertices.begin(), meshVertices.end(), meshPositions.begin(),
+			[](const VertData& vertex) {
+				return vertex.position.GetVector3();
+			}
+		);
+		auto& meshLods = lods.emplace_back();
+		meshLods.push_back({ 0u, static_cast<uint32_t>(meshIndices.size()), 0.0f });
+		for (uint32_t level = 1; level < kMaxLodNum; level++) {
+			// 誤差が積み重ならないように毎回元の形状から減らす
+			lodIndices.assign(meshIndices.begin(), meshIndices.begin() + meshLods.front().indexNum);
+			const size_t targetIndexNum = (lodIndices.size() >> level) / 3 * 3;
+			float error = SimplifyMesh(lodIndices, meshPositions, targetIndexNum, lodMaxError);
+
+			// 前のLODからほとんど減らなければ意味が無いのでやめる
+			if (static_cast<size_t>(meshLods.back().indexNum) * 9 / 10 < lodIndices.size()) {
+				break;
+			}
+
+			OptimizeVertexCache(lodIndices, meshVertices.size());
+			meshLods.push_back({
+				static_cast<uint32_t>(meshIndices.size()),
+				static_cast<uint32_t>(lodIndices.size()),
+				std::max(error, meshLods.back().error)
+				});
+			meshIndices.insert(meshIndices.end(), lodIndices.begin(), lodIndices.end());
+		}
+
+		auto& cacheSubmesh = cacheSubmeshes.emplace_back();
+		cacheSubmesh.name = mtlName;
+		cacheSubmesh.vertices = std::as_bytes(std::span<const VertData>(meshVertices));
+		cacheSubmesh.vertexNum = static_cast<uint32_t>(meshVertices.size());
+		cacheSubmesh.indices = meshIndices;
+		cacheSubmesh.lods = meshLods;
+		cacheSubmesh.meshlets = meshMeshlets;
+		cacheSubmesh.sourceVertexCache = sourceVertexCache;
+		cacheSubmesh.vertexCache = vertexCache;
+	}
+
+	if (!meshCache.Create(objFileName, sizeof(VertData), cacheSubmeshes, meshAABB, meshSphere, objLoader.GetMtlFileNames())) {
+		errorText = "CreateMeshCache() : Failed to create meshCache";
+		return false;
+	}
+	return true;
+}
+
+bool MeshLoader::LoadMtl(const std::string& mtlFileName, std::vector<std::pair<std::string, std::string>>& materials) {
+	std::ifstream file(mtlFileName);
+	if (!file) {
+		return false;
+	}
+
+	std::string lineBuf;
+	std::filesystem::path path = mtlFileName;
+
+	while (std::getline(file, lineBuf)) {
+		std::string identifier;
+		std::istringstream line(lineBuf);
+
+		line >> identifier;
+		if (identifier == "map_Kd") {
+			std::string texName;
+			line >> texName;
+
+			// シェーダーは最初のテクスチャしか使わない
+			if (!materials.empty() && materials.back().second.empty()) {
+				materials.back().second = path.parent_path().string() + "/" + texName;
+			}
+		}
+		else if (identifier == "newmtl") {
+			std::string useMtlName;
+			line >> useMtlName;
+			materials.emplace_back(useMtlName, std::string());
+		}
+	}
+	return true;
+}
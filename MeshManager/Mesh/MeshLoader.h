@@ -0,0 +1,102 @@
+#pragma once
+#include "Utils/Math/Vector4.h"
+#include "Utils/Math/Vector3.h"
+#include "Utils/Math/Vector2.h"
+#include "Utils/Bvh/TriangleBvh.h"
+#include "Drawers/Model/MeshCache/MeshCache.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <utility>
+#include <memory>
+#include <cstdint>
+#include <numbers>
+
+class Texture;
+
+/// <summary>
+/// GPUに転送する前までのMeshの読み込み(キャッシュ、mtl、BVH)
+/// GPUもエラーウィンドウも使わないので、MeshManagerのワーカースレッドから呼べる
+/// 起きたエラーはLoadDataに入れて返し、メインスレッドのMeshが出す
+/// </summary>
+class MeshLoader {
+public:
+	struct VertData {
+		Vector4 position;
+		Vector3 normal;
+		Vector2 uv;
+	};
+
+	/// <summary>
+	/// ワーカースレッドで読み込んで、Mesh::Upload()でGPUに転送するまで持っておくデータ
+	/// </summary>
+	struct LoadData {
+		MeshCache meshCache;
+		/// <summary>
+		/// マテリアル名とテクスチャのファイル名(無ければ空)
+		/// </summary>
+		std::vector<std::pair<std::string, std::string>> materials;
+		/// <summary>
+		/// 読み込みが終わったテクスチャ(キー値: ファイル名。失敗したらnullptr)
+		/// </summary>
+		std::unordered_map<std::string, Texture*> textures;
+		/// <summary>
+		/// サブメッシュごとのUVの密度(キー値: サブメッシュ名)
+		/// </summary>
+		std::unordered_map<std::string, float> uvDensities;
+		TriangleBvh bvh;
+
+		/// <summary>
+		/// 読み込み中に起きたエラー(mtlが無いだけなら形状の読み込みは続ける)
+		/// </summary>
+		std::vector<std::string> errorTexts;
+		/// <summary>
+		/// 形状を読み込めたか(falseならerrorTextsに理由がある)
+		/// </summary>
+		bool isSucceeded = false;
+	};
+
+public:
+	/// <summary>
+	/// 作るLODの最大数(元の形状を含む)。1段ごとに三角形の数を半分にする
+	/// </summary>
+	static constexpr uint32_t kMaxLodNum = 4;
+	/// <summary>
+	/// 簡略化で許容する誤差(境界球の半径に対する割合)
+	/// </summary>
+	static constexpr float kLodMaxErrorRate = 0.05f;
+
+	/// <summary>
+	/// メッシュレット1つの頂点数と三角形数の上限
+	/// </summary>
+	static constexpr uint32_t kMeshletMaxVertexNum = 64;
+	static constexpr uint32_t kMeshletMaxTriangleNum = 124;
+
+	/// <summary>
+	/// objに法線が無い時に、スムージンググループの面で平均する面同士の角度の上限(60度)
+	/// </summary>
+	static constexpr float kNormalSmoothAngle = std::numbers::pi_v<float> / 3.0f;
+
+public:
+	MeshLoader() = delete;
+
+public:
+	/// <summary>
+	/// 変換済みのキャッシュを読み込み(無ければobjから作って書き出す)、mtlとBVHを読み込む
+	/// </summary>
+	/// <returns>失敗してもnullptrにはせず、isSucceededとerrorTextsで返す</returns>
+	static std::shared_ptr<LoadData> LoadCpuData(const std::string& objFileName);
+
+	/// <summary>
+	/// mtlファイルからマテリアル名とテクスチャのファイル名(無ければ空)を読む
+	/// </summary>
+	/// <returns>ファイルを開けたか</returns>
+	static bool LoadMtl(const std::string& mtlFileName, std::vector<std::pair<std::string, std::string>>& materials);
+
+	/// <summary>
+	/// objを読み込んで、法線の生成、頂点の重複削除と並び替え、メッシュレット分割、LOD作成をしたキャッシュを作る
+	/// </summary>
+	/// <param name="errorText">失敗した理由</param>
+	static bool CreateMeshCache(const std::string& objFileName, MeshCache& meshCache, std::string& errorText);
+};
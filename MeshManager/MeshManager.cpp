@@ -0,0 +1,180 @@
+#include "MeshManager.h"
+#include "externals/imgui/imgui.h"
+#include <algorithm>
+#include <cassert>
+
+MeshManager* MeshManager::instance = nullptr;
+
+MeshManager* MeshManager::GetInstance() {
+	return instance;
+}
+
+void MeshManager::Initialize() {
+	instance = new MeshManager();
+	assert(instance);
+}
+
+void MeshManager::Finalize() {
+	delete instance;
+	instance = nullptr;
+}
+
+MeshManager::MeshManager() :
+	meshes(),
+	loadingMeshes(),
+	loader(&MeshLoader::LoadCpuData, kLoadThreadNum)
+{}
+
+MeshManager::~MeshManager() {
+	// ワーカースレッドはMeshを触らないので、読み込み中でも先に解放してよい
+	loadingMeshes.clear();
+	meshes.clear();
+}
+
+Mesh* MeshManager::LoadObj(const std::string& fileName) {
+	auto itr = meshes.find(fileName);
+	if (itr == meshes.end()) {
+		auto mesh = std::make_unique<Mesh>();
+		mesh->Load(fileName);
+		if (!mesh->isLoad) {
+			return nullptr;
+		}
+
+		itr = meshes.insert(std::make_pair(fileName, std::move(mesh))).first;
+	}
+	else if (itr->second->IsLoading()) {
+		// 非同期読み込み中ならここで読み込みを終わらせて転送する
+		Mesh* mesh = itr->second.get();
+		std::erase(loadingMeshes, mesh);
+		if (!FinishLoad(mesh) && mesh->refCount == 0) {
+			meshes.erase(itr);
+			return nullptr;
+		}
+	}
+
+	if (!(*itr->second)) {
+		return nullptr;
+	}
+
+	itr->second->refCount++;
+
+	return itr->second.get();
+}
+
+Mesh* MeshManager::LoadObjAsync(const std::string& fileName) {
+	auto itr = meshes.find(fileName);
+	if (itr == meshes.end()) {
+		auto mesh = std::make_unique<Mesh>();
+		mesh->fileName = fileName;
+		mesh->loadJob = loader.Request(fileName);
+		loadingMeshes.push_back(mesh.get());
+
+		itr = meshes.insert(std::make_pair(fileName, std::move(mesh))).first;
+	}
+
+	itr->second->refCount++;
+
+	return itr->second.get();
+}
+
+void MeshManager::UploadLoadedMeshes() {
+	TakeLoadedMeshes();
+
+	for (auto itr = loadingMeshes.begin(); itr != loadingMeshes.end();) {
+		Mesh* mesh = *itr;
+		if (mesh->loadJob || !mesh->IsLoadTexturesFinish()) {
+			++itr;
+			continue;
+		}
+		itr = loadingMeshes.erase(itr);
+
+		// 失敗したMeshはfalseのまま残して、使っているModelは描画しない(エラーはTakeLoadedMeshes()で出している)
+		if (mesh->loadData) {
+			mesh->Upload();
+		}
+	}
+}
+
+void MeshManager::TakeLoadedMeshes() {
+	for (auto& job : loader.TakeLoaded()) {
+		// 取り消した後に終わったものは捨てる
+		auto itr = meshes.find(job->GetKey());
+		if (itr == meshes.end() || itr->second->loadJob != job) {
+			continue;
+		}
+
+		Mesh* mesh = itr->second.get();
+		mesh->loadJob.reset();
+		mesh->loadData = std::move(job->GetResult());
+		// ワーカースレッドで起きたエラーはここで出す
+		mesh->ReportLoadErrors();
+		if (mesh->loadData) {
+			mesh->LoadTexturesAsync();
+		}
+	}
+}
+
+bool MeshManager::FinishLoad(Mesh* mesh) {
+	if (mesh->loadJob) {
+		if (loader.CancelIfQueued(mesh->loadJob)) {
+			// まだ待っているなら、取り消してこのスレッドで読み込む
+			mesh->loadJob.reset();
+			mesh->loadData = MeshLoader::LoadCpuData(mesh->fileName);
+			mesh->ReportLoadErrors();
+		}
+		else {
+			// 読み込み中なら同じファイルを二重に読み込まないように終わるのを待ち、結果を受け取る
+			loader.Wait(mesh->loadJob);
+			TakeLoadedMeshes();
+		}
+	}
+
+	if (mesh->loadData) {
+		mesh->LoadTextures();
+		mesh->Upload();
+	}
+	return mesh->isLoad;
+}
+
+void MeshManager::ReleaseObj(Mesh* mesh) {
+	if (!mesh) {
+		return;
+	}
+
+	auto itr = meshes.find(mesh->fileName);
+	assert(itr != meshes.end() && itr->second.get() == mesh);
+	if (itr == meshes.end() || itr->second.get() != mesh) {
+		return;
+	}
+
+	mesh->refCount--;
+	if (mesh->refCount == 0) {
+		// 読み込み中なら取り消す(ワーカースレッドはMeshを触らないので、すぐに解放してよい)
+		if (mesh->loadJob) {
+			loader.Cancel(mesh->loadJob);
+		}
+		std::erase(loadingMeshes, mesh);
+		meshes.erase(itr);
+	}
+}
+
+void MeshManager::Debug(const std::string& guiName) {
+	size_t bufferSize = 0;
+	size_t savedBufferSize = 0;
+
+	ImGui::Begin(guiName.c_str());
+	for (auto& i : meshes) {
+		if (!(*i.second)) {
+			ImGui::Text("%s : ref %u, %s", i.first.c_str(), i.second->refCount, i.second->IsLoading() ? "loading" : "failed");
+			continue;
+		}
+		const size_t meshBufferSize = i.second->GetBufferSize();
+		bufferSize += meshBufferSize;
+		// Modelごとに読み込んでいた時に増えていた分
+		savedBufferSize += meshBufferSize * (i.second->refCount - 1);
+		ImGui::Text("%s : ref %u, %zu KB", i.first.c_str(), i.second->refCount, meshBufferSize / 1024);
+	}
+	ImGui::Text("buffer %zu KB (saved %zu KB)", bufferSize / 1024, savedBufferSize / 1024);
+	ImGui::Text("loading %zu", loadingMeshes.size());
+	ImGui::End();
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include "Mesh/Mesh.h"
+
+#include <unordered_map>
+#include <string>
+#include <memory>
+#include <vector>
+
+class MeshManager {
+public:
+	/// <summary>
+	/// objを読み込むワーカースレッドの数
+	/// </summary>
+	static constexpr uint32_t kLoadThreadNum = 2u;
+
+private:
+	MeshManager();
+	MeshManager(const MeshManager&) = delete;
+	MeshManager(MeshManager&&) noexcept = delete;
+	~MeshManager();
+
+	MeshManager& operator=(const MeshManager&) = delete;
+	MeshManager& operator=(MeshManager&&) noexcept = delete;
+
+public:
+	static MeshManager* GetInstance();
+
+	static void Initialize();
+
+	static void Finalize();
+
+private:
+	static MeshManager* instance;
+
+
+public:
+	/// <summary>
+	/// objを読み込む(読み込み済みなら同じMeshを返して参照数を増やす)
+	/// </summary>
+	/// <param name="fileName">objファイルパス</param>
+	/// <returns>読み込みに失敗したらnullptr</returns>
+	Mesh* LoadObj(const std::string& fileName);
+
+	/// <summary>
+	/// objの読み込みをワーカースレッドで始めてすぐに返す(読み込み済み、読み込み中なら同じMeshを返して参照数を増やす)
+	/// GPUへの転送はUploadLoadedMeshes()で行うので、それまでMeshはfalseになる
+	/// </summary>
+	/// <param name="fileName">objファイルパス</param>
+	/// <returns>読み込み中のMesh</returns>
+	Mesh* LoadObjAsync(const std::string& fileName);
+
+	/// <summary>
+	/// ワーカースレッドの処理が終わったMeshのテクスチャの読み込みを始め、テクスチャまで読み込めたMeshをGPUに転送する
+	/// Engineのコマンドリストを閉じる前に、TextureManager::UploadLoadedTextures()より先に毎フレーム呼ぶ
+	/// </summary>
+	void UploadLoadedMeshes();
+
+	/// <summary>
+	/// 非同期読み込み中のMeshの数
+	/// </summary>
+	inline size_t GetLoadingNum() const {
+		return loadingMeshes.size();
+	}
+
+	/// <summary>
+	/// 参照数を減らして、誰も使わなくなったら解放する(読み込み中なら取り消す)
+	/// </summary>
+	/// <param name="mesh">LoadObjで受け取ったMesh</param>
+	void ReleaseObj(Mesh* mesh);
+
+	/// <summary>
+	/// 読み込んだメッシュと共有で節約できたバッファのサイズを表示する
+	/// </summary>
+	void Debug(const std::string& guiName);
+
+private:
+	/// <summary>
+	/// ワーカースレッドの処理が終わったMeshにデータを移してエラーを出し、テクスチャの読み込みを始める
+	/// </summary>
+	void TakeLoadedMeshes();
+
+	/// <summary>
+	/// 非同期読み込み中のMeshをここで読み込んで転送する
+	/// ワーカースレッドがまだ始めていなければ取り消してここで読み込み、読み込み中なら終わるのを待つ
+	/// </summary>
+	/// <returns>読み込めたか</returns>
+	bool FinishLoad(Mesh* mesh);
+
+private:
+	/// <summary>
+	/// Meshのコンテナ(キー値: ファイルネーム  コンテナデータ型: Mesh*)
+	/// </summary>
+	std::unordered_map<std::string, std::unique_ptr<Mesh>> meshes;
+
+	/// <summary>
+	/// 非同期読み込み中のMesh(meshesが持っている)
+	/// </summary>
+	std::vector<Mesh*> loadingMeshes;
+
+	/// <summary>
+	/// objの読み込み(キャッシュ、mtl、BVH)をするワーカースレッド
+	/// </summary>
+	Mesh::CpuDataLoader loader;
+};
@@ -17,8 +17,9 @@ cbuffer Color : register(b2){
 	float4 color;
 }
 
+// ジオメトリシェーダーを使わない時はそのままピクセルシェーダーに渡す
 struct VertexShaderOutput{
-    float32_t4 position : POSITION0;
+    float32_t4 position : SV_POSITION;
     float32_t3 normal : NORMAL;
     float32_t4 worldPosition : POSITION1;
     float32_t2 uv : TEXCOORD;
@@ -47,4 +48,81 @@ struct DSoutPut{
     float32_t3 normal : NORMAL;
     float32_t4 worldPosition : POSITION1;
     float32_t2 uv : TEXCOORD;
-};
\ No newline at end of file
+};
+
+struct InstanceData {
+	float32_t4x4 worldMat;
+	float32_t4 color;
+};
+
+struct InstancingVertexShaderOutput{
+    float32_t4 position : SV_POSITION;
+    float32_t3 normal : NORMAL;
+    float32_t4 worldPosition : POSITION1;
+    float32_t2 uv : TEXCOORD;
+    float32_t4 color : COLOR0;
+};
+
+// ディレクションライトとポイントライトの光の強さ
+float3 CalcLighting(float3 normal, float3 worldPosition)
+{
+	// ディレクションライト拡散反射光
+	float t = dot(normal, ligDirection);
+
+	t *= -1.0f;
+	t = (t + abs(t)) * 0.5f;
+
+	float3 diffDirection = ligColor * t;
+
+	// メタリックすぎるので削除
+	// ディレクションライト鏡面反射光
+	/*float3 refVec = reflect(ligDirection, normal.xyz);
+
+	float3 toEye = eyePos - worldPosition;
+	toEye = normalize(toEye);
+
+	t  = dot(refVec,  toEye);
+	t = (t + abs(t)) * 0.5f;
+
+	t = pow(t, 5.0f);
+	float3 specDirection =  ligColor * t;*/
+
+
+	float3 ligDir = worldPosition - ptPos;
+	ligDir = normalize(ligDir);
+
+	// ポイントライト拡散反射光
+	t = dot(normal, ligDir);
+
+	t *= -1.0f;
+	t = (t + abs(t)) * 0.5f;
+
+	float3 diffPoint = ptColor * t;
+
+	// ポイントライト鏡面反射光
+	float3 refVec = reflect(ligDir, normal);
+
+	float3 toEye = eyePos - worldPosition;
+	toEye = normalize(toEye);
+
+	t  = dot(refVec,  toEye);
+	t = (t + abs(t)) * 0.5f;
+
+	t = pow(t, 5.0f);
+	float3 specpoint = ptColor * t;
+
+	// 影響率計算
+	float distance = length(worldPosition - ptPos);
+
+	float affect = 1.0f - 1.0f / ptRange * distance;
+	affect = (affect + abs(affect)) * 0.5f;
+	affect = pow(affect, 3.0f);
+
+	diffPoint *= affect;
+	specpoint *= affect;
+
+	float3 diffuseLig = diffPoint + diffDirection;
+	float3 specularLig = specpoint;// + specDirection;
+
+	return diffuseLig + specularLig;
+}
@@ -0,0 +1,25 @@
+#include "Model.hlsli"
+
+struct PixelShaderOutPut {
+	float32_t4 color : SV_TARGET0;
+};
+
+Texture2D<float4> tex : register(t0);
+SamplerState smp : register(s0);
+
+PixelShaderOutPut main(InstancingVertexShaderOutput input)
+{
+	PixelShaderOutPut output;
+	input.normal = normalize(input.normal);
+
+	float3 lig = CalcLighting(input.normal, input.worldPosition.xyz);
+
+	output.color = tex.Sample(smp, input.uv);
+	output.color *= input.color;
+	lig.x += 0.2f;
+	lig.y += 0.2f;
+	lig.z += 0.2f;
+	output.color.xyz *= lig;
+
+	return output;
+}
@@ -0,0 +1,27 @@
+#include "Model.hlsli"
+
+struct VertexShaderInput {
+	float32_t4 position : POSITION0;
+	float32_t3 normal : NORMAL0;
+	float32_t2 uv : TEXCOORD;
+};
+
+// インスタンスごとのワールド行列と色(cbufferのworldMatは使わない)
+StructuredBuffer<InstanceData> instanceData : register(t1);
+
+InstancingVertexShaderOutput main(VertexShaderInput input, uint32_t instanceID : SV_InstanceID)
+{
+	InstancingVertexShaderOutput output;
+
+	float32_t4x4 instanceWorldMat = instanceData[instanceID].worldMat;
+
+	input.position = mul(instanceWorldMat, input.position);
+	output.worldPosition = input.position;
+	output.position = mul(viewProjectionMat, input.position);
+	input.normal = normalize(input.normal);
+	output.normal = mul((float32_t3x3)instanceWorldMat, input.normal);
+	output.uv = input.uv;
+	output.color = instanceData[instanceID].color;
+
+	return output;
+}
@@ -0,0 +1,353 @@
+// 非同期読み込み(user-025)のテスト(MeshManager::FinishLoad()で使う取り消しと待ち(user-013)も見る)
+// 競合はThreadSanitizerで調べる(cmake -S Tests -B build-tsan -DENGINE_TESTS_SANITIZER=thread)
+#include "Tests/Common/Test.h"
+#include "Utils/AsyncLoader/AsyncLoader.h"
+#include <array>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+	using Loader = AsyncLoader<std::string>;
+
+	std::string MakeResult(const std::string& key) {
+		return "loaded " + key;
+	}
+
+	void TestOrder() {
+		// 1つのワーカーが読み込み中の間に積んだものは、優先度の高い順、同じなら要求した順に読み込む
+		std::mutex mutex;
+		std::condition_variable condition;
+		bool isOpen = false;
+		std::vector<std::string> loadedKeys;
+		Loader loader(
+			[&](const std::string& key) {
+				std::unique_lock<std::mutex> lock(mutex);
+				condition.wait(lock, [&]() { return isOpen; });
+				loadedKeys.push_back(key);
+				return MakeResult(key);
+			}, 1
+		);
+		TEST_CHECK(loader.GetThreadNum() == 1);
+
+		const Loader::Handle first = loader.Request("first");
+		while (first->GetState() != Loader::State::Loading) {
+			std::this_thread::yield();
+		}
+		const Loader::Handle low = loader.Request("low", -1);
+		const Loader::Handle middleA = loader.Request("middleA", 5);
+		const Loader::Handle middleB = loader.Request("middleB", 5);
+		const Loader::Handle raised = loader.Request("raised", 0);
+		const Loader::Handle canceled = loader.Request("canceled", 10);
+		loader.SetPriority(raised, 7);
+		// 同じキーの要求はまとめられ、高い方の優先度になる
+		TEST_CHECK(loader.Request("middleB", 6) == middleB);
+		TEST_CHECK(loader.GetRequestedNum() == 6);
+
+		// 要求が残っている間は取り消されない
+		TEST_CHECK(loader.Cancel(middleB));
+		TEST_CHECK(middleB->GetState() == Loader::State::Queued);
+		TEST_CHECK(loader.Cancel(canceled));
+		TEST_CHECK(canceled->GetState() == Loader::State::Canceled);
+		TEST_CHECK(!loader.Cancel(canceled));
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			isOpen = true;
+		}
+		condition.notify_all();
+		loader.WaitIdle();
+
+		const std::vector<std::string> expectedKeys = { "first", "raised", "middleB", "middleA", "low" };
+		TEST_CHECK(loadedKeys == expectedKeys);
+		TEST_CHECK(loader.GetRequestedNum() == 0);
+		const std::vector<Loader::Handle> loaded = loader.TakeLoaded();
+		TEST_CHECK(loaded.size() == expectedKeys.size());
+		for (const auto& job : loaded) {
+			TEST_CHECK(job->GetState() == Loader::State::Loaded);
+			TEST_CHECK(job->GetResult() == MakeResult(job->GetKey()));
+		}
+		TEST_CHECK(loader.TakeLoaded().empty());
+		// 読み込み終わったものは取り消せない
+		TEST_CHECK(!loader.Cancel(first));
+	}
+
+	/// <summary>
+	/// 1つのジョブに対してテスト側で数えた要求と取り消し
+	/// </summary>
+	struct JobRecord {
+		Loader::Handle job;
+		uint32_t requestNum = 0;
+		uint32_t cancelNum = 0;
+		uint32_t takenNum = 0;
+	};
+
+	void TestStress() {
+		// 複数のスレッドが重なるキーを要求、取り消し、優先度変更し、メインスレッドが受け取り続ける
+		constexpr uint32_t kKeyNum = 24;
+		constexpr uint32_t kProducerNum = 4;
+		constexpr uint32_t kStepNum = 6000;
+
+		std::array<std::atomic<uint32_t>, kKeyNum> loadingNums = {};
+		std::atomic<uint32_t> overlapNum = 0;
+		std::atomic<uint32_t> loadNum = 0;
+		auto getKeyIndex = [](const std::string& key) { return static_cast<size_t>(std::stoul(key.substr(3))); };
+
+		std::unordered_map<Loader::Job*, JobRecord> records;
+		std::mutex recordMutex;
+		std::vector<Loader::Handle> takenJobs;
+		std::atomic<uint32_t> badNum = 0;
+
+		{
+			Loader loader(
+				[&](const std::string& key) {
+					// 同じキーが同時に読み込まれることは無い
+					const size_t index = getKeyIndex(key);
+					if (loadingNums[index].fetch_add(1) != 0) {
+						overlapNum++;
+					}
+					std::this_thread::sleep_for(std::chrono::microseconds(20 + index * 3));
+					loadingNums[index].fetch_sub(1);
+					loadNum++;
+					return MakeResult(key);
+				}, 3
+			);
+
+			std::atomic<uint32_t> runningNum = kProducerNum;
+			std::vector<std::thread> producers;
+			for (uint32_t producerIndex = 0; producerIndex < kProducerNum; producerIndex++) {
+				producers.emplace_back(
+					[&, producerIndex]() {
+						std::mt19937 random(producerIndex + 10);
+						std::uniform_int_distribution<uint32_t> keyDist(0, kKeyNum - 1);
+						std::uniform_int_distribution<int32_t> priorityDist(-8, 8);
+						std::uniform_int_distribution<uint32_t> actionDist(0, 9);
+						// 取り消していない自分の要求
+						std::vector<Loader::Handle> holds;
+						std::unordered_map<Loader::Job*, JobRecord> localRecords;
+						for (uint32_t step = 0; step < kStepNum; step++) {
+							const uint32_t action = actionDist(random);
+							if (action < 4 || holds.empty()) {
+								Loader::Handle job = loader.Request("key" + std::to_string(keyDist(random)), priorityDist(random));
+								JobRecord& record = localRecords[job.get()];
+								record.job = job;
+								record.requestNum++;
+								holds.push_back(std::move(job));
+							}
+							else {
+								const size_t index = std::uniform_int_distribution<size_t>(0, holds.size() - 1)(random);
+								if (action < 8) {
+									if (loader.Cancel(holds[index])) {
+										localRecords[holds[index].get()].cancelNum++;
+									}
+									else {
+										// 自分の要求が残っているので、取り消せないのは読み込み終わった時だけ
+										if (holds[index]->GetState() != Loader::State::Loaded) {
+											badNum++;
+										}
+									}
+									holds.erase(holds.begin() + index);
+								}
+								else {
+									loader.SetPriority(holds[index], priorityDist(random));
+								}
+							}
+							// ワーカーが読み込み終わるのを挟む
+							if (step % 8 == 0) {
+								std::this_thread::sleep_for(std::chrono::microseconds(10));
+							}
+						}
+
+						std::lock_guard<std::mutex> lock(recordMutex);
+						for (auto& [pointer, localRecord] : localRecords) {
+							JobRecord& record = records[pointer];
+							record.job = localRecord.job;
+							record.requestNum += localRecord.requestNum;
+							record.cancelNum += localRecord.cancelNum;
+						}
+						runningNum--;
+					}
+				);
+			}
+
+			// 受け取ったものは読み込み終わっていて、キーに合った結果を持つ
+			auto take = [&]() {
+				for (auto& job : loader.TakeLoaded()) {
+					if (job->GetState() != Loader::State::Loaded || job->GetResult() != MakeResult(job->GetKey())) {
+						badNum++;
+					}
+					takenJobs.push_back(std::move(job));
+				}
+			};
+			while (runningNum != 0) {
+				take();
+				std::this_thread::yield();
+			}
+			for (auto& producer : producers) {
+				producer.join();
+			}
+			loader.WaitIdle();
+			take();
+			TEST_CHECK(loader.GetRequestedNum() == 0);
+		}
+
+		TEST_CHECK(badNum == 0);
+		TEST_CHECK(overlapNum == 0);
+		TEST_CHECK(0 < loadNum);
+
+		// 要求が残っていたものはちょうど1回受け取り、全て取り消されたものは受け取らない
+		for (const auto& job : takenJobs) {
+			auto itr = records.find(job.get());
+			TEST_CHECK(itr != records.end());
+			if (itr != records.end()) {
+				itr->second.takenNum++;
+			}
+		}
+		uint32_t loadedNum = 0;
+		bool isOk = true;
+		for (const auto& [pointer, record] : records) {
+			if (record.cancelNum < record.requestNum) {
+				isOk &= record.takenNum == 1 && record.job->GetState() == Loader::State::Loaded;
+				loadedNum++;
+			}
+			else {
+				isOk &= record.cancelNum == record.requestNum && record.takenNum == 0 && record.job->GetState() == Loader::State::Canceled;
+			}
+		}
+		TEST_CHECK(isOk);
+		TEST_CHECK(loadedNum == takenJobs.size());
+		std::printf("stress : %zu jobs, %u loaded, %u loads\n", records.size(), loadedNum, loadNum.load());
+	}
+
+	void TestFinish() {
+		// 待っているものだけ取り消せて、読み込み中のものは終わるまで待てる
+		std::mutex mutex;
+		std::condition_variable condition;
+		bool isOpen = false;
+		std::vector<std::string> loadedKeys;
+		Loader loader(
+			[&](const std::string& key) {
+				std::unique_lock<std::mutex> lock(mutex);
+				condition.wait(lock, [&]() { return isOpen; });
+				loadedKeys.push_back(key);
+				return MakeResult(key);
+			}, 1
+		);
+
+		const Loader::Handle loading = loader.Request("loading");
+		while (loading->GetState() != Loader::State::Loading) {
+			std::this_thread::yield();
+		}
+		const Loader::Handle queued = loader.Request("queued");
+		const Loader::Handle shared = loader.Request("shared");
+		TEST_CHECK(loader.Request("shared") == shared);
+
+		TEST_CHECK(!loader.CancelIfQueued(loading));
+		TEST_CHECK(loading->GetState() == Loader::State::Loading);
+		TEST_CHECK(loader.CancelIfQueued(queued));
+		TEST_CHECK(queued->GetState() == Loader::State::Canceled);
+		TEST_CHECK(!loader.CancelIfQueued(queued));
+		// 他の要求が残っていれば、取り消すのはその要求だけ
+		TEST_CHECK(loader.CancelIfQueued(shared));
+		TEST_CHECK(shared->GetState() == Loader::State::Queued);
+
+		std::thread opener(
+			[&]() {
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					isOpen = true;
+				}
+				condition.notify_all();
+			}
+		);
+		loader.Wait(loading);
+		TEST_CHECK(loading->GetState() == Loader::State::Loaded);
+		TEST_CHECK(loading->GetResult() == MakeResult("loading"));
+		opener.join();
+		// 終わったもの、取り消されたものはすぐに戻る
+		loader.Wait(loading);
+		loader.Wait(queued);
+		loader.Wait(shared);
+		TEST_CHECK(shared->GetState() == Loader::State::Loaded);
+		TEST_CHECK(!loader.CancelIfQueued(shared));
+
+		const std::vector<std::string> expectedKeys = { "loading", "shared" };
+		TEST_CHECK(loadedKeys == expectedKeys);
+		TEST_CHECK(loader.TakeLoaded().size() == 2);
+	}
+
+	void TestFinishStress() {
+		// MeshManager::FinishLoad()と同じように、要求したものを順番にその場で終わらせる
+		// (待っていれば取り消して自分で読み込み、読み込み中なら待つ。どのキーもちょうど1回だけ読み込む)
+		constexpr uint32_t kKeyNum = 400;
+		std::array<std::atomic<uint32_t>, kKeyNum> loadNums = {};
+		auto load = [&loadNums](const std::string& key) {
+			loadNums[std::stoul(key.substr(3))]++;
+			std::this_thread::sleep_for(std::chrono::microseconds(50));
+			return MakeResult(key);
+		};
+		Loader loader(load, 2);
+
+		std::vector<Loader::Handle> jobs;
+		for (uint32_t i = 0; i < kKeyNum; i++) {
+			jobs.push_back(loader.Request("key" + std::to_string(i)));
+		}
+		uint32_t selfLoadNum = 0;
+		bool isOk = true;
+		// 後ろから終わらせて、ワーカーが追いつくまでは自分で読み込み、追いついたら待つようにする
+		for (auto itr = jobs.rbegin(); itr != jobs.rend(); itr++) {
+			const Loader::Handle& job = *itr;
+			if (loader.CancelIfQueued(job)) {
+				isOk &= load(job->GetKey()) == MakeResult(job->GetKey());
+				selfLoadNum++;
+			}
+			else {
+				loader.Wait(job);
+				isOk &= job->GetState() == Loader::State::Loaded && job->GetResult() == MakeResult(job->GetKey());
+			}
+		}
+		loader.WaitIdle();
+		TEST_CHECK(isOk);
+		TEST_CHECK(0 < selfLoadNum && selfLoadNum < kKeyNum);
+		TEST_CHECK(loader.TakeLoaded().size() == kKeyNum - selfLoadNum);
+		TEST_CHECK(std::all_of(loadNums.begin(), loadNums.end(), [](const auto& num) { return num == 1; }));
+		std::printf("finish : %u keys, %u loaded here\n", kKeyNum, selfLoadNum);
+	}
+
+	void TestDestroy() {
+		// 待っている読み込みがあっても壊せて、待っていたものは取り消される
+		std::vector<Loader::Handle> jobs;
+		{
+			Loader loader(
+				[](const std::string& key) {
+					std::this_thread::sleep_for(std::chrono::milliseconds(1));
+					return MakeResult(key);
+				}, 2
+			);
+			for (int i = 0; i < 200; i++) {
+				jobs.push_back(loader.Request("key" + std::to_string(i), i % 7));
+			}
+		}
+		uint32_t canceledNum = 0;
+		bool isOk = true;
+		for (const auto& job : jobs) {
+			const Loader::State state = job->GetState();
+			isOk &= state == Loader::State::Loaded || state == Loader::State::Canceled;
+			canceledNum += state == Loader::State::Canceled ? 1 : 0;
+		}
+		TEST_CHECK(isOk);
+		TEST_CHECK(0 < canceledNum);
+	}
+}
+
+int main() {
+	TestOrder();
+	TestStress();
+	TestFinish();
+	TestFinishStress();
+	TestDestroy();
+
+	return Test::Result("AsyncLoaderTest");
+}
@@ -0,0 +1,114 @@
+// アトラスの矩形詰め(user-024)のテスト
+#include "Tests/Common/Test.h"
+#include "Utils/AtlasPacker/AtlasPacker.h"
+#include <vector>
+#include <random>
+
+namespace {
+	/// <summary>
+	/// 詰めた結果を確かめて、最後のページ以外の埋まり具合の平均を返す
+	/// </summary>
+	double CheckPlacements(std::span<const AtlasPacker::Size> sizes, const AtlasPacker::Setting& setting) {
+		uint32_t pageNum = 0;
+		const std::vector<AtlasPacker::Placement> placements = AtlasPacker::Pack(sizes, setting, pageNum);
+		TEST_CHECK(placements.size() == sizes.size());
+		TEST_CHECK(pageNum <= setting.maxPageNum);
+
+		const uint32_t pageWidth = setting.pageWidth / setting.alignment * setting.alignment;
+		const uint32_t pageHeight = setting.pageHeight / setting.alignment * setting.alignment;
+		std::vector<std::vector<bool>> isUsed(pageNum, std::vector<bool>(static_cast<size_t>(pageWidth) * pageHeight, false));
+		std::vector<uint64_t> usedArea(pageNum, 0);
+
+		bool isOk = true;
+		for (size_t i = 0; i < sizes.size(); i++) {
+			const AtlasPacker::Size cell = AtlasPacker::CalcCellSize(sizes[i], setting);
+			const AtlasPacker::Placement& placement = placements[i];
+			if (placement.page == AtlasPacker::kInvalidPage) {
+				// 置けないのは、大きすぎるか、大きさが0か、ページが足りない時だけ
+				isOk &= pageWidth < cell.width || pageHeight < cell.height || sizes[i].width == 0 || sizes[i].height == 0 || pageNum == setting.maxPageNum;
+				continue;
+			}
+
+			// 区画は揃えの倍数の位置にあり、ページからはみ出さず、他の区画と重ならない
+			const AtlasPacker::Rect& rect = placement.rect;
+			isOk &= placement.page < pageNum;
+			isOk &= rect.width == sizes[i].width && rect.height == sizes[i].height;
+			const uint32_t cellX = rect.x - setting.padding;
+			const uint32_t cellY = rect.y - setting.padding;
+			isOk &= cellX % setting.alignment == 0 && cellY % setting.alignment == 0;
+			isOk &= cellX + cell.width <= pageWidth && cellY + cell.height <= pageHeight;
+			if (!isOk || pageNum <= placement.page) {
+				break;
+			}
+			std::vector<bool>& page = isUsed[placement.page];
+			for (uint32_t y = cellY; y < cellY + cell.height; y++) {
+				for (uint32_t x = cellX; x < cellX + cell.width; x++) {
+					isOk &= !page[static_cast<size_t>(y) * pageWidth + x];
+					page[static_cast<size_t>(y) * pageWidth + x] = true;
+				}
+			}
+			usedArea[placement.page] += static_cast<uint64_t>(cell.width) * cell.height;
+		}
+		TEST_CHECK(isOk);
+
+		if (pageNum <= 1) {
+			return pageNum == 0 ? 0.0 : static_cast<double>(usedArea[0]) / (static_cast<double>(pageWidth) * pageHeight);
+		}
+		double occupancy = 0.0;
+		for (uint32_t page = 0; page + 1 < pageNum; page++) {
+			occupancy += static_cast<double>(usedArea[page]) / (static_cast<double>(pageWidth) * pageHeight);
+		}
+		return occupancy / (pageNum - 1);
+	}
+
+	void TestPack() {
+		std::mt19937 random(1);
+
+		// UIのような大きさがばらばらの画像でも、ページがよく埋まる
+		for (int n = 0; n < 10; n++) {
+			std::uniform_int_distribution<uint32_t> dist(8, 256);
+			std::vector<AtlasPacker::Size> sizes(400);
+			for (auto& size : sizes) {
+				size = { dist(random), dist(random) };
+			}
+			TEST_CHECK(0.85 < CheckPlacements(sizes, AtlasPacker::Setting{}));
+		}
+
+		// 2の累乗の正方形は隙間なく詰まる
+		std::vector<AtlasPacker::Size> squares(64, AtlasPacker::Size{ 128, 128 });
+		TEST_CHECK(0.999 < CheckPlacements(squares, AtlasPacker::Setting{ 1024, 1024, 0, 1, 8 }));
+
+		// 大きすぎるもの、大きさが0のもの、ページ数の上限
+		const std::vector<AtlasPacker::Size> edges = { { 5000, 10 }, { 0, 5 }, { 100, 100 } };
+		CheckPlacements(edges, AtlasPacker::Setting{});
+		const std::vector<AtlasPacker::Size> many(20, AtlasPacker::Size{ 120, 120 });
+		CheckPlacements(many, AtlasPacker::Setting{ 256, 256, 2, 4, 2 });
+
+		// 隙間と揃えの組み合わせ
+		for (uint32_t padding : { 0u, 1u, 2u, 4u }) {
+			for (uint32_t alignment : { 1u, 2u, 4u, 8u, 16u }) {
+				std::uniform_int_distribution<uint32_t> dist(1, 100);
+				std::vector<AtlasPacker::Size> sizes(300);
+				for (auto& size : sizes) {
+					size = { dist(random), dist(random) };
+				}
+				CheckPlacements(sizes, AtlasPacker::Setting{ 1000, 700, padding, alignment, 16 });
+			}
+		}
+	}
+
+	void TestSafeMipNum() {
+		// ミップkで区画の端がテクセルの境目に乗り、隙間が半テクセル以上残る数
+		TEST_CHECK(AtlasPacker::CalcSafeMipNum(AtlasPacker::Setting{ 2048, 2048, 4, 8, 4 }) == 4);
+		TEST_CHECK(AtlasPacker::CalcSafeMipNum(AtlasPacker::Setting{ 2048, 2048, 0, 8, 4 }) == 1);
+		TEST_CHECK(AtlasPacker::CalcSafeMipNum(AtlasPacker::Setting{ 2048, 2048, 8, 4, 4 }) == 3);
+		TEST_CHECK(AtlasPacker::CalcSafeMipNum(AtlasPacker::Setting{ 2048, 2048, 1, 16, 4 }) == 2);
+	}
+}
+
+int main() {
+	TestPack();
+	TestSafeMipNum();
+
+	return Test::Result("AtlasPackerTest");
+}
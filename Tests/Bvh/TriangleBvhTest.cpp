@@ -0,0 +1,95 @@
+// 三角形のBVH(user-018)のテスト
+#include "Tests/Common/Test.h"
+#include "Tests/MeshOptimizer/TestMesh.h"
+#include "Utils/Math/Ray.h"
+#include "Utils/Bvh/TriangleBvh.h"
+#include <random>
+
+namespace {
+	using Test::Mesh;
+
+	/// <summary>
+	/// 全ての三角形を調べる(BVHの答え合わせ用)
+	/// </summary>
+	bool RaycastBruteForce(const Mesh& mesh, const Ray& ray, float& distance, uint32_t& triangleIndex) {
+		bool isHit = false;
+		for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+			const Vector3& p0 = mesh.positions[mesh.indices[i]];
+			const Vector3 edge1 = mesh.positions[mesh.indices[i + 1]] - p0;
+			const Vector3 edge2 = mesh.positions[mesh.indices[i + 2]] - p0;
+			const Vector3 pvec = ray.direction.Cross(edge2);
+			const float det = edge1.Dot(pvec);
+			if (det == 0.0f) {
+				continue;
+			}
+			const float invDet = 1.0f / det;
+			const Vector3 tvec = ray.origin - p0;
+			const float u = tvec.Dot(pvec) * invDet;
+			if (u < 0.0f || 1.0f < u) {
+				continue;
+			}
+			const Vector3 qvec = tvec.Cross(edge1);
+			const float v = ray.direction.Dot(qvec) * invDet;
+			if (v < 0.0f || 1.0f < u + v) {
+				continue;
+			}
+			const float t = edge2.Dot(qvec) * invDet;
+			if (t < 0.0f || (isHit && distance <= t)) {
+				continue;
+			}
+			distance = t;
+			triangleIndex = static_cast<uint32_t>(i / 3);
+			isHit = true;
+		}
+		return isHit;
+	}
+
+	void TestBvh() {
+		const Mesh sphere = Test::MakeSphere(32, 64);
+		TriangleBvh bvh;
+		bvh.Build(sphere.positions, sphere.indices);
+		TEST_CHECK(bvh.GetTriangleNum() == sphere.indices.size() / 3);
+
+		std::mt19937 random(5);
+		std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+		uint32_t hitNum = 0;
+		uint32_t mismatchNum = 0;
+		for (int n = 0; n < 20000; n++) {
+			// 球の外から、球の近くを狙う
+			Vector3 origin(dist(random), dist(random), dist(random));
+			origin = origin.Normalize() * 3.0f;
+			const Vector3 target = Vector3(dist(random), dist(random), dist(random)) * 1.2f;
+			const Ray ray{ origin, (target - origin).Normalize() };
+
+			RaycastHit hit;
+			const bool isHit = bvh.Raycast(ray, hit);
+			float distance = 0.0f;
+			uint32_t triangleIndex = 0;
+			const bool isHitExpected = RaycastBruteForce(sphere, ray, distance, triangleIndex);
+			if (isHit != isHitExpected) {
+				// 辺の上をかすめたときだけ食い違ってよいが、そもそも滅多に起きない
+				mismatchNum++;
+				continue;
+			}
+			if (isHit) {
+				hitNum++;
+				TEST_CHECK(std::abs(hit.distance - distance) <= 1.0e-4f);
+				TEST_CHECK((hit.position - ray.GetPoint(hit.distance)).Length() <= 1.0e-4f);
+			}
+		}
+		TEST_CHECK(mismatchNum <= 2);
+		TEST_CHECK(1000 < hitNum);
+
+		// 最大距離より遠い面には当たらない
+		RaycastHit hit;
+		TEST_CHECK(!bvh.Raycast(Ray{ Vector3(0.0f, 0.0f, -3.0f), Vector3(0.0f, 0.0f, 1.0f) }, hit, 1.5f));
+		TEST_CHECK(bvh.Raycast(Ray{ Vector3(0.0f, 0.0f, -3.0f), Vector3(0.0f, 0.0f, 1.0f) }, hit, 2.5f));
+		TEST_CHECK(std::abs(hit.distance - 2.0f) <= 0.01f);
+	}
+}
+
+int main() {
+	TestBvh();
+
+	return Test::Result("TriangleBvhTest");
+}
@@ -0,0 +1,29 @@
+// テスト用のErrorCheck(ウィンドウもログファイルも使わず、標準エラーに出すだけ)
+#include "Engine/ErrorCheck/ErrorCheck.h"
+#include <cstdio>
+
+ErrorCheck* ErrorCheck::GetInstance() {
+	static ErrorCheck instance;
+	return &instance;
+}
+
+ErrorCheck::ErrorCheck() :
+	isError(false)
+{}
+
+ErrorCheck::~ErrorCheck() {}
+
+void ErrorCheck::ErrorTextBox(const std::string& text, const std::string& boxName) {
+	ErrorLog(text, boxName);
+	isError = true;
+}
+
+void ErrorCheck::ErrorTextBox(bool isError_, const std::string& text, const std::string& boxName) {
+	if (isError_) {
+		ErrorTextBox(text, boxName);
+	}
+}
+
+void ErrorCheck::ErrorLog(const std::string& text, const std::string& boxName) {
+	std::fprintf(stderr, "ErrorCheck : %s / %s\n", boxName.c_str(), text.c_str());
+}
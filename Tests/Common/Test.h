@@ -0,0 +1,85 @@
+#pragma once
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <string>
+
+/// <summary>
+/// テスト用の確認(失敗しても止めずに数え、最後にTest::Result()で終了コードにする)
+/// </summary>
+namespace Test {
+	inline uint32_t& GetFailedNum() {
+		static uint32_t failedNum = 0;
+		return failedNum;
+	}
+
+	inline bool Check(bool isOk, const char* expr, const char* file, int line) {
+		if (!isOk) {
+			std::fprintf(stderr, "%s(%d): failed: %s\n", file, line, expr);
+			GetFailedNum()++;
+		}
+		return isOk;
+	}
+
+	/// <summary>
+	/// mainの戻り値(失敗が無ければ0)
+	/// </summary>
+	inline int Result(const char* testName) {
+		const uint32_t failedNum = GetFailedNum();
+		std::printf("%s: %s (%u failed)\n", testName, failedNum == 0 ? "ok" : "NG", failedNum);
+		return failedNum == 0 ? 0 : 1;
+	}
+
+	/// <summary>
+	/// 2つのfloatの間にあるfloatの数(ULPの差)
+	/// </summary>
+	inline uint32_t UlpDistance(float left, float right) {
+		int32_t leftBits = 0;
+		int32_t rightBits = 0;
+		std::memcpy(&leftBits, &left, sizeof(float));
+		std::memcpy(&rightBits, &right, sizeof(float));
+		// 符号と絶対値の表現を、大小の順に並ぶ整数にする
+		if (leftBits < 0) {
+			leftBits = INT32_MIN - leftBits;
+		}
+		if (rightBits < 0) {
+			rightBits = INT32_MIN - rightBits;
+		}
+		const int64_t distance = static_cast<int64_t>(leftBits) - static_cast<int64_t>(rightBits);
+		return static_cast<uint32_t>(distance < 0 ? -distance : distance);
+	}
+
+	/// <summary>
+	/// 経過時間を測る
+	/// </summary>
+	class Stopwatch final {
+	public:
+		Stopwatch() :
+			start(std::chrono::steady_clock::now())
+		{}
+
+	public:
+		double GetMilliSeconds() const {
+			return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		}
+
+	private:
+		std::chrono::steady_clock::time_point start;
+	};
+
+	/// <summary>
+	/// ベンチマークの回数を減らすか(ctestではこれを付けて呼ぶ)
+	/// </summary>
+	inline bool IsQuick(int argc, char** argv) {
+		for (int i = 1; i < argc; i++) {
+			if (std::string(argv[i]) == "--quick") {
+				return true;
+			}
+		}
+		return false;
+	}
+}
+
+#define TEST_CHECK(expr) ::Test::Check(static_cast<bool>(expr), #expr, __FILE__, __LINE__)
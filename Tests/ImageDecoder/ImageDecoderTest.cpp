@@ -0,0 +1,138 @@
+// 画像のデコード(user-023)のテスト(Resourcesの画像が正しくデコードできるか、速度)
+// リポジトリの一番上で動かす(ctestはそこで動かす)。--quick を付けるとベンチマークの回数を減らす
+#include "Tests/Common/Test.h"
+#include "Utils/ImageDecoder/ImageDecoder.h"
+#include <array>
+#include <vector>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+
+namespace {
+	/// <summary>
+	/// 別のデコーダー(zlibとPNGのフィルターを素直に書いたもの)でデコードした結果
+	/// </summary>
+	struct Expected {
+		const char* fileName;
+		uint32_t width;
+		uint32_t height;
+		/// <summary>
+		/// RGBA8のピクセル全体のFNV-1a(64bit)
+		/// </summary>
+		uint64_t hash;
+	};
+
+	constexpr std::array<Expected, 13> kExpecteds = { {
+		{ "Resources/Watame/T_Watame_Body.png", 2048, 2048, 0x9b4248dda7017134ull },
+		{ "Resources/Watame/T_Watame_Face.png", 2048, 2048, 0x360640d8609b3b4dull },
+		{ "Resources/Watame/T_Watame_Face_Eye.png", 2048, 2048, 0x808c8962cf6a19bbull },
+		{ "Resources/Watame/T_Watame_Face_Eye_EX.png", 2048, 2048, 0xf85579b1e2d8b80aull },
+		{ "Resources/Watame/T_Watame_Face_Hoho.png", 1024, 1024, 0x66a96d756f3d754eull },
+		{ "Resources/Watame/T_Watame_Fuku_A.png", 2048, 2048, 0xb9a7ba2d2c4b081bull },
+		{ "Resources/Watame/T_Watame_Fuku_B.png", 2048, 2048, 0xe61be54e72bd22bdull },
+		{ "Resources/Watame/T_Watame_Hair_BC.png", 2048, 2048, 0xa416746de543068cull },
+		{ "Resources/Watame/T_Watame_Hair_FR.png", 2048, 2048, 0xdd6bfa972fb715bbull },
+		{ "Resources/skydome/skydome.png", 128, 128, 0x5a4d359ebbc24f04ull },
+		{ "Resources/uvChecker.png", 512, 512, 0xebb9bf2dd80e1459ull },
+		{ "Resources/watame.png", 1920, 1080, 0x01d1c9731ac6d58bull },
+		{ "Resources/white2x2.png", 2, 2, 0xd6607508f5a1e855ull },
+	} };
+
+	/// <summary>
+	/// 拡張子はPNGだが中身はAVIF(デコードに失敗してWICに任せる)
+	/// </summary>
+	constexpr const char* kAvifFileName = "Resources/sakabannbasupisu.png";
+
+	uint64_t CalcHash(std::span<const uint8_t> data) {
+		uint64_t hash = 0xcbf29ce484222325ull;
+		for (uint8_t value : data) {
+			hash = (hash ^ value) * 0x100000001b3ull;
+		}
+		return hash;
+	}
+
+	std::vector<uint8_t> ReadFile(const std::string& fileName) {
+		std::ifstream file(fileName, std::ios::binary);
+		return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	bool IsExpected(const ImageDecoder::Image& image, const Expected& expected) {
+		return image.width == expected.width && image.height == expected.height
+			&& image.pixels.size() == static_cast<size_t>(expected.width) * expected.height * 4
+			&& CalcHash(image.pixels) == expected.hash;
+	}
+
+	void TestFiles() {
+		// 1バイトも違わずにデコードできる
+		for (const Expected& expected : kExpecteds) {
+			ImageDecoder::Image image;
+			const bool isSucceeded = ImageDecoder::DecodeFile(expected.fileName, image);
+			if (!isSucceeded || !IsExpected(image, expected)) {
+				std::fprintf(stderr, "%s : %ux%u %016llx\n", expected.fileName, image.width, image.height, static_cast<unsigned long long>(CalcHash(image.pixels)));
+			}
+			TEST_CHECK(isSucceeded);
+			TEST_CHECK(IsExpected(image, expected));
+		}
+
+		// まとめてデコードしても同じ
+		std::vector<std::string> fileNames;
+		for (const Expected& expected : kExpecteds) {
+			fileNames.emplace_back(expected.fileName);
+		}
+		fileNames.emplace_back(kAvifFileName);
+		const std::vector<ImageDecoder::Image> images = ImageDecoder::DecodeFiles(fileNames, 3);
+		TEST_CHECK(images.size() == fileNames.size());
+		for (size_t i = 0; i < std::min(images.size(), kExpecteds.size()); i++) {
+			TEST_CHECK(IsExpected(images[i], kExpecteds[i]));
+		}
+		TEST_CHECK(images.back().width == 0 && images.back().height == 0 && images.back().pixels.empty());
+	}
+
+	void TestFailure() {
+		// 対応していないものや壊れたものは失敗し、画像は空になる
+		ImageDecoder::Image image;
+		const std::vector<uint8_t> avif = ReadFile(kAvifFileName);
+		TEST_CHECK(!avif.empty());
+		TEST_CHECK(ImageDecoder::GetFileType(avif) == ImageDecoder::FileType::Unknown);
+		TEST_CHECK(!ImageDecoder::DecodeFile(kAvifFileName, image));
+		TEST_CHECK(!ImageDecoder::DecodeFile("Resources/NotFound.png", image));
+		TEST_CHECK(image.width == 0 && image.height == 0 && image.pixels.empty());
+
+		const std::array<uint8_t, 4> jpegHeader = { 0xFF, 0xD8, 0xFF, 0xE0 };
+		TEST_CHECK(ImageDecoder::GetFileType(jpegHeader) == ImageDecoder::FileType::Jpeg);
+		TEST_CHECK(!ImageDecoder::Decode(jpegHeader, image));
+
+		// 途中で切れたPNG
+		const std::vector<uint8_t> png = ReadFile("Resources/uvChecker.png");
+		TEST_CHECK(ImageDecoder::GetFileType(png) == ImageDecoder::FileType::Png);
+		for (size_t size : { size_t(8), size_t(33), png.size() / 2, png.size() - 13 }) {
+			TEST_CHECK(!ImageDecoder::Decode(std::span<const uint8_t>(png).first(std::min(size, png.size())), image));
+			TEST_CHECK(image.width == 0 && image.height == 0 && image.pixels.empty());
+		}
+	}
+
+	void Bench(bool isQuick) {
+		const int count = isQuick ? 1 : 10;
+		for (const char* fileName : { "Resources/uvChecker.png", "Resources/watame.png", "Resources/Watame/T_Watame_Body.png" }) {
+			const std::vector<uint8_t> data = ReadFile(fileName);
+			ImageDecoder::Image image;
+			const Test::Stopwatch stopwatch;
+			for (int i = 0; i < count; i++) {
+				TEST_CHECK(ImageDecoder::Decode(data, image));
+			}
+			const double seconds = stopwatch.GetMilliSeconds() / count / 1000.0;
+			std::printf("%-36s %ux%u : %.2f ms (file %.1f MB/s, pixels %.1f MB/s)\n",
+				fileName, image.width, image.height, seconds * 1000.0,
+				static_cast<double>(data.size()) / seconds / 1e6, static_cast<double>(image.pixels.size()) / seconds / 1e6
+			);
+		}
+	}
+}
+
+int main(int argc, char** argv) {
+	TestFiles();
+	TestFailure();
+	Bench(Test::IsQuick(argc, argv));
+
+	return Test::Result("ImageDecoderTest");
+}
@@ -0,0 +1,234 @@
+// インスタンシング描画のデータ詰め(user-014)のテスト
+// 視錐台カリングして詰める、バッファを増やす、1フレームに何回もDrawInstancing()する場合
+#include "Tests/Common/Test.h"
+#include "Drawers/Model/InstanceBatch/InstanceBatch.h"
+#include "Utils/Math/Mat4x4.h"
+#include "Utils/Math/Frustum.h"
+#include <vector>
+#include <memory>
+#include <random>
+
+namespace {
+	using InstanceData = InstanceBatch::InstanceData;
+
+	const Sphere kLocalSphere = { Vector3(0.0f, 0.0f, 0.0f), 1.0f };
+
+	Frustum MakeFrustum() {
+		// 原点から+zを見るカメラ
+		return Frustum(VertMakeMatrixPerspectiveFov(0.45f, 16.0f / 9.0f, 0.1f, 100.0f));
+	}
+
+	bool IsSame(const InstanceData& left, const InstanceData& right) {
+		return std::memcmp(&left, &right, sizeof(InstanceData)) == 0;
+	}
+
+	Vector4 MakeColor(uint32_t index) {
+		return Vector4(static_cast<float>(index), 0.5f, 0.25f, 1.0f);
+	}
+
+	void TestPack() {
+		// 見えるものだけを追加した順に詰め、行列はシェーダー用に転置している
+		InstanceBatch batch;
+		std::vector<Mat4x4> visibleMats;
+		for (uint32_t i = 0; i < 40; i++) {
+			// 奇数番目はカメラの後ろ
+			const float z = i % 2 == 0 ? 10.0f + static_cast<float>(i) : -10.0f;
+			const Mat4x4 worldMat = HoriMakeMatrixAffin(Vector3::identity, Vector3(0.0f, 0.1f * static_cast<float>(i), 0.0f), Vector3(0.0f, 0.0f, z));
+			batch.Push(worldMat, MakeColor(i), kLocalSphere);
+			if (i % 2 == 0) {
+				visibleMats.push_back(worldMat);
+			}
+		}
+		TEST_CHECK(batch.GetInstanceNum() == 40);
+
+		const auto visible = batch.Cull(MakeFrustum());
+		TEST_CHECK(visible.size() == visibleMats.size());
+		bool isOk = visible.size() == visibleMats.size();
+		for (size_t i = 0; isOk && i < visible.size(); i++) {
+			const Mat4x4 transposed = MakeMatrixTransepose(visibleMats[i]);
+			isOk &= std::memcmp(&visible[i].worldMat, &transposed, sizeof(Mat4x4)) == 0;
+			isOk &= visible[i].color.vec.x == static_cast<float>(i * 2);
+		}
+		TEST_CHECK(isOk);
+
+		// 書き込み先に入るだけコピーする
+		std::vector<InstanceData> destination(8);
+		TEST_CHECK(InstanceBatch::Write(visible, destination) == 8);
+		TEST_CHECK(IsSame(destination[7], visible[7]));
+		TEST_CHECK(InstanceBatch::Write(visible.first(3), destination) == 3);
+
+		batch.Clear();
+		TEST_CHECK(batch.GetInstanceNum() == 0 && batch.Cull(MakeFrustum()).empty());
+	}
+
+	void TestCapacity() {
+		TEST_CHECK(InstanceBatch::CalcCapacity(0) == InstanceBatch::kMinCapacity);
+		TEST_CHECK(InstanceBatch::CalcCapacity(1) == InstanceBatch::kMinCapacity);
+		TEST_CHECK(InstanceBatch::CalcCapacity(16) == 16);
+		TEST_CHECK(InstanceBatch::CalcCapacity(17) == 32);
+		TEST_CHECK(InstanceBatch::CalcCapacity(1000) == 1024);
+
+		// 入る間は使った所の後ろに詰め、入らなければ詰めた分も含めた容量で作り直す
+		const InstanceBatch::BufferRange fit = InstanceBatch::Allocate(32, 10, 22);
+		TEST_CHECK(fit.offset == 10 && fit.newCapacity == 0);
+		const InstanceBatch::BufferRange grow = InstanceBatch::Allocate(32, 10, 23);
+		TEST_CHECK(grow.offset == 0 && grow.newCapacity == 64);
+		const InstanceBatch::BufferRange first = InstanceBatch::Allocate(0, 0, 5);
+		TEST_CHECK(first.offset == 0 && first.newCapacity == InstanceBatch::kMinCapacity);
+	}
+
+	/// <summary>
+	/// Model::DrawInstancing()と同じようにバッファを使う(GPUのバッファの代わりにvectorを使う)
+	/// </summary>
+	class InstancingModel {
+	public:
+		/// <summary>
+		/// 記録した1回の描画(GPUが読むのはフレームの終わりなので、その時にbufferのoffsetからinstancesが残っていないといけない)
+		/// </summary>
+		struct Draw {
+			std::shared_ptr<std::vector<InstanceData>> buffer;
+			uint32_t offset = 0;
+			std::vector<InstanceData> instances;
+		};
+
+	public:
+		void Update() {
+			// Model::Update()と同じく先頭に戻し、前のフレームで作り直す前のバッファを解放する
+			offset = 0;
+			retiredBuffers.clear();
+			draws.clear();
+			grownNum = 0;
+		}
+
+		void DrawInstancing(InstanceBatch& batch, const Frustum& frustum) {
+			const auto instances = batch.Cull(frustum);
+			const uint32_t instanceNum = static_cast<uint32_t>(instances.size());
+			if (instanceNum == 0) {
+				batch.Clear();
+				return;
+			}
+
+			const InstanceBatch::BufferRange range = InstanceBatch::Allocate(capacity, offset, instanceNum);
+			if (range.newCapacity != 0) {
+				if (buffer) {
+					retiredBuffers.push_back(buffer);
+				}
+				capacity = range.newCapacity;
+				buffer = std::make_shared<std::vector<InstanceData>>(capacity);
+				grownNum++;
+			}
+			offset = range.offset;
+			InstanceBatch::Write(instances, std::span<InstanceData>(*buffer).subspan(offset));
+
+			draws.push_back({ buffer, offset, std::vector<InstanceData>(instances.begin(), instances.end()) });
+			batch.Clear();
+			offset += instanceNum;
+		}
+
+		/// <summary>
+		/// このフレームの全ての描画が、自分のインスタンスを読めるか
+		/// </summary>
+		bool IsDrawsValid() const {
+			for (const auto& draw : draws) {
+				if (draw.buffer->size() < draw.offset + draw.instances.size()) {
+					return false;
+				}
+				for (size_t i = 0; i < draw.instances.size(); i++) {
+					if (!IsSame((*draw.buffer)[draw.offset + i], draw.instances[i])) {
+						return false;
+					}
+				}
+			}
+			return true;
+		}
+
+		uint32_t GetCapacity() const {
+			return capacity;
+		}
+		uint32_t GetGrownNum() const {
+			return grownNum;
+		}
+		size_t GetDrawNum() const {
+			return draws.size();
+		}
+
+	private:
+		std::shared_ptr<std::vector<InstanceData>> buffer;
+		std::vector<std::shared_ptr<std::vector<InstanceData>>> retiredBuffers;
+		uint32_t capacity = 0;
+		uint32_t offset = 0;
+		std::vector<Draw> draws;
+		uint32_t grownNum = 0;
+	};
+
+	void PushInstances(InstanceBatch& batch, uint32_t num, uint32_t firstIndex) {
+		for (uint32_t i = 0; i < num; i++) {
+			const float x = static_cast<float>((firstIndex + i) % 7) - 3.0f;
+			batch.Push(HoriMakeMatrixTranslate(Vector3(x, 0.0f, 20.0f + static_cast<float>(i % 13))), MakeColor(firstIndex + i), kLocalSphere);
+		}
+	}
+
+	void TestMultipleDraws() {
+		// 1フレームに数が違うDrawInstancing()を何回も呼ぶ(同じカメラでも、影などで別のカメラでも)
+		InstancingModel model;
+		InstanceBatch batch;
+		const Frustum frustum = MakeFrustum();
+
+		// 1フレーム目は途中で何回か作り直すが、先に描画したものは上書きされない
+		model.Update();
+		const std::vector<uint32_t> firstFrame = { 5, 12, 40, 3, 100 };
+		uint32_t total = 0;
+		for (uint32_t num : firstFrame) {
+			PushInstances(batch, num, total);
+			model.DrawInstancing(batch, frustum);
+			total += num;
+		}
+		TEST_CHECK(model.GetDrawNum() == firstFrame.size());
+		TEST_CHECK(1 < model.GetGrownNum());
+		TEST_CHECK(model.IsDrawsValid());
+		TEST_CHECK(total <= model.GetCapacity());
+
+		// 同じ数なら次のフレームからは作り直さない
+		for (int frame = 0; frame < 3; frame++) {
+			model.Update();
+			uint32_t index = 0;
+			for (uint32_t num : firstFrame) {
+				PushInstances(batch, num, index + 1000);
+				model.DrawInstancing(batch, frustum);
+				index += num;
+			}
+			TEST_CHECK(model.GetGrownNum() == 0);
+			TEST_CHECK(model.IsDrawsValid());
+		}
+
+		// 見えるものが無い描画はバッファを使わない
+		model.Update();
+		batch.Push(HoriMakeMatrixTranslate(Vector3(0.0f, 0.0f, -50.0f)), MakeColor(0), kLocalSphere);
+		model.DrawInstancing(batch, frustum);
+		TEST_CHECK(model.GetDrawNum() == 0 && batch.GetInstanceNum() == 0);
+
+		// ばらばらの数で長く回しても、どのフレームも全ての描画が読める
+		std::mt19937 random(14);
+		std::uniform_int_distribution<uint32_t> drawNumDist(1, 8);
+		std::uniform_int_distribution<uint32_t> instanceNumDist(0, 300);
+		bool isOk = true;
+		for (int frame = 0; frame < 200; frame++) {
+			model.Update();
+			const uint32_t drawNum = drawNumDist(random);
+			for (uint32_t i = 0; i < drawNum; i++) {
+				PushInstances(batch, instanceNumDist(random), i * 1000);
+				model.DrawInstancing(batch, frustum);
+			}
+			isOk &= model.IsDrawsValid();
+		}
+		TEST_CHECK(isOk);
+	}
+}
+
+int main() {
+	TestPack();
+	TestCapacity();
+	TestMultipleDraws();
+
+	return Test::Result("InstanceBatchTest");
+}
@@ -0,0 +1,182 @@
+// 行列の積、逆行列と行列を作る関数(user-001, user-002)、まとめて変換(user-003)、sincos(user-006)のベンチマーク
+// --quick を付けると回数を減らす(ctestで動くかだけ確かめる)
+#include "Tests/Common/Test.h"
+#include "Utils/Math/Vector3.h"
+#include "Utils/Math/Vector4.h"
+#include "Utils/Math/Mat4x4.h"
+#include "Utils/Math/Vector3Stream.h"
+#include "Utils/Math/SinCos.h"
+#include <vector>
+#include <random>
+
+namespace {
+	/// <summary>
+	/// 結果を使ったことにして、計算を消されないようにする
+	/// </summary>
+	volatile float sink = 0.0f;
+
+	template<class Func>
+	void Bench(const char* name, size_t count, Func func) {
+		// 1回目はキャッシュを温めるだけ
+		func();
+		const Test::Stopwatch stopwatch;
+		func();
+		const double milliSeconds = stopwatch.GetMilliSeconds();
+		std::printf("%-28s %10.2f ns/op\n", name, milliSeconds * 1.0e6 / static_cast<double>(count));
+	}
+
+	/// <summary>
+	/// 行列を作る関数のベンチマーク(作った行列は全て書き出して、一部の要素だけの計算にされないようにする)
+	/// </summary>
+	/// <param name="make">i回目に作る行列</param>
+	template<class Make>
+	void BenchMake(const char* name, size_t count, std::vector<Mat4x4>& results, Make make) {
+		const size_t mask = results.size() - 1;
+		Bench(name, count, [&]() {
+			for (size_t i = 0; i < count; i++) {
+				results[i & mask] = make(i);
+			}
+			sink = results[(count - 1) & mask][1][1];
+		});
+	}
+}
+
+int main(int argc, char** argv) {
+	const size_t count = Test::IsQuick(argc, argv) ? 1000 : 1000000;
+
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+	std::vector<Mat4x4> matrices(1024);
+	for (auto& mat : matrices) {
+		mat = VertMakeMatrixAffin(
+			Vector3(1.0f + std::abs(dist(random)), 1.0f + std::abs(dist(random)), 1.0f + std::abs(dist(random))),
+			Vector3(dist(random), dist(random), dist(random)),
+			Vector3(dist(random), dist(random), dist(random))
+		);
+	}
+	const size_t mask = matrices.size() - 1;
+
+	Bench("Mat4x4 * Mat4x4", count, [&]() {
+		Mat4x4 result = MakeMatrixIndentity();
+		for (size_t i = 0; i < count; i++) {
+			result = matrices[i & mask] * result;
+		}
+		sink = result[0][0];
+	});
+
+	Bench("MakeMatrixInverse", count, [&]() {
+		float sum = 0.0f;
+		for (size_t i = 0; i < count; i++) {
+			sum += MakeMatrixInverse(matrices[i & mask])[3][3];
+		}
+		sink = sum;
+	});
+
+	Bench("VertMakeMatrixInverseAffin", count, [&]() {
+		float sum = 0.0f;
+		for (size_t i = 0; i < count; i++) {
+			sum += VertMakeMatrixInverseAffin(matrices[i & mask])[0][3];
+		}
+		sink = sum;
+	});
+
+	std::vector<Mat4x4> horiMatrices(matrices.size());
+	for (size_t i = 0; i < matrices.size(); i++) {
+		horiMatrices[i] = MakeMatrixTransepose(matrices[i]);
+	}
+	Bench("HoriMakeMatrixInverseAffin", count, [&]() {
+		float sum = 0.0f;
+		for (size_t i = 0; i < count; i++) {
+			sum += HoriMakeMatrixInverseAffin(horiMatrices[i & mask])[3][0];
+		}
+		sink = sum;
+	});
+
+	// 行列を作る関数は、毎回違う引数を渡して定数にされないようにする
+	std::vector<Vector3> scales(matrices.size());
+	std::vector<Vector3> rotates(matrices.size());
+	std::vector<Vector3> translates(matrices.size());
+	std::vector<float> values(matrices.size());
+	for (size_t i = 0; i < matrices.size(); i++) {
+		scales[i] = Vector3(1.0f + std::abs(dist(random)), 1.0f + std::abs(dist(random)), 1.0f + std::abs(dist(random)));
+		rotates[i] = Vector3(dist(random), dist(random), dist(random));
+		translates[i] = Vector3(dist(random), dist(random), dist(random));
+		values[i] = 1.0f + std::abs(dist(random));
+	}
+	std::vector<Mat4x4> results(matrices.size());
+	BenchMake("HoriMakeMatrixRotateX", count, results, [&](size_t i) { return HoriMakeMatrixRotateX(values[i & mask]); });
+	BenchMake("VertMakeMatrixRotateX", count, results, [&](size_t i) { return VertMakeMatrixRotateX(values[i & mask]); });
+	BenchMake("HoriMakeMatrixRotateY", count, results, [&](size_t i) { return HoriMakeMatrixRotateY(values[i & mask]); });
+	BenchMake("VertMakeMatrixRotateY", count, results, [&](size_t i) { return VertMakeMatrixRotateY(values[i & mask]); });
+	BenchMake("HoriMakeMatrixRotateZ", count, results, [&](size_t i) { return HoriMakeMatrixRotateZ(values[i & mask]); });
+	BenchMake("VertMakeMatrixRotateZ", count, results, [&](size_t i) { return VertMakeMatrixRotateZ(values[i & mask]); });
+	BenchMake("HoriMakeMatrixAffin", count, results, [&](size_t i) {
+		return HoriMakeMatrixAffin(scales[i & mask], rotates[i & mask], translates[i & mask]);
+	});
+	BenchMake("VertMakeMatrixAffin", count, results, [&](size_t i) {
+		return VertMakeMatrixAffin(scales[i & mask], rotates[i & mask], translates[i & mask]);
+	});
+	BenchMake("HoriMakeMatrixTranslate", count, results, [&](size_t i) { return HoriMakeMatrixTranslate(translates[i & mask]); });
+	BenchMake("VertMakeMatrixTranslate", count, results, [&](size_t i) { return VertMakeMatrixTranslate(translates[i & mask]); });
+	BenchMake("MakeMatrixScalar", count, results, [&](size_t i) { return MakeMatrixScalar(scales[i & mask]); });
+	BenchMake("MakeMatrixTransepose", count, results, [&](size_t i) { return MakeMatrixTransepose(matrices[i & mask]); });
+	BenchMake("HoriMakeMatrixPerspectiveFov", count, results, [&](size_t i) {
+		return HoriMakeMatrixPerspectiveFov(values[i & mask] * 0.1f, 16.0f / 9.0f, 0.1f, 100.0f + values[i & mask]);
+	});
+	BenchMake("VertMakeMatrixPerspectiveFov", count, results, [&](size_t i) {
+		return VertMakeMatrixPerspectiveFov(values[i & mask] * 0.1f, 16.0f / 9.0f, 0.1f, 100.0f + values[i & mask]);
+	});
+	BenchMake("HoriMakeMatrixOrthographic", count, results, [&](size_t i) {
+		return HoriMakeMatrixOrthographic(-values[i & mask], values[i & mask], values[i & mask], -values[i & mask], 0.0f, 100.0f);
+	});
+	BenchMake("VertMakeMatrixOrthographic", count, results, [&](size_t i) {
+		return VertMakeMatrixOrthographic(-values[i & mask], values[i & mask], values[i & mask], -values[i & mask], 0.0f, 100.0f);
+	});
+	BenchMake("HoriMakeMatrixViewPort", count, results, [&](size_t i) {
+		return HoriMakeMatrixViewPort(0.0f, 0.0f, 1280.0f * values[i & mask], 720.0f * values[i & mask], 0.0f, 1.0f);
+	});
+	BenchMake("VertMakeMatrixViewPort", count, results, [&](size_t i) {
+		return VertMakeMatrixViewPort(0.0f, 0.0f, 1280.0f * values[i & mask], 720.0f * values[i & mask], 0.0f, 1.0f);
+	});
+
+	std::vector<Vector3> points(count);
+	for (auto& point : points) {
+		point = Vector3(dist(random), dist(random), dist(random));
+	}
+	std::vector<Vector3> transformed(points.size());
+	const Mat4x4 horiMatrix = MakeMatrixTransepose(matrices[0]);
+	Bench("Vector3 * Mat4x4", count, [&]() {
+		for (size_t i = 0; i < count; i++) {
+			transformed[i] = points[i] * horiMatrix;
+		}
+		sink = transformed.back().x;
+	});
+
+	Bench("TransformPoints(AoS)", count, [&]() {
+		TransformPoints(horiMatrix, points, transformed);
+		sink = transformed.back().x;
+	});
+
+	Vector3Stream stream(points);
+	Vector3Stream streamTransformed(points.size());
+	Bench("TransformPoints(SoA)", count, [&]() {
+		TransformPoints(horiMatrix, stream, streamTransformed);
+		sink = streamTransformed.x.back();
+	});
+
+	Bench("SinCos4 (per 4 angles)", count, [&]() {
+		__m128 sum = _mm_setzero_ps();
+		__m128 rad = _mm_set_ps(0.1f, 0.2f, 0.3f, 0.4f);
+		const __m128 step = _mm_set1_ps(0.001f);
+		for (size_t i = 0; i < count; i++) {
+			__m128 sinValue{};
+			__m128 cosValue{};
+			SinCos4(rad, sinValue, cosValue);
+			sum = _mm_add_ps(sum, _mm_add_ps(sinValue, cosValue));
+			rad = _mm_add_ps(rad, step);
+		}
+		sink = _mm_cvtss_f32(sum);
+	});
+
+	return 0;
+}
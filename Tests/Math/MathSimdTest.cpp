@@ -0,0 +1,118 @@
+// SIMD版とスカラー版(MATH_NO_SIMD)の行列、ベクトル演算の結果がビット単位で一致するかのテスト(user-001, user-003)
+// スカラー版でビルドしたものが --write で結果をファイルに書き出し、SIMD版が --compare で読み込んで比べる
+#include "Tests/Common/Test.h"
+#include "Utils/Math/Vector3.h"
+#include "Utils/Math/Vector4.h"
+#include "Utils/Math/Mat4x4.h"
+#include "Utils/Math/Quaternion.h"
+#include "Utils/Math/Vector3Stream.h"
+#include <array>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <random>
+#include <iterator>
+
+namespace {
+	/// <summary>
+	/// 比べる値を順番に並べる
+	/// </summary>
+	std::vector<float> Calculate() {
+		std::vector<float> results;
+		const auto push = [&results](const auto& value) {
+			const float* data = reinterpret_cast<const float*>(&value);
+			results.insert(results.end(), data, data + sizeof(value) / sizeof(float));
+		};
+
+		std::mt19937 random(1);
+		std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+		for (int n = 0; n < 10000; n++) {
+			Mat4x4 left;
+			Mat4x4 right;
+			for (size_t y = 0; y < 4; y++) {
+				for (size_t x = 0; x < 4; x++) {
+					left[y][x] = dist(random);
+					right[y][x] = dist(random);
+				}
+			}
+			const Vector4 vec4(dist(random), dist(random), dist(random), dist(random));
+			const Vector3 vec3(dist(random), dist(random), dist(random));
+
+			push(left * right);
+			push(left + right);
+			push(left - right);
+			push(MakeMatrixTransepose(left));
+			push(vec4 * left);
+			push(left * vec4);
+			push(vec4.Dot(left[0]));
+			push(vec4.Length());
+
+			const Quaternion quaternion(vec4.vec.x, vec4.vec.y, vec4.vec.z, vec4.vec.w);
+			const Quaternion quaternionRight(left[0].vec.x, left[0].vec.y, left[0].vec.z, left[0].vec.w);
+			push(quaternion.Dot(quaternionRight));
+			push(quaternion.Length());
+
+			// アフィン変換(wが1になる)で座標を変換する
+			right[0][3] = 0.0f;
+			right[1][3] = 0.0f;
+			right[2][3] = 0.0f;
+			right[3][3] = 1.0f;
+			push(vec3 * right);
+		}
+
+		// まとめて変換しても1つずつと同じ(端数の分も含めて、AVXとSSEとスカラーの全ての経路を通す)
+		const Mat4x4 mat = HoriMakeMatrixAffin(Vector3(1.0f, 2.0f, 3.0f), Vector3(0.1f, 0.2f, 0.3f), Vector3(4.0f, 5.0f, 6.0f));
+		std::vector<Vector3> points(1003);
+		for (auto& point : points) {
+			point = Vector3(dist(random), dist(random), dist(random));
+		}
+		std::vector<Vector3> transformed(points.size());
+		TransformPoints(mat, points, transformed);
+		for (const auto& point : transformed) {
+			push(point);
+		}
+
+		Vector3Stream stream(points);
+		TransformPoints(mat, stream, stream);
+		for (size_t i = 0; i < stream.Size(); i++) {
+			push(stream.Get(i));
+		}
+
+		return results;
+	}
+}
+
+int main(int argc, char** argv) {
+	if (argc != 3) {
+		std::fprintf(stderr, "usage: %s --write|--compare <file>\n", argv[0]);
+		return 1;
+	}
+	const std::string mode = argv[1];
+	const std::vector<float> results = Calculate();
+
+	if (mode == "--write") {
+		std::ofstream file(argv[2], std::ios::binary);
+		file.write(reinterpret_cast<const char*>(results.data()), static_cast<std::streamsize>(results.size() * sizeof(float)));
+		TEST_CHECK(file.good());
+		return Test::Result("MathSimdTest(write)");
+	}
+
+	std::ifstream file(argv[2], std::ios::binary);
+	const std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	TEST_CHECK(bytes.size() == results.size() * sizeof(float));
+	if (bytes.size() == results.size() * sizeof(float)) {
+		size_t differentNum = 0;
+		for (size_t i = 0; i < results.size(); i++) {
+			float expected = 0.0f;
+			std::memcpy(&expected, bytes.data() + i * sizeof(float), sizeof(float));
+			if (std::memcmp(&expected, &results[i], sizeof(float)) != 0) {
+				if (differentNum == 0) {
+					std::fprintf(stderr, "first difference at %zu : scalar %.9g simd %.9g\n", i, expected, results[i]);
+				}
+				differentNum++;
+			}
+		}
+		TEST_CHECK(differentNum == 0);
+	}
+	return Test::Result("MathSimdTest");
+}
@@ -0,0 +1,466 @@
+// 行列(user-001, user-002)、コンパイル時計算(user-004)、クォータニオンの補間とTransform(user-005)、sincos(user-006)、視錐台(user-007)のテスト
+#include "Tests/Common/Test.h"
+#include "Utils/Math/Vector2.h"
+#include "Utils/Math/Vector3.h"
+#include "Utils/Math/Vector4.h"
+#include "Utils/Math/Mat4x4.h"
+#include "Utils/Math/Quaternion.h"
+#include "Utils/Math/SinCos.h"
+#include "Utils/Math/Bounds.h"
+#include "Utils/Math/Frustum.h"
+#include "Utils/Transform/Transform.h"
+#include <array>
+#include <vector>
+#include <random>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+#include <memory>
+#include <span>
+#include <numbers>
+
+namespace {
+	// そのままmemcpyやGPUへの転送に使えるか
+	static_assert(std::is_trivially_copyable_v<Vector2>);
+	static_assert(std::is_trivially_copyable_v<Vector3>);
+	static_assert(std::is_trivially_copyable_v<Vector4>);
+	static_assert(std::is_trivially_copyable_v<Mat4x4>);
+	static_assert(std::is_trivially_copyable_v<Quaternion>);
+	static_assert(std::is_trivially_copyable_v<Sphere>);
+
+	// コンパイル時に計算できるか
+	constexpr Mat4x4 kConstexprMatrix = HoriMakeMatrixTranslate(Vector3(1.0f, 2.0f, 3.0f));
+	static_assert(kConstexprMatrix[3][1] == 2.0f && kConstexprMatrix[0][0] == 1.0f && kConstexprMatrix[3][3] == 1.0f);
+	constexpr Mat4x4 kConstexprViewPort = VertMakeMatrixViewPort(0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 1.0f);
+	static_assert(kConstexprViewPort[0][0] == 640.0f && kConstexprViewPort[1][1] == -360.0f);
+	constexpr std::array<Vector4, 2> kConstexprVectors = { Vector4(1.0f, 2.0f, 3.0f, 4.0f), Vector4() };
+	static_assert(kConstexprVectors[0][3] == 4.0f && kConstexprVectors[1][0] == 0.0f);
+
+	Mat4x4 MakeRandomMatrix(std::mt19937& random, float range) {
+		std::uniform_real_distribution<float> dist(-range, range);
+		Mat4x4 mat;
+		for (size_t y = 0; y < 4; y++) {
+			for (size_t x = 0; x < 4; x++) {
+				mat[y][x] = dist(random);
+			}
+		}
+		return mat;
+	}
+
+	Mat4x4 MakeRandomAffin(std::mt19937& random, bool isHori) {
+		std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+		std::uniform_real_distribution<float> rad(-3.14f, 3.14f);
+		std::uniform_real_distribution<float> translate(-10.0f, 10.0f);
+		const Vector3 s(scale(random), scale(random), scale(random));
+		const Vector3 r(rad(random), rad(random), rad(random));
+		const Vector3 t(translate(random), translate(random), translate(random));
+		return isHori ? HoriMakeMatrixAffin(s, r, t) : VertMakeMatrixAffin(s, r, t);
+	}
+
+	/// <summary>
+	/// 行列が単位行列に近いか
+	/// </summary>
+	bool IsNearIdentity(const Mat4x4& mat, float tolerance) {
+		for (size_t y = 0; y < 4; y++) {
+			for (size_t x = 0; x < 4; x++) {
+				if (tolerance < std::abs(mat[y][x] - (x == y ? 1.0f : 0.0f))) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	bool IsNear(const Mat4x4& left, const Mat4x4& right, float tolerance) {
+		for (size_t y = 0; y < 4; y++) {
+			for (size_t x = 0; x < 4; x++) {
+				if (tolerance < std::abs(left[y][x] - right[y][x])) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	bool IsNear(const Quaternion& left, const Quaternion& right, float tolerance) {
+		for (size_t i = 0; i < 4; i++) {
+			if (!(std::abs(left[i] - right[i]) <= tolerance)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void TestMatrixMultiply() {
+		std::mt19937 random(1);
+		for (int n = 0; n < 10000; n++) {
+			const Mat4x4 left = MakeRandomMatrix(random, 10.0f);
+			const Mat4x4 right = MakeRandomMatrix(random, 10.0f);
+			const Mat4x4 result = left * right;
+
+			// doubleで計算した値との差が、掛けた値の大きさに対して十分小さいか
+			bool isOk = true;
+			for (size_t y = 0; y < 4; y++) {
+				for (size_t x = 0; x < 4; x++) {
+					double expected = 0.0;
+					double magnitude = 0.0;
+					for (size_t i = 0; i < 4; i++) {
+						expected += static_cast<double>(left[y][i]) * right[i][x];
+						magnitude += std::abs(static_cast<double>(left[y][i]) * right[i][x]);
+					}
+					isOk &= std::abs(result[y][x] - expected) <= magnitude * 1.0e-6 + 1.0e-30;
+				}
+			}
+			TEST_CHECK(isOk);
+
+			Mat4x4 assigned = left;
+			assigned *= right;
+			TEST_CHECK(assigned == result);
+
+			const Mat4x4 sum = left + right;
+			const Mat4x4 difference = left - right;
+			const Mat4x4 transposed = MakeMatrixTransepose(left);
+			for (size_t y = 0; y < 4; y++) {
+				for (size_t x = 0; x < 4; x++) {
+					isOk &= sum[y][x] == left[y][x] + right[y][x];
+					isOk &= difference[y][x] == left[y][x] - right[y][x];
+					isOk &= transposed[y][x] == left[x][y];
+				}
+			}
+			TEST_CHECK(isOk);
+
+			// 横ベクトル(v * M)と縦ベクトル(M * v)
+			const Vector4 vec(left[0][0], left[1][1], left[2][2], left[3][3]);
+			const Vector4 hori = vec * right;
+			const Vector4 vert = right * vec;
+			for (size_t i = 0; i < 4; i++) {
+				double horiExpected = 0.0;
+				double vertExpected = 0.0;
+				double horiMagnitude = 0.0;
+				double vertMagnitude = 0.0;
+				for (size_t j = 0; j < 4; j++) {
+					horiExpected += static_cast<double>(vec[j]) * right[j][i];
+					vertExpected += static_cast<double>(right[i][j]) * vec[j];
+					horiMagnitude += std::abs(static_cast<double>(vec[j]) * right[j][i]);
+					vertMagnitude += std::abs(static_cast<double>(right[i][j]) * vec[j]);
+				}
+				isOk &= std::abs(hori[i] - horiExpected) <= horiMagnitude * 1.0e-6 + 1.0e-30;
+				isOk &= std::abs(vert[i] - vertExpected) <= vertMagnitude * 1.0e-6 + 1.0e-30;
+			}
+			TEST_CHECK(isOk);
+		}
+	}
+
+	/// <summary>
+	/// doubleで部分ピボット付きのガウス・ジョルダン法で求めた逆行列
+	/// </summary>
+	std::array<std::array<double, 4>, 4> CalcInverseReference(const Mat4x4& mat) {
+		std::array<std::array<double, 8>, 4> work{};
+		for (size_t y = 0; y < 4; y++) {
+			for (size_t x = 0; x < 4; x++) {
+				work[y][x] = mat[y][x];
+				work[y][x + 4] = x == y ? 1.0 : 0.0;
+			}
+		}
+		for (size_t i = 0; i < 4; i++) {
+			size_t pivot = i;
+			for (size_t y = i + 1; y < 4; y++) {
+				if (std::abs(work[pivot][i]) < std::abs(work[y][i])) {
+					pivot = y;
+				}
+			}
+			std::swap(work[i], work[pivot]);
+			const double scale = 1.0 / work[i][i];
+			for (auto& value : work[i]) {
+				value *= scale;
+			}
+			for (size_t y = 0; y < 4; y++) {
+				if (y != i) {
+					const double factor = work[y][i];
+					for (size_t x = 0; x < 8; x++) {
+						work[y][x] -= factor * work[i][x];
+					}
+				}
+			}
+		}
+		std::array<std::array<double, 4>, 4> result{};
+		for (size_t y = 0; y < 4; y++) {
+			for (size_t x = 0; x < 4; x++) {
+				result[y][x] = work[y][x + 4];
+			}
+		}
+		return result;
+	}
+
+	/// <summary>
+	/// 逆行列の各要素の誤差が、その行の一番大きい要素に対して十分小さいか
+	/// </summary>
+	bool IsNearInverse(const Mat4x4& inverse, const Mat4x4& mat, double tolerance) {
+		const std::array<std::array<double, 4>, 4> expected = CalcInverseReference(mat);
+		for (size_t y = 0; y < 4; y++) {
+			double rowMax = 0.0;
+			for (size_t x = 0; x < 4; x++) {
+				rowMax = std::max(rowMax, std::abs(expected[y][x]));
+			}
+			for (size_t x = 0; x < 4; x++) {
+				if (rowMax * tolerance < std::abs(inverse[y][x] - expected[y][x])) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	void TestMatrixInverse() {
+		std::mt19937 random(2);
+		for (int n = 0; n < 10000; n++) {
+			// 一般の逆行列(透視投影とアフィン変換の積)
+			const Mat4x4 projection = VertMakeMatrixPerspectiveFov(0.45f, 16.0f / 9.0f, 0.1f, 100.0f);
+			const Mat4x4 vertAffin = MakeRandomAffin(random, false);
+			const Mat4x4 viewProjection = projection * vertAffin;
+			TEST_CHECK(IsNearInverse(MakeMatrixInverse(viewProjection), viewProjection, 2.0e-4));
+			TEST_CHECK(IsNearInverse(MakeMatrixInverse(vertAffin), vertAffin, 1.0e-5));
+
+			// アフィン変換の逆行列は一般の逆行列と同じになる
+			TEST_CHECK(IsNearInverse(VertMakeMatrixInverseAffin(vertAffin), vertAffin, 1.0e-5));
+			const Mat4x4 horiAffin = MakeRandomAffin(random, true);
+			const Mat4x4 horiInverse = HoriMakeMatrixInverseAffin(horiAffin);
+			TEST_CHECK(IsNearInverse(horiInverse, horiAffin, 1.0e-5));
+			TEST_CHECK(IsNearIdentity(horiAffin * horiInverse, 1.0e-4f));
+
+			// 横ベクトル用と縦ベクトル用は転置の関係
+			TEST_CHECK(IsNearInverse(MakeMatrixTransepose(horiInverse), MakeMatrixTransepose(horiAffin), 1.0e-5));
+		}
+
+		// 逆行列が無ければそのまま
+		const Mat4x4 singular = MakeMatrixScalar(Vector3(1.0f, 0.0f, 1.0f));
+		TEST_CHECK(MakeMatrixInverse(singular) == singular);
+	}
+
+	void TestSinCos() {
+		constexpr float kMaxRad = 8192.0f;
+		constexpr float kSmallResult = 1.0f / 1024.0f;
+		constexpr float kMaxAbsError = 8.0e-8f;
+
+		uint32_t maxUlp = 0;
+		float maxAbsError = 0.0f;
+		const auto check = [&](float rad, float sinValue, float cosValue) {
+			const float expectedSin = std::sin(rad);
+			const float expectedCos = std::cos(rad);
+			for (auto [value, expected] : { std::make_pair(sinValue, expectedSin), std::make_pair(cosValue, expectedCos) }) {
+				if (kSmallResult <= std::abs(expected)) {
+					maxUlp = std::max(maxUlp, Test::UlpDistance(value, expected));
+				}
+				else {
+					maxAbsError = std::max(maxAbsError, std::abs(value - expected));
+				}
+			}
+		};
+
+		// 範囲の中をまんべんなく調べる
+		std::mt19937 random(3);
+		std::uniform_real_distribution<float> dist(-kMaxRad, kMaxRad);
+		for (int n = 0; n < 1000000; n++) {
+			alignas(16) std::array<float, 4> rad = { dist(random), dist(random) * 0.001f, dist(random) * 1.0e-6f, static_cast<float>(n % 4096) * 1.5707964f };
+			__m128 sinValue{};
+			__m128 cosValue{};
+			SinCos4(_mm_load_ps(rad.data()), sinValue, cosValue);
+			alignas(16) std::array<float, 4> sinArray{};
+			alignas(16) std::array<float, 4> cosArray{};
+			_mm_store_ps(sinArray.data(), sinValue);
+			_mm_store_ps(cosArray.data(), cosValue);
+			for (size_t i = 0; i < 4; i++) {
+				check(rad[i], sinArray[i], cosArray[i]);
+			}
+		}
+		TEST_CHECK(maxUlp <= 2);
+		TEST_CHECK(maxAbsError <= kMaxAbsError);
+
+		// 範囲の外(NaNと無限大も含む)はstd::sin/std::cosと同じ
+		const std::array<float, 8> largeRads = {
+			kMaxRad * 1.5f, -1.0e9f, 1.7e9f, 3.0e38f,
+			std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(), std::numeric_limits<float>::quiet_NaN(), -2.0e20f
+		};
+		for (float rad : largeRads) {
+			float sinValue = 0.0f;
+			float cosValue = 0.0f;
+			SinCos(rad, sinValue, cosValue);
+			if (std::isnan(rad) || std::isinf(rad)) {
+				TEST_CHECK(std::isnan(sinValue) && std::isnan(cosValue));
+			}
+			else {
+				TEST_CHECK(sinValue == std::sin(rad) && cosValue == std::cos(rad));
+			}
+		}
+	}
+
+	void TestQuaternionLerp() {
+		const Vector3 axisY(0.0f, 1.0f, 0.0f);
+		const Quaternion start = Quaternion::MakeRotateAxisAngle(Vector3(1.0f, 0.0f, 0.0f), 0.3f);
+		const Quaternion end = Quaternion::MakeRotateAxisAngle(axisY, 2.0f) * start;
+
+		// 端では始点と終点そのもの
+		TEST_CHECK(IsNear(Slerp(start, end, 0.0f), start, 1.0e-6f));
+		TEST_CHECK(IsNear(Slerp(start, end, 1.0f), end, 1.0e-6f));
+		TEST_CHECK(IsNear(Nlerp(start, end, 0.0f), start, 1.0e-6f));
+		TEST_CHECK(IsNear(Nlerp(start, end, 1.0f), end, 1.0e-6f));
+
+		// Slerpは角速度が一定で、途中も長さが1
+		bool isOk = true;
+		for (int i = 0; i <= 8; i++) {
+			const float t = static_cast<float>(i) / 8.0f;
+			const Quaternion slerp = Slerp(start, end, t);
+			isOk &= IsNear(slerp, Quaternion::MakeRotateAxisAngle(axisY, 2.0f * t) * start, 1.0e-5f);
+			isOk &= std::abs(slerp.Length() - 1.0f) < 1.0e-5f && std::abs(Nlerp(start, end, t).Length() - 1.0f) < 1.0e-5f;
+		}
+		TEST_CHECK(isOk);
+
+		// 符号を反転した終点(同じ回転)を渡しても遠回りせず、同じ結果になる
+		const Quaternion farEnd = Quaternion::MakeRotateAxisAngle(axisY, 4.0f);
+		TEST_CHECK(farEnd.Dot(Quaternion::identity) < 0.0f);
+		const Quaternion nearEnd = farEnd * -1.0f;
+		TEST_CHECK(IsNear(Slerp(Quaternion::identity, farEnd, 0.5f), Quaternion::MakeRotateAxisAngle(axisY, 2.0f - std::numbers::pi_v<float>), 1.0e-5f));
+		TEST_CHECK(IsNear(Slerp(Quaternion::identity, farEnd, 0.5f), Slerp(Quaternion::identity, nearEnd, 0.5f), 1.0e-6f));
+		TEST_CHECK(IsNear(Nlerp(Quaternion::identity, farEnd, 0.5f), Nlerp(Quaternion::identity, nearEnd, 0.5f), 1.0e-6f));
+		TEST_CHECK(0.0f < Nlerp(Quaternion::identity, farEnd, 0.5f).Dot(Quaternion::identity));
+		TEST_CHECK(IsNear(Slerp(start, end * -1.0f, 0.25f), Slerp(start, end, 0.25f), 1.0e-5f));
+
+		// ほぼ同じ向き(反転したものも)では、sinθで割っても壊れずに間の値になる
+		for (float rad : { 0.0f, 1.0e-6f, 1.0e-3f, 0.03f }) {
+			const Quaternion parallelStart = Quaternion::MakeRotateAxisAngle(axisY, 1.0f);
+			const Quaternion parallelEnd = Quaternion::MakeRotateAxisAngle(axisY, 1.0f + rad);
+			const Quaternion expected = Quaternion::MakeRotateAxisAngle(axisY, 1.0f + rad * 0.5f);
+			TEST_CHECK(IsNear(Slerp(parallelStart, parallelEnd, 0.5f), expected, 1.0e-5f));
+			TEST_CHECK(IsNear(Slerp(parallelStart, parallelEnd * -1.0f, 0.5f), expected, 1.0e-5f));
+			TEST_CHECK(IsNear(Nlerp(parallelStart, parallelEnd, 0.5f), expected, 1.0e-5f));
+		}
+	}
+
+	void TestTransform() {
+		const Vector3 scale(2.0f, 3.0f, 0.5f);
+		const Vector3 rad(0.3f, -1.2f, 2.0f);
+		const Vector3 translate(4.0f, -5.0f, 6.0f);
+
+		// 作った直後は行列を作っていない
+		Transform transform;
+		TEST_CHECK(transform.IsDirty());
+		TEST_CHECK(IsNear(transform.GetHoriMatrix(), MakeMatrixIndentity(), 0.0f));
+		TEST_CHECK(!transform.IsDirty());
+
+		transform.SetScale(scale);
+		transform.SetRotate(rad);
+		transform.SetTranslate(translate);
+		TEST_CHECK(transform.IsDirty());
+		TEST_CHECK(IsNear(transform.GetHoriMatrix(), HoriMakeMatrixAffin(scale, rad, translate), 1.0e-5f));
+		TEST_CHECK(IsNear(transform.GetVertMatrix(), MakeMatrixTransepose(HoriMakeMatrixAffin(scale, rad, translate)), 1.0e-5f));
+		TEST_CHECK(!transform.IsDirty());
+
+		// 同じ値を設定し直しても汚れない(Texture2D::Update()は毎フレーム設定してIsDirty()の時だけ頂点を計算する)
+		transform.SetScale(scale);
+		transform.SetRotate(rad);
+		transform.SetTranslate(translate);
+		TEST_CHECK(!transform.IsDirty());
+
+		// どれか1つでも変われば汚れて、行列を取得するまでそのまま
+		transform.SetScale(Vector3(1.0f, 3.0f, 0.5f));
+		TEST_CHECK(transform.IsDirty());
+		transform.SetScale(scale);
+		TEST_CHECK(transform.IsDirty());
+		TEST_CHECK(IsNear(transform.GetHoriMatrix(), HoriMakeMatrixAffin(scale, rad, translate), 1.0e-5f));
+
+		transform.SetTranslate(Vector3(4.0f, -5.0f, 7.0f));
+		TEST_CHECK(transform.IsDirty());
+		transform.GetVertMatrix();
+		TEST_CHECK(!transform.IsDirty());
+		transform.SetRotate(Vector3(0.3f, -1.2f, 2.5f));
+		TEST_CHECK(transform.IsDirty());
+		transform.GetHoriMatrix();
+
+		// クォータニオンで回転を変えた後は、前と同じオイラー角でも設定し直す
+		transform.SetRotate(Quaternion::identity);
+		TEST_CHECK(transform.IsDirty());
+		transform.GetHoriMatrix();
+		transform.SetRotate(Vector3(0.3f, -1.2f, 2.5f));
+		TEST_CHECK(transform.IsDirty());
+		TEST_CHECK(IsNear(transform.GetHoriMatrix(), HoriMakeMatrixAffin(scale, Vector3(0.3f, -1.2f, 2.5f), Vector3(4.0f, -5.0f, 7.0f)), 1.0e-5f));
+		transform.SetRotate(Quaternion::identity);
+		transform.GetHoriMatrix();
+		transform.SetRotate(Quaternion::identity);
+		TEST_CHECK(!transform.IsDirty());
+
+		// Texture2D::Update()と同じく毎フレーム設定して、変わったフレームだけ頂点を計算し直す
+		Transform sprite;
+		uint32_t updateNum = 0;
+		for (uint32_t frame = 0; frame < 100; frame++) {
+			const float x = static_cast<float>(frame / 10);
+			sprite.SetScale(Vector3(64.0f, 32.0f, 1.0f));
+			sprite.SetRotate(Vector3(0.0f, 0.0f, frame < 50 ? 0.0f : 0.5f));
+			sprite.SetTranslate(Vector3(x, 0.0f, 0.0f));
+			if (sprite.IsDirty()) {
+				sprite.GetHoriMatrix();
+				updateNum++;
+			}
+		}
+		// 位置が変わる10回(回転が変わるフレームも位置が変わる)
+		TEST_CHECK(updateNum == 10);
+	}
+
+	void TestFrustum() {
+		const Mat4x4 projection = VertMakeMatrixPerspectiveFov(0.45f, 16.0f / 9.0f, 0.1f, 100.0f);
+		const Mat4x4 view = VertMakeMatrixInverseAffin(VertMakeMatrixAffin(Vector3::identity, Vector3(0.3f, 0.5f, 0.1f), Vector3(1.0f, 2.0f, -10.0f)));
+		const Mat4x4 viewProjection = projection * view;
+		const Frustum frustum(viewProjection);
+
+		// 球の中心を画面に映して、確実に見えるものと見えないものを確かめる
+		const Mat4x4 inverse = MakeMatrixInverse(viewProjection);
+		const auto unproject = [&inverse](float x, float y, float z) {
+			const Vector4 pos = inverse * Vector4(x, y, z, 1.0f);
+			return Vector3(pos.vec.x / pos.vec.w, pos.vec.y / pos.vec.w, pos.vec.z / pos.vec.w);
+		};
+		TEST_CHECK(frustum.IsVisible(Sphere{ unproject(0.0f, 0.0f, 0.5f), 0.01f }));
+		TEST_CHECK(frustum.IsVisible(Sphere{ unproject(0.99f, -0.99f, 0.9f), 0.0f }));
+		TEST_CHECK(!frustum.IsVisible(Sphere{ unproject(1.5f, 0.0f, 0.5f), 0.0f }));
+		TEST_CHECK(!frustum.IsVisible(Sphere{ unproject(0.0f, -1.5f, 0.5f), 0.0f }));
+		TEST_CHECK(!frustum.IsVisible(Sphere{ unproject(0.0f, 0.0f, 1.01f), 0.0f }));
+		TEST_CHECK(frustum.IsVisible(AABB(unproject(0.0f, 0.0f, 0.5f), unproject(0.0f, 0.0f, 0.5f) + Vector3::identity)));
+
+		// まとめて判定しても1つずつと同じ(端数の分も含めて、AVXとSSEとスカラーの全ての経路を通す)
+		std::mt19937 random(4);
+		std::uniform_real_distribution<float> posDist(-60.0f, 60.0f);
+		std::uniform_real_distribution<float> radiusDist(0.0f, 5.0f);
+		std::vector<Sphere> spheres(10007);
+		for (auto& sphere : spheres) {
+			sphere = Sphere{ Vector3(posDist(random), posDist(random), posDist(random)), radiusDist(random) };
+		}
+		std::unique_ptr<bool[]> isVisible = std::make_unique<bool[]>(spheres.size());
+		frustum.CullSpheres(spheres, std::span<bool>(isVisible.get(), spheres.size()));
+
+		size_t visibleNum = 0;
+		bool isSame = true;
+		bool isAABBConservative = true;
+		for (size_t i = 0; i < spheres.size(); i++) {
+			isSame &= isVisible[i] == frustum.IsVisible(spheres[i]);
+			visibleNum += isVisible[i] ? 1 : 0;
+
+			// 球が見えるなら、球を含むAABBも見える
+			const Vector3 extent(spheres[i].radius, spheres[i].radius, spheres[i].radius);
+			if (isVisible[i]) {
+				isAABBConservative &= frustum.IsVisible(AABB(spheres[i].center - extent, spheres[i].center + extent));
+			}
+		}
+		TEST_CHECK(isSame);
+		TEST_CHECK(isAABBConservative);
+		TEST_CHECK(0 < visibleNum && visibleNum < spheres.size());
+	}
+}
+
+int main() {
+	TestMatrixMultiply();
+	TestMatrixInverse();
+	TestQuaternionLerp();
+	TestTransform();
+	TestSinCos();
+	TestFrustum();
+
+	return Test::Result("MathTest");
+}
@@ -0,0 +1,137 @@
+// メッシュのキャッシュ(user-011)のテスト(元ファイルの更新日時だけ変わった時、objから作るのとの速度)
+// リポジトリの一番上で動かす(ctestはそこで動かす)。--quick を付けるとベンチマークを小さくする
+// 作ったobjとキャッシュは一時フォルダーに置く
+#include "Tests/Common/Test.h"
+#include "Tests/ObjLoader/TestObj.h"
+#include "MeshManager/Mesh/MeshLoader.h"
+#include "Drawers/Model/MeshCache/MeshCache.h"
+#include "Drawers/Model/ObjLoader/ObjLoader.h"
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <chrono>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+
+namespace {
+	using VertData = MeshLoader::VertData;
+
+	void WriteFile(const std::filesystem::path& path, const std::string& text) {
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file << text;
+	}
+
+	std::string ReadFile(const std::filesystem::path& path) {
+		std::ifstream file(path, std::ios::binary);
+		std::ostringstream text;
+		text << file.rdbuf();
+		return text.str();
+	}
+
+	bool CreateAndSave(const std::string& objFileName) {
+		MeshCache meshCache;
+		std::string errorText;
+		return MeshLoader::CreateMeshCache(objFileName, meshCache, errorText) && meshCache.Save();
+	}
+
+	void TestSourceTime(const std::filesystem::path& directory) {
+		Test::ObjSetting setting;
+		setting.gridNum = 16;
+		const std::string text = Test::MakeObjText(setting);
+		const std::filesystem::path path = directory / "touched.obj";
+		WriteFile(path, text);
+		const std::string objFileName = path.string();
+		TEST_CHECK(CreateAndSave(objFileName));
+		const std::string cacheImage = ReadFile(MeshCache::GetCacheFileName(objFileName));
+
+		// 中身を変えずに更新日時だけ進めても使え、ヘッダーの日時だけが書き戻される
+		const auto touchedTime = std::filesystem::last_write_time(path) + std::chrono::hours(1);
+		std::filesystem::last_write_time(path, touchedTime);
+		MeshCache meshCache;
+		TEST_CHECK(meshCache.Load(objFileName, sizeof(VertData)));
+		TEST_CHECK(meshCache.GetSubmeshes().size() == 1);
+		meshCache.Close();
+		const std::string patchedImage = ReadFile(MeshCache::GetCacheFileName(objFileName));
+		TEST_CHECK(patchedImage.size() == cacheImage.size() && patchedImage != cacheImage);
+		size_t differentNum = 0;
+		for (size_t i = 0; i < std::min(patchedImage.size(), cacheImage.size()); i++) {
+			differentNum += patchedImage[i] != cacheImage[i] ? 1 : 0;
+		}
+		TEST_CHECK(differentNum <= sizeof(int64_t));
+
+		// 書き戻した後はサイズと日時だけで判定する(同じサイズ、同じ日時のまま中身を変えてもハッシュを取らないので使う)
+		std::string changedText = text;
+		changedText[changedText.find("v ") + 2] = changedText[changedText.find("v ") + 2] == '-' ? '+' : '-';
+		WriteFile(path, changedText);
+		std::filesystem::last_write_time(path, touchedTime);
+		TEST_CHECK(meshCache.Load(objFileName, sizeof(VertData)));
+		meshCache.Close();
+
+		// 日時も変われば、ハッシュが違うので使わない
+		std::filesystem::last_write_time(path, touchedTime + std::chrono::hours(1));
+		TEST_CHECK(!meshCache.Load(objFileName, sizeof(VertData)));
+	}
+
+	void Bench(const std::filesystem::path& directory, bool isQuick) {
+		// 同梱のobjと、大きいモデルの代わりに作ったもので、objから作るのとキャッシュを読むのを比べる
+		std::vector<std::string> objFileNames;
+		for (const char* fileName : { "Resources/Ball.obj", "Resources/skydome/skydome.obj" }) {
+			const std::filesystem::path path = directory / std::filesystem::path(fileName).filename();
+			std::filesystem::copy_file(fileName, path, std::filesystem::copy_options::overwrite_existing);
+			objFileNames.push_back(path.string());
+		}
+		Test::ObjSetting setting;
+		setting.gridNum = isQuick ? 128 : 512;
+		setting.mtlNames = { "Body", "Face", "Fuku", "Hair" };
+		setting.groupFaceNum = 4096;
+		const std::filesystem::path generatedPath = directory / "generated.obj";
+		WriteFile(generatedPath, Test::MakeObjText(setting));
+		objFileNames.push_back(generatedPath.string());
+
+		const int count = isQuick ? 1 : 5;
+		std::vector<std::byte> uploadBuffer;
+		for (const auto& objFileName : objFileNames) {
+			double parseTime = 0.0;
+			double createTime = 0.0;
+			double loadTime = 0.0;
+			for (int i = 0; i < count; i++) {
+				const Test::Stopwatch parseStopwatch;
+				ObjLoader loader;
+				TEST_CHECK(loader.Load(objFileName));
+				parseTime += parseStopwatch.GetMilliSeconds();
+
+				const Test::Stopwatch createStopwatch;
+				TEST_CHECK(CreateAndSave(objFileName));
+				createTime += createStopwatch.GetMilliSeconds();
+
+				// マップしただけでは読まれないので、Mesh::Upload()と同じように頂点とインデックスをコピーするまでを測る
+				const Test::Stopwatch loadStopwatch;
+				MeshCache meshCache;
+				TEST_CHECK(meshCache.Load(objFileName, sizeof(VertData)));
+				for (const auto& submesh : meshCache.GetSubmeshes()) {
+					uploadBuffer.assign(submesh.vertices.begin(), submesh.vertices.end());
+					uploadBuffer.insert(uploadBuffer.end(), submesh.indices.begin(), submesh.indices.end());
+				}
+				loadTime += loadStopwatch.GetMilliSeconds();
+			}
+			std::printf("%-16s : ObjLoader %.3f ms, obj to cache %.3f ms, cache %.3f ms (x%.0f)\n",
+				std::filesystem::path(objFileName).filename().string().c_str(),
+				parseTime / count, createTime / count, loadTime / count, createTime / loadTime
+			);
+		}
+	}
+}
+
+int main(int argc, char** argv) {
+	const std::filesystem::path directory = std::filesystem::temp_directory_path() / "Engine2MeshCacheTest";
+	std::filesystem::remove_all(directory);
+	std::filesystem::create_directories(directory);
+
+	TestSourceTime(directory);
+	Bench(directory, Test::IsQuick(argc, argv));
+
+	std::filesystem::remove_all(directory);
+	return Test::Result("MeshCacheTest");
+}
@@ -0,0 +1,141 @@
+// GPUを使わないMeshの読み込み(user-019)のテスト
+// フレームを回しながら50個のモデルをワーカースレッドで読み込み、エラーがメインスレッドに返ってくるか見る
+// 作ったobjとキャッシュは一時フォルダーに置く
+#include "Tests/Common/Test.h"
+#include "Tests/ObjLoader/TestObj.h"
+#include "MeshManager/Mesh/MeshLoader.h"
+#include "Utils/AsyncLoader/AsyncLoader.h"
+#include "Engine/ErrorCheck/ErrorCheck.h"
+#include <vector>
+#include <string>
+#include <fstream>
+#include <filesystem>
+#include <unordered_map>
+#include <algorithm>
+#include <thread>
+
+namespace {
+	using Loader = AsyncLoader<std::shared_ptr<MeshLoader::LoadData>>;
+
+	constexpr uint32_t kModelNum = 50;
+	constexpr uint32_t kLoadThreadNum = 2;
+
+	void WriteFile(const std::filesystem::path& path, const std::string& text) {
+		std::ofstream file(path, std::ios::binary);
+		file << text;
+	}
+
+	struct Models {
+		std::vector<std::string> fileNames;
+		std::string missingObj;
+		std::string malformedObj;
+		std::string missingMtl;
+	};
+
+	/// <summary>
+	/// 大きさの違う格子のobjと、壊れたものを書き出す
+	/// </summary>
+	Models WriteModels(const std::filesystem::path& directory) {
+		std::filesystem::remove_all(directory);
+		std::filesystem::create_directories(directory);
+		WriteFile(directory / "generated.mtl", "newmtl Body\nnewmtl Face\nmap_Kd face.png\n");
+
+		Models models;
+		Test::ObjSetting setting;
+		setting.mtlNames = { "Body", "Face" };
+		for (uint32_t i = 0; i < kModelNum; i++) {
+			setting.gridNum = 8 + i % 5 * 24;
+			setting.groupFaceNum = setting.gridNum * 4;
+			setting.hasNormal = i % 3 != 0;
+			const std::filesystem::path path = directory / ("model" + std::to_string(i) + ".obj");
+			WriteFile(path, Test::MakeObjText(setting));
+			models.fileNames.push_back(path.string());
+		}
+
+		models.missingObj = (directory / "missing.obj").string();
+		models.malformedObj = (directory / "malformed.obj").string();
+		WriteFile(models.malformedObj, "mtllib generated.mtl\nv 0 0 0\nv 1 0 0\nusemtl Body\nf 1 2 3\n");
+		models.missingMtl = (directory / "missingMtl.obj").string();
+		WriteFile(models.missingMtl, "mtllib missing.mtl\nv 0 0 0\nv 1 0 0\nv 0 1 0\nusemtl Body\nf 1 2 3\n");
+		return models;
+	}
+
+	/// <summary>
+	/// メインスレッドでフレームを回しながら、ワーカースレッドで全て読み込む
+	/// </summary>
+	std::unordered_map<std::string, std::shared_ptr<MeshLoader::LoadData>> LoadWhileTicking(const std::vector<std::string>& fileNames, const char* name) {
+		std::unordered_map<std::string, std::shared_ptr<MeshLoader::LoadData>> results;
+		Loader loader(&MeshLoader::LoadCpuData, kLoadThreadNum);
+		for (const auto& fileName : fileNames) {
+			loader.Request(fileName);
+		}
+
+		const Test::Stopwatch total;
+		uint32_t frameNum = 0;
+		double maxFrameTime = 0.0;
+		while (results.size() < fileNames.size()) {
+			// 1フレームの間にメインスレッドがするのは受け取りだけ(読み込みを待たない)
+			const Test::Stopwatch frame;
+			for (auto& job : loader.TakeLoaded()) {
+				results[job->GetKey()] = std::move(job->GetResult());
+			}
+			maxFrameTime = std::max(maxFrameTime, frame.GetMilliSeconds());
+			frameNum++;
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		std::printf("%-6s : %zu models in %.1f ms, %u frames, max frame %.3f ms\n",
+			name, fileNames.size(), total.GetMilliSeconds(), frameNum, maxFrameTime
+		);
+		// ワーカースレッドに1フレーム分を超えて止められていない
+		TEST_CHECK(maxFrameTime < 16.0);
+		TEST_CHECK(1 < frameNum);
+		return results;
+	}
+
+	void TestLoad() {
+		const std::filesystem::path directory = std::filesystem::temp_directory_path() / "Engine2MeshLoaderTest";
+		const Models models = WriteModels(directory);
+
+		std::vector<std::string> fileNames = models.fileNames;
+		fileNames.insert(fileNames.end(), { models.missingObj, models.malformedObj, models.missingMtl });
+
+		// 1回目はobjから作ってキャッシュを書き出し、2回目はキャッシュから読む
+		for (const char* name : { "obj", "cache" }) {
+			const auto results = LoadWhileTicking(fileNames, name);
+
+			bool isOk = true;
+			for (const auto& fileName : models.fileNames) {
+				const auto& data = results.at(fileName);
+				isOk &= data && data->isSucceeded && data->errorTexts.empty();
+				isOk &= data->meshCache.GetSubmeshes().size() == 2 && data->materials.size() == 2;
+				isOk &= !data->bvh.IsEmpty() && data->uvDensities.size() == 2;
+			}
+			TEST_CHECK(isOk);
+
+			// 読めなかったものは失敗とその理由を返す
+			const auto& missingObj = results.at(models.missingObj);
+			TEST_CHECK(!missingObj->isSucceeded && missingObj->errorTexts.size() == 1);
+			const auto& malformedObj = results.at(models.malformedObj);
+			TEST_CHECK(!malformedObj->isSucceeded && malformedObj->errorTexts.size() == 1);
+			if (!malformedObj->errorTexts.empty()) {
+				TEST_CHECK(malformedObj->errorTexts.front().find("Index out of range") != std::string::npos);
+			}
+			// mtlが無いだけなら形状は読み込めて、エラーも返す
+			const auto& missingMtl = results.at(models.missingMtl);
+			TEST_CHECK(missingMtl->isSucceeded && missingMtl->errorTexts.size() == 1);
+			TEST_CHECK(missingMtl->materials.empty());
+		}
+		TEST_CHECK(std::filesystem::exists(MeshCache::GetCacheFileName(models.fileNames.front())));
+
+		// ワーカースレッドからはエラーウィンドウを出していない
+		TEST_CHECK(!ErrorCheck::GetInstance()->GetError());
+
+		std::filesystem::remove_all(directory);
+	}
+}
+
+int main() {
+	TestLoad();
+
+	return Test::Result("MeshLoaderTest");
+}
@@ -0,0 +1,148 @@
+// 頂点キャッシュ、オーバードロー、頂点フェッチの並び替え(user-010)のテスト
+// リポジトリの一番上で動かす(ctestはそこで動かす)
+#include "Tests/Common/Test.h"
+#include "Tests/MeshOptimizer/TestMesh.h"
+#include "Tests/ObjLoader/TestObj.h"
+#include "Utils/MeshOptimizer/MeshOptimizer.h"
+#include "Utils/MeshOptimizer/Meshlet.h"
+#include "Drawers/Model/MeshCache/MeshCache.h"
+#include <array>
+#include <vector>
+#include <random>
+#include <algorithm>
+
+namespace {
+	using Test::Mesh;
+
+	/// <summary>
+	/// 三角形を頂点座標の組にして、巻き順を保ったまま一番小さい座標から始まるように回して並べたもの
+	/// (頂点を並び替えても形が同じなら同じになる)
+	/// </summary>
+	std::vector<std::array<std::array<float, 3>, 3>> SortTrianglePositions(const Mesh& mesh) {
+		std::vector<std::array<std::array<float, 3>, 3>> triangles;
+		for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+			std::array<std::array<float, 3>, 3> triangle;
+			for (size_t j = 0; j < 3; j++) {
+				const Vector3& pos = mesh.positions[mesh.indices[i + j]];
+				triangle[j] = { pos.x, pos.y, pos.z };
+			}
+			std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+			triangles.push_back(triangle);
+		}
+		std::sort(triangles.begin(), triangles.end());
+		return triangles;
+	}
+
+	void TestAnalyze() {
+		// 1つの三角形は3回、同じ三角形を続けてもキャッシュに残っているので増えない
+		const std::vector<uint32_t> indices = { 0, 1, 2, 2, 1, 0 };
+		const VertexCacheStatistics statistics = AnalyzeVertexCache(indices, 3);
+		TEST_CHECK(statistics.transformedNum == 3);
+		TEST_CHECK(statistics.acmr == 1.5f);
+		TEST_CHECK(statistics.atvr == 1.0f);
+
+		// キャッシュより遠くで使い直すと読み直す
+		std::vector<uint32_t> farIndices = { 0, 1, 2 };
+		for (uint32_t i = 3; i < 30; i += 3) {
+			farIndices.insert(farIndices.end(), { i, i + 1, i + 2 });
+		}
+		farIndices.insert(farIndices.end(), { 0, 1, 2 });
+		TEST_CHECK(AnalyzeVertexCache(farIndices, 30, 16).transformedNum == 33);
+		TEST_CHECK(AnalyzeVertexCache(farIndices, 30, 32).transformedNum == 30);
+	}
+
+	/// <summary>
+	/// MeshLoader::CreateMeshCache()と同じ順番で並び替え、三角形と形が変わらず、キャッシュの効率が良くなるか調べる
+	/// </summary>
+	void CheckOptimize(const Mesh& source, const char* name) {
+		Mesh mesh = source;
+		const VertexCacheStatistics sourceStatistics = AnalyzeVertexCache(mesh.indices, mesh.positions.size());
+
+		// 並び替えるだけで、三角形の集合も巻き順も変わらない
+		OptimizeVertexCache(mesh.indices, mesh.positions.size());
+		const VertexCacheStatistics cacheStatistics = AnalyzeVertexCache(mesh.indices, mesh.positions.size());
+		TEST_CHECK(Test::SortTriangles(mesh.indices) == Test::SortTriangles(source.indices));
+
+		OptimizeOverdraw(mesh.indices, mesh.positions);
+		const VertexCacheStatistics overdrawStatistics = AnalyzeVertexCache(mesh.indices, mesh.positions.size());
+		TEST_CHECK(Test::SortTriangles(mesh.indices) == Test::SortTriangles(source.indices));
+
+		// メッシュレットの後に頂点を使う順に並べ替えても形は同じ
+		BuildMeshlets(mesh.indices, mesh.positions, 64, 124);
+		RemapVertices(mesh.positions, OptimizeVertexFetch(mesh.indices, mesh.positions.size()));
+		const VertexCacheStatistics fetchStatistics = AnalyzeVertexCache(mesh.indices, mesh.positions.size());
+		TEST_CHECK(SortTrianglePositions(mesh) == SortTrianglePositions(source));
+		// 頂点は最初に使われた順に並んでいる
+		uint32_t nextVertex = 0;
+		bool isFetchOrder = true;
+		for (uint32_t index : mesh.indices) {
+			isFetchOrder &= index <= nextVertex;
+			nextVertex = std::max(nextVertex, index + 1);
+		}
+		TEST_CHECK(isFetchOrder);
+
+		// ACMRは下がり、オーバードローのための並び替えはほとんど悪くしない
+		// (許すのはクラスタごとに5%までだが、各区切りの最後の小さいクラスタは超えることがあるので10%で見る)
+		TEST_CHECK(cacheStatistics.acmr < sourceStatistics.acmr);
+		TEST_CHECK(overdrawStatistics.acmr <= cacheStatistics.acmr * 1.1f);
+		TEST_CHECK(fetchStatistics.transformedNum <= overdrawStatistics.transformedNum * 11 / 10);
+		TEST_CHECK(fetchStatistics.acmr < sourceStatistics.acmr);
+		std::printf("%-28s : triangle %6zu, acmr %.3f -> %.3f (overdraw %.3f, meshlet %.3f), atvr %.3f -> %.3f\n",
+			name, source.indices.size() / 3, sourceStatistics.acmr, cacheStatistics.acmr, overdrawStatistics.acmr, fetchStatistics.acmr,
+			sourceStatistics.atvr, fetchStatistics.atvr
+		);
+	}
+
+	void TestOptimize() {
+		for (const char* fileName : { "Resources/Ball.obj", "Resources/skydome/skydome.obj" }) {
+			ObjLoader loader;
+			TEST_CHECK(loader.Load(fileName));
+			for (const Mesh& mesh : Test::MakeObjMeshes(loader)) {
+				CheckOptimize(mesh, fileName);
+			}
+		}
+
+		// 三角形の順番がばらばらなもの
+		Mesh shuffled = Test::MakeSphere(64, 128);
+		std::vector<std::array<uint32_t, 3>> triangles;
+		for (size_t i = 0; i < shuffled.indices.size(); i += 3) {
+			triangles.push_back({ shuffled.indices[i], shuffled.indices[i + 1], shuffled.indices[i + 2] });
+		}
+		std::shuffle(triangles.begin(), triangles.end(), std::mt19937(3));
+		shuffled.indices.clear();
+		for (const auto& triangle : triangles) {
+			shuffled.indices.insert(shuffled.indices.end(), triangle.begin(), triangle.end());
+		}
+		CheckOptimize(shuffled, "shuffled sphere");
+	}
+
+	void TestMeshCache() {
+		// キャッシュに書いた効率は読み直しても同じ
+		const std::vector<Vector3> positions = { Vector3(0.0f, 0.0f, 0.0f), Vector3(1.0f, 0.0f, 0.0f), Vector3(0.0f, 1.0f, 0.0f) };
+		const std::vector<uint32_t> indices = { 0, 1, 2 };
+		MeshCache::SubmeshSource source;
+		source.name = "Material";
+		source.vertices = std::as_bytes(std::span<const Vector3>(positions));
+		source.vertexNum = static_cast<uint32_t>(positions.size());
+		source.indices = indices;
+		source.sourceVertexCache = { 6, 6.0f, 2.0f };
+		source.vertexCache = AnalyzeVertexCache(indices, positions.size());
+
+		MeshCache meshCache;
+		TEST_CHECK(meshCache.Create("Resources/Cube.obj", sizeof(Vector3), std::span<const MeshCache::SubmeshSource>(&source, 1), AABB(), Sphere(), {}));
+		TEST_CHECK(meshCache.GetSubmeshes().size() == 1);
+		if (meshCache.GetSubmeshes().size() == 1) {
+			const MeshCache::Submesh& submesh = meshCache.GetSubmeshes().front();
+			TEST_CHECK(submesh.sourceVertexCache.transformedNum == 6 && submesh.sourceVertexCache.acmr == 6.0f && submesh.sourceVertexCache.atvr == 2.0f);
+			TEST_CHECK(submesh.vertexCache.transformedNum == 3 && submesh.vertexCache.acmr == 3.0f && submesh.vertexCache.atvr == 1.0f);
+		}
+	}
+}
+
+int main() {
+	TestAnalyze();
+	TestOptimize();
+	TestMeshCache();
+
+	return Test::Result("MeshOptimizerTest");
+}
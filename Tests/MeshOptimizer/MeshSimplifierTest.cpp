@@ -0,0 +1,115 @@
+// LOD(user-015)のテスト
+// リポジトリの一番上で動かす(ctestはそこで動かす)
+#include "Tests/Common/Test.h"
+#include "Tests/MeshOptimizer/TestMesh.h"
+#include "Tests/ObjLoader/TestObj.h"
+#include "Utils/MeshOptimizer/MeshSimplifier.h"
+#include <vector>
+
+namespace {
+	using Test::Mesh;
+
+	void TestSimplify() {
+		// 平面の内側は誤差0で消せ、縁は動かないので面積が変わらない
+		const Mesh grid = Test::MakeGrid(32);
+		std::vector<uint32_t> gridIndices = grid.indices;
+		const float gridError = SimplifyMesh(gridIndices, grid.positions, 0, 1.0e-4f);
+		TEST_CHECK(Test::IsValidTriangleList(grid, gridIndices));
+		TEST_CHECK(gridIndices.size() * 4 < grid.indices.size());
+		TEST_CHECK(gridError <= 1.0e-4f);
+		TEST_CHECK(std::abs(Test::CalcArea(grid, gridIndices) - Test::CalcArea(grid, grid.indices)) <= 1.0e-3f);
+
+		// 球は目標の数まで減らし、誤差が大きくなるほど粗くなる
+		const Mesh sphere = Test::MakeSphere(32, 64);
+		std::vector<float> lodErrors = { 0.0f };
+		std::vector<uint32_t> lodIndices = sphere.indices;
+		for (size_t lod = 1; lod < 4; lod++) {
+			const size_t targetIndexNum = lodIndices.size() / 4 / 3 * 3;
+			const float error = SimplifyMesh(lodIndices, sphere.positions, targetIndexNum, 1.0f);
+			TEST_CHECK(Test::IsValidTriangleList(sphere, lodIndices));
+			TEST_CHECK(lodIndices.size() <= targetIndexNum);
+			TEST_CHECK(lodErrors.back() <= error && error <= 1.0f);
+			lodErrors.push_back(error);
+		}
+
+		// 許容する誤差を超える縮約はしない
+		std::vector<uint32_t> limitedIndices = sphere.indices;
+		TEST_CHECK(SimplifyMesh(limitedIndices, sphere.positions, 0, 1.0e-3f) <= 1.0e-3f);
+		TEST_CHECK(Test::IsValidTriangleList(sphere, limitedIndices));
+		TEST_CHECK(0 < limitedIndices.size() && limitedIndices.size() < sphere.indices.size());
+
+		// 画面上の誤差が閾値に収まる一番粗いLODを選ぶ
+		TEST_CHECK(SelectLod(lodErrors, 0.0f) == lodErrors.size() - 1);
+		TEST_CHECK(SelectLod(lodErrors, 1.0e9f) == 0);
+		const float pixelPerUnit = 0.5f / lodErrors[1];
+		const uint32_t lod = SelectLod(lodErrors, pixelPerUnit);
+		TEST_CHECK(1 <= lod && lodErrors[lod] * pixelPerUnit <= 1.0f);
+		TEST_CHECK(lod + 1 == lodErrors.size() || 1.0f < lodErrors[lod + 1] * pixelPerUnit);
+	}
+
+	/// <summary>
+	/// MeshLoader::CreateMeshCache()と同じように、誤差の上限を境界の半径の5%にして三角形を半分ずつにしたLODを作る
+	/// </summary>
+	void CheckLodChain(const Mesh& mesh, const char* name) {
+		Vector3 minPos = mesh.positions.front();
+		Vector3 maxPos = mesh.positions.front();
+		for (const Vector3& pos : mesh.positions) {
+			minPos = Vector3(std::min(minPos.x, pos.x), std::min(minPos.y, pos.y), std::min(minPos.z, pos.z));
+			maxPos = Vector3(std::max(maxPos.x, pos.x), std::max(maxPos.y, pos.y), std::max(maxPos.z, pos.z));
+		}
+		const float maxError = (maxPos - minPos).Length() * 0.5f * 0.05f;
+		const float area = Test::CalcArea(mesh, mesh.indices);
+
+		std::printf("%-30s : triangle %zu", name, mesh.indices.size() / 3);
+		size_t prevIndexNum = mesh.indices.size();
+		float prevError = 0.0f;
+		for (uint32_t level = 1; level < 4; level++) {
+			std::vector<uint32_t> lodIndices = mesh.indices;
+			const size_t targetIndexNum = (lodIndices.size() >> level) / 3 * 3;
+			const float error = SimplifyMesh(lodIndices, mesh.positions, targetIndexNum, maxError);
+
+			// 壊れた三角形を作らず、誤差の上限を守り、目標まで減らせなかったのは上限に当たった時だけ
+			TEST_CHECK(Test::IsValidTriangleList(mesh, lodIndices));
+			TEST_CHECK(0 < lodIndices.size() && lodIndices.size() <= prevIndexNum);
+			TEST_CHECK(prevError <= error && error <= maxError);
+			TEST_CHECK(lodIndices.size() <= targetIndexNum || maxError * 0.5f <= error);
+			// 誤差が半径の5%までなら、表面積もほとんど変わらない
+			const float lodArea = Test::CalcArea(mesh, lodIndices);
+			TEST_CHECK(std::abs(lodArea - area) <= area * 0.1f);
+			std::printf(" -> %zu (error %.4f, area %+.2f%%)", lodIndices.size() / 3, error, (lodArea - area) * 100.0f / area);
+
+			prevIndexNum = lodIndices.size();
+			prevError = error;
+		}
+		std::printf("\n");
+	}
+
+	void TestObjFiles() {
+		// 同梱のobjをObjLoaderで読み込んだもの(継ぎ目で分かれた頂点を含む)
+		for (const char* fileName : { "Resources/Ball.obj", "Resources/skydome/skydome.obj" }) {
+			ObjLoader loader;
+			TEST_CHECK(loader.Load(fileName));
+			for (const Mesh& mesh : Test::MakeObjMeshes(loader)) {
+				CheckLodChain(mesh, fileName);
+			}
+		}
+
+		// 同梱のものは小さいので、複数のマテリアルに分かれた大きいものを作って読み込む
+		Test::ObjSetting setting;
+		setting.gridNum = 160;
+		setting.mtlNames = { "Body", "Face", "Hair" };
+		setting.groupFaceNum = 8000;
+		ObjLoader loader;
+		TEST_CHECK(loader.Parse(Test::MakeObjText(setting)));
+		for (const Mesh& mesh : Test::MakeObjMeshes(loader)) {
+			CheckLodChain(mesh, "generated");
+		}
+	}
+}
+
+int main() {
+	TestSimplify();
+	TestObjFiles();
+
+	return Test::Result("MeshSimplifierTest");
+}
@@ -0,0 +1,69 @@
+// メッシュレット(user-016)のテスト
+#include "Tests/Common/Test.h"
+#include "Tests/MeshOptimizer/TestMesh.h"
+#include "Utils/Math/Mat4x4.h"
+#include "Utils/Math/Frustum.h"
+#include "Utils/MeshOptimizer/Meshlet.h"
+#include <vector>
+#include <memory>
+#include <unordered_set>
+
+namespace {
+	using Test::Mesh;
+
+	void TestMeshlets() {
+		const Mesh sphere = Test::MakeSphere(48, 96);
+		std::vector<uint32_t> indices = sphere.indices;
+		const std::vector<Meshlet> meshlets = BuildMeshlets(indices, sphere.positions, 64, 124);
+		TEST_CHECK(!meshlets.empty());
+
+		// 三角形は並び替えるだけで、増えも減りもしない
+		TEST_CHECK(Test::SortTriangles(indices) == Test::SortTriangles(sphere.indices));
+
+		// 上限を守り、インデックスの範囲が隙間なく並び、球が頂点を全て含む
+		uint32_t indexOffset = 0;
+		bool isOk = true;
+		for (const auto& meshlet : meshlets) {
+			isOk &= meshlet.indexOffset == indexOffset;
+			isOk &= 0 < meshlet.triangleNum && meshlet.triangleNum <= 124;
+			isOk &= 0 < meshlet.vertexNum && meshlet.vertexNum <= 64;
+
+			std::unordered_set<uint32_t> vertices;
+			for (uint32_t i = meshlet.indexOffset; i < meshlet.indexOffset + meshlet.triangleNum * 3; i++) {
+				vertices.insert(indices[i]);
+				isOk &= (sphere.positions[indices[i]] - meshlet.sphere.center).Length() <= meshlet.sphere.radius * 1.0001f + 1.0e-6f;
+			}
+			isOk &= vertices.size() == meshlet.vertexNum;
+			indexOffset += meshlet.triangleNum * 3;
+		}
+		TEST_CHECK(isOk);
+		TEST_CHECK(indexOffset == indices.size());
+
+		// 裏面で消したメッシュレットは、全ての面がカメラに背を向けている
+		const Vector3 cameraPos(0.3f, 0.5f, -4.0f);
+		const Mat4x4 view = VertMakeMatrixInverseAffin(VertMakeMatrixTranslate(cameraPos));
+		const Frustum frustum(VertMakeMatrixPerspectiveFov(1.2f, 1.0f, 0.1f, 100.0f) * view);
+		std::unique_ptr<bool[]> isVisible = std::make_unique<bool[]>(meshlets.size());
+		const uint32_t visibleNum = CullMeshlets(meshlets, frustum, cameraPos, true, std::span<bool>(isVisible.get(), meshlets.size()));
+		bool isBackFace = true;
+		for (size_t i = 0; i < meshlets.size(); i++) {
+			if (isVisible[i] || !frustum.IsVisible(meshlets[i].sphere)) {
+				continue;
+			}
+			for (uint32_t j = meshlets[i].indexOffset; j < meshlets[i].indexOffset + meshlets[i].triangleNum * 3; j += 3) {
+				const Vector3& p0 = sphere.positions[indices[j]];
+				const Vector3 normal = CalcFaceNormal(p0, sphere.positions[indices[j + 1]], sphere.positions[indices[j + 2]]);
+				isBackFace &= -1.0e-5f <= normal.Dot(p0 - cameraPos);
+			}
+		}
+		TEST_CHECK(isBackFace);
+		// 球の半分くらいは裏を向いている
+		TEST_CHECK(0 < visibleNum && visibleNum < meshlets.size() * 3 / 4);
+	}
+}
+
+int main() {
+	TestMeshlets();
+
+	return Test::Result("MeshletTest");
+}
@@ -0,0 +1,54 @@
+// 法線の生成(user-017)のテスト
+#include "Tests/Common/Test.h"
+#include "Tests/MeshOptimizer/TestMesh.h"
+#include <vector>
+#include <cstring>
+
+namespace {
+	using Test::Mesh;
+
+	void TestNormals() {
+		const Mesh sphere = Test::MakeSphere(32, 64);
+
+		// スムーズなら球の中心から外向き、フラットなら面の法線
+		const std::vector<Vector3> smoothNormals = GenerateNormals(sphere.positions, sphere.indices, std::numbers::pi_v<float> / 3.0f);
+		const std::vector<Vector3> flatNormals = GenerateNormals(sphere.positions, sphere.indices, 0.0f);
+		TEST_CHECK(smoothNormals.size() == sphere.indices.size());
+		TEST_CHECK(flatNormals.size() == sphere.indices.size());
+		if (smoothNormals.size() != sphere.indices.size() || flatNormals.size() != sphere.indices.size()) {
+			return;
+		}
+
+		float minSmoothDot = 1.0f;
+		bool isFlat = true;
+		bool isSameVertexSame = true;
+		for (size_t i = 0; i < sphere.indices.size(); i++) {
+			const Vector3& pos = sphere.positions[sphere.indices[i]];
+			minSmoothDot = std::min(minSmoothDot, smoothNormals[i].Dot(pos.Normalize()));
+
+			const size_t first = i / 3 * 3;
+			const Vector3 faceNormal = CalcFaceNormal(sphere.positions[sphere.indices[first]], sphere.positions[sphere.indices[first + 1]], sphere.positions[sphere.indices[first + 2]]);
+			isFlat &= 0.99999f <= flatNormals[i].Dot(faceNormal);
+		}
+		// 同じ頂点を使う角はビットまで同じ法線になる
+		std::vector<int64_t> firstCorner(sphere.positions.size(), -1);
+		for (size_t i = 0; i < sphere.indices.size(); i++) {
+			int64_t& first = firstCorner[sphere.indices[i]];
+			if (first < 0) {
+				first = static_cast<int64_t>(i);
+			}
+			else {
+				isSameVertexSame &= std::memcmp(&smoothNormals[static_cast<size_t>(first)], &smoothNormals[i], sizeof(Vector3)) == 0;
+			}
+		}
+		TEST_CHECK(0.999f <= minSmoothDot);
+		TEST_CHECK(isFlat);
+		TEST_CHECK(isSameVertexSame);
+	}
+}
+
+int main() {
+	TestNormals();
+
+	return Test::Result("NormalGeneratorTest");
+}
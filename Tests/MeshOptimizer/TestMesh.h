@@ -0,0 +1,114 @@
+#pragma once
+#include "Utils/Math/Vector3.h"
+#include "Utils/MeshOptimizer/NormalGenerator.h"
+#include <array>
+#include <span>
+#include <vector>
+#include <numbers>
+#include <algorithm>
+
+/// <summary>
+/// メッシュのテストで使う形と確認
+/// </summary>
+namespace Test {
+	struct Mesh {
+		std::vector<Vector3> positions;
+		std::vector<uint32_t> indices;
+	};
+
+	/// <summary>
+	/// 半径1のUV球(経度方向は頂点を共有して継ぎ目を作らない。面は外側が表)
+	/// </summary>
+	inline Mesh MakeSphere(uint32_t latitudeNum, uint32_t longitudeNum) {
+		Mesh mesh;
+		mesh.positions.push_back(Vector3(0.0f, 1.0f, 0.0f));
+		for (uint32_t lat = 1; lat < latitudeNum; lat++) {
+			const float theta = std::numbers::pi_v<float> * static_cast<float>(lat) / static_cast<float>(latitudeNum);
+			for (uint32_t lon = 0; lon < longitudeNum; lon++) {
+				const float phi = 2.0f * std::numbers::pi_v<float> * static_cast<float>(lon) / static_cast<float>(longitudeNum);
+				mesh.positions.push_back(Vector3(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)));
+			}
+		}
+		const uint32_t bottom = static_cast<uint32_t>(mesh.positions.size());
+		mesh.positions.push_back(Vector3(0.0f, -1.0f, 0.0f));
+
+		const auto ring = [longitudeNum](uint32_t lat, uint32_t lon) {
+			return 1u + (lat - 1u) * longitudeNum + lon % longitudeNum;
+		};
+		const auto push = [&mesh](uint32_t i0, uint32_t i1, uint32_t i2) {
+			// 外から見て表になるように並べる
+			const Vector3 center = (mesh.positions[i0] + mesh.positions[i1] + mesh.positions[i2]) / 3.0f;
+			if (CalcFaceNormal(mesh.positions[i0], mesh.positions[i1], mesh.positions[i2]).Dot(center) < 0.0f) {
+				std::swap(i1, i2);
+			}
+			mesh.indices.insert(mesh.indices.end(), { i0, i1, i2 });
+		};
+		for (uint32_t lon = 0; lon < longitudeNum; lon++) {
+			push(0u, ring(1u, lon), ring(1u, lon + 1u));
+			push(bottom, ring(latitudeNum - 1u, lon), ring(latitudeNum - 1u, lon + 1u));
+			for (uint32_t lat = 1; lat + 1 < latitudeNum; lat++) {
+				push(ring(lat, lon), ring(lat + 1u, lon), ring(lat + 1u, lon + 1u));
+				push(ring(lat, lon), ring(lat + 1u, lon + 1u), ring(lat, lon + 1u));
+			}
+		}
+		return mesh;
+	}
+
+	/// <summary>
+	/// xz平面上の格子(縁以外の頂点は全て消せる)
+	/// </summary>
+	inline Mesh MakeGrid(uint32_t num) {
+		Mesh mesh;
+		for (uint32_t z = 0; z <= num; z++) {
+			for (uint32_t x = 0; x <= num; x++) {
+				mesh.positions.push_back(Vector3(static_cast<float>(x), 0.0f, static_cast<float>(z)));
+			}
+		}
+		for (uint32_t z = 0; z < num; z++) {
+			for (uint32_t x = 0; x < num; x++) {
+				const uint32_t i = z * (num + 1u) + x;
+				mesh.indices.insert(mesh.indices.end(), { i, i + num + 1u, i + num + 2u, i, i + num + 2u, i + 1u });
+			}
+		}
+		return mesh;
+	}
+
+	inline float CalcArea(const Mesh& mesh, std::span<const uint32_t> indices) {
+		float area = 0.0f;
+		for (size_t i = 0; i < indices.size(); i += 3) {
+			const Vector3& p0 = mesh.positions[indices[i]];
+			area += (mesh.positions[indices[i + 1]] - p0).Cross(mesh.positions[indices[i + 2]] - p0).Length() * 0.5f;
+		}
+		return area;
+	}
+
+	inline bool IsValidTriangleList(const Mesh& mesh, std::span<const uint32_t> indices) {
+		if (indices.size() % 3 != 0) {
+			return false;
+		}
+		for (size_t i = 0; i < indices.size(); i += 3) {
+			if (mesh.positions.size() <= std::max({ indices[i], indices[i + 1], indices[i + 2] })
+				|| indices[i] == indices[i + 1] || indices[i + 1] == indices[i + 2] || indices[i] == indices[i + 2]
+			) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// 三角形を一番小さいインデックスから始まるように回して並べたもの
+	/// (回すだけなので、並び替えても巻き順が変わっていなければ同じになる)
+	/// </summary>
+	inline std::vector<std::array<uint32_t, 3>> SortTriangles(std::span<const uint32_t> indices) {
+		std::vector<std::array<uint32_t, 3>> triangles;
+		triangles.reserve(indices.size() / 3);
+		for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+			std::array<uint32_t, 3> triangle = { indices[i], indices[i + 1], indices[i + 2] };
+			std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+			triangles.push_back(triangle);
+		}
+		std::sort(triangles.begin(), triangles.end());
+		return triangles;
+	}
+}
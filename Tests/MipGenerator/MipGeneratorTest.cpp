@@ -0,0 +1,128 @@
+// ミップマップ生成(user-022)のテスト
+#include "Tests/Common/Test.h"
+#include "Utils/MipGenerator/MipGenerator.h"
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <iterator>
+#include <span>
+
+namespace {
+	double SrgbToLinear(double value) {
+		return value <= 0.04045 ? value / 12.92 : std::pow((value + 0.055) / 1.055, 2.4);
+	}
+
+	double LinearToSrgb(double value) {
+		return value <= 0.0031308 ? value * 12.92 : 1.055 * std::pow(value, 1.0 / 2.4) - 0.055;
+	}
+
+	std::vector<uint8_t> MakeRandomImage(uint32_t width, uint32_t height, size_t rowPitch, uint32_t seed) {
+		std::mt19937 random(seed);
+		std::uniform_int_distribution<int> dist(0, 255);
+		std::vector<uint8_t> pixels(rowPitch * height);
+		for (auto& pixel : pixels) {
+			pixel = static_cast<uint8_t>(dist(random));
+		}
+		return pixels;
+	}
+
+	void TestSize() {
+		TEST_CHECK(MipGenerator::CalcMipNum(1, 1) == 1);
+		TEST_CHECK(MipGenerator::CalcMipNum(256, 256) == 9);
+		TEST_CHECK(MipGenerator::CalcMipNum(37, 13) == 6);
+
+		const std::vector<uint8_t> pixels = MakeRandomImage(37, 13, 37 * 4, 1);
+		const std::vector<MipGenerator::Mip> mips = MipGenerator::Generate(pixels, 37, 13, 37 * 4);
+		const uint32_t expectedSizes[][2] = { { 18, 6 }, { 9, 3 }, { 4, 1 }, { 2, 1 }, { 1, 1 } };
+		TEST_CHECK(mips.size() == std::size(expectedSizes));
+		for (size_t i = 0; i < std::min(mips.size(), std::size(expectedSizes)); i++) {
+			TEST_CHECK(mips[i].width == expectedSizes[i][0] && mips[i].height == expectedSizes[i][1]);
+			TEST_CHECK(mips[i].pixels.size() == static_cast<size_t>(mips[i].width) * mips[i].height * 4);
+		}
+
+		// 引数が不正なら空
+		TEST_CHECK(MipGenerator::Generate(pixels, 37, 13, 36 * 4).empty());
+		TEST_CHECK(MipGenerator::Generate(std::span<const uint8_t>(pixels).first(100), 37, 13, 37 * 4).empty());
+	}
+
+	void TestBox() {
+		// 2の累乗ならボックスフィルターは2x2の平均で、色は線形空間で平均する
+		constexpr uint32_t kSize = 64;
+		constexpr size_t kRowPitch = kSize * 4 + 16;
+		const std::vector<uint8_t> pixels = MakeRandomImage(kSize, kSize, kRowPitch, 2);
+		const std::vector<MipGenerator::Mip> mips = MipGenerator::Generate(pixels, kSize, kSize, kRowPitch, MipGenerator::Filter::Box);
+		TEST_CHECK(!mips.empty());
+		if (mips.empty()) {
+			return;
+		}
+
+		const MipGenerator::Mip& mip = mips[0];
+		int maxDifference = 0;
+		for (uint32_t y = 0; y < mip.height; y++) {
+			for (uint32_t x = 0; x < mip.width; x++) {
+				for (uint32_t channel = 0; channel < 4; channel++) {
+					double sum = 0.0;
+					for (uint32_t i = 0; i < 4; i++) {
+						const double value = pixels[(y * 2 + i / 2) * kRowPitch + (x * 2 + i % 2) * 4 + channel] / 255.0;
+						sum += channel == 3 ? value : SrgbToLinear(value);
+					}
+					const double average = channel == 3 ? sum / 4.0 : LinearToSrgb(sum / 4.0);
+					const int expected = static_cast<int>(std::round(average * 255.0));
+					maxDifference = std::max(maxDifference, std::abs(expected - static_cast<int>(mip.pixels[(y * mip.width + x) * 4 + channel])));
+				}
+			}
+		}
+		TEST_CHECK(maxDifference <= 1);
+	}
+
+	void TestFilter(MipGenerator::Filter filter) {
+		// スレッド数によらず同じ結果になる
+		const std::vector<uint8_t> pixels = MakeRandomImage(123, 77, 123 * 4, 3);
+		const std::vector<MipGenerator::Mip> singleThread = MipGenerator::Generate(pixels, 123, 77, 123 * 4, filter, 1);
+		const std::vector<MipGenerator::Mip> multiThread = MipGenerator::Generate(pixels, 123, 77, 123 * 4, filter, 4);
+		TEST_CHECK(singleThread.size() == multiThread.size());
+		for (size_t i = 0; i < std::min(singleThread.size(), multiThread.size()); i++) {
+			TEST_CHECK(singleThread[i].pixels == multiThread[i].pixels);
+		}
+
+		// 一色の画像は縮小しても同じ色
+		std::vector<uint8_t> solid(64 * 48 * 4);
+		for (size_t i = 0; i < solid.size(); i += 4) {
+			solid[i] = 200;
+			solid[i + 1] = 30;
+			solid[i + 2] = 128;
+			solid[i + 3] = 77;
+		}
+		bool isSolid = true;
+		for (const auto& mip : MipGenerator::Generate(solid, 64, 48, 64 * 4, filter)) {
+			for (size_t i = 0; i < mip.pixels.size(); i += 4) {
+				isSolid &= std::abs(mip.pixels[i] - 200) <= 1 && std::abs(mip.pixels[i + 1] - 30) <= 1
+					&& std::abs(mip.pixels[i + 2] - 128) <= 1 && std::abs(mip.pixels[i + 3] - 77) <= 1;
+			}
+		}
+		TEST_CHECK(isSolid);
+	}
+
+	void Bench(bool isQuick) {
+		constexpr uint32_t kSize = 2048;
+		const std::vector<uint8_t> pixels = MakeRandomImage(kSize, kSize, kSize * 4, 4);
+		const int count = isQuick ? 1 : 5;
+		for (auto [filter, name] : { std::make_pair(MipGenerator::Filter::Box, "Box"), std::make_pair(MipGenerator::Filter::Kaiser, "Kaiser") }) {
+			const Test::Stopwatch stopwatch;
+			for (int i = 0; i < count; i++) {
+				TEST_CHECK(MipGenerator::Generate(pixels, kSize, kSize, kSize * 4, filter).size() == 11);
+			}
+			std::printf("%-6s %ux%u : %.2f ms\n", name, kSize, kSize, stopwatch.GetMilliSeconds() / count);
+		}
+	}
+}
+
+int main(int argc, char** argv) {
+	TestSize();
+	TestBox();
+	TestFilter(MipGenerator::Filter::Box);
+	TestFilter(MipGenerator::Filter::Kaiser);
+	Bench(Test::IsQuick(argc, argv));
+
+	return Test::Result("MipGeneratorTest");
+}
@@ -0,0 +1,154 @@
+// objの並列解析(user-012)のテスト(1スレッドと同じ結果になるか、スレッド数ごとの速度)
+// --quick を付けるとベンチマークを小さくする
+#include "Tests/Common/Test.h"
+#include "Tests/ObjLoader/TestObj.h"
+#include "Drawers/Model/ObjLoader/ObjLoader.h"
+#include <array>
+#include <vector>
+#include <string>
+#include <numeric>
+#include <numbers>
+
+namespace {
+	/// <summary>
+	/// ObjLoader::Parse()が1スレッドに任せる最小のバイト数
+	/// </summary>
+	constexpr size_t kMinChunkSize = 1 << 20;
+
+	/// <summary>
+	/// ObjLoader::Parse()と同じ区切り方で、chunkNum個の区間の境目にborderLinesを順番に差し込む
+	/// (差し込んだ行が次の区間の最初の行になる)
+	/// </summary>
+	std::string InsertAtChunkBorders(const std::string& text, uint32_t chunkNum, const std::vector<std::string>& borderLines) {
+		const size_t totalSize = std::accumulate(borderLines.begin(), borderLines.end(), text.size(),
+			[](size_t size, const std::string& line) { return size + line.size(); }
+		);
+
+		std::string result;
+		result.reserve(totalSize);
+		size_t borderIndex = 0;
+		for (size_t start = 0; start < text.size();) {
+			// 区間は境目の位置を含む行までなので、その次の行の頭に差し込む
+			while (borderIndex < borderLines.size() && totalSize * (borderIndex + 1) / chunkNum < result.size()) {
+				result += borderLines[borderIndex++];
+			}
+			const size_t end = std::min(text.find('\n', start), text.size() - 1) + 1;
+			result.append(text, start, end - start);
+			start = end;
+		}
+		return result;
+	}
+
+	/// <summary>
+	/// 区間の最初の行(ObjLoader::Parse()と同じ区切り方)
+	/// </summary>
+	std::string_view GetChunkFirstLine(std::string_view text, uint32_t chunkNum, uint32_t index) {
+		size_t start = text.find('\n', text.size() * index / chunkNum) + 1;
+		return text.substr(start, text.find('\n', start) - start);
+	}
+
+	bool IsSameResult(const ObjLoader& left, const ObjLoader& right) {
+		auto isSameBits = [](const auto& l, const auto& r) {
+			return l.size() == r.size() && (l.empty() || std::memcmp(l.data(), r.data(), sizeof(l[0]) * l.size()) == 0);
+		};
+		return isSameBits(left.GetPositions(), right.GetPositions())
+			&& isSameBits(left.GetNormals(), right.GetNormals())
+			&& isSameBits(left.GetUvs(), right.GetUvs())
+			&& left.GetIndices() == right.GetIndices()
+			&& left.GetMtlFileNames() == right.GetMtlFileNames();
+	}
+
+	void TestParallel() {
+		// 区間の境目にusemtlやsが来る場合、面のまとまりの途中で切れる場合
+		const std::vector<std::string> borderKinds = {
+			"usemtl Border\n",
+			"s 1\n",
+			"s off\n",
+			"",
+			"usemtl Face\ns 1\n",
+			"mtllib border.mtl\n",
+			"s 2\nusemtl Body\n",
+		};
+
+		for (bool hasNormal : { false, true }) {
+			Test::ObjSetting setting;
+			setting.gridNum = 320;
+			setting.mtlNames = { "Body", "Face", "Hair" };
+			setting.groupFaceNum = 5000;
+			setting.smoothFaceNum = 3000;
+			setting.hasNormal = hasNormal;
+			setting.isNegativeIndex = !hasNormal;
+			setting.isInterleaved = true;
+			const std::string text = Test::MakeObjText(setting);
+
+			for (uint32_t threadNum : { 2u, 3u, 4u, 8u }) {
+				std::vector<std::string> borderLines;
+				for (uint32_t i = 0; i + 1 < threadNum; i++) {
+					borderLines.push_back(borderKinds[(i + threadNum) % borderKinds.size()]);
+				}
+				const std::string borderText = InsertAtChunkBorders(text, threadNum, borderLines);
+				TEST_CHECK(threadNum * kMinChunkSize <= borderText.size());
+
+				// 差し込んだ行がちょうど区間の最初に来ている
+				bool isOnBorder = true;
+				for (uint32_t i = 0; i + 1 < threadNum; i++) {
+					if (!borderLines[i].empty()) {
+						isOnBorder &= borderLines[i].starts_with(GetChunkFirstLine(borderText, threadNum, i + 1));
+					}
+				}
+				TEST_CHECK(isOnBorder);
+
+				ObjLoader serial;
+				ObjLoader parallel;
+				TEST_CHECK(serial.Parse(borderText, 1));
+				TEST_CHECK(parallel.Parse(borderText, threadNum));
+				if (!IsSameResult(serial, parallel)) {
+					std::fprintf(stderr, "hasNormal %d, %u threads : different from 1 thread\n", hasNormal, threadNum);
+				}
+				TEST_CHECK(IsSameResult(serial, parallel));
+
+				// 法線が無い面は、sの状態を引き継いで作った法線まで同じ
+				if (!hasNormal) {
+					serial.GenerateMissingNormals(std::numbers::pi_v<float> / 3.0f);
+					parallel.GenerateMissingNormals(std::numbers::pi_v<float> / 3.0f);
+					TEST_CHECK(IsSameResult(serial, parallel));
+				}
+			}
+		}
+	}
+
+	void Bench(bool isQuick) {
+		// 数百万の三角形を持つobjで、スレッド数ごとの解析時間を測る
+		Test::ObjSetting setting;
+		setting.gridNum = isQuick ? 320 : 1200;
+		setting.mtlNames = { "Body", "Face", "Fuku", "Hair" };
+		setting.groupFaceNum = 65536;
+		setting.smoothFaceNum = 40000;
+		setting.isInterleaved = true;
+		const std::string text = Test::MakeObjText(setting);
+
+		const int count = isQuick ? 1 : 5;
+		double serialTime = 0.0;
+		for (uint32_t threadNum : { 1u, 2u, 4u, 8u, 16u }) {
+			const Test::Stopwatch stopwatch;
+			for (int i = 0; i < count; i++) {
+				ObjLoader loader;
+				TEST_CHECK(loader.Parse(text, threadNum));
+			}
+			const double time = stopwatch.GetMilliSeconds() / count;
+			if (threadNum == 1) {
+				serialTime = time;
+			}
+			std::printf("%.1f MB, %u triangles, %2u threads : %.2f ms (x%.2f)\n",
+				static_cast<double>(text.size()) / 1e6, setting.gridNum * setting.gridNum * 2, threadNum, time, serialTime / time
+			);
+		}
+	}
+}
+
+int main(int argc, char** argv) {
+	TestParallel();
+	Bench(Test::IsQuick(argc, argv));
+
+	return Test::Result("ObjLoaderParallelTest");
+}
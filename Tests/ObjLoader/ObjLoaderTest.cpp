@@ -0,0 +1,337 @@
+// objの読み込み(user-008)のテスト(以前の読み込みと同じ頂点になるか、壊れたファイル、速度)
+// リポジトリの一番上で動かす(ctestはそこで動かす)。--quick を付けるとベンチマークを小さくする
+#include "Tests/Common/Test.h"
+#include "Tests/ObjLoader/TestObj.h"
+#include "Drawers/Model/ObjLoader/ObjLoader.h"
+#include <array>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+	struct Vertex {
+		Vector4 position;
+		Vector3 normal;
+		Vector2 uv;
+	};
+
+	using VertexMap = std::unordered_map<std::string, std::vector<Vertex>>;
+
+	/// <summary>
+	/// 書き換える前のModel::LoadObj()の解析部分(istringstreamで1行ずつ読む)
+	/// v/vt/vnの面だけに対応していて、面の角ごとに頂点を展開する
+	/// </summary>
+	bool LoadReference(std::istream& objFile, VertexMap& vertices) {
+		std::vector<Vector4> posDatas;
+		std::vector<Vector3> normalDatas;
+		std::vector<Vector2> uvDatas;
+		std::unordered_map<std::string, std::vector<ObjLoader::IndexData>> indexDatas;
+		std::unordered_map<std::string, std::vector<ObjLoader::IndexData>>::iterator indicesItr = indexDatas.end();
+
+		std::string lineBuf;
+		while (std::getline(objFile, lineBuf)) {
+			std::string identifier;
+			std::istringstream line(lineBuf);
+			line >> identifier;
+			if (identifier == "v") {
+				Vector4 buf;
+				line >> buf.vec.x >> buf.vec.y >> buf.vec.z;
+				buf.vec.x *= -1.0f;
+				buf.vec.w = 1.0f;
+				posDatas.push_back(buf);
+			}
+			else if (identifier == "vn") {
+				Vector3 buf;
+				line >> buf.x >> buf.y >> buf.z;
+				buf.x *= -1.0f;
+				normalDatas.push_back(buf);
+			}
+			else if (identifier == "vt") {
+				Vector2 buf;
+				line >> buf.x >> buf.y;
+				buf.y = 1.0f - buf.y;
+				uvDatas.push_back(buf);
+			}
+			else if (identifier == "f") {
+				std::string buf;
+				std::array<ObjLoader::IndexData, 3> indcoes;
+				auto idnexItr = indcoes.rbegin();
+				while (std::getline(line, buf, ' ')) {
+					std::string num[3];
+					int32_t count = 0;
+					if (std::any_of(buf.cbegin(), buf.cend(), [](char ch) { return '0' <= ch && ch <= '9'; })) {
+						for (auto& ch : buf) {
+							if (ch == '/') {
+								count++;
+							}
+							else {
+								num[count] += ch;
+							}
+						}
+					}
+					if (idnexItr == indcoes.rend()) {
+						return false;
+					}
+					if (count == 2) {
+						idnexItr->vertNum = static_cast<uint32_t>(std::stoi(num[0]) - 1);
+						idnexItr->uvNum = static_cast<uint32_t>(std::stoi(num[1]) - 1);
+						idnexItr->normalNum = static_cast<uint32_t>(std::stoi(num[2]) - 1);
+						idnexItr++;
+					}
+					else if (count == 1) {
+						idnexItr->vertNum = static_cast<uint32_t>(std::stoi(num[0]) - 1);
+						idnexItr->normalNum = static_cast<uint32_t>(std::stoi(num[1]) - 1);
+						idnexItr++;
+					}
+				}
+				if (indicesItr == indexDatas.end()) {
+					return false;
+				}
+				for (auto& i : indcoes) {
+					indicesItr->second.push_back(i);
+				}
+			}
+			else if (identifier == "usemtl") {
+				std::string useMtlName;
+				line >> useMtlName;
+				indexDatas.insert({ useMtlName, std::vector<ObjLoader::IndexData>() });
+				indicesItr = indexDatas.find(useMtlName);
+			}
+		}
+
+		vertices.clear();
+		for (const auto& [mtlName, corners] : indexDatas) {
+			auto& mtlVertices = vertices[mtlName];
+			for (const auto& corner : corners) {
+				Vertex& vertex = mtlVertices.emplace_back();
+				vertex.position = posDatas[corner.vertNum];
+				vertex.normal = normalDatas[corner.normalNum];
+				if (!uvDatas.empty()) {
+					vertex.uv = uvDatas[corner.uvNum];
+				}
+			}
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// ObjLoaderの結果を面の角ごとに展開する
+	/// </summary>
+	VertexMap Expand(const ObjLoader& loader) {
+		VertexMap vertices;
+		for (const auto& [mtlName, corners] : loader.GetIndices()) {
+			auto& mtlVertices = vertices[mtlName];
+			for (const auto& corner : corners) {
+				Vertex& vertex = mtlVertices.emplace_back();
+				vertex.position = loader.GetPositions()[corner.vertNum];
+				vertex.normal = loader.GetNormals()[corner.normalNum];
+				if (!loader.GetUvs().empty()) {
+					vertex.uv = loader.GetUvs()[corner.uvNum];
+				}
+			}
+		}
+		return vertices;
+	}
+
+	/// <summary>
+	/// マテリアルごとの頂点がビット単位で同じか
+	/// </summary>
+	bool IsSame(const VertexMap& left, const VertexMap& right) {
+		if (left.size() != right.size()) {
+			return false;
+		}
+		for (const auto& [mtlName, leftVertices] : left) {
+			auto itr = right.find(mtlName);
+			if (itr == right.end() || itr->second.size() != leftVertices.size()) {
+				return false;
+			}
+			for (size_t i = 0; i < leftVertices.size(); i++) {
+				const Vertex& l = leftVertices[i];
+				const Vertex& r = itr->second[i];
+				if (std::memcmp(&l.position, &r.position, sizeof(Vector4)) != 0
+					|| std::memcmp(&l.normal, &r.normal, sizeof(Vector3)) != 0
+					|| std::memcmp(&l.uv, &r.uv, sizeof(Vector2)) != 0
+				) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	size_t GetVertexNum(const VertexMap& vertices) {
+		size_t num = 0;
+		for (const auto& [mtlName, mtlVertices] : vertices) {
+			num += mtlVertices.size();
+		}
+		return num;
+	}
+
+	constexpr std::array<const char*, 3> kFileNames = {
+		"Resources/Ball.obj",
+		"Resources/Cube.obj",
+		"Resources/skydome/skydome.obj",
+	};
+
+	void TestParity() {
+		// 同梱のobjは以前の読み込みとビット単位で同じ頂点になる
+		for (const char* fileName : kFileNames) {
+			std::ifstream file(fileName);
+			VertexMap expected;
+			TEST_CHECK(LoadReference(file, expected));
+			ObjLoader loader;
+			TEST_CHECK(loader.Load(fileName));
+			const VertexMap vertices = Expand(loader);
+			TEST_CHECK(0 < GetVertexNum(vertices));
+			if (!IsSame(vertices, expected)) {
+				std::fprintf(stderr, "%s : different from the reference\n", fileName);
+			}
+			TEST_CHECK(IsSame(vertices, expected));
+			TEST_CHECK(loader.GetMtlFileNames().size() == 1);
+		}
+
+		// 複数のマテリアルを行き来するもの
+		Test::ObjSetting setting;
+		setting.gridNum = 48;
+		setting.mtlNames = { "Body", "Face", "Hair" };
+		setting.groupFaceNum = 100;
+		const std::string text = Test::MakeObjText(setting);
+		std::istringstream stream(text);
+		VertexMap expected;
+		TEST_CHECK(LoadReference(stream, expected));
+		ObjLoader loader;
+		TEST_CHECK(loader.Parse(text));
+		TEST_CHECK(loader.GetIndices().size() == setting.mtlNames.size());
+		TEST_CHECK(IsSame(Expand(loader), expected));
+
+		// 負のインデックスで書いても同じ
+		setting.isNegativeIndex = true;
+		ObjLoader negativeLoader;
+		TEST_CHECK(negativeLoader.Parse(Test::MakeObjText(setting)));
+		TEST_CHECK(IsSame(Expand(negativeLoader), expected));
+
+		// 改行がCRLFでも同じ
+		std::string crlfText;
+		for (char ch : text) {
+			if (ch == '\n') {
+				crlfText += '\r';
+			}
+			crlfText += ch;
+		}
+		ObjLoader crlfLoader;
+		TEST_CHECK(crlfLoader.Parse(crlfText));
+		TEST_CHECK(IsSame(Expand(crlfLoader), expected));
+	}
+
+	void TestMalformed() {
+		const std::string header =
+			"v 0 0 0\nv 1 0 0\nv 0 1 0\n"
+			"vt 0 0\n"
+			"vn 0 0 1\n"
+			"usemtl Material\n";
+
+		// 角が足りない面、多すぎる面、0や範囲外を指すインデックスは失敗し、何も残さない
+		const std::array<const char*, 9> malformedFaces = {
+			"f 1 2\n",
+			"f 1\n",
+			"f 1 2 3 1\n",
+			"f 0 1 2\n",
+			"f 1 2 4\n",
+			"f -4 -1 -2\n",
+			"f 1/2/1 2/1/1 3/1/1\n",
+			"f 1//1 2//2 3//1\n",
+			"f 1/-2 2/1 3/1\n",
+		};
+		for (const char* face : malformedFaces) {
+			ObjLoader loader;
+			const bool isSucceeded = loader.Parse(header + face);
+			if (isSucceeded) {
+				std::fprintf(stderr, "accepted : %s", face);
+			}
+			TEST_CHECK(!isSucceeded);
+			TEST_CHECK(loader.GetPositions().empty() && loader.GetIndices().empty());
+		}
+
+		// 正しいものは読める(負のインデックスは直前までの定義からの相対、正のものは後で定義されてもよい)
+		const std::array<const char*, 4> validFaces = {
+			"f 1 2 3\n",
+			"f -3 -2 -1\n",
+			"f 1/1/1 2/1/1 3/1/1\n",
+			"f 1//1 2//1 4//1\nv 1 1 0\n",
+		};
+		for (const char* face : validFaces) {
+			ObjLoader loader;
+			TEST_CHECK(loader.Parse(header + face));
+			const auto& indices = loader.GetIndices();
+			TEST_CHECK(indices.size() == 1 && indices.begin()->second.size() == 3);
+		}
+		ObjLoader relative;
+		ObjLoader absolute;
+		TEST_CHECK(relative.Parse(header + "f -3 -2 -1\n"));
+		TEST_CHECK(absolute.Parse(header + "f 1 2 3\n"));
+		TEST_CHECK(relative.GetIndices() == absolute.GetIndices());
+	}
+
+	void Bench(bool isQuick) {
+		const int count = isQuick ? 1 : 10;
+		auto measure = [count](auto func) {
+			const Test::Stopwatch stopwatch;
+			for (int i = 0; i < count; i++) {
+				func();
+			}
+			return stopwatch.GetMilliSeconds() / count;
+		};
+
+		for (const char* fileName : kFileNames) {
+			const double referenceTime = measure(
+				[fileName]() {
+					std::ifstream file(fileName);
+					VertexMap vertices;
+					TEST_CHECK(LoadReference(file, vertices));
+				}
+			);
+			const double time = measure(
+				[fileName]() {
+					ObjLoader loader;
+					TEST_CHECK(loader.Load(fileName));
+				}
+			);
+			std::printf("%-32s : reference %.3f ms, ObjLoader %.3f ms (x%.1f)\n", fileName, referenceTime, time, referenceTime / time);
+		}
+
+		// 同梱のものは小さいので、大きいモデルの代わりに作ったもので測る
+		Test::ObjSetting setting;
+		setting.gridNum = isQuick ? 128 : 512;
+		setting.mtlNames = { "Body", "Face", "Fuku", "Hair" };
+		setting.groupFaceNum = 4096;
+		const std::string text = Test::MakeObjText(setting);
+		const double referenceTime = measure(
+			[&text]() {
+				std::istringstream stream(text);
+				VertexMap vertices;
+				TEST_CHECK(LoadReference(stream, vertices));
+			}
+		);
+		const double time = measure(
+			[&text]() {
+				ObjLoader loader;
+				TEST_CHECK(loader.Parse(text, 1));
+			}
+		);
+		std::printf("generated %.1f MB, %u triangles : reference %.3f ms, ObjLoader %.3f ms (x%.1f)\n",
+			static_cast<double>(text.size()) / 1e6, setting.gridNum * setting.gridNum * 2,
+			referenceTime, time, referenceTime / time
+		);
+	}
+}
+
+int main(int argc, char** argv) {
+	TestParity();
+	TestMalformed();
+	Bench(Test::IsQuick(argc, argv));
+
+	return Test::Result("ObjLoaderTest");
+}
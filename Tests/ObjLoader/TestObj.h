@@ -0,0 +1,132 @@
+#pragma once
+#include "Tests/MeshOptimizer/TestMesh.h"
+#include "Drawers/Model/ObjLoader/ObjLoader.h"
+#include <cstdio>
+#include <cstdint>
+#include <cmath>
+#include <numbers>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// ObjLoaderのテストで使うobjテキストを作る、読み込んだobjをメッシュにする
+/// </summary>
+namespace Test {
+	struct ObjSetting {
+		/// <summary>
+		/// 格子の分割数(頂点は(gridNum+1)^2、三角形は2*gridNum^2)
+		/// </summary>
+		uint32_t gridNum = 16;
+		/// <summary>
+		/// groupFaceNum個の面ごとにusemtlで順番に切り替えるマテリアル(空ならusemtlを書かない)
+		/// </summary>
+		std::vector<std::string> mtlNames;
+		uint32_t groupFaceNum = 64;
+		/// <summary>
+		/// 0でなければsmoothFaceNum個の面ごとにs offとs 1を切り替える
+		/// </summary>
+		uint32_t smoothFaceNum = 0;
+		bool hasUv = true;
+		bool hasNormal = true;
+		/// <summary>
+		/// 面のインデックスをそれまでに書いた頂点からの相対(負)で書く
+		/// </summary>
+		bool isNegativeIndex = false;
+		/// <summary>
+		/// 格子の1列ごとに頂点と面を交互に書く(falseなら頂点を全て書いてから面を書く)
+		/// </summary>
+		bool isInterleaved = false;
+	};
+
+	/// <summary>
+	/// 波打った格子のobjテキスト
+	/// </summary>
+	inline std::string MakeObjText(const ObjSetting& setting) {
+		const uint32_t rowNum = setting.gridNum + 1u;
+		const uint32_t vertexNum = rowNum * rowNum;
+
+		std::string text = "# generated\nmtllib generated.mtl\n";
+		text.reserve(static_cast<size_t>(vertexNum) * 96 + static_cast<size_t>(setting.gridNum) * setting.gridNum * 2 * 48);
+		char buf[128];
+		uint32_t definedNum = 0;
+		auto pushRow = [&](uint32_t z) {
+			for (uint32_t x = 0; x < rowNum; x++) {
+				const float fx = static_cast<float>(x) / static_cast<float>(setting.gridNum);
+				const float fz = static_cast<float>(z) / static_cast<float>(setting.gridNum);
+				const float height = 0.1f * std::sin(fx * 12.0f) * std::cos(fz * 9.0f);
+				std::snprintf(buf, sizeof(buf), "v %.6f %.6f %.6f\n", fx * 2.0f - 1.0f, height, fz * 2.0f - 1.0f);
+				text += buf;
+				if (setting.hasUv) {
+					std::snprintf(buf, sizeof(buf), "vt %.6f %.6f\n", fx, fz);
+					text += buf;
+				}
+				if (setting.hasNormal) {
+					const float length = std::sqrt(1.0f + height * height);
+					std::snprintf(buf, sizeof(buf), "vn %.4f %.4f %.4f\n", -height / length, 1.0f / length, height * 0.5f / length);
+					text += buf;
+				}
+			}
+			definedNum += rowNum;
+		};
+
+		auto corner = [&setting, &definedNum](uint32_t index) {
+			const int64_t num = setting.isNegativeIndex ? static_cast<int64_t>(index) - definedNum : static_cast<int64_t>(index) + 1;
+			const std::string str = std::to_string(num);
+			if (setting.hasUv && setting.hasNormal) {
+				return str + "/" + str + "/" + str;
+			}
+			if (setting.hasUv) {
+				return str + "/" + str;
+			}
+			if (setting.hasNormal) {
+				return str + "//" + str;
+			}
+			return str;
+		};
+
+		uint32_t faceNum = 0;
+		auto pushFace = [&](uint32_t i0, uint32_t i1, uint32_t i2) {
+			if (!setting.mtlNames.empty() && faceNum % setting.groupFaceNum == 0) {
+				text += "usemtl " + setting.mtlNames[faceNum / setting.groupFaceNum % setting.mtlNames.size()] + "\n";
+			}
+			if (setting.smoothFaceNum != 0 && faceNum % setting.smoothFaceNum == 0) {
+				text += faceNum / setting.smoothFaceNum % 2 == 0 ? "s off\n" : "s 1\n";
+			}
+			text += "f " + corner(i0) + " " + corner(i1) + " " + corner(i2) + "\n";
+			faceNum++;
+		};
+		// 交互に書く時は、面の1列目に要る2列分だけ先に書く
+		const uint32_t firstRowNum = setting.isInterleaved ? 2u : rowNum;
+		for (uint32_t z = 0; z < firstRowNum; z++) {
+			pushRow(z);
+		}
+		for (uint32_t z = 0; z < setting.gridNum; z++) {
+			if (setting.isInterleaved && 0 < z) {
+				pushRow(z + 1u);
+			}
+			for (uint32_t x = 0; x < setting.gridNum; x++) {
+				const uint32_t i = z * rowNum + x;
+				pushFace(i, i + rowNum, i + rowNum + 1u);
+				pushFace(i, i + rowNum + 1u, i + 1u);
+			}
+		}
+		return text;
+	}
+
+	/// <summary>
+	/// 読み込んだobjをMeshLoader::CreateMeshCache()と同じように、マテリアルごとに頂点の重複を取り除いたメッシュにする
+	/// </summary>
+	inline std::vector<Mesh> MakeObjMeshes(ObjLoader& loader) {
+		loader.GenerateMissingNormals(std::numbers::pi_v<float> / 3.0f);
+		std::vector<Mesh> meshes;
+		std::vector<ObjLoader::IndexData> vertices;
+		for (const auto& [mtlName, corners] : loader.GetIndices()) {
+			Mesh& mesh = meshes.emplace_back();
+			ObjLoader::Deduplicate(corners, vertices, mesh.indices);
+			for (const auto& vertex : vertices) {
+				mesh.positions.push_back(loader.GetPositions()[vertex.vertNum].GetVector3());
+			}
+		}
+		return meshes;
+	}
+}
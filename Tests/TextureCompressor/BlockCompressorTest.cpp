@@ -0,0 +1,192 @@
+// ブロック圧縮(user-021)のテスト(圧縮して展開した画像のPSNR、不透明な画像が不透明のままか、速度)
+// --quick を付けるとベンチマークの回数を減らす
+#include "Tests/Common/Test.h"
+#include "Utils/TextureCompressor/BlockCompressor.h"
+#include <array>
+#include <vector>
+#include <random>
+#include <numbers>
+#include <algorithm>
+
+namespace {
+	constexpr std::array<BlockFormat, 3> kFormats = { BlockFormat::BC1, BlockFormat::BC3, BlockFormat::BC7 };
+
+	const char* GetFormatName(BlockFormat format) {
+		switch (format) {
+		case BlockFormat::BC1:
+			return "BC1";
+		case BlockFormat::BC3:
+			return "BC3";
+		default:
+			return "BC7";
+		}
+	}
+
+	/// <summary>
+	/// なめらかな模様に細かいノイズを乗せた、写真に近い画像
+	/// </summary>
+	/// <param name="isOpaque">アルファを全て255にするか(しないならアルファもなめらかに変える)</param>
+	std::vector<uint8_t> MakeImage(uint32_t width, uint32_t height, bool isOpaque, uint32_t seed) {
+		std::mt19937 random(seed);
+		std::normal_distribution<float> noise(0.0f, 4.0f);
+		std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 4);
+		for (uint32_t y = 0; y < height; y++) {
+			for (uint32_t x = 0; x < width; x++) {
+				const float u = static_cast<float>(x) / static_cast<float>(width) * 2.0f * std::numbers::pi_v<float>;
+				const float v = static_cast<float>(y) / static_cast<float>(height) * 2.0f * std::numbers::pi_v<float>;
+				const std::array<float, 4> values = {
+					128.0f + 100.0f * std::sin(u * 3.0f + v),
+					128.0f + 90.0f * std::cos(u * 2.0f - v * 5.0f),
+					128.0f + 80.0f * std::sin(u * 7.0f) * std::cos(v * 3.0f),
+					isOpaque ? 255.0f : 128.0f + 120.0f * std::sin(u + v * 2.0f)
+				};
+				for (size_t channel = 0; channel < 4; channel++) {
+					const float value = channel == 3 ? values[channel] : values[channel] + noise(random);
+					pixels[(static_cast<size_t>(y) * width + x) * 4 + channel] = static_cast<uint8_t>(std::clamp(std::round(value), 0.0f, 255.0f));
+				}
+			}
+		}
+		return pixels;
+	}
+
+	/// <summary>
+	/// 2つの画像のPSNR(firstChannelからchannelNum個のチャンネルで計算する)
+	/// </summary>
+	double CalcPsnr(std::span<const uint8_t> left, std::span<const uint8_t> right, size_t firstChannel, size_t channelNum) {
+		double squaredError = 0.0;
+		size_t count = 0;
+		for (size_t i = 0; i < left.size(); i += 4) {
+			for (size_t channel = firstChannel; channel < firstChannel + channelNum; channel++) {
+				const double difference = static_cast<double>(left[i + channel]) - static_cast<double>(right[i + channel]);
+				squaredError += difference * difference;
+				count++;
+			}
+		}
+		if (squaredError == 0.0) {
+			return 99.0;
+		}
+		return 10.0 * std::log10(255.0 * 255.0 / (squaredError / static_cast<double>(count)));
+	}
+
+	bool IsOpaque(std::span<const uint8_t> pixels) {
+		for (size_t i = 3; i < pixels.size(); i += 4) {
+			if (pixels[i] != 255) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	std::vector<uint8_t> RoundTrip(BlockFormat format, std::span<const uint8_t> pixels, uint32_t width, uint32_t height, uint32_t threadNum = 0) {
+		std::vector<uint8_t> blocks(CalcCompressedSize(format, width, height));
+		std::vector<uint8_t> decoded(static_cast<size_t>(width) * height * 4);
+		TEST_CHECK(CompressImage(format, pixels, width, height, static_cast<size_t>(width) * 4, blocks, threadNum));
+		TEST_CHECK(DecompressImage(format, blocks, width, height, decoded, static_cast<size_t>(width) * 4));
+		return decoded;
+	}
+
+	void TestQuality() {
+		constexpr uint32_t kWidth = 256;
+		constexpr uint32_t kHeight = 256;
+		const std::vector<uint8_t> opaque = MakeImage(kWidth, kHeight, true, 1);
+		const std::vector<uint8_t> transparent = MakeImage(kWidth, kHeight, false, 2);
+
+		// 形式ごとの最低限の画質(dB)
+		constexpr std::array<double, 3> kMinColorPsnr = { 31.0, 31.0, 33.0 };
+		constexpr std::array<double, 3> kMinAlphaPsnr = { 0.0, 44.0, 34.0 };
+		for (size_t i = 0; i < kFormats.size(); i++) {
+			const std::vector<uint8_t> opaqueDecoded = RoundTrip(kFormats[i], opaque, kWidth, kHeight);
+			const double colorPsnr = CalcPsnr(opaque, opaqueDecoded, 0, 3);
+			std::printf("%s : RGB %.2f dB", GetFormatName(kFormats[i]), colorPsnr);
+			TEST_CHECK(kMinColorPsnr[i] <= colorPsnr);
+			// 不透明な画像は不透明のまま
+			TEST_CHECK(IsOpaque(opaqueDecoded));
+
+			if (kFormats[i] != BlockFormat::BC1) {
+				const std::vector<uint8_t> transparentDecoded = RoundTrip(kFormats[i], transparent, kWidth, kHeight);
+				const double alphaPsnr = CalcPsnr(transparent, transparentDecoded, 3, 1);
+				std::printf(", A %.2f dB", alphaPsnr);
+				TEST_CHECK(kMinAlphaPsnr[i] <= alphaPsnr);
+			}
+			std::printf("\n");
+		}
+	}
+
+	void TestOpaqueBlocks() {
+		// どんな色の組み合わせでも、アルファが全て255のブロックは255に戻る
+		std::mt19937 random(3);
+		std::uniform_int_distribution<int> dist(0, 255);
+		std::array<uint8_t, kBlockPixelNum * 4> pixels{};
+		std::array<uint8_t, kBlockPixelNum * 4> decoded{};
+		std::array<uint8_t, 16> block{};
+		std::array<uint32_t, 3> badNum = {};
+		for (int n = 0; n < 20000; n++) {
+			// ランダムなブロックと、2色だけのブロックを交互に試す
+			const std::array<uint8_t, 3> colorA = { static_cast<uint8_t>(dist(random)), static_cast<uint8_t>(dist(random)), static_cast<uint8_t>(dist(random)) };
+			const std::array<uint8_t, 3> colorB = { static_cast<uint8_t>(dist(random)), static_cast<uint8_t>(dist(random)), static_cast<uint8_t>(dist(random)) };
+			for (size_t i = 0; i < kBlockPixelNum; i++) {
+				for (size_t channel = 0; channel < 3; channel++) {
+					pixels[i * 4 + channel] = n % 2 == 0 ? static_cast<uint8_t>(dist(random)) : (i % 3 == 0 ? colorA : colorB)[channel];
+				}
+				pixels[i * 4 + 3] = 255;
+			}
+
+			EncodeBC1Block(pixels, std::span<uint8_t, 8>(block.data(), 8));
+			DecodeBC1Block(std::span<const uint8_t, 8>(block.data(), 8), decoded);
+			badNum[0] += IsOpaque(decoded) ? 0 : 1;
+
+			EncodeBC3Block(pixels, block);
+			DecodeBC3Block(block, decoded);
+			badNum[1] += IsOpaque(decoded) ? 0 : 1;
+
+			EncodeBC7Block(pixels, block);
+			DecodeBC7Block(block, decoded);
+			badNum[2] += IsOpaque(decoded) ? 0 : 1;
+		}
+		TEST_CHECK(badNum[0] == 0);
+		TEST_CHECK(badNum[1] == 0);
+		TEST_CHECK(badNum[2] == 0);
+	}
+
+	void TestImage() {
+		// 4の倍数でない大きさは端のピクセルで埋め、スレッド数によらず同じ結果になる
+		constexpr uint32_t kWidth = 133;
+		constexpr uint32_t kHeight = 61;
+		const std::vector<uint8_t> pixels = MakeImage(kWidth, kHeight, false, 4);
+		for (BlockFormat format : kFormats) {
+			TEST_CHECK(CalcCompressedSize(format, kWidth, kHeight) == GetBlockSize(format) * 34 * 16);
+			const std::vector<uint8_t> singleThread = RoundTrip(format, pixels, kWidth, kHeight, 1);
+			const std::vector<uint8_t> multiThread = RoundTrip(format, pixels, kWidth, kHeight, 4);
+			TEST_CHECK(singleThread == multiThread);
+			TEST_CHECK(25.0 <= CalcPsnr(pixels, singleThread, 0, 3));
+
+			// 書き込み先が足りなければ失敗する
+			std::vector<uint8_t> blocks(CalcCompressedSize(format, kWidth, kHeight) - 1);
+			TEST_CHECK(!CompressImage(format, pixels, kWidth, kHeight, kWidth * 4, blocks));
+		}
+	}
+
+	void Bench(bool isQuick) {
+		constexpr uint32_t kSize = 1024;
+		const std::vector<uint8_t> pixels = MakeImage(kSize, kSize, false, 5);
+		const int count = isQuick ? 1 : 5;
+		for (BlockFormat format : kFormats) {
+			std::vector<uint8_t> blocks(CalcCompressedSize(format, kSize, kSize));
+			const Test::Stopwatch stopwatch;
+			for (int i = 0; i < count; i++) {
+				CompressImage(format, pixels, kSize, kSize, kSize * 4, blocks);
+			}
+			const double milliSeconds = stopwatch.GetMilliSeconds() / count;
+			std::printf("%s %ux%u : %.2f ms (%.2f MPixel/s)\n", GetFormatName(format), kSize, kSize, milliSeconds, static_cast<double>(kSize) * kSize / (milliSeconds * 1000.0));
+		}
+	}
+}
+
+int main(int argc, char** argv) {
+	TestQuality();
+	TestOpaqueBlocks();
+	TestImage();
+	Bench(Test::IsQuick(argc, argv));
+
+	return Test::Result("BlockCompressorTest");
+}
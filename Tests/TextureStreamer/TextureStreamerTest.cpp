@@ -0,0 +1,259 @@
+// テクスチャのストリーミング(user-020)のテスト
+// Model::RequestTextureMip()と同じ計算で要求したミップ、予算を超えた時に粗くする順番、フレームの中での順番
+// (Engine::FrameStart()のTextureManager::UpdateStreaming()でUpdate()し、その後の描画で要求する)
+#include "Tests/Common/Test.h"
+#include "TextureManager/TextureStreamer/TextureStreamer.h"
+#include "Utils/Math/Mat4x4.h"
+#include "Utils/Math/Bounds.h"
+#include <vector>
+#include <cmath>
+#include <functional>
+
+namespace {
+	constexpr float kFovY = 0.45f;
+	constexpr float kScreenHeight = 720.0f;
+
+	/// <summary>
+	/// 正方形のRGBA8テクスチャのミップごとのバイト数
+	/// </summary>
+	std::vector<uint64_t> MakeMipSizes(uint32_t size) {
+		std::vector<uint64_t> mipSizes;
+		for (uint32_t mipSize = size; 0u < mipSize; mipSize >>= 1) {
+			mipSizes.push_back(static_cast<uint64_t>(mipSize) * mipSize * 4u);
+		}
+		return mipSizes;
+	}
+
+	uint32_t Register(TextureStreamer& streamer, uint32_t size) {
+		const std::vector<uint64_t> mipSizes = MakeMipSizes(size);
+		return streamer.Register(size, size, mipSizes);
+	}
+
+	/// <summary>
+	/// 1フレーム進める(Update()してから、描画で要求する)
+	/// </summary>
+	/// <returns>Update()で置くミップを変えたテクスチャ</returns>
+	std::vector<TextureStreamer::MipChange> Tick(TextureStreamer& streamer, const std::function<void()>& draw = nullptr) {
+		const std::vector<TextureStreamer::MipChange> changes = streamer.Update();
+		if (draw) {
+			draw();
+		}
+		return changes;
+	}
+
+	bool IsSizeValid(const TextureStreamer& streamer, std::initializer_list<uint32_t> ids) {
+		// 置いているミップのバイト数の合計は、予算に数える分と最小のミップの分を足したもの
+		uint64_t residentSize = 0u;
+		for (uint32_t id : ids) {
+			residentSize += streamer.CalcResidentSize(id, streamer.GetResidentMip(id));
+		}
+		return streamer.GetResidentSize() + streamer.GetMinResidentSize() == residentSize && streamer.GetResidentSize() <= streamer.GetBudget();
+	}
+
+	/// <summary>
+	/// Model::RequestTextureMip()と同じ計算で要求するミップ
+	/// </summary>
+	uint32_t CalcRequestMip(const Mat4x4& worldMat, float textureSize, float uvDensity) {
+		// カメラは原点から+zを見る
+		const Mat4x4 viewProjectionMat = VertMakeMatrixPerspectiveFov(kFovY, 16.0f / 9.0f, 0.1f, 100.0f);
+		const Sphere localSphere = { Vector3(0.0f, 0.0f, 0.0f), 1.0f };
+		const float pixelPerUnit = TextureStreamer::CalcPixelPerLocalUnit(viewProjectionMat, localSphere, worldMat, kScreenHeight);
+		return TextureStreamer::CalcMip(TextureStreamer::CalcTexelPerPixel(textureSize, uvDensity, pixelPerUnit));
+	}
+
+	void TestCalcMip() {
+		TEST_CHECK(TextureStreamer::CalcMip(0.5f) == 0u);
+		TEST_CHECK(TextureStreamer::CalcMip(1.0f) == 0u);
+		TEST_CHECK(TextureStreamer::CalcMip(1.9f) == 0u);
+		TEST_CHECK(TextureStreamer::CalcMip(2.0f) == 1u);
+		TEST_CHECK(TextureStreamer::CalcMip(7.9f) == 2u);
+		TEST_CHECK(TextureStreamer::CalcMip(std::nanf("")) == 0u);
+		TEST_CHECK(TextureStreamer::CalcMip(1.0e30f) == 31u);
+	}
+
+	void TestRequestMip() {
+		// 半径1の球をz=10に置くと、一番近い所の奥行きは9
+		const Mat4x4 viewProjectionMat = VertMakeMatrixPerspectiveFov(kFovY, 16.0f / 9.0f, 0.1f, 100.0f);
+		const Sphere localSphere = { Vector3(0.0f, 0.0f, 0.0f), 1.0f };
+		const float scaleY = 1.0f / std::tan(kFovY * 0.5f);
+		const float pixelPerUnit = TextureStreamer::CalcPixelPerLocalUnit(viewProjectionMat, localSphere, HoriMakeMatrixTranslate(Vector3(0.0f, 0.0f, 10.0f)), kScreenHeight);
+		const float expected = scaleY * kScreenHeight * 0.5f / 9.0f;
+		TEST_CHECK(std::abs(pixelPerUnit - expected) < expected * 1.0e-4f);
+
+		// 2倍に拡大すると、奥行きは8になりローカル座標の1単位も2倍の大きさに見える
+		const float scaledPixelPerUnit = TextureStreamer::CalcPixelPerLocalUnit(viewProjectionMat, localSphere,
+			HoriMakeMatrixAffin(Vector3(2.0f, 2.0f, 2.0f), Vector3(0.0f, 0.0f, 0.0f), Vector3(0.0f, 0.0f, 10.0f)), kScreenHeight
+		);
+		const float scaledExpected = scaleY * kScreenHeight * 0.5f / 8.0f * 2.0f;
+		TEST_CHECK(std::abs(scaledPixelPerUnit - scaledExpected) < scaledExpected * 1.0e-4f);
+
+		// カメラに重なっていても無限大にならない
+		const float insidePixelPerUnit = TextureStreamer::CalcPixelPerLocalUnit(viewProjectionMat, localSphere, HoriMakeMatrixTranslate(Vector3(0.0f, 0.0f, 0.5f)), kScreenHeight);
+		TEST_CHECK(std::isfinite(insidePixelPerUnit) && expected < insidePixelPerUnit);
+
+		// 1024のテクスチャはz=10で約5.9テクセル/ピクセル(ミップ2)、z=100で約64テクセル/ピクセル(ミップ6)
+		TEST_CHECK(CalcRequestMip(HoriMakeMatrixTranslate(Vector3(0.0f, 0.0f, 10.0f)), 1024.0f, 1.0f) == 2u);
+		TEST_CHECK(CalcRequestMip(HoriMakeMatrixTranslate(Vector3(0.0f, 0.0f, 100.0f)), 1024.0f, 1.0f) == 6u);
+		// UVを繰り返すほど細かいミップが要る
+		TEST_CHECK(CalcRequestMip(HoriMakeMatrixTranslate(Vector3(0.0f, 0.0f, 10.0f)), 1024.0f, 4.0f) == 4u);
+
+		// 近づくほど細かくなる
+		uint32_t previousMip = 31u;
+		bool isOk = true;
+		for (float z = 100.0f; 2.0f < z; z *= 0.8f) {
+			const uint32_t mip = CalcRequestMip(HoriMakeMatrixTranslate(Vector3(0.0f, 0.0f, z)), 1024.0f, 1.0f);
+			isOk &= mip <= previousMip;
+			previousMip = mip;
+		}
+		TEST_CHECK(isOk && previousMip == 0u);
+
+		// 要求したミップに向けて1フレームに1段ずつ細かくなる(登録時は64以下のミップ4だけを置く)
+		TextureStreamer streamer;
+		const uint32_t id = Register(streamer, 1024);
+		TEST_CHECK(streamer.GetResidentMip(id) == 4u);
+		const uint32_t requestMip = CalcRequestMip(HoriMakeMatrixTranslate(Vector3(0.0f, 0.0f, 10.0f)), 1024.0f, 1.0f);
+		auto draw = [&]() { streamer.Request(id, requestMip); };
+		Tick(streamer, draw);
+		TEST_CHECK(streamer.GetResidentMip(id) == 4u);
+		Tick(streamer, draw);
+		TEST_CHECK(streamer.GetResidentMip(id) == 3u);
+		Tick(streamer, draw);
+		TEST_CHECK(streamer.GetResidentMip(id) == 2u);
+		Tick(streamer, draw);
+		TEST_CHECK(streamer.GetResidentMip(id) == 2u && streamer.GetDesiredMip(id) == 2u);
+		TEST_CHECK(IsSizeValid(streamer, { id }));
+	}
+
+	void TestFrameOrder() {
+		TextureStreamer streamer;
+		const uint32_t id = Register(streamer, 1024);
+		Tick(streamer);
+
+		// Update()の後の要求は、次のUpdate()で反映する
+		streamer.Request(id, 3u);
+		streamer.Request(id, 1u);
+		streamer.Request(id, 2u);
+		TEST_CHECK(streamer.GetDesiredMip(id) == 4u && streamer.GetResidentMip(id) == 4u);
+		auto changes = Tick(streamer);
+		// 同じフレームの要求は一番細かいものを使い、1段だけ細かくする
+		TEST_CHECK(streamer.GetDesiredMip(id) == 1u);
+		TEST_CHECK(changes.size() == 1u && changes[0].id == id && changes[0].residentMip == 3u);
+		TEST_CHECK(streamer.GetUploadSize() == streamer.CalcResidentSize(id, 3u));
+
+		// 要求が途切れても、しばらくは前の要求に向けて細かくし続ける
+		Tick(streamer);
+		Tick(streamer);
+		TEST_CHECK(streamer.GetResidentMip(id) == 1u);
+		changes = Tick(streamer);
+		TEST_CHECK(changes.empty() && streamer.GetUploadSize() == 0u);
+
+		// 最後の要求からkUnusedFrameNumフレームを過ぎると、最小のミップだけで良いことになる(予算内なら外さない)
+		for (uint32_t i = 3u; i < TextureStreamer::kUnusedFrameNum; i++) {
+			Tick(streamer);
+		}
+		TEST_CHECK(streamer.GetDesiredMip(id) == 1u);
+		Tick(streamer);
+		TEST_CHECK(streamer.GetDesiredMip(id) == 4u && streamer.GetResidentMip(id) == 1u);
+
+		// 転送の上限を超える時は、要求との差が大きいものを先にする
+		TextureStreamer limited;
+		limited.SetUploadLimit(1u);
+		const uint32_t nearId = Register(limited, 1024);
+		const uint32_t farId = Register(limited, 1024);
+		Tick(limited, [&]() {
+			limited.Request(farId, 3u);
+			limited.Request(nearId, 0u);
+		});
+		changes = Tick(limited);
+		TEST_CHECK(changes.size() == 1u && changes[0].id == nearId && changes[0].residentMip == 3u);
+		changes = Tick(limited);
+		TEST_CHECK(changes.size() == 1u && changes[0].id == nearId && changes[0].residentMip == 2u);
+		changes = Tick(limited);
+		TEST_CHECK(changes.size() == 1u && changes[0].id == nearId && changes[0].residentMip == 1u);
+		// 差も要求したフレームも同じなら番号の小さい方から
+		changes = Tick(limited);
+		TEST_CHECK(changes.size() == 1u && changes[0].id == nearId && changes[0].residentMip == 0u);
+		changes = Tick(limited);
+		TEST_CHECK(changes.size() == 1u && changes[0].id == farId && changes[0].residentMip == 3u);
+	}
+
+	void TestBudget() {
+		TextureStreamer streamer;
+		// 256のテクスチャは64のミップ2までを最初に置く
+		const uint32_t a = Register(streamer, 256);
+		const uint32_t b = Register(streamer, 256);
+		const uint32_t c = Register(streamer, 256);
+		TEST_CHECK(streamer.GetResidentMip(a) == 2u && streamer.GetResidentSize() == 0u);
+
+		for (int frame = 0; frame < 4; frame++) {
+			Tick(streamer, [&]() {
+				streamer.Request(a, 0u);
+				streamer.Request(b, 0u);
+				streamer.Request(c, 0u);
+			});
+		}
+		const uint64_t fullSize = streamer.CalcResidentSize(a, 0u) - streamer.CalcResidentSize(a, 2u);
+		TEST_CHECK(streamer.GetResidentSize() == fullSize * 3u);
+		TEST_CHECK(IsSizeValid(streamer, { a, b, c }));
+
+		// aは要求が途切れ(一番長く使われていない)、bは粗いミップを要求する
+		auto draw = [&]() {
+			streamer.Request(b, 2u);
+			streamer.Request(c, 0u);
+		};
+		for (int frame = 0; frame < 3; frame++) {
+			Tick(streamer, draw);
+		}
+
+		// 要求より細かいミップを持っているbを、aより先に要求まで粗くする
+		streamer.SetBudget(streamer.GetResidentSize() - 1u);
+		auto changes = Tick(streamer, draw);
+		TEST_CHECK(changes.size() == 1u && changes[0].id == b && changes[0].residentMip == 2u);
+		TEST_CHECK(streamer.GetResidentMip(a) == 0u && streamer.GetResidentMip(c) == 0u);
+		TEST_CHECK(IsSizeValid(streamer, { a, b, c }));
+
+		// それでも足りなければ、要求されているものから長く使われていないaを1段だけ粗くする
+		streamer.SetBudget(streamer.GetResidentSize() - 1u);
+		changes = Tick(streamer, draw);
+		TEST_CHECK(changes.size() == 1u && changes[0].id == a && changes[0].residentMip == 1u);
+		TEST_CHECK(streamer.GetResidentMip(c) == 0u);
+		TEST_CHECK(IsSizeValid(streamer, { a, b, c }));
+
+		// 入れ替えは1フレームに1回なので、予算を大きく下げると数フレームかけて最小のミップまで粗くする
+		streamer.SetBudget(0u);
+		for (int frame = 0; frame < 4; frame++) {
+			Tick(streamer, draw);
+		}
+		TEST_CHECK(streamer.GetResidentSize() == 0u);
+		TEST_CHECK(streamer.GetResidentMip(a) == 2u && streamer.GetResidentMip(b) == 2u && streamer.GetResidentMip(c) == 2u);
+
+		// 要求されていても予算を超えるなら細かくしない
+		streamer.SetBudget(fullSize - 1u);
+		for (int frame = 0; frame < 4; frame++) {
+			Tick(streamer, draw);
+			TEST_CHECK(IsSizeValid(streamer, { a, b, c }));
+		}
+		TEST_CHECK(streamer.GetResidentMip(c) == 1u);
+
+		// 予算が空けば要求に戻る(要求が途切れてからkUnusedFrameNumフレーム経っていないaも戻る)
+		streamer.SetBudget(fullSize * 2u);
+		Tick(streamer, draw);
+		TEST_CHECK(streamer.GetResidentMip(a) == 0u && streamer.GetResidentMip(b) == 2u && streamer.GetResidentMip(c) == 0u);
+		TEST_CHECK(IsSizeValid(streamer, { a, b, c }));
+
+		// 外すと最小のミップの分も減る
+		const uint64_t minResidentSize = streamer.GetMinResidentSize();
+		streamer.Unregister(c);
+		TEST_CHECK(streamer.GetResidentSize() == fullSize && streamer.GetTextureNum() == 2u);
+		TEST_CHECK(streamer.GetMinResidentSize() * 3u == minResidentSize * 2u);
+	}
+}
+
+int main() {
+	TestCalcMip();
+	TestRequestMip();
+	TestFrameOrder();
+	TestBudget();
+
+	return Test::Result("TextureStreamerTest");
+}
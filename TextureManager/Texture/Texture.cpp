@@ -2,9 +2,82 @@
 #include "Engine/ConvertString/ConvertString.h"
 #include "Engine/Engine.h"
 #include <cassert>
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <filesystem>
 #include "Engine/ErrorCheck/ErrorCheck.h"
+#include "TextureManager/TextureCache/TextureCache.h"
+#include "Utils/MipGenerator/MipGenerator.h"
+#include "Utils/ImageDecoder/ImageDecoder.h"
+
+namespace {
+	DXGI_FORMAT ToDxgiFormat(TextureCache::Format format) {
+		switch (format) {
+		case TextureCache::Format::BC1:
+			return DXGI_FORMAT_BC1_UNORM_SRGB;
+		case TextureCache::Format::BC3:
+			return DXGI_FORMAT_BC3_UNORM_SRGB;
+		case TextureCache::Format::BC7:
+			return DXGI_FORMAT_BC7_UNORM_SRGB;
+		case TextureCache::Format::RGBA8:
+		default:
+			return DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+		}
+	}
+
+	/// <summary>
+	/// キャッシュのミップをScratchImageにコピーする
+	/// </summary>
+	/// <returns>失敗したら空</returns>
+	DirectX::ScratchImage CreateImage(const TextureCache& cache) {
+		const auto& mips = cache.GetMips();
+		DirectX::ScratchImage image{};
+		if (mips.empty() || FAILED(image.Initialize2D(ToDxgiFormat(cache.GetFormat()), mips.front().width, mips.front().height, 1, mips.size()))) {
+			return DirectX::ScratchImage();
+		}
+
+		for (size_t i = 0; i < mips.size(); i++) {
+			const DirectX::Image* dst = image.GetImage(i, 0, 0);
+			const size_t rowNum = mips[i].data.size() / mips[i].rowPitch;
+			const size_t rowSize = std::min(dst->rowPitch, mips[i].rowPitch);
+			for (size_t row = 0; row < rowNum; row++) {
+				std::memcpy(dst->pixels + row * dst->rowPitch, mips[i].data.data() + row * mips[i].rowPitch, rowSize);
+			}
+		}
+		return image;
+	}
+
+	/// <summary>
+	/// sRGBのRGBA8の画像からミップマップ付きのScratchImageを作る(キャッシュは作らない)
+	/// </summary>
+	/// <returns>失敗したら空</returns>
+	DirectX::ScratchImage CreateMipImage(const DirectX::Image& source) {
+		const std::vector<MipGenerator::Mip> mips = MipGenerator::Generate(
+			std::span<const uint8_t>(source.pixels, source.slicePitch),
+			static_cast<uint32_t>(source.width),
+			static_cast<uint32_t>(source.height),
+			source.rowPitch
+		);
+		DirectX::ScratchImage image{};
+		if (FAILED(image.Initialize2D(DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, source.width, source.height, 1, mips.size() + 1))) {
+			return DirectX::ScratchImage();
+		}
+
+		const DirectX::Image* dst = image.GetImage(0, 0, 0);
+		for (size_t row = 0; row < source.height; row++) {
+			std::memcpy(dst->pixels + row * dst->rowPitch, source.pixels + row * source.rowPitch, source.width * 4);
+		}
+		for (size_t i = 0; i < mips.size(); i++) {
+			dst = image.GetImage(i + 1, 0, 0);
+			const size_t rowSize = static_cast<size_t>(mips[i].width) * 4;
+			for (size_t row = 0; row < mips[i].height; row++) {
+				std::memcpy(dst->pixels + row * dst->rowPitch, mips[i].pixels.data() + row * rowSize, rowSize);
+			}
+		}
+		return image;
+	}
+}
 
 Texture::Texture():
 	textureResouce(nullptr),
@@ -12,6 +85,10 @@ Texture::Texture():
 	srvDesc(),
 	isLoad(false),
 	threadLoadFlg(false),
+	streamImage(),
+	streamId(kNotStreaming),
+	residentMip(0u),
+	viewVersion(0u),
 	size(),
 	fileName()
 {}
@@ -29,16 +106,25 @@ Texture& Texture::operator=(Texture&& tex) noexcept {
 	this->intermediateResource = std::move(tex.intermediateResource);
 	this->srvDesc = tex.srvDesc;
 	isLoad = tex.isLoad;
+	streamImage = std::move(tex.streamImage);
+	streamId = tex.streamId;
+	residentMip = tex.residentMip;
+	viewVersion = tex.viewVersion;
 	fileName = tex.fileName;
 
 	return *this;
 }
 
 void Texture::Load(const std::string& filePath) {
+	if (!isLoad && !threadLoadFlg) {
+		Load(filePath, LoadTexture(filePath));
+	}
+}
+
+void Texture::Load(const std::string& filePath, const DirectX::ScratchImage& mipImages) {
 	if (!isLoad && !threadLoadFlg) {
 		this->fileName = filePath;
 
-		DirectX::ScratchImage mipImages = LoadTexture(filePath);
 		const DirectX::TexMetadata& metadata = mipImages.GetMetadata();
 		size = { static_cast<float>(metadata.width),static_cast<float>(metadata.height) };
 		textureResouce = CreateTextureResource(metadata);
@@ -60,30 +146,61 @@ void Texture::Load(const std::string& filePath) {
 	}
 }
 
-void Texture::Load(const std::string& filePath, ID3D12GraphicsCommandList* commandList) {
+void Texture::LoadStreaming(const std::string& filePath, DirectX::ScratchImage&& mipImages, uint32_t streamId_, uint32_t residentMip_) {
 	if (!isLoad && !threadLoadFlg) {
 		this->fileName = filePath;
 
-		DirectX::ScratchImage mipImages = LoadTexture(filePath);
 		const DirectX::TexMetadata& metadata = mipImages.GetMetadata();
-		size = { static_cast<float>(metadata.width),static_cast<float>(metadata.height) };
-		textureResouce = CreateTextureResource(metadata);
-
-		if (textureResouce) {
-			intermediateResource = UploadTextureData(textureResouce.Get(), mipImages, commandList);
-		}
-		else {
+		if (metadata.width == 0 || metadata.height == 0 || Engine::GetIsCloseCommandList()) {
 			return;
 		}
+		size = { static_cast<float>(metadata.width),static_cast<float>(metadata.height) };
+		streamImage = std::move(mipImages);
+		streamId = streamId_;
 
-		srvDesc.Format = metadata.format;
-		srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-		srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-		srvDesc.Texture2D.MipLevels = UINT(metadata.mipLevels);
+		StreamMip(residentMip_);
 
 		// load済み
-		isLoad = true;
+		isLoad = static_cast<bool>(textureResouce);
+	}
+}
+
+void Texture::StreamMip(uint32_t residentMip_) {
+	const DirectX::TexMetadata& metadata = streamImage.GetMetadata();
+	residentMip_ = std::min(residentMip_, static_cast<uint32_t>(metadata.mipLevels - 1));
+	// ブロック圧縮のテクスチャは一番大きいミップが4の倍数でないといけないので、そうなるミップまで細かくする
+	if (DirectX::IsCompressed(metadata.format)) {
+		while (0 < residentMip_ && ((metadata.width >> residentMip_) % 4 != 0 || (metadata.height >> residentMip_) % 4 != 0)) {
+			residentMip_--;
+		}
+	}
+
+	// 置くミップだけのテクスチャを作る(2Dテクスチャの画像はミップの順に並んでいる)
+	DirectX::TexMetadata residentMetadata = metadata;
+	residentMetadata.width = std::max<size_t>(metadata.width >> residentMip_, 1);
+	residentMetadata.height = std::max<size_t>(metadata.height >> residentMip_, 1);
+	residentMetadata.mipLevels = metadata.mipLevels - residentMip_;
+	ID3D12Resource* resource = CreateTextureResource(residentMetadata);
+	if (!resource) {
+		return;
+	}
+
+	// 前のフレームの描画と転送はFrameEnd()で待っているので、古いリソースはすぐに解放してよい
+	ReleaseIntermediateResource();
+	if (textureResouce) {
+		textureResouce->Release();
+		textureResouce.Reset();
 	}
+	textureResouce = resource;
+	intermediateResource = UploadTextureData(textureResouce.Get(), streamImage.GetImage(residentMip_, 0, 0), residentMetadata);
+
+	srvDesc.Format = metadata.format;
+	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+	srvDesc.Texture2D.MipLevels = UINT(residentMetadata.mipLevels);
+
+	residentMip = residentMip_;
+	viewVersion++;
 }
 
 void Texture::Unload() {
@@ -99,6 +216,10 @@ void Texture::Unload() {
 			textureResouce.Reset();
 		}
 
+		streamImage.Release();
+		streamId = kNotStreaming;
+		residentMip = 0u;
+
 		// Unload済み
 		isLoad = false;
 	}
@@ -111,7 +232,35 @@ DirectX::ScratchImage Texture::LoadTexture(const std::string& filePath) {
 		return DirectX::ScratchImage();
 	}
 
-	// テクスチャファイルを読み込んでプログラムを扱えるようにする
+	// 変換済みのキャッシュが新しければ、デコードとミップマップの作成を飛ばす
+	// 無ければ圧縮せずに読み込む(キャッシュはTextureManager::CookTextures()で作っておく)
+	TextureCache cache;
+	if (cache.Load(filePath)) {
+		DirectX::ScratchImage cacheImage = CreateImage(cache);
+		if (cacheImage.GetImageCount() != 0) {
+			return cacheImage;
+		}
+	}
+
+	// PNGとJPEGはWICを通さずにデコードする
+	ImageDecoder::Image decoded;
+	if (ImageDecoder::DecodeFile(filePath, decoded)) {
+		const size_t rowPitch = static_cast<size_t>(decoded.width) * 4;
+		const DirectX::Image rgba = {
+			decoded.width,
+			decoded.height,
+			DXGI_FORMAT_R8G8B8A8_UNORM_SRGB,
+			rowPitch,
+			rowPitch * decoded.height,
+			decoded.pixels.data()
+		};
+		DirectX::ScratchImage textureImage = CreateMipImage(rgba);
+		if (textureImage.GetImageCount() != 0) {
+			return textureImage;
+		}
+	}
+
+	// 対応していない形式はWICで読み込む
 	DirectX::ScratchImage image{};
 	std::wstring filePathW = ConvertString(filePath);
 	HRESULT hr = DirectX::LoadFromWICFile(filePathW.c_str(), DirectX::WIC_FLAGS_FORCE_SRGB, nullptr, image);
@@ -120,7 +269,21 @@ DirectX::ScratchImage Texture::LoadTexture(const std::string& filePath) {
 		return DirectX::ScratchImage();
 	}
 
-	// ミップマップの作成
+	// RGBA8にそろえて、ミップマップを作る
+	DirectX::ScratchImage rgbaImage{};
+	const DirectX::Image* rgba = image.GetImage(0, 0, 0);
+	if (image.GetMetadata().format != DXGI_FORMAT_R8G8B8A8_UNORM_SRGB) {
+		hr = DirectX::Convert(*rgba, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, DirectX::TEX_FILTER_DEFAULT, DirectX::TEX_THRESHOLD_DEFAULT, rgbaImage);
+		rgba = SUCCEEDED(hr) ? rgbaImage.GetImage(0, 0, 0) : nullptr;
+	}
+	if (rgba) {
+		DirectX::ScratchImage textureImage = CreateMipImage(*rgba);
+		if (textureImage.GetImageCount() != 0) {
+			return textureImage;
+		}
+	}
+
+	// RGBA8にできなければ、今まで通りDirectXTexでミップマップを作る
 	DirectX::ScratchImage mipImages{};
 	hr = DirectX::GenerateMipMaps(image.GetImages(), image.GetImageCount(), image.GetMetadata(), DirectX::TEX_FILTER_SRGB, 0, mipImages);
 	if (!SUCCEEDED(hr)) {
@@ -171,8 +334,13 @@ ID3D12Resource* Texture::CreateTextureResource(const DirectX::TexMetadata& metaD
 
 [[nodiscard]]
 ID3D12Resource* Texture::UploadTextureData(ID3D12Resource* texture, const DirectX::ScratchImage& mipImages) {
+	return UploadTextureData(texture, mipImages.GetImages(), mipImages.GetMetadata());
+}
+
+[[nodiscard]]
+ID3D12Resource* Texture::UploadTextureData(ID3D12Resource* texture, const DirectX::Image* images, const DirectX::TexMetadata& metadata) {
 	std::vector<D3D12_SUBRESOURCE_DATA> subresources;
-	DirectX::PrepareUpload(Engine::GetDevice(), mipImages.GetImages(), mipImages.GetImageCount(), mipImages.GetMetadata(), subresources);
+	DirectX::PrepareUpload(Engine::GetDevice(), images, metadata.mipLevels * metadata.arraySize, metadata, subresources);
 	uint64_t intermediateSize = GetRequiredIntermediateSize(texture, 0, UINT(subresources.size()));
 	ID3D12Resource* resource = Engine::CreateBufferResuorce(intermediateSize);
 	UpdateSubresources(Engine::GetCommandList(), texture, resource, 0, 0, UINT(subresources.size()), subresources.data());
@@ -187,37 +355,6 @@ ID3D12Resource* Texture::UploadTextureData(ID3D12Resource* texture, const Direct
 	return resource;
 }
 
-[[nodiscard]]
-ID3D12Resource* Texture::UploadTextureData(ID3D12Resource* texture, const DirectX::ScratchImage& mipImages, ID3D12GraphicsCommandList* commandList) {
-	std::vector<D3D12_SUBRESOURCE_DATA> subresources;
-	DirectX::PrepareUpload(Engine::GetDevice(), mipImages.GetImages(), mipImages.GetImageCount(), mipImages.GetMetadata(), subresources);
-	uint64_t intermediateSize = GetRequiredIntermediateSize(texture, 0, UINT(subresources.size()));
-	ID3D12Resource* resource = Engine::CreateBufferResuorce(intermediateSize);
-	UpdateSubresources(commandList, texture, resource, 0, 0, UINT(subresources.size()), subresources.data());
-	// Textureへの転送後は利用できるよう、D3D12_STATE_COPY_DESTからD3D12_RESOURCE_STATE_GENERIC_READへResouceStateを変更する
-	
-	// TransitionBarrierの設定
-	D3D12_RESOURCE_BARRIER barrier{};
-	// 今回のバリアはTransition
-	barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-	// Noneにしておく
-	barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
-	// バリアを張る対象のリソース
-	barrier.Transition.pResource = texture;
-	// subResourceの設定
-	barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-	// 遷移前(現在)のResouceState
-	barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
-	// 遷移後のResouceState
-	barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_GENERIC_READ;
-	// TransitionBarrierを張る
-	commandList->ResourceBarrier(1, &barrier);
-
-	return resource;
-}
-
-
-
 void Texture::CreateSRVView(D3D12_CPU_DESCRIPTOR_HANDLE descHeapHandle) {
 	Engine::GetDevice()->CreateShaderResourceView(textureResouce.Get(), &srvDesc, descHeapHandle);
 }
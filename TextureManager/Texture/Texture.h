@@ -7,6 +7,7 @@
 #include <wrl.h>
 
 #include <string>
+#include <cstdint>
 
 #include "Utils/Math/Vector2.h"
 
@@ -38,15 +39,36 @@ public:
 /// </summary>
 private:
 	void Load(const std::string& filePath);
-	void Load(const std::string& filePath, ID3D12GraphicsCommandList* commandList);
+	/// <summary>
+	/// LoadTexture()で読み込み済みの画像をGPUに転送する
+	/// </summary>
+	void Load(const std::string& filePath, const DirectX::ScratchImage& mipImages);
+	/// <summary>
+	/// ストリーミングするテクスチャとして読み込む(画像はCPU側に持っておき、residentMipより粗いミップだけを転送する)
+	/// </summary>
+	void LoadStreaming(const std::string& filePath, DirectX::ScratchImage&& mipImages, uint32_t streamId_, uint32_t residentMip_);
+	/// <summary>
+	/// GPUに置くミップを変える(リソースを作り直して、置くミップを全て転送し直す)
+	/// 前のフレームの描画が終わっていて、このフレームの描画より前に呼ぶ
+	/// </summary>
+	void StreamMip(uint32_t residentMip_);
 	void Unload();
 
-	DirectX::ScratchImage LoadTexture(const std::string& filePath);
+	/// <summary>
+	/// 画像ファイルを読み込んでミップマップを作る(GPUを使わないのでどのスレッドからでも呼べる)
+	/// 変換済みのキャッシュ(.tex)が新しければそれを使い、無ければ圧縮せずにミップマップを作る(キャッシュは書き出さない)
+	/// </summary>
+	static DirectX::ScratchImage LoadTexture(const std::string& filePath);
 	ID3D12Resource* CreateTextureResource(const DirectX::TexMetadata& metaData);
 	[[nodiscard]]
 	ID3D12Resource* UploadTextureData(ID3D12Resource* texture, const DirectX::ScratchImage& mipImages);
+	/// <summary>
+	/// 画像の一部のミップを転送する
+	/// </summary>
+	/// <param name="images">転送する一番細かいミップから並んだ画像</param>
+	/// <param name="metadata">転送するミップだけのメタデータ</param>
 	[[nodiscard]]
-	ID3D12Resource* UploadTextureData(ID3D12Resource* texture, const DirectX::ScratchImage& mipImages, ID3D12GraphicsCommandList* commandList);
+	ID3D12Resource* UploadTextureData(ID3D12Resource* texture, const DirectX::Image* images, const DirectX::TexMetadata& metadata);
 
 /// <summary>
 /// View作成関数
@@ -65,6 +87,23 @@ public:
 		return static_cast<bool>(textureResouce) && !static_cast<bool>(intermediateResource) && isLoad;
 	}
 
+	/// <summary>
+	/// ビューを作り直す必要があるとき(リソースを作り直したとき)に増える
+	/// </summary>
+	inline uint32_t GetViewVersion() const {
+		return viewVersion;
+	}
+
+	inline bool IsStreaming() const {
+		return streamId != kNotStreaming;
+	}
+	/// <summary>
+	/// GPUに置いている一番細かいミップ(ストリーミングしないなら0)
+	/// </summary>
+	inline uint32_t GetResidentMip() const {
+		return residentMip;
+	}
+
 
 /// <summary>
 /// メンバ関数
@@ -78,6 +117,18 @@ private:
 	bool isLoad;
 	bool threadLoadFlg;
 
+	static constexpr uint32_t kNotStreaming = 0xffffffffu;
+	/// <summary>
+	/// ストリーミングする時の全ミップの画像
+	/// </summary>
+	DirectX::ScratchImage streamImage;
+	/// <summary>
+	/// TextureStreamerの登録番号(ストリーミングしないならkNotStreaming)
+	/// </summary>
+	uint32_t streamId;
+	uint32_t residentMip;
+	uint32_t viewVersion;
+
 	Vector2 size;
 public:
 	inline const Vector2& getSize() const {
@@ -0,0 +1,342 @@
+#include "TextureAtlas.h"
+#include "TextureManager/TextureManager.h"
+#include "Engine/ConvertString/ConvertString.h"
+#include "Engine/ErrorCheck/ErrorCheck.h"
+#include "Utils/ImageDecoder/ImageDecoder.h"
+#include "Utils/MipGenerator/MipGenerator.h"
+#include "Utils/MappedFile/MappedFile.h"
+#include "Utils/CacheFile/CacheFile.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <type_traits>
+
+namespace {
+	constexpr std::array<char, 4> kMagic = { 'A', 'T', 'L', 'S' };
+	/// <summary>
+	/// ページの画像の先頭の揃え
+	/// </summary>
+	constexpr size_t kBlobAlignment = 16;
+
+	struct FileHeader {
+		std::array<char, 4> magic;
+		uint32_t version;
+
+		uint32_t pageWidth;
+		uint32_t pageHeight;
+		uint32_t padding;
+		uint32_t alignment;
+		uint32_t pageNum;
+		uint32_t regionNum;
+	};
+
+	/// <summary>
+	/// 範囲の表(名前はこの表の後ろにまとめて置く)
+	/// </summary>
+	struct RegionHeader {
+		uint32_t page;
+		AtlasPacker::Rect rect;
+		uint32_t nameOffset;
+		uint32_t nameSize;
+	};
+
+	static_assert(std::is_trivially_copyable_v<FileHeader>);
+	static_assert(std::is_trivially_copyable_v<RegionHeader>);
+
+	template<class T>
+	bool Read(std::span<const std::byte> image, size_t offset, T& out) {
+		if (image.size() < offset || image.size() - offset < sizeof(T)) {
+			return false;
+		}
+		std::memcpy(&out, image.data() + offset, sizeof(T));
+		return true;
+	}
+
+	/// <summary>
+	/// 自前でデコードできない形式をWICで読み込んでRGBA8にする
+	/// </summary>
+	/// <returns>成功したか</returns>
+	bool DecodeWic(const std::string& fileName, ImageDecoder::Image& image) {
+		DirectX::ScratchImage wicImage{};
+		const std::wstring fileNameW = ConvertString(fileName);
+		if (FAILED(DirectX::LoadFromWICFile(fileNameW.c_str(), DirectX::WIC_FLAGS_FORCE_SRGB, nullptr, wicImage))) {
+			return false;
+		}
+
+		DirectX::ScratchImage rgbaImage{};
+		const DirectX::Image* rgba = wicImage.GetImage(0, 0, 0);
+		if (wicImage.GetMetadata().format != DXGI_FORMAT_R8G8B8A8_UNORM_SRGB) {
+			if (FAILED(DirectX::Convert(*rgba, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, DirectX::TEX_FILTER_DEFAULT, DirectX::TEX_THRESHOLD_DEFAULT, rgbaImage))) {
+				return false;
+			}
+			rgba = rgbaImage.GetImage(0, 0, 0);
+		}
+
+		image.width = static_cast<uint32_t>(rgba->width);
+		image.height = static_cast<uint32_t>(rgba->height);
+		image.pixels.resize(rgba->width * rgba->height * 4);
+		for (size_t row = 0; row < rgba->height; row++) {
+			std::memcpy(image.pixels.data() + row * rgba->width * 4, rgba->pixels + row * rgba->rowPitch, rgba->width * 4);
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// 画像をページに書き込み、周りの隙間を画像の端のピクセルで埋める
+	/// </summary>
+	void Blit(std::vector<uint8_t>& page, uint32_t pageWidth, const ImageDecoder::Image& image, const AtlasPacker::Rect& rect, uint32_t padding) {
+		const size_t pagePitch = static_cast<size_t>(pageWidth) * 4;
+		const size_t imagePitch = static_cast<size_t>(image.width) * 4;
+		const uint32_t left = rect.x - padding;
+		const uint32_t top = rect.y - padding;
+
+		for (uint32_t y = 0; y < rect.height; y++) {
+			uint8_t* dst = page.data() + (rect.y + y) * pagePitch;
+			const uint8_t* src = image.pixels.data() + y * imagePitch;
+			std::memcpy(dst + rect.x * 4, src, imagePitch);
+			for (uint32_t x = left; x < rect.x; x++) {
+				std::memcpy(dst + x * 4, src, 4);
+			}
+			for (uint32_t x = rect.x + rect.width; x < rect.x + rect.width + padding; x++) {
+				std::memcpy(dst + x * 4, src + imagePitch - 4, 4);
+			}
+		}
+
+		// 上下は隙間まで広げた端の行をコピーする
+		const size_t rowSize = static_cast<size_t>(rect.width + padding * 2) * 4;
+		const uint8_t* firstRow = page.data() + rect.y * pagePitch + left * 4;
+		const uint8_t* lastRow = page.data() + (rect.y + rect.height - 1) * pagePitch + left * 4;
+		for (uint32_t y = top; y < rect.y; y++) {
+			std::memcpy(page.data() + y * pagePitch + left * 4, firstRow, rowSize);
+		}
+		for (uint32_t y = rect.y + rect.height; y < rect.y + rect.height + padding; y++) {
+			std::memcpy(page.data() + y * pagePitch + left * 4, lastRow, rowSize);
+		}
+	}
+}
+
+TextureAtlas::TextureAtlas() :
+	name(),
+	setting(),
+	pageNum(0u),
+	regions(),
+	pages(),
+	textures()
+{}
+
+bool TextureAtlas::Build(const std::string& name_, std::span<const std::string> fileNames, const AtlasPacker::Setting& setting_) {
+	Clear();
+	name = name_;
+	setting = setting_;
+	// 詰める時と同じく、ページの大きさを揃えの倍数に切り捨てておく
+	const uint32_t alignment = std::max(setting.alignment, 1u);
+	setting.pageWidth = setting.pageWidth / alignment * alignment;
+	setting.pageHeight = setting.pageHeight / alignment * alignment;
+
+	std::vector<ImageDecoder::Image> images = ImageDecoder::DecodeFiles(fileNames);
+	std::vector<AtlasPacker::Size> sizes(images.size());
+	bool isSucceeded = true;
+	for (size_t i = 0; i < images.size(); i++) {
+		if (images[i].width == 0 && !DecodeWic(fileNames[i], images[i])) {
+			ErrorCheck::GetInstance()->ErrorTextBox("Build() : Failed to decode -> " + fileNames[i], "TextureAtlas");
+			isSucceeded = false;
+			continue;
+		}
+		sizes[i] = { images[i].width, images[i].height };
+	}
+
+	const std::vector<AtlasPacker::Placement> placements = AtlasPacker::Pack(sizes, setting, pageNum);
+
+	pages.resize(pageNum);
+	for (auto& page : pages) {
+		page.assign(static_cast<size_t>(setting.pageWidth) * setting.pageHeight * 4, 0u);
+	}
+	for (size_t i = 0; i < images.size(); i++) {
+		if (images[i].width == 0) {
+			continue;
+		}
+		if (placements[i].page == AtlasPacker::kInvalidPage) {
+			ErrorCheck::GetInstance()->ErrorTextBox("Build() : This image does not fit in the atlas -> " + fileNames[i], "TextureAtlas");
+			isSucceeded = false;
+			continue;
+		}
+
+		Blit(pages[placements[i].page], setting.pageWidth, images[i], placements[i].rect, setting.padding);
+		images[i] = ImageDecoder::Image();
+
+		Region region;
+		region.page = placements[i].page;
+		region.rect = placements[i].rect;
+		CalcUv(region);
+		regions[fileNames[i]] = region;
+	}
+
+	return isSucceeded;
+}
+
+bool TextureAtlas::Save(const std::string& fileName) const {
+	if (pages.size() != pageNum || pageNum == 0) {
+		return false;
+	}
+
+	FileHeader header{};
+	header.magic = kMagic;
+	header.version = kVersion;
+	header.pageWidth = setting.pageWidth;
+	header.pageHeight = setting.pageHeight;
+	header.padding = setting.padding;
+	header.alignment = setting.alignment;
+	header.pageNum = pageNum;
+	header.regionNum = static_cast<uint32_t>(regions.size());
+
+	std::vector<RegionHeader> regionHeaders;
+	regionHeaders.reserve(regions.size());
+	std::string names;
+	for (const auto& [regionName, region] : regions) {
+		regionHeaders.push_back({ region.page, region.rect, static_cast<uint32_t>(names.size()), static_cast<uint32_t>(regionName.size()) });
+		names += regionName;
+	}
+
+	const size_t pageSize = static_cast<size_t>(setting.pageWidth) * setting.pageHeight * 4;
+	const size_t namesOffset = sizeof(FileHeader) + sizeof(RegionHeader) * regionHeaders.size();
+	const size_t pagesOffset = AlignUp(namesOffset + names.size(), kBlobAlignment);
+	std::vector<std::byte> image(pagesOffset + pageSize * pageNum, std::byte{ 0 });
+	std::memcpy(image.data(), &header, sizeof(header));
+	std::memcpy(image.data() + sizeof(header), regionHeaders.data(), sizeof(RegionHeader) * regionHeaders.size());
+	std::memcpy(image.data() + namesOffset, names.data(), names.size());
+	for (uint32_t page = 0; page < pageNum; page++) {
+		std::memcpy(image.data() + pagesOffset + pageSize * page, pages[page].data(), pageSize);
+	}
+
+	return SaveCacheFile(fileName, image);
+}
+
+bool TextureAtlas::Load(const std::string& fileName) {
+	Clear();
+
+	MappedFile file;
+	if (!file.Open(fileName)) {
+		ErrorCheck::GetInstance()->ErrorTextBox("Load() : Failed : This file is not exist -> " + fileName, "TextureAtlas");
+		return false;
+	}
+	const std::span<const std::byte> data = file.GetData();
+
+	FileHeader header{};
+	if (!Read(data, 0, header) || header.magic != kMagic || header.version != kVersion
+		|| header.pageWidth == 0 || header.pageHeight == 0 || header.pageNum == 0
+	) {
+		ErrorCheck::GetInstance()->ErrorTextBox("Load() : Failed : This file is not atlas or old version -> " + fileName, "TextureAtlas");
+		return false;
+	}
+
+	const size_t pageSize = static_cast<size_t>(header.pageWidth) * header.pageHeight * 4;
+	const size_t namesOffset = sizeof(FileHeader) + sizeof(RegionHeader) * static_cast<size_t>(header.regionNum);
+	bool isValid = namesOffset <= data.size();
+	size_t namesSize = 0;
+	std::vector<RegionHeader> regionHeaders(isValid ? header.regionNum : 0u);
+	for (size_t i = 0; isValid && i < regionHeaders.size(); i++) {
+		RegionHeader& regionHeader = regionHeaders[i];
+		isValid = Read(data, sizeof(FileHeader) + sizeof(RegionHeader) * i, regionHeader)
+			&& regionHeader.page < header.pageNum
+			&& regionHeader.rect.width != 0 && regionHeader.rect.height != 0
+			&& static_cast<uint64_t>(regionHeader.rect.x) + regionHeader.rect.width <= header.pageWidth
+			&& static_cast<uint64_t>(regionHeader.rect.y) + regionHeader.rect.height <= header.pageHeight;
+		namesSize = std::max<size_t>(namesSize, static_cast<size_t>(regionHeader.nameOffset) + regionHeader.nameSize);
+	}
+	const size_t pagesOffset = AlignUp(namesOffset + namesSize, kBlobAlignment);
+	if (!isValid || data.size() < pagesOffset || (data.size() - pagesOffset) / pageSize < header.pageNum) {
+		ErrorCheck::GetInstance()->ErrorTextBox("Load() : Failed : This file is broken -> " + fileName, "TextureAtlas");
+		return false;
+	}
+
+	name = fileName;
+	setting.pageWidth = header.pageWidth;
+	setting.pageHeight = header.pageHeight;
+	setting.padding = header.padding;
+	setting.alignment = header.alignment;
+	setting.maxPageNum = header.pageNum;
+	pageNum = header.pageNum;
+
+	const char* names = reinterpret_cast<const char*>(data.data() + namesOffset);
+	for (const auto& regionHeader : regionHeaders) {
+		Region region;
+		region.page = regionHeader.page;
+		region.rect = regionHeader.rect;
+		CalcUv(region);
+		regions[std::string(names + regionHeader.nameOffset, regionHeader.nameSize)] = region;
+	}
+
+	pages.resize(pageNum);
+	for (uint32_t page = 0; page < pageNum; page++) {
+		const uint8_t* pageData = reinterpret_cast<const uint8_t*>(data.data() + pagesOffset + pageSize * page);
+		pages[page].assign(pageData, pageData + pageSize);
+	}
+
+	return true;
+}
+
+bool TextureAtlas::CreateTextures() {
+	if (pages.size() != pageNum) {
+		return !textures.empty();
+	}
+
+	const uint32_t mipNum = std::min(AtlasPacker::CalcSafeMipNum(setting), MipGenerator::CalcMipNum(setting.pageWidth, setting.pageHeight));
+	const size_t rowPitch = static_cast<size_t>(setting.pageWidth) * 4;
+	bool isSucceeded = true;
+	textures.assign(pageNum, nullptr);
+	for (uint32_t page = 0; page < pageNum; page++) {
+		// 1x1まで作ってから、にじまないミップまでを使う
+		const std::vector<MipGenerator::Mip> mips = MipGenerator::Generate(pages[page], setting.pageWidth, setting.pageHeight, rowPitch);
+		DirectX::ScratchImage image{};
+		if (mips.size() + 1 < mipNum || FAILED(image.Initialize2D(DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, setting.pageWidth, setting.pageHeight, 1, mipNum))) {
+			isSucceeded = false;
+			continue;
+		}
+
+		const DirectX::Image* dst = image.GetImage(0, 0, 0);
+		for (size_t row = 0; row < setting.pageHeight; row++) {
+			std::memcpy(dst->pixels + row * dst->rowPitch, pages[page].data() + row * rowPitch, rowPitch);
+		}
+		for (uint32_t mip = 1; mip < mipNum; mip++) {
+			const MipGenerator::Mip& source = mips[mip - 1];
+			const size_t rowSize = static_cast<size_t>(source.width) * 4;
+			dst = image.GetImage(mip, 0, 0);
+			for (size_t row = 0; row < source.height; row++) {
+				std::memcpy(dst->pixels + row * dst->rowPitch, source.pixels.data() + row * rowSize, rowSize);
+			}
+		}
+
+		textures[page] = TextureManager::GetInstance()->LoadTexture(name + "#" + std::to_string(page), std::move(image));
+		if (!textures[page]) {
+			isSucceeded = false;
+		}
+	}
+
+	pages.clear();
+	pages.shrink_to_fit();
+	return isSucceeded;
+}
+
+const TextureAtlas::Region* TextureAtlas::GetRegion(const std::string& regionName) const {
+	auto itr = regions.find(regionName);
+	return itr == regions.end() ? nullptr : &itr->second;
+}
+
+Texture* TextureAtlas::GetTexture(uint32_t page) const {
+	return page < textures.size() ? textures[page] : nullptr;
+}
+
+void TextureAtlas::Clear() {
+	name.clear();
+	setting = AtlasPacker::Setting{};
+	pageNum = 0u;
+	regions.clear();
+	pages.clear();
+	textures.clear();
+}
+
+void TextureAtlas::CalcUv(Region& region) const {
+	const Vector2 pageSize = { static_cast<float>(setting.pageWidth), static_cast<float>(setting.pageHeight) };
+	region.uvPibot = { static_cast<float>(region.rect.x) / pageSize.x, static_cast<float>(region.rect.y) / pageSize.y };
+	region.uvSize = { static_cast<float>(region.rect.width) / pageSize.x, static_cast<float>(region.rect.height) / pageSize.y };
+}
@@ -0,0 +1,131 @@
+#pragma once
+#include "TextureManager/Texture/Texture.h"
+#include "Utils/AtlasPacker/AtlasPacker.h"
+#include "Utils/Math/Vector2.h"
+
+#include <string>
+#include <vector>
+#include <span>
+#include <unordered_map>
+#include <cstdint>
+
+/// <summary>
+/// 複数の小さい画像を1枚または数枚のページにまとめたテクスチャ
+/// Build()かLoad()でページの画像と画像ごとの範囲を作り(GPUを使わないのでワーカースレッドからも呼べる)、
+/// CreateTextures()でページをTextureManagerに登録する
+/// 画像の範囲はファイル名で引き、Texture2D::LoadTexture(atlas, name)でuvPibotとuvSizeに入れる
+/// </summary>
+class TextureAtlas final {
+public:
+	/// <summary>
+	/// 1つの画像がページのどこにあるか
+	/// </summary>
+	struct Region {
+		uint32_t page = 0;
+		/// <summary>
+		/// ページ上のピクセルの範囲
+		/// </summary>
+		AtlasPacker::Rect rect;
+		/// <summary>
+		/// Texture2Dにそのまま入れるUV(左上と大きさ)
+		/// </summary>
+		Vector2 uvPibot;
+		Vector2 uvSize;
+	};
+
+public:
+	/// <summary>
+	/// ファイルの形式が変わったら上げる
+	/// </summary>
+	static constexpr uint32_t kVersion = 1;
+
+public:
+	TextureAtlas();
+	TextureAtlas(const TextureAtlas&) = delete;
+	TextureAtlas(TextureAtlas&&) noexcept = default;
+	~TextureAtlas() = default;
+
+	TextureAtlas& operator=(const TextureAtlas&) = delete;
+	TextureAtlas& operator=(TextureAtlas&&) noexcept = default;
+
+public:
+	/// <summary>
+	/// 画像ファイルを読み込んでページに詰める
+	/// </summary>
+	/// <param name="name_">アトラスの名前(ページをTextureManagerに登録するときのキーに使う)</param>
+	/// <param name="fileNames">詰める画像ファイル(ファイル名がそのまま範囲を引く名前になる)</param>
+	/// <param name="setting_">ページの大きさと隙間</param>
+	/// <returns>全ての画像を詰められたか(詰められなかった画像は範囲が登録されない)</returns>
+	bool Build(const std::string& name_, std::span<const std::string> fileNames, const AtlasPacker::Setting& setting_ = AtlasPacker::Setting{});
+
+	/// <summary>
+	/// Build()で作ったページと範囲をファイルに書き出す(CreateTextures()より前に呼ぶ)
+	/// オフラインで作っておけば、読み込み時は画像のデコードと詰める処理を飛ばせる
+	/// </summary>
+	/// <returns>成功したか</returns>
+	bool Save(const std::string& fileName) const;
+
+	/// <summary>
+	/// Save()で書き出したファイルを読み込む(ファイル名がアトラスの名前になる)
+	/// </summary>
+	/// <returns>成功したか</returns>
+	bool Load(const std::string& fileName);
+
+	/// <summary>
+	/// ページのミップマップを作ってTextureManagerに登録する(CPU側のページの画像は解放する)
+	/// ミップは隣の画像がにじまない数までにする
+	/// メインスレッドでEngineのコマンドリストが開いている間に呼ぶ
+	/// </summary>
+	/// <returns>全てのページを登録できたか</returns>
+	bool CreateTextures();
+
+public:
+	/// <summary>
+	/// 画像の範囲を探す
+	/// </summary>
+	/// <param name="regionName">Build()に渡したファイル名</param>
+	/// <returns>無ければnullptr</returns>
+	const Region* GetRegion(const std::string& regionName) const;
+
+	/// <summary>
+	/// ページのテクスチャ(CreateTextures()より前ならnullptr)
+	/// </summary>
+	Texture* GetTexture(uint32_t page) const;
+
+	inline uint32_t GetPageNum() const {
+		return pageNum;
+	}
+
+	inline const std::string& GetName() const {
+		return name;
+	}
+
+	inline const AtlasPacker::Setting& GetSetting() const {
+		return setting;
+	}
+
+private:
+	void Clear();
+
+	/// <summary>
+	/// 範囲からUVを計算する
+	/// </summary>
+	void CalcUv(Region& region) const;
+
+private:
+	std::string name;
+	AtlasPacker::Setting setting;
+	uint32_t pageNum;
+
+	/// <summary>
+	/// 画像の範囲(キー値: ファイル名)
+	/// </summary>
+	std::unordered_map<std::string, Region> regions;
+
+	/// <summary>
+	/// ページの画像(sRGBのRGBA8。CreateTextures()で解放する)
+	/// </summary>
+	std::vector<std::vector<uint8_t>> pages;
+
+	std::vector<Texture*> textures;
+};
@@ -0,0 +1,212 @@
+#include "TextureCache.h"
+#include "Utils/CacheFile/CacheFile.h"
+#include "Utils/TextureCompressor/BlockCompressor.h"
+#include <filesystem>
+#include <array>
+#include <cstring>
+#include <type_traits>
+
+namespace {
+	constexpr std::array<char, 4> kMagic = { 'T', 'E', 'X', 'C' };
+	/// <summary>
+	/// 1x1までのミップの数の上限(65536x65536)
+	/// </summary>
+	constexpr uint32_t kMaxMipNum = 17;
+
+	struct FileHeader {
+		std::array<char, 4> magic;
+		uint32_t version;
+
+		// 元ファイルの情報(キャッシュが古くなっていないかの判定用)
+		uint64_t sourceSize;
+		int64_t sourceTime;
+		uint64_t sourceHash;
+
+		TextureCache::Format format;
+		uint32_t mipNum;
+	};
+
+	struct MipHeader {
+		uint32_t width;
+		uint32_t height;
+		uint64_t offset;
+		uint64_t size;
+	};
+
+	static_assert(std::is_trivially_copyable_v<FileHeader>);
+	static_assert(std::is_trivially_copyable_v<MipHeader>);
+
+	template<class T>
+	bool Read(std::span<const std::byte> image, size_t offset, T& out) {
+		if (image.size() < offset || image.size() - offset < sizeof(T)) {
+			return false;
+		}
+		std::memcpy(&out, image.data() + offset, sizeof(T));
+		return true;
+	}
+
+	BlockFormat ToBlockFormat(TextureCache::Format format) {
+		switch (format) {
+		case TextureCache::Format::BC1:
+			return BlockFormat::BC1;
+		case TextureCache::Format::BC3:
+			return BlockFormat::BC3;
+		case TextureCache::Format::BC7:
+		default:
+			return BlockFormat::BC7;
+		}
+	}
+}
+
+TextureCache::TextureCache() :
+	sourceFileName(),
+	file(),
+	image(),
+	format(Format::RGBA8),
+	mips()
+{}
+
+bool TextureCache::Load(const std::string& sourceFileName_) {
+	Close();
+	sourceFileName = sourceFileName_;
+
+	if (!file.Open(GetCacheFileName(sourceFileName))) {
+		return false;
+	}
+
+	FileHeader header{};
+	if (!Read(file.GetData(), 0, header) || header.magic != kMagic || header.version != kVersion) {
+		Close();
+		return false;
+	}
+
+	if (!IsSameSourceFile(sourceFileName, { header.sourceSize, header.sourceTime, header.sourceHash })) {
+		Close();
+		return false;
+	}
+
+	if (!Parse(file.GetData())) {
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+bool TextureCache::Create(const std::string& sourceFileName_, Format format_, std::span<const Mip> mipSources) {
+	Close();
+	sourceFileName = sourceFileName_;
+
+	if (mipSources.empty() || kMaxMipNum < mipSources.size()) {
+		return false;
+	}
+
+	FileHeader header{};
+	header.magic = kMagic;
+	header.version = kVersion;
+	SourceFileInfo sourceInfo;
+	if (!GetSourceFileInfo(sourceFileName, sourceInfo)) {
+		return false;
+	}
+	header.sourceSize = sourceInfo.size;
+	header.sourceTime = sourceInfo.time;
+	header.sourceHash = sourceInfo.hash;
+	header.format = format_;
+	header.mipNum = static_cast<uint32_t>(mipSources.size());
+
+	// ミップの配置を決める(行の隙間は詰める)
+	std::vector<MipHeader> mipHeaders(mipSources.size());
+	size_t offset = sizeof(FileHeader) + sizeof(MipHeader) * mipHeaders.size();
+	for (size_t i = 0; i < mipSources.size(); i++) {
+		const Mip& source = mipSources[i];
+		const size_t rowPitch = CalcRowPitch(format_, source.width);
+		const size_t mipSize = CalcMipSize(format_, source.width, source.height);
+		if (source.width == 0 || source.height == 0 || source.rowPitch < rowPitch
+			|| source.data.size() < source.rowPitch * (mipSize / rowPitch - 1) + rowPitch
+		) {
+			return false;
+		}
+
+		offset = AlignUp(offset, kBlobAlignment);
+		mipHeaders[i] = { source.width, source.height, offset, mipSize };
+		offset += mipSize;
+	}
+
+	// 書き込む
+	image.assign(offset, std::byte{ 0 });
+	std::memcpy(image.data(), &header, sizeof(header));
+	std::memcpy(image.data() + sizeof(header), mipHeaders.data(), sizeof(MipHeader) * mipHeaders.size());
+	for (size_t i = 0; i < mipSources.size(); i++) {
+		const Mip& source = mipSources[i];
+		const size_t rowPitch = CalcRowPitch(format_, source.width);
+		const size_t rowNum = static_cast<size_t>(mipHeaders[i].size / rowPitch);
+		for (size_t row = 0; row < rowNum; row++) {
+			std::memcpy(image.data() + mipHeaders[i].offset + row * rowPitch, source.data.data() + row * source.rowPitch, rowPitch);
+		}
+	}
+
+	if (!Parse(image)) {
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+bool TextureCache::Save() const {
+	return SaveCacheFile(GetCacheFileName(sourceFileName), image);
+}
+
+void TextureCache::Close() {
+	file.Close();
+	image.clear();
+	format = Format::RGBA8;
+	mips.clear();
+}
+
+size_t TextureCache::CalcRowPitch(Format format, uint32_t width) {
+	return IsCompressed(format) ? CalcCompressedRowPitch(ToBlockFormat(format), width) : static_cast<size_t>(width) * 4;
+}
+
+size_t TextureCache::CalcMipSize(Format format, uint32_t width, uint32_t height) {
+	return IsCompressed(format) ? CalcCompressedSize(ToBlockFormat(format), width, height) : static_cast<size_t>(width) * height * 4;
+}
+
+std::string TextureCache::GetCacheFileName(const std::string& sourceFileName) {
+	std::filesystem::path path = sourceFileName;
+	path.replace_extension(".tex");
+	return path.string();
+}
+
+bool TextureCache::Parse(std::span<const std::byte> data) {
+	FileHeader header{};
+	if (!Read(data, 0, header) || header.mipNum == 0 || kMaxMipNum < header.mipNum
+		|| static_cast<uint32_t>(Format::BC7) < static_cast<uint32_t>(header.format)
+	) {
+		return false;
+	}
+
+	size_t offset = sizeof(FileHeader);
+	mips.resize(header.mipNum);
+	for (auto& mip : mips) {
+		MipHeader mipHeader{};
+		if (!Read(data, offset, mipHeader)
+			|| mipHeader.width == 0 || mipHeader.height == 0
+			|| mipHeader.size != CalcMipSize(header.format, mipHeader.width, mipHeader.height)
+			|| data.size() < mipHeader.offset || data.size() - mipHeader.offset < mipHeader.size
+		) {
+			mips.clear();
+			return false;
+		}
+		offset += sizeof(MipHeader);
+
+		mip.width = mipHeader.width;
+		mip.height = mipHeader.height;
+		mip.rowPitch = CalcRowPitch(header.format, mipHeader.width);
+		mip.data = data.subspan(static_cast<size_t>(mipHeader.offset), static_cast<size_t>(mipHeader.size));
+	}
+
+	format = header.format;
+
+	return true;
+}
@@ -0,0 +1,127 @@
+#pragma once
+#include "Utils/MappedFile/MappedFile.h"
+#include <string>
+#include <vector>
+#include <span>
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// 画像ファイルから変換したテクスチャのバイナリキャッシュ(ミップマップ込み)
+/// ファイルの構成 : ヘッダー | ミップ表 | ミップごとのデータ(それぞれkBlobAlignmentに揃える)
+/// 読み込み時はファイルをマップして、コピーせずにミップのspanを返す
+/// 元ファイルのサイズと更新日時が変わっていて、中身のハッシュも違う場合は無効になる
+/// </summary>
+class TextureCache {
+public:
+	/// <summary>
+	/// 画素の形式(全てsRGB)
+	/// </summary>
+	enum class Format : uint32_t {
+		RGBA8,
+		BC1,
+		BC3,
+		BC7
+	};
+
+	/// <summary>
+	/// 1つのミップ(ブロック圧縮ならrowPitchはブロック1列分のバイト数)
+	/// </summary>
+	struct Mip {
+		uint32_t width = 0;
+		uint32_t height = 0;
+		size_t rowPitch = 0;
+		std::span<const std::byte> data;
+	};
+
+public:
+	/// <summary>
+	/// 形式が変わったら上げる
+	/// </summary>
+	static constexpr uint32_t kVersion = 2;
+	/// <summary>
+	/// ミップのデータの先頭の揃え
+	/// </summary>
+	static constexpr size_t kBlobAlignment = 16;
+
+public:
+	TextureCache();
+	TextureCache(const TextureCache&) = delete;
+	TextureCache(TextureCache&&) noexcept = default;
+	~TextureCache() = default;
+
+	TextureCache& operator=(const TextureCache&) = delete;
+	TextureCache& operator=(TextureCache&&) noexcept = default;
+
+public:
+	/// <summary>
+	/// 元ファイルに対応するキャッシュファイルを開く
+	/// </summary>
+	/// <param name="sourceFileName">元の画像ファイルパス</param>
+	/// <returns>有効なキャッシュが読めたか</returns>
+	bool Load(const std::string& sourceFileName);
+
+	/// <summary>
+	/// メモリ上にキャッシュを作る(Save()でファイルに書き出せる)
+	/// </summary>
+	/// <param name="sourceFileName">元の画像ファイルパス(更新日時とハッシュを記録する)</param>
+	/// <param name="format">画素の形式</param>
+	/// <param name="mips">0番が一番大きいミップ</param>
+	/// <returns>成功したか</returns>
+	bool Create(const std::string& sourceFileName, Format format, std::span<const Mip> mips);
+
+	/// <summary>
+	/// Create()で作ったキャッシュをファイルに書き出す
+	/// </summary>
+	/// <returns>成功したか</returns>
+	bool Save() const;
+
+	void Close();
+
+public:
+	Format GetFormat() const {
+		return format;
+	}
+	const std::vector<Mip>& GetMips() const {
+		return mips;
+	}
+
+	/// <summary>
+	/// ブロック圧縮されているか
+	/// </summary>
+	static bool IsCompressed(Format format) {
+		return format != Format::RGBA8;
+	}
+
+	/// <summary>
+	/// ミップの1行(ブロック圧縮なら1ブロック列)のバイト数
+	/// </summary>
+	static size_t CalcRowPitch(Format format, uint32_t width);
+	/// <summary>
+	/// ミップのバイト数
+	/// </summary>
+	static size_t CalcMipSize(Format format, uint32_t width, uint32_t height);
+
+	/// <summary>
+	/// 元ファイルに対応するキャッシュファイル名(拡張子を.texにする)
+	/// </summary>
+	static std::string GetCacheFileName(const std::string& sourceFileName);
+
+private:
+	/// <summary>
+	/// ファイルの中身を解析してspanを作る
+	/// </summary>
+	bool Parse(std::span<const std::byte> image);
+
+private:
+	std::string sourceFileName;
+
+	MappedFile file;
+	/// <summary>
+	/// Create()で作ったときのファイルの中身
+	/// </summary>
+	std::vector<std::byte> image;
+
+	Format format;
+	std::vector<Mip> mips;
+};
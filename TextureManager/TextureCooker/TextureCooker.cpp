@@ -0,0 +1,107 @@
+#include "TextureCooker.h"
+#include "Utils/TextureCompressor/BlockCompressor.h"
+#include <filesystem>
+
+namespace {
+	BlockFormat ToBlockFormat(TextureCache::Format format) {
+		switch (format) {
+		case TextureCache::Format::BC1:
+			return BlockFormat::BC1;
+		case TextureCache::Format::BC3:
+			return BlockFormat::BC3;
+		case TextureCache::Format::BC7:
+		default:
+			return BlockFormat::BC7;
+		}
+	}
+}
+
+bool TextureCooker::Cook(
+	const std::string& sourceFileName,
+	std::span<const uint8_t> pixels,
+	uint32_t width,
+	uint32_t height,
+	size_t rowPitch,
+	const Setting& setting,
+	TextureCache& cache
+) {
+	if (width == 0 || height == 0 || rowPitch < static_cast<size_t>(width) * 4
+		|| pixels.size() < rowPitch * (height - 1) + static_cast<size_t>(width) * 4
+	) {
+		return false;
+	}
+
+	const TextureCache::Format format = ChooseFormat(pixels, width, height, rowPitch, setting.format);
+
+	// 1x1までのミップマップを作る
+	const std::vector<MipGenerator::Mip> generatedMips = MipGenerator::Generate(pixels, width, height, rowPitch, setting.filter, setting.threadNum);
+	std::vector<TextureCache::Mip> mips;
+	mips.reserve(generatedMips.size() + 1);
+	mips.push_back({ width, height, rowPitch, std::as_bytes(pixels) });
+	for (const auto& mip : generatedMips) {
+		mips.push_back({ mip.width, mip.height, static_cast<size_t>(mip.width) * 4, std::as_bytes(std::span<const uint8_t>(mip.pixels)) });
+	}
+
+	// ブロック圧縮する(4x4より小さいミップは端を繰り返して1ブロックにする)
+	std::vector<std::vector<uint8_t>> compressedMips;
+	if (TextureCache::IsCompressed(format)) {
+		const BlockFormat blockFormat = ToBlockFormat(format);
+		compressedMips.reserve(mips.size());
+		for (auto& mip : mips) {
+			auto& compressed = compressedMips.emplace_back(CalcCompressedSize(blockFormat, mip.width, mip.height));
+			const std::span<const uint8_t> mipSource(reinterpret_cast<const uint8_t*>(mip.data.data()), mip.data.size());
+			if (!CompressImage(blockFormat, mipSource, mip.width, mip.height, mip.rowPitch, compressed, setting.threadNum)) {
+				return false;
+			}
+			mip.rowPitch = CalcCompressedRowPitch(blockFormat, mip.width);
+			mip.data = std::as_bytes(std::span<const uint8_t>(compressed));
+		}
+	}
+
+	return cache.Create(sourceFileName, format, mips);
+}
+
+TextureCache::Format TextureCooker::ChooseFormat(std::span<const uint8_t> pixels, uint32_t width, uint32_t height, size_t rowPitch, Format format) {
+	// D3D12ではブロック圧縮のテクスチャの大きさは4の倍数でないといけない
+	if (format == Format::RGBA8 || width % 4 != 0 || height % 4 != 0) {
+		return TextureCache::Format::RGBA8;
+	}
+
+	switch (format) {
+	case Format::BC1:
+		return TextureCache::Format::BC1;
+	case Format::BC3:
+		return TextureCache::Format::BC3;
+	case Format::BC7:
+		return TextureCache::Format::BC7;
+	case Format::Auto:
+	default:
+		break;
+	}
+
+	for (uint32_t y = 0; y < height; y++) {
+		for (uint32_t x = 0; x < width; x++) {
+			if (pixels[y * rowPitch + x * 4 + 3] != 255) {
+				return TextureCache::Format::BC7;
+			}
+		}
+	}
+	return TextureCache::Format::BC1;
+}
+
+std::vector<std::string> TextureCooker::FindStaleSources(const std::string& directory) {
+	std::vector<std::string> result;
+	std::error_code err;
+	for (auto itr = std::filesystem::recursive_directory_iterator(directory, err); !err && itr != std::filesystem::recursive_directory_iterator(); itr.increment(err)) {
+		if (!itr->is_regular_file() || itr->path().extension() != kSourceExtension) {
+			continue;
+		}
+
+		const std::string fileName = itr->path().generic_string();
+		TextureCache cache;
+		if (!cache.Load(fileName)) {
+			result.push_back(fileName);
+		}
+	}
+	return result;
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include "TextureManager/TextureCache/TextureCache.h"
+#include "Utils/MipGenerator/MipGenerator.h"
+#include <string>
+#include <vector>
+#include <span>
+#include <cstdint>
+
+/// <summary>
+/// 画像をミップマップ付きのブロック圧縮テクスチャに変換してキャッシュを作る(GPUもWindowsのAPIも使わない)
+/// </summary>
+class TextureCooker {
+public:
+	/// <summary>
+	/// 変換後の形式
+	/// </summary>
+	enum class Format : uint32_t {
+		/// <summary>
+		/// 不透明ならBC1、半透明ならBC7
+		/// </summary>
+		Auto,
+		RGBA8,
+		BC1,
+		BC3,
+		BC7
+	};
+
+	struct Setting {
+		Format format = Format::Auto;
+		/// <summary>
+		/// ミップマップを作る時の縮小のフィルター
+		/// </summary>
+		MipGenerator::Filter filter = MipGenerator::Filter::Box;
+		/// <summary>
+		/// ミップマップの生成と圧縮に使うスレッド数(0ならハードウェアのスレッド数)
+		/// </summary>
+		uint32_t threadNum = 0;
+	};
+
+public:
+	/// <summary>
+	/// 変換するファイルの拡張子
+	/// </summary>
+	static constexpr const char* kSourceExtension = ".png";
+
+public:
+	/// <summary>
+	/// sRGBのRGBA8の画像からミップマップを作って圧縮し、キャッシュを作る(Save()はしない)
+	/// 幅と高さが4の倍数でなければブロック圧縮できないのでRGBA8にする
+	/// </summary>
+	/// <param name="sourceFileName">元の画像ファイルパス</param>
+	/// <param name="pixels">sRGBのRGBA8の画像</param>
+	/// <param name="width">幅</param>
+	/// <param name="height">高さ</param>
+	/// <param name="rowPitch">1行のバイト数</param>
+	/// <param name="setting">変換の設定</param>
+	/// <param name="cache">作ったキャッシュ</param>
+	/// <returns>成功したか</returns>
+	static bool Cook(
+		const std::string& sourceFileName,
+		std::span<const uint8_t> pixels,
+		uint32_t width,
+		uint32_t height,
+		size_t rowPitch,
+		const Setting& setting,
+		TextureCache& cache
+	);
+
+	/// <summary>
+	/// 画像の内容と設定から形式を決める
+	/// </summary>
+	static TextureCache::Format ChooseFormat(std::span<const uint8_t> pixels, uint32_t width, uint32_t height, size_t rowPitch, Format format);
+
+	/// <summary>
+	/// ディレクトリ以下の変換するファイルのうち、キャッシュが無いか古いものを探す
+	/// </summary>
+	static std::vector<std::string> FindStaleSources(const std::string& directory);
+};
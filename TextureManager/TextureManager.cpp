@@ -1,7 +1,11 @@
 #include "TextureManager.h"
 #include "Engine/ErrorCheck/ErrorCheck.h"
 #include "Engine/Engine.h"
+#include "TextureManager/TextureCooker/TextureCooker.h"
+#include "Utils/ImageDecoder/ImageDecoder.h"
+#include "externals/imgui/imgui.h"
 #include <cassert>
+#include <algorithm>
 
 TextureManager* TextureManager::instance = nullptr;
 
@@ -23,66 +27,18 @@ void TextureManager::Finalize() {
 TextureManager::TextureManager() :
 	textures(),
 	thisFrameLoadFlg(false),
-	threadTextureBuff(),
-	load(),
-	isThreadFinish(false),
-	fence(),
-	fenceVal(0),
-	fenceEvent(nullptr)
-{
-	// コマンドキューを作成
-	commandQueue = nullptr;
-	D3D12_COMMAND_QUEUE_DESC commandQueueDesc{};
-	HRESULT hr = Engine::GetDevice()->CreateCommandQueue(&commandQueueDesc, IID_PPV_ARGS(commandQueue.GetAddressOf()));
-	assert(SUCCEEDED(hr));
-	if (!SUCCEEDED(hr)) {
-		ErrorCheck::GetInstance()->ErrorTextBox("TextureManager() : CreateCommandQueue() Failed", "TextureManager");
-		return;
-	}
-
-	// コマンドアロケータを生成する
-	commandAllocator = nullptr;
-	hr = Engine::GetDevice()->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(commandAllocator.GetAddressOf()));
-	assert(SUCCEEDED(hr));
-	if (!SUCCEEDED(hr)) {
-		ErrorCheck::GetInstance()->ErrorTextBox("TextureManager() : CreateCommandAllocator() Failed", "TextureManager");
-		return;
-	}
-
-	// コマンドリストを作成する
-	commandList = nullptr;
-	hr = Engine::GetDevice()->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, commandAllocator.Get(), nullptr, IID_PPV_ARGS(commandList.GetAddressOf()));
-	assert(SUCCEEDED(hr));
-	if (!SUCCEEDED(hr)) {
-		ErrorCheck::GetInstance()->ErrorTextBox("TextureManager() : CreateCommandList() Failed", "TextureManager");
-		return;
-	}
-
-	// 初期値0でFenceを作る
-	fence = nullptr;
-	fenceVal = 0;
-	hr = Engine::GetDevice()->CreateFence(fenceVal, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(fence.GetAddressOf()));
-	assert(SUCCEEDED(hr));
-	if (!SUCCEEDED(hr)) {
-		ErrorCheck::GetInstance()->ErrorTextBox("TextureManager() : CreateFence() Failed", "TextureManager");
-		return;
-	}
-
-	// FenceのSignalを持つためのイベントを作成する
-	fenceEvent = nullptr;
-	fenceEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
-	assert(fenceEvent != nullptr);
-	if (!(fenceEvent != nullptr)) {
-		ErrorCheck::GetInstance()->ErrorTextBox("TextureManager() : CreateEvent() Failed", "TextureManager");
-		return;
-	}
-}
+	loader(&TextureManager::DecodeTexture),
+	loadRequests(),
+	nextLoadId(kInvalidLoadId + 1u),
+	streamer(),
+	streamTextures(),
+	isStreaming(false)
+{}
 
 TextureManager::~TextureManager() {
-	if (load.joinable()) {
-		load.join();
-	}
-	CloseHandle(fenceEvent);
+	// デコード中のものはloaderのデストラクタで待つ
+	loadRequests.clear();
+	streamTextures.clear();
 	textures.clear();
 }
 
@@ -117,108 +73,249 @@ Texture* TextureManager::LoadTexture(const std::string& fileName) {
 	return textures[fileName].get();
 }
 
-Texture* TextureManager::LoadTexture(const std::string& fileName, ID3D12GraphicsCommandList* commandList_) {
-	if (textures.empty()) {
+Texture* TextureManager::LoadTexture(const std::string& fileName, DirectX::ScratchImage&& mipImages) {
+	auto itr = textures.find(fileName);
+	if (itr == textures.end()) {
 		auto tex = std::make_unique<Texture>();
-		tex->Load(fileName, commandList_);
+		if (isStreaming && 1 < mipImages.GetMetadata().mipLevels) {
+			// ミップごとのバイト数で登録して、最初に置くミップを決めてもらう
+			const DirectX::TexMetadata& metadata = mipImages.GetMetadata();
+			std::vector<uint64_t> mipSizes(metadata.mipLevels);
+			for (size_t mip = 0; mip < metadata.mipLevels; mip++) {
+				mipSizes[mip] = mipImages.GetImage(mip, 0, 0)->slicePitch;
+			}
+			const uint32_t streamId = streamer.Register(static_cast<uint32_t>(metadata.width), static_cast<uint32_t>(metadata.height), mipSizes);
+			if (streamId != TextureStreamer::kInvalidId) {
+				tex->LoadStreaming(fileName, std::move(mipImages), streamId, streamer.GetResidentMip(streamId));
+				if (!tex->isLoad) {
+					streamer.Unregister(streamId);
+					return nullptr;
+				}
+				if (streamTextures.size() <= streamId) {
+					streamTextures.resize(streamId + 1, nullptr);
+				}
+				streamTextures[streamId] = tex.get();
+			}
+		}
+		else {
+			tex->Load(fileName, mipImages);
+		}
 		if (!tex->isLoad) {
 			return nullptr;
 		}
 
-		textures.insert(std::make_pair(fileName, std::move(tex)));
+		itr = textures.insert(std::make_pair(fileName, std::move(tex))).first;
 
 		thisFrameLoadFlg = true;
 	}
-	else {
-		auto itr = textures.find(fileName);
-		if (itr == textures.end()) {
-			auto tex = std::make_unique<Texture>();
-			tex->Load(fileName, commandList_);
-			if (!tex->isLoad) {
-				return nullptr;
-			}
 
-			textures.insert(std::make_pair(fileName, std::move(tex)));
+	return itr->second.get();
+}
 
-			thisFrameLoadFlg = true;
+Texture* TextureManager::FindTexture(const std::string& fileName) const {
+	auto itr = textures.find(fileName);
+	return itr != textures.end() ? itr->second.get() : nullptr;
+}
+
+DirectX::ScratchImage TextureManager::DecodeTexture(const std::string& fileName) {
+	return Texture::LoadTexture(fileName);
+}
+
+size_t TextureManager::CookTextures(const std::string& directory) {
+	const std::vector<std::string> fileNames = TextureCooker::FindStaleSources(directory);
+	// デコードはファイルごとに並列に行い、圧縮は中で並列に行うので順番に変換する
+	// 一度にデコードするのはスレッド数までにして、デコードした画像を溜めすぎないようにする
+	const size_t batchSize = std::max(std::thread::hardware_concurrency(), 1u);
+	size_t cookNum = 0;
+	for (size_t first = 0; first < fileNames.size(); first += batchSize) {
+		const std::span<const std::string> batch = std::span<const std::string>(fileNames).subspan(first, std::min(batchSize, fileNames.size() - first));
+		std::vector<ImageDecoder::Image> images = ImageDecoder::DecodeFiles(batch);
+		for (size_t i = 0; i < batch.size(); i++) {
+			TextureCache cache;
+			if (images[i].width != 0) {
+				if (TextureCooker::Cook(batch[i], images[i].pixels, images[i].width, images[i].height, static_cast<size_t>(images[i].width) * 4, TextureCooker::Setting{}, cache)
+					&& cache.Save()
+				) {
+					cookNum++;
+				}
+				images[i] = ImageDecoder::Image();
+				continue;
+			}
+
+			// 自前でデコードできない形式はWICで読み込み、RGBA8にそろえた0番のミップから変換する
+			const DirectX::ScratchImage mipImages = Texture::LoadTexture(batch[i]);
+			const DirectX::Image* rgba = mipImages.GetImage(0, 0, 0);
+			if (rgba && rgba->format == DXGI_FORMAT_R8G8B8A8_UNORM_SRGB
+				&& TextureCooker::Cook(batch[i], std::span<const uint8_t>(rgba->pixels, rgba->rowPitch * rgba->height), static_cast<uint32_t>(rgba->width), static_cast<uint32_t>(rgba->height), rgba->rowPitch, TextureCooker::Setting{}, cache)
+				&& cache.Save()
+			) {
+				cookNum++;
+			}
 		}
 	}
+	return cookNum;
+}
 
-	return textures[fileName].get();
+TextureManager::LoadId TextureManager::LoadTextureAsync(const std::string& fileName, int32_t priority, LoadCallback callback) {
+	LoadRequest request;
+	request.fileName = fileName;
+	// 読み込み済みならデコードしない
+	if (!textures.contains(fileName)) {
+		request.job = loader.Request(fileName, priority);
+	}
+	request.callback = std::move(callback);
+
+	const LoadId id = nextLoadId++;
+	loadRequests.insert(std::make_pair(id, std::move(request)));
+	return id;
+}
+
+TextureManager::LoadId TextureManager::LoadTexture(const std::string& fileName, Texture** texPtr) {
+	return LoadTextureAsync(fileName, 0,
+		[texPtr](Texture* texture) {
+			*texPtr = texture;
+		});
 }
 
-void TextureManager::LoadTexture(const std::string& fileName, Texture** texPtr) {
-	if (load.joinable() && threadTextureBuff.empty()) {
-		load.join();
+bool TextureManager::CancelLoad(LoadId id) {
+	auto itr = loadRequests.find(id);
+	if (itr == loadRequests.end()) {
+		return false;
 	}
-	
-	// コンテナに追加
-	threadTextureBuff.push({ fileName, texPtr });
+
+	// 同じファイルの他の要求が残っていればデコードは続く
+	if (itr->second.job) {
+		loader.Cancel(itr->second.job);
+	}
+	loadRequests.erase(itr);
+	return true;
+}
+
+void TextureManager::SetLoadPriority(LoadId id, int32_t priority) {
+	auto itr = loadRequests.find(id);
+	if (itr != loadRequests.end() && itr->second.job) {
+		loader.SetPriority(itr->second.job, priority);
+	}
+}
+
+bool TextureManager::IsLoading(LoadId id) const {
+	return loadRequests.contains(id);
 }
 
-void TextureManager::ThreadLoadTexture() {
-	if (!load.joinable() && !threadTextureBuff.empty()) {
-		auto loadProc = [this]() {
-			while (!threadTextureBuff.empty()) {
-				auto&& front = threadTextureBuff.front();
-				*front.second = LoadTexture(front.first, commandList.Get());
-				threadTextureBuff.pop();
+void TextureManager::UploadLoadedTextures() {
+	if (Engine::GetIsCloseCommandList()) {
+		return;
+	}
+
+	// 要求が残っていなくても受け取って、デコードした画像を解放する
+	// (デコードが終わってから取り消された要求は、ローダーに画像が残っている)
+	std::vector<AsyncLoader<DirectX::ScratchImage>::Handle> loadedJobs = loader.TakeLoaded();
+	if (loadRequests.empty()) {
+		return;
+	}
+
+	// デコードが終わったものを転送する(失敗したものはnullptr。エラーはTextureが出している)
+	std::unordered_map<const AsyncLoader<DirectX::ScratchImage>::Job*, Texture*> uploadedTextures;
+	for (auto& job : loadedJobs) {
+		// 全ての要求が取り消されたものは転送しない
+		const bool isRequested = std::any_of(loadRequests.begin(), loadRequests.end(),
+			[&job](const auto& request) {
+				return request.second.job == job;
+			});
+		if (!isRequested) {
+			continue;
+		}
+
+		DirectX::ScratchImage& mipImages = job->GetResult();
+		Texture* texture = nullptr;
+		if (mipImages.GetImageCount() != 0) {
+			texture = LoadTexture(job->GetKey(), std::move(mipImages));
+		}
+		uploadedTextures.insert(std::make_pair(job.get(), texture));
+	}
+
+	// callbackの中で読み込みを要求されてもいいように、先にコンテナから外す
+	std::vector<std::pair<LoadCallback, Texture*>> finishedRequests;
+	for (auto itr = loadRequests.begin(); itr != loadRequests.end();) {
+		LoadRequest& request = itr->second;
+		Texture* texture = nullptr;
+		if (request.job) {
+			auto uploaded = uploadedTextures.find(request.job.get());
+			if (uploaded == uploadedTextures.end()) {
+				++itr;
+				continue;
 			}
+			texture = uploaded->second;
+		}
+		else {
+			auto loaded = textures.find(request.fileName);
+			texture = loaded == textures.end() ? nullptr : loaded->second.get();
+		}
 
-			isThreadFinish = true;
-		};
+		if (request.callback) {
+			finishedRequests.push_back(std::make_pair(std::move(request.callback), texture));
+		}
+		itr = loadRequests.erase(itr);
+	}
 
-		load = std::thread(loadProc);
+	for (auto& [callback, texture] : finishedRequests) {
+		callback(texture);
 	}
 }
 
-Texture* TextureManager::GetWhiteTex() {
-	return instance->LoadTexture("./Resources/white2x2.png");
+void TextureManager::RequestMip(const Texture* texture, float texelPerPixel) {
+	if (texture == nullptr || !texture->IsStreaming()) {
+		return;
+	}
+	streamer.Request(texture->streamId, TextureStreamer::CalcMip(texelPerPixel));
 }
 
-void TextureManager::ReleaseIntermediateResource() {
-	if (thisFrameLoadFlg && threadTextureBuff.empty()) {
-		for (auto& i : textures) {
-			i.second->ReleaseIntermediateResource();
-		}
+void TextureManager::UpdateStreaming() {
+	if (streamer.GetTextureNum() == 0 || Engine::GetIsCloseCommandList()) {
+		return;
+	}
 
-		thisFrameLoadFlg = false;
+	for (auto& change : streamer.Update()) {
+		streamTextures[change.id]->StreamMip(change.residentMip);
+		thisFrameLoadFlg = true;
 	}
 }
 
-void TextureManager::ResetCommandList() {
-	if (isThreadFinish) {
-		commandList->Close();
-		ID3D12CommandList* commandLists[] = { commandList.Get() };
-		commandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
-		// Fenceの値を更新
-		fenceVal++;
-		// GPUがここまでたどり着いたときに、Fenceの値を指定した値に代入するようにSignalを送る
-		commandQueue->Signal(fence.Get(), fenceVal);
-
-		// Fenceの値が指定したSigna値にたどり着いているか確認する
-		// GetCompletedValueの初期値はFence作成時に渡した初期値
-		if (fence->GetCompletedValue() < fenceVal) {
-			// 指定したSignal値にたどり着いていないので、たどり着くまで待つようにイベントを設定する
-			fence->SetEventOnCompletion(fenceVal, fenceEvent);
-			// イベントを待つ
-			WaitForSingleObject(fenceEvent, INFINITE);
+void TextureManager::Debug(const std::string& guiName) {
+	constexpr float kMegaByte = 1024.0f * 1024.0f;
+
+	ImGui::Begin(guiName.c_str());
+	ImGui::Checkbox("streaming", &isStreaming);
+	float budget = static_cast<float>(streamer.GetBudget()) / kMegaByte;
+	if (ImGui::DragFloat("budget(MB)", &budget, 1.0f, 0.0f, 4096.0f)) {
+		streamer.SetBudget(static_cast<uint64_t>(budget * kMegaByte));
+	}
+	float uploadLimit = static_cast<float>(streamer.GetUploadLimit()) / kMegaByte;
+	if (ImGui::DragFloat("uploadLimit(MB)", &uploadLimit, 0.1f, 0.0f, 256.0f)) {
+		streamer.SetUploadLimit(static_cast<uint64_t>(uploadLimit * kMegaByte));
+	}
+	ImGui::Text("resident %.2f MB (+ min mips %.2f MB)", static_cast<float>(streamer.GetResidentSize()) / kMegaByte, static_cast<float>(streamer.GetMinResidentSize()) / kMegaByte);
+	ImGui::Text("upload %.2f MB / frame", static_cast<float>(streamer.GetUploadSize()) / kMegaByte);
+	ImGui::Text("async load %zu (decode %zu)", loadRequests.size(), loader.GetRequestedNum());
+	for (auto& texture : streamTextures) {
+		if (texture == nullptr) {
+			continue;
 		}
+		ImGui::Text("%s : mip %u (desired %u)", texture->GetFileName().c_str(), texture->GetResidentMip(), streamer.GetDesiredMip(texture->streamId));
+	}
+	ImGui::End();
+}
 
-		load.join();
+Texture* TextureManager::GetWhiteTex() {
+	return instance->LoadTexture("./Resources/white2x2.png");
+}
 
-		// 次フレーム用のコマンドリストを準備
-		auto hr = commandAllocator->Reset();
-		assert(SUCCEEDED(hr));
-		if (!SUCCEEDED(hr)) {
-			ErrorCheck::GetInstance()->ErrorTextBox("CommandAllocator->Reset() Failed", "Engine");
-		}
-		hr = commandList->Reset(commandAllocator.Get(), nullptr);
-		assert(SUCCEEDED(hr));
-		if (!SUCCEEDED(hr)) {
-			ErrorCheck::GetInstance()->ErrorTextBox("CommandList->Reset() Failed", "Engine");
+void TextureManager::ReleaseIntermediateResource() {
+	if (thisFrameLoadFlg) {
+		for (auto& i : textures) {
+			i.second->ReleaseIntermediateResource();
 		}
 
-		isThreadFinish = false;
+		thisFrameLoadFlg = false;
 	}
-}
\ No newline at end of file
+}
@@ -1,13 +1,31 @@
 #pragma once
 #include "Texture/Texture.h"
+#include "TextureStreamer/TextureStreamer.h"
+#include "Utils/AsyncLoader/AsyncLoader.h"
 
 #include <unordered_map>
 #include <string>
 #include <memory>
-#include <queue>
-#include <thread>
+#include <vector>
+#include <functional>
 
 class TextureManager {
+public:
+	/// <summary>
+	/// 非同期読み込みの番号
+	/// </summary>
+	using LoadId = uint64_t;
+	/// <summary>
+	/// 非同期読み込みが終わった時に呼ぶ関数(失敗したらnullptrを渡す)
+	/// </summary>
+	using LoadCallback = std::function<void(Texture*)>;
+
+	static constexpr LoadId kInvalidLoadId = 0u;
+	/// <summary>
+	/// 描画しようとしているテクスチャの読み込みの優先度
+	/// </summary>
+	static constexpr int32_t kVisibleLoadPriority = 100;
+
 private:
 	TextureManager();
 	TextureManager(const TextureManager&) = delete;
@@ -31,50 +49,163 @@ private:
 public:
 	Texture* LoadTexture(const std::string& fileName);
 
-private:
-	Texture* LoadTexture(const std::string& fileName, ID3D12GraphicsCommandList* commandList_);
+	/// <summary>
+	/// DecodeTexture()で読み込んだ画像からテクスチャを作る(読み込み済みなら画像は使わない)
+	/// ストリーミングが有効なら、小さいミップだけを転送して画像は持っておく
+	/// メインスレッドでEngineのコマンドリストが開いている間に呼ぶ
+	/// </summary>
+	/// <param name="fileName">キーにするファイル名</param>
+	/// <param name="mipImages">ミップマップ付きの画像</param>
+	Texture* LoadTexture(const std::string& fileName, DirectX::ScratchImage&& mipImages);
+
+	/// <summary>
+	/// 読み込み済みのテクスチャを探す(読み込まない)
+	/// </summary>
+	/// <returns>無ければnullptr</returns>
+	Texture* FindTexture(const std::string& fileName) const;
+
+	/// <summary>
+	/// 画像ファイルを読み込んでミップマップを作る(GPUを使わないのでワーカースレッドから呼べる)
+	/// </summary>
+	static DirectX::ScratchImage DecodeTexture(const std::string& fileName);
+
+	/// <summary>
+	/// ディレクトリ以下の画像ファイルのうち、キャッシュが無いか古いものをブロック圧縮してキャッシュを書き出す
+	/// 起動時やツールから呼んでおくと、読み込み時に変換しなくて済む
+	/// </summary>
+	/// <param name="directory">探すディレクトリ(サブディレクトリも探す)</param>
+	/// <returns>変換したファイルの数</returns>
+	static size_t CookTextures(const std::string& directory);
 
 public:
 	/// <summary>
-	/// スレッドを分けてロードする用
+	/// 画像のデコードをワーカースレッドで始めてすぐに返す
+	/// デコードが終わったらUploadLoadedTextures()で転送してcallbackを呼ぶ(読み込み済みなら次のUploadLoadedTextures()で呼ぶ)
+	/// 同じファイルを読み込み中ならデコードはまとめる
+	/// </summary>
+	/// <param name="fileName">ファイルパス</param>
+	/// <param name="priority">大きいほど先にデコードする</param>
+	/// <param name="callback">読み込みが終わった時にメインスレッドで呼ぶ関数</param>
+	/// <returns>取り消しや優先度の変更に使う番号</returns>
+	LoadId LoadTextureAsync(const std::string& fileName, int32_t priority = 0, LoadCallback callback = nullptr);
+
+	/// <summary>
+	/// スレッドを分けてロードする用(LoadTextureAsync()で読み込んで、終わったら*texPtrに入れる)
 	/// </summary>
 	/// <param name="fileName"></param>
 	/// <param name="texPtr"></param>
-	void LoadTexture(const std::string& fileName, Texture** texPtr);
+	LoadId LoadTexture(const std::string& fileName, Texture** texPtr);
 
-	void ThreadLoadTexture();
+	/// <summary>
+	/// 非同期読み込みを取り消す(callbackは呼ばない)
+	/// </summary>
+	/// <returns>取り消せたか(読み込みが終わっていたら取り消せない)</returns>
+	bool CancelLoad(LoadId id);
+
+	/// <summary>
+	/// 非同期読み込みの優先度を変える(デコードを待っている間だけ効果がある)
+	/// </summary>
+	void SetLoadPriority(LoadId id, int32_t priority);
+
+	/// <summary>
+	/// 非同期読み込みが終わっていないか
+	/// </summary>
+	bool IsLoading(LoadId id) const;
+
+	/// <summary>
+	/// 終わっていない非同期読み込みの数
+	/// </summary>
+	inline size_t GetLoadingNum() const {
+		return loadRequests.size();
+	}
+
+	/// <summary>
+	/// デコードが終わったテクスチャを転送して、読み込みが終わったcallbackを呼ぶ(取り消されたものは転送せずに捨てる)
+	/// Engineのコマンドリストを閉じる前に毎フレーム呼ぶ
+	/// </summary>
+	void UploadLoadedTextures();
 
 	Texture* GetWhiteTex();
 
 	void ReleaseIntermediateResource();
 
-	bool ThreadLoadFinish() const {
-		return isThreadFinish;
+public:
+	/// <summary>
+	/// 有効にすると、これからLoadTexture(fileName, mipImages)で読み込むテクスチャをストリーミングする
+	/// </summary>
+	inline void SetStreaming(bool isStreaming_) {
+		isStreaming = isStreaming_;
+	}
+	inline bool IsStreaming() const {
+		return isStreaming;
 	}
 
-	inline ID3D12GraphicsCommandList* GetCommandList() const {
-		return commandList.Get();
+	/// <summary>
+	/// ストリーミングで置くミップのバイト数の上限
+	/// </summary>
+	inline void SetStreamingBudget(uint64_t budget) {
+		streamer.SetBudget(budget);
+	}
+	/// <summary>
+	/// ストリーミングで1フレームに転送するバイト数の上限
+	/// </summary>
+	inline void SetStreamingUploadLimit(uint64_t uploadLimit) {
+		streamer.SetUploadLimit(uploadLimit);
 	}
 
-	void ResetCommandList();
+	/// <summary>
+	/// 描画に必要なミップを伝える(ストリーミングしないテクスチャなら何もしない)
+	/// </summary>
+	/// <param name="texture">描画するテクスチャ</param>
+	/// <param name="texelPerPixel">1ピクセルに入るテクセル数(1辺)</param>
+	void RequestMip(const Texture* texture, float texelPerPixel);
 
+	/// <summary>
+	/// 前のフレームの要求から、ストリーミングするテクスチャのミップを入れ替える
+	/// FrameStart()で描画より前に呼ぶ
+	/// </summary>
+	void UpdateStreaming();
 
-private:
-	Microsoft::WRL::ComPtr<ID3D12CommandQueue> commandQueue;
-	Microsoft::WRL::ComPtr<ID3D12CommandAllocator> commandAllocator;
-	Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList;
+	/// <summary>
+	/// ストリーミングの予算と使用量を表示する
+	/// </summary>
+	void Debug(const std::string& guiName);
 
-	Microsoft::WRL::ComPtr<ID3D12Fence> fence;
-	uint64_t fenceVal;
-	HANDLE fenceEvent;
 
+private:
+	/// <summary>
+	/// 非同期読み込みの要求
+	/// </summary>
+	struct LoadRequest {
+		std::string fileName;
+		/// <summary>
+		/// デコード(読み込み済みだったらnullptr)
+		/// </summary>
+		AsyncLoader<DirectX::ScratchImage>::Handle job;
+		LoadCallback callback;
+	};
+
+private:
 	/// <summary>
 	/// Textureのコンテナ(キー値: ファイルネーム  コンテナデータ型: Texture*)
 	/// </summary>
 	std::unordered_map<std::string, std::unique_ptr<Texture>> textures;
 	bool thisFrameLoadFlg;
 
-	std::queue<std::pair<std::string, Texture**>> threadTextureBuff;
-	std::thread load;
-	bool isThreadFinish;
+	/// <summary>
+	/// 画像のデコードをするワーカースレッド
+	/// </summary>
+	AsyncLoader<DirectX::ScratchImage> loader;
+	/// <summary>
+	/// 終わっていない非同期読み込み(キー値: 番号)
+	/// </summary>
+	std::unordered_map<LoadId, LoadRequest> loadRequests;
+	LoadId nextLoadId;
+
+	TextureStreamer streamer;
+	/// <summary>
+	/// ストリーミングするテクスチャ(添え字: TextureStreamerの登録番号)
+	/// </summary>
+	std::vector<Texture*> streamTextures;
+	bool isStreaming;
 };
\ No newline at end of file
@@ -0,0 +1,260 @@
+#include "TextureStreamer.h"
+#include "Engine/ErrorCheck/ErrorCheck.h"
+#include <algorithm>
+#include <cmath>
+#include <cassert>
+
+namespace {
+	// 境界球がカメラに重なっている時の奥行き
+	constexpr float kMinTextureRequestDepth = 0.01f;
+}
+
+TextureStreamer::TextureStreamer() :
+	entries(),
+	freeIds(),
+	changes(),
+	candidates(),
+	budget(256ull * 1024ull * 1024ull),
+	uploadLimit(16ull * 1024ull * 1024ull),
+	residentSize(0u),
+	minResidentSize(0u),
+	uploadSize(0u),
+	frame(0u)
+{}
+
+uint32_t TextureStreamer::Register(uint32_t width, uint32_t height, std::span<const uint64_t> mipSizes) {
+	assert(!mipSizes.empty());
+	if (mipSizes.empty()) {
+		ErrorCheck::GetInstance()->ErrorTextBox("Register() : mipSizes is empty", "TextureStreamer");
+		return kInvalidId;
+	}
+
+	uint32_t id = 0u;
+	if (freeIds.empty()) {
+		id = static_cast<uint32_t>(entries.size());
+		entries.emplace_back();
+	}
+	else {
+		id = freeIds.back();
+		freeIds.pop_back();
+	}
+
+	Entry& entry = entries[id];
+	entry.mipNum = static_cast<uint32_t>(mipSizes.size());
+	entry.residentSizes.assign(mipSizes.size() + 1, 0u);
+	for (size_t mip = mipSizes.size(); 0 < mip; mip--) {
+		entry.residentSizes[mip - 1] = entry.residentSizes[mip] + mipSizes[mip - 1];
+	}
+
+	// 小さいミップだけを最初に置く
+	entry.minResidentMip = entry.mipNum - 1u;
+	for (uint32_t mip = 0; mip < entry.mipNum; mip++) {
+		if (std::max({ width >> mip, height >> mip, 1u }) <= kMinResidentSize) {
+			entry.minResidentMip = mip;
+			break;
+		}
+	}
+	entry.residentMip = entry.minResidentMip;
+	entry.desiredMip = entry.minResidentMip;
+	entry.requestMip = entry.mipNum;
+	entry.lastRequestFrame = frame;
+	entry.changeFrame = frame;
+	entry.isUsed = true;
+
+	minResidentSize += entry.residentSizes[entry.minResidentMip];
+
+	return id;
+}
+
+void TextureStreamer::Unregister(uint32_t id) {
+	assert(id < entries.size() && entries[id].isUsed);
+	if (entries.size() <= id || !entries[id].isUsed) {
+		return;
+	}
+
+	Entry& entry = entries[id];
+	residentSize -= entry.residentSizes[entry.residentMip] - entry.residentSizes[entry.minResidentMip];
+	minResidentSize -= entry.residentSizes[entry.minResidentMip];
+	entry = Entry();
+	freeIds.push_back(id);
+}
+
+void TextureStreamer::Request(uint32_t id, uint32_t mip) {
+	assert(id < entries.size() && entries[id].isUsed);
+	if (entries.size() <= id || !entries[id].isUsed) {
+		return;
+	}
+
+	Entry& entry = entries[id];
+	entry.requestMip = std::min(entry.requestMip, mip);
+}
+
+const std::vector<TextureStreamer::MipChange>& TextureStreamer::Update() {
+	frame++;
+	changes.clear();
+	uploadSize = 0u;
+
+	// このフレームの要求を反映する(要求が途切れてもしばらくは前の要求を使う)
+	for (auto& entry : entries) {
+		if (!entry.isUsed) {
+			continue;
+		}
+		if (entry.requestMip < entry.mipNum) {
+			entry.desiredMip = std::min(entry.requestMip, entry.minResidentMip);
+			entry.lastRequestFrame = frame;
+		}
+		else if (kUnusedFrameNum < frame - entry.lastRequestFrame) {
+			entry.desiredMip = entry.minResidentMip;
+		}
+		entry.requestMip = entry.mipNum;
+	}
+
+	// 予算を下げた時などは、要求より細かいものから粗くして、それでも足りなければ要求されているものも1段ずつ粗くする
+	while (budget < residentSize) {
+		uint32_t id = FindEvictEntry(kInvalidId, false);
+		if (id != kInvalidId) {
+			ChangeResidentMip(id, entries[id].desiredMip);
+			continue;
+		}
+		id = FindEvictEntry(kInvalidId, true);
+		if (id == kInvalidId) {
+			break;
+		}
+		ChangeResidentMip(id, entries[id].residentMip + 1u);
+	}
+
+	// 要求との差が大きいものから1段ずつ細かくする
+	candidates.clear();
+	for (uint32_t id = 0; id < entries.size(); id++) {
+		const Entry& entry = entries[id];
+		if (entry.isUsed && entry.changeFrame != frame && entry.desiredMip < entry.residentMip) {
+			candidates.push_back(id);
+		}
+	}
+	std::sort(candidates.begin(), candidates.end(),
+		[this](uint32_t left, uint32_t right) {
+			const Entry& leftEntry = entries[left];
+			const Entry& rightEntry = entries[right];
+			const uint32_t leftGap = leftEntry.residentMip - leftEntry.desiredMip;
+			const uint32_t rightGap = rightEntry.residentMip - rightEntry.desiredMip;
+			if (leftGap != rightGap) {
+				return rightGap < leftGap;
+			}
+			if (leftEntry.lastRequestFrame != rightEntry.lastRequestFrame) {
+				return rightEntry.lastRequestFrame < leftEntry.lastRequestFrame;
+			}
+			return left < right;
+		}
+	);
+
+	for (uint32_t id : candidates) {
+		const Entry& entry = entries[id];
+		const uint32_t nextMip = entry.residentMip - 1u;
+		const uint64_t growSize = entry.residentSizes[nextMip] - entry.residentSizes[entry.residentMip];
+		if (uploadSize != 0u && uploadLimit < uploadSize + entry.residentSizes[nextMip]) {
+			continue;
+		}
+
+		// 予算が足りなければ、要求より細かいミップを持っているものを粗くする
+		while (budget < residentSize + growSize) {
+			const uint32_t evictId = FindEvictEntry(id, false);
+			if (evictId == kInvalidId) {
+				break;
+			}
+			ChangeResidentMip(evictId, entries[evictId].desiredMip);
+		}
+		if (budget < residentSize + growSize) {
+			continue;
+		}
+
+		ChangeResidentMip(id, nextMip);
+	}
+
+	return changes;
+}
+
+uint32_t TextureStreamer::CalcMip(float texelPerPixel) {
+	// 1ピクセルに1テクセル以下になる一番粗いミップ(NaNも0にする)
+	if (!(1.0f < texelPerPixel)) {
+		return 0u;
+	}
+	return static_cast<uint32_t>(std::min(std::floor(std::log2(texelPerPixel)), 31.0f));
+}
+
+float TextureStreamer::CalcPixelPerLocalUnit(const Mat4x4& viewProjectionMat, const Sphere& localSphere, const Mat4x4& worldMat, float screenHeight) {
+	const Sphere worldSphere = HoriTransformSphere(localSphere, worldMat);
+	const float worldScale = 0.0f < localSphere.radius ? worldSphere.radius / localSphere.radius : 1.0f;
+
+	// 2行目の長さが縦の拡大率(透視投影なら1/tan(fov/2))、4行目がwになる(平行投影なら常に1)
+	const float scaleY = viewProjectionMat[1].GetVector3().Length();
+	const Vector3 depthAxis = viewProjectionMat[3].GetVector3();
+	float depth = viewProjectionMat[3].vec.w;
+	if (depthAxis != Vector3::zero) {
+		depth = std::max(depthAxis.Dot(worldSphere.center) + depth - worldSphere.radius * depthAxis.Length(), kMinTextureRequestDepth);
+	}
+
+	return scaleY * screenHeight * 0.5f / depth * worldScale;
+}
+
+float TextureStreamer::CalcTexelPerPixel(float textureSize, float uvDensity, float pixelPerUnit) {
+	// ローカル座標の1単位に入るテクセル数と、画面上のピクセル数の比
+	return textureSize * uvDensity / pixelPerUnit;
+}
+
+uint32_t TextureStreamer::GetResidentMip(uint32_t id) const {
+	assert(id < entries.size() && entries[id].isUsed);
+	return id < entries.size() ? entries[id].residentMip : 0u;
+}
+
+uint32_t TextureStreamer::GetDesiredMip(uint32_t id) const {
+	assert(id < entries.size() && entries[id].isUsed);
+	return id < entries.size() ? entries[id].desiredMip : 0u;
+}
+
+uint64_t TextureStreamer::CalcResidentSize(uint32_t id, uint32_t mip) const {
+	assert(id < entries.size() && entries[id].isUsed);
+	if (entries.size() <= id || !entries[id].isUsed) {
+		return 0u;
+	}
+	const Entry& entry = entries[id];
+	return entry.residentSizes[std::min(mip, entry.mipNum)];
+}
+
+uint32_t TextureStreamer::FindEvictEntry(uint32_t excludeId, bool isForce) const {
+	// 長く使われていないもの、同じなら空くバイト数が多いものを選ぶ
+	uint32_t bestId = kInvalidId;
+	uint64_t bestFrame = 0u;
+	uint64_t bestSize = 0u;
+	for (uint32_t id = 0; id < entries.size(); id++) {
+		const Entry& entry = entries[id];
+		if (!entry.isUsed || id == excludeId || entry.changeFrame == frame) {
+			continue;
+		}
+
+		const uint32_t limitMip = isForce ? entry.minResidentMip : entry.desiredMip;
+		if (limitMip <= entry.residentMip) {
+			continue;
+		}
+		const uint32_t evictMip = isForce ? entry.residentMip + 1u : entry.desiredMip;
+		const uint64_t evictSize = entry.residentSizes[entry.residentMip] - entry.residentSizes[evictMip];
+
+		if (bestId == kInvalidId || entry.lastRequestFrame < bestFrame ||
+			(entry.lastRequestFrame == bestFrame && bestSize < evictSize)) {
+			bestId = id;
+			bestFrame = entry.lastRequestFrame;
+			bestSize = evictSize;
+		}
+	}
+	return bestId;
+}
+
+void TextureStreamer::ChangeResidentMip(uint32_t id, uint32_t mip) {
+	Entry& entry = entries[id];
+	residentSize = residentSize + entry.residentSizes[mip] - entry.residentSizes[entry.residentMip];
+	// 入れ替えたテクスチャは置くミップを全て転送し直す
+	uploadSize += entry.residentSizes[mip];
+
+	entry.residentMip = mip;
+	entry.changeFrame = frame;
+	changes.push_back({ id, mip });
+}
@@ -0,0 +1,205 @@
+#pragma once
+#include "Utils/Math/Mat4x4.h"
+#include "Utils/Math/Bounds.h"
+#include <vector>
+#include <span>
+#include <cstdint>
+
+/// <summary>
+/// テクスチャのミップをVRAMの予算内で入れ替える(GPUは使わず、どのミップを置くかだけを決める)
+/// 登録時は小さいミップだけを置き、描画時に要求されたミップに向けて1フレームに1段ずつ細かくする
+/// 予算を超える時は要求より細かいミップを持っているテクスチャを、長く使われていない順に粗くする
+/// </summary>
+class TextureStreamer final {
+public:
+	static constexpr uint32_t kInvalidId = 0xffffffffu;
+
+	/// <summary>
+	/// 大きさがこれ以下のミップは登録時に置いて、予算に関係なく外さない
+	/// </summary>
+	static constexpr uint32_t kMinResidentSize = 64u;
+
+	/// <summary>
+	/// 要求が無くなってから、最小のミップだけで良いことにするまでのフレーム数
+	/// </summary>
+	static constexpr uint32_t kUnusedFrameNum = 120u;
+
+	/// <summary>
+	/// Update()で置くミップを変えたテクスチャ
+	/// </summary>
+	struct MipChange {
+		uint32_t id = kInvalidId;
+		/// <summary>
+		/// 新しく置く一番細かいミップ(これより粗いミップは全て置く)
+		/// </summary>
+		uint32_t residentMip = 0u;
+	};
+
+private:
+	struct Entry {
+		/// <summary>
+		/// そのミップから一番粗いミップまでのバイト数(mipNum番は0)
+		/// </summary>
+		std::vector<uint64_t> residentSizes;
+		uint32_t mipNum = 0u;
+
+		/// <summary>
+		/// これより粗いミップは常に置く
+		/// </summary>
+		uint32_t minResidentMip = 0u;
+		uint32_t residentMip = 0u;
+		/// <summary>
+		/// 最後に要求されたミップ(要求が無い時はminResidentMip)
+		/// </summary>
+		uint32_t desiredMip = 0u;
+		/// <summary>
+		/// このフレームで要求された一番細かいミップ(要求が無ければmipNum)
+		/// </summary>
+		uint32_t requestMip = 0u;
+
+		uint64_t lastRequestFrame = 0u;
+		/// <summary>
+		/// 登録したフレーム、最後に入れ替えたフレーム(同じフレームで2回変えない)
+		/// </summary>
+		uint64_t changeFrame = 0u;
+
+		bool isUsed = false;
+	};
+
+public:
+	TextureStreamer();
+	TextureStreamer(const TextureStreamer&) = default;
+	TextureStreamer(TextureStreamer&&) noexcept = default;
+	~TextureStreamer() = default;
+
+	TextureStreamer& operator=(const TextureStreamer&) = default;
+	TextureStreamer& operator=(TextureStreamer&&) noexcept = default;
+
+public:
+	/// <summary>
+	/// テクスチャを登録する(小さいミップだけを置いた状態になる。置くミップはGetResidentMip()で受け取る)
+	/// </summary>
+	/// <param name="width">ミップ0の幅</param>
+	/// <param name="height">ミップ0の高さ</param>
+	/// <param name="mipSizes">ミップごとのバイト数(0番が一番細かい)</param>
+	/// <returns>登録番号</returns>
+	uint32_t Register(uint32_t width, uint32_t height, std::span<const uint64_t> mipSizes);
+
+	void Unregister(uint32_t id);
+
+	/// <summary>
+	/// 描画に必要なミップを伝える(同じフレームで複数回呼ぶと一番細かいミップになる)
+	/// </summary>
+	void Request(uint32_t id, uint32_t mip);
+
+	/// <summary>
+	/// このフレームの要求から置くミップを決める(1フレームに1回呼ぶ)
+	/// </summary>
+	/// <returns>置くミップを変えたテクスチャ(次のUpdate()まで有効)</returns>
+	const std::vector<MipChange>& Update();
+
+	/// <summary>
+	/// 1テクセルが画面上で何ピクセルに当たるかから必要なミップを求める
+	/// </summary>
+	/// <param name="texelPerPixel">1ピクセルに入るテクセル数(1辺)</param>
+	static uint32_t CalcMip(float texelPerPixel);
+
+	/// <summary>
+	/// 境界球のカメラに一番近い所で、ローカル座標の1単位が画面上で何ピクセルになるか
+	/// </summary>
+	/// <param name="viewProjectionMat">縦ベクトル用のビュープロジェクション行列</param>
+	/// <param name="localSphere">ローカル座標の境界球</param>
+	/// <param name="worldMat">横ベクトル用のワールド行列</param>
+	/// <param name="screenHeight">画面の高さ(ピクセル)</param>
+	static float CalcPixelPerLocalUnit(const Mat4x4& viewProjectionMat, const Sphere& localSphere, const Mat4x4& worldMat, float screenHeight);
+
+	/// <summary>
+	/// 1ピクセルに入るテクセル数(CalcMip()に渡す)
+	/// </summary>
+	/// <param name="textureSize">ミップ0の長い方の辺</param>
+	/// <param name="uvDensity">形状の1単位あたりのUVの大きさ</param>
+	/// <param name="pixelPerUnit">CalcPixelPerLocalUnit()</param>
+	static float CalcTexelPerPixel(float textureSize, float uvDensity, float pixelPerUnit);
+
+public:
+	/// <summary>
+	/// 置いているミップのバイト数の上限(最小のミップは含めない)
+	/// </summary>
+	inline void SetBudget(uint64_t budget_) {
+		budget = budget_;
+	}
+	inline uint64_t GetBudget() const {
+		return budget;
+	}
+
+	/// <summary>
+	/// 1フレームで転送するバイト数の上限(入れ替えたテクスチャは置いているミップを全て転送し直す)
+	/// 1つで上限を超えるテクスチャも、そのフレームで最初なら転送する
+	/// </summary>
+	inline void SetUploadLimit(uint64_t uploadLimit_) {
+		uploadLimit = uploadLimit_;
+	}
+	inline uint64_t GetUploadLimit() const {
+		return uploadLimit;
+	}
+
+	/// <summary>
+	/// 置いているミップのバイト数(最小のミップは含めない)
+	/// </summary>
+	inline uint64_t GetResidentSize() const {
+		return residentSize;
+	}
+	/// <summary>
+	/// 最小のミップのバイト数
+	/// </summary>
+	inline uint64_t GetMinResidentSize() const {
+		return minResidentSize;
+	}
+	/// <summary>
+	/// 前のUpdate()で転送することにしたバイト数
+	/// </summary>
+	inline uint64_t GetUploadSize() const {
+		return uploadSize;
+	}
+
+	uint32_t GetResidentMip(uint32_t id) const;
+	uint32_t GetDesiredMip(uint32_t id) const;
+
+	/// <summary>
+	/// ミップを置いた時のバイト数(これより粗いミップも含める)
+	/// </summary>
+	uint64_t CalcResidentSize(uint32_t id, uint32_t mip) const;
+
+	inline size_t GetTextureNum() const {
+		return entries.size() - freeIds.size();
+	}
+
+private:
+	/// <summary>
+	/// 予算を空けるために粗くするテクスチャを探す
+	/// </summary>
+	/// <param name="excludeId">粗くしないテクスチャ</param>
+	/// <param name="isForce">要求されているミップより粗くしてもよいか</param>
+	/// <returns>見つからなければkInvalidId</returns>
+	uint32_t FindEvictEntry(uint32_t excludeId, bool isForce) const;
+
+	/// <summary>
+	/// 置くミップを変えて、予算と変更リストに反映する
+	/// </summary>
+	void ChangeResidentMip(uint32_t id, uint32_t mip);
+
+private:
+	std::vector<Entry> entries;
+	std::vector<uint32_t> freeIds;
+
+	std::vector<MipChange> changes;
+	std::vector<uint32_t> candidates;
+
+	uint64_t budget;
+	uint64_t uploadLimit;
+	uint64_t residentSize;
+	uint64_t minResidentSize;
+	uint64_t uploadSize;
+
+	uint64_t frame;
+};
@@ -0,0 +1,350 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <set>
+#include <unordered_map>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
+
+/// <summary>
+/// キーごとの読み込みを、常駐するワーカースレッドで優先度の高い順に行う(どのスレッドからでも呼べる)
+/// 同じキーの読み込みが待っているか読み込み中なら要求をまとめ、全ての要求が取り消されたら結果を捨てる
+/// 読み込みが終わったものはTakeLoaded()で受け取る(GPUへの転送などは受け取った側で行う)
+/// </summary>
+/// <typeparam name="Result">読み込み結果(ムーブできる型)</typeparam>
+template<class Result>
+class AsyncLoader final {
+public:
+	enum class State : uint32_t {
+		Queued,
+		Loading,
+		Loaded,
+		Canceled
+	};
+
+	/// <summary>
+	/// 1つのキーの読み込み
+	/// </summary>
+	class Job {
+		friend AsyncLoader;
+
+	public:
+		Job(const std::string& key_, int32_t priority_, uint64_t order_) :
+			key(key_),
+			state(State::Queued),
+			priority(priority_),
+			order(order_),
+			requestNum(1u),
+			result()
+		{}
+
+	public:
+		inline const std::string& GetKey() const {
+			return key;
+		}
+
+		inline State GetState() const {
+			return state.load(std::memory_order_acquire);
+		}
+
+		/// <summary>
+		/// TakeLoaded()で受け取った後だけ使える
+		/// </summary>
+		inline Result& GetResult() {
+			return result;
+		}
+
+	private:
+		std::string key;
+		std::atomic<State> state;
+
+		// ここから下はAsyncLoaderのmutexで守る
+		int32_t priority;
+		/// <summary>
+		/// 同じ優先度なら先に要求した順
+		/// </summary>
+		uint64_t order;
+		/// <summary>
+		/// 取り消されていない要求の数(0なら読み込み終わっても捨てる)
+		/// </summary>
+		uint32_t requestNum;
+		Result result;
+	};
+
+	using Handle = std::shared_ptr<Job>;
+	using LoadFunc = std::function<Result(const std::string&)>;
+
+public:
+	/// <param name="loadFunc_">ワーカースレッドで呼ぶ読み込み関数</param>
+	/// <param name="threadNum">ワーカースレッド数(0ならメインスレッドの分を除いたハードウェアのスレッド数)</param>
+	AsyncLoader(LoadFunc loadFunc_, uint32_t threadNum = 0) :
+		loadFunc(std::move(loadFunc_)),
+		mutex(),
+		workerCondition(),
+		idleCondition(),
+		finishCondition(),
+		queue(),
+		requestedJobs(),
+		loadedJobs(),
+		loadingNum(0u),
+		nextOrder(0u),
+		isStop(false),
+		workers()
+	{
+		if (threadNum == 0) {
+			threadNum = std::max(std::thread::hardware_concurrency(), 2u) - 1u;
+		}
+		workers.reserve(threadNum);
+		for (uint32_t i = 0; i < threadNum; i++) {
+			workers.emplace_back(&AsyncLoader::WorkerProc, this);
+		}
+	}
+	AsyncLoader(const AsyncLoader&) = delete;
+	AsyncLoader(AsyncLoader&&) = delete;
+	/// <summary>
+	/// 待っている読み込みは取り消し、読み込み中のものは終わるまで待つ
+	/// </summary>
+	~AsyncLoader() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			isStop = true;
+			for (auto& job : queue) {
+				job->state.store(State::Canceled, std::memory_order_release);
+			}
+			queue.clear();
+		}
+		workerCondition.notify_all();
+		finishCondition.notify_all();
+		for (auto& worker : workers) {
+			worker.join();
+		}
+	}
+
+	AsyncLoader& operator=(const AsyncLoader&) = delete;
+	AsyncLoader& operator=(AsyncLoader&&) = delete;
+
+public:
+	/// <summary>
+	/// 読み込みを要求する(同じキーが待っているか読み込み中なら、それを返して優先度を上げる)
+	/// </summary>
+	/// <param name="key">読み込み関数に渡すキー</param>
+	/// <param name="priority">大きいほど先に読み込む</param>
+	Handle Request(const std::string& key, int32_t priority = 0) {
+		std::unique_lock<std::mutex> lock(mutex);
+		auto itr = requestedJobs.find(key);
+		if (itr != requestedJobs.end()) {
+			Handle job = itr->second;
+			job->requestNum++;
+			if (job->priority < priority) {
+				SetPriorityLocked(job, priority);
+			}
+			return job;
+		}
+
+		Handle job = std::make_shared<Job>(key, priority, nextOrder++);
+		queue.insert(job);
+		requestedJobs.emplace(key, job);
+		lock.unlock();
+
+		workerCondition.notify_one();
+		return job;
+	}
+
+	/// <summary>
+	/// 要求を1つ取り消す(全ての要求が取り消されたら、待っているなら読み込まず、読み込み中なら結果を捨てる)
+	/// </summary>
+	/// <returns>取り消せたか(読み込み終わっていたら取り消せない)</returns>
+	bool Cancel(const Handle& job) {
+		std::lock_guard<std::mutex> lock(mutex);
+		const State state = job->GetState();
+		if ((state != State::Queued && state != State::Loading) || job->requestNum == 0) {
+			return false;
+		}
+
+		job->requestNum--;
+		if (job->requestNum == 0 && state == State::Queued) {
+			queue.erase(job);
+			requestedJobs.erase(job->key);
+			job->state.store(State::Canceled, std::memory_order_release);
+			NotifyIdleLocked();
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// 待っている間だけ要求を1つ取り消す(読み込み中なら何もしない。要求した側で同じものを読み込み直すときに使う)
+	/// </summary>
+	/// <returns>取り消せたか</returns>
+	bool CancelIfQueued(const Handle& job) {
+		std::lock_guard<std::mutex> lock(mutex);
+		if (job->GetState() != State::Queued || job->requestNum == 0) {
+			return false;
+		}
+
+		job->requestNum--;
+		if (job->requestNum == 0) {
+			queue.erase(job);
+			requestedJobs.erase(job->key);
+			job->state.store(State::Canceled, std::memory_order_release);
+			NotifyIdleLocked();
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// 読み込みが終わるか取り消されるまで待つ(結果はTakeLoaded()で受け取る)
+	/// </summary>
+	void Wait(const Handle& job) {
+		std::unique_lock<std::mutex> lock(mutex);
+		finishCondition.wait(lock,
+			[&job]() {
+				const State state = job->GetState();
+				return state != State::Queued && state != State::Loading;
+			}
+		);
+	}
+
+	/// <summary>
+	/// 優先度を変える(待っている間だけ効果がある)
+	/// </summary>
+	void SetPriority(const Handle& job, int32_t priority) {
+		std::lock_guard<std::mutex> lock(mutex);
+		if (job->priority != priority) {
+			SetPriorityLocked(job, priority);
+		}
+	}
+
+	/// <summary>
+	/// 読み込みが終わったものを受け取る(取り消されたものは含まない)
+	/// </summary>
+	std::vector<Handle> TakeLoaded() {
+		std::vector<Handle> result;
+		std::lock_guard<std::mutex> lock(mutex);
+		result.swap(loadedJobs);
+		return result;
+	}
+
+	/// <summary>
+	/// 待っている読み込みと読み込み中のものが無くなるまで待つ
+	/// </summary>
+	void WaitIdle() {
+		std::unique_lock<std::mutex> lock(mutex);
+		idleCondition.wait(lock, [this]() { return queue.empty() && loadingNum == 0; });
+	}
+
+	/// <summary>
+	/// 待っている読み込みと読み込み中のものの数
+	/// </summary>
+	size_t GetRequestedNum() const {
+		std::lock_guard<std::mutex> lock(mutex);
+		return requestedJobs.size();
+	}
+
+	uint32_t GetThreadNum() const {
+		return static_cast<uint32_t>(workers.size());
+	}
+
+private:
+	void SetPriorityLocked(const Handle& job, int32_t priority) {
+		// 並び順が変わるので、入れ直す
+		if (job->GetState() == State::Queued) {
+			queue.erase(job);
+			job->priority = priority;
+			queue.insert(job);
+		}
+		else {
+			job->priority = priority;
+		}
+	}
+
+	void NotifyIdleLocked() {
+		if (queue.empty() && loadingNum == 0) {
+			idleCondition.notify_all();
+		}
+	}
+
+	void WorkerProc() {
+		std::unique_lock<std::mutex> lock(mutex);
+		while (true) {
+			workerCondition.wait(lock, [this]() { return isStop || !queue.empty(); });
+			if (isStop) {
+				return;
+			}
+
+			Handle job = *queue.begin();
+			queue.erase(queue.begin());
+			job->state.store(State::Loading, std::memory_order_release);
+			loadingNum++;
+			lock.unlock();
+
+			Result result = loadFunc(job->key);
+
+			lock.lock();
+			loadingNum--;
+			requestedJobs.erase(job->key);
+			if (job->requestNum == 0) {
+				job->state.store(State::Canceled, std::memory_order_release);
+				NotifyIdleLocked();
+				finishCondition.notify_all();
+				// 捨てる結果の解放はロックの外で行う
+				lock.unlock();
+				result = Result();
+				lock.lock();
+				continue;
+			}
+			job->result = std::move(result);
+			job->state.store(State::Loaded, std::memory_order_release);
+			loadedJobs.push_back(std::move(job));
+			NotifyIdleLocked();
+			finishCondition.notify_all();
+		}
+	}
+
+private:
+	/// <summary>
+	/// 優先度の高い順、同じなら要求した順
+	/// </summary>
+	struct Compare {
+		bool operator()(const Handle& left, const Handle& right) const {
+			if (left->priority != right->priority) {
+				return right->priority < left->priority;
+			}
+			return left->order < right->order;
+		}
+	};
+
+private:
+	LoadFunc loadFunc;
+
+	mutable std::mutex mutex;
+	std::condition_variable workerCondition;
+	std::condition_variable idleCondition;
+	/// <summary>
+	/// 1つの読み込みが終わるたびに知らせる(Wait()用)
+	/// </summary>
+	std::condition_variable finishCondition;
+
+	/// <summary>
+	/// 待っている読み込み
+	/// </summary>
+	std::set<Handle, Compare> queue;
+	/// <summary>
+	/// 待っているか読み込み中のもの(キー値: キー)
+	/// </summary>
+	std::unordered_map<std::string, Handle> requestedJobs;
+	/// <summary>
+	/// 読み込みが終わってTakeLoaded()を待っているもの
+	/// </summary>
+	std::vector<Handle> loadedJobs;
+	uint32_t loadingNum;
+	uint64_t nextOrder;
+	bool isStop;
+
+	std::vector<std::thread> workers;
+};
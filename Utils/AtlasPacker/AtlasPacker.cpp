@@ -0,0 +1,199 @@
+#include "AtlasPacker.h"
+#include <algorithm>
+#include <numeric>
+
+namespace {
+	bool IsContained(const AtlasPacker::Rect& inner, const AtlasPacker::Rect& outer) {
+		return outer.x <= inner.x && outer.y <= inner.y
+			&& inner.x + inner.width <= outer.x + outer.width
+			&& inner.y + inner.height <= outer.y + outer.height;
+	}
+
+	bool IsIntersected(const AtlasPacker::Rect& left, const AtlasPacker::Rect& right) {
+		return left.x < right.x + right.width && right.x < left.x + left.width
+			&& left.y < right.y + right.height && right.y < left.y + left.height;
+	}
+
+	/// <summary>
+	/// 1ページ分の空き領域(重なりを許した、極大な空き矩形の集まり)
+	/// </summary>
+	class MaxRectsPage {
+	public:
+		MaxRectsPage(uint32_t width, uint32_t height) :
+			freeRects{ AtlasPacker::Rect{ 0u, 0u, width, height } },
+			newRects()
+		{}
+
+	public:
+		/// <summary>
+		/// 短い辺の余りが一番小さい空きを探す(同じなら長い辺の余りで比べる)
+		/// </summary>
+		/// <returns>置けるか</returns>
+		bool Find(uint32_t width, uint32_t height, AtlasPacker::Rect& rect, uint64_t& score) const {
+			bool isFound = false;
+			for (const auto& freeRect : freeRects) {
+				if (freeRect.width < width || freeRect.height < height) {
+					continue;
+				}
+				const uint32_t restWidth = freeRect.width - width;
+				const uint32_t restHeight = freeRect.height - height;
+				const uint64_t freeScore = (static_cast<uint64_t>(std::min(restWidth, restHeight)) << 32) | std::max(restWidth, restHeight);
+				if (!isFound || freeScore < score) {
+					rect = { freeRect.x, freeRect.y, width, height };
+					score = freeScore;
+					isFound = true;
+				}
+			}
+			return isFound;
+		}
+
+		/// <summary>
+		/// 置いた矩形と重なる空きを、重ならない残りの部分に分ける
+		/// </summary>
+		void Place(const AtlasPacker::Rect& used) {
+			newRects.clear();
+			for (size_t i = 0; i < freeRects.size();) {
+				const AtlasPacker::Rect freeRect = freeRects[i];
+				if (!IsIntersected(freeRect, used)) {
+					i++;
+					continue;
+				}
+
+				if (freeRect.x < used.x) {
+					newRects.push_back({ freeRect.x, freeRect.y, used.x - freeRect.x, freeRect.height });
+				}
+				if (used.x + used.width < freeRect.x + freeRect.width) {
+					newRects.push_back({ used.x + used.width, freeRect.y, freeRect.x + freeRect.width - (used.x + used.width), freeRect.height });
+				}
+				if (freeRect.y < used.y) {
+					newRects.push_back({ freeRect.x, freeRect.y, freeRect.width, used.y - freeRect.y });
+				}
+				if (used.y + used.height < freeRect.y + freeRect.height) {
+					newRects.push_back({ freeRect.x, used.y + used.height, freeRect.width, freeRect.y + freeRect.height - (used.y + used.height) });
+				}
+
+				freeRects[i] = freeRects.back();
+				freeRects.pop_back();
+			}
+
+			Prune();
+		}
+
+	private:
+		/// <summary>
+		/// 他の空きに含まれる空きを消す
+		/// 元からある空きは互いに含まれず、分けてできた空きにも含まれないので、分けてできた空きだけを消せばよい
+		/// </summary>
+		void Prune() {
+			for (size_t i = 0; i < newRects.size();) {
+				bool isContained = false;
+				for (size_t j = 0; j < newRects.size(); j++) {
+					if (i != j && IsContained(newRects[i], newRects[j])
+						// 同じ矩形が2つあれば、後ろの方を残す
+						&& !(j < i && IsContained(newRects[j], newRects[i]))
+					) {
+						isContained = true;
+						break;
+					}
+				}
+				if (!isContained) {
+					isContained = std::any_of(freeRects.begin(), freeRects.end(),
+						[&newRect = newRects[i]](const AtlasPacker::Rect& freeRect) {
+							return IsContained(newRect, freeRect);
+						});
+				}
+
+				if (isContained) {
+					newRects[i] = newRects.back();
+					newRects.pop_back();
+				}
+				else {
+					i++;
+				}
+			}
+
+			freeRects.insert(freeRects.end(), newRects.begin(), newRects.end());
+		}
+
+	private:
+		std::vector<AtlasPacker::Rect> freeRects;
+		/// <summary>
+		/// Place()で分けてできた空き(作業用)
+		/// </summary>
+		std::vector<AtlasPacker::Rect> newRects;
+	};
+}
+
+std::vector<AtlasPacker::Placement> AtlasPacker::Pack(std::span<const Size> sizes, const Setting& setting, uint32_t& pageNum) {
+	std::vector<Placement> placements(sizes.size());
+	pageNum = 0;
+
+	// 区画が揃うように、ページの大きさも揃えの倍数に切り捨てる
+	const uint32_t alignment = std::max(setting.alignment, 1u);
+	const uint32_t pageWidth = setting.pageWidth / alignment * alignment;
+	const uint32_t pageHeight = setting.pageHeight / alignment * alignment;
+
+	// 大きいものから置いた方が隙間が少なくなる
+	std::vector<uint32_t> order(sizes.size());
+	std::iota(order.begin(), order.end(), 0u);
+	std::stable_sort(order.begin(), order.end(),
+		[&sizes](uint32_t left, uint32_t right) {
+			const uint32_t leftMax = std::max(sizes[left].width, sizes[left].height);
+			const uint32_t rightMax = std::max(sizes[right].width, sizes[right].height);
+			if (leftMax != rightMax) {
+				return rightMax < leftMax;
+			}
+			return std::min(sizes[right].width, sizes[right].height) < std::min(sizes[left].width, sizes[left].height);
+		});
+
+	std::vector<MaxRectsPage> pages;
+	for (uint32_t index : order) {
+		const Size size = sizes[index];
+		const Size cell = CalcCellSize(size, setting);
+		if (size.width == 0 || size.height == 0 || pageWidth < cell.width || pageHeight < cell.height) {
+			continue;
+		}
+
+		// 前のページから順に空きを探し、どこにも無ければページを増やす
+		Rect rect;
+		uint64_t score = 0;
+		uint32_t page = 0;
+		for (; page < pages.size(); page++) {
+			if (pages[page].Find(cell.width, cell.height, rect, score)) {
+				break;
+			}
+		}
+		if (page == pages.size()) {
+			if (setting.maxPageNum <= pages.size()) {
+				continue;
+			}
+			pages.emplace_back(pageWidth, pageHeight);
+			pages.back().Find(cell.width, cell.height, rect, score);
+		}
+
+		pages[page].Place(rect);
+		placements[index].page = page;
+		placements[index].rect = { rect.x + setting.padding, rect.y + setting.padding, size.width, size.height };
+	}
+
+	pageNum = static_cast<uint32_t>(pages.size());
+	return placements;
+}
+
+AtlasPacker::Size AtlasPacker::CalcCellSize(Size size, const Setting& setting) {
+	const uint32_t alignment = std::max(setting.alignment, 1u);
+	return {
+		(size.width + setting.padding * 2 + alignment - 1) / alignment * alignment,
+		(size.height + setting.padding * 2 + alignment - 1) / alignment * alignment
+	};
+}
+
+uint32_t AtlasPacker::CalcSafeMipNum(const Setting& setting) {
+	// ミップkでは区画の端が2^kの倍数に乗り、隙間がpadding / 2^kテクセルになる
+	const uint32_t alignment = std::max(setting.alignment, 1u);
+	uint32_t mipNum = 1;
+	for (uint32_t step = 2; alignment % step == 0 && step <= setting.padding * 2; step *= 2) {
+		mipNum++;
+	}
+	return mipNum;
+}
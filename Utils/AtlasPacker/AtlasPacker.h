@@ -0,0 +1,76 @@
+#pragma once
+#include <vector>
+#include <span>
+#include <cstdint>
+
+/// <summary>
+/// 矩形をMaxRects法でページに詰める(画素は扱わないので、オフラインでも読み込み時でも使える)
+/// 各矩形は周りにpaddingの隙間を付けた上でalignmentの倍数の区画に置くので、ミップを下げても隣の画像がにじまない
+/// 入りきらなければページを増やす
+/// </summary>
+class AtlasPacker final {
+public:
+	struct Size {
+		uint32_t width = 0;
+		uint32_t height = 0;
+	};
+
+	struct Rect {
+		uint32_t x = 0;
+		uint32_t y = 0;
+		uint32_t width = 0;
+		uint32_t height = 0;
+	};
+
+	/// <summary>
+	/// 置いた場所
+	/// </summary>
+	struct Placement {
+		/// <summary>
+		/// 置いたページ(置けなかったらkInvalidPage)
+		/// </summary>
+		uint32_t page = 0xffffffffu;
+		/// <summary>
+		/// 画像の範囲(隙間は含まない)
+		/// </summary>
+		Rect rect;
+	};
+
+	struct Setting {
+		uint32_t pageWidth = 2048;
+		uint32_t pageHeight = 2048;
+		/// <summary>
+		/// 画像の周りの隙間(画像の端を引き延ばして埋める)
+		/// </summary>
+		uint32_t padding = 4;
+		/// <summary>
+		/// 区画の位置と大きさの揃え(2の累乗)
+		/// </summary>
+		uint32_t alignment = 8;
+		uint32_t maxPageNum = 4;
+	};
+
+public:
+	static constexpr uint32_t kInvalidPage = 0xffffffffu;
+
+public:
+	/// <summary>
+	/// 矩形を詰める(大きいものから順に、短い辺の余りが一番小さい空きに置く)
+	/// </summary>
+	/// <param name="sizes">画像の大きさ</param>
+	/// <param name="setting">詰め方の設定</param>
+	/// <param name="pageNum">使ったページ数</param>
+	/// <returns>sizesと同じ順番の置いた場所</returns>
+	static std::vector<Placement> Pack(std::span<const Size> sizes, const Setting& setting, uint32_t& pageNum);
+
+	/// <summary>
+	/// 画像を区画に広げた大きさ(隙間を付けてalignmentの倍数に切り上げる)
+	/// </summary>
+	static Size CalcCellSize(Size size, const Setting& setting);
+
+	/// <summary>
+	/// 隣の画像がにじまずに作れる、0番も含めたミップの数
+	/// 区画の端がミップのテクセルの境目に乗り、バイリニアで読む半テクセル分が隙間に収まるところまで
+	/// </summary>
+	static uint32_t CalcSafeMipNum(const Setting& setting);
+};
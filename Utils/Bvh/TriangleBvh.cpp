@@ -0,0 +1,503 @@
+#include "TriangleBvh.h"
+#include "Engine/ErrorCheck/ErrorCheck.h"
+#include <algorithm>
+#include <cmath>
+#include <cassert>
+#include <immintrin.h>
+
+namespace {
+	constexpr uint32_t kInvalidIndex = std::numeric_limits<uint32_t>::max();
+
+	// 0の成分は逆数が無限大になり、0 * 無限大でNaNが出るので、これより小さい成分はこの値にする
+	constexpr float kMinDirection = 1.0e-20f;
+
+	/// <summary>
+	/// 作る途中の2分木のノード
+	/// </summary>
+	struct BuildNode {
+		AABB bounds;
+		// 内部ノードの子(葉ならkInvalidIndex)
+		uint32_t left = kInvalidIndex;
+		uint32_t right = kInvalidIndex;
+		// 葉の三角形の範囲(並び替えた三角形の番号)
+		uint32_t first = 0;
+		uint32_t count = 0;
+
+		bool IsLeaf() const noexcept {
+			return left == kInvalidIndex;
+		}
+	};
+
+	float CalcSurfaceArea(const AABB& aabb) noexcept {
+		if (aabb.IsEmpty()) {
+			return 0.0f;
+		}
+		const Vector3 size = aabb.max - aabb.min;
+		return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+	}
+
+	void Merge(AABB& aabb, const AABB& right) noexcept {
+		aabb.Extend(right.min);
+		aabb.Extend(right.max);
+	}
+
+	float GetAxis(const Vector3& vec, uint32_t axis) noexcept {
+		return axis == 0 ? vec.x : (axis == 1 ? vec.y : vec.z);
+	}
+
+	/// <summary>
+	/// 2分木を作る(三角形の番号をorderの中で葉ごとに連続するように並び替える)
+	/// </summary>
+	class BvhBuilder {
+	public:
+		BvhBuilder(std::span<const AABB> triangleBounds_, std::span<const Vector3> centers_) :
+			triangleBounds(triangleBounds_),
+			centers(centers_),
+			order(triangleBounds_.size()),
+			nodes()
+		{
+			for (size_t i = 0; i < order.size(); i++) {
+				order[i] = static_cast<uint32_t>(i);
+			}
+			nodes.reserve(triangleBounds_.size() * 2 / TriangleBvh::kMaxLeafTriangleNum + 1);
+			Build(0u, static_cast<uint32_t>(order.size()), 0u);
+		}
+
+	public:
+		std::span<const uint32_t> GetOrder() const noexcept {
+			return order;
+		}
+		std::span<const BuildNode> GetNodes() const noexcept {
+			return nodes;
+		}
+
+	private:
+		uint32_t Build(uint32_t first, uint32_t count, uint32_t depth) {
+			const uint32_t nodeIndex = static_cast<uint32_t>(nodes.size());
+			nodes.emplace_back();
+
+			AABB bounds;
+			AABB centerBounds;
+			for (uint32_t i = first; i < first + count; i++) {
+				Merge(bounds, triangleBounds[order[i]]);
+				centerBounds.Extend(centers[order[i]]);
+			}
+			nodes[nodeIndex].bounds = bounds;
+
+			if (count <= TriangleBvh::kMaxLeafTriangleNum) {
+				nodes[nodeIndex].first = first;
+				nodes[nodeIndex].count = count;
+				return nodeIndex;
+			}
+
+			// 残りの深さで中央分割しても葉まで届かなくなるならSAHをやめて中央で分ける
+			uint32_t medianDepth = 0;
+			for (uint32_t num = TriangleBvh::kMaxLeafTriangleNum; num < count; num *= 2) {
+				medianDepth++;
+			}
+			uint32_t middle = first;
+			if (depth + medianDepth + 1 < TriangleBvh::kMaxDepth) {
+				middle = SplitSah(first, count, centerBounds);
+			}
+			if (middle == first || middle == first + count) {
+				middle = SplitMedian(first, count, centerBounds);
+			}
+
+			const uint32_t left = Build(first, middle - first, depth + 1);
+			const uint32_t right = Build(middle, first + count - middle, depth + 1);
+			nodes[nodeIndex].left = left;
+			nodes[nodeIndex].right = right;
+
+			return nodeIndex;
+		}
+
+		/// <summary>
+		/// 中心をビンに分けて、左右の表面積 * 三角形数が一番小さい所で分ける
+		/// </summary>
+		/// <returns>右の最初の位置(分けられなければfirst)</returns>
+		uint32_t SplitSah(uint32_t first, uint32_t count, const AABB& centerBounds) {
+			uint32_t bestAxis = 0;
+			uint32_t bestSplit = 0;
+			float bestCost = std::numeric_limits<float>::max();
+
+			std::array<AABB, TriangleBvh::kBinNum> binBounds;
+			std::array<uint32_t, TriangleBvh::kBinNum> binCounts;
+			std::array<float, TriangleBvh::kBinNum> rightAreas;
+			std::array<uint32_t, TriangleBvh::kBinNum> rightCounts;
+			for (uint32_t axis = 0; axis < 3; axis++) {
+				const float minCenter = GetAxis(centerBounds.min, axis);
+				const float extent = GetAxis(centerBounds.max, axis) - minCenter;
+				if (!(0.0f < extent)) {
+					continue;
+				}
+				const float binScale = static_cast<float>(TriangleBvh::kBinNum) / extent;
+
+				binBounds.fill(AABB());
+				binCounts.fill(0u);
+				for (uint32_t i = first; i < first + count; i++) {
+					const uint32_t bin = CalcBin(GetAxis(centers[order[i]], axis), minCenter, binScale);
+					Merge(binBounds[bin], triangleBounds[order[i]]);
+					binCounts[bin]++;
+				}
+
+				// 右から累積して、左から累積しながらコストを比べる
+				AABB rightBounds;
+				uint32_t rightCount = 0;
+				for (uint32_t bin = TriangleBvh::kBinNum - 1; 0 < bin; bin--) {
+					Merge(rightBounds, binBounds[bin]);
+					rightCount += binCounts[bin];
+					rightAreas[bin] = CalcSurfaceArea(rightBounds);
+					rightCounts[bin] = rightCount;
+				}
+				AABB leftBounds;
+				uint32_t leftCount = 0;
+				for (uint32_t split = 1; split < TriangleBvh::kBinNum; split++) {
+					Merge(leftBounds, binBounds[split - 1]);
+					leftCount += binCounts[split - 1];
+					if (leftCount == 0 || rightCounts[split] == 0) {
+						continue;
+					}
+					const float cost = CalcSurfaceArea(leftBounds) * static_cast<float>(leftCount) + rightAreas[split] * static_cast<float>(rightCounts[split]);
+					if (cost < bestCost) {
+						bestCost = cost;
+						bestAxis = axis;
+						bestSplit = split;
+					}
+				}
+			}
+
+			if (bestSplit == 0) {
+				return first;
+			}
+
+			const float minCenter = GetAxis(centerBounds.min, bestAxis);
+			const float binScale = static_cast<float>(TriangleBvh::kBinNum) / (GetAxis(centerBounds.max, bestAxis) - minCenter);
+			auto middle = std::partition(order.begin() + first, order.begin() + first + count,
+				[&](uint32_t triangle) {
+					return CalcBin(GetAxis(centers[triangle], bestAxis), minCenter, binScale) < bestSplit;
+				}
+			);
+			return static_cast<uint32_t>(middle - order.begin());
+		}
+
+		/// <summary>
+		/// 中心が一番広がっている軸で、三角形の数が半分になる所で分ける
+		/// </summary>
+		uint32_t SplitMedian(uint32_t first, uint32_t count, const AABB& centerBounds) {
+			const Vector3 extent = centerBounds.max - centerBounds.min;
+			const uint32_t axis = extent.y < extent.x ? (extent.z < extent.x ? 0u : 2u) : (extent.z < extent.y ? 1u : 2u);
+			const uint32_t middle = first + count / 2;
+			std::nth_element(order.begin() + first, order.begin() + middle, order.begin() + first + count,
+				[&](uint32_t left, uint32_t right) {
+					return GetAxis(centers[left], axis) < GetAxis(centers[right], axis);
+				}
+			);
+			return middle;
+		}
+
+		static uint32_t CalcBin(float center, float minCenter, float binScale) noexcept {
+			const float bin = (center - minCenter) * binScale;
+			return std::min(static_cast<uint32_t>(std::max(bin, 0.0f)), TriangleBvh::kBinNum - 1);
+		}
+
+	private:
+		std::span<const AABB> triangleBounds;
+		std::span<const Vector3> centers;
+		std::vector<uint32_t> order;
+		std::vector<BuildNode> nodes;
+	};
+}
+
+TriangleBvh::TriangleBvh() :
+	nodes(),
+	triangles(),
+	triangleIndices(),
+	aabb()
+{}
+
+void TriangleBvh::Build(std::span<const Vector3> positions, std::span<const uint32_t> indices) {
+	Clear();
+
+	assert(indices.size() % 3 == 0);
+	if (indices.size() % 3 != 0) {
+		ErrorCheck::GetInstance()->ErrorTextBox("Build() : indices is not a triangle list", "TriangleBvh");
+		return;
+	}
+	if (std::any_of(indices.begin(), indices.end(), [&positions](uint32_t index) { return positions.size() <= index; })) {
+		ErrorCheck::GetInstance()->ErrorTextBox("Build() : index out of range", "TriangleBvh");
+		return;
+	}
+	if (indices.empty()) {
+		return;
+	}
+
+	const size_t triangleNum = indices.size() / 3;
+	std::vector<AABB> triangleBounds(triangleNum);
+	std::vector<Vector3> centers(triangleNum);
+	for (size_t i = 0; i < triangleNum; i++) {
+		for (size_t j = 0; j < 3; j++) {
+			triangleBounds[i].Extend(positions[indices[i * 3 + j]]);
+		}
+		centers[i] = triangleBounds[i].GetCenter();
+		aabb.Extend(triangleBounds[i].min);
+		aabb.Extend(triangleBounds[i].max);
+	}
+
+	BvhBuilder builder(triangleBounds, centers);
+	auto order = builder.GetOrder();
+	auto buildNodes = builder.GetNodes();
+
+	// 葉の順番に三角形を並べる
+	triangles.resize(triangleNum);
+	triangleIndices.assign(order.begin(), order.end());
+	for (size_t i = 0; i < triangleNum; i++) {
+		const Vector3& p0 = positions[indices[order[i] * 3]];
+		triangles[i].p0 = p0;
+		triangles[i].edge1 = positions[indices[order[i] * 3 + 1]] - p0;
+		triangles[i].edge2 = positions[indices[order[i] * 3 + 2]] - p0;
+	}
+
+	// 2分木の2段分(最大4つの子)を1つのノードにまとめる。深さ優先で並べる
+	auto emitNode = [&](auto& self, uint32_t buildNodeIndex) -> uint32_t {
+		const uint32_t nodeIndex = static_cast<uint32_t>(nodes.size());
+		nodes.emplace_back();
+
+		// 表面積が一番大きい内部ノードから開いて、子を4つまで集める(根が葉の時はそれだけ)
+		const BuildNode& buildNode = buildNodes[buildNodeIndex];
+		std::array<uint32_t, 4> children = { buildNodeIndex };
+		uint32_t childNum = 1;
+		if (!buildNode.IsLeaf()) {
+			children = { buildNode.left, buildNode.right };
+			childNum = 2;
+		}
+		while (childNum < 4) {
+			uint32_t open = kInvalidIndex;
+			float maxArea = -1.0f;
+			for (uint32_t i = 0; i < childNum; i++) {
+				const BuildNode& child = buildNodes[children[i]];
+				const float area = CalcSurfaceArea(child.bounds);
+				if (!child.IsLeaf() && maxArea < area) {
+					open = i;
+					maxArea = area;
+				}
+			}
+			if (open == kInvalidIndex) {
+				break;
+			}
+			const BuildNode& opened = buildNodes[children[open]];
+			children[open] = opened.left;
+			children[childNum++] = opened.right;
+		}
+
+		std::array<uint32_t, 4> nodeChildren{};
+		std::array<uint32_t, 4> triangleNums{};
+		for (uint32_t i = 0; i < childNum; i++) {
+			const BuildNode& child = buildNodes[children[i]];
+			if (child.IsLeaf()) {
+				nodeChildren[i] = child.first;
+				triangleNums[i] = child.count;
+			}
+			else {
+				nodeChildren[i] = self(self, children[i]);
+			}
+		}
+
+		// 子を作る間にnodesが伸びるので、最後に書き込む
+		Node& node = nodes[nodeIndex];
+		const AABB empty;
+		for (uint32_t i = 0; i < 4; i++) {
+			const AABB& bounds = i < childNum ? buildNodes[children[i]].bounds : empty;
+			node.minX[i] = bounds.min.x;
+			node.minY[i] = bounds.min.y;
+			node.minZ[i] = bounds.min.z;
+			node.maxX[i] = bounds.max.x;
+			node.maxY[i] = bounds.max.y;
+			node.maxZ[i] = bounds.max.z;
+		}
+		node.children = nodeChildren;
+		node.triangleNums = triangleNums;
+
+		return nodeIndex;
+	};
+	nodes.reserve(buildNodes.size() / 2 + 1);
+	emitNode(emitNode, 0u);
+}
+
+void TriangleBvh::Clear() {
+	nodes.clear();
+	triangles.clear();
+	triangleIndices.clear();
+	aabb = AABB();
+}
+
+bool TriangleBvh::Raycast(const Ray& ray, RaycastHit& hit, float maxDistance) const {
+	if (nodes.empty()) {
+		return false;
+	}
+
+	auto safeInverse = [](float direction) {
+		return 1.0f / (std::abs(direction) < kMinDirection ? std::copysign(kMinDirection, direction) : direction);
+	};
+	const Vector3 invDirection = { safeInverse(ray.direction.x), safeInverse(ray.direction.y), safeInverse(ray.direction.z) };
+
+	// 向きが負の軸はmaxの面から入る
+	const bool isNegativeX = invDirection.x < 0.0f;
+	const bool isNegativeY = invDirection.y < 0.0f;
+	const bool isNegativeZ = invDirection.z < 0.0f;
+
+#if defined(MATH_USE_SSE)
+	const __m128 originX = _mm_set1_ps(ray.origin.x);
+	const __m128 originY = _mm_set1_ps(ray.origin.y);
+	const __m128 originZ = _mm_set1_ps(ray.origin.z);
+	const __m128 invDirectionX = _mm_set1_ps(invDirection.x);
+	const __m128 invDirectionY = _mm_set1_ps(invDirection.y);
+	const __m128 invDirectionZ = _mm_set1_ps(invDirection.z);
+#endif
+
+	float closest = maxDistance;
+	uint32_t hitTriangle = kInvalidIndex;
+	float hitU = 0.0f;
+	float hitV = 0.0f;
+
+	// 1段ごとに最大4つ積んで1つ取り出すので、深さの3倍より少し多ければ足りる
+	struct StackEntry {
+		uint32_t node;
+		float distance;
+	};
+	std::array<StackEntry, kMaxDepth * 4> stack;
+	size_t stackSize = 0;
+	stack[stackSize++] = { 0u, 0.0f };
+
+	while (stackSize != 0) {
+		const StackEntry entry = stack[--stackSize];
+		// 積んだ後により近い交差が見つかっていたら調べなくていい
+		if (closest < entry.distance) {
+			continue;
+		}
+		const Node& node = nodes[entry.node];
+
+		const float* nearX = isNegativeX ? node.maxX.data() : node.minX.data();
+		const float* nearY = isNegativeY ? node.maxY.data() : node.minY.data();
+		const float* nearZ = isNegativeZ ? node.maxZ.data() : node.minZ.data();
+		const float* farX = isNegativeX ? node.minX.data() : node.maxX.data();
+		const float* farY = isNegativeY ? node.minY.data() : node.maxY.data();
+		const float* farZ = isNegativeZ ? node.minZ.data() : node.maxZ.data();
+
+		// 4つの子のAABBとスラブ法で判定する
+		alignas(16) std::array<float, 4> tNears;
+		uint32_t hitMask = 0;
+#if defined(MATH_USE_SSE)
+		const __m128 tNear = _mm_max_ps(
+			_mm_max_ps(
+				_mm_mul_ps(_mm_sub_ps(_mm_load_ps(nearX), originX), invDirectionX),
+				_mm_mul_ps(_mm_sub_ps(_mm_load_ps(nearY), originY), invDirectionY)
+			),
+			_mm_max_ps(
+				_mm_mul_ps(_mm_sub_ps(_mm_load_ps(nearZ), originZ), invDirectionZ),
+				_mm_setzero_ps()
+			)
+		);
+		const __m128 tFar = _mm_min_ps(
+			_mm_min_ps(
+				_mm_mul_ps(_mm_sub_ps(_mm_load_ps(farX), originX), invDirectionX),
+				_mm_mul_ps(_mm_sub_ps(_mm_load_ps(farY), originY), invDirectionY)
+			),
+			_mm_min_ps(
+				_mm_mul_ps(_mm_sub_ps(_mm_load_ps(farZ), originZ), invDirectionZ),
+				_mm_set1_ps(closest)
+			)
+		);
+		_mm_store_ps(tNears.data(), tNear);
+		hitMask = static_cast<uint32_t>(_mm_movemask_ps(_mm_cmple_ps(tNear, tFar)));
+#else
+		for (uint32_t i = 0; i < 4; i++) {
+			tNears[i] = std::max(
+				std::max((nearX[i] - ray.origin.x) * invDirection.x, (nearY[i] - ray.origin.y) * invDirection.y),
+				std::max((nearZ[i] - ray.origin.z) * invDirection.z, 0.0f)
+			);
+			const float tFar = std::min(
+				std::min((farX[i] - ray.origin.x) * invDirection.x, (farY[i] - ray.origin.y) * invDirection.y),
+				std::min((farZ[i] - ray.origin.z) * invDirection.z, closest)
+			);
+			hitMask |= tNears[i] <= tFar ? (1u << i) : 0u;
+		}
+#endif
+		if (hitMask == 0) {
+			continue;
+		}
+
+		// 当たった子を近い順に並べる
+		std::array<uint32_t, 4> hitChildren;
+		uint32_t hitChildNum = 0;
+		for (uint32_t i = 0; i < 4; i++) {
+			if (!(hitMask & (1u << i))) {
+				continue;
+			}
+			uint32_t j = hitChildNum++;
+			for (; 0 < j && tNears[i] < tNears[hitChildren[j - 1]]; j--) {
+				hitChildren[j] = hitChildren[j - 1];
+			}
+			hitChildren[j] = i;
+		}
+
+		// 葉はすぐに三角形と判定する(Moller-Trumbore)
+		for (uint32_t k = 0; k < hitChildNum; k++) {
+			const uint32_t i = hitChildren[k];
+			if (node.triangleNums[i] == 0 || closest < tNears[i]) {
+				continue;
+			}
+			const uint32_t first = node.children[i];
+			for (uint32_t triangle = first; triangle < first + node.triangleNums[i]; triangle++) {
+				const Triangle& tri = triangles[triangle];
+				const Vector3 pvec = ray.direction.Cross(tri.edge2);
+				const float det = tri.edge1.Dot(pvec);
+				if (det == 0.0f) {
+					continue;
+				}
+				const float invDet = 1.0f / det;
+				const Vector3 tvec = ray.origin - tri.p0;
+				const float u = tvec.Dot(pvec) * invDet;
+				if (u < 0.0f || 1.0f < u) {
+					continue;
+				}
+				const Vector3 qvec = tvec.Cross(tri.edge1);
+				const float v = ray.direction.Dot(qvec) * invDet;
+				if (v < 0.0f || 1.0f < u + v) {
+					continue;
+				}
+				const float t = tri.edge2.Dot(qvec) * invDet;
+				if (t < 0.0f || closest <= t) {
+					continue;
+				}
+				closest = t;
+				hitTriangle = triangle;
+				hitU = u;
+				hitV = v;
+			}
+		}
+
+		// 内部ノードは遠い順に積んで、近いものから取り出す
+		for (uint32_t k = hitChildNum; 0 < k; k--) {
+			const uint32_t i = hitChildren[k - 1];
+			if (node.triangleNums[i] != 0 || closest < tNears[i]) {
+				continue;
+			}
+			assert(stackSize < stack.size());
+			stack[stackSize++] = { node.children[i], tNears[i] };
+		}
+	}
+
+	if (hitTriangle == kInvalidIndex) {
+		return false;
+	}
+
+	const Triangle& tri = triangles[hitTriangle];
+	hit.distance = closest;
+	hit.position = ray.GetPoint(closest);
+	hit.normal = tri.edge1.Cross(tri.edge2).Normalize();
+	hit.triangleIndex = triangleIndices[hitTriangle];
+	hit.u = hitU;
+	hit.v = hitV;
+
+	return true;
+}
@@ -0,0 +1,142 @@
+#pragma once
+#include "Utils/Math/Vector3.h"
+#include "Utils/Math/Bounds.h"
+#include "Utils/Math/Ray.h"
+#include <vector>
+#include <array>
+#include <span>
+#include <cstdint>
+#include <limits>
+
+/// <summary>
+/// レイと三角形の交差結果
+/// </summary>
+struct RaycastHit {
+	/// <summary>
+	/// レイのパラメーターt(directionが正規化されていれば距離)
+	/// </summary>
+	float distance = 0.0f;
+	Vector3 position;
+	/// <summary>
+	/// 三角形の面法線(正規化済み。表面(時計回り)から見た時にカメラ側を向く)
+	/// </summary>
+	Vector3 normal;
+	/// <summary>
+	/// Build()に渡したインデックスでの三角形の番号
+	/// </summary>
+	uint32_t triangleIndex = 0;
+	/// <summary>
+	/// 重心座標(position = p0 * (1 - u - v) + p1 * u + p2 * v)
+	/// </summary>
+	float u = 0.0f;
+	float v = 0.0f;
+};
+
+/// <summary>
+/// 三角形のBVH(SAHで分割した2分木を4分木にまとめたもの)
+/// ノードは4つの子のAABBを成分ごとに並べて持ち、SIMDで4つ同時にレイと判定する
+/// ノードと三角形は深さ優先の順番で連続した配列に置く
+/// </summary>
+class TriangleBvh final {
+public:
+	/// <summary>
+	/// 葉に入れる三角形の最大数
+	/// </summary>
+	static constexpr uint32_t kMaxLeafTriangleNum = 4;
+	/// <summary>
+	/// SAHで分割位置を探す時のビンの数
+	/// </summary>
+	static constexpr uint32_t kBinNum = 16;
+	/// <summary>
+	/// 2分木の深さの上限(超えそうなら中央で分ける)。探索スタックの大きさもこれで決まる
+	/// </summary>
+	static constexpr uint32_t kMaxDepth = 64;
+
+private:
+	/// <summary>
+	/// 4つの子を持つノード(キャッシュライン2本分)
+	/// </summary>
+	struct alignas(64) Node {
+		std::array<float, 4> minX;
+		std::array<float, 4> minY;
+		std::array<float, 4> minZ;
+		std::array<float, 4> maxX;
+		std::array<float, 4> maxY;
+		std::array<float, 4> maxZ;
+		/// <summary>
+		/// 内部ノードならノードの番号、葉なら最初の三角形の番号
+		/// </summary>
+		std::array<uint32_t, 4> children;
+		/// <summary>
+		/// 葉の三角形の数(0なら内部ノード。使っていない子はAABBが空)
+		/// </summary>
+		std::array<uint32_t, 4> triangleNums;
+	};
+
+	/// <summary>
+	/// 交差判定用の三角形(Moller-Trumboreで使う辺を持っておく)
+	/// </summary>
+	struct Triangle {
+		Vector3 p0;
+		Vector3 edge1;
+		Vector3 edge2;
+	};
+
+public:
+	TriangleBvh();
+	TriangleBvh(const TriangleBvh&) = default;
+	TriangleBvh(TriangleBvh&&) noexcept = default;
+	~TriangleBvh() = default;
+
+	TriangleBvh& operator=(const TriangleBvh&) = default;
+	TriangleBvh& operator=(TriangleBvh&&) noexcept = default;
+
+public:
+	/// <summary>
+	/// 三角形リストからBVHを作る(前の内容は捨てる)
+	/// </summary>
+	/// <param name="positions">頂点座標</param>
+	/// <param name="indices">三角形リストのインデックス</param>
+	void Build(std::span<const Vector3> positions, std::span<const uint32_t> indices);
+
+	void Clear();
+
+	/// <summary>
+	/// レイと一番近い三角形の交差を求める(裏面にも当たる)
+	/// </summary>
+	/// <param name="ray">BVHと同じ座標系のレイ</param>
+	/// <param name="hit">当たった時の結果</param>
+	/// <param name="maxDistance">これより遠い交差は無視する(レイのパラメーターt)</param>
+	/// <returns>当たったか</returns>
+	bool Raycast(const Ray& ray, RaycastHit& hit, float maxDistance = std::numeric_limits<float>::infinity()) const;
+
+	inline bool IsEmpty() const noexcept {
+		return triangles.empty();
+	}
+
+	inline size_t GetNodeNum() const noexcept {
+		return nodes.size();
+	}
+	inline size_t GetTriangleNum() const noexcept {
+		return triangles.size();
+	}
+	/// <summary>
+	/// ノードと三角形に使っているバイト数
+	/// </summary>
+	inline size_t GetMemorySize() const noexcept {
+		return nodes.size() * sizeof(Node) + triangles.size() * sizeof(Triangle) + triangleIndices.size() * sizeof(uint32_t);
+	}
+
+	inline const AABB& GetAABB() const noexcept {
+		return aabb;
+	}
+
+private:
+	std::vector<Node> nodes;
+	// 葉の順番に並べた三角形
+	std::vector<Triangle> triangles;
+	// trianglesの元の三角形の番号
+	std::vector<uint32_t> triangleIndices;
+
+	AABB aabb;
+};
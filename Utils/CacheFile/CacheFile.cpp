@@ -0,0 +1,101 @@
+#include "CacheFile.h"
+#include <filesystem>
+#include <fstream>
+#include <array>
+#include <thread>
+
+namespace {
+	/// <summary>
+	/// FNV-1a(64bit)
+	/// </summary>
+	uint64_t HashFile(const std::string& fileName, bool& isSuccess) {
+		std::ifstream file(fileName, std::ios::binary);
+		isSuccess = static_cast<bool>(file);
+
+		uint64_t hash = 0xcbf29ce484222325ull;
+		std::array<char, 1 << 16> buf;
+		while (file) {
+			file.read(buf.data(), buf.size());
+			std::streamsize readSize = file.gcount();
+			for (std::streamsize i = 0; i < readSize; i++) {
+				hash ^= static_cast<uint8_t>(buf[i]);
+				hash *= 0x100000001b3ull;
+			}
+		}
+
+		return hash;
+	}
+
+	bool GetSizeAndTime(const std::string& fileName, uint64_t& size, int64_t& time) {
+		std::error_code err;
+		size = static_cast<uint64_t>(std::filesystem::file_size(fileName, err));
+		if (err) {
+			return false;
+		}
+		time = static_cast<int64_t>(std::filesystem::last_write_time(fileName, err).time_since_epoch().count());
+		return !err;
+	}
+}
+
+bool GetSourceFileInfo(const std::string& fileName, SourceFileInfo& info) {
+	if (!GetSizeAndTime(fileName, info.size, info.time)) {
+		return false;
+	}
+	bool isSuccess = false;
+	info.hash = HashFile(fileName, isSuccess);
+	return isSuccess;
+}
+
+bool IsSameSourceFile(const std::string& fileName, const SourceFileInfo& info, int64_t* currentTime) {
+	uint64_t size = 0;
+	int64_t time = 0;
+	if (!GetSizeAndTime(fileName, size, time) || info.size != size) {
+		return false;
+	}
+	if (currentTime) {
+		*currentTime = time;
+	}
+	if (info.time == time) {
+		return true;
+	}
+	bool isSuccess = false;
+	return info.hash == HashFile(fileName, isSuccess) && isSuccess;
+}
+
+bool SaveCacheFile(const std::string& cacheFileName, std::span<const std::byte> image) {
+	if (image.empty()) {
+		return false;
+	}
+
+	// 同じファイルを別のスレッドで同時に書き出しても壊れないように、一時ファイルはスレッドごとに分ける
+	std::string tmpFileName = cacheFileName + ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+	{
+		std::ofstream cacheFile(tmpFileName, std::ios::binary | std::ios::trunc);
+		if (!cacheFile) {
+			return false;
+		}
+		cacheFile.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+		if (!cacheFile) {
+			return false;
+		}
+	}
+
+	std::error_code err;
+	std::filesystem::rename(tmpFileName, cacheFileName, err);
+	if (err) {
+		std::filesystem::remove(tmpFileName, err);
+		return false;
+	}
+
+	return true;
+}
+
+bool PatchCacheFile(const std::string& cacheFileName, size_t offset, std::span<const std::byte> data) {
+	std::fstream cacheFile(cacheFileName, std::ios::binary | std::ios::in | std::ios::out);
+	if (!cacheFile) {
+		return false;
+	}
+	cacheFile.seekp(static_cast<std::streamoff>(offset));
+	cacheFile.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+	return static_cast<bool>(cacheFile);
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <string>
+#include <span>
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// キャッシュの元ファイルの情報(キャッシュが古くなっていないかの判定用)
+/// </summary>
+struct SourceFileInfo {
+	uint64_t size = 0;
+	int64_t time = 0;
+	/// <summary>
+	/// 中身のハッシュ(FNV-1a 64bit)
+	/// </summary>
+	uint64_t hash = 0;
+};
+
+/// <summary>
+/// 元ファイルのサイズ、更新日時、ハッシュを取得する
+/// </summary>
+/// <returns>ファイルが読めたか</returns>
+bool GetSourceFileInfo(const std::string& fileName, SourceFileInfo& info);
+
+/// <summary>
+/// キャッシュを作った時から元ファイルが変わっていないか
+/// サイズと更新日時が同じならそのまま使う。違う場合は中身のハッシュで判定する
+/// </summary>
+/// <param name="currentTime">同じだった時に元ファイルの今の更新日時を受け取る(info.timeと違えばキャッシュに書き戻すと次からハッシュを取らずに済む)</param>
+bool IsSameSourceFile(const std::string& fileName, const SourceFileInfo& info, int64_t* currentTime = nullptr);
+
+/// <summary>
+/// キャッシュファイルを書き出す(書きかけのファイルを読まないように、一時ファイルに書き終わってから置き換える)
+/// </summary>
+/// <returns>成功したか</returns>
+bool SaveCacheFile(const std::string& cacheFileName, std::span<const std::byte> image);
+
+/// <summary>
+/// キャッシュファイルの一部をその場で書き換える(ヘッダーの更新日時など。開いているMappedFileは先に閉じる)
+/// </summary>
+/// <returns>成功したか</returns>
+bool PatchCacheFile(const std::string& cacheFileName, size_t offset, std::span<const std::byte> data);
+
+inline size_t AlignUp(size_t value, size_t alignment) {
+	return (value + alignment - 1) / alignment * alignment;
+}
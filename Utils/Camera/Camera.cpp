@@ -117,13 +117,13 @@ void Camera::Update(const Vector3& gazePoint) {
 		view = VertMakeMatrixAffin(scale, rotate, pos);
 		view = VertMakeMatrixAffin(Vector3::identity, Vector3(gazePointRotate.y, gazePointRotate.x, 0.0f), gazePoint) * view;
 		worldPos = { view[0][3],view[1][3], view[2][3] };
-		view.Inverse();
+		view.VertInverseAffin();
 	}
 	else {
 		view.VertAffin(scale, rotate, pos + gazePoint);
 		view = VertMakeMatrixAffin(Vector3::identity, Vector3(gazePointRotate.y, gazePointRotate.x, 0.0f), pos + gazePoint) * view;
 		worldPos = { view[0][3],view[1][3], view[2][3] };
-		view.Inverse();
+		view.VertInverseAffin();
 	}
 	static auto engine = Engine::GetInstance();
 	static const float aspect = static_cast<float>(engine->clientWidth) / static_cast<float>(engine->clientHeight);
@@ -160,7 +160,7 @@ void Camera::Update(const Mat4x4& worldMat) {
 	view.VertAffin(scale, rotate, pos);
 	view = worldMat * view;
 	worldPos = { view[0][3],view[1][3], view[2][3] };
-	view.Inverse();
+	view.VertInverseAffin();
 
 	static auto engine = Engine::GetInstance();
 	static const float aspect = static_cast<float>(engine->clientWidth) / static_cast<float>(engine->clientHeight);
@@ -191,4 +191,41 @@ void Camera::Update(const Mat4x4& worldMat) {
 		viewOthograohicsVp = VertMakeMatrixViewPort(0.0f, 0.0f, windowSize.x, windowSize.y, 0.0f, 1.0f) * viewOthograohics;
 		break;
 	}
+}
+
+float Camera::CalcPixelPerUnit(float distance) const {
+	const float windowHeight = WinApp::GetInstance()->GetWindowSize().y;
+
+	switch (type)
+	{
+	case Camera::Type::Projecction:
+	default:
+		// 近すぎると無限大になるのでニアクリップより手前は同じ扱い
+		distance = std::max(distance, kNearClip);
+		return windowHeight / (2.0f * distance * std::tan(fov * 0.5f));
+
+	case Camera::Type::Othographic:
+		return 1.0f / drawScale;
+	}
+}
+
+Ray Camera::ScreenPosToRay(const Vector2& screenPos) const {
+	// ビューポートまで含めた行列の逆行列で、深度0(ニアクリップ面)と深度1(ファークリップ面)の点をワールド座標に戻す
+	Mat4x4 inverseViewProjectionVp;
+	switch (type)
+	{
+	case Camera::Type::Projecction:
+	default:
+		inverseViewProjectionVp = MakeMatrixInverse(viewProjecctionVp);
+		break;
+
+	case Camera::Type::Othographic:
+		inverseViewProjectionVp = MakeMatrixInverse(viewOthograohicsVp);
+		break;
+	}
+
+	const Vector3 nearPos = inverseViewProjectionVp * Vector3(screenPos.x, screenPos.y, 0.0f);
+	const Vector3 farPos = inverseViewProjectionVp * Vector3(screenPos.x, screenPos.y, 1.0f);
+
+	return Ray{ nearPos, (farPos - nearPos).Normalize() };
 }
\ No newline at end of file
@@ -3,6 +3,8 @@
 #include "Utils/Math/Mat4x4.h"
 #include "Utils/Math/Vector2.h"
 #include "Utils/Math/Vector4.h"
+#include "Utils/Math/Frustum.h"
+#include "Utils/Math/Ray.h"
 
 class Camera {
 public:
@@ -35,6 +37,11 @@ public:
 		return viewOthograohics;
 	}
 
+	// 透視投影の視錐台
+	inline Frustum GetFrustum() noexcept {
+		return Frustum(viewProjecction);
+	}
+
 	const Vector3& GetPos() const {
 		return worldPos;
 	}
@@ -48,6 +55,17 @@ public:
 		return viewOthograohicsVp;
 	}
 
+	/// <summary>
+	/// カメラからdistance離れた位置で、距離1が画面上で何ピクセルになるか(LODの選択に使う)
+	/// </summary>
+	float CalcPixelPerUnit(float distance) const;
+
+	/// <summary>
+	/// スクリーン座標(クライアント領域のピクセル。Mouse::GetPos()と同じ)を通るワールド座標のレイ
+	/// ニアクリップ面から奥に向かう(directionは正規化済み。Update()の後に呼ぶ)
+	/// </summary>
+	Ray ScreenPosToRay(const Vector2& screenPos) const;
+
 public:
 	Type type;
 	bool isDebug;
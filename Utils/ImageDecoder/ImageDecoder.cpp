@@ -0,0 +1,77 @@
+#include "ImageDecoder.h"
+#include "Utils/ImageDecoder/PngDecoder.h"
+#include "Utils/ImageDecoder/JpegDecoder.h"
+#include "Utils/MappedFile/MappedFile.h"
+#include <thread>
+#include <atomic>
+#include <algorithm>
+
+ImageDecoder::FileType ImageDecoder::GetFileType(std::span<const uint8_t> data) {
+	if (8 <= data.size() && data[0] == 0x89 && data[1] == 'P' && data[2] == 'N' && data[3] == 'G') {
+		return FileType::Png;
+	}
+	if (3 <= data.size() && data[0] == 0xFF && data[1] == 0xD8 && data[2] == 0xFF) {
+		return FileType::Jpeg;
+	}
+	return FileType::Unknown;
+}
+
+bool ImageDecoder::Decode(std::span<const uint8_t> data, Image& image) {
+	bool isSucceeded = false;
+	switch (GetFileType(data)) {
+	case FileType::Png:
+		isSucceeded = DecodePng(data, image);
+		break;
+	case FileType::Jpeg:
+		isSucceeded = DecodeJpeg(data, image);
+		break;
+	case FileType::Unknown:
+	default:
+		break;
+	}
+
+	if (!isSucceeded) {
+		image = Image();
+	}
+	return isSucceeded;
+}
+
+bool ImageDecoder::DecodeFile(const std::string& fileName, Image& image) {
+	MappedFile file;
+	if (!file.Open(fileName)) {
+		image = Image();
+		return false;
+	}
+	const std::span<const std::byte> data = file.GetData();
+	return Decode(std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(data.data()), data.size()), image);
+}
+
+std::vector<ImageDecoder::Image> ImageDecoder::DecodeFiles(std::span<const std::string> fileNames, uint32_t threadNum) {
+	std::vector<Image> result(fileNames.size());
+	if (threadNum == 0) {
+		threadNum = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+	threadNum = std::clamp(static_cast<uint32_t>(fileNames.size()), 1u, threadNum);
+
+	// ファイルごとに大きさが違うので、空いたスレッドから次のファイルを取る
+	std::atomic<size_t> next = 0;
+	const auto decodeProc = [&]() {
+		for (size_t i = next++; i < fileNames.size(); i = next++) {
+			DecodeFile(fileNames[i], result[i]);
+		}
+	};
+	if (threadNum == 1) {
+		decodeProc();
+		return result;
+	}
+
+	std::vector<std::thread> threads;
+	threads.reserve(threadNum);
+	for (uint32_t i = 0; i < threadNum; i++) {
+		threads.emplace_back(decodeProc);
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	return result;
+}
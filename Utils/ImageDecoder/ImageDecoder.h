@@ -0,0 +1,58 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <span>
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// PNGとJPEGをRGBA8にデコードする(WICを使わないので、どのスレッドからでも同時に呼べる)
+/// 対応していない形式(プログレッシブJPEG、ファイルの中身がAVIFなど)は失敗するので、呼び出し側でWICに任せる
+/// </summary>
+class ImageDecoder final {
+public:
+	enum class FileType : uint32_t {
+		Unknown,
+		Png,
+		Jpeg
+	};
+
+	/// <summary>
+	/// デコードした画像(行の隙間なく詰めたRGBA8。色はファイルのまま変換しない)
+	/// </summary>
+	struct Image {
+		uint32_t width = 0;
+		uint32_t height = 0;
+		std::vector<uint8_t> pixels;
+	};
+
+public:
+	/// <summary>
+	/// 先頭のシグネチャから形式を調べる(拡張子は見ない)
+	/// </summary>
+	static FileType GetFileType(std::span<const uint8_t> data);
+
+	/// <summary>
+	/// メモリ上のファイルをデコードする
+	/// </summary>
+	/// <param name="data">ファイルの中身</param>
+	/// <param name="image">デコードした画像</param>
+	/// <returns>成功したか</returns>
+	static bool Decode(std::span<const uint8_t> data, Image& image);
+
+	/// <summary>
+	/// ファイルをマップしてデコードする
+	/// </summary>
+	/// <param name="fileName">ファイルパス</param>
+	/// <param name="image">デコードした画像</param>
+	/// <returns>成功したか</returns>
+	static bool DecodeFile(const std::string& fileName, Image& image);
+
+	/// <summary>
+	/// 複数のファイルをスレッドに分けてデコードする
+	/// </summary>
+	/// <param name="fileNames">ファイルパス</param>
+	/// <param name="threadNum">使うスレッド数(0ならハードウェアのスレッド数)</param>
+	/// <returns>fileNamesと同じ順番の画像(失敗したものは幅と高さが0)</returns>
+	static std::vector<Image> DecodeFiles(std::span<const std::string> fileNames, uint32_t threadNum = 0);
+};
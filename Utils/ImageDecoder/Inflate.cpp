@@ -0,0 +1,453 @@
+#include "Inflate.h"
+#include <array>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+	/// <summary>
+	/// 1回の表引きで復号する符号の最大ビット数(これより長い符号は正準符号の範囲から探す)
+	/// </summary>
+	constexpr uint32_t kFastBits = 10;
+	constexpr uint32_t kMaxCodeLength = 15;
+	constexpr size_t kMaxSymbolNum = 288;
+	/// <summary>
+	/// 一致のコピーを8バイトずつ行うため、出力の後ろに余分に確保するバイト数
+	/// </summary>
+	constexpr size_t kOutputSlack = 8;
+
+	constexpr std::array<uint16_t, 29> kLengthBase = {
+		3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+		35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+	};
+	constexpr std::array<uint8_t, 29> kLengthExtra = {
+		0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+		3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+	};
+	constexpr std::array<uint16_t, 30> kDistanceBase = {
+		1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+		257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+	};
+	constexpr std::array<uint8_t, 30> kDistanceExtra = {
+		0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+		7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+	};
+	constexpr std::array<uint8_t, 19> kCodeLengthOrder = {
+		16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+	};
+
+	constexpr std::array<uint8_t, 256> MakeReverseTable() {
+		std::array<uint8_t, 256> table{};
+		for (uint32_t i = 0; i < 256; i++) {
+			uint32_t reversed = 0;
+			for (uint32_t bit = 0; bit < 8; bit++) {
+				reversed |= ((i >> bit) & 1u) << (7 - bit);
+			}
+			table[i] = static_cast<uint8_t>(reversed);
+		}
+		return table;
+	}
+	constexpr std::array<uint8_t, 256> kReverseTable = MakeReverseTable();
+
+	uint32_t ReverseBits16(uint32_t value) {
+		return (static_cast<uint32_t>(kReverseTable[value & 0xff]) << 8) | kReverseTable[(value >> 8) & 0xff];
+	}
+
+	/// <summary>
+	/// 下位ビットから順に読む(8バイトずつまとめて補充する)
+	/// </summary>
+	class BitReader {
+	public:
+		BitReader(std::span<const uint8_t> source) :
+			pos(source.data()),
+			end(source.data() + source.size()),
+			bits(0),
+			bitNum(0),
+			paddingBitNum(0)
+		{}
+
+	public:
+		/// <summary>
+		/// 56ビット以上読める状態にする(データの後ろは0で埋める)
+		/// </summary>
+		void Refill() {
+			if (8 <= end - pos) {
+				uint64_t value = 0;
+				std::memcpy(&value, pos, sizeof(value));
+				bits |= value << bitNum;
+				pos += (63 - bitNum) >> 3;
+				bitNum |= 56;
+			}
+			else {
+				while (bitNum <= 56) {
+					if (pos < end) {
+						bits |= static_cast<uint64_t>(*pos++) << bitNum;
+					}
+					else {
+						paddingBitNum += 8;
+					}
+					bitNum += 8;
+				}
+			}
+		}
+
+		uint32_t Peek(uint32_t n) const {
+			return static_cast<uint32_t>(bits & ((uint64_t{ 1 } << n) - 1));
+		}
+		void Consume(uint32_t n) {
+			bits >>= n;
+			bitNum -= n;
+		}
+		uint32_t Read(uint32_t n) {
+			const uint32_t value = Peek(n);
+			Consume(n);
+			return value;
+		}
+
+		/// <summary>
+		/// 次のバイトの境界まで飛ばし、読んでいないバイトの先頭を返す(ビットの読み込みは最初からやり直す)
+		/// </summary>
+		const uint8_t* AlignToByte() {
+			Consume(bitNum & 7u);
+			const uint8_t* result = pos - (bitNum - std::min(bitNum, paddingBitNum)) / 8;
+			Seek(result);
+			return result;
+		}
+		void Seek(const uint8_t* pos_) {
+			pos = pos_;
+			bits = 0;
+			bitNum = 0;
+			paddingBitNum = 0;
+		}
+
+		const uint8_t* GetEnd() const {
+			return end;
+		}
+
+		/// <summary>
+		/// データの後ろまで読んでしまったか
+		/// </summary>
+		bool IsOverrun() const {
+			return bitNum < paddingBitNum;
+		}
+
+	private:
+		const uint8_t* pos;
+		const uint8_t* end;
+		uint64_t bits;
+		uint32_t bitNum;
+		uint32_t paddingBitNum;
+	};
+
+	/// <summary>
+	/// 正準ハフマン符号の復号表
+	/// </summary>
+	struct Huffman {
+		/// <summary>
+		/// kFastBitsまでの符号を反転したビットで引く((記号 << 4) | 符号長。0なら長い符号か不正な符号)
+		/// </summary>
+		std::array<uint16_t, 1 << kFastBits> fast;
+		/// <summary>
+		/// 符号長ごとの最後の符号の次の値(16ビットに左詰め)
+		/// </summary>
+		std::array<uint32_t, kMaxCodeLength + 2> maxCode;
+		std::array<uint16_t, kMaxCodeLength + 1> firstCode;
+		std::array<uint16_t, kMaxCodeLength + 1> firstSymbol;
+		std::array<uint16_t, kMaxSymbolNum> symbols;
+
+		bool Build(std::span<const uint8_t> lengths) {
+			std::array<uint32_t, kMaxCodeLength + 1> counts{};
+			for (uint8_t length : lengths) {
+				counts[length]++;
+			}
+			counts[0] = 0;
+
+			std::array<uint32_t, kMaxCodeLength + 1> nextCode{};
+			uint32_t code = 0;
+			uint32_t symbolNum = 0;
+			for (uint32_t i = 1; i <= kMaxCodeLength; i++) {
+				nextCode[i] = code;
+				firstCode[i] = static_cast<uint16_t>(code);
+				firstSymbol[i] = static_cast<uint16_t>(symbolNum);
+				code += counts[i];
+				// 符号が足りない(符号長の割り当てが多すぎる)
+				if ((1u << i) < code) {
+					return false;
+				}
+				maxCode[i] = code << (16 - i);
+				code <<= 1;
+				symbolNum += counts[i];
+			}
+			maxCode[kMaxCodeLength + 1] = 1u << 16;
+
+			fast.fill(0);
+			for (size_t symbol = 0; symbol < lengths.size(); symbol++) {
+				const uint32_t length = lengths[symbol];
+				if (length == 0) {
+					continue;
+				}
+				symbols[firstSymbol[length] + nextCode[length] - firstCode[length]] = static_cast<uint16_t>(symbol);
+				if (length <= kFastBits) {
+					const uint32_t reversed = ReverseBits16(nextCode[length]) >> (16 - length);
+					for (uint32_t i = reversed; i < fast.size(); i += 1u << length) {
+						fast[i] = static_cast<uint16_t>((symbol << 4) | length);
+					}
+				}
+				nextCode[length]++;
+			}
+			return true;
+		}
+
+		/// <summary>
+		/// 記号を1つ読む(Refill()の後に呼ぶ)
+		/// </summary>
+		/// <returns>不正な符号なら-1</returns>
+		int32_t Decode(BitReader& reader) const {
+			const uint32_t entry = fast[reader.Peek(kFastBits)];
+			if (entry != 0) {
+				reader.Consume(entry & 15u);
+				return static_cast<int32_t>(entry >> 4);
+			}
+
+			const uint32_t code = ReverseBits16(reader.Peek(16));
+			uint32_t length = kFastBits + 1;
+			while (maxCode[length] <= code) {
+				length++;
+			}
+			if (kMaxCodeLength < length) {
+				return -1;
+			}
+			const uint32_t index = (code >> (16 - length)) - firstCode[length] + firstSymbol[length];
+			if (kMaxSymbolNum <= index) {
+				return -1;
+			}
+			reader.Consume(length);
+			return symbols[index];
+		}
+	};
+
+	struct FixedHuffman {
+		Huffman literal;
+		Huffman distance;
+	};
+
+	const FixedHuffman& GetFixedHuffman() {
+		static const FixedHuffman fixedHuffman = []() {
+			FixedHuffman result{};
+			std::array<uint8_t, kMaxSymbolNum> lengths{};
+			std::fill(lengths.begin(), lengths.begin() + 144, uint8_t{ 8 });
+			std::fill(lengths.begin() + 144, lengths.begin() + 256, uint8_t{ 9 });
+			std::fill(lengths.begin() + 256, lengths.begin() + 280, uint8_t{ 7 });
+			std::fill(lengths.begin() + 280, lengths.end(), uint8_t{ 8 });
+			result.literal.Build(lengths);
+			lengths.fill(5);
+			result.distance.Build(std::span<const uint8_t>(lengths.data(), kDistanceBase.size()));
+			return result;
+		}();
+		return fixedHuffman;
+	}
+
+	bool ReadDynamicHuffman(BitReader& reader, Huffman& literal, Huffman& distance) {
+		reader.Refill();
+		const uint32_t literalNum = reader.Read(5) + 257;
+		const uint32_t distanceNum = reader.Read(5) + 1;
+		const uint32_t codeLengthNum = reader.Read(4) + 4;
+
+		std::array<uint8_t, kCodeLengthOrder.size()> codeLengthLengths{};
+		for (uint32_t i = 0; i < codeLengthNum; i++) {
+			reader.Refill();
+			codeLengthLengths[kCodeLengthOrder[i]] = static_cast<uint8_t>(reader.Read(3));
+		}
+		Huffman codeLength;
+		if (!codeLength.Build(codeLengthLengths)) {
+			return false;
+		}
+
+		std::array<uint8_t, kMaxSymbolNum + 32> lengths{};
+		const uint32_t totalNum = literalNum + distanceNum;
+		uint32_t n = 0;
+		while (n < totalNum) {
+			reader.Refill();
+			const int32_t symbol = codeLength.Decode(reader);
+			if (symbol < 0) {
+				return false;
+			}
+			if (symbol < 16) {
+				lengths[n++] = static_cast<uint8_t>(symbol);
+				continue;
+			}
+
+			uint32_t repeat = 0;
+			uint8_t value = 0;
+			if (symbol == 16) {
+				if (n == 0) {
+					return false;
+				}
+				repeat = reader.Read(2) + 3;
+				value = lengths[n - 1];
+			}
+			else if (symbol == 17) {
+				repeat = reader.Read(3) + 3;
+			}
+			else {
+				repeat = reader.Read(7) + 11;
+			}
+			if (totalNum - n < repeat) {
+				return false;
+			}
+			std::fill_n(lengths.begin() + n, repeat, value);
+			n += repeat;
+		}
+
+		// ブロックの終わりの記号が無いと終われない
+		if (lengths[256] == 0) {
+			return false;
+		}
+		return literal.Build(std::span<const uint8_t>(lengths.data(), literalNum))
+			&& distance.Build(std::span<const uint8_t>(lengths.data() + literalNum, distanceNum));
+	}
+
+	bool InflateBlock(BitReader& reader, const Huffman& literal, const Huffman& distance, uint8_t* begin, uint8_t*& out, uint8_t* end) {
+		for (;;) {
+			// 長さと距離の記号と追加ビットを合わせても48ビットなので、1回の補充で足りる
+			reader.Refill();
+			const int32_t symbol = literal.Decode(reader);
+			if (static_cast<uint32_t>(symbol) < 256u) {
+				if (out == end) {
+					return false;
+				}
+				*out++ = static_cast<uint8_t>(symbol);
+				continue;
+			}
+			if (symbol == 256) {
+				return true;
+			}
+
+			const uint32_t lengthSymbol = static_cast<uint32_t>(symbol) - 257u;
+			if (kLengthBase.size() <= lengthSymbol) {
+				return false;
+			}
+			const size_t length = kLengthBase[lengthSymbol] + reader.Read(kLengthExtra[lengthSymbol]);
+			const uint32_t distanceSymbol = static_cast<uint32_t>(distance.Decode(reader));
+			if (kDistanceBase.size() <= distanceSymbol) {
+				return false;
+			}
+			const size_t dist = kDistanceBase[distanceSymbol] + reader.Read(kDistanceExtra[distanceSymbol]);
+			if (static_cast<size_t>(out - begin) < dist || static_cast<size_t>(end - out) < length) {
+				return false;
+			}
+
+			const uint8_t* src = out - dist;
+			if (8 <= dist) {
+				// 8バイト単位なら重なっても書いた後の値を読まないので、まとめてコピーする(後ろのはみ出しはkOutputSlackに収まる)
+				uint8_t* copyEnd = out + length;
+				do {
+					std::memcpy(out, src, 8);
+					out += 8;
+					src += 8;
+				} while (out < copyEnd);
+				out = copyEnd;
+			}
+			else if (dist == 1) {
+				std::memset(out, *src, length);
+				out += length;
+			}
+			else {
+				for (size_t i = 0; i < length; i++) {
+					out[i] = src[i];
+				}
+				out += length;
+			}
+		}
+	}
+
+	uint32_t Adler32(const uint8_t* data, size_t size) {
+		// 65521で割る前に32ビットを超えない最大の長さ
+		constexpr size_t kBlockSize = 5552;
+		uint32_t a = 1;
+		uint32_t b = 0;
+		while (0 < size) {
+			const size_t blockSize = std::min(size, kBlockSize);
+			size -= blockSize;
+			for (size_t i = 0; i < blockSize; i++) {
+				a += data[i];
+				b += a;
+			}
+			data += blockSize;
+			a %= 65521u;
+			b %= 65521u;
+		}
+		return (b << 16) | a;
+	}
+}
+
+bool InflateZlib(std::span<const uint8_t> source, size_t size, std::vector<uint8_t>& dst) {
+	// zlibのヘッダー(Deflateで、プリセット辞書を使わないものだけ)
+	if (source.size() < 6) {
+		return false;
+	}
+	const uint32_t cmf = source[0];
+	const uint32_t flg = source[1];
+	if ((cmf & 15u) != 8 || 7 < (cmf >> 4) || (cmf * 256u + flg) % 31u != 0 || (flg & 0x20u) != 0) {
+		return false;
+	}
+
+	dst.resize(size + kOutputSlack);
+	uint8_t* begin = dst.data();
+	uint8_t* out = begin;
+	uint8_t* end = begin + size;
+
+	BitReader reader(source.subspan(2));
+	bool isFinal = false;
+	while (!isFinal) {
+		reader.Refill();
+		isFinal = reader.Read(1) != 0;
+		const uint32_t type = reader.Read(2);
+
+		bool isSucceeded = false;
+		if (type == 0) {
+			// 無圧縮のブロック
+			const uint8_t* pos = reader.AlignToByte();
+			if (reader.GetEnd() - pos < 4) {
+				return false;
+			}
+			const uint32_t length = pos[0] | (static_cast<uint32_t>(pos[1]) << 8);
+			const uint32_t lengthComplement = pos[2] | (static_cast<uint32_t>(pos[3]) << 8);
+			pos += 4;
+			if ((length ^ 0xffffu) != lengthComplement || static_cast<size_t>(reader.GetEnd() - pos) < length || static_cast<size_t>(end - out) < length) {
+				return false;
+			}
+			std::memcpy(out, pos, length);
+			out += length;
+			reader.Seek(pos + length);
+			isSucceeded = true;
+		}
+		else if (type == 1) {
+			const FixedHuffman& fixedHuffman = GetFixedHuffman();
+			isSucceeded = InflateBlock(reader, fixedHuffman.literal, fixedHuffman.distance, begin, out, end);
+		}
+		else if (type == 2) {
+			Huffman literal;
+			Huffman distance;
+			isSucceeded = ReadDynamicHuffman(reader, literal, distance)
+				&& InflateBlock(reader, literal, distance, begin, out, end);
+		}
+
+		if (!isSucceeded || reader.IsOverrun()) {
+			return false;
+		}
+	}
+
+	// 最後のブロックの後ろにビッグエンディアンのAdler-32がある
+	const uint8_t* checksum = reader.AlignToByte();
+	if (out != end || reader.GetEnd() - checksum < 4) {
+		return false;
+	}
+	const uint32_t expected = (static_cast<uint32_t>(checksum[0]) << 24) | (static_cast<uint32_t>(checksum[1]) << 16)
+		| (static_cast<uint32_t>(checksum[2]) << 8) | checksum[3];
+	if (Adler32(begin, size) != expected) {
+		return false;
+	}
+
+	dst.resize(size);
+	return true;
+}
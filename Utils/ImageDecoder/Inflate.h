@@ -0,0 +1,15 @@
+#pragma once
+#include <vector>
+#include <span>
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// zlib形式(RFC 1950)のDeflate(RFC 1951)のデータを展開する
+/// 展開後の大きさが分かっているデータ専用(PNGのIDATなど)
+/// </summary>
+/// <param name="source">zlibのヘッダーとAdler-32を含むデータ</param>
+/// <param name="size">展開後のバイト数(違っていたら失敗にする)</param>
+/// <param name="dst">展開したデータ(大きさはsizeになる)</param>
+/// <returns>成功したか(データが壊れている、大きさが違う、チェックサムが合わない時は失敗)</returns>
+bool InflateZlib(std::span<const uint8_t> source, size_t size, std::vector<uint8_t>& dst);
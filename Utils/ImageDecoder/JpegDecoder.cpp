@@ -0,0 +1,869 @@
+#include "JpegDecoder.h"
+#include <array>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+	/// <summary>
+	/// 受け付ける幅と高さの上限(D3D12のテクスチャの上限)
+	/// </summary>
+	constexpr uint32_t kMaxSize = 16384;
+	constexpr size_t kMaxComponentNum = 3;
+	constexpr size_t kBlockSize = 8;
+	constexpr size_t kCoefficientNum = 64;
+	/// <summary>
+	/// 1回の表引きで復号する符号の最大ビット数
+	/// </summary>
+	constexpr uint32_t kFastBits = 9;
+	constexpr uint32_t kMaxCodeLength = 16;
+
+	/// <summary>
+	/// ジグザグの順番から行優先の順番へ
+	/// </summary>
+	constexpr std::array<uint8_t, kCoefficientNum> kZigzag = {
+		0, 1, 8, 16, 9, 2, 3, 10, 17, 24, 32, 25, 18, 11, 4, 5,
+		12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13, 6, 7, 14, 21, 28,
+		35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+		58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63
+	};
+
+	enum Marker : uint8_t {
+		kSof0 = 0xC0,
+		kSof1 = 0xC1,
+		kDht = 0xC4,
+		kRst0 = 0xD0,
+		kRst7 = 0xD7,
+		kSoi = 0xD8,
+		kEoi = 0xD9,
+		kSos = 0xDA,
+		kDqt = 0xDB,
+		kDri = 0xDD,
+		kApp14 = 0xEE
+	};
+
+	uint16_t ReadU16(const uint8_t* data) {
+		return static_cast<uint16_t>((data[0] << 8) | data[1]);
+	}
+
+	/// <summary>
+	/// エントロピー符号化されたデータを上位ビットから読む(0xFF00は0xFFにし、マーカーの後ろは0を読む)
+	/// </summary>
+	class BitReader {
+	public:
+		BitReader(const uint8_t* pos_, const uint8_t* end_) :
+			pos(pos_),
+			end(end_),
+			bits(0),
+			bitNum(0),
+			isMarkerFound(false)
+		{}
+
+	public:
+		/// <summary>
+		/// 56ビット以上読める状態にする
+		/// </summary>
+		void Refill() {
+			while (bitNum <= 56) {
+				uint32_t byte = 0;
+				if (!isMarkerFound && pos < end) {
+					byte = *pos;
+					if (byte != 0xFF) {
+						pos++;
+					}
+					else if (end - pos < 2 || pos[1] != 0) {
+						// マーカーなので、ここで止める
+						isMarkerFound = true;
+						byte = 0;
+					}
+					else {
+						pos += 2;
+					}
+				}
+				bits |= static_cast<uint64_t>(byte) << (56 - bitNum);
+				bitNum += 8;
+			}
+		}
+
+		uint32_t Peek(uint32_t n) const {
+			return static_cast<uint32_t>(bits >> (64 - n));
+		}
+		void Consume(uint32_t n) {
+			bits <<= n;
+			bitNum -= n;
+		}
+		uint32_t Read(uint32_t n) {
+			if (n == 0) {
+				return 0;
+			}
+			const uint32_t value = Peek(n);
+			Consume(n);
+			return value;
+		}
+
+		/// <summary>
+		/// リスタートマーカーの後ろから読み直す
+		/// </summary>
+		void Restart() {
+			if (!isMarkerFound) {
+				// 残りのビットを捨ててマーカーを探す
+				while (pos < end && !(pos[0] == 0xFF && end - pos >= 2 && pos[1] != 0)) {
+					pos++;
+				}
+			}
+			if (end - pos >= 2 && pos[0] == 0xFF && kRst0 <= pos[1] && pos[1] <= kRst7) {
+				pos += 2;
+			}
+			bits = 0;
+			bitNum = 0;
+			isMarkerFound = false;
+		}
+
+		const uint8_t* GetPosition() const {
+			return pos;
+		}
+
+	private:
+		const uint8_t* pos;
+		const uint8_t* end;
+		uint64_t bits;
+		uint32_t bitNum;
+		bool isMarkerFound;
+	};
+
+	struct Huffman {
+		/// <summary>
+		/// kFastBitsまでの符号を上位ビットで引く((符号長 << 8) | 記号。0なら長い符号か不正な符号)
+		/// </summary>
+		std::array<uint16_t, 1 << kFastBits> fast{};
+		/// <summary>
+		/// 符号長ごとの最後の符号(無ければ-1)
+		/// </summary>
+		std::array<int32_t, kMaxCodeLength + 1> maxCode{};
+		/// <summary>
+		/// 符号に足すと記号の番号になる値
+		/// </summary>
+		std::array<int32_t, kMaxCodeLength + 1> valueOffset{};
+		std::array<uint8_t, 256> symbols{};
+		bool isDefined = false;
+
+		bool Build(const uint8_t* counts, std::span<const uint8_t> values) {
+			std::copy(values.begin(), values.end(), symbols.begin());
+
+			int32_t code = 0;
+			int32_t index = 0;
+			for (uint32_t length = 1; length <= kMaxCodeLength; length++) {
+				const int32_t count = counts[length - 1];
+				valueOffset[length] = index - code;
+				code += count;
+				index += count;
+				maxCode[length] = count == 0 ? -1 : code - 1;
+				if ((1 << length) < code) {
+					return false;
+				}
+				code <<= 1;
+			}
+
+			fast.fill(0);
+			code = 0;
+			index = 0;
+			for (uint32_t length = 1; length <= kFastBits; length++) {
+				for (uint32_t i = 0; i < counts[length - 1]; i++, code++, index++) {
+					const uint32_t first = static_cast<uint32_t>(code) << (kFastBits - length);
+					for (uint32_t j = 0; j < (1u << (kFastBits - length)); j++) {
+						fast[first | j] = static_cast<uint16_t>((length << 8) | symbols[index]);
+					}
+				}
+				code <<= 1;
+			}
+
+			isDefined = true;
+			return true;
+		}
+
+		/// <summary>
+		/// 記号を1つ読む(Refill()の後に呼ぶ)
+		/// </summary>
+		/// <returns>不正な符号なら-1</returns>
+		int32_t Decode(BitReader& reader) const {
+			const uint32_t entry = fast[reader.Peek(kFastBits)];
+			if (entry != 0) {
+				reader.Consume(entry >> 8);
+				return static_cast<int32_t>(entry & 0xff);
+			}
+			for (uint32_t length = kFastBits + 1; length <= kMaxCodeLength; length++) {
+				const int32_t code = static_cast<int32_t>(reader.Peek(length));
+				if (code <= maxCode[length]) {
+					reader.Consume(length);
+					return symbols[static_cast<uint8_t>(code + valueOffset[length])];
+				}
+			}
+			return -1;
+		}
+	};
+
+	struct Component {
+		uint8_t id = 0;
+		uint32_t horizontal = 1;
+		uint32_t vertical = 1;
+		uint32_t quantIndex = 0;
+		uint32_t dcIndex = 0;
+		uint32_t acIndex = 0;
+		int32_t dcPredictor = 0;
+
+		/// <summary>
+		/// 間引いた後の大きさ
+		/// </summary>
+		uint32_t width = 0;
+		uint32_t height = 0;
+		/// <summary>
+		/// MCUの端まで含めたブロックを展開した画素
+		/// </summary>
+		uint32_t planeWidth = 0;
+		uint32_t planeHeight = 0;
+		std::vector<uint8_t> plane;
+		bool isDecoded = false;
+	};
+
+	struct Decoder {
+		std::array<std::array<uint16_t, kCoefficientNum>, 4> quantTables{};
+		std::array<Huffman, 4> dcTables;
+		std::array<Huffman, 4> acTables;
+		uint32_t restartInterval = 0;
+
+		uint32_t width = 0;
+		uint32_t height = 0;
+		std::vector<Component> components;
+		uint32_t maxHorizontal = 1;
+		uint32_t maxVertical = 1;
+		uint32_t mcuX = 0;
+		uint32_t mcuY = 0;
+
+		bool isJfif = false;
+		/// <summary>
+		/// AdobeのAPP14の色変換(無ければ-1)
+		/// </summary>
+		int32_t adobeTransform = -1;
+	};
+
+	int32_t Extend(uint32_t value, uint32_t bitNum) {
+		return bitNum == 0 ? 0
+			: value < (1u << (bitNum - 1)) ? static_cast<int32_t>(value) - static_cast<int32_t>((1u << bitNum) - 1u)
+			: static_cast<int32_t>(value);
+	}
+
+	/// <summary>
+	/// 逆DCTの結果(-128足した値)を0から255にする(libjpegの範囲制限の表と同じく、1024で折り返す)
+	/// </summary>
+	struct RangeLimitTable {
+		std::array<uint8_t, 1024> values;
+
+		RangeLimitTable() : values() {
+			for (int32_t i = 0; i < 1024; i++) {
+				values[i] = i < 128 ? static_cast<uint8_t>(i + 128)
+					: i < 512 ? uint8_t{ 255 }
+					: i < 896 ? uint8_t{ 0 }
+					: static_cast<uint8_t>(i - 896);
+			}
+		}
+	};
+	const RangeLimitTable kRangeLimit;
+
+	/// <summary>
+	/// 整数の逆DCT(libjpegのjpeg_idct_islowと同じ計算)
+	/// </summary>
+	void InverseDct(const std::array<int32_t, kCoefficientNum>& coefficients, const std::array<uint16_t, kCoefficientNum>& quant, uint8_t* dst, size_t stride) {
+		constexpr int32_t kConstBits = 13;
+		constexpr int32_t kPass1Bits = 2;
+		constexpr int32_t kFix0_298631336 = 2446;
+		constexpr int32_t kFix0_390180644 = 3196;
+		constexpr int32_t kFix0_541196100 = 4433;
+		constexpr int32_t kFix0_765366865 = 6270;
+		constexpr int32_t kFix0_899976223 = 7373;
+		constexpr int32_t kFix1_175875602 = 9633;
+		constexpr int32_t kFix1_501321110 = 12299;
+		constexpr int32_t kFix1_847759065 = 15137;
+		constexpr int32_t kFix1_961570560 = 16069;
+		constexpr int32_t kFix2_053119869 = 16819;
+		constexpr int32_t kFix2_562915447 = 20995;
+		constexpr int32_t kFix3_072711026 = 25172;
+		const auto descale = [](int32_t value, int32_t n) {
+			return (value + (1 << (n - 1))) >> n;
+		};
+
+		std::array<int32_t, kCoefficientNum> workspace;
+
+		// 列ごと
+		for (size_t x = 0; x < kBlockSize; x++) {
+			const auto in = [&](size_t y) {
+				return coefficients[y * kBlockSize + x] * static_cast<int32_t>(quant[y * kBlockSize + x]);
+			};
+			if (coefficients[8 + x] == 0 && coefficients[16 + x] == 0 && coefficients[24 + x] == 0 && coefficients[32 + x] == 0
+				&& coefficients[40 + x] == 0 && coefficients[48 + x] == 0 && coefficients[56 + x] == 0
+			) {
+				const int32_t dc = in(0) * (1 << kPass1Bits);
+				for (size_t y = 0; y < kBlockSize; y++) {
+					workspace[y * kBlockSize + x] = dc;
+				}
+				continue;
+			}
+
+			// 偶数部
+			int32_t z2 = in(2);
+			int32_t z3 = in(6);
+			int32_t z1 = (z2 + z3) * kFix0_541196100;
+			int32_t tmp2 = z1 + z3 * -kFix1_847759065;
+			int32_t tmp3 = z1 + z2 * kFix0_765366865;
+			z2 = in(0);
+			z3 = in(4);
+			int32_t tmp0 = (z2 + z3) * (1 << kConstBits);
+			int32_t tmp1 = (z2 - z3) * (1 << kConstBits);
+			const int32_t tmp10 = tmp0 + tmp3;
+			const int32_t tmp13 = tmp0 - tmp3;
+			const int32_t tmp11 = tmp1 + tmp2;
+			const int32_t tmp12 = tmp1 - tmp2;
+
+			// 奇数部
+			tmp0 = in(7);
+			tmp1 = in(5);
+			tmp2 = in(3);
+			tmp3 = in(1);
+			z1 = tmp0 + tmp3;
+			z2 = tmp1 + tmp2;
+			z3 = tmp0 + tmp2;
+			int32_t z4 = tmp1 + tmp3;
+			const int32_t z5 = (z3 + z4) * kFix1_175875602;
+			tmp0 = tmp0 * kFix0_298631336;
+			tmp1 = tmp1 * kFix2_053119869;
+			tmp2 = tmp2 * kFix3_072711026;
+			tmp3 = tmp3 * kFix1_501321110;
+			z1 = z1 * -kFix0_899976223;
+			z2 = z2 * -kFix2_562915447;
+			z3 = z3 * -kFix1_961570560 + z5;
+			z4 = z4 * -kFix0_390180644 + z5;
+			tmp0 += z1 + z3;
+			tmp1 += z2 + z4;
+			tmp2 += z2 + z3;
+			tmp3 += z1 + z4;
+
+			constexpr int32_t kShift = kConstBits - kPass1Bits;
+			workspace[0 * kBlockSize + x] = descale(tmp10 + tmp3, kShift);
+			workspace[7 * kBlockSize + x] = descale(tmp10 - tmp3, kShift);
+			workspace[1 * kBlockSize + x] = descale(tmp11 + tmp2, kShift);
+			workspace[6 * kBlockSize + x] = descale(tmp11 - tmp2, kShift);
+			workspace[2 * kBlockSize + x] = descale(tmp12 + tmp1, kShift);
+			workspace[5 * kBlockSize + x] = descale(tmp12 - tmp1, kShift);
+			workspace[3 * kBlockSize + x] = descale(tmp13 + tmp0, kShift);
+			workspace[4 * kBlockSize + x] = descale(tmp13 - tmp0, kShift);
+		}
+
+		// 行ごと
+		constexpr int32_t kShift = kConstBits + kPass1Bits + 3;
+		for (size_t y = 0; y < kBlockSize; y++, dst += stride) {
+			const int32_t* row = workspace.data() + y * kBlockSize;
+			if (row[1] == 0 && row[2] == 0 && row[3] == 0 && row[4] == 0 && row[5] == 0 && row[6] == 0 && row[7] == 0) {
+				const uint8_t dc = kRangeLimit.values[descale(row[0], kPass1Bits + 3) & 1023];
+				std::memset(dst, dc, kBlockSize);
+				continue;
+			}
+
+			int32_t z2 = row[2];
+			int32_t z3 = row[6];
+			int32_t z1 = (z2 + z3) * kFix0_541196100;
+			int32_t tmp2 = z1 + z3 * -kFix1_847759065;
+			int32_t tmp3 = z1 + z2 * kFix0_765366865;
+			int32_t tmp0 = (row[0] + row[4]) * (1 << kConstBits);
+			int32_t tmp1 = (row[0] - row[4]) * (1 << kConstBits);
+			const int32_t tmp10 = tmp0 + tmp3;
+			const int32_t tmp13 = tmp0 - tmp3;
+			const int32_t tmp11 = tmp1 + tmp2;
+			const int32_t tmp12 = tmp1 - tmp2;
+
+			tmp0 = row[7];
+			tmp1 = row[5];
+			tmp2 = row[3];
+			tmp3 = row[1];
+			z1 = tmp0 + tmp3;
+			z2 = tmp1 + tmp2;
+			z3 = tmp0 + tmp2;
+			int32_t z4 = tmp1 + tmp3;
+			const int32_t z5 = (z3 + z4) * kFix1_175875602;
+			tmp0 = tmp0 * kFix0_298631336;
+			tmp1 = tmp1 * kFix2_053119869;
+			tmp2 = tmp2 * kFix3_072711026;
+			tmp3 = tmp3 * kFix1_501321110;
+			z1 = z1 * -kFix0_899976223;
+			z2 = z2 * -kFix2_562915447;
+			z3 = z3 * -kFix1_961570560 + z5;
+			z4 = z4 * -kFix0_390180644 + z5;
+			tmp0 += z1 + z3;
+			tmp1 += z2 + z4;
+			tmp2 += z2 + z3;
+			tmp3 += z1 + z4;
+
+			dst[0] = kRangeLimit.values[descale(tmp10 + tmp3, kShift) & 1023];
+			dst[7] = kRangeLimit.values[descale(tmp10 - tmp3, kShift) & 1023];
+			dst[1] = kRangeLimit.values[descale(tmp11 + tmp2, kShift) & 1023];
+			dst[6] = kRangeLimit.values[descale(tmp11 - tmp2, kShift) & 1023];
+			dst[2] = kRangeLimit.values[descale(tmp12 + tmp1, kShift) & 1023];
+			dst[5] = kRangeLimit.values[descale(tmp12 - tmp1, kShift) & 1023];
+			dst[3] = kRangeLimit.values[descale(tmp13 + tmp0, kShift) & 1023];
+			dst[4] = kRangeLimit.values[descale(tmp13 - tmp0, kShift) & 1023];
+		}
+	}
+
+	/// <summary>
+	/// 1ブロックを復号して逆DCTする
+	/// </summary>
+	bool DecodeBlock(BitReader& reader, const Decoder& decoder, Component& component, uint8_t* dst) {
+		const Huffman& dcTable = decoder.dcTables[component.dcIndex];
+		const Huffman& acTable = decoder.acTables[component.acIndex];
+		std::array<int32_t, kCoefficientNum> coefficients{};
+
+		// 記号は16ビット、追加ビットは11ビットまでなので、1回の補充で足りる
+		reader.Refill();
+		const int32_t dcBitNum = dcTable.Decode(reader);
+		if (dcBitNum < 0 || 11 < dcBitNum) {
+			return false;
+		}
+		component.dcPredictor += Extend(reader.Read(static_cast<uint32_t>(dcBitNum)), static_cast<uint32_t>(dcBitNum));
+		coefficients[0] = component.dcPredictor;
+
+		for (size_t k = 1; k < kCoefficientNum;) {
+			reader.Refill();
+			const int32_t symbol = acTable.Decode(reader);
+			if (symbol < 0) {
+				return false;
+			}
+			const uint32_t run = static_cast<uint32_t>(symbol) >> 4;
+			const uint32_t bitNum = static_cast<uint32_t>(symbol) & 15u;
+			if (bitNum == 0) {
+				if (run != 15) {
+					// ブロックの終わり
+					break;
+				}
+				k += 16;
+				continue;
+			}
+			k += run;
+			if (kCoefficientNum <= k) {
+				return false;
+			}
+			coefficients[kZigzag[k]] = Extend(reader.Read(bitNum), bitNum);
+			k++;
+		}
+
+		InverseDct(coefficients, decoder.quantTables[component.quantIndex], dst, component.planeWidth);
+		return true;
+	}
+
+	bool ParseFrame(std::span<const uint8_t> segment, Decoder& decoder) {
+		if (segment.size() < 6 || segment[0] != 8 || !decoder.components.empty()) {
+			return false;
+		}
+		decoder.height = ReadU16(segment.data() + 1);
+		decoder.width = ReadU16(segment.data() + 3);
+		const size_t componentNum = segment[5];
+		if (decoder.width == 0 || decoder.height == 0 || kMaxSize < decoder.width || kMaxSize < decoder.height
+			|| (componentNum != 1 && componentNum != kMaxComponentNum) || segment.size() < 6 + componentNum * 3
+		) {
+			return false;
+		}
+
+		decoder.components.resize(componentNum);
+		for (size_t i = 0; i < componentNum; i++) {
+			Component& component = decoder.components[i];
+			const uint8_t* data = segment.data() + 6 + i * 3;
+			component.id = data[0];
+			component.horizontal = data[1] >> 4;
+			component.vertical = data[1] & 15u;
+			component.quantIndex = data[2];
+			if (component.horizontal < 1 || 4 < component.horizontal || component.vertical < 1 || 4 < component.vertical || 3 < component.quantIndex) {
+				return false;
+			}
+			decoder.maxHorizontal = std::max(decoder.maxHorizontal, component.horizontal);
+			decoder.maxVertical = std::max(decoder.maxVertical, component.vertical);
+		}
+
+		decoder.mcuX = (decoder.width + decoder.maxHorizontal * kBlockSize - 1) / (decoder.maxHorizontal * kBlockSize);
+		decoder.mcuY = (decoder.height + decoder.maxVertical * kBlockSize - 1) / (decoder.maxVertical * kBlockSize);
+		for (auto& component : decoder.components) {
+			// アップサンプリングは2倍まで
+			const uint32_t horizontalScale = decoder.maxHorizontal / component.horizontal;
+			const uint32_t verticalScale = decoder.maxVertical / component.vertical;
+			if (decoder.maxHorizontal % component.horizontal != 0 || decoder.maxVertical % component.vertical != 0
+				|| 2 < horizontalScale || 2 < verticalScale
+			) {
+				return false;
+			}
+			component.width = (decoder.width * component.horizontal + decoder.maxHorizontal - 1) / decoder.maxHorizontal;
+			component.height = (decoder.height * component.vertical + decoder.maxVertical - 1) / decoder.maxVertical;
+			component.planeWidth = decoder.mcuX * component.horizontal * kBlockSize;
+			component.planeHeight = decoder.mcuY * component.vertical * kBlockSize;
+			component.plane.resize(static_cast<size_t>(component.planeWidth) * component.planeHeight);
+		}
+		return true;
+	}
+
+	bool ParseQuantTables(std::span<const uint8_t> segment, Decoder& decoder) {
+		size_t offset = 0;
+		while (offset < segment.size()) {
+			const uint32_t precision = segment[offset] >> 4;
+			const uint32_t index = segment[offset] & 15u;
+			const size_t valueSize = precision == 0 ? 1 : 2;
+			if (1 < precision || 3 < index || segment.size() - offset - 1 < kCoefficientNum * valueSize) {
+				return false;
+			}
+			offset++;
+			for (size_t k = 0; k < kCoefficientNum; k++, offset += valueSize) {
+				decoder.quantTables[index][kZigzag[k]] = valueSize == 1 ? segment[offset] : ReadU16(segment.data() + offset);
+			}
+		}
+		return true;
+	}
+
+	bool ParseHuffmanTables(std::span<const uint8_t> segment, Decoder& decoder) {
+		size_t offset = 0;
+		while (offset < segment.size()) {
+			if (segment.size() - offset < 17) {
+				return false;
+			}
+			const uint32_t tableClass = segment[offset] >> 4;
+			const uint32_t index = segment[offset] & 15u;
+			const uint8_t* counts = segment.data() + offset + 1;
+			size_t valueNum = 0;
+			for (size_t i = 0; i < kMaxCodeLength; i++) {
+				valueNum += counts[i];
+			}
+			offset += 17;
+			if (1 < tableClass || 3 < index || 256 < valueNum || segment.size() - offset < valueNum) {
+				return false;
+			}
+			Huffman& table = tableClass == 0 ? decoder.dcTables[index] : decoder.acTables[index];
+			if (!table.Build(counts, segment.subspan(offset, valueNum))) {
+				return false;
+			}
+			offset += valueNum;
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// スキャンのヘッダーを読んで、続くエントロピー符号化されたデータを復号する
+	/// </summary>
+	/// <returns>スキャンの後ろ(失敗したらnullptr)</returns>
+	const uint8_t* DecodeScan(std::span<const uint8_t> segment, const uint8_t* pos, const uint8_t* end, Decoder& decoder) {
+		if (decoder.components.empty() || segment.empty()) {
+			return nullptr;
+		}
+		const size_t scanComponentNum = segment[0];
+		if (scanComponentNum < 1 || decoder.components.size() < scanComponentNum || segment.size() != 4 + scanComponentNum * 2) {
+			return nullptr;
+		}
+
+		std::array<Component*, kMaxComponentNum> scanComponents{};
+		for (size_t i = 0; i < scanComponentNum; i++) {
+			const uint8_t id = segment[1 + i * 2];
+			const uint8_t tables = segment[2 + i * 2];
+			const auto itr = std::find_if(decoder.components.begin(), decoder.components.end(), [id](const Component& component) { return component.id == id; });
+			if (itr == decoder.components.end()) {
+				return nullptr;
+			}
+			itr->dcIndex = tables >> 4;
+			itr->acIndex = tables & 15u;
+			if (3 < itr->dcIndex || 3 < itr->acIndex || !decoder.dcTables[itr->dcIndex].isDefined || !decoder.acTables[itr->acIndex].isDefined) {
+				return nullptr;
+			}
+			itr->dcPredictor = 0;
+			itr->isDecoded = true;
+			scanComponents[i] = &*itr;
+		}
+		// ベースラインは全ての係数を1回のスキャンで送る
+		const uint8_t* spectral = segment.data() + 1 + scanComponentNum * 2;
+		if (spectral[0] != 0 || spectral[1] != 63 || spectral[2] != 0) {
+			return nullptr;
+		}
+
+		BitReader reader(pos, end);
+		// 1成分だけのスキャンは、MCUではなく成分の大きさのブロックを順に並べる
+		const bool isInterleaved = 1 < scanComponentNum;
+		const Component& first = *scanComponents[0];
+		const uint32_t mcuX = isInterleaved ? decoder.mcuX : (first.width + kBlockSize - 1) / kBlockSize;
+		const uint32_t mcuY = isInterleaved ? decoder.mcuY : (first.height + kBlockSize - 1) / kBlockSize;
+		uint32_t restartCount = 0;
+		for (uint32_t my = 0; my < mcuY; my++) {
+			for (uint32_t mx = 0; mx < mcuX; mx++) {
+				if (decoder.restartInterval != 0 && restartCount == decoder.restartInterval) {
+					reader.Restart();
+					for (size_t i = 0; i < scanComponentNum; i++) {
+						scanComponents[i]->dcPredictor = 0;
+					}
+					restartCount = 0;
+				}
+				restartCount++;
+
+				for (size_t i = 0; i < scanComponentNum; i++) {
+					Component& component = *scanComponents[i];
+					const uint32_t blockX = isInterleaved ? component.horizontal : 1;
+					const uint32_t blockY = isInterleaved ? component.vertical : 1;
+					for (uint32_t by = 0; by < blockY; by++) {
+						for (uint32_t bx = 0; bx < blockX; bx++) {
+							const size_t x = (static_cast<size_t>(mx) * blockX + bx) * kBlockSize;
+							const size_t y = (static_cast<size_t>(my) * blockY + by) * kBlockSize;
+							if (!DecodeBlock(reader, decoder, component, component.plane.data() + y * component.planeWidth + x)) {
+								return nullptr;
+							}
+						}
+					}
+				}
+			}
+		}
+
+		return reader.GetPosition();
+	}
+
+	/// <summary>
+	/// 色差の1行を元の大きさに広げる(libjpegのfancy upsamplingと同じ計算)
+	/// </summary>
+	/// <returns>広げた行(広げない時は成分の行をそのまま返す)</returns>
+	const uint8_t* UpsampleRow(const Decoder& decoder, const Component& component, uint32_t y, uint8_t* buffer) {
+		const uint32_t horizontalScale = decoder.maxHorizontal / component.horizontal;
+		const uint32_t verticalScale = decoder.maxVertical / component.vertical;
+		const auto getRow = [&component](int64_t row) {
+			row = std::clamp<int64_t>(row, 0, static_cast<int64_t>(component.height) - 1);
+			return component.plane.data() + static_cast<size_t>(row) * component.planeWidth;
+		};
+
+		const int64_t inputY = y / verticalScale;
+		const bool isUpper = y % verticalScale == 0;
+		const uint8_t* row = getRow(inputY);
+		if (horizontalScale == 1 && verticalScale == 1) {
+			return row;
+		}
+
+		const uint32_t width = component.width;
+		if (horizontalScale == 1) {
+			// 縦だけ2倍
+			const uint8_t* other = getRow(isUpper ? inputY - 1 : inputY + 1);
+			const int32_t bias = isUpper ? 1 : 2;
+			for (uint32_t x = 0; x < width; x++) {
+				buffer[x] = static_cast<uint8_t>((row[x] * 3 + other[x] + bias) >> 2);
+			}
+			return buffer;
+		}
+
+		// 幅が2以下だとlibjpegは単純に繰り返す
+		if (width <= 2) {
+			for (uint32_t x = 0; x < width * 2; x++) {
+				buffer[x] = row[x / 2];
+			}
+			return buffer;
+		}
+
+		if (verticalScale == 1) {
+			// 横だけ2倍
+			buffer[0] = row[0];
+			buffer[1] = static_cast<uint8_t>((row[0] * 3 + row[1] + 2) >> 2);
+			for (uint32_t x = 1; x + 1 < width; x++) {
+				const int32_t center = row[x] * 3;
+				buffer[x * 2] = static_cast<uint8_t>((center + row[x - 1] + 1) >> 2);
+				buffer[x * 2 + 1] = static_cast<uint8_t>((center + row[x + 1] + 2) >> 2);
+			}
+			buffer[width * 2 - 2] = static_cast<uint8_t>((row[width - 1] * 3 + row[width - 2] + 1) >> 2);
+			buffer[width * 2 - 1] = row[width - 1];
+			return buffer;
+		}
+
+		// 縦横2倍(先に縦に3:1で混ぜた列の和を横に3:1で混ぜる)
+		const uint8_t* other = getRow(isUpper ? inputY - 1 : inputY + 1);
+		const auto columnSum = [&](uint32_t x) {
+			return row[x] * 3 + other[x];
+		};
+		buffer[0] = static_cast<uint8_t>((columnSum(0) * 4 + 8) >> 4);
+		buffer[1] = static_cast<uint8_t>((columnSum(0) * 3 + columnSum(1) + 7) >> 4);
+		for (uint32_t x = 1; x + 1 < width; x++) {
+			const int32_t center = columnSum(x) * 3;
+			buffer[x * 2] = static_cast<uint8_t>((center + columnSum(x - 1) + 8) >> 4);
+			buffer[x * 2 + 1] = static_cast<uint8_t>((center + columnSum(x + 1) + 7) >> 4);
+		}
+		buffer[width * 2 - 2] = static_cast<uint8_t>((columnSum(width - 1) * 3 + columnSum(width - 2) + 8) >> 4);
+		buffer[width * 2 - 1] = static_cast<uint8_t>((columnSum(width - 1) * 4 + 7) >> 4);
+		return buffer;
+	}
+
+	/// <summary>
+	/// YCbCrからRGBへの変換表(libjpegと同じ16ビットの固定小数点)
+	/// </summary>
+	struct YCbCrTable {
+		std::array<int32_t, 256> crToR;
+		std::array<int32_t, 256> cbToB;
+		std::array<int32_t, 256> crToG;
+		std::array<int32_t, 256> cbToG;
+
+		YCbCrTable() : crToR(), cbToB(), crToG(), cbToG() {
+			constexpr int32_t kScaleBits = 16;
+			constexpr int32_t kHalf = 1 << (kScaleBits - 1);
+			const auto fix = [](double value) {
+				return static_cast<int32_t>(value * (1 << kScaleBits) + 0.5);
+			};
+			for (int32_t i = 0; i < 256; i++) {
+				const int32_t x = i - 128;
+				crToR[i] = (fix(1.40200) * x + kHalf) >> kScaleBits;
+				cbToB[i] = (fix(1.77200) * x + kHalf) >> kScaleBits;
+				crToG[i] = -fix(0.71414) * x;
+				cbToG[i] = -fix(0.34414) * x + kHalf;
+			}
+		}
+	};
+
+	uint8_t Clamp(int32_t value) {
+		return static_cast<uint8_t>(std::clamp(value, 0, 255));
+	}
+}
+
+bool DecodeJpeg(std::span<const uint8_t> data, ImageDecoder::Image& image) {
+	if (data.size() < 4 || data[0] != 0xFF || data[1] != kSoi) {
+		return false;
+	}
+
+	Decoder decoder;
+	const uint8_t* pos = data.data() + 2;
+	const uint8_t* end = data.data() + data.size();
+	bool isEnd = false;
+	while (!isEnd) {
+		// 次のマーカーを探す(間の0xFFの詰め物は飛ばす)
+		while (pos < end && *pos != 0xFF) {
+			pos++;
+		}
+		while (pos < end && *pos == 0xFF) {
+			pos++;
+		}
+		if (end <= pos) {
+			// EOIが無くても、全ての成分があればそこまでで終わる
+			break;
+		}
+		const uint8_t marker = *pos++;
+		if (marker == kEoi) {
+			isEnd = true;
+			continue;
+		}
+		if (marker == 0 || (kRst0 <= marker && marker <= kRst7) || marker == 0x01) {
+			// 長さの無いマーカー
+			continue;
+		}
+
+		if (end - pos < 2) {
+			return false;
+		}
+		const size_t length = ReadU16(pos);
+		if (length < 2 || static_cast<size_t>(end - pos) < length) {
+			return false;
+		}
+		const std::span<const uint8_t> segment(pos + 2, length - 2);
+		pos += length;
+
+		bool isSucceeded = true;
+		switch (marker) {
+		case kSof0:
+		case kSof1:
+			isSucceeded = ParseFrame(segment, decoder);
+			break;
+		case kDqt:
+			isSucceeded = ParseQuantTables(segment, decoder);
+			break;
+		case kDht:
+			isSucceeded = ParseHuffmanTables(segment, decoder);
+			break;
+		case kDri:
+			isSucceeded = 2 <= segment.size();
+			if (isSucceeded) {
+				decoder.restartInterval = ReadU16(segment.data());
+			}
+			break;
+		case kSos:
+			pos = DecodeScan(segment, pos, end, decoder);
+			isSucceeded = pos != nullptr;
+			break;
+		case 0xE0:
+			decoder.isJfif = decoder.isJfif || (5 <= segment.size() && std::memcmp(segment.data(), "JFIF", 5) == 0);
+			break;
+		case kApp14:
+			if (12 <= segment.size() && std::memcmp(segment.data(), "Adobe", 5) == 0) {
+				decoder.adobeTransform = segment[11];
+			}
+			break;
+		default:
+			// プログレッシブ、算術符号、ロスレスなどのフレームは対応しない
+			isSucceeded = !(0xC0 <= marker && marker <= 0xCF && marker != kDht && marker != 0xC8 && marker != 0xCC);
+			break;
+		}
+		if (!isSucceeded) {
+			return false;
+		}
+	}
+
+	if (decoder.components.empty()) {
+		return false;
+	}
+	for (const auto& component : decoder.components) {
+		if (!component.isDecoded) {
+			return false;
+		}
+	}
+
+	// 3成分の色空間はlibjpegと同じ順番で決める
+	bool isRgb = false;
+	if (decoder.components.size() == kMaxComponentNum && !decoder.isJfif) {
+		if (0 <= decoder.adobeTransform) {
+			isRgb = decoder.adobeTransform == 0;
+		}
+		else {
+			isRgb = decoder.components[0].id == 'R' && decoder.components[1].id == 'G' && decoder.components[2].id == 'B';
+		}
+	}
+
+	static const YCbCrTable kYCbCrTable;
+	image.width = decoder.width;
+	image.height = decoder.height;
+	image.pixels.resize(static_cast<size_t>(decoder.width) * decoder.height * 4);
+	std::array<std::vector<uint8_t>, kMaxComponentNum> buffers;
+	for (auto& buffer : buffers) {
+		buffer.resize(static_cast<size_t>(decoder.width) + kBlockSize * 2);
+	}
+	std::array<const uint8_t*, kMaxComponentNum> rows{};
+	for (uint32_t y = 0; y < decoder.height; y++) {
+		for (size_t i = 0; i < decoder.components.size(); i++) {
+			rows[i] = UpsampleRow(decoder, decoder.components[i], y, buffers[i].data());
+		}
+
+		uint8_t* dst = image.pixels.data() + static_cast<size_t>(y) * decoder.width * 4;
+		if (decoder.components.size() == 1) {
+			for (uint32_t x = 0; x < decoder.width; x++, dst += 4) {
+				dst[0] = rows[0][x];
+				dst[1] = rows[0][x];
+				dst[2] = rows[0][x];
+				dst[3] = 255;
+			}
+		}
+		else if (isRgb) {
+			for (uint32_t x = 0; x < decoder.width; x++, dst += 4) {
+				dst[0] = rows[0][x];
+				dst[1] = rows[1][x];
+				dst[2] = rows[2][x];
+				dst[3] = 255;
+			}
+		}
+		else {
+			for (uint32_t x = 0; x < decoder.width; x++, dst += 4) {
+				const int32_t luma = rows[0][x];
+				const uint8_t cb = rows[1][x];
+				const uint8_t cr = rows[2][x];
+				dst[0] = Clamp(luma + kYCbCrTable.crToR[cr]);
+				dst[1] = Clamp(luma + ((kYCbCrTable.cbToG[cb] + kYCbCrTable.crToG[cr]) >> 16));
+				dst[2] = Clamp(luma + kYCbCrTable.cbToB[cb]);
+				dst[3] = 255;
+			}
+		}
+	}
+
+	return true;
+}
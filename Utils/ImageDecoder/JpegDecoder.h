@@ -0,0 +1,12 @@
+#pragma once
+#include "Utils/ImageDecoder/ImageDecoder.h"
+
+/// <summary>
+/// ハフマン符号のベースラインJPEG(8ビット、グレーかYCbCr)をRGBA8にデコードする
+/// 逆DCT、色差のアップサンプリング(水平、垂直の2倍まで)、色変換の計算はlibjpegの既定の方法と同じにしている
+/// プログレッシブ、算術符号、CMYKなどは失敗する
+/// </summary>
+/// <param name="data">ファイルの中身</param>
+/// <param name="image">デコードした画像</param>
+/// <returns>成功したか</returns>
+bool DecodeJpeg(std::span<const uint8_t> data, ImageDecoder::Image& image);
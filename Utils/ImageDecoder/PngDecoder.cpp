@@ -0,0 +1,578 @@
+#include "PngDecoder.h"
+#include "Utils/ImageDecoder/Inflate.h"
+// SIMDの命令セットの選択(MATH_USE_SSEなど)をベクトル演算と揃える
+#include "Utils/Math/Vector4.h"
+#include <array>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+	constexpr std::array<uint8_t, 8> kSignature = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+	/// <summary>
+	/// 受け付ける幅と高さの上限(D3D12のテクスチャの上限。壊れたヘッダーで巨大な確保をしないため)
+	/// </summary>
+	constexpr uint32_t kMaxSize = 16384;
+
+	enum class ColorType : uint8_t {
+		Gray = 0,
+		Rgb = 2,
+		Palette = 3,
+		GrayAlpha = 4,
+		Rgba = 6
+	};
+
+	enum class Filter : uint8_t {
+		None,
+		Sub,
+		Up,
+		Average,
+		Paeth
+	};
+
+	struct Header {
+		uint32_t width = 0;
+		uint32_t height = 0;
+		uint32_t bitDepth = 0;
+		ColorType colorType = ColorType::Gray;
+		bool isInterlaced = false;
+
+		uint32_t channelNum = 0;
+		/// <summary>
+		/// フィルターで左のピクセルとして扱うバイト数(1バイト未満なら1)
+		/// </summary>
+		size_t filterStride = 0;
+	};
+
+	/// <summary>
+	/// デコードした行をRGBA8にする時に使う情報
+	/// </summary>
+	struct ColorInfo {
+		/// <summary>
+		/// パレット(tRNSのアルファ込み。範囲外の番号は不透明な黒)
+		/// </summary>
+		std::array<std::array<uint8_t, 4>, 256> palette;
+		/// <summary>
+		/// この色のピクセルを透明にする(グレーは0番だけ使う)
+		/// </summary>
+		std::array<uint16_t, 3> transparentColor;
+		bool hasTransparentColor;
+	};
+
+	struct Pass {
+		uint32_t xStart;
+		uint32_t yStart;
+		uint32_t xStep;
+		uint32_t yStep;
+	};
+	constexpr std::array<Pass, 7> kAdam7Passes = { {
+		{ 0, 0, 8, 8 },
+		{ 4, 0, 8, 8 },
+		{ 0, 4, 4, 8 },
+		{ 2, 0, 4, 4 },
+		{ 0, 2, 2, 4 },
+		{ 1, 0, 2, 2 },
+		{ 0, 1, 1, 2 }
+	} };
+	constexpr Pass kWholePass = { 0, 0, 1, 1 };
+
+	uint32_t ReadU32(const uint8_t* data) {
+		return (static_cast<uint32_t>(data[0]) << 24) | (static_cast<uint32_t>(data[1]) << 16)
+			| (static_cast<uint32_t>(data[2]) << 8) | data[3];
+	}
+
+	uint16_t ReadU16(const uint8_t* data) {
+		return static_cast<uint16_t>((data[0] << 8) | data[1]);
+	}
+
+	bool ParseHeader(std::span<const uint8_t> chunk, Header& header) {
+		if (chunk.size() != 13) {
+			return false;
+		}
+		header.width = ReadU32(chunk.data());
+		header.height = ReadU32(chunk.data() + 4);
+		header.bitDepth = chunk[8];
+		header.colorType = static_cast<ColorType>(chunk[9]);
+		header.isInterlaced = chunk[12] == 1;
+		if (header.width == 0 || header.height == 0 || kMaxSize < header.width || kMaxSize < header.height
+			|| chunk[10] != 0 || chunk[11] != 0 || 1 < chunk[12]
+		) {
+			return false;
+		}
+
+		bool isValidDepth = false;
+		switch (header.colorType) {
+		case ColorType::Gray:
+			header.channelNum = 1;
+			isValidDepth = header.bitDepth == 1 || header.bitDepth == 2 || header.bitDepth == 4 || header.bitDepth == 8 || header.bitDepth == 16;
+			break;
+		case ColorType::Palette:
+			header.channelNum = 1;
+			isValidDepth = header.bitDepth == 1 || header.bitDepth == 2 || header.bitDepth == 4 || header.bitDepth == 8;
+			break;
+		case ColorType::Rgb:
+			header.channelNum = 3;
+			isValidDepth = header.bitDepth == 8 || header.bitDepth == 16;
+			break;
+		case ColorType::GrayAlpha:
+			header.channelNum = 2;
+			isValidDepth = header.bitDepth == 8 || header.bitDepth == 16;
+			break;
+		case ColorType::Rgba:
+			header.channelNum = 4;
+			isValidDepth = header.bitDepth == 8 || header.bitDepth == 16;
+			break;
+		default:
+			break;
+		}
+		header.filterStride = std::max<size_t>(header.channelNum * header.bitDepth / 8, 1);
+		return isValidDepth;
+	}
+
+	/// <summary>
+	/// フィルターのバイトを除いた1行のバイト数
+	/// </summary>
+	size_t CalcRowSize(const Header& header, uint32_t width) {
+		return (static_cast<size_t>(width) * header.channelNum * header.bitDepth + 7) / 8;
+	}
+
+	uint32_t CalcPassSize(uint32_t size, uint32_t start, uint32_t step) {
+		return size <= start ? 0 : (size - start + step - 1) / step;
+	}
+
+	uint8_t PaethPredictor(uint8_t a, uint8_t b, uint8_t c) {
+		const int32_t pa = std::abs(static_cast<int32_t>(b) - c);
+		const int32_t pb = std::abs(static_cast<int32_t>(a) - c);
+		const int32_t pc = std::abs(static_cast<int32_t>(a) + b - c - c);
+		if (pa <= pb && pa <= pc) {
+			return a;
+		}
+		return pb <= pc ? b : c;
+	}
+
+#if defined(MATH_USE_SSE)
+	/// <summary>
+	/// 1ピクセル(3か4バイト)を読み書きする
+	/// </summary>
+	template<size_t kPixelSize>
+	__m128i LoadPixel(const uint8_t* src) {
+		int32_t value = 0;
+		std::memcpy(&value, src, kPixelSize);
+		return _mm_cvtsi32_si128(value);
+	}
+	template<size_t kPixelSize>
+	void StorePixel(uint8_t* dst, __m128i value) {
+		const int32_t pixel = _mm_cvtsi128_si32(value);
+		std::memcpy(dst, &pixel, kPixelSize);
+	}
+
+	/// <summary>
+	/// Subは16バイトの中で左のピクセルを足していく(4バイトなら4ピクセル、3バイトなら5ピクセルずつ)
+	/// </summary>
+	template<size_t kPixelSize>
+	void UnfilterSubSimd(const uint8_t* src, uint8_t* dst, size_t size) {
+		constexpr size_t kPixelNum = 16 / kPixelSize;
+		constexpr size_t kStep = kPixelNum * kPixelSize;
+		__m128i left = _mm_setzero_si128();
+		size_t i = 0;
+		for (; i + 16 <= size; i += kStep) {
+			__m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+			value = _mm_add_epi8(value, _mm_slli_si128(value, kPixelSize));
+			value = _mm_add_epi8(value, _mm_slli_si128(value, kPixelSize * 2));
+			if constexpr (4 < kPixelNum) {
+				value = _mm_add_epi8(value, _mm_slli_si128(value, kPixelSize * 4));
+			}
+			value = _mm_add_epi8(value, left);
+			// 3バイトの時は16バイト目が次のピクセルにかかるので、同じ場所で戻している時のために元の値を書き戻す
+			const uint8_t next = src[i + 15];
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), value);
+			if constexpr (kStep != 16) {
+				dst[i + 15] = next;
+			}
+			// 最後のピクセルを全てのピクセルの位置に並べる
+			if constexpr (kPixelSize == 4) {
+				left = _mm_shuffle_epi32(value, _MM_SHUFFLE(3, 3, 3, 3));
+			}
+			else {
+				left = _mm_shuffle_epi8(value, _mm_setr_epi8(12, 13, 14, 12, 13, 14, 12, 13, 14, 12, 13, 14, 12, 13, 14, 12));
+			}
+		}
+		// 残りは1ピクセルずつ
+		for (; i < size; i += kPixelSize) {
+			left = _mm_add_epi8(left, LoadPixel<kPixelSize>(src + i));
+			StorePixel<kPixelSize>(dst + i, left);
+		}
+	}
+
+	template<size_t kPixelSize>
+	void UnfilterAverageSimd(const uint8_t* src, uint8_t* dst, const uint8_t* prior, size_t size) {
+		const __m128i one = _mm_set1_epi8(1);
+		__m128i left = _mm_setzero_si128();
+		for (size_t i = 0; i < size; i += kPixelSize) {
+			const __m128i above = LoadPixel<kPixelSize>(prior + i);
+			// _mm_avg_epu8は切り上げなので、奇数の時に1引いて切り捨てにする
+			__m128i average = _mm_avg_epu8(left, above);
+			average = _mm_sub_epi8(average, _mm_and_si128(_mm_xor_si128(left, above), one));
+			left = _mm_add_epi8(LoadPixel<kPixelSize>(src + i), average);
+			StorePixel<kPixelSize>(dst + i, left);
+		}
+	}
+
+	template<size_t kPixelSize>
+	void UnfilterPaethSimd(const uint8_t* src, uint8_t* dst, const uint8_t* prior, size_t size) {
+		const __m128i zero = _mm_setzero_si128();
+		// 16ビットに広げて計算する
+		__m128i left = zero;
+		__m128i upperLeft = zero;
+		for (size_t i = 0; i < size; i += kPixelSize) {
+			const __m128i above = _mm_unpacklo_epi8(LoadPixel<kPixelSize>(prior + i), zero);
+			const __m128i pa = _mm_sub_epi16(above, upperLeft);
+			const __m128i pb = _mm_sub_epi16(left, upperLeft);
+			const __m128i pc = _mm_abs_epi16(_mm_add_epi16(pa, pb));
+			const __m128i absPa = _mm_abs_epi16(pa);
+			const __m128i absPb = _mm_abs_epi16(pb);
+			const __m128i smallest = _mm_min_epi16(pc, _mm_min_epi16(absPa, absPb));
+
+			// 同じ距離ならa、b、cの順に優先する
+			__m128i nearest = _mm_blendv_epi8(upperLeft, above, _mm_cmpeq_epi16(smallest, absPb));
+			nearest = _mm_blendv_epi8(nearest, left, _mm_cmpeq_epi16(smallest, absPa));
+
+			const __m128i value = _mm_add_epi8(LoadPixel<kPixelSize>(src + i), _mm_packus_epi16(nearest, zero));
+			StorePixel<kPixelSize>(dst + i, value);
+			left = _mm_unpacklo_epi8(value, zero);
+			upperLeft = above;
+		}
+	}
+#endif
+
+	/// <summary>
+	/// 1行のフィルターを戻す(srcとdstは同じでもいい)
+	/// </summary>
+	/// <param name="prior">1つ上の行の戻した後の値(最初の行は0の行)</param>
+	/// <param name="stride">左のピクセルまでのバイト数</param>
+	bool Unfilter(uint8_t filter, const uint8_t* src, uint8_t* dst, const uint8_t* prior, size_t size, size_t stride) {
+		switch (static_cast<Filter>(filter)) {
+		case Filter::None:
+			if (src != dst) {
+				std::memcpy(dst, src, size);
+			}
+			return true;
+
+		case Filter::Sub:
+#if defined(MATH_USE_SSE)
+			if (stride == 4) {
+				UnfilterSubSimd<4>(src, dst, size);
+				return true;
+			}
+			if (stride == 3) {
+				UnfilterSubSimd<3>(src, dst, size);
+				return true;
+			}
+#endif
+			std::memmove(dst, src, std::min(stride, size));
+			for (size_t i = stride; i < size; i++) {
+				dst[i] = static_cast<uint8_t>(src[i] + dst[i - stride]);
+			}
+			return true;
+
+		case Filter::Up: {
+			size_t i = 0;
+#if defined(MATH_USE_SSE)
+			for (; i + 16 <= size; i += 16) {
+				const __m128i value = _mm_add_epi8(
+					_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)),
+					_mm_loadu_si128(reinterpret_cast<const __m128i*>(prior + i))
+				);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), value);
+			}
+#endif
+			for (; i < size; i++) {
+				dst[i] = static_cast<uint8_t>(src[i] + prior[i]);
+			}
+			return true;
+		}
+
+		case Filter::Average:
+#if defined(MATH_USE_SSE)
+			if (stride == 4) {
+				UnfilterAverageSimd<4>(src, dst, prior, size);
+				return true;
+			}
+			if (stride == 3) {
+				UnfilterAverageSimd<3>(src, dst, prior, size);
+				return true;
+			}
+#endif
+			for (size_t i = 0; i < size; i++) {
+				const uint32_t left = stride <= i ? dst[i - stride] : 0u;
+				dst[i] = static_cast<uint8_t>(src[i] + ((left + prior[i]) >> 1));
+			}
+			return true;
+
+		case Filter::Paeth:
+#if defined(MATH_USE_SSE)
+			if (stride == 4) {
+				UnfilterPaethSimd<4>(src, dst, prior, size);
+				return true;
+			}
+			if (stride == 3) {
+				UnfilterPaethSimd<3>(src, dst, prior, size);
+				return true;
+			}
+#endif
+			for (size_t i = 0; i < size; i++) {
+				const uint8_t left = stride <= i ? dst[i - stride] : uint8_t{ 0 };
+				const uint8_t upperLeft = stride <= i ? prior[i - stride] : uint8_t{ 0 };
+				dst[i] = static_cast<uint8_t>(src[i] + PaethPredictor(left, prior[i], upperLeft));
+			}
+			return true;
+
+		default:
+			return false;
+		}
+	}
+
+	/// <summary>
+	/// 16ビットを8ビットに丸める(v * 255 / 65535の四捨五入)
+	/// </summary>
+	uint8_t Scale16To8(uint32_t value) {
+		return static_cast<uint8_t>((value * 255u + 32895u) >> 16);
+	}
+
+	/// <summary>
+	/// フィルターを戻した1行をRGBA8にする
+	/// </summary>
+	void ExpandRow(const uint8_t* src, uint32_t width, const Header& header, const ColorInfo& info, uint8_t* dst) {
+		const bool isWide = header.bitDepth == 16;
+		switch (header.colorType) {
+		case ColorType::Rgba:
+			if (!isWide) {
+				std::memcpy(dst, src, static_cast<size_t>(width) * 4);
+				return;
+			}
+			for (uint32_t x = 0; x < width; x++, src += 8, dst += 4) {
+				for (size_t c = 0; c < 4; c++) {
+					dst[c] = Scale16To8(ReadU16(src + c * 2));
+				}
+			}
+			return;
+
+		case ColorType::Rgb:
+			for (uint32_t x = 0; x < width; x++, dst += 4) {
+				std::array<uint16_t, 3> color;
+				if (isWide) {
+					color = { ReadU16(src), ReadU16(src + 2), ReadU16(src + 4) };
+					dst[0] = Scale16To8(color[0]);
+					dst[1] = Scale16To8(color[1]);
+					dst[2] = Scale16To8(color[2]);
+					src += 6;
+				}
+				else {
+					color = { src[0], src[1], src[2] };
+					dst[0] = src[0];
+					dst[1] = src[1];
+					dst[2] = src[2];
+					src += 3;
+				}
+				dst[3] = info.hasTransparentColor && color == info.transparentColor ? 0 : 255;
+			}
+			return;
+
+		case ColorType::GrayAlpha:
+			for (uint32_t x = 0; x < width; x++, dst += 4) {
+				const uint8_t gray = isWide ? Scale16To8(ReadU16(src)) : src[0];
+				dst[0] = gray;
+				dst[1] = gray;
+				dst[2] = gray;
+				dst[3] = isWide ? Scale16To8(ReadU16(src + 2)) : src[1];
+				src += isWide ? 4 : 2;
+			}
+			return;
+
+		case ColorType::Gray:
+		case ColorType::Palette:
+		default:
+			break;
+		}
+
+		// 1ピクセル1チャンネル
+		const bool isPalette = header.colorType == ColorType::Palette;
+		const uint32_t sampleMax = (1u << std::min(header.bitDepth, 8u)) - 1u;
+		// 8ビット未満のグレーは0から255に広げる
+		const uint32_t grayScale = 255u / sampleMax;
+		for (uint32_t x = 0; x < width; x++, dst += 4) {
+			uint32_t sample = 0;
+			if (isWide) {
+				sample = ReadU16(src + static_cast<size_t>(x) * 2);
+			}
+			else if (header.bitDepth == 8) {
+				sample = src[x];
+			}
+			else {
+				// 上位ビットから詰められている
+				const size_t bitOffset = static_cast<size_t>(x) * header.bitDepth;
+				sample = (src[bitOffset / 8] >> (8 - header.bitDepth - bitOffset % 8)) & sampleMax;
+			}
+
+			if (isPalette) {
+				std::memcpy(dst, info.palette[sample].data(), 4);
+				continue;
+			}
+			const uint8_t gray = isWide ? Scale16To8(sample) : static_cast<uint8_t>(sample * grayScale);
+			dst[0] = gray;
+			dst[1] = gray;
+			dst[2] = gray;
+			dst[3] = info.hasTransparentColor && sample == info.transparentColor[0] ? 0 : 255;
+		}
+	}
+}
+
+bool DecodePng(std::span<const uint8_t> data, ImageDecoder::Image& image) {
+	if (data.size() < kSignature.size() || !std::equal(kSignature.begin(), kSignature.end(), data.begin())) {
+		return false;
+	}
+
+	// チャンクを読む(IDATは繋げる)
+	Header header;
+	ColorInfo info{};
+	for (auto& color : info.palette) {
+		color = { 0, 0, 0, 255 };
+	}
+	bool hasHeader = false;
+	bool hasPalette = false;
+	bool isEnd = false;
+	std::vector<uint8_t> compressed;
+	size_t offset = kSignature.size();
+	while (!isEnd) {
+		if (data.size() - offset < 12) {
+			return false;
+		}
+		const uint32_t length = ReadU32(data.data() + offset);
+		const uint8_t* type = data.data() + offset + 4;
+		if (data.size() - offset - 12 < length) {
+			return false;
+		}
+		const std::span<const uint8_t> chunk = data.subspan(offset + 8, length);
+		offset += 12 + static_cast<size_t>(length);
+
+		const auto isType = [type](const char* name) {
+			return std::memcmp(type, name, 4) == 0;
+		};
+		if (!hasHeader) {
+			// 最初はIHDRでないといけない
+			if (!isType("IHDR") || !ParseHeader(chunk, header)) {
+				return false;
+			}
+			hasHeader = true;
+		}
+		else if (isType("PLTE")) {
+			if (chunk.size() % 3 != 0 || info.palette.size() * 3 < chunk.size()) {
+				return false;
+			}
+			for (size_t i = 0; i < chunk.size() / 3; i++) {
+				info.palette[i] = { chunk[i * 3], chunk[i * 3 + 1], chunk[i * 3 + 2], 255 };
+			}
+			hasPalette = true;
+		}
+		else if (isType("tRNS")) {
+			if (header.colorType == ColorType::Palette) {
+				for (size_t i = 0; i < std::min(chunk.size(), info.palette.size()); i++) {
+					info.palette[i][3] = chunk[i];
+				}
+			}
+			else if (header.colorType == ColorType::Gray && 2 <= chunk.size()) {
+				info.transparentColor[0] = ReadU16(chunk.data());
+				info.hasTransparentColor = true;
+			}
+			else if (header.colorType == ColorType::Rgb && 6 <= chunk.size()) {
+				info.transparentColor = { ReadU16(chunk.data()), ReadU16(chunk.data() + 2), ReadU16(chunk.data() + 4) };
+				info.hasTransparentColor = true;
+			}
+		}
+		else if (isType("IDAT")) {
+			compressed.insert(compressed.end(), chunk.begin(), chunk.end());
+		}
+		else if (isType("IEND")) {
+			isEnd = true;
+		}
+		else if ((type[0] & 0x20) == 0) {
+			// 知らない必須チャンク
+			return false;
+		}
+	}
+	if (header.colorType == ColorType::Palette && !hasPalette) {
+		return false;
+	}
+	// 8ビット以下では透明にする色はサンプルのビット数に切り詰めて比べる
+	if (info.hasTransparentColor && header.bitDepth != 16) {
+		const uint16_t mask = static_cast<uint16_t>((1u << header.bitDepth) - 1u);
+		for (auto& color : info.transparentColor) {
+			color &= mask;
+		}
+	}
+
+	// 展開後の大きさはヘッダーから決まる
+	const std::span<const Pass> passes = header.isInterlaced ? std::span<const Pass>(kAdam7Passes) : std::span<const Pass>(&kWholePass, 1);
+	size_t rawSize = 0;
+	for (const Pass& pass : passes) {
+		const uint32_t passWidth = CalcPassSize(header.width, pass.xStart, pass.xStep);
+		const uint32_t passHeight = CalcPassSize(header.height, pass.yStart, pass.yStep);
+		if (passWidth != 0 && passHeight != 0) {
+			rawSize += (CalcRowSize(header, passWidth) + 1) * passHeight;
+		}
+	}
+	std::vector<uint8_t> raw;
+	if (!InflateZlib(compressed, rawSize, raw)) {
+		return false;
+	}
+	compressed = std::vector<uint8_t>();
+
+	image.width = header.width;
+	image.height = header.height;
+	image.pixels.resize(static_cast<size_t>(header.width) * header.height * 4);
+	const size_t dstRowPitch = static_cast<size_t>(header.width) * 4;
+	// RGBA8はフィルターを戻すだけなので、直接書き込む
+	const bool isDirect = !header.isInterlaced && header.colorType == ColorType::Rgba && header.bitDepth == 8;
+
+	const std::vector<uint8_t> zeroRow(CalcRowSize(header, header.width), 0);
+	std::vector<uint8_t> expanded(dstRowPitch);
+	size_t rawOffset = 0;
+	for (const Pass& pass : passes) {
+		const uint32_t passWidth = CalcPassSize(header.width, pass.xStart, pass.xStep);
+		const uint32_t passHeight = CalcPassSize(header.height, pass.yStart, pass.yStep);
+		if (passWidth == 0 || passHeight == 0) {
+			continue;
+		}
+		const size_t rowSize = CalcRowSize(header, passWidth);
+
+		const uint8_t* prior = zeroRow.data();
+		for (uint32_t y = 0; y < passHeight; y++) {
+			const uint8_t filter = raw[rawOffset];
+			uint8_t* row = raw.data() + rawOffset + 1;
+			rawOffset += rowSize + 1;
+
+			uint8_t* dstRow = image.pixels.data() + (pass.yStart + static_cast<size_t>(y) * pass.yStep) * dstRowPitch;
+			if (isDirect) {
+				if (!Unfilter(filter, row, dstRow, prior, rowSize, header.filterStride)) {
+					return false;
+				}
+				prior = dstRow;
+				continue;
+			}
+
+			if (!Unfilter(filter, row, row, prior, rowSize, header.filterStride)) {
+				return false;
+			}
+			prior = row;
+			if (!header.isInterlaced) {
+				ExpandRow(row, passWidth, header, info, dstRow);
+				continue;
+			}
+			ExpandRow(row, passWidth, header, info, expanded.data());
+			for (uint32_t x = 0; x < passWidth; x++) {
+				std::memcpy(dstRow + (pass.xStart + static_cast<size_t>(x) * pass.xStep) * 4, expanded.data() + static_cast<size_t>(x) * 4, 4);
+			}
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,12 @@
+#pragma once
+#include "Utils/ImageDecoder/ImageDecoder.h"
+
+/// <summary>
+/// PNGをRGBA8にデコードする
+/// 全ての色の種類とビット深度、インターレースに対応する(16ビットは丸めて8ビットにする)
+/// チャンクのCRCは確認しない(画素データの破損はzlibのAdler-32で分かる)
+/// </summary>
+/// <param name="data">ファイルの中身</param>
+/// <param name="image">デコードした画像</param>
+/// <returns>成功したか</returns>
+bool DecodePng(std::span<const uint8_t> data, ImageDecoder::Image& image);
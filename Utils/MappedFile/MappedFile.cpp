@@ -0,0 +1,117 @@
+#include "MappedFile.h"
+#include <utility>
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+// テストをWindows以外でもビルドできるようにするため(fileとmappingは使わない)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define INVALID_HANDLE_VALUE nullptr
+#endif
+
+MappedFile::MappedFile() :
+	file(INVALID_HANDLE_VALUE),
+	mapping(nullptr),
+	data(nullptr),
+	size(0)
+{}
+
+MappedFile::MappedFile(MappedFile&& right) noexcept :
+	MappedFile()
+{
+	*this = std::move(right);
+}
+
+MappedFile::~MappedFile() {
+	Close();
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& right) noexcept {
+	if (this != &right) {
+		Close();
+		file = std::exchange(right.file, INVALID_HANDLE_VALUE);
+		mapping = std::exchange(right.mapping, nullptr);
+		data = std::exchange(right.data, nullptr);
+		size = std::exchange(right.size, 0);
+	}
+
+	return *this;
+}
+
+bool MappedFile::Open(const std::string& fileName) {
+	Close();
+
+#if defined(_WIN32)
+	file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	LARGE_INTEGER fileSize{};
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+		Close();
+		return false;
+	}
+
+	mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping) {
+		Close();
+		return false;
+	}
+
+	data = static_cast<const std::byte*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (!data) {
+		Close();
+		return false;
+	}
+	size = static_cast<size_t>(fileSize.QuadPart);
+#else
+	const int fileDescriptor = open(fileName.c_str(), O_RDONLY);
+	if (fileDescriptor < 0) {
+		return false;
+	}
+
+	struct stat fileStat{};
+	if (fstat(fileDescriptor, &fileStat) != 0 || fileStat.st_size == 0) {
+		close(fileDescriptor);
+		return false;
+	}
+
+	// マップした後は閉じても使える
+	void* view = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+	close(fileDescriptor);
+	if (view == MAP_FAILED) {
+		return false;
+	}
+	data = static_cast<const std::byte*>(view);
+	size = static_cast<size_t>(fileStat.st_size);
+#endif
+
+	return true;
+}
+
+void MappedFile::Close() {
+#if defined(_WIN32)
+	if (data) {
+		UnmapViewOfFile(data);
+		data = nullptr;
+	}
+	size = 0;
+	if (mapping) {
+		CloseHandle(mapping);
+		mapping = nullptr;
+	}
+	if (file != INVALID_HANDLE_VALUE) {
+		CloseHandle(file);
+		file = INVALID_HANDLE_VALUE;
+	}
+#else
+	if (data) {
+		munmap(const_cast<std::byte*>(data), size);
+		data = nullptr;
+	}
+	size = 0;
+#endif
+}
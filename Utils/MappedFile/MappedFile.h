@@ -0,0 +1,44 @@
+#pragma once
+#include <string>
+#include <span>
+#include <cstddef>
+
+/// <summary>
+/// ファイルをメモリにマップして読み取り専用で使う
+/// </summary>
+class MappedFile {
+public:
+	MappedFile();
+	MappedFile(const MappedFile&) = delete;
+	MappedFile(MappedFile&& right) noexcept;
+	~MappedFile();
+
+	MappedFile& operator=(const MappedFile&) = delete;
+	MappedFile& operator=(MappedFile&& right) noexcept;
+
+public:
+	/// <summary>
+	/// ファイルをマップする(既に開いていたら閉じてから開く)
+	/// </summary>
+	/// <param name="fileName">ファイルパス</param>
+	/// <returns>成功したか</returns>
+	bool Open(const std::string& fileName);
+
+	void Close();
+
+	bool IsOpen() const {
+		return data != nullptr;
+	}
+
+	std::span<const std::byte> GetData() const {
+		return { data, size };
+	}
+
+private:
+	// HANDLE(Windows.hを公開しないためvoid*で持つ)
+	void* file;
+	void* mapping;
+
+	const std::byte* data;
+	size_t size;
+};
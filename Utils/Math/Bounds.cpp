@@ -0,0 +1,106 @@
+#include "Bounds.h"
+#include "Mat4x4.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+AABB::AABB() noexcept :
+	min(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max()),
+	max(std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest())
+{}
+
+AABB::AABB(const Vector3& min_, const Vector3& max_) noexcept :
+	min(min_),
+	max(max_)
+{}
+
+void AABB::Extend(const Vector3& point) noexcept {
+	min.x = std::min(min.x, point.x);
+	min.y = std::min(min.y, point.y);
+	min.z = std::min(min.z, point.z);
+	max.x = std::max(max.x, point.x);
+	max.y = std::max(max.y, point.y);
+	max.z = std::max(max.z, point.z);
+}
+
+bool AABB::IsEmpty() const noexcept {
+	return max.x < min.x || max.y < min.y || max.z < min.z;
+}
+
+Vector3 AABB::GetCenter() const noexcept {
+	return (min + max) * 0.5f;
+}
+
+Vector3 AABB::GetExtent() const noexcept {
+	return (max - min) * 0.5f;
+}
+
+AABB MakeAABB(std::span<const Vector3> points) noexcept {
+	AABB result;
+	for (auto& i : points) {
+		result.Extend(i);
+	}
+
+	return result;
+}
+
+Sphere MakeSphere(const AABB& aabb, std::span<const Vector3> points) noexcept {
+	Sphere result;
+	if (aabb.IsEmpty()) {
+		return result;
+	}
+
+	result.center = aabb.GetCenter();
+
+	float radiusSq = 0.0f;
+	for (auto& i : points) {
+		Vector3 dist = i - result.center;
+		radiusSq = std::max(radiusSq, dist.Dot(dist));
+	}
+	result.radius = std::sqrt(radiusSq);
+
+	return result;
+}
+
+AABB HoriTransformAABB(const AABB& aabb, const Mat4x4& mat) noexcept {
+	if (aabb.IsEmpty()) {
+		return aabb;
+	}
+
+	// 中心を変換して、広がりは行列の絶対値で変換する
+	Vector3 center = aabb.GetCenter();
+	Vector3 extent = aabb.GetExtent();
+
+	Vector3 worldCenter = {
+		center.x * mat[0][0] + center.y * mat[1][0] + center.z * mat[2][0] + mat[3][0],
+		center.x * mat[0][1] + center.y * mat[1][1] + center.z * mat[2][1] + mat[3][1],
+		center.x * mat[0][2] + center.y * mat[1][2] + center.z * mat[2][2] + mat[3][2]
+	};
+	Vector3 worldExtent = {
+		extent.x * std::abs(mat[0][0]) + extent.y * std::abs(mat[1][0]) + extent.z * std::abs(mat[2][0]),
+		extent.x * std::abs(mat[0][1]) + extent.y * std::abs(mat[1][1]) + extent.z * std::abs(mat[2][1]),
+		extent.x * std::abs(mat[0][2]) + extent.y * std::abs(mat[1][2]) + extent.z * std::abs(mat[2][2])
+	};
+
+	return AABB(worldCenter - worldExtent, worldCenter + worldExtent);
+}
+
+Sphere HoriTransformSphere(const Sphere& sphere, const Mat4x4& mat) noexcept {
+	Sphere result;
+	const Vector3& center = sphere.center;
+
+	result.center = {
+		center.x * mat[0][0] + center.y * mat[1][0] + center.z * mat[2][0] + mat[3][0],
+		center.x * mat[0][1] + center.y * mat[1][1] + center.z * mat[2][1] + mat[3][1],
+		center.x * mat[0][2] + center.y * mat[1][2] + center.z * mat[2][2] + mat[3][2]
+	};
+
+	float scaleSq = 0.0f;
+	for (size_t i = 0; i < 3; i++) {
+		Vector3 axis = { mat[i][0], mat[i][1], mat[i][2] };
+		scaleSq = std::max(scaleSq, axis.Dot(axis));
+	}
+	result.radius = sphere.radius * std::sqrt(scaleSq);
+
+	return result;
+}
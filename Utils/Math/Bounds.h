@@ -0,0 +1,63 @@
+#pragma once
+#include "Vector3.h"
+#include <span>
+#include <type_traits>
+
+class Mat4x4;
+
+/// <summary>
+/// 軸並行境界ボックス
+/// </summary>
+struct AABB {
+	/// <summary>
+	/// 何も含まない状態(min > max)で初期化
+	/// </summary>
+	AABB() noexcept;
+	AABB(const Vector3& min_, const Vector3& max_) noexcept;
+
+	/// <summary>
+	/// 点を含むように広げる
+	/// </summary>
+	void Extend(const Vector3& point) noexcept;
+
+	bool IsEmpty() const noexcept;
+	Vector3 GetCenter() const noexcept;
+	/// <summary>
+	/// 中心から各面までの距離
+	/// </summary>
+	Vector3 GetExtent() const noexcept;
+
+	Vector3 min;
+	Vector3 max;
+};
+
+/// <summary>
+/// 境界球
+/// </summary>
+struct Sphere {
+	Vector3 center;
+	float radius = 0.0f;
+};
+
+static_assert(std::is_trivially_copyable_v<Sphere>, "Sphere must be trivially copyable");
+static_assert(sizeof(Sphere) == sizeof(float) * 4, "Sphere must be 4 floats (loaded as one __m128)");
+
+/// <summary>
+/// 点群を全て含むAABB
+/// </summary>
+AABB MakeAABB(std::span<const Vector3> points) noexcept;
+
+/// <summary>
+/// AABBの中心を中心として、点群を全て含む球
+/// </summary>
+Sphere MakeSphere(const AABB& aabb, std::span<const Vector3> points) noexcept;
+
+/// <summary>
+/// 横ベクトル用のアフィン行列で変換したAABB(回転した箱を全て含む大きさになる)
+/// </summary>
+AABB HoriTransformAABB(const AABB& aabb, const Mat4x4& mat) noexcept;
+
+/// <summary>
+/// 横ベクトル用のアフィン行列で変換した球(半径は一番大きい軸の拡縮で広げる)
+/// </summary>
+Sphere HoriTransformSphere(const Sphere& sphere, const Mat4x4& mat) noexcept;
@@ -0,0 +1,143 @@
+#include "Frustum.h"
+#include "Engine/ErrorCheck/ErrorCheck.h"
+#include <cmath>
+#include <cassert>
+#include <immintrin.h>
+
+Frustum::Frustum() noexcept :
+	planes()
+{}
+
+Frustum::Frustum(const Mat4x4& viewProjection) noexcept :
+	planes()
+{
+	Update(viewProjection);
+}
+
+void Frustum::Update(const Mat4x4& viewProjection) noexcept {
+	const Vector4& row0 = viewProjection[0];
+	const Vector4& row1 = viewProjection[1];
+	const Vector4& row2 = viewProjection[2];
+	const Vector4& row3 = viewProjection[3];
+
+	// クリップ座標で -w <= x <= w, -w <= y <= w, 0 <= z <= w
+	planes[static_cast<size_t>(Plane::Left)] = row3 + row0;
+	planes[static_cast<size_t>(Plane::Right)] = row3 - row0;
+	planes[static_cast<size_t>(Plane::Bottom)] = row3 + row1;
+	planes[static_cast<size_t>(Plane::Top)] = row3 - row1;
+	planes[static_cast<size_t>(Plane::Near)] = row2;
+	planes[static_cast<size_t>(Plane::Far)] = row3 - row2;
+
+	// 距離として使えるように法線を正規化する
+	for (auto& plane : planes) {
+		float length = std::sqrt(plane.vec.x * plane.vec.x + plane.vec.y * plane.vec.y + plane.vec.z * plane.vec.z);
+		if (length != 0.0f) {
+			plane *= 1.0f / length;
+		}
+	}
+}
+
+bool Frustum::IsVisible(const Sphere& sphere) const noexcept {
+	for (auto& plane : planes) {
+		float dist = plane.vec.x * sphere.center.x + plane.vec.y * sphere.center.y + plane.vec.z * sphere.center.z + plane.vec.w;
+		if (dist < -sphere.radius) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool Frustum::IsVisible(const AABB& aabb) const noexcept {
+	if (aabb.IsEmpty()) {
+		return false;
+	}
+
+	for (auto& plane : planes) {
+		Vector3 positive = {
+			0.0f <= plane.vec.x ? aabb.max.x : aabb.min.x,
+			0.0f <= plane.vec.y ? aabb.max.y : aabb.min.y,
+			0.0f <= plane.vec.z ? aabb.max.z : aabb.min.z
+		};
+		float dist = plane.vec.x * positive.x + plane.vec.y * positive.y + plane.vec.z * positive.z + plane.vec.w;
+		if (dist < 0.0f) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void Frustum::CullSpheres(std::span<const Sphere> spheres, std::span<bool> isVisible) const noexcept {
+	assert(spheres.size() == isVisible.size());
+	if (spheres.size() != isVisible.size()) {
+		ErrorCheck::GetInstance()->ErrorTextBox("CullSpheres() : spheres and isVisible are different sizes", "Frustum");
+		return;
+	}
+
+	size_t index = 0;
+
+#if defined(MATH_USE_AVX)
+	// 8個の球を転置して、x,y,z,半径をそれぞれ8要素のレジスタにまとめる
+	for (; index + 8 <= spheres.size(); index += 8) {
+		const float* src = &spheres[index].center.x;
+		__m256 r0 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(src)), _mm_loadu_ps(src + 16), 1);
+		__m256 r1 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(src + 4)), _mm_loadu_ps(src + 20), 1);
+		__m256 r2 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(src + 8)), _mm_loadu_ps(src + 24), 1);
+		__m256 r3 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(src + 12)), _mm_loadu_ps(src + 28), 1);
+
+		__m256 t0 = _mm256_unpacklo_ps(r0, r1);
+		__m256 t1 = _mm256_unpacklo_ps(r2, r3);
+		__m256 t2 = _mm256_unpackhi_ps(r0, r1);
+		__m256 t3 = _mm256_unpackhi_ps(r2, r3);
+
+		__m256 centerX = _mm256_shuffle_ps(t0, t1, 0x44);
+		__m256 centerY = _mm256_shuffle_ps(t0, t1, 0xee);
+		__m256 centerZ = _mm256_shuffle_ps(t2, t3, 0x44);
+		__m256 negRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_shuffle_ps(t2, t3, 0xee));
+
+		__m256 outside = _mm256_setzero_ps();
+		for (auto& plane : planes) {
+			__m256 dist = _mm256_mul_ps(_mm256_set1_ps(plane.vec.x), centerX);
+			dist = _mm256_add_ps(dist, _mm256_mul_ps(_mm256_set1_ps(plane.vec.y), centerY));
+			dist = _mm256_add_ps(dist, _mm256_mul_ps(_mm256_set1_ps(plane.vec.z), centerZ));
+			dist = _mm256_add_ps(dist, _mm256_set1_ps(plane.vec.w));
+			outside = _mm256_or_ps(outside, _mm256_cmp_ps(dist, negRadius, _CMP_LT_OQ));
+		}
+
+		int mask = _mm256_movemask_ps(outside);
+		for (size_t i = 0; i < 8; i++) {
+			isVisible[index + i] = ((mask >> i) & 1) == 0;
+		}
+	}
+#endif
+
+#if defined(MATH_USE_SSE)
+	for (; index + 4 <= spheres.size(); index += 4) {
+		__m128 centerX = _mm_loadu_ps(&spheres[index].center.x);
+		__m128 centerY = _mm_loadu_ps(&spheres[index + 1].center.x);
+		__m128 centerZ = _mm_loadu_ps(&spheres[index + 2].center.x);
+		__m128 negRadius = _mm_loadu_ps(&spheres[index + 3].center.x);
+		_MM_TRANSPOSE4_PS(centerX, centerY, centerZ, negRadius);
+		negRadius = _mm_sub_ps(_mm_setzero_ps(), negRadius);
+
+		__m128 outside = _mm_setzero_ps();
+		for (auto& plane : planes) {
+			__m128 dist = _mm_mul_ps(_mm_set1_ps(plane.vec.x), centerX);
+			dist = _mm_add_ps(dist, _mm_mul_ps(_mm_set1_ps(plane.vec.y), centerY));
+			dist = _mm_add_ps(dist, _mm_mul_ps(_mm_set1_ps(plane.vec.z), centerZ));
+			dist = _mm_add_ps(dist, _mm_set1_ps(plane.vec.w));
+			outside = _mm_or_ps(outside, _mm_cmplt_ps(dist, negRadius));
+		}
+
+		int mask = _mm_movemask_ps(outside);
+		for (size_t i = 0; i < 4; i++) {
+			isVisible[index + i] = ((mask >> i) & 1) == 0;
+		}
+	}
+#endif
+
+	for (; index < spheres.size(); index++) {
+		isVisible[index] = IsVisible(spheres[index]);
+	}
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include "Vector4.h"
+#include "Mat4x4.h"
+#include "Bounds.h"
+#include <array>
+#include <span>
+
+/// <summary>
+/// 視錐台(6平面)
+/// 平面は(a,b,c,d)でa*x + b*y + c*z + d >= 0を内側とする
+/// </summary>
+class Frustum final {
+public:
+	enum class Plane : uint8_t {
+		Left,
+		Right,
+		Bottom,
+		Top,
+		Near,
+		Far,
+
+		PlaneNum
+	};
+
+public:
+	Frustum() noexcept;
+	/// <summary>
+	/// ビュープロジェクション行列から平面を取り出す
+	/// </summary>
+	/// <param name="viewProjection">縦ベクトル用(Camera::GetViewProjection()と同じ)の行列</param>
+	Frustum(const Mat4x4& viewProjection) noexcept;
+	Frustum(const Frustum&) = default;
+	Frustum(Frustum&&) noexcept = default;
+	~Frustum() = default;
+
+	Frustum& operator=(const Frustum&) = default;
+	Frustum& operator=(Frustum&&) noexcept = default;
+
+public:
+	/// <summary>
+	/// ビュープロジェクション行列から平面を取り出す(Gribb/Hartmannの方法。深度は0～1)
+	/// </summary>
+	/// <param name="viewProjection">縦ベクトル用(Camera::GetViewProjection()と同じ)の行列</param>
+	void Update(const Mat4x4& viewProjection) noexcept;
+
+	/// <summary>
+	/// 球が視錐台と重なっているか
+	/// </summary>
+	bool IsVisible(const Sphere& sphere) const noexcept;
+	/// <summary>
+	/// AABBが視錐台と重なっているか(各平面で一番内側の頂点を調べる)
+	/// </summary>
+	bool IsVisible(const AABB& aabb) const noexcept;
+
+	/// <summary>
+	/// 球をまとめて判定する(AVXなら8個、SSEなら4個ずつ)
+	/// 結果はIsVisible(const Sphere&)と一致する
+	/// </summary>
+	/// <param name="spheres">判定する球</param>
+	/// <param name="isVisible">結果(spheresと同じ数)</param>
+	void CullSpheres(std::span<const Sphere> spheres, std::span<bool> isVisible) const noexcept;
+
+	const Vector4& GetPlane(Plane plane) const noexcept {
+		return planes[static_cast<size_t>(plane)];
+	}
+
+private:
+	std::array<Vector4, static_cast<size_t>(Plane::PlaneNum)> planes;
+};
@@ -1,41 +1,46 @@
 #include "Mat4x4.h"
 #include "Vector3.h"
+#include "SinCos.h"
 #include <cmath>
 #include <algorithm>
-#include <Windows.h>
 #include <immintrin.h>
 
-Mat4x4::Mat4x4()
-	:m()
-{}
-
-Mat4x4::Mat4x4(const Mat4x4& mat) {
-	*this = mat;
-}
-
-Mat4x4::Mat4x4(Mat4x4&& mat) noexcept {
-	*this = std::move(mat);
-}
-
-Mat4x4::Mat4x4(const std::array<Vector4, 4>& num) {
-	m = num;
-}
+Mat4x4 Mat4x4::operator*(const Mat4x4& mat) const {
+	Mat4x4 result;
 
-Mat4x4& Mat4x4::operator=(const Mat4x4& mat) {
-	std::copy(mat.m.begin(), mat.m.end(), m.begin());
+#if defined(MATH_USE_AVX)
+	// 2行ずつ計算する(下位128bitがy行、上位128bitがy+1行)
+	const __m256 b0 = _mm256_broadcast_ps(&mat.m[0].m128);
+	const __m256 b1 = _mm256_broadcast_ps(&mat.m[1].m128);
+	const __m256 b2 = _mm256_broadcast_ps(&mat.m[2].m128);
+	const __m256 b3 = _mm256_broadcast_ps(&mat.m[3].m128);
 
-	return *this;
-}
+	for (int y = 0; y < Mat4x4::HEIGHT; y += 2) {
+		const __m256 a = _mm256_loadu_ps(this->m[y].m.data());
 
-Mat4x4& Mat4x4::operator=(Mat4x4&& mat) noexcept {
-	m = std::move(mat.m);
+		// スカラー版と同じく0から順番に足していく
+		__m256 r = _mm256_setzero_ps();
+		r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(a, a, 0x00), b0));
+		r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(a, a, 0x55), b1));
+		r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(a, a, 0xaa), b2));
+		r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(a, a, 0xff), b3));
 
-	return *this;
-}
+		_mm256_storeu_ps(result.m[y].m.data(), r);
+	}
+#elif defined(MATH_USE_SSE)
+	for (int y = 0; y < Mat4x4::HEIGHT; y++) {
+		const __m128 a = this->m[y].m128;
 
-Mat4x4 Mat4x4::operator*(const Mat4x4& mat) const {
-	Mat4x4 result;
+		// スカラー版と同じく0から順番に足していく
+		__m128 r = _mm_setzero_ps();
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(a, a, 0x00), mat.m[0].m128));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(a, a, 0x55), mat.m[1].m128));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(a, a, 0xaa), mat.m[2].m128));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(a, a, 0xff), mat.m[3].m128));
 
+		result.m[y].m128 = r;
+	}
+#else
 	for (int y = 0; y < Mat4x4::HEIGHT; y++) {
 		for (int x = 0; x < Mat4x4::WIDTH; x++) {
 			for (int i = 0; i < Mat4x4::WIDTH; i++) {
@@ -43,6 +48,7 @@ Mat4x4 Mat4x4::operator*(const Mat4x4& mat) const {
 			}
 		}
 	}
+#endif
 
 	return result;
 }
@@ -56,52 +62,68 @@ Mat4x4& Mat4x4::operator*=(const Mat4x4& mat) {
 Mat4x4 Mat4x4::operator+(const Mat4x4& mat) const {
 	Mat4x4 tmp;
 
+#if defined(MATH_USE_SSE)
+	for (int y = 0; y < Mat4x4::HEIGHT; y++) {
+		tmp.m[y].m128 = _mm_add_ps(this->m[y].m128, mat.m[y].m128);
+	}
+#else
 	for (int y = 0; y < Mat4x4::HEIGHT; y++) {
 		for (int x = 0; x < Mat4x4::WIDTH; x++) {
 			tmp[y][x] = this->m[y][x] + mat.m[y][x];
 		}
 	}
+#endif
 
 	return tmp;
 }
 Mat4x4& Mat4x4::operator+=(const Mat4x4& mat) {
+#if defined(MATH_USE_SSE)
+	for (int y = 0; y < Mat4x4::HEIGHT; y++) {
+		this->m[y].m128 = _mm_add_ps(this->m[y].m128, mat.m[y].m128);
+	}
+#else
 	for (int y = 0; y < Mat4x4::HEIGHT; y++) {
 		for (int x = 0; x < Mat4x4::WIDTH; x++) {
 			this->m[y][x] += mat.m[y][x];
 		}
 	}
+#endif
 
 	return *this;
 }
 Mat4x4 Mat4x4::operator-(const Mat4x4& mat) const {
 	Mat4x4 tmp;
 
+#if defined(MATH_USE_SSE)
+	for (int y = 0; y < Mat4x4::HEIGHT; y++) {
+		tmp.m[y].m128 = _mm_sub_ps(this->m[y].m128, mat.m[y].m128);
+	}
+#else
 	for (int y = 0; y < Mat4x4::HEIGHT; y++) {
 		for (int x = 0; x < Mat4x4::WIDTH; x++) {
 			tmp[y][x] = this->m[y][x] - mat.m[y][x];
 		}
 	}
+#endif
 
 	return tmp;
 }
 Mat4x4& Mat4x4::operator-=(const Mat4x4& mat) {
+#if defined(MATH_USE_SSE)
+	for (int y = 0; y < Mat4x4::HEIGHT; y++) {
+		this->m[y].m128 = _mm_sub_ps(this->m[y].m128, mat.m[y].m128);
+	}
+#else
 	for (int y = 0; y < Mat4x4::HEIGHT; y++) {
 		for (int x = 0; x < Mat4x4::WIDTH; x++) {
 			this->m[y][x] -= mat.m[y][x];
 		}
 	}
+#endif
 
 	return *this;
 }
 
-Vector4& Mat4x4::operator[](size_t index) {
-	return m[index];
-}
-
-const Vector4& Mat4x4::operator[](size_t index) const {
-	return m[index];
-}
-
 bool Mat4x4::operator==(const Mat4x4& mat) const {
 	return m == mat.m;
 }
@@ -110,131 +132,127 @@ bool Mat4x4::operator!=(const Mat4x4& mat) const {
 	return m != mat.m;
 }
 
-void Mat4x4::Indentity() {
-	m = {};
-
-	for (int i = 0; i < WIDTH; i++) {
-		m[i][i] = 1.0f;
-	}
-}
-
-void Mat4x4::HoriTranslate(const Vector3& vec) {
-	this->m = {};
-
-	this->m[0][0] = 1.0f;
-	this->m[1][1] = 1.0f;
-	this->m[2][2] = 1.0f;
-	this->m[3][3] = 1.0f;
-
-	this->m[3][0] = vec.x;
-	this->m[3][1] = vec.y;
-	this->m[3][2] = vec.z;
-}
-void Mat4x4::VertTranslate(const Vector3& vec) {
-	this->m = {};
-
-	this->m[0][0] = 1.0f;
-	this->m[1][1] = 1.0f;
-	this->m[2][2] = 1.0f;
-	this->m[3][3] = 1.0f;
-
-	this->m[0][3] = vec.x;
-	this->m[1][3] = vec.y;
-	this->m[2][3] = vec.z;
-}
-
-void Mat4x4::Scalar(const Vector3& vec) {
-	this->m = {};
-
-	this->m[0][0] = vec.x;
-	this->m[1][1] = vec.y;
-	this->m[2][2] = vec.z;
-	this->m[3][3] = 1.0f;
-}
-
 void Mat4x4::HoriRotateX(float rad) {
+	float sin, cos;
+	SinCos(rad, sin, cos);
+
 	this->m = {};
 	this->m[0][0] = 1.0f;
 	this->m[3][3] = 1.0f;
 
-	this->m[1][1] = std::cos(rad);
-	this->m[1][2] = std::sin(rad);
-	this->m[2][1] = -std::sin(rad);
-	this->m[2][2] = std::cos(rad);
+	this->m[1][1] = cos;
+	this->m[1][2] = sin;
+	this->m[2][1] = -sin;
+	this->m[2][2] = cos;
 }
 void Mat4x4::VertRotateX(float rad) {
+	float sin, cos;
+	SinCos(rad, sin, cos);
+
 	this->m = {};
 	this->m[0][0] = 1.0f;
 	this->m[3][3] = 1.0f;
 
-	this->m[1][1] = std::cos(rad);
-	this->m[2][1] = std::sin(rad);
-	this->m[1][2] = -std::sin(rad);
-	this->m[2][2] = std::cos(rad);
+	this->m[1][1] = cos;
+	this->m[2][1] = sin;
+	this->m[1][2] = -sin;
+	this->m[2][2] = cos;
 }
 
 void Mat4x4::HoriRotateY(float rad) {
+	float sin, cos;
+	SinCos(rad, sin, cos);
+
 	this->m = {};
 	this->m[1][1] = 1.0f;
 	this->m[3][3] = 1.0f;
 
-	this->m[0][0] = std::cos(rad);
-	this->m[0][2] = -std::sin(rad);
-	this->m[2][0] = std::sin(rad);
-	this->m[2][2] = std::cos(rad);
+	this->m[0][0] = cos;
+	this->m[0][2] = -sin;
+	this->m[2][0] = sin;
+	this->m[2][2] = cos;
 }
 void Mat4x4::VertRotateY(float rad) {
+	float sin, cos;
+	SinCos(rad, sin, cos);
+
 	this->m = {};
 	this->m[1][1] = 1.0f;
 	this->m[3][3] = 1.0f;
 
-	this->m[0][0] = std::cos(rad);
-	this->m[2][0] = -std::sin(rad);
-	this->m[0][2] = std::sin(rad);
-	this->m[2][2] = std::cos(rad);
+	this->m[0][0] = cos;
+	this->m[2][0] = -sin;
+	this->m[0][2] = sin;
+	this->m[2][2] = cos;
 }
 
 void Mat4x4::HoriRotateZ(float rad) {
+	float sin, cos;
+	SinCos(rad, sin, cos);
+
 	this->m = {};
 	this->m[2][2] = 1.0f;
 	this->m[3][3] = 1.0f;
 	
-	this->m[0][0] = std::cos(rad);
-	this->m[0][1] = -std::sin(rad);
-	this->m[1][0] = std::sin(rad);
-	this->m[1][1] = std::cos(rad);
+	this->m[0][0] = cos;
+	this->m[0][1] = -sin;
+	this->m[1][0] = sin;
+	this->m[1][1] = cos;
 }
 void Mat4x4::VertRotateZ(float rad) {
+	float sin, cos;
+	SinCos(rad, sin, cos);
+
 	this->m = {};
 	this->m[2][2] = 1.0f;
 	this->m[3][3] = 1.0f;
 
-	this->m[0][0] = std::cos(rad);
-	this->m[1][0] = std::sin(rad);
-	this->m[0][1] = -std::sin(rad);
-	this->m[1][1] = std::cos(rad);
+	this->m[0][0] = cos;
+	this->m[1][0] = sin;
+	this->m[0][1] = -sin;
+	this->m[1][1] = cos;
 }
 
 void Mat4x4::HoriAffin(const Vector3& scale, const Vector3& rad, const Vector3& translate) {
-	Mat4x4 rotate = HoriMakeMatrixRotateX(rad.x) * HoriMakeMatrixRotateY(rad.y) * HoriMakeMatrixRotateZ(rad.z);
+	// 3軸分のsin,cosを一度に求めて、RotateX * RotateY * RotateZを展開した式で作る
+	alignas(16) std::array<float, 4> sin;
+	alignas(16) std::array<float, 4> cos;
+	{
+		__m128 sinVec, cosVec;
+		SinCos4(_mm_setr_ps(rad.x, rad.y, rad.z, 0.0f), sinVec, cosVec);
+		_mm_store_ps(sin.data(), sinVec);
+		_mm_store_ps(cos.data(), cosVec);
+	}
+	const float sx = sin[0], sy = sin[1], sz = sin[2];
+	const float cx = cos[0], cy = cos[1], cz = cos[2];
 
 	*this = Mat4x4{ 
 		std::array<Vector4, 4>{
-		Vector4{scale.x * rotate.m[0][0], scale.x * rotate.m[0][1],scale.x * rotate.m[0][2], 0.0f},
-		Vector4{scale.y * rotate.m[1][0], scale.y * rotate.m[1][1],scale.y * rotate.m[1][2], 0.0f },
-		Vector4{scale.z * rotate.m[2][0], scale.z * rotate.m[2][1],scale.z * rotate.m[2][2], 0.0f},
+		Vector4{scale.x * (cy * cz), scale.x * (-cy * sz), scale.x * -sy, 0.0f},
+		Vector4{scale.y * (sx * sy * cz + cx * sz), scale.y * (cx * cz - sx * sy * sz), scale.y * (sx * cy), 0.0f },
+		Vector4{scale.z * (cx * sy * cz - sx * sz), scale.z * (-cx * sy * sz - sx * cz), scale.z * (cx * cy), 0.0f},
 		Vector4{translate.x, translate.y, translate.z, 1.0f}
 		}
 	};
 }
 void Mat4x4::VertAffin(const Vector3& scale, const Vector3& rad, const Vector3& translate) {
-	Mat4x4 rotate = VertMakeMatrixRotateZ(rad.z) * VertMakeMatrixRotateY(rad.y) * VertMakeMatrixRotateX(rad.x);
+	// 3軸分のsin,cosを一度に求めて、RotateZ * RotateY * RotateXを展開した式で作る
+	alignas(16) std::array<float, 4> sin;
+	alignas(16) std::array<float, 4> cos;
+	{
+		__m128 sinVec, cosVec;
+		SinCos4(_mm_setr_ps(rad.x, rad.y, rad.z, 0.0f), sinVec, cosVec);
+		_mm_store_ps(sin.data(), sinVec);
+		_mm_store_ps(cos.data(), cosVec);
+	}
+	const float sx = sin[0], sy = sin[1], sz = sin[2];
+	const float cx = cos[0], cy = cos[1], cz = cos[2];
 
 	*this = Mat4x4{
 		std::array<Vector4, 4>{
-		Vector4{ scale.x * rotate.m[0][0], scale.y * rotate.m[0][1], scale.z * rotate.m[0][2], translate.x },
-		Vector4{ scale.x * rotate.m[1][0], scale.y * rotate.m[1][1], scale.z * rotate.m[1][2], translate.y },
-		Vector4{ scale.x * rotate.m[2][0], scale.y * rotate.m[2][1], scale.z * rotate.m[2][2], translate.z },
+		Vector4{ scale.x * (cz * cy), scale.y * (cz * sy * sx - sz * cx), scale.z * (cz * sy * cx + sz * sx), translate.x },
+		Vector4{ scale.x * (sz * cy), scale.y * (sz * sy * sx + cz * cx), scale.z * (sz * sy * cx - cz * sx), translate.y },
+		Vector4{ scale.x * -sy, scale.y * (cy * sx), scale.z * (cy * cx), translate.z },
 		Vector4{ 0.0f, 0.0f, 0.0f, 1.0f }
 		}
 	};
@@ -242,6 +260,89 @@ void Mat4x4::VertAffin(const Vector3& scale, const Vector3& rad, const Vector3&
 
 
 void Mat4x4::Inverse() {
+#if defined(MATH_USE_SSE)
+	// クラメルの公式(余因子展開)で求める
+	// 転置した行列の各行を、2x2小行列式を作りやすい並びにしておく
+	__m128 row0 = m[0].m128;
+	__m128 row1 = m[1].m128;
+	__m128 row2 = m[2].m128;
+	__m128 row3 = m[3].m128;
+	_MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+	row1 = _mm_shuffle_ps(row1, row1, 0x4e);
+	row3 = _mm_shuffle_ps(row3, row3, 0x4e);
+
+	__m128 minor0, minor1, minor2, minor3;
+	__m128 tmp;
+
+	tmp = _mm_mul_ps(row2, row3);
+	tmp = _mm_shuffle_ps(tmp, tmp, 0xb1);
+	minor0 = _mm_mul_ps(row1, tmp);
+	minor1 = _mm_mul_ps(row0, tmp);
+	tmp = _mm_shuffle_ps(tmp, tmp, 0x4e);
+	minor0 = _mm_sub_ps(_mm_mul_ps(row1, tmp), minor0);
+	minor1 = _mm_sub_ps(_mm_mul_ps(row0, tmp), minor1);
+	minor1 = _mm_shuffle_ps(minor1, minor1, 0x4e);
+
+	tmp = _mm_mul_ps(row1, row2);
+	tmp = _mm_shuffle_ps(tmp, tmp, 0xb1);
+	minor0 = _mm_add_ps(_mm_mul_ps(row3, tmp), minor0);
+	minor3 = _mm_mul_ps(row0, tmp);
+	tmp = _mm_shuffle_ps(tmp, tmp, 0x4e);
+	minor0 = _mm_sub_ps(minor0, _mm_mul_ps(row3, tmp));
+	minor3 = _mm_sub_ps(_mm_mul_ps(row0, tmp), minor3);
+	minor3 = _mm_shuffle_ps(minor3, minor3, 0x4e);
+
+	tmp = _mm_mul_ps(_mm_shuffle_ps(row1, row1, 0x4e), row3);
+	tmp = _mm_shuffle_ps(tmp, tmp, 0xb1);
+	row2 = _mm_shuffle_ps(row2, row2, 0x4e);
+	minor0 = _mm_add_ps(_mm_mul_ps(row2, tmp), minor0);
+	minor2 = _mm_mul_ps(row0, tmp);
+	tmp = _mm_shuffle_ps(tmp, tmp, 0x4e);
+	minor0 = _mm_sub_ps(minor0, _mm_mul_ps(row2, tmp));
+	minor2 = _mm_sub_ps(_mm_mul_ps(row0, tmp), minor2);
+	minor2 = _mm_shuffle_ps(minor2, minor2, 0x4e);
+
+	tmp = _mm_mul_ps(row0, row1);
+	tmp = _mm_shuffle_ps(tmp, tmp, 0xb1);
+	minor2 = _mm_add_ps(_mm_mul_ps(row3, tmp), minor2);
+	minor3 = _mm_sub_ps(_mm_mul_ps(row2, tmp), minor3);
+	tmp = _mm_shuffle_ps(tmp, tmp, 0x4e);
+	minor2 = _mm_sub_ps(_mm_mul_ps(row3, tmp), minor2);
+	minor3 = _mm_sub_ps(minor3, _mm_mul_ps(row2, tmp));
+
+	tmp = _mm_mul_ps(row0, row3);
+	tmp = _mm_shuffle_ps(tmp, tmp, 0xb1);
+	minor1 = _mm_sub_ps(minor1, _mm_mul_ps(row2, tmp));
+	minor2 = _mm_add_ps(_mm_mul_ps(row1, tmp), minor2);
+	tmp = _mm_shuffle_ps(tmp, tmp, 0x4e);
+	minor1 = _mm_add_ps(_mm_mul_ps(row2, tmp), minor1);
+	minor2 = _mm_sub_ps(minor2, _mm_mul_ps(row1, tmp));
+
+	tmp = _mm_mul_ps(row0, row2);
+	tmp = _mm_shuffle_ps(tmp, tmp, 0xb1);
+	minor1 = _mm_add_ps(_mm_mul_ps(row3, tmp), minor1);
+	minor3 = _mm_sub_ps(minor3, _mm_mul_ps(row1, tmp));
+	tmp = _mm_shuffle_ps(tmp, tmp, 0x4e);
+	minor1 = _mm_sub_ps(minor1, _mm_mul_ps(row3, tmp));
+	minor3 = _mm_add_ps(_mm_mul_ps(row1, tmp), minor3);
+
+	// 行列式
+	__m128 det = _mm_mul_ps(row0, minor0);
+	det = _mm_add_ps(_mm_shuffle_ps(det, det, 0x4e), det);
+	det = _mm_add_ps(_mm_shuffle_ps(det, det, 0xb1), det);
+
+	// 逆行列が存在しない場合は何もしない
+	if (_mm_cvtss_f32(det) == 0.0f) {
+		return;
+	}
+
+	det = _mm_div_ps(_mm_set1_ps(1.0f), det);
+
+	m[0].m128 = _mm_mul_ps(det, minor0);
+	m[1].m128 = _mm_mul_ps(det, minor1);
+	m[2].m128 = _mm_mul_ps(det, minor2);
+	m[3].m128 = _mm_mul_ps(det, minor3);
+#else
 	Mat4x4 tmp = *this;
 
 	Mat4x4 identity = MakeMatrixIndentity();
@@ -294,16 +395,86 @@ void Mat4x4::Inverse() {
 	}
 
 	*this = identity;
+#endif
+}
+
+void Mat4x4::HoriInverseAffin() {
+	// 左上3x3の逆行列(余因子行列 / 行列式)
+	const Vector3 c0 = { m[0][0], m[1][0], m[2][0] };
+	const Vector3 c1 = { m[0][1], m[1][1], m[2][1] };
+	const Vector3 c2 = { m[0][2], m[1][2], m[2][2] };
+
+	const Vector3 r0 = c1.Cross(c2);
+	const Vector3 r1 = c2.Cross(c0);
+	const Vector3 r2 = c0.Cross(c1);
+
+	const float det = c0.Dot(r0);
+
+	// 逆行列が存在しない場合は何もしない
+	if (det == 0.0f) {
+		return;
+	}
+
+	const float invDet = 1.0f / det;
+	const Vector3 translate = { m[3][0], m[3][1], m[3][2] };
+
+	m = {
+		Vector4{ r0.x * invDet, r0.y * invDet, r0.z * invDet, 0.0f },
+		Vector4{ r1.x * invDet, r1.y * invDet, r1.z * invDet, 0.0f },
+		Vector4{ r2.x * invDet, r2.y * invDet, r2.z * invDet, 0.0f },
+		Vector4{ 0.0f, 0.0f, 0.0f, 1.0f }
+	};
+
+	// 平行移動は -translate * 逆行列(3x3)
+	m[3][0] = -(translate.x * m[0][0] + translate.y * m[1][0] + translate.z * m[2][0]);
+	m[3][1] = -(translate.x * m[0][1] + translate.y * m[1][1] + translate.z * m[2][1]);
+	m[3][2] = -(translate.x * m[0][2] + translate.y * m[1][2] + translate.z * m[2][2]);
+}
+void Mat4x4::VertInverseAffin() {
+	// 左上3x3の逆行列(余因子行列 / 行列式)
+	const Vector3 c0 = { m[0][0], m[1][0], m[2][0] };
+	const Vector3 c1 = { m[0][1], m[1][1], m[2][1] };
+	const Vector3 c2 = { m[0][2], m[1][2], m[2][2] };
+
+	const Vector3 r0 = c1.Cross(c2);
+	const Vector3 r1 = c2.Cross(c0);
+	const Vector3 r2 = c0.Cross(c1);
+
+	const float det = c0.Dot(r0);
+
+	// 逆行列が存在しない場合は何もしない
+	if (det == 0.0f) {
+		return;
+	}
+
+	const float invDet = 1.0f / det;
+	const Vector3 translate = { m[0][3], m[1][3], m[2][3] };
+
+	m = {
+		Vector4{ r0.x * invDet, r0.y * invDet, r0.z * invDet, 0.0f },
+		Vector4{ r1.x * invDet, r1.y * invDet, r1.z * invDet, 0.0f },
+		Vector4{ r2.x * invDet, r2.y * invDet, r2.z * invDet, 0.0f },
+		Vector4{ 0.0f, 0.0f, 0.0f, 1.0f }
+	};
+
+	// 平行移動は 逆行列(3x3) * -translate
+	m[0][3] = -(m[0][0] * translate.x + m[0][1] * translate.y + m[0][2] * translate.z);
+	m[1][3] = -(m[1][0] * translate.x + m[1][1] * translate.y + m[1][2] * translate.z);
+	m[2][3] = -(m[2][0] * translate.x + m[2][1] * translate.y + m[2][2] * translate.z);
 }
 
 
 void Mat4x4::Transepose() {
+#if defined(MATH_USE_SSE)
+	_MM_TRANSPOSE4_PS(m[0].m128, m[1].m128, m[2].m128, m[3].m128);
+#else
 	std::swap(m[1][0], m[0][1]);
 	std::swap(m[2][0], m[0][2]);
 	std::swap(m[3][0], m[0][3]);
 	std::swap(m[2][1], m[1][2]);
 	std::swap(m[2][3], m[3][2]);
 	std::swap(m[3][1], m[1][3]);
+#endif
 }
 
 void Mat4x4::HoriPerspectiveFov(float fovY, float aspectRatio, float nearClip, float farClip) {
@@ -325,66 +496,21 @@ void Mat4x4::VertPerspectiveFov(float fovY, float aspectRatio, float nearClip, f
 	m[2][3] = (-nearClip * farClip) / (farClip - nearClip);
 }
 
-void Mat4x4::HoriOrthographic(float left, float top, float right, float bottom, float nearClip, float farClip) {
-	m = {};
-
-	m[0][0] = 2.0f / (right - left);
-	m[1][1] = 2.0f / (top - bottom);
-	m[2][2] = 1.0f / (farClip - nearClip);
-	m[3][3] = 1.0f;
 
-	m[3][0] = (left + right) / (left - right);
-	m[3][1] = (top + bottom) / (bottom - top);
-	m[3][2] = nearClip / (nearClip - farClip);
-}
-void Mat4x4::VertOrthographic(float left, float top, float right, float bottom, float nearClip, float farClip) {
-	m = {};
-
-	m[0][0] = 2.0f / (right - left);
-	m[1][1] = 2.0f / (top - bottom);
-	m[2][2] = 1.0f / (farClip - nearClip);
-	m[3][3] = 1.0f;
-
-	m[0][3] = (left + right) / (left - right);
-	m[1][3] = (top + bottom) / (bottom - top);
-	m[2][3] = nearClip / (nearClip - farClip);
-}
-
-void Mat4x4::HoriViewPort(float left, float top, float width, float height, float minDepth, float maxDepth) {
-	m = {};
-
-	m[0][0] = width / 2.0f;
-	m[1][1] = height/ -2.0f;
-	m[2][2] = maxDepth - minDepth;
-	m[3][3] = 1.0f;
-
-	m[3][0] = left + (width / 2.0f);
-	m[3][1] = top + (height / 2.0f);
-	m[3][2] = minDepth;
-}
-void Mat4x4::VertViewPort(float left, float top, float width, float height, float minDepth, float maxDepth) {
-	m = {};
-
-	m[0][0] = width / 2.0f;
-	m[1][1] = height / -2.0f;
-	m[2][2] = maxDepth - minDepth;
-	m[3][3] = 1.0f;
-
-	m[0][3] = left + (width / 2.0f);
-	m[1][3] = top + (height / 2.0f);
-	m[2][3] = minDepth;
+Mat4x4 MakeMatrixInverse(Mat4x4 mat) {
+	Mat4x4 tmp = mat;
+	tmp.Inverse();
+	return tmp;
 }
 
-
-Mat4x4 MakeMatrixIndentity() {
-	Mat4x4 tmp;
-	tmp.Indentity();
+Mat4x4 HoriMakeMatrixInverseAffin(Mat4x4 mat) {
+	Mat4x4 tmp = mat;
+	tmp.HoriInverseAffin();
 	return tmp;
 }
-
-Mat4x4 MakeMatrixInverse(Mat4x4 mat) {
+Mat4x4 VertMakeMatrixInverseAffin(Mat4x4 mat) {
 	Mat4x4 tmp = mat;
-	tmp.Inverse();
+	tmp.VertInverseAffin();
 	return tmp;
 }
 
@@ -394,29 +520,6 @@ Mat4x4 MakeMatrixTransepose(Mat4x4 mat) {
 	return tmp;
 }
 
-Mat4x4 HoriMakeMatrixTranslate(Vector3 vec) {
-	Mat4x4 mat;
-
-	mat.HoriTranslate(vec);
-
-	return mat;
-}
-Mat4x4 VertMakeMatrixTranslate(Vector3 vec) {
-	Mat4x4 mat;
-
-	mat.VertTranslate(vec);
-
-	return mat;
-}
-
-Mat4x4 MakeMatrixScalar(Vector3 vec) {
-	Mat4x4 mat;
-
-	mat.Scalar(vec);
-
-	return mat;
-}
-
 Mat4x4 HoriMakeMatrixRotateX(float rad) {
 	Mat4x4 tmp;
 
@@ -489,35 +592,5 @@ Mat4x4 VertMakeMatrixPerspectiveFov(float fovY, float aspectRatio, float nearCli
 
 	tmp.VertPerspectiveFov(fovY, aspectRatio, nearClip, farClip);
 
-	return tmp;
-}
-
-Mat4x4 HoriMakeMatrixOrthographic(float left, float right, float top, float bottom, float nearClip, float farClip) {
-	Mat4x4 tmp;
-
-	tmp.HoriOrthographic(left, right, top, bottom, nearClip, farClip);
-
-	return tmp;
-}
-Mat4x4 VertMakeMatrixOrthographic(float left, float right, float top, float bottom, float nearClip, float farClip) {
-	Mat4x4 tmp;
-
-	tmp.VertOrthographic(left, right, top, bottom, nearClip, farClip);
-
-	return tmp;
-}
-
-Mat4x4 HoriMakeMatrixViewPort(float left, float top, float width, float height, float minDepth, float maxDepth) {
-	Mat4x4 tmp;
-
-	tmp.HoriViewPort(left, top, width, height, minDepth, maxDepth);
-
-	return tmp;
-}
-Mat4x4 VertMakeMatrixViewPort(float left, float top, float width, float height, float minDepth, float maxDepth) {
-	Mat4x4 tmp;
-
-	tmp.VertViewPort(left, top, width, height, minDepth, maxDepth);
-
 	return tmp;
 }
\ No newline at end of file
@@ -2,19 +2,23 @@
 
 #include <array>
 #include <string>
+#include <type_traits>
 #include "Vector4.h"
-
-class Vector3;
+#include "Vector3.h"
 
 class Mat4x4 final {
 /// <summary>
 /// コンストラクタ
 /// </summary>
 public:
-	Mat4x4();
-	Mat4x4(const Mat4x4& mat);
-	Mat4x4(Mat4x4&& mat) noexcept;
-	Mat4x4(const std::array<Vector4, 4>& num);
+	constexpr Mat4x4() :
+		m()
+	{}
+	constexpr Mat4x4(const Mat4x4& mat) = default;
+	constexpr Mat4x4(Mat4x4&& mat) noexcept = default;
+	constexpr Mat4x4(const std::array<Vector4, 4>& num) :
+		m(num)
+	{}
 public:
 	~Mat4x4() = default;
 
@@ -22,8 +26,8 @@ public:
 /// 演算子のオーバーロード
 /// </summary>
 public:
-	Mat4x4& operator=(const Mat4x4& mat);
-	Mat4x4& operator=(Mat4x4&& mat) noexcept;
+	constexpr Mat4x4& operator=(const Mat4x4& mat) = default;
+	constexpr Mat4x4& operator=(Mat4x4&& mat) noexcept = default;
 	Mat4x4 operator*(const Mat4x4& mat) const;
 	Mat4x4& operator*=(const Mat4x4& mat);
 
@@ -32,8 +36,12 @@ public:
 	Mat4x4 operator-(const Mat4x4& mat) const;
 	Mat4x4& operator-=(const Mat4x4& mat);
 
-	Vector4& operator[](size_t index);
-	const Vector4& operator[](size_t index) const;
+	constexpr Vector4& operator[](size_t index) {
+		return m[index];
+	}
+	constexpr const Vector4& operator[](size_t index) const {
+		return m[index];
+	}
 
 	bool operator==(const Mat4x4& mat) const;
 	bool operator!=(const Mat4x4& mat) const;
@@ -42,12 +50,37 @@ public:
 /// メンバ関数
 /// </summary>
 public:
-	void Indentity();
-
-	void HoriTranslate(const Vector3& vec);
-	void VertTranslate(const Vector3& vec);
-
-	void Scalar(const Vector3& vec);
+	constexpr void Indentity() {
+		m = {};
+
+		for (int i = 0; i < WIDTH; i++) {
+			m[i][i] = 1.0f;
+		}
+	}
+
+	constexpr void HoriTranslate(const Vector3& vec) {
+		Indentity();
+
+		m[3][0] = vec.x;
+		m[3][1] = vec.y;
+		m[3][2] = vec.z;
+	}
+	constexpr void VertTranslate(const Vector3& vec) {
+		Indentity();
+
+		m[0][3] = vec.x;
+		m[1][3] = vec.y;
+		m[2][3] = vec.z;
+	}
+
+	constexpr void Scalar(const Vector3& vec) {
+		m = {};
+
+		m[0][0] = vec.x;
+		m[1][1] = vec.y;
+		m[2][2] = vec.z;
+		m[3][3] = 1.0f;
+	}
 
 	void HoriRotateX(float rad);
 	void VertRotateX(float rad);
@@ -63,16 +96,66 @@ public:
 
 	void Inverse();
 
+	/// <summary>
+	/// 拡縮、回転、平行移動のみの行列(アフィン行列)の逆行列
+	/// </summary>
+	void HoriInverseAffin();
+	void VertInverseAffin();
+
 	void Transepose();
 
 	void HoriPerspectiveFov(float fovY, float aspectRatio, float nearClip, float farClip);
 	void VertPerspectiveFov(float fovY, float aspectRatio, float nearClip, float farClip);
 
-	void HoriOrthographic(float left, float right, float top, float bottom, float nearClip, float farClip);
-	void VertOrthographic(float left, float right, float top, float bottom, float nearClip, float farClip);
-
-	void HoriViewPort(float left, float top, float width, float height, float minDepth, float maxDepth);
-	void VertViewPort(float left, float top, float width, float height, float minDepth, float maxDepth);
+	constexpr void HoriOrthographic(float left, float top, float right, float bottom, float nearClip, float farClip) {
+		m = {};
+
+		m[0][0] = 2.0f / (right - left);
+		m[1][1] = 2.0f / (top - bottom);
+		m[2][2] = 1.0f / (farClip - nearClip);
+		m[3][3] = 1.0f;
+
+		m[3][0] = (left + right) / (left - right);
+		m[3][1] = (top + bottom) / (bottom - top);
+		m[3][2] = nearClip / (nearClip - farClip);
+	}
+	constexpr void VertOrthographic(float left, float top, float right, float bottom, float nearClip, float farClip) {
+		m = {};
+
+		m[0][0] = 2.0f / (right - left);
+		m[1][1] = 2.0f / (top - bottom);
+		m[2][2] = 1.0f / (farClip - nearClip);
+		m[3][3] = 1.0f;
+
+		m[0][3] = (left + right) / (left - right);
+		m[1][3] = (top + bottom) / (bottom - top);
+		m[2][3] = nearClip / (nearClip - farClip);
+	}
+
+	constexpr void HoriViewPort(float left, float top, float width, float height, float minDepth, float maxDepth) {
+		m = {};
+
+		m[0][0] = width / 2.0f;
+		m[1][1] = height / -2.0f;
+		m[2][2] = maxDepth - minDepth;
+		m[3][3] = 1.0f;
+
+		m[3][0] = left + (width / 2.0f);
+		m[3][1] = top + (height / 2.0f);
+		m[3][2] = minDepth;
+	}
+	constexpr void VertViewPort(float left, float top, float width, float height, float minDepth, float maxDepth) {
+		m = {};
+
+		m[0][0] = width / 2.0f;
+		m[1][1] = height / -2.0f;
+		m[2][2] = maxDepth - minDepth;
+		m[3][3] = 1.0f;
+
+		m[0][3] = left + (width / 2.0f);
+		m[1][3] = top + (height / 2.0f);
+		m[2][3] = minDepth;
+	}
 
 /// <summary>
 /// 静的定数
@@ -89,12 +172,38 @@ private:
 };
 
 
-Mat4x4 MakeMatrixIndentity();
+static_assert(std::is_trivially_copyable_v<Mat4x4>, "Mat4x4 must be trivially copyable");
+static_assert(sizeof(Mat4x4) == sizeof(float) * 16 && alignof(Mat4x4) == alignof(__m128), "Mat4x4 must be 16 contiguous floats");
+
+
+constexpr Mat4x4 MakeMatrixIndentity() {
+	Mat4x4 tmp;
+	tmp.Indentity();
+	return tmp;
+}
+
+constexpr Mat4x4 HoriMakeMatrixTranslate(Vector3 vec) {
+	Mat4x4 mat;
+
+	mat.HoriTranslate(vec);
+
+	return mat;
+}
+constexpr Mat4x4 VertMakeMatrixTranslate(Vector3 vec) {
+	Mat4x4 mat;
+
+	mat.VertTranslate(vec);
+
+	return mat;
+}
 
-Mat4x4 HoriMakeMatrixTranslate(Vector3 vec);
-Mat4x4 VertMakeMatrixTranslate(Vector3 vec);
+constexpr Mat4x4 MakeMatrixScalar(Vector3 vec) {
+	Mat4x4 mat;
 
-Mat4x4 MakeMatrixScalar(Vector3 vec);
+	mat.Scalar(vec);
+
+	return mat;
+}
 
 Mat4x4 HoriMakeMatrixRotateX(float rad);
 Mat4x4 VertMakeMatrixRotateX(float rad);
@@ -110,13 +219,47 @@ Mat4x4 VertMakeMatrixAffin(const Vector3& scale, const Vector3& rad, const Vecto
 
 Mat4x4 MakeMatrixInverse(Mat4x4 mat);
 
+Mat4x4 HoriMakeMatrixInverseAffin(Mat4x4 mat);
+Mat4x4 VertMakeMatrixInverseAffin(Mat4x4 mat);
+
 Mat4x4 MakeMatrixTransepose(Mat4x4 mat);
 
 Mat4x4 HoriMakeMatrixPerspectiveFov(float fovY, float aspectRatio, float nearClip, float farClip);
 Mat4x4 VertMakeMatrixPerspectiveFov(float fovY, float aspectRatio, float nearClip, float farClip);
 
-Mat4x4 HoriMakeMatrixOrthographic(float left, float top, float right, float bottom, float nearClip, float farClip);
-Mat4x4 VertMakeMatrixOrthographic(float left, float top, float right, float bottom, float nearClip, float farClip);
+constexpr Mat4x4 HoriMakeMatrixOrthographic(float left, float top, float right, float bottom, float nearClip, float farClip) {
+	Mat4x4 tmp;
+
+	tmp.HoriOrthographic(left, top, right, bottom, nearClip, farClip);
+
+	return tmp;
+}
+constexpr Mat4x4 VertMakeMatrixOrthographic(float left, float top, float right, float bottom, float nearClip, float farClip) {
+	Mat4x4 tmp;
+
+	tmp.VertOrthographic(left, top, right, bottom, nearClip, farClip);
+
+	return tmp;
+}
+
+constexpr Mat4x4 HoriMakeMatrixViewPort(float left, float top, float width, float height, float minDepth, float maxDepth) {
+	Mat4x4 tmp;
+
+	tmp.HoriViewPort(left, top, width, height, minDepth, maxDepth);
+
+	return tmp;
+}
+constexpr Mat4x4 VertMakeMatrixViewPort(float left, float top, float width, float height, float minDepth, float maxDepth) {
+	Mat4x4 tmp;
+
+	tmp.VertViewPort(left, top, width, height, minDepth, maxDepth);
+
+	return tmp;
+}
 
-Mat4x4 HoriMakeMatrixViewPort(float left, float top, float width, float height, float minDepth, float maxDepth);
-Mat4x4 VertMakeMatrixViewPort(float left, float top, float width, float height, float minDepth, float maxDepth);
\ No newline at end of file
+// コンパイル時に計算できるかの確認
+static_assert(MakeMatrixIndentity()[2][2] == 1.0f && MakeMatrixIndentity()[2][3] == 0.0f);
+static_assert(HoriMakeMatrixTranslate(Vector3(1.0f, 2.0f, 3.0f))[3][2] == 3.0f);
+static_assert(VertMakeMatrixTranslate(Vector3(1.0f, 2.0f, 3.0f))[2][3] == 3.0f);
+static_assert(MakeMatrixScalar(Vector3(1.0f, 2.0f, 3.0f))[1][1] == 2.0f);
+static_assert(VertMakeMatrixOrthographic(-1.0f, 1.0f, 1.0f, -1.0f, 0.0f, 1.0f)[0][0] == 1.0f);
\ No newline at end of file
@@ -0,0 +1,266 @@
+#include "Quaternion.h"
+#include "Vector3.h"
+#include "Mat4x4.h"
+#include "SinCos.h"
+#include <cmath>
+
+#ifdef MATH_USE_SSE
+namespace {
+	/// <summary>
+	/// 4要素の内積を全ての要素に入れる(_mm_dp_psはSSE4.1なので、SSE2のシャッフルと加算で足す)
+	/// </summary>
+	inline __m128 Dot4(__m128 left, __m128 right) noexcept {
+		__m128 sum = _mm_mul_ps(left, right);
+		sum = _mm_add_ps(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(2, 3, 0, 1)));
+		return _mm_add_ps(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 0, 3, 2)));
+	}
+}
+#endif
+
+const Quaternion Quaternion::identity = { 0.0f, 0.0f, 0.0f, 1.0f };
+
+Quaternion::Quaternion(const Vector3& vector, float w) noexcept :
+	m{ vector.x, vector.y, vector.z, w }
+{}
+
+Quaternion Quaternion::operator+(const Quaternion& right) const noexcept {
+	Quaternion result;
+#ifdef MATH_USE_SSE
+	result.m128 = _mm_add_ps(m128, right.m128);
+#else
+	for (size_t i = 0; i < result.m.size(); i++) {
+		result.m[i] = m[i] + right.m[i];
+	}
+#endif
+	return result;
+}
+Quaternion& Quaternion::operator+=(const Quaternion& right) noexcept {
+	*this = *this + right;
+
+	return *this;
+}
+
+Quaternion Quaternion::operator-(const Quaternion& right) const noexcept {
+	Quaternion result;
+#ifdef MATH_USE_SSE
+	result.m128 = _mm_sub_ps(m128, right.m128);
+#else
+	for (size_t i = 0; i < result.m.size(); i++) {
+		result.m[i] = m[i] - right.m[i];
+	}
+#endif
+	return result;
+}
+Quaternion& Quaternion::operator-=(const Quaternion& right) noexcept {
+	*this = *this - right;
+
+	return *this;
+}
+
+Quaternion Quaternion::operator*(const Quaternion& right) const noexcept {
+	Quaternion result;
+#ifdef MATH_USE_SSE
+	// w1 * q2 + x1 * (w2,-z2,y2,-x2) + y1 * (z2,w2,-x2,-y2) + z1 * (-y2,x2,w2,-z2)
+	const __m128 signX = _mm_setr_ps(1.0f, -1.0f, 1.0f, -1.0f);
+	const __m128 signY = _mm_setr_ps(1.0f, 1.0f, -1.0f, -1.0f);
+	const __m128 signZ = _mm_setr_ps(-1.0f, 1.0f, 1.0f, -1.0f);
+
+	__m128 sum = _mm_mul_ps(_mm_shuffle_ps(m128, m128, 0xff), right.m128);
+	sum = _mm_add_ps(sum, _mm_mul_ps(_mm_shuffle_ps(m128, m128, 0x00), _mm_mul_ps(_mm_shuffle_ps(right.m128, right.m128, _MM_SHUFFLE(0, 1, 2, 3)), signX)));
+	sum = _mm_add_ps(sum, _mm_mul_ps(_mm_shuffle_ps(m128, m128, 0x55), _mm_mul_ps(_mm_shuffle_ps(right.m128, right.m128, _MM_SHUFFLE(1, 0, 3, 2)), signY)));
+	sum = _mm_add_ps(sum, _mm_mul_ps(_mm_shuffle_ps(m128, m128, 0xaa), _mm_mul_ps(_mm_shuffle_ps(right.m128, right.m128, _MM_SHUFFLE(2, 3, 0, 1)), signZ)));
+	result.m128 = sum;
+#else
+	const auto& [x1, y1, z1, w1] = quaternion;
+	const auto& [x2, y2, z2, w2] = right.quaternion;
+
+	result.quaternion.x = w1 * x2 + x1 * w2 + y1 * z2 + z1 * -y2;
+	result.quaternion.y = w1 * y2 + x1 * -z2 + y1 * w2 + z1 * x2;
+	result.quaternion.z = w1 * z2 + x1 * y2 + y1 * -x2 + z1 * w2;
+	result.quaternion.w = w1 * w2 + x1 * -x2 + y1 * -y2 + z1 * -z2;
+#endif
+	return result;
+}
+Quaternion& Quaternion::operator*=(const Quaternion& right) noexcept {
+	*this = *this * right;
+
+	return *this;
+}
+
+Quaternion Quaternion::operator*(float scalar) const noexcept {
+	Quaternion result;
+#ifdef MATH_USE_SSE
+	result.m128 = _mm_mul_ps(m128, _mm_set1_ps(scalar));
+#else
+	for (size_t i = 0; i < result.m.size(); i++) {
+		result.m[i] = m[i] * scalar;
+	}
+#endif
+	return result;
+}
+Quaternion& Quaternion::operator*=(float scalar) noexcept {
+	*this = *this * scalar;
+
+	return *this;
+}
+
+bool Quaternion::operator==(const Quaternion& right) const noexcept {
+	return m == right.m;
+}
+bool Quaternion::operator!=(const Quaternion& right) const noexcept {
+	return m != right.m;
+}
+
+float Quaternion::Dot(const Quaternion& right) const noexcept {
+#ifdef MATH_USE_SSE
+	return _mm_cvtss_f32(Dot4(m128, right.m128));
+#else
+	// SSE版と同じく(x + y) + (z + w)の順に足す
+	return (m[0] * right.m[0] + m[1] * right.m[1]) + (m[2] * right.m[2] + m[3] * right.m[3]);
+#endif
+}
+
+float Quaternion::Length() const noexcept {
+	return std::sqrt(Dot(*this));
+}
+
+Quaternion Quaternion::Normalize() const noexcept {
+	float length = Length();
+	if (length == 0.0f) {
+		return *this;
+	}
+
+	return *this * (1.0f / length);
+}
+
+Quaternion Quaternion::Conjugate() const noexcept {
+	return Quaternion(-quaternion.x, -quaternion.y, -quaternion.z, quaternion.w);
+}
+
+Quaternion Quaternion::Inverse() const noexcept {
+	float lengthSq = Dot(*this);
+	if (lengthSq == 0.0f) {
+		return *this;
+	}
+
+	return Conjugate() * (1.0f / lengthSq);
+}
+
+Vector3 Quaternion::Rotate(const Vector3& vec) const noexcept {
+	Quaternion result = *this * Quaternion(vec, 0.0f) * Conjugate();
+
+	return Vector3(result.quaternion.x, result.quaternion.y, result.quaternion.z);
+}
+
+Mat4x4 Quaternion::GetHoriMatrix() const noexcept {
+	const auto& [x, y, z, w] = quaternion;
+
+	const float xx = x * x, yy = y * y, zz = z * z;
+	const float xy = x * y, xz = x * z, yz = y * z;
+	const float wx = w * x, wy = w * y, wz = w * z;
+
+	return Mat4x4{
+		std::array<Vector4, 4>{
+			Vector4{ 1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy), 0.0f },
+			Vector4{ 2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx), 0.0f },
+			Vector4{ 2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy), 0.0f },
+			Vector4{ 0.0f, 0.0f, 0.0f, 1.0f }
+		}
+	};
+}
+
+Mat4x4 Quaternion::GetVertMatrix() const noexcept {
+	Mat4x4 result = GetHoriMatrix();
+	result.Transepose();
+
+	return result;
+}
+
+Quaternion Quaternion::MakeRotateAxisAngle(const Vector3& axis, float rad) noexcept {
+	float sin, cos;
+	SinCos(rad * 0.5f, sin, cos);
+
+	return Quaternion(axis * sin, cos);
+}
+
+namespace {
+	/// <summary>
+	/// Z軸回転 * Y軸回転 * X軸回転のクォータニオン(半角のsin,cosは一度にまとめて求める)
+	/// </summary>
+	Quaternion MakeRotateZYX(float radX, float radY, float radZ) noexcept {
+		alignas(16) std::array<float, 4> sin;
+		alignas(16) std::array<float, 4> cos;
+		{
+			__m128 sinVec, cosVec;
+			SinCos4(_mm_mul_ps(_mm_setr_ps(radX, radY, radZ, 0.0f), _mm_set1_ps(0.5f)), sinVec, cosVec);
+			_mm_store_ps(sin.data(), sinVec);
+			_mm_store_ps(cos.data(), cosVec);
+		}
+		const float sx = sin[0], sy = sin[1], sz = sin[2];
+		const float cx = cos[0], cy = cos[1], cz = cos[2];
+
+		return Quaternion(
+			cz * cy * sx - sz * sy * cx,
+			cz * sy * cx + sz * cy * sx,
+			sz * cy * cx - cz * sy * sx,
+			cz * cy * cx + sz * sy * sx
+		);
+	}
+}
+
+Quaternion Quaternion::HoriMakeRotateEuler(const Vector3& rad) noexcept {
+	// HoriMakeMatrixRotateZは縦ベクトル用と同じ並びなので、横ベクトルで見るとZ軸だけ逆回転になる
+	return MakeRotateZYX(rad.x, rad.y, -rad.z);
+}
+
+Quaternion Quaternion::VertMakeRotateEuler(const Vector3& rad) noexcept {
+	return MakeRotateZYX(rad.x, rad.y, rad.z);
+}
+
+Quaternion Nlerp(const Quaternion& start, const Quaternion& end, float t) noexcept {
+	Quaternion result;
+	float dot = start.Dot(end);
+
+#ifdef MATH_USE_SSE
+	// 内積が負なら遠回りになるので終点を反転する
+	__m128 endVec = dot < 0.0f ? _mm_sub_ps(_mm_setzero_ps(), end.m128) : end.m128;
+	__m128 lerp = _mm_add_ps(start.m128, _mm_mul_ps(_mm_sub_ps(endVec, start.m128), _mm_set1_ps(t)));
+	__m128 lengthSq = Dot4(lerp, lerp);
+	if (_mm_cvtss_f32(lengthSq) == 0.0f) {
+		return start;
+	}
+	result.m128 = _mm_div_ps(lerp, _mm_sqrt_ps(lengthSq));
+#else
+	Quaternion endQua = dot < 0.0f ? end * -1.0f : end;
+	result = (start + (endQua - start) * t).Normalize();
+#endif
+	return result;
+}
+
+Quaternion Slerp(const Quaternion& start, const Quaternion& end, float t) noexcept {
+	float dot = start.Dot(end);
+	float sign = 1.0f;
+	if (dot < 0.0f) {
+		dot = -dot;
+		sign = -1.0f;
+	}
+
+	// ほぼ同じ向きならsinθが0に近く不安定になるのでNlerpで代用する
+	static constexpr float kNlerpThreshold = 0.9995f;
+	if (kNlerpThreshold < dot) {
+		return Nlerp(start, end, t);
+	}
+
+	float theta = std::acos(dot);
+	float invSin = 1.0f / std::sin(theta);
+	float startScale = std::sin((1.0f - t) * theta) * invSin;
+	float endScale = std::sin(t * theta) * invSin * sign;
+
+	Quaternion result;
+#ifdef MATH_USE_SSE
+	result.m128 = _mm_add_ps(_mm_mul_ps(start.m128, _mm_set1_ps(startScale)), _mm_mul_ps(end.m128, _mm_set1_ps(endScale)));
+#else
+	result = start * startScale + end * endScale;
+#endif
+	return result;
+}
@@ -0,0 +1,144 @@
+#pragma once
+#include <array>
+#include <type_traits>
+#include <immintrin.h>
+#include "Vector4.h"
+
+class Vector3;
+class Mat4x4;
+
+/// <summary>
+/// 回転を表すクォータニオン(x,y,zが虚部、wが実部)
+/// </summary>
+class Quaternion final {
+/// <summary>
+/// コンストラクタ
+/// </summary>
+public:
+	/// <summary>
+	/// 単位クォータニオン(回転なし)で初期化
+	/// </summary>
+	constexpr Quaternion() noexcept :
+		m{ 0.0f, 0.0f, 0.0f, 1.0f }
+	{}
+	constexpr Quaternion(const Quaternion& right) noexcept = default;
+	constexpr Quaternion(Quaternion&& right) noexcept = default;
+	constexpr Quaternion(float x, float y, float z, float w) noexcept :
+		m{ x,y,z,w }
+	{}
+	Quaternion(const Vector3& vector, float w) noexcept;
+public:
+	~Quaternion() = default;
+
+/// <summary>
+/// 演算子のオーバーロード
+/// </summary>
+public:
+	constexpr Quaternion& operator=(const Quaternion& right) noexcept = default;
+	constexpr Quaternion& operator=(Quaternion&& right) noexcept = default;
+
+	Quaternion operator+(const Quaternion& right) const noexcept;
+	Quaternion& operator+=(const Quaternion& right) noexcept;
+	Quaternion operator-(const Quaternion& right) const noexcept;
+	Quaternion& operator-=(const Quaternion& right) noexcept;
+
+	/// <summary>
+	/// 積(right回転の後にthis回転をする)
+	/// </summary>
+	Quaternion operator*(const Quaternion& right) const noexcept;
+	Quaternion& operator*=(const Quaternion& right) noexcept;
+
+	Quaternion operator*(float scalar) const noexcept;
+	Quaternion& operator*=(float scalar) noexcept;
+
+	bool operator==(const Quaternion& right) const noexcept;
+	bool operator!=(const Quaternion& right) const noexcept;
+
+	constexpr float& operator[](size_t index) noexcept {
+		return m[index];
+	}
+	constexpr const float& operator[](size_t index) const noexcept {
+		return m[index];
+	}
+
+/// <summary>
+/// メンバ関数
+/// </summary>
+public:
+	float Dot(const Quaternion& right) const noexcept;
+	float Length() const noexcept;
+	Quaternion Normalize() const noexcept;
+	Quaternion Conjugate() const noexcept;
+	Quaternion Inverse() const noexcept;
+
+	/// <summary>
+	/// ベクトルを回転させる
+	/// </summary>
+	Vector3 Rotate(const Vector3& vec) const noexcept;
+
+	/// <summary>
+	/// 回転行列(横ベクトル用。HoriMakeMatrixRotate系と同じ並び)
+	/// </summary>
+	Mat4x4 GetHoriMatrix() const noexcept;
+	/// <summary>
+	/// 回転行列(縦ベクトル用。VertMakeMatrixRotate系と同じ並び)
+	/// </summary>
+	Mat4x4 GetVertMatrix() const noexcept;
+
+/// <summary>
+/// 静的関数
+/// </summary>
+public:
+	/// <summary>
+	/// 任意軸回転
+	/// </summary>
+	/// <param name="axis">回転軸(正規化済み)</param>
+	/// <param name="rad">回転量(ラジアン)</param>
+	static Quaternion MakeRotateAxisAngle(const Vector3& axis, float rad) noexcept;
+
+	/// <summary>
+	/// HoriMakeMatrixRotateX(rad.x) * HoriMakeMatrixRotateY(rad.y) * HoriMakeMatrixRotateZ(rad.z)と同じ回転
+	/// </summary>
+	static Quaternion HoriMakeRotateEuler(const Vector3& rad) noexcept;
+	/// <summary>
+	/// VertMakeMatrixRotateZ(rad.z) * VertMakeMatrixRotateY(rad.y) * VertMakeMatrixRotateX(rad.x)と同じ回転
+	/// </summary>
+	static Quaternion VertMakeRotateEuler(const Vector3& rad) noexcept;
+
+/// <summary>
+/// 静的定数
+/// </summary>
+public:
+	/// <summary>
+	/// x = 0.0f, y = 0.0f, z = 0.0f, w = 1.0f
+	/// </summary>
+	static const Quaternion identity;
+
+/// <summary>
+/// メンバ変数
+/// </summary>
+public:
+	union {
+		std::array<float, 4> m;
+		struct {
+			float x;
+			float y;
+			float z;
+			float w;
+		} quaternion;
+		__m128 m128;
+	};
+};
+
+static_assert(std::is_trivially_copyable_v<Quaternion>, "Quaternion must be trivially copyable");
+static_assert(sizeof(Quaternion) == sizeof(float) * 4 && alignof(Quaternion) == alignof(__m128), "Quaternion must have the same layout as __m128");
+
+/// <summary>
+/// 正規化線形補間(速度は一定ではないがSlerpより軽い)
+/// </summary>
+Quaternion Nlerp(const Quaternion& start, const Quaternion& end, float t) noexcept;
+
+/// <summary>
+/// 球面線形補間
+/// </summary>
+Quaternion Slerp(const Quaternion& start, const Quaternion& end, float t) noexcept;
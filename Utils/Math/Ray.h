@@ -0,0 +1,17 @@
+#pragma once
+#include "Vector3.h"
+
+/// <summary>
+/// 半直線(origin + direction * t, 0 <= t)
+/// </summary>
+struct Ray {
+	Vector3 origin;
+	/// <summary>
+	/// 向き(正規化していれば、tがそのまま距離になる)
+	/// </summary>
+	Vector3 direction;
+
+	inline Vector3 GetPoint(float t) const noexcept {
+		return origin + direction * t;
+	}
+};
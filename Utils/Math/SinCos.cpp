@@ -0,0 +1,116 @@
+#include "SinCos.h"
+#include <cmath>
+#include <array>
+
+void SinCos4(__m128 rad, __m128& sinOut, __m128& cosOut) noexcept {
+#ifdef MATH_USE_SSE
+	static const __m128 kSignMask = _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(0x80000000)));
+	static const __m128i kOne = _mm_set1_epi32(1);
+	static const __m128i kInvOne = _mm_set1_epi32(~1);
+	static const __m128i kTwo = _mm_set1_epi32(2);
+	static const __m128i kFour = _mm_set1_epi32(4);
+
+	// 4/π
+	static const __m128 kFourOverPi = _mm_set1_ps(1.27323954473516f);
+	// π/4を3つに分けたもの(範囲縮約の桁落ちを防ぐ)
+	static const __m128 kDP1 = _mm_set1_ps(0.78515625f);
+	static const __m128 kDP2 = _mm_set1_ps(2.4187564849853515625e-4f);
+	static const __m128 kDP3 = _mm_set1_ps(3.77489497744594108e-8f);
+
+	static const __m128 kSinP0 = _mm_set1_ps(-1.9515295891e-4f);
+	static const __m128 kSinP1 = _mm_set1_ps(8.3321608736e-3f);
+	static const __m128 kSinP2 = _mm_set1_ps(-1.6666654611e-1f);
+	static const __m128 kCosP0 = _mm_set1_ps(2.443315711809948e-5f);
+	static const __m128 kCosP1 = _mm_set1_ps(-1.388731625493765e-3f);
+	static const __m128 kCosP2 = _mm_set1_ps(4.166664568298827e-2f);
+	static const __m128 kHalf = _mm_set1_ps(0.5f);
+	static const __m128 kOneF = _mm_set1_ps(1.0f);
+	// これより大きいと象限の計算が32bit整数に収まらず、範囲縮約の誤差も大きくなる
+	static const __m128 kMaxRad = _mm_set1_ps(8192.0f);
+
+	__m128 signSin = _mm_and_ps(rad, kSignMask);
+	__m128 x = _mm_andnot_ps(kSignMask, rad);
+	// NaNと無限大も含める
+	const int largeMask = _mm_movemask_ps(_mm_cmpnle_ps(x, kMaxRad));
+
+	// x * 4/π を偶数に切り上げて、どの象限(π/4単位)にいるかを求める
+	__m128i quadrant = _mm_cvttps_epi32(_mm_mul_ps(x, kFourOverPi));
+	quadrant = _mm_and_si128(_mm_add_epi32(quadrant, kOne), kInvOne);
+	__m128 y = _mm_cvtepi32_ps(quadrant);
+
+	__m128 swapSignSin = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, kFour), 29));
+	__m128 signCos = _mm_castsi128_ps(_mm_slli_epi32(_mm_andnot_si128(_mm_sub_epi32(quadrant, kTwo), kFour), 29));
+	// sinとcosの多項式を入れ替えるか
+	__m128 polyMask = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, kTwo), _mm_setzero_si128()));
+
+	signSin = _mm_xor_ps(signSin, swapSignSin);
+
+	// x - y * π/4
+	x = _mm_sub_ps(x, _mm_mul_ps(y, kDP1));
+	x = _mm_sub_ps(x, _mm_mul_ps(y, kDP2));
+	x = _mm_sub_ps(x, _mm_mul_ps(y, kDP3));
+
+	__m128 z = _mm_mul_ps(x, x);
+
+	// cos(x) ≒ 1 - z/2 + z^2 * (P2 + z * (P1 + z * P0))
+	__m128 cosPoly = _mm_add_ps(_mm_mul_ps(kCosP0, z), kCosP1);
+	cosPoly = _mm_add_ps(_mm_mul_ps(cosPoly, z), kCosP2);
+	cosPoly = _mm_mul_ps(_mm_mul_ps(cosPoly, z), z);
+	cosPoly = _mm_sub_ps(cosPoly, _mm_mul_ps(z, kHalf));
+	cosPoly = _mm_add_ps(cosPoly, kOneF);
+
+	// sin(x) ≒ x + x * z * (P2 + z * (P1 + z * P0))
+	__m128 sinPoly = _mm_add_ps(_mm_mul_ps(kSinP0, z), kSinP1);
+	sinPoly = _mm_add_ps(_mm_mul_ps(sinPoly, z), kSinP2);
+	sinPoly = _mm_mul_ps(_mm_mul_ps(sinPoly, z), x);
+	sinPoly = _mm_add_ps(sinPoly, x);
+
+	__m128 sinResult = _mm_or_ps(_mm_and_ps(polyMask, sinPoly), _mm_andnot_ps(polyMask, cosPoly));
+	__m128 cosResult = _mm_or_ps(_mm_and_ps(polyMask, cosPoly), _mm_andnot_ps(polyMask, sinPoly));
+
+	sinOut = _mm_xor_ps(sinResult, signSin);
+	cosOut = _mm_xor_ps(cosResult, signCos);
+
+	// 大きい角度のレーンだけstd::sin/std::cosで計算し直す
+	if (largeMask != 0) {
+		alignas(16) std::array<float, 4> radArray;
+		alignas(16) std::array<float, 4> sinArray;
+		alignas(16) std::array<float, 4> cosArray;
+		_mm_store_ps(radArray.data(), rad);
+		_mm_store_ps(sinArray.data(), sinOut);
+		_mm_store_ps(cosArray.data(), cosOut);
+		for (size_t i = 0; i < radArray.size(); i++) {
+			if (largeMask & (1 << i)) {
+				sinArray[i] = std::sin(radArray[i]);
+				cosArray[i] = std::cos(radArray[i]);
+			}
+		}
+		sinOut = _mm_load_ps(sinArray.data());
+		cosOut = _mm_load_ps(cosArray.data());
+	}
+#else
+	alignas(16) std::array<float, 4> radArray;
+	alignas(16) std::array<float, 4> sinArray;
+	alignas(16) std::array<float, 4> cosArray;
+	_mm_store_ps(radArray.data(), rad);
+	for (size_t i = 0; i < radArray.size(); i++) {
+		sinArray[i] = std::sin(radArray[i]);
+		cosArray[i] = std::cos(radArray[i]);
+	}
+	sinOut = _mm_load_ps(sinArray.data());
+	cosOut = _mm_load_ps(cosArray.data());
+#endif
+}
+
+void SinCos(float rad, float& sinOut, float& cosOut) noexcept {
+#ifdef MATH_USE_SSE
+	__m128 sinVec;
+	__m128 cosVec;
+	SinCos4(_mm_set_ss(rad), sinVec, cosVec);
+	sinOut = _mm_cvtss_f32(sinVec);
+	cosOut = _mm_cvtss_f32(cosVec);
+#else
+	sinOut = std::sin(rad);
+	cosOut = std::cos(rad);
+#endif
+}
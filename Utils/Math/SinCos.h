@@ -0,0 +1,23 @@
+#pragma once
+#include <immintrin.h>
+#include "Vector4.h"
+
+/// <summary>
+/// 4つの角度のsinとcosを同時に計算する(Cephesのsinf/cosfと同じ範囲縮約と多項式近似)
+/// |rad| <= 8192.0f の範囲でstd::sin/std::cosとの差は最大2ULP(結果の絶対値が2^-10以上のとき)
+/// 零点付近(sin(nπ)など)は絶対誤差で最大8.0e-8
+/// |rad| > 8192.0f(NaNと無限大も含む)のレーンはstd::sin/std::cosで計算する
+/// MATH_NO_SIMDが定義されている場合はstd::sin/std::cosを使う
+/// </summary>
+/// <param name="rad">角度(ラジアン)</param>
+/// <param name="sinOut">sin(rad)</param>
+/// <param name="cosOut">cos(rad)</param>
+void SinCos4(__m128 rad, __m128& sinOut, __m128& cosOut) noexcept;
+
+/// <summary>
+/// SinCos4の1つ分
+/// </summary>
+/// <param name="rad">角度(ラジアン)</param>
+/// <param name="sinOut">sin(rad)</param>
+/// <param name="cosOut">cos(rad)</param>
+void SinCos(float rad, float& sinOut, float& cosOut) noexcept;
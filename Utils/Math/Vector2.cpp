@@ -3,23 +3,6 @@
 #include <cmath>
 #include <numbers>
 
-Vector2::Vector2() noexcept :
-	x(0.0f),
-	y(0.0f)
-{}
-
-Vector2::Vector2(const Vector2& right) noexcept {
-	*this = right;
-}
-Vector2::Vector2(float x, float y) noexcept :
-	x(x),
-	y(y)
-{}
-
-Vector2::Vector2(Vector2&& right) noexcept {
-	*this = std::move(right);
-}
-
 const Vector2 Vector2::identity = { 1.0f,1.0f };
 const Vector2 Vector2::zero = {0.0f, 0.0f};
 const Vector2 Vector2::xIdy = { 1.0f,0.0f };
@@ -61,21 +44,6 @@ Vector2 Vector2::operator/(float scalar) const noexcept {
 	return result;
 }
 
-Vector2& Vector2::operator=(const Vector2& right) noexcept {
-	this->x = right.x;
-	this->y = right.y;
-
-	return *this;
-}
-
-Vector2& Vector2::operator=(Vector2&& right) noexcept {
-	this->x = std::move(right.x);
-	this->y = std::move(right.y);
-
-	return *this;
-}
-
-
 Vector2& Vector2::operator+=(const Vector2& right) noexcept {
 	this->x += right.x;
 	this->y += right.y;
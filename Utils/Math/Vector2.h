@@ -1,15 +1,22 @@
 #pragma once
+#include <type_traits>
 
 class Vector2 final {
 /// <summary>
 /// コンストラクタ
 /// </summary>
 public:
-	Vector2() noexcept;
-	Vector2(float x, float y) noexcept;
+	constexpr Vector2() noexcept :
+		x(0.0f),
+		y(0.0f)
+	{}
+	constexpr Vector2(float x, float y) noexcept :
+		x(x),
+		y(y)
+	{}
 
-	Vector2(const Vector2& right) noexcept;
-	Vector2(Vector2&& right) noexcept;
+	constexpr Vector2(const Vector2& right) noexcept = default;
+	constexpr Vector2(Vector2&& right) noexcept = default;
 public:
 	~Vector2() = default;
 
@@ -21,8 +28,8 @@ public:
 	Vector2 operator-(const Vector2& right) const noexcept;
 	Vector2 operator*(float scalar) const noexcept;
 	Vector2 operator/(float scalar) const noexcept;
-	Vector2& operator=(const Vector2& right) noexcept;
-	Vector2& operator=(Vector2&& right) noexcept;
+	constexpr Vector2& operator=(const Vector2& right) noexcept = default;
+	constexpr Vector2& operator=(Vector2&& right) noexcept = default;
 	Vector2& operator+=(const Vector2& right) noexcept;
 	Vector2& operator-=(const Vector2& right) noexcept;
 	Vector2& operator*=(float scalar) noexcept;
@@ -71,4 +78,7 @@ public:
 public:
 	float x;
 	float y;
-};
\ No newline at end of file
+};
+
+static_assert(std::is_trivially_copyable_v<Vector2>, "Vector2 must be trivially copyable");
+static_assert(sizeof(Vector2) == sizeof(float) * 2, "Vector2 must not have padding");
\ No newline at end of file
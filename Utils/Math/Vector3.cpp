@@ -5,33 +5,12 @@
 #include <cassert>
 #include "Engine/ErrorCheck/ErrorCheck.h"
 
-Vector3::Vector3() noexcept :
-	x(0.0f),
-	y(0.0f),
-	z(0.0f)
-{}
-
-Vector3::Vector3(float x, float y, float z) noexcept :
-	x(x),
-	y(y),
-	z(z)
-{}
-
-Vector3::Vector3(const Vector3& right) noexcept
-{
-	*this = right;
-}
 Vector3::Vector3(const Vector2& right) noexcept {
 	x = right.x;
 	y = right.y;
 	z = 0.0f;
 }
 
-Vector3::Vector3(Vector3&& right) noexcept
-{
-	*this = std::move(right);
-}
-
 const Vector3 Vector3::identity = { 1.0f,1.0f,1.0f };
 const Vector3 Vector3::zero = { 0.0f, 0.0f,0.0f };
 const Vector3 Vector3::xIdy = { 1.0f,0.0f,0.0f };
@@ -45,22 +24,6 @@ Vector3 Vector3::operator-() const noexcept {
 	return Vector3(-x, -y, -z);
 }
 
-Vector3& Vector3::operator=(const Vector3& right) noexcept {
-	x = right.x;
-	y = right.y;
-	z = right.z;
-
-	return *this;
-}
-
-Vector3& Vector3::operator=(Vector3&& right) noexcept {
-	x = std::move(right.x);
-	y = std::move(right.y);
-	z = std::move(right.z);
-
-	return *this;
-}
-
 Vector3 Vector3::operator+(const Vector3& right) const noexcept {
 	Vector3 tmp(x + right.x, y + right.y, z + right.z);
 
@@ -106,11 +69,25 @@ Vector3& Vector3::operator/=(float scalar) noexcept {
 
 Vector3 Vector3::operator*(const Mat4x4& mat) const noexcept {
 	Vector3 result;
-	Vector4 vec = { *this,1.0f };
+#if defined(MATH_USE_SSE)
+	// スカラー版と同じ順番で足していく
+	__m128 r = _mm_mul_ps(_mm_set1_ps(x), mat[0].m128);
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(y), mat[1].m128));
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(z), mat[2].m128));
+	r = _mm_add_ps(r, mat[3].m128);
+
+	alignas(16) std::array<float, 4> tmp;
+	_mm_store_ps(tmp.data(), r);
+	result.x = tmp[0];
+	result.y = tmp[1];
+	result.z = tmp[2];
+	float w = tmp[3];
+#else
 	result.x = x * mat[0][0] + y * mat[1][0] + z * mat[2][0] + 1.0f * mat[3][0];
 	result.y = x * mat[0][1] + y * mat[1][1] + z * mat[2][1] + 1.0f * mat[3][1];
 	result.z = x * mat[0][2] + y * mat[1][2] + z * mat[2][2] + 1.0f * mat[3][2];
 	float&& w = x * mat[0][3] + y * mat[1][3] + z * mat[2][3] + 1.0f * mat[3][3];
+#endif
 	assert(w != 0.0f);
 	if (w == 0.0f) {
 		ErrorCheck::GetInstance()->ErrorTextBox("Vector3 * Matrix4x4 : w = 0.0f", "Vector3");
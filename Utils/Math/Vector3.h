@@ -1,16 +1,25 @@
 #pragma once
 #include <string>
+#include <type_traits>
 
 class Vector3 final {
 /// <summary>
 /// コンストラクタ
 /// </summary>
 public:
-	Vector3() noexcept;
-	Vector3(float x, float y, float z) noexcept;
-	Vector3(const Vector3& right) noexcept;
+	constexpr Vector3() noexcept :
+		x(0.0f),
+		y(0.0f),
+		z(0.0f)
+	{}
+	constexpr Vector3(float x, float y, float z) noexcept :
+		x(x),
+		y(y),
+		z(z)
+	{}
+	constexpr Vector3(const Vector3& right) noexcept = default;
 	Vector3(const class Vector2& right) noexcept;
-	Vector3(Vector3&& right) noexcept;
+	constexpr Vector3(Vector3&& right) noexcept = default;
 public:
 	~Vector3() = default;
 
@@ -25,8 +34,8 @@ public:
 
 	// 二項演算子
 
-	Vector3& operator=(const Vector3& right) noexcept;
-	Vector3& operator=(Vector3&& right) noexcept;
+	constexpr Vector3& operator=(const Vector3& right) noexcept = default;
+	constexpr Vector3& operator=(Vector3&& right) noexcept = default;
 	Vector3 operator+(const Vector3& right) const noexcept;
 	Vector3 operator-(const Vector3& right) const noexcept;
 	Vector3& operator+=(const Vector3& right) noexcept;
@@ -90,4 +99,7 @@ public:
 	float x;
 	float y;
 	float z;
-};
\ No newline at end of file
+};
+
+static_assert(std::is_trivially_copyable_v<Vector3>, "Vector3 must be trivially copyable");
+static_assert(sizeof(Vector3) == sizeof(float) * 3, "Vector3 must not have padding");
\ No newline at end of file
@@ -0,0 +1,221 @@
+#include "Vector3Stream.h"
+#include "Vector3StreamAvx2.h"
+#include "Mat4x4.h"
+#include <cassert>
+#include <algorithm>
+#include <array>
+#include "Engine/ErrorCheck/ErrorCheck.h"
+
+#if defined(MATH_USE_SSE)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+	/// <summary>
+	/// CPUとOSがAVX2を使えるか(エンジンはAVX2無しでビルドするので、実行時に調べてTransformPointsAvx2()を使う)
+	/// </summary>
+	bool IsAvx2Supported() noexcept {
+#if defined(_MSC_VER)
+		std::array<int, 4> info{};
+		__cpuid(info.data(), 0);
+		if (info[0] < 7) {
+			return false;
+		}
+
+		// AVXがあり、OSがYMMレジスタを保存する(OSXSAVEがあり、XCR0のSSEとAVXの状態が有効)
+		constexpr int kOsxsaveBit = 1 << 27;
+		constexpr int kAvxBit = 1 << 28;
+		__cpuid(info.data(), 1);
+		if ((info[2] & (kOsxsaveBit | kAvxBit)) != (kOsxsaveBit | kAvxBit) || (_xgetbv(0) & 0x6) != 0x6) {
+			return false;
+		}
+
+		constexpr int kAvx2Bit = 1 << 5;
+		__cpuidex(info.data(), 7, 0);
+		return (info[1] & kAvx2Bit) != 0;
+#else
+		// OSがYMMレジスタを保存するかも含めて調べる
+		return __builtin_cpu_supports("avx2");
+#endif
+	}
+}
+#endif
+
+Vector3Stream::Vector3Stream(size_t size) :
+	x(size),
+	y(size),
+	z(size)
+{}
+
+Vector3Stream::Vector3Stream(std::span<const Vector3> points) :
+	x(points.size()),
+	y(points.size()),
+	z(points.size())
+{
+	for (size_t i = 0; i < points.size(); i++) {
+		x[i] = points[i].x;
+		y[i] = points[i].y;
+		z[i] = points[i].z;
+	}
+}
+
+void Vector3Stream::Resize(size_t size) {
+	x.resize(size);
+	y.resize(size);
+	z.resize(size);
+}
+
+void Vector3Stream::Reserve(size_t size) {
+	x.reserve(size);
+	y.reserve(size);
+	z.reserve(size);
+}
+
+void Vector3Stream::Clear() {
+	x.clear();
+	y.clear();
+	z.clear();
+}
+
+void Vector3Stream::PushBack(const Vector3& point) {
+	x.push_back(point.x);
+	y.push_back(point.y);
+	z.push_back(point.z);
+}
+
+void Vector3Stream::Set(size_t index, const Vector3& point) {
+	x[index] = point.x;
+	y[index] = point.y;
+	z[index] = point.z;
+}
+
+Vector3 Vector3Stream::Get(size_t index) const {
+	return Vector3(x[index], y[index], z[index]);
+}
+
+void Vector3Stream::CopyTo(std::span<Vector3> points) const {
+	assert(points.size() >= Size());
+
+	for (size_t i = 0; i < Size(); i++) {
+		points[i] = Vector3(x[i], y[i], z[i]);
+	}
+}
+
+
+void TransformPoints(const Mat4x4& mat, std::span<const Vector3> src, std::span<Vector3> dst) {
+	assert(dst.size() >= src.size());
+
+	bool isWZero = false;
+
+#if defined(MATH_USE_SSE)
+	const __m128 row0 = mat[0].m128;
+	const __m128 row1 = mat[1].m128;
+	const __m128 row2 = mat[2].m128;
+	const __m128 row3 = mat[3].m128;
+
+	alignas(16) std::array<float, 4> tmp;
+
+	for (size_t i = 0; i < src.size(); i++) {
+		// Vector3 * Mat4x4と同じ順番で足していく
+		__m128 r = _mm_mul_ps(_mm_set1_ps(src[i].x), row0);
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(src[i].y), row1));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(src[i].z), row2));
+		r = _mm_add_ps(r, row3);
+		_mm_store_ps(tmp.data(), r);
+
+		isWZero = isWZero || tmp[3] == 0.0f;
+		float w = 1.0f / tmp[3];
+
+		dst[i].x = tmp[0] * w;
+		dst[i].y = tmp[1] * w;
+		dst[i].z = tmp[2] * w;
+	}
+#else
+	for (size_t i = 0; i < src.size(); i++) {
+		dst[i] = src[i] * mat;
+	}
+#endif
+
+	assert(!isWZero);
+	if (isWZero) {
+		ErrorCheck::GetInstance()->ErrorTextBox("TransformPoints() : w = 0.0f", "Vector3Stream");
+	}
+}
+
+void TransformPoints(const Mat4x4& mat, std::span<const Vector4> src, std::span<Vector4> dst) {
+	assert(dst.size() >= src.size());
+
+#if defined(MATH_USE_SSE)
+	const __m128 row0 = mat[0].m128;
+	const __m128 row1 = mat[1].m128;
+	const __m128 row2 = mat[2].m128;
+	const __m128 row3 = mat[3].m128;
+
+	for (size_t i = 0; i < src.size(); i++) {
+		const __m128 v = src[i].m128;
+
+		// Vector4 * Mat4x4と同じく0から順番に足していく
+		__m128 r = _mm_setzero_ps();
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(v, v, 0x00), row0));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(v, v, 0x55), row1));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(v, v, 0xaa), row2));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(v, v, 0xff), row3));
+
+		dst[i].m128 = r;
+	}
+#else
+	for (size_t i = 0; i < src.size(); i++) {
+		dst[i] = src[i] * mat;
+	}
+#endif
+}
+
+void TransformPoints(const Mat4x4& mat, const Vector3Stream& src, Vector3Stream& dst) {
+	const size_t size = src.Size();
+	if (dst.Size() != size) {
+		dst.Resize(size);
+	}
+
+	const float* srcX = src.x.data();
+	const float* srcY = src.y.data();
+	const float* srcZ = src.z.data();
+	float* dstX = dst.x.data();
+	float* dstY = dst.y.data();
+	float* dstZ = dst.z.data();
+
+	bool isWZero = false;
+	size_t i = 0;
+
+#if defined(MATH_USE_SSE)
+	// AVX2が使えるCPUなら8個ずつ処理する
+	static const bool isAvx2Supported = IsAvx2Supported();
+	if (isAvx2Supported) {
+		i = TransformPointsAvx2(&mat[0][0], srcX, srcY, srcZ, dstX, dstY, dstZ, size, isWZero);
+	}
+#endif
+
+	// 残り
+	for (; i < size; i++) {
+		const float x = srcX[i];
+		const float y = srcY[i];
+		const float z = srcZ[i];
+
+		float rx = x * mat[0][0] + y * mat[1][0] + z * mat[2][0] + mat[3][0];
+		float ry = x * mat[0][1] + y * mat[1][1] + z * mat[2][1] + mat[3][1];
+		float rz = x * mat[0][2] + y * mat[1][2] + z * mat[2][2] + mat[3][2];
+		float rw = x * mat[0][3] + y * mat[1][3] + z * mat[2][3] + mat[3][3];
+
+		isWZero = isWZero || rw == 0.0f;
+		rw = 1.0f / rw;
+
+		dstX[i] = rx * rw;
+		dstY[i] = ry * rw;
+		dstZ[i] = rz * rw;
+	}
+
+	assert(!isWZero);
+	if (isWZero) {
+		ErrorCheck::GetInstance()->ErrorTextBox("TransformPoints() : w = 0.0f", "Vector3Stream");
+	}
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <vector>
+#include <span>
+#include "Vector3.h"
+#include "Vector4.h"
+
+class Mat4x4;
+
+/// <summary>
+/// Vector3をSoA(x,y,zを別々の配列)で持つコンテナ
+/// 大量の座標をまとめて変換するときに使う(AVX2が使えるCPUでは8個ずつ処理する)
+/// </summary>
+class Vector3Stream final {
+public:
+	Vector3Stream() = default;
+	explicit Vector3Stream(size_t size);
+	explicit Vector3Stream(std::span<const Vector3> points);
+	Vector3Stream(const Vector3Stream&) = default;
+	Vector3Stream(Vector3Stream&&) noexcept = default;
+	~Vector3Stream() = default;
+
+public:
+	Vector3Stream& operator=(const Vector3Stream&) = default;
+	Vector3Stream& operator=(Vector3Stream&&) noexcept = default;
+
+public:
+	void Resize(size_t size);
+	void Reserve(size_t size);
+	void Clear();
+
+	void PushBack(const Vector3& point);
+
+	void Set(size_t index, const Vector3& point);
+	Vector3 Get(size_t index) const;
+
+	/// <summary>
+	/// AoSに書き出す
+	/// </summary>
+	void CopyTo(std::span<Vector3> points) const;
+
+	inline size_t Size() const noexcept {
+		return x.size();
+	}
+
+	inline bool Empty() const noexcept {
+		return x.empty();
+	}
+
+public:
+	std::vector<float> x;
+	std::vector<float> y;
+	std::vector<float> z;
+};
+
+/// <summary>
+/// 座標をまとめて行列で変換する(Vector3 * Mat4x4と同じ結果になる)
+/// </summary>
+/// <param name="mat">変換行列</param>
+/// <param name="src">変換前の座標</param>
+/// <param name="dst">変換後の座標(srcと同じ数。srcと同じでもよい)</param>
+void TransformPoints(const Mat4x4& mat, std::span<const Vector3> src, std::span<Vector3> dst);
+
+/// <summary>
+/// ベクトルをまとめて行列で変換する(Vector4 * Mat4x4と同じ結果になる)
+/// </summary>
+/// <param name="mat">変換行列</param>
+/// <param name="src">変換前のベクトル</param>
+/// <param name="dst">変換後のベクトル(srcと同じ数。srcと同じでもよい)</param>
+void TransformPoints(const Mat4x4& mat, std::span<const Vector4> src, std::span<Vector4> dst);
+
+/// <summary>
+/// SoAの座標をまとめて行列で変換する(Vector3 * Mat4x4と同じ結果になる)
+/// </summary>
+/// <param name="mat">変換行列</param>
+/// <param name="src">変換前の座標</param>
+/// <param name="dst">変換後の座標(srcと同じでもよい)</param>
+void TransformPoints(const Mat4x4& mat, const Vector3Stream& src, Vector3Stream& dst);
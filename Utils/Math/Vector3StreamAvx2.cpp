@@ -0,0 +1,55 @@
+#include "Vector3StreamAvx2.h"
+#include <immintrin.h>
+
+#if defined(__AVX2__)
+size_t TransformPointsAvx2(
+	const float* mat,
+	const float* srcX, const float* srcY, const float* srcZ,
+	float* dstX, float* dstY, float* dstZ,
+	size_t size,
+	bool& isWZero
+) noexcept {
+	const __m256 m00 = _mm256_set1_ps(mat[0]), m01 = _mm256_set1_ps(mat[1]), m02 = _mm256_set1_ps(mat[2]), m03 = _mm256_set1_ps(mat[3]);
+	const __m256 m10 = _mm256_set1_ps(mat[4]), m11 = _mm256_set1_ps(mat[5]), m12 = _mm256_set1_ps(mat[6]), m13 = _mm256_set1_ps(mat[7]);
+	const __m256 m20 = _mm256_set1_ps(mat[8]), m21 = _mm256_set1_ps(mat[9]), m22 = _mm256_set1_ps(mat[10]), m23 = _mm256_set1_ps(mat[11]);
+	const __m256 m30 = _mm256_set1_ps(mat[12]), m31 = _mm256_set1_ps(mat[13]), m32 = _mm256_set1_ps(mat[14]), m33 = _mm256_set1_ps(mat[15]);
+	const __m256 one = _mm256_set1_ps(1.0f);
+	const __m256 zero = _mm256_setzero_ps();
+
+	// 8個ずつ処理する(Vector3 * Mat4x4と同じ順番で足していく)
+	size_t i = 0;
+	for (; i + 8 <= size; i += 8) {
+		const __m256 x = _mm256_loadu_ps(srcX + i);
+		const __m256 y = _mm256_loadu_ps(srcY + i);
+		const __m256 z = _mm256_loadu_ps(srcZ + i);
+
+		__m256 rx = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, m00), _mm256_mul_ps(y, m10)), _mm256_mul_ps(z, m20)), m30);
+		__m256 ry = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, m01), _mm256_mul_ps(y, m11)), _mm256_mul_ps(z, m21)), m31);
+		__m256 rz = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, m02), _mm256_mul_ps(y, m12)), _mm256_mul_ps(z, m22)), m32);
+		__m256 rw = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, m03), _mm256_mul_ps(y, m13)), _mm256_mul_ps(z, m23)), m33);
+
+		isWZero = isWZero || _mm256_movemask_ps(_mm256_cmp_ps(rw, zero, _CMP_EQ_OQ)) != 0;
+		rw = _mm256_div_ps(one, rw);
+
+		_mm256_storeu_ps(dstX + i, _mm256_mul_ps(rx, rw));
+		_mm256_storeu_ps(dstY + i, _mm256_mul_ps(ry, rw));
+		_mm256_storeu_ps(dstZ + i, _mm256_mul_ps(rz, rw));
+	}
+
+	// AVXの上位128ビットを使った後は、SSEに戻る前に消しておく
+	_mm256_zeroupper();
+
+	return i;
+}
+#else
+size_t TransformPointsAvx2(
+	const float*,
+	const float*, const float*, const float*,
+	float*, float*, float*,
+	size_t,
+	bool&
+) noexcept {
+	// AVX2でビルドしていないので、全て呼び出し側で変換する
+	return 0;
+}
+#endif
@@ -0,0 +1,19 @@
+#pragma once
+#include <cstddef>
+
+/// <summary>
+/// SoAの座標をまとめて行列で変換するAVX2版(Vector3Stream.cppが、AVX2が使えるCPUの時だけ呼ぶ)
+/// これだけをAVX2でビルドする。Vector4.hなどのインライン関数をAVX2でビルドすると、
+/// リンカーがそれを他のファイルからの呼び出しにも使うことがあるので、floatの配列だけを受け取る
+/// </summary>
+/// <param name="mat">変換行列(Mat4x4と同じ並びの16個)</param>
+/// <param name="size">座標の数</param>
+/// <param name="isWZero">wが0になったらtrueにする</param>
+/// <returns>変換した数(8の倍数で、残りは呼び出し側で変換する。AVX2でビルドしていなければ0)</returns>
+size_t TransformPointsAvx2(
+	const float* mat,
+	const float* srcX, const float* srcY, const float* srcZ,
+	float* dstX, float* dstY, float* dstZ,
+	size_t size,
+	bool& isWZero
+) noexcept;
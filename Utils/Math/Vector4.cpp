@@ -5,22 +5,6 @@
 #include <cmath>
 #include <limits>
 
-Vector4::Vector4() noexcept :
-	m{0.0f}
-{}
-
-Vector4::Vector4(const Vector4& right) noexcept 
-{
-	*this = right;
-}
-Vector4::Vector4(Vector4&& right)  noexcept :
-	m(std::move(right.m))
-{}
-
-Vector4::Vector4(float x, float y, float z, float w) noexcept :
-	m{x,y,z,w}
-{}
-
 Vector4::Vector4(const Vector3& vec3, float w) noexcept :
 	m{vec3.x,vec3.y,vec3.z,w }
 {}
@@ -29,12 +13,6 @@ Vector4::Vector4(const Vector2& vec2, float z, float w) noexcept :
 	m{ vec2.x,vec2.y,z,w }
 {}
 
-Vector4& Vector4::operator=(const Vector4& right) noexcept {
-	std::copy(right.m.begin(), right.m.end(), m.begin());
-
-	return *this;
-}
-
 Vector4& Vector4::operator=(const Vector3& right) noexcept {
 	vec.x = right.x;
 	vec.y = right.y;
@@ -53,12 +31,6 @@ Vector4& Vector4::operator=(const Vector2& right) noexcept {
 	return *this;
 }
 
-Vector4& Vector4::operator=(Vector4&& right) noexcept {
-	m = std::move(right.m);
-
-	return *this;
-}
-
 Vector4 Vector4::operator+(const Vector4& right) const noexcept {
 	Vector4 result;
 
@@ -125,12 +97,21 @@ Vector4& Vector4::operator/=(float scalar) noexcept {
 Vector4 Vector4::operator*(const Mat4x4& mat) const noexcept {
 	Vector4 result;
 
-	auto tmp = mat;
-	tmp.Transepose();
-
-	for (int32_t i = 0; i < m.size(); i++) {
-		result.m[i] = Dot(tmp[i]);
+#if defined(MATH_USE_SSE)
+	// スカラー版と同じく0から順番に足していく
+	__m128 r = _mm_setzero_ps();
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(m128, m128, 0x00), mat[0].m128));
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(m128, m128, 0x55), mat[1].m128));
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(m128, m128, 0xaa), mat[2].m128));
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(m128, m128, 0xff), mat[3].m128));
+	result.m128 = r;
+#else
+	for (size_t x = 0; x < m.size(); x++) {
+		for (size_t i = 0; i < m.size(); i++) {
+			result.m[x] += m[i] * mat[i][x];
+		}
 	}
+#endif
 
 	return result;
 }
@@ -144,9 +125,28 @@ Vector4& Vector4::operator*=(const Mat4x4& mat) noexcept {
 Vector4 operator*(const Mat4x4& left, const Vector4& right) noexcept {
 	Vector4 result;
 
-	for (int32_t y = 0; y < 4; y++) {
-		result.m[y] = left[y].Dot(right);
+#if defined(MATH_USE_SSE)
+	// 転置して列ごとに掛けて足す(スカラー版と同じく0から順番に足していく)
+	__m128 c0 = left[0].m128;
+	__m128 c1 = left[1].m128;
+	__m128 c2 = left[2].m128;
+	__m128 c3 = left[3].m128;
+	_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+	const __m128 v = right.m128;
+	__m128 r = _mm_setzero_ps();
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(v, v, 0x00), c0));
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(v, v, 0x55), c1));
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(v, v, 0xaa), c2));
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(v, v, 0xff), c3));
+	result.m128 = r;
+#else
+	for (size_t y = 0; y < result.m.size(); y++) {
+		for (size_t i = 0; i < result.m.size(); i++) {
+			result.m[y] += left[y][i] * right.m[i];
+		}
 	}
+#endif
 
 	return result;
 }
@@ -158,14 +158,6 @@ bool Vector4::operator!=(const Vector4& right) const noexcept {
 	return m != right.m;
 }
 
-float& Vector4::operator[](size_t index) noexcept {
-	return m[index];
-}
-
-const float& Vector4::operator[](size_t index) const noexcept {
-	return m[index];
-}
-
 float Vector4::Length() const noexcept {
 	return std::sqrt(Dot(*this));
 }
@@ -181,7 +173,16 @@ Vector4 Vector4::Normalize() const noexcept {
 }
 
 float Vector4::Dot(const Vector4& right) const noexcept {
-	return _mm_cvtss_f32(_mm_dp_ps(m128, right.m128, 0xff));
+#ifdef MATH_USE_SSE
+	// _mm_dp_psはSSE4.1なので、SSE2のシャッフルと加算で足す
+	__m128 sum = _mm_mul_ps(m128, right.m128);
+	sum = _mm_add_ps(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(2, 3, 0, 1)));
+	sum = _mm_add_ps(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 0, 3, 2)));
+	return _mm_cvtss_f32(sum);
+#else
+	// SSE版と同じく(x + y) + (z + w)の順に足す
+	return (m[0] * right.m[0] + m[1] * right.m[1]) + (m[2] * right.m[2] + m[3] * right.m[3]);
+#endif
 }
 
 Vector3 Vector4::GetVector3() const noexcept {
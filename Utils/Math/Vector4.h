@@ -1,16 +1,31 @@
 #pragma once
 #include <array>
+#include <type_traits>
+#include <cstdint>
 #include <immintrin.h>
 
+// ベクトル、行列演算で使用するSIMD命令セット(コンパイル時に選択)
+// MATH_NO_SIMDを定義するとスカラー実装になる(演算順序を揃えているので結果はビット単位で一致する)
+#if !defined(MATH_NO_SIMD)
+#define MATH_USE_SSE
+#if defined(__AVX__)
+#define MATH_USE_AVX
+#endif
+#endif
+
 class Vector4 final {
 	/// <summary>
 	/// コンストラクタ
 	/// </summary>
 public:
-	Vector4() noexcept;
-	Vector4(const Vector4& right) noexcept;
-	Vector4(Vector4&& right) noexcept;
-	Vector4(float x, float y, float z, float w) noexcept;
+	constexpr Vector4() noexcept :
+		m{ 0.0f }
+	{}
+	constexpr Vector4(const Vector4& right) noexcept = default;
+	constexpr Vector4(Vector4&& right) noexcept = default;
+	constexpr Vector4(float x, float y, float z, float w) noexcept :
+		m{ x,y,z,w }
+	{}
 	Vector4(const class Vector3& vec3, float w) noexcept;
 	Vector4(const class Vector2& vec2, float z, float w) noexcept;
 public:
@@ -20,10 +35,10 @@ public:
 	/// 演算子のオーバーロード
 	/// </summary>
 public:
-	Vector4& operator=(const Vector4& right) noexcept;
+	constexpr Vector4& operator=(const Vector4& right) noexcept = default;
 	Vector4& operator=(const class Vector3& right) noexcept;
 	Vector4& operator=(const class Vector2& right) noexcept;
-	Vector4& operator=(Vector4&& right) noexcept;
+	constexpr Vector4& operator=(Vector4&& right) noexcept = default;
 
 	Vector4 operator+(const Vector4& right) const noexcept;
 	Vector4& operator+=(const Vector4& right) noexcept;
@@ -43,8 +58,12 @@ public:
 	bool operator==(const Vector4& right) const noexcept;
 	bool operator!=(const Vector4& right) const noexcept;
 
-	float& operator[](size_t index) noexcept;
-	const float& operator[](size_t index) const noexcept;
+	constexpr float& operator[](size_t index) noexcept {
+		return m[index];
+	}
+	constexpr const float& operator[](size_t index) const noexcept {
+		return m[index];
+	}
 
 	/// <summary>
 	/// メンバ関数
@@ -82,6 +101,9 @@ public:
 
 };
 
+static_assert(std::is_trivially_copyable_v<Vector4>, "Vector4 must be trivially copyable");
+static_assert(sizeof(Vector4) == sizeof(float) * 4 && alignof(Vector4) == alignof(__m128), "Vector4 must have the same layout as __m128");
+
 /// <summary>
 /// uint32_tからVector4への変換
 /// </summary>
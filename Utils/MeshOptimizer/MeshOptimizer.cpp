@@ -0,0 +1,338 @@
+#include "MeshOptimizer.h"
+#include "Engine/ErrorCheck/ErrorCheck.h"
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <cassert>
+#include <limits>
+
+namespace {
+	// Forsythの頂点スコアの定数(論文と同じ値)
+	constexpr uint32_t kForsythCacheSize = 32;
+	constexpr float kCacheDecayPower = 1.5f;
+	constexpr float kLastTriScore = 0.75f;
+	constexpr float kValenceBoostScale = 2.0f;
+	constexpr float kValenceBoostPower = 0.5f;
+
+	// クラスタ分けに使うキャッシュの大きさ
+	constexpr uint32_t kOverdrawCacheSize = 16;
+
+	constexpr uint32_t kInvalidIndex = std::numeric_limits<uint32_t>::max();
+
+	float VertexScore(int32_t cachePos, uint32_t remainingTriNum) {
+		if (remainingTriNum == 0) {
+			return -1.0f;
+		}
+
+		float score = 0.0f;
+		if (0 <= cachePos) {
+			if (cachePos < 3) {
+				// 直前の三角形で使った頂点は少しだけ下げる(同じ向きの細長い帯になりにくくする)
+				score = kLastTriScore;
+			}
+			else {
+				constexpr float kScaler = 1.0f / static_cast<float>(kForsythCacheSize - 3);
+				score = std::pow(1.0f - static_cast<float>(cachePos - 3) * kScaler, kCacheDecayPower);
+			}
+		}
+
+		// 残りの三角形が少ない頂点を優先して早く使い切る
+		score += kValenceBoostScale * std::pow(static_cast<float>(remainingTriNum), -kValenceBoostPower);
+
+		return score;
+	}
+
+	bool IsValidIndices(std::span<const uint32_t> indices, size_t vertexNum, const std::string& funcName) {
+		assert(indices.size() % 3 == 0);
+		if (indices.size() % 3 != 0) {
+			ErrorCheck::GetInstance()->ErrorTextBox(funcName + "() : indices is not a triangle list", "MeshOptimizer");
+			return false;
+		}
+		if (std::any_of(indices.begin(), indices.end(), [vertexNum](uint32_t index) { return vertexNum <= index; })) {
+			ErrorCheck::GetInstance()->ErrorTextBox(funcName + "() : index out of range", "MeshOptimizer");
+			return false;
+		}
+		return true;
+	}
+}
+
+VertexCacheStatistics AnalyzeVertexCache(std::span<const uint32_t> indices, size_t vertexNum, uint32_t cacheSize) {
+	VertexCacheStatistics result;
+	if (indices.empty() || !IsValidIndices(indices, vertexNum, "AnalyzeVertexCache")) {
+		return result;
+	}
+
+	// 最後にキャッシュに入った時刻で、FIFOに残っているかを判断する
+	std::vector<uint32_t> cacheTime(vertexNum, 0u);
+	uint32_t time = cacheSize + 1;
+
+	for (auto& index : indices) {
+		if (cacheSize < time - cacheTime[index]) {
+			cacheTime[index] = time;
+			time++;
+			result.transformedNum++;
+		}
+	}
+
+	result.acmr = static_cast<float>(result.transformedNum) / static_cast<float>(indices.size() / 3);
+	result.atvr = static_cast<float>(result.transformedNum) / static_cast<float>(vertexNum);
+
+	return result;
+}
+
+void OptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexNum) {
+	if (indices.empty() || !IsValidIndices(indices, vertexNum, "OptimizeVertexCache")) {
+		return;
+	}
+
+	const size_t triNum = indices.size() / 3;
+
+	// 頂点ごとに使っている三角形のリストを作る
+	std::vector<uint32_t> remainingTriNum(vertexNum, 0u);
+	for (auto& index : indices) {
+		remainingTriNum[index]++;
+	}
+	std::vector<uint32_t> adjacencyOffset(vertexNum + 1, 0u);
+	std::inclusive_scan(remainingTriNum.begin(), remainingTriNum.end(), adjacencyOffset.begin() + 1);
+	std::vector<uint32_t> adjacency(indices.size());
+	{
+		std::vector<uint32_t> fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+		for (size_t i = 0; i < indices.size(); i++) {
+			adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+		}
+	}
+
+	std::vector<int32_t> cachePos(vertexNum, -1);
+	std::vector<float> vertexScore(vertexNum);
+	for (size_t i = 0; i < vertexNum; i++) {
+		vertexScore[i] = VertexScore(-1, remainingTriNum[i]);
+	}
+
+	std::vector<float> triScore(triNum);
+	std::vector<bool> isTriAdded(triNum, false);
+	for (size_t i = 0; i < triNum; i++) {
+		triScore[i] = vertexScore[indices[i * 3]] + vertexScore[indices[i * 3 + 1]] + vertexScore[indices[i * 3 + 2]];
+	}
+
+	uint32_t bestTri = static_cast<uint32_t>(std::distance(triScore.begin(), std::max_element(triScore.begin(), triScore.end())));
+	size_t scanCursor = 0;
+
+	std::vector<uint32_t> result;
+	result.reserve(indices.size());
+
+	std::vector<uint32_t> cache;
+	std::vector<uint32_t> newCache;
+	cache.reserve(kForsythCacheSize + 3);
+	newCache.reserve(kForsythCacheSize + 3);
+
+	for (size_t n = 0; n < triNum; n++) {
+		// キャッシュ周辺に候補が無ければ、まだ使っていない三角形を先頭から探す
+		if (bestTri == kInvalidIndex) {
+			while (isTriAdded[scanCursor]) {
+				scanCursor++;
+			}
+			bestTri = static_cast<uint32_t>(scanCursor);
+		}
+
+		isTriAdded[bestTri] = true;
+		const uint32_t* tri = &indices[bestTri * 3];
+		result.insert(result.end(), tri, tri + 3);
+
+		// 使った三角形を隣接リストから外す
+		for (size_t i = 0; i < 3; i++) {
+			uint32_t vertex = tri[i];
+			uint32_t* begin = &adjacency[adjacencyOffset[vertex]];
+			uint32_t* end = begin + remainingTriNum[vertex];
+			auto itr = std::find(begin, end, bestTri);
+			assert(itr != end);
+			std::swap(*itr, *(end - 1));
+			remainingTriNum[vertex]--;
+		}
+
+		// 今の三角形の頂点を先頭にして、残りは押し出す(LRU)
+		newCache.assign(tri, tri + 3);
+		for (auto& vertex : cache) {
+			if (vertex != tri[0] && vertex != tri[1] && vertex != tri[2]) {
+				newCache.push_back(vertex);
+			}
+		}
+
+		// キャッシュ内(と押し出された)頂点のスコアを更新して、三角形のスコアに反映する
+		for (size_t i = 0; i < newCache.size(); i++) {
+			uint32_t vertex = newCache[i];
+			int32_t pos = i < kForsythCacheSize ? static_cast<int32_t>(i) : -1;
+			cachePos[vertex] = pos;
+
+			float score = VertexScore(pos, remainingTriNum[vertex]);
+			float diff = score - vertexScore[vertex];
+			vertexScore[vertex] = score;
+
+			for (uint32_t j = 0; j < remainingTriNum[vertex]; j++) {
+				triScore[adjacency[adjacencyOffset[vertex] + j]] += diff;
+			}
+		}
+		if (kForsythCacheSize < newCache.size()) {
+			newCache.resize(kForsythCacheSize);
+		}
+		cache.swap(newCache);
+
+		// 次はキャッシュ内の頂点を使う三角形の中で一番スコアが高いもの
+		bestTri = kInvalidIndex;
+		float bestScore = 0.0f;
+		for (auto& vertex : cache) {
+			for (uint32_t j = 0; j < remainingTriNum[vertex]; j++) {
+				uint32_t triangle = adjacency[adjacencyOffset[vertex] + j];
+				if (bestScore < triScore[triangle]) {
+					bestScore = triScore[triangle];
+					bestTri = triangle;
+				}
+			}
+		}
+	}
+
+	indices.swap(result);
+}
+
+void OptimizeOverdraw(std::vector<uint32_t>& indices, std::span<const Vector3> positions, float threshold) {
+	if (indices.empty() || !IsValidIndices(indices, positions.size(), "OptimizeOverdraw")) {
+		return;
+	}
+
+	const size_t triNum = indices.size() / 3;
+
+	// 三角形ごとのキャッシュミス数
+	std::vector<uint32_t> cacheTime(positions.size(), 0u);
+	uint32_t time = kOverdrawCacheSize + 1;
+	auto countMiss = [&](size_t triangle) {
+		uint32_t miss = 0;
+		for (size_t i = 0; i < 3; i++) {
+			uint32_t index = indices[triangle * 3 + i];
+			if (kOverdrawCacheSize < time - cacheTime[index]) {
+				cacheTime[index] = time;
+				time++;
+				miss++;
+			}
+		}
+		return miss;
+	};
+	auto flushCache = [&]() {
+		time += kOverdrawCacheSize + 1;
+	};
+
+	// 3頂点とも新しい三角形はキャッシュが途切れているので、そこで必ず区切る
+	std::vector<uint32_t> hardBoundary;
+	std::vector<uint32_t> missNum(triNum);
+	for (size_t i = 0; i < triNum; i++) {
+		missNum[i] = countMiss(i);
+		if (i == 0 || missNum[i] == 3) {
+			hardBoundary.push_back(static_cast<uint32_t>(i));
+		}
+	}
+	hardBoundary.push_back(static_cast<uint32_t>(triNum));
+
+	// キャッシュを空にしてから描画してもACMRがthreshold倍以内に収まるところで細かく区切る
+	std::vector<uint32_t> clusterStart;
+	for (size_t c = 0; c + 1 < hardBoundary.size(); c++) {
+		uint32_t start = hardBoundary[c];
+		uint32_t end = hardBoundary[c + 1];
+
+		uint32_t clusterMiss = std::accumulate(missNum.begin() + start, missNum.begin() + end, 0u);
+		float clusterAcmr = static_cast<float>(clusterMiss) / static_cast<float>(end - start);
+
+		clusterStart.push_back(start);
+		flushCache();
+		uint32_t subStart = start;
+		uint32_t subMiss = 0;
+		for (uint32_t i = start; i < end; i++) {
+			subMiss += countMiss(i);
+			float subAcmr = static_cast<float>(subMiss) / static_cast<float>(i + 1 - subStart);
+			if (i + 1 < end && subAcmr <= clusterAcmr * threshold) {
+				subStart = i + 1;
+				subMiss = 0;
+				clusterStart.push_back(subStart);
+				flushCache();
+			}
+		}
+	}
+	clusterStart.push_back(static_cast<uint32_t>(triNum));
+
+	// クラスタの中心と向きを求める(面積で重み付け)
+	const size_t clusterNum = clusterStart.size() - 1;
+	std::vector<Vector3> clusterCenter(clusterNum);
+	std::vector<Vector3> clusterNormal(clusterNum);
+	Vector3 meshCenter;
+	float meshArea = 0.0f;
+	for (size_t c = 0; c < clusterNum; c++) {
+		Vector3 center;
+		Vector3 normal;
+		float area = 0.0f;
+		for (uint32_t i = clusterStart[c]; i < clusterStart[c + 1]; i++) {
+			const Vector3& p0 = positions[indices[i * 3]];
+			const Vector3& p1 = positions[indices[i * 3 + 1]];
+			const Vector3& p2 = positions[indices[i * 3 + 2]];
+
+			Vector3 cross = (p1 - p0).Cross(p2 - p0);
+			float triArea = cross.Length();
+
+			center += (p0 + p1 + p2) * (triArea / 3.0f);
+			normal += cross;
+			area += triArea;
+		}
+
+		meshCenter += center;
+		meshArea += area;
+
+		clusterCenter[c] = area == 0.0f ? Vector3() : center / area;
+		clusterNormal[c] = normal.Normalize();
+	}
+	if (meshArea != 0.0f) {
+		meshCenter /= meshArea;
+	}
+
+	// 外側を向いているクラスタほど手前に来やすいので先に描画する
+	std::vector<float> sortKey(clusterNum);
+	for (size_t c = 0; c < clusterNum; c++) {
+		sortKey[c] = (clusterCenter[c] - meshCenter).Dot(clusterNormal[c]);
+	}
+	std::vector<uint32_t> clusterOrder(clusterNum);
+	std::iota(clusterOrder.begin(), clusterOrder.end(), 0u);
+	std::stable_sort(clusterOrder.begin(), clusterOrder.end(),
+		[&sortKey](uint32_t left, uint32_t right) {
+			return sortKey[left] > sortKey[right];
+		}
+	);
+
+	std::vector<uint32_t> result;
+	result.reserve(indices.size());
+	for (auto& c : clusterOrder) {
+		result.insert(result.end(), indices.begin() + clusterStart[c] * 3, indices.begin() + clusterStart[c + 1] * 3);
+	}
+	indices.swap(result);
+}
+
+std::vector<uint32_t> OptimizeVertexFetch(std::vector<uint32_t>& indices, size_t vertexNum) {
+	std::vector<uint32_t> remap(vertexNum, kInvalidIndex);
+	if (!IsValidIndices(indices, vertexNum, "OptimizeVertexFetch")) {
+		std::iota(remap.begin(), remap.end(), 0u);
+		return remap;
+	}
+
+	uint32_t nextIndex = 0;
+	for (auto& index : indices) {
+		if (remap[index] == kInvalidIndex) {
+			remap[index] = nextIndex;
+			nextIndex++;
+		}
+		index = remap[index];
+	}
+
+	// 使われていない頂点は後ろに詰める
+	for (auto& i : remap) {
+		if (i == kInvalidIndex) {
+			i = nextIndex;
+			nextIndex++;
+		}
+	}
+
+	return remap;
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include "Utils/Math/Vector3.h"
+#include <vector>
+#include <span>
+#include <cstdint>
+
+/// <summary>
+/// 頂点キャッシュのシミュレーション結果
+/// </summary>
+struct VertexCacheStatistics {
+	/// <summary>
+	/// 頂点シェーダーが実行された回数
+	/// </summary>
+	uint32_t transformedNum = 0;
+	/// <summary>
+	/// 三角形1つあたりのキャッシュミス数(0.5～3.0、小さいほど良い)
+	/// </summary>
+	float acmr = 0.0f;
+	/// <summary>
+	/// 頂点1つあたりのキャッシュミス数(1.0が最良)
+	/// </summary>
+	float atvr = 0.0f;
+};
+
+/// <summary>
+/// FIFOの頂点キャッシュを使ったときのキャッシュミスを数える
+/// </summary>
+/// <param name="indices">三角形リストのインデックス</param>
+/// <param name="vertexNum">頂点数</param>
+/// <param name="cacheSize">キャッシュに入る頂点数</param>
+VertexCacheStatistics AnalyzeVertexCache(std::span<const uint32_t> indices, size_t vertexNum, uint32_t cacheSize = 16);
+
+/// <summary>
+/// 頂点キャッシュに乗りやすい順番に三角形を並び替える(Forsyth)
+/// </summary>
+/// <param name="indices">三角形リストのインデックス(並び替えられる)</param>
+/// <param name="vertexNum">頂点数</param>
+void OptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexNum);
+
+/// <summary>
+/// 頂点キャッシュ効率をthreshold倍まで許して三角形をクラスタに分け、外側を向いたクラスタから描画されるように並び替える
+/// OptimizeVertexCacheの後に使う
+/// </summary>
+/// <param name="indices">三角形リストのインデックス(並び替えられる)</param>
+/// <param name="positions">頂点座標</param>
+/// <param name="threshold">許容するACMRの悪化(1.05なら5%まで)</param>
+void OptimizeOverdraw(std::vector<uint32_t>& indices, std::span<const Vector3> positions, float threshold = 1.05f);
+
+/// <summary>
+/// インデックスで最初に使われた順番に頂点を並べる番号を作り、indicesを書き換える
+/// 使われていない頂点は後ろに回す
+/// </summary>
+/// <param name="indices">三角形リストのインデックス(書き換えられる)</param>
+/// <param name="vertexNum">頂点数</param>
+/// <returns>古い頂点番号から新しい頂点番号への対応</returns>
+std::vector<uint32_t> OptimizeVertexFetch(std::vector<uint32_t>& indices, size_t vertexNum);
+
+/// <summary>
+/// OptimizeVertexFetchの結果で頂点を並び替える
+/// </summary>
+/// <param name="vertices">頂点</param>
+/// <param name="remap">古い頂点番号から新しい頂点番号への対応</param>
+template<class T>
+void RemapVertices(std::vector<T>& vertices, const std::vector<uint32_t>& remap) {
+	std::vector<T> result(vertices.size());
+	for (size_t i = 0; i < vertices.size(); i++) {
+		result[remap[i]] = vertices[i];
+	}
+	vertices.swap(result);
+}
@@ -0,0 +1,397 @@
+#include "MeshSimplifier.h"
+#include "Engine/ErrorCheck/ErrorCheck.h"
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cassert>
+#include <limits>
+
+namespace {
+	constexpr uint32_t kInvalidIndex = std::numeric_limits<uint32_t>::max();
+
+	// 縮約を繰り返す回数の上限(1回で互いに離れた辺をまとめて縮約する)
+	constexpr uint32_t kMaxPassNum = 64;
+
+	/// <summary>
+	/// 平面までの二乗距離の和を表す対称行列(面積で重み付け)
+	/// </summary>
+	struct Quadric {
+		double a00 = 0.0, a01 = 0.0, a02 = 0.0;
+		double a11 = 0.0, a12 = 0.0;
+		double a22 = 0.0;
+		double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+		double c = 0.0;
+		double weight = 0.0;
+
+		Quadric& operator+=(const Quadric& right) {
+			a00 += right.a00;
+			a01 += right.a01;
+			a02 += right.a02;
+			a11 += right.a11;
+			a12 += right.a12;
+			a22 += right.a22;
+			b0 += right.b0;
+			b1 += right.b1;
+			b2 += right.b2;
+			c += right.c;
+			weight += right.weight;
+			return *this;
+		}
+
+		Quadric operator+(const Quadric& right) const {
+			Quadric result = *this;
+			result += right;
+			return result;
+		}
+
+		/// <summary>
+		/// 平面までの二乗距離の重み付き平均
+		/// </summary>
+		double Error(const Vector3& pos) const {
+			if (weight <= 0.0) {
+				return 0.0;
+			}
+			const double x = pos.x;
+			const double y = pos.y;
+			const double z = pos.z;
+			const double error =
+				a00 * x * x + a11 * y * y + a22 * z * z
+				+ 2.0 * (a01 * x * y + a02 * x * z + a12 * y * z)
+				+ 2.0 * (b0 * x + b1 * y + b2 * z)
+				+ c;
+			return std::max(error, 0.0) / weight;
+		}
+	};
+
+	Quadric MakePlaneQuadric(const Vector3& p0, const Vector3& p1, const Vector3& p2) {
+		Quadric result;
+
+		const Vector3 normal = (p1 - p0).Cross(p2 - p0);
+		const double length = normal.Length();
+		if (length <= 0.0) {
+			return result;
+		}
+
+		const double nx = normal.x / length;
+		const double ny = normal.y / length;
+		const double nz = normal.z / length;
+		const double d = -(nx * p0.x + ny * p0.y + nz * p0.z);
+		// 三角形の面積
+		const double weight = length * 0.5;
+
+		result.a00 = weight * nx * nx;
+		result.a01 = weight * nx * ny;
+		result.a02 = weight * nx * nz;
+		result.a11 = weight * ny * ny;
+		result.a12 = weight * ny * nz;
+		result.a22 = weight * nz * nz;
+		result.b0 = weight * nx * d;
+		result.b1 = weight * ny * d;
+		result.b2 = weight * nz * d;
+		result.c = weight * d * d;
+		result.weight = weight;
+
+		return result;
+	}
+
+	struct PositionHash {
+		size_t operator()(const std::array<uint32_t, 3>& key) const noexcept {
+			uint64_t hash = (static_cast<uint64_t>(key[0]) << 32) ^ (static_cast<uint64_t>(key[1]) << 16) ^ key[2];
+			hash ^= hash >> 33;
+			hash *= 0xff51afd7ed558ccdull;
+			hash ^= hash >> 33;
+			return static_cast<size_t>(hash);
+		}
+	};
+
+	/// <summary>
+	/// 同じ座標の頂点に同じ番号を付ける
+	/// </summary>
+	/// <returns>頂点ごとの座標の番号</returns>
+	std::vector<uint32_t> WeldPositions(std::span<const Vector3> positions, std::vector<Vector3>& weldPositions) {
+		std::vector<uint32_t> weld(positions.size());
+		std::unordered_map<std::array<uint32_t, 3>, uint32_t, PositionHash> weldIndices;
+		weldIndices.reserve(positions.size());
+		weldPositions.clear();
+
+		for (size_t i = 0; i < positions.size(); i++) {
+			// -0.0fと0.0fを同じにする
+			const std::array<uint32_t, 3> key = {
+				std::bit_cast<uint32_t>(positions[i].x + 0.0f),
+				std::bit_cast<uint32_t>(positions[i].y + 0.0f),
+				std::bit_cast<uint32_t>(positions[i].z + 0.0f)
+			};
+			auto [itr, isInsert] = weldIndices.try_emplace(key, static_cast<uint32_t>(weldPositions.size()));
+			if (isInsert) {
+				weldPositions.push_back(positions[i]);
+			}
+			weld[i] = itr->second;
+		}
+
+		return weld;
+	}
+
+	uint64_t MakeEdgeKey(uint32_t a, uint32_t b) {
+		return a < b ? (static_cast<uint64_t>(a) << 32) | b : (static_cast<uint64_t>(b) << 32) | a;
+	}
+
+	/// <summary>
+	/// 縮約の候補(fromをtoに寄せる)
+	/// </summary>
+	struct Collapse {
+		uint32_t from;
+		uint32_t to;
+		double error;
+	};
+}
+
+float SimplifyMesh(std::vector<uint32_t>& indices, std::span<const Vector3> positions, size_t targetIndexNum, float maxError) {
+	assert(indices.size() % 3 == 0);
+	if (indices.size() % 3 != 0) {
+		ErrorCheck::GetInstance()->ErrorTextBox("SimplifyMesh() : indices is not a triangle list", "MeshSimplifier");
+		return 0.0f;
+	}
+	if (std::any_of(indices.begin(), indices.end(), [&positions](uint32_t index) { return positions.size() <= index; })) {
+		ErrorCheck::GetInstance()->ErrorTextBox("SimplifyMesh() : index out of range", "MeshSimplifier");
+		return 0.0f;
+	}
+
+	std::vector<Vector3> weldPositions;
+	const std::vector<uint32_t> weld = WeldPositions(positions, weldPositions);
+	const size_t weldNum = weldPositions.size();
+
+	// 面積0の三角形は先に消す
+	auto isDegenerate = [&weld](uint32_t i0, uint32_t i1, uint32_t i2) {
+		return weld[i0] == weld[i1] || weld[i1] == weld[i2] || weld[i2] == weld[i0];
+	};
+	{
+		size_t writeIndex = 0;
+		for (size_t i = 0; i < indices.size(); i += 3) {
+			if (!isDegenerate(indices[i], indices[i + 1], indices[i + 2])) {
+				std::copy_n(indices.begin() + i, 3, indices.begin() + writeIndex);
+				writeIndex += 3;
+			}
+		}
+		indices.resize(writeIndex);
+	}
+
+	// 継ぎ目(同じ座標で別の頂点が使われている)と、縁や非多様体の辺の頂点は動かさない
+	std::vector<uint32_t> weldVertex(weldNum, kInvalidIndex);
+	std::vector<uint8_t> isLocked(weldNum, 0);
+	for (uint32_t index : indices) {
+		uint32_t& vertex = weldVertex[weld[index]];
+		if (vertex == kInvalidIndex) {
+			vertex = index;
+		}
+		else if (vertex != index) {
+			isLocked[weld[index]] = 1;
+		}
+	}
+
+	std::unordered_map<uint64_t, uint32_t> edgeCounts;
+	edgeCounts.reserve(indices.size());
+	for (size_t i = 0; i < indices.size(); i += 3) {
+		for (size_t j = 0; j < 3; j++) {
+			edgeCounts[MakeEdgeKey(weld[indices[i + j]], weld[indices[i + (j + 1) % 3]])]++;
+		}
+	}
+	for (auto& [key, count] : edgeCounts) {
+		if (count != 2) {
+			isLocked[static_cast<uint32_t>(key >> 32)] = 1;
+			isLocked[static_cast<uint32_t>(key)] = 1;
+		}
+	}
+
+	std::vector<Quadric> quadrics(weldNum);
+	for (size_t i = 0; i < indices.size(); i += 3) {
+		const Quadric quadric = MakePlaneQuadric(positions[indices[i]], positions[indices[i + 1]], positions[indices[i + 2]]);
+		for (size_t j = 0; j < 3; j++) {
+			quadrics[weld[indices[i + j]]] += quadric;
+		}
+	}
+
+	const double maxErrorSq = static_cast<double>(maxError) * static_cast<double>(maxError);
+	double resultErrorSq = 0.0;
+
+	std::vector<uint32_t> remap(positions.size());
+	std::vector<uint32_t> triOffsets(weldNum + 1);
+	std::vector<uint32_t> adjacentTris;
+	std::vector<Collapse> collapses;
+	std::vector<uint8_t> isTouched(weldNum);
+	std::vector<uint32_t> neighborMarks(weldNum, kInvalidIndex);
+
+	for (uint32_t pass = 0; pass < kMaxPassNum && targetIndexNum < indices.size(); pass++) {
+		const uint32_t triNum = static_cast<uint32_t>(indices.size() / 3);
+
+		// 座標ごとに周りの三角形をまとめる
+		std::fill(triOffsets.begin(), triOffsets.end(), 0u);
+		for (uint32_t index : indices) {
+			triOffsets[weld[index] + 1]++;
+		}
+		std::partial_sum(triOffsets.begin(), triOffsets.end(), triOffsets.begin());
+		adjacentTris.resize(indices.size());
+		{
+			std::vector<uint32_t> writeOffsets(triOffsets.begin(), triOffsets.end() - 1);
+			for (uint32_t tri = 0; tri < triNum; tri++) {
+				for (size_t j = 0; j < 3; j++) {
+					adjacentTris[writeOffsets[weld[indices[tri * 3 + j]]]++] = tri;
+				}
+			}
+		}
+		auto getAdjacentTris = [&triOffsets, &adjacentTris](uint32_t weldIndex) {
+			return std::span<const uint32_t>(adjacentTris.data() + triOffsets[weldIndex], triOffsets[weldIndex + 1] - triOffsets[weldIndex]);
+		};
+
+		// 辺ごとに誤差が小さい向きの縮約を候補にする
+		collapses.clear();
+		for (size_t i = 0; i < indices.size(); i += 3) {
+			for (size_t j = 0; j < 3; j++) {
+				const uint32_t a = weld[indices[i + j]];
+				const uint32_t b = weld[indices[i + (j + 1) % 3]];
+				// 内側の辺は2つの三角形に逆向きで出てくるので片方だけ使う
+				if (b < a || (isLocked[a] && isLocked[b])) {
+					continue;
+				}
+
+				const Quadric quadric = quadrics[a] + quadrics[b];
+				const double errorAB = isLocked[a] ? std::numeric_limits<double>::max() : quadric.Error(weldPositions[b]);
+				const double errorBA = isLocked[b] ? std::numeric_limits<double>::max() : quadric.Error(weldPositions[a]);
+				if (errorAB <= errorBA) {
+					collapses.push_back({ a, b, errorAB });
+				}
+				else {
+					collapses.push_back({ b, a, errorBA });
+				}
+			}
+		}
+		std::sort(collapses.begin(), collapses.end(),
+			[](const Collapse& left, const Collapse& right) {
+				return left.error < right.error;
+			}
+		);
+
+		// 誤差の小さい順に、周りが重ならないものをまとめて縮約する
+		const size_t removeTriNum = (indices.size() - targetIndexNum + 2) / 3;
+		size_t removedTriNum = 0;
+		std::fill(isTouched.begin(), isTouched.end(), 0);
+		std::iota(remap.begin(), remap.end(), 0u);
+		uint32_t collapseNum = 0;
+
+		for (const auto& collapse : collapses) {
+			if (removeTriNum <= removedTriNum || maxErrorSq < collapse.error) {
+				break;
+			}
+			if (isTouched[collapse.from] || isTouched[collapse.to]) {
+				continue;
+			}
+
+			const auto fromTris = getAdjacentTris(collapse.from);
+			const auto toTris = getAdjacentTris(collapse.to);
+
+			// 共通の隣の頂点が2つ(辺の両側の三角形)でないと、縮約で面が重なる
+			for (uint32_t tri : fromTris) {
+				for (size_t j = 0; j < 3; j++) {
+					neighborMarks[weld[indices[tri * 3 + j]]] = collapse.from;
+				}
+			}
+			uint32_t commonNum = 0;
+			for (uint32_t tri : toTris) {
+				for (size_t j = 0; j < 3; j++) {
+					const uint32_t neighbor = weld[indices[tri * 3 + j]];
+					if (neighbor != collapse.from && neighbor != collapse.to && neighborMarks[neighbor] == collapse.from) {
+						commonNum++;
+						// 数え終わったら印を消して2回数えないようにする
+						neighborMarks[neighbor] = kInvalidIndex;
+					}
+				}
+			}
+			for (uint32_t tri : fromTris) {
+				for (size_t j = 0; j < 3; j++) {
+					neighborMarks[weld[indices[tri * 3 + j]]] = kInvalidIndex;
+				}
+			}
+			if (commonNum != 2) {
+				continue;
+			}
+
+			// 残る三角形が裏返らないか
+			uint32_t toVertex = kInvalidIndex;
+			bool isFlip = false;
+			for (uint32_t tri : fromTris) {
+				std::array<Vector3, 3> triPositions;
+				std::array<Vector3, 3> movedPositions;
+				bool isContainTo = false;
+				for (size_t j = 0; j < 3; j++) {
+					const uint32_t index = indices[tri * 3 + j];
+					triPositions[j] = weldPositions[weld[index]];
+					movedPositions[j] = weld[index] == collapse.from ? weldPositions[collapse.to] : triPositions[j];
+					if (weld[index] == collapse.to) {
+						isContainTo = true;
+						toVertex = index;
+					}
+				}
+				if (isContainTo) {
+					continue;
+				}
+
+				const Vector3 normal = (triPositions[1] - triPositions[0]).Cross(triPositions[2] - triPositions[0]);
+				const Vector3 movedNormal = (movedPositions[1] - movedPositions[0]).Cross(movedPositions[2] - movedPositions[0]);
+				if (normal.Dot(movedNormal) <= 0.0f) {
+					isFlip = true;
+					break;
+				}
+			}
+			if (isFlip || toVertex == kInvalidIndex) {
+				continue;
+			}
+
+			// 継ぎ目の無い頂点なので使われている頂点は1つだけ
+			remap[weldVertex[collapse.from]] = toVertex;
+			weldVertex[collapse.from] = kInvalidIndex;
+			quadrics[collapse.to] += quadrics[collapse.from];
+			resultErrorSq = std::max(resultErrorSq, collapse.error);
+
+			for (uint32_t tri : fromTris) {
+				for (size_t j = 0; j < 3; j++) {
+					isTouched[weld[indices[tri * 3 + j]]] = 1;
+				}
+			}
+			removedTriNum += 2;
+			collapseNum++;
+		}
+
+		if (collapseNum == 0) {
+			break;
+		}
+
+		// 縮約した頂点を置き換えて、つぶれた三角形を消す
+		size_t writeIndex = 0;
+		for (size_t i = 0; i < indices.size(); i += 3) {
+			const uint32_t i0 = remap[indices[i]];
+			const uint32_t i1 = remap[indices[i + 1]];
+			const uint32_t i2 = remap[indices[i + 2]];
+			if (!isDegenerate(i0, i1, i2)) {
+				indices[writeIndex++] = i0;
+				indices[writeIndex++] = i1;
+				indices[writeIndex++] = i2;
+			}
+		}
+		indices.resize(writeIndex);
+	}
+
+	return static_cast<float>(std::sqrt(resultErrorSq));
+}
+
+uint32_t SelectLod(std::span<const float> lodErrors, float pixelPerUnit, float pixelThreshold) {
+	uint32_t lod = 0;
+	for (uint32_t i = 1; i < static_cast<uint32_t>(lodErrors.size()); i++) {
+		if (pixelThreshold < lodErrors[i] * pixelPerUnit) {
+			break;
+		}
+		lod = i;
+	}
+	return lod;
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "Utils/Math/Vector3.h"
+#include <vector>
+#include <span>
+#include <cstdint>
+
+/// <summary>
+/// 二次誤差(QEM)で辺を縮約して三角形を減らす
+/// 頂点は消すだけで新しく作らないので、元の頂点バッファをそのまま使える
+/// 穴の縁と、UVや法線の継ぎ目(同じ座標に別の頂点がある所)の頂点は動かさない
+/// </summary>
+/// <param name="indices">三角形リストのインデックス(減らした結果に書き換えられる)</param>
+/// <param name="positions">頂点座標</param>
+/// <param name="targetIndexNum">目標のインデックス数</param>
+/// <param name="maxError">許容する誤差(座標と同じ単位の距離)。これを超える縮約はしない</param>
+/// <returns>縮約で生じた誤差の最大値(座標と同じ単位の距離)</returns>
+float SimplifyMesh(std::vector<uint32_t>& indices, std::span<const Vector3> positions, size_t targetIndexNum, float maxError);
+
+/// <summary>
+/// 画面上の誤差がpixelThreshold以下に収まる一番粗いLODを選ぶ
+/// </summary>
+/// <param name="lodErrors">各LODの誤差(0番が一番細かい、座標と同じ単位の距離)</param>
+/// <param name="pixelPerUnit">描画位置で距離1が画面上で何ピクセルになるか(Camera::CalcPixelPerUnit())</param>
+/// <param name="pixelThreshold">許容する画面上の誤差(ピクセル)</param>
+/// <returns>LODの番号</returns>
+uint32_t SelectLod(std::span<const float> lodErrors, float pixelPerUnit, float pixelThreshold = 1.0f);
@@ -0,0 +1,279 @@
+#include "Meshlet.h"
+#include "MeshOptimizer.h"
+#include "Engine/ErrorCheck/ErrorCheck.h"
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <cassert>
+#include <limits>
+
+namespace {
+	constexpr uint32_t kInvalidIndex = std::numeric_limits<uint32_t>::max();
+
+	// 法線がこれより広がっているメッシュレットはほとんど裏面カリングできないのでコーンを作らない
+	constexpr float kMinConeDot = 0.1f;
+
+	/// <summary>
+	/// 境界球と法線コーンを求める
+	/// </summary>
+	void CalcMeshletBounds(Meshlet& meshlet, std::span<const uint32_t> meshletIndices, std::span<const uint32_t> meshletVertices, std::span<const Vector3> positions) {
+		std::vector<Vector3> points(meshletVertices.size());
+		std::transform(meshletVertices.begin(), meshletVertices.end(), points.begin(),
+			[&positions](uint32_t vertex) {
+				return positions[vertex];
+			}
+		);
+		meshlet.sphere = MakeSphere(MakeAABB(points), points);
+
+		std::vector<Vector3> normals;
+		normals.reserve(meshletIndices.size() / 3);
+		Vector3 axis;
+		for (size_t i = 0; i < meshletIndices.size(); i += 3) {
+			const Vector3& p0 = positions[meshletIndices[i]];
+			const Vector3& p1 = positions[meshletIndices[i + 1]];
+			const Vector3& p2 = positions[meshletIndices[i + 2]];
+			// 表面(時計回り)から見た時にカメラ側を向く
+			Vector3 normal = (p1 - p0).Cross(p2 - p0);
+			float length = normal.Length();
+			if (length == 0.0f) {
+				continue;
+			}
+			normal *= 1.0f / length;
+			normals.push_back(normal);
+			axis += normal;
+		}
+
+		meshlet.coneAxis = Vector3();
+		meshlet.coneCutoff = 1.0f;
+
+		float axisLength = axis.Length();
+		if (normals.empty() || axisLength < 1.0e-6f) {
+			return;
+		}
+		axis *= 1.0f / axisLength;
+
+		float minDot = 1.0f;
+		for (auto& normal : normals) {
+			minDot = std::min(minDot, normal.Dot(axis));
+		}
+		if (minDot <= kMinConeDot) {
+			return;
+		}
+
+		// 軸とビューの角度が(90度 - コーンの半角)以内なら全ての面が裏を向いている
+		meshlet.coneAxis = axis;
+		meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+	}
+}
+
+std::vector<Meshlet> BuildMeshlets(std::vector<uint32_t>& indices, std::span<const Vector3> positions, uint32_t maxVertexNum, uint32_t maxTriangleNum) {
+	assert(indices.size() % 3 == 0);
+	if (indices.size() % 3 != 0) {
+		ErrorCheck::GetInstance()->ErrorTextBox("BuildMeshlets() : indices is not a triangle list", "Meshlet");
+		return {};
+	}
+	if (std::any_of(indices.begin(), indices.end(), [&positions](uint32_t index) { return positions.size() <= index; })) {
+		ErrorCheck::GetInstance()->ErrorTextBox("BuildMeshlets() : index out of range", "Meshlet");
+		return {};
+	}
+	assert(3u <= maxVertexNum && 1u <= maxTriangleNum);
+	if (maxVertexNum < 3u || maxTriangleNum < 1u) {
+		ErrorCheck::GetInstance()->ErrorTextBox("BuildMeshlets() : maxVertexNum or maxTriangleNum is too small", "Meshlet");
+		return {};
+	}
+
+	const size_t triangleNum = indices.size() / 3;
+	const size_t vertexNum = positions.size();
+
+	// 頂点を使っている三角形を引けるようにする
+	std::vector<uint32_t> adjacencyOffsets(vertexNum + 1, 0u);
+	for (uint32_t index : indices) {
+		adjacencyOffsets[index + 1]++;
+	}
+	std::partial_sum(adjacencyOffsets.begin(), adjacencyOffsets.end(), adjacencyOffsets.begin());
+	std::vector<uint32_t> adjacencyTriangles(indices.size());
+	{
+		std::vector<uint32_t> cursors(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+		for (size_t i = 0; i < indices.size(); i++) {
+			adjacencyTriangles[cursors[indices[i]]++] = static_cast<uint32_t>(i / 3);
+		}
+	}
+
+	std::vector<Vector3> triangleCenters(triangleNum);
+	for (size_t i = 0; i < triangleNum; i++) {
+		triangleCenters[i] = (positions[indices[i * 3]] + positions[indices[i * 3 + 1]] + positions[indices[i * 3 + 2]]) * (1.0f / 3.0f);
+	}
+
+	// どのメッシュレットに入ったか、どのメッシュレットの候補になったか
+	std::vector<uint8_t> isTriangleUsed(triangleNum, 0u);
+	std::vector<uint32_t> candidateMeshlets(triangleNum, kInvalidIndex);
+	std::vector<uint32_t> vertexMeshlets(vertexNum, kInvalidIndex);
+
+	std::vector<Meshlet> meshlets;
+	std::vector<uint32_t> meshletIndices;
+	meshletIndices.reserve(indices.size());
+	std::vector<uint32_t> meshletVertices;
+	std::vector<uint32_t> meshletTriangles;
+	std::vector<uint32_t> localIndices;
+	std::vector<uint32_t> candidates;
+
+	size_t seed = 0;
+	uint32_t nextSeed = kInvalidIndex;
+	while (true) {
+		// 前のメッシュレットの隣から続けて、無ければ元の順番で残っている最初の三角形から始める
+		while (seed < triangleNum && isTriangleUsed[seed]) {
+			seed++;
+		}
+		if (seed == triangleNum) {
+			break;
+		}
+		uint32_t triangle = nextSeed != kInvalidIndex ? nextSeed : static_cast<uint32_t>(seed);
+
+		const uint32_t meshletIndex = static_cast<uint32_t>(meshlets.size());
+		Meshlet meshlet;
+		meshlet.indexOffset = static_cast<uint32_t>(meshletIndices.size());
+		meshletVertices.clear();
+		meshletTriangles.clear();
+		candidates.clear();
+		Vector3 centerSum;
+
+		while (true) {
+			isTriangleUsed[triangle] = 1u;
+			meshletTriangles.push_back(triangle);
+			for (size_t i = 0; i < 3; i++) {
+				const uint32_t vertex = indices[triangle * 3 + i];
+				if (vertexMeshlets[vertex] == meshletIndex) {
+					continue;
+				}
+				vertexMeshlets[vertex] = meshletIndex;
+				meshletVertices.push_back(vertex);
+
+				for (uint32_t j = adjacencyOffsets[vertex]; j < adjacencyOffsets[vertex + 1]; j++) {
+					const uint32_t adjacency = adjacencyTriangles[j];
+					if (!isTriangleUsed[adjacency] && candidateMeshlets[adjacency] != meshletIndex) {
+						candidateMeshlets[adjacency] = meshletIndex;
+						candidates.push_back(adjacency);
+					}
+				}
+			}
+			centerSum += triangleCenters[triangle];
+
+			if (maxTriangleNum <= meshletTriangles.size()) {
+				break;
+			}
+
+			// 隣の三角形のうち、増える頂点が少なく、中心に近いものを次に入れる
+			const Vector3 center = centerSum * (1.0f / static_cast<float>(meshletTriangles.size()));
+			uint32_t best = kInvalidIndex;
+			uint32_t bestNewVertexNum = 4u;
+			float bestDistance = std::numeric_limits<float>::max();
+			size_t writeIndex = 0;
+			for (uint32_t candidate : candidates) {
+				if (isTriangleUsed[candidate]) {
+					continue;
+				}
+				candidates[writeIndex++] = candidate;
+
+				uint32_t newVertexNum = 0;
+				for (size_t i = 0; i < 3; i++) {
+					newVertexNum += vertexMeshlets[indices[candidate * 3 + i]] != meshletIndex ? 1u : 0u;
+				}
+				if (maxVertexNum < meshletVertices.size() + newVertexNum) {
+					continue;
+				}
+
+				const Vector3 toCenter = triangleCenters[candidate] - center;
+				const float distance = toCenter.Dot(toCenter);
+				if (newVertexNum < bestNewVertexNum || (newVertexNum == bestNewVertexNum && distance < bestDistance)) {
+					best = candidate;
+					bestNewVertexNum = newVertexNum;
+					bestDistance = distance;
+				}
+			}
+			candidates.resize(writeIndex);
+
+			if (best == kInvalidIndex) {
+				break;
+			}
+			triangle = best;
+		}
+
+		// 残った隣の三角形のうち、使っていない隣が一番少ないもの(端から埋めると細切れが残りにくい)
+		nextSeed = kInvalidIndex;
+		uint32_t minFreeNum = std::numeric_limits<uint32_t>::max();
+		for (uint32_t candidate : candidates) {
+			if (isTriangleUsed[candidate]) {
+				continue;
+			}
+			uint32_t freeNum = 0;
+			for (size_t i = 0; i < 3; i++) {
+				const uint32_t vertex = indices[candidate * 3 + i];
+				for (uint32_t j = adjacencyOffsets[vertex]; j < adjacencyOffsets[vertex + 1]; j++) {
+					freeNum += isTriangleUsed[adjacencyTriangles[j]] ? 0u : 1u;
+				}
+			}
+			if (freeNum < minFreeNum) {
+				nextSeed = candidate;
+				minFreeNum = freeNum;
+			}
+		}
+
+		// メッシュレットの中で頂点キャッシュに乗りやすい順番に並び替える
+		localIndices.clear();
+		for (uint32_t meshletTriangle : meshletTriangles) {
+			for (size_t i = 0; i < 3; i++) {
+				const uint32_t vertex = indices[meshletTriangle * 3 + i];
+				localIndices.push_back(static_cast<uint32_t>(std::find(meshletVertices.begin(), meshletVertices.end(), vertex) - meshletVertices.begin()));
+			}
+		}
+		OptimizeVertexCache(localIndices, meshletVertices.size());
+		for (uint32_t localIndex : localIndices) {
+			meshletIndices.push_back(meshletVertices[localIndex]);
+		}
+		meshlet.triangleNum = static_cast<uint32_t>(meshletTriangles.size());
+		meshlet.vertexNum = static_cast<uint32_t>(meshletVertices.size());
+		CalcMeshletBounds(
+			meshlet,
+			std::span<const uint32_t>(meshletIndices).subspan(meshlet.indexOffset, meshlet.triangleNum * 3),
+			meshletVertices,
+			positions
+		);
+		meshlets.push_back(meshlet);
+	}
+
+	indices = std::move(meshletIndices);
+
+	return meshlets;
+}
+
+bool IsMeshletVisible(const Meshlet& meshlet, const Frustum& frustum, const Vector3& cameraPos, bool isConeCulling) {
+	if (!frustum.IsVisible(meshlet.sphere)) {
+		return false;
+	}
+
+	if (isConeCulling && meshlet.coneCutoff < 1.0f) {
+		// 球のどこから見ても、ビューと軸の角度がコーンの外側なら裏面
+		const Vector3 toCenter = meshlet.sphere.center - cameraPos;
+		if (meshlet.coneCutoff * toCenter.Length() + meshlet.sphere.radius <= toCenter.Dot(meshlet.coneAxis)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+uint32_t CullMeshlets(std::span<const Meshlet> meshlets, const Frustum& frustum, const Vector3& cameraPos, bool isConeCulling, std::span<bool> isVisible) {
+	assert(meshlets.size() == isVisible.size());
+	if (meshlets.size() != isVisible.size()) {
+		ErrorCheck::GetInstance()->ErrorTextBox("CullMeshlets() : meshlets and isVisible are different sizes", "Meshlet");
+		return 0u;
+	}
+
+	uint32_t visibleNum = 0;
+	for (size_t i = 0; i < meshlets.size(); i++) {
+		isVisible[i] = IsMeshletVisible(meshlets[i], frustum, cameraPos, isConeCulling);
+		visibleNum += isVisible[i] ? 1u : 0u;
+	}
+
+	return visibleNum;
+}
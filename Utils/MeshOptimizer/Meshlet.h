@@ -0,0 +1,63 @@
+#pragma once
+#include "Utils/Math/Vector3.h"
+#include "Utils/Math/Bounds.h"
+#include "Utils/Math/Frustum.h"
+#include <vector>
+#include <span>
+#include <cstdint>
+#include <type_traits>
+
+/// <summary>
+/// 三角形の小さな塊(クラスター)。塊ごとに視錐台と裏面でカリングする
+/// 三角形はインデックスバッファ上で連続しているので、範囲を指定してそのまま描画できる
+/// </summary>
+struct Meshlet {
+	/// <summary>
+	/// インデックスバッファ上の開始位置
+	/// </summary>
+	uint32_t indexOffset = 0;
+	uint32_t triangleNum = 0;
+	uint32_t vertexNum = 0;
+
+	/// <summary>
+	/// 法線コーンの広がり(sin)。1ならコーンが無効で裏面カリングしない
+	/// </summary>
+	float coneCutoff = 1.0f;
+
+	Sphere sphere;
+
+	/// <summary>
+	/// 三角形の法線の平均の向き(正規化済み。コーンが無効なら0)
+	/// </summary>
+	Vector3 coneAxis;
+	float pad = 0.0f;
+};
+
+static_assert(std::is_trivially_copyable_v<Meshlet>, "Meshlet must be trivially copyable");
+
+/// <summary>
+/// 三角形を頂点数と三角形数の上限以内のメッシュレットに分ける
+/// 隣り合う三角形を新しい頂点が少ない順にまとめていく
+/// </summary>
+/// <param name="indices">三角形リストのインデックス(メッシュレットごとに連続するように並び替えられる)</param>
+/// <param name="positions">頂点座標</param>
+/// <param name="maxVertexNum">1つのメッシュレットの頂点数の上限</param>
+/// <param name="maxTriangleNum">1つのメッシュレットの三角形数の上限</param>
+/// <returns>メッシュレット(インデックスの順番に並ぶ)</returns>
+std::vector<Meshlet> BuildMeshlets(std::vector<uint32_t>& indices, std::span<const Vector3> positions, uint32_t maxVertexNum = 64, uint32_t maxTriangleNum = 124);
+
+/// <summary>
+/// メッシュレットが見えるか(視錐台の外と、全ての面がカメラに背を向けているものを除く)
+/// </summary>
+/// <param name="meshlet">メッシュレット</param>
+/// <param name="frustum">メッシュレットと同じ座標系の視錐台</param>
+/// <param name="cameraPos">メッシュレットと同じ座標系のカメラの位置</param>
+/// <param name="isConeCulling">裏面カリングをするか(拡縮が軸ごとに違う、または反転している時は法線が変わるのでしない)</param>
+bool IsMeshletVisible(const Meshlet& meshlet, const Frustum& frustum, const Vector3& cameraPos, bool isConeCulling = true);
+
+/// <summary>
+/// メッシュレットをまとめてカリングする
+/// </summary>
+/// <param name="isVisible">結果(meshletsと同じ数)</param>
+/// <returns>見えるメッシュレットの数</returns>
+uint32_t CullMeshlets(std::span<const Meshlet> meshlets, const Frustum& frustum, const Vector3& cameraPos, bool isConeCulling, std::span<bool> isVisible);
@@ -0,0 +1,86 @@
+#include "NormalGenerator.h"
+#include "Engine/ErrorCheck/ErrorCheck.h"
+#include <algorithm>
+#include <numeric>
+#include <numbers>
+#include <cmath>
+#include <cassert>
+
+Vector3 CalcFaceNormal(const Vector3& p0, const Vector3& p1, const Vector3& p2) {
+	const Vector3 vec1 = p1 - p0;
+	const Vector3 vec2 = p2 - p1;
+
+	return vec1.Cross(vec2).Normalize();
+}
+
+std::vector<Vector3> GenerateNormals(std::span<const Vector3> positions, std::span<const uint32_t> indices, float smoothAngle) {
+	assert(indices.size() % 3 == 0);
+	if (indices.size() % 3 != 0) {
+		ErrorCheck::GetInstance()->ErrorTextBox("GenerateNormals() : indices is not a triangle list", "NormalGenerator");
+		return {};
+	}
+	if (std::any_of(indices.begin(), indices.end(), [&positions](uint32_t index) { return positions.size() <= index; })) {
+		ErrorCheck::GetInstance()->ErrorTextBox("GenerateNormals() : index out of range", "NormalGenerator");
+		return {};
+	}
+
+	const size_t triangleNum = indices.size() / 3;
+	std::vector<Vector3> faceNormals(triangleNum);
+	for (size_t i = 0; i < triangleNum; i++) {
+		faceNormals[i] = CalcFaceNormal(positions[indices[i * 3]], positions[indices[i * 3 + 1]], positions[indices[i * 3 + 2]]);
+	}
+
+	std::vector<Vector3> normals(indices.size());
+	if (smoothAngle <= 0.0f) {
+		for (size_t i = 0; i < indices.size(); i++) {
+			normals[i] = faceNormals[i / 3];
+		}
+		return normals;
+	}
+
+	// 角ごとの角度(平均するときの重み)
+	std::vector<float> cornerAngles(indices.size());
+	for (size_t i = 0; i < indices.size(); i++) {
+		const size_t first = i / 3 * 3;
+		const Vector3& pos = positions[indices[i]];
+		const Vector3 edge1 = (positions[indices[first + (i + 1) % 3]] - pos).Normalize();
+		const Vector3 edge2 = (positions[indices[first + (i + 2) % 3]] - pos).Normalize();
+		cornerAngles[i] = std::acos(std::clamp(edge1.Dot(edge2), -1.0f, 1.0f));
+	}
+
+	// 頂点を使っている角を引けるようにする
+	std::vector<uint32_t> adjacencyOffsets(positions.size() + 1, 0u);
+	for (uint32_t index : indices) {
+		adjacencyOffsets[index + 1]++;
+	}
+	std::partial_sum(adjacencyOffsets.begin(), adjacencyOffsets.end(), adjacencyOffsets.begin());
+	std::vector<uint32_t> adjacencyCorners(indices.size());
+	{
+		std::vector<uint32_t> cursors(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+		for (size_t i = 0; i < indices.size(); i++) {
+			adjacencyCorners[cursors[indices[i]]++] = static_cast<uint32_t>(i);
+		}
+	}
+
+	const float cosSmoothAngle = std::cos(std::min(smoothAngle, std::numbers::pi_v<float>));
+	for (size_t i = 0; i < indices.size(); i++) {
+		const Vector3& faceNormal = faceNormals[i / 3];
+		if (faceNormal == Vector3::zero) {
+			continue;
+		}
+
+		// 同じ頂点の角を同じ順番で足すので、同じ面の組み合わせなら結果も同じになる
+		Vector3 sum;
+		const uint32_t vertex = indices[i];
+		for (uint32_t j = adjacencyOffsets[vertex]; j < adjacencyOffsets[vertex + 1]; j++) {
+			const uint32_t corner = adjacencyCorners[j];
+			const Vector3& normal = faceNormals[corner / 3];
+			if (cosSmoothAngle <= normal.Dot(faceNormal)) {
+				sum += normal * cornerAngles[corner];
+			}
+		}
+		normals[i] = sum == Vector3::zero ? faceNormal : sum.Normalize();
+	}
+
+	return normals;
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include "Utils/Math/Vector3.h"
+#include <vector>
+#include <span>
+#include <cstdint>
+
+/// <summary>
+/// 面の法線(Model.GS.hlslと同じ計算で、表(時計回り)から見てカメラ側を向く)
+/// 面積が0の面は0ベクトルになる
+/// </summary>
+Vector3 CalcFaceNormal(const Vector3& p0, const Vector3& p1, const Vector3& p2);
+
+/// <summary>
+/// 三角形の頂点ごとの法線を作る
+/// スムーズの時は同じ頂点座標を使う面のうち、向きの差がsmoothAngle以下のものを頂点の角度で重み付けして平均する
+/// </summary>
+/// <param name="positions">頂点座標</param>
+/// <param name="indices">三角形リストのインデックス(同じ頂点番号の角を同じ点として扱う)</param>
+/// <param name="smoothAngle">平均する面の角度の上限(ラジアン)。0以下ならフラット</param>
+/// <returns>indicesと同じ数の法線(正規化済み、同じ結果になる角はビットまで同じ値)</returns>
+std::vector<Vector3> GenerateNormals(std::span<const Vector3> positions, std::span<const uint32_t> indices, float smoothAngle);
@@ -0,0 +1,425 @@
+#include "MipGenerator.h"
+// SIMDの命令セットの選択(MATH_USE_SSEなど)をベクトル演算と揃える
+#include "Utils/Math/Vector4.h"
+#include <array>
+#include <thread>
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace {
+	/// <summary>
+	/// 線形からsRGBに戻す時の表の分割数(0付近でも1段階未満の誤差になる細かさ)
+	/// </summary>
+	constexpr size_t kSrgbTableSize = 1 << 14;
+	/// <summary>
+	/// 1スレッドに任せる最小の行数(小さいミップはスレッドを作る方が遅い)
+	/// </summary>
+	constexpr uint32_t kMinRowPerThread = 16;
+
+	struct SrgbTable {
+		std::array<float, 256> toLinear;
+		std::array<uint8_t, kSrgbTableSize + 1> toSrgb;
+	};
+
+	SrgbTable MakeSrgbTable() {
+		SrgbTable table{};
+		for (size_t i = 0; i < table.toLinear.size(); i++) {
+			const double value = static_cast<double>(i) / 255.0;
+			table.toLinear[i] = static_cast<float>(value <= 0.04045 ? value / 12.92 : std::pow((value + 0.055) / 1.055, 2.4));
+		}
+		for (size_t i = 0; i < table.toSrgb.size(); i++) {
+			const double value = static_cast<double>(i) / static_cast<double>(kSrgbTableSize);
+			const double srgb = value <= 0.0031308 ? value * 12.92 : 1.055 * std::pow(value, 1.0 / 2.4) - 0.055;
+			table.toSrgb[i] = static_cast<uint8_t>(std::lround(std::clamp(srgb, 0.0, 1.0) * 255.0));
+		}
+		return table;
+	}
+
+	const SrgbTable& GetSrgbTable() {
+		static const SrgbTable table = MakeSrgbTable();
+		return table;
+	}
+
+	/// <summary>
+	/// 線形空間の画像(1ピクセルにRGBAのfloatを4つ並べる)
+	/// </summary>
+	struct LinearImage {
+		uint32_t width = 0;
+		uint32_t height = 0;
+		std::vector<float> pixels;
+
+		float* GetRow(uint32_t y) {
+			return pixels.data() + static_cast<size_t>(y) * width * 4;
+		}
+		const float* GetRow(uint32_t y) const {
+			return pixels.data() + static_cast<size_t>(y) * width * 4;
+		}
+	};
+
+	/// <summary>
+	/// 1次元の縮小に使う重み
+	/// 縮小後のi番のピクセルは、元のfirsts[i]番から(offsets[i + 1] - offsets[i])個のピクセルを重み付きで足す
+	/// </summary>
+	struct FilterTaps {
+		std::vector<uint32_t> firsts;
+		std::vector<uint32_t> offsets;
+		std::vector<float> weights;
+	};
+
+	/// <summary>
+	/// 第1種変形ベッセル関数(0次)
+	/// </summary>
+	double BesselI0(double x) {
+		double sum = 1.0;
+		double term = 1.0;
+		for (int k = 1; k < 32; k++) {
+			term *= (x * 0.5 / k) * (x * 0.5 / k);
+			sum += term;
+			if (term < sum * 1.0e-12) {
+				break;
+			}
+		}
+		return sum;
+	}
+
+	FilterTaps MakeFilterTaps(uint32_t sourceSize, uint32_t size, MipGenerator::Filter filter) {
+		FilterTaps taps;
+		taps.firsts.reserve(size);
+		taps.offsets.reserve(size + 1);
+		taps.offsets.push_back(0);
+
+		const double scale = static_cast<double>(sourceSize) / static_cast<double>(size);
+		const double radius = filter == MipGenerator::Filter::Box ? scale * 0.5 : MipGenerator::kKaiserRadius * scale;
+		const double kaiserScale = 1.0 / BesselI0(MipGenerator::kKaiserAlpha);
+
+		std::vector<double> weights;
+		for (uint32_t i = 0; i < size; i++) {
+			// 元のピクセルi番は[i, i + 1)の範囲にあるとして、縮小後のピクセルの中心を合わせる
+			const double center = (i + 0.5) * scale;
+			const int64_t begin = static_cast<int64_t>(std::floor(center - radius));
+			const int64_t end = static_cast<int64_t>(std::ceil(center + radius));
+
+			// 範囲外は端のピクセルを繰り返す
+			const int64_t first = std::clamp<int64_t>(begin, 0, sourceSize - 1);
+			const int64_t last = std::clamp<int64_t>(end - 1, 0, sourceSize - 1);
+			weights.assign(static_cast<size_t>(last - first + 1), 0.0);
+			for (int64_t j = begin; j < end; j++) {
+				double weight = 0.0;
+				if (filter == MipGenerator::Filter::Box) {
+					weight = std::max(0.0, std::min(j + 1.0, center + radius) - std::max(static_cast<double>(j), center - radius));
+				}
+				else {
+					// 縮小後のピクセル単位の距離
+					const double x = (j + 0.5 - center) / scale;
+					const double windowX = x / MipGenerator::kKaiserRadius;
+					if (windowX * windowX < 1.0) {
+						const double sinc = std::abs(x) < 1.0e-9 ? 1.0 : std::sin(std::numbers::pi * x) / (std::numbers::pi * x);
+						weight = sinc * BesselI0(MipGenerator::kKaiserAlpha * std::sqrt(1.0 - windowX * windowX)) * kaiserScale;
+					}
+				}
+				weights[static_cast<size_t>(std::clamp<int64_t>(j, 0, sourceSize - 1) - first)] += weight;
+			}
+
+			// 重みが0の端は詰める
+			size_t front = 0;
+			size_t back = weights.size();
+			while (front + 1 < back && weights[front] == 0.0) {
+				front++;
+			}
+			while (front + 1 < back && weights[back - 1] == 0.0) {
+				back--;
+			}
+			double sum = 0.0;
+			for (size_t j = front; j < back; j++) {
+				sum += weights[j];
+			}
+
+			taps.firsts.push_back(static_cast<uint32_t>(first + static_cast<int64_t>(front)));
+			for (size_t j = front; j < back; j++) {
+				taps.weights.push_back(static_cast<float>(weights[j] / sum));
+			}
+			taps.offsets.push_back(static_cast<uint32_t>(taps.weights.size()));
+		}
+
+		return taps;
+	}
+
+	/// <summary>
+	/// [0, count)を分けて並列に処理する
+	/// </summary>
+	template<class Func>
+	void ParallelFor(uint32_t count, uint32_t threadNum, Func func) {
+		if (threadNum == 0) {
+			threadNum = std::max(std::thread::hardware_concurrency(), 1u);
+		}
+		threadNum = std::clamp(count / kMinRowPerThread, 1u, threadNum);
+		if (threadNum == 1) {
+			func(0u, count);
+			return;
+		}
+
+		std::vector<std::thread> threads;
+		threads.reserve(threadNum);
+		for (uint32_t i = 0; i < threadNum; i++) {
+			threads.emplace_back(func, count * i / threadNum, count * (i + 1) / threadNum);
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+	}
+
+	/// <summary>
+	/// 行を重み付きで足す(dst = Σ weights[k] * sources[k])
+	/// </summary>
+	void BlendRows(const float* const* sources, const float* weights, uint32_t tapNum, size_t floatNum, float* dst) {
+		size_t i = 0;
+#if defined(MATH_USE_AVX)
+		for (; i + 8 <= floatNum; i += 8) {
+			__m256 sum = _mm256_setzero_ps();
+			for (uint32_t k = 0; k < tapNum; k++) {
+				sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(weights[k]), _mm256_loadu_ps(sources[k] + i)));
+			}
+			_mm256_storeu_ps(dst + i, sum);
+		}
+#endif
+#if defined(MATH_USE_SSE)
+		for (; i + 4 <= floatNum; i += 4) {
+			__m128 sum = _mm_setzero_ps();
+			for (uint32_t k = 0; k < tapNum; k++) {
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[k]), _mm_loadu_ps(sources[k] + i)));
+			}
+			_mm_storeu_ps(dst + i, sum);
+		}
+#endif
+		for (; i < floatNum; i++) {
+			float sum = 0.0f;
+			for (uint32_t k = 0; k < tapNum; k++) {
+				sum += weights[k] * sources[k][i];
+			}
+			dst[i] = sum;
+		}
+	}
+
+	/// <summary>
+	/// 1行の中で隣り合うピクセルを重み付きで足す
+	/// </summary>
+	void BlendColumns(const float* source, const FilterTaps& taps, uint32_t width, float* dst) {
+		for (uint32_t x = 0; x < width; x++) {
+			const float* pixel = source + static_cast<size_t>(taps.firsts[x]) * 4;
+			const float* weights = taps.weights.data() + taps.offsets[x];
+			const uint32_t tapNum = taps.offsets[x + 1] - taps.offsets[x];
+#if defined(MATH_USE_SSE)
+			__m128 sum = _mm_setzero_ps();
+			for (uint32_t k = 0; k < tapNum; k++) {
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[k]), _mm_loadu_ps(pixel + k * 4)));
+			}
+			_mm_storeu_ps(dst + static_cast<size_t>(x) * 4, sum);
+#else
+			for (size_t c = 0; c < 4; c++) {
+				float sum = 0.0f;
+				for (uint32_t k = 0; k < tapNum; k++) {
+					sum += weights[k] * pixel[k * 4 + c];
+				}
+				dst[static_cast<size_t>(x) * 4 + c] = sum;
+			}
+#endif
+		}
+	}
+
+	/// <summary>
+	/// 元のsRGBの画像の行を線形空間に直して返す
+	/// 縦のフィルターがかかる範囲の行だけを輪状に覚えておき、同じ行を何度も直さないようにする
+	/// </summary>
+	class SrgbRowReader {
+	public:
+		SrgbRowReader(std::span<const uint8_t> pixels_, uint32_t width_, size_t rowPitch_, uint32_t rowNum, const SrgbTable& table_) :
+			pixels(pixels_),
+			width(width_),
+			rowPitch(rowPitch_),
+			table(table_),
+			rows(static_cast<size_t>(width_) * 4 * rowNum),
+			rowIndices(rowNum, -1)
+		{}
+
+	public:
+		const float* GetRow(uint32_t y) {
+			const size_t slot = y % rowIndices.size();
+			float* dst = rows.data() + slot * width * 4;
+			if (rowIndices[slot] != static_cast<int64_t>(y)) {
+				const uint8_t* src = pixels.data() + y * rowPitch;
+				for (size_t i = 0; i < static_cast<size_t>(width) * 4; i += 4) {
+					dst[i + 0] = table.toLinear[src[i + 0]];
+					dst[i + 1] = table.toLinear[src[i + 1]];
+					dst[i + 2] = table.toLinear[src[i + 2]];
+					dst[i + 3] = static_cast<float>(src[i + 3]) * (1.0f / 255.0f);
+				}
+				rowIndices[slot] = y;
+			}
+			return dst;
+		}
+
+	private:
+		std::span<const uint8_t> pixels;
+		uint32_t width;
+		size_t rowPitch;
+		const SrgbTable& table;
+
+		std::vector<float> rows;
+		std::vector<int64_t> rowIndices;
+	};
+
+	/// <summary>
+	/// 線形空間の画像の行をそのまま返す
+	/// </summary>
+	class LinearRowReader {
+	public:
+		LinearRowReader(const LinearImage& image_) :
+			image(image_)
+		{}
+
+	public:
+		const float* GetRow(uint32_t y) const {
+			return image.GetRow(y);
+		}
+
+	private:
+		const LinearImage& image;
+	};
+
+	/// <summary>
+	/// 縮小する(1行ずつ縦に足してから横に足すので、途中の画像は作らない)
+	/// </summary>
+	/// <param name="makeReader">スレッドごとに元の画像の行を読むものを作る関数(引数は同時に使う行の数)</param>
+	template<class MakeReader>
+	void Downsample(uint32_t sourceWidth, uint32_t sourceHeight, MakeReader makeReader, LinearImage& dst, MipGenerator::Filter filter, uint32_t threadNum) {
+		dst.width = std::max(sourceWidth / 2u, 1u);
+		dst.height = std::max(sourceHeight / 2u, 1u);
+		dst.pixels.resize(static_cast<size_t>(dst.width) * dst.height * 4);
+
+		const FilterTaps rowTaps = MakeFilterTaps(sourceHeight, dst.height, filter);
+		const FilterTaps columnTaps = MakeFilterTaps(sourceWidth, dst.width, filter);
+		uint32_t maxTapNum = 1;
+		for (uint32_t y = 0; y < dst.height; y++) {
+			maxTapNum = std::max(maxTapNum, rowTaps.offsets[y + 1] - rowTaps.offsets[y]);
+		}
+
+		ParallelFor(dst.height, threadNum,
+			[&](uint32_t begin, uint32_t end) {
+				auto reader = makeReader(maxTapNum);
+				std::vector<const float*> rows(maxTapNum);
+				std::vector<float> blendedRow(static_cast<size_t>(sourceWidth) * 4);
+				for (uint32_t y = begin; y < end; y++) {
+					const uint32_t tapNum = rowTaps.offsets[y + 1] - rowTaps.offsets[y];
+					for (uint32_t k = 0; k < tapNum; k++) {
+						rows[k] = reader.GetRow(rowTaps.firsts[y] + k);
+					}
+					BlendRows(rows.data(), rowTaps.weights.data() + rowTaps.offsets[y], tapNum, blendedRow.size(), blendedRow.data());
+					BlendColumns(blendedRow.data(), columnTaps, dst.width, dst.GetRow(y));
+				}
+			}
+		);
+	}
+
+	/// <summary>
+	/// 線形空間の1行をsRGBのRGBA8にする
+	/// </summary>
+	void EncodeRow(const float* source, uint32_t width, const SrgbTable& table, uint8_t* dst) {
+		for (uint32_t x = 0; x < width; x++) {
+			alignas(16) std::array<int32_t, 4> indices;
+#if defined(MATH_USE_SSE)
+			static const __m128 scale = _mm_setr_ps(static_cast<float>(kSrgbTableSize), static_cast<float>(kSrgbTableSize), static_cast<float>(kSrgbTableSize), 255.0f);
+			__m128 value = _mm_loadu_ps(source + static_cast<size_t>(x) * 4);
+			value = _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+			value = _mm_add_ps(_mm_mul_ps(value, scale), _mm_set1_ps(0.5f));
+			_mm_store_si128(reinterpret_cast<__m128i*>(indices.data()), _mm_cvttps_epi32(value));
+#else
+			constexpr std::array<float, 4> scale = { static_cast<float>(kSrgbTableSize), static_cast<float>(kSrgbTableSize), static_cast<float>(kSrgbTableSize), 255.0f };
+			for (size_t c = 0; c < 4; c++) {
+				indices[c] = static_cast<int32_t>(std::min(std::max(source[static_cast<size_t>(x) * 4 + c], 0.0f), 1.0f) * scale[c] + 0.5f);
+			}
+#endif
+			uint8_t* pixel = dst + static_cast<size_t>(x) * 4;
+			pixel[0] = table.toSrgb[indices[0]];
+			pixel[1] = table.toSrgb[indices[1]];
+			pixel[2] = table.toSrgb[indices[2]];
+			pixel[3] = static_cast<uint8_t>(indices[3]);
+		}
+	}
+}
+
+std::vector<MipGenerator::Mip> MipGenerator::Generate(
+	std::span<const uint8_t> pixels,
+	uint32_t width,
+	uint32_t height,
+	size_t rowPitch,
+	Filter filter,
+	uint32_t threadNum
+) {
+	std::vector<Mip> result;
+	if (width == 0 || height == 0 || rowPitch < static_cast<size_t>(width) * 4
+		|| pixels.size() < rowPitch * (height - 1) + static_cast<size_t>(width) * 4
+	) {
+		return result;
+	}
+
+	const uint32_t mipNum = CalcMipNum(width, height);
+	if (mipNum <= 1) {
+		return result;
+	}
+
+	const SrgbTable& table = GetSrgbTable();
+
+	// ミップは前のミップから作るので順番に作り、それぞれの中を行で分ける
+	// 元の画像は縮小しながら線形空間に直すので、線形空間の元の画像は作らない
+	std::vector<LinearImage> levels(mipNum - 1);
+	for (size_t i = 0; i < levels.size(); i++) {
+		if (i == 0) {
+			Downsample(width, height,
+				[&](uint32_t rowNum) { return SrgbRowReader(pixels, width, rowPitch, rowNum, table); },
+				levels[i], filter, threadNum
+			);
+		}
+		else {
+			const LinearImage& parent = levels[i - 1];
+			Downsample(parent.width, parent.height,
+				[&](uint32_t) { return LinearRowReader(parent); },
+				levels[i], filter, threadNum
+			);
+		}
+	}
+
+	// sRGBに戻すのは全てのミップの行をまとめて分ける
+	std::vector<uint32_t> rowOffsets(levels.size() + 1, 0);
+	result.resize(levels.size());
+	for (size_t i = 0; i < levels.size(); i++) {
+		result[i].width = levels[i].width;
+		result[i].height = levels[i].height;
+		result[i].pixels.resize(static_cast<size_t>(levels[i].width) * levels[i].height * 4);
+		rowOffsets[i + 1] = rowOffsets[i] + levels[i].height;
+	}
+	ParallelFor(rowOffsets.back(), threadNum,
+		[&](uint32_t begin, uint32_t end) {
+			size_t level = 0;
+			for (uint32_t row = begin; row < end; row++) {
+				while (rowOffsets[level + 1] <= row) {
+					level++;
+				}
+				const uint32_t y = row - rowOffsets[level];
+				EncodeRow(levels[level].GetRow(y), levels[level].width, table, result[level].pixels.data() + static_cast<size_t>(y) * levels[level].width * 4);
+			}
+		}
+	);
+
+	return result;
+}
+
+uint32_t MipGenerator::CalcMipNum(uint32_t width, uint32_t height) {
+	uint32_t mipNum = 1;
+	while (1 < width || 1 < height) {
+		width = std::max(width / 2u, 1u);
+		height = std::max(height / 2u, 1u);
+		mipNum++;
+	}
+	return mipNum;
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <vector>
+#include <span>
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// sRGBのRGBA8の画像からミップマップを作る(GPUもWindowsのAPIも使わない)
+/// 色は線形空間に直してから縮小し、sRGBに戻す(アルファはそのまま縮小する)
+/// 縦、横の順に分けてフィルターをかけ、行ごとにスレッドで分ける
+/// 縮小後の大きさは max(元の大きさ / 2, 1) で、2の累乗でない大きさも元の範囲に合わせて重みを決める
+/// </summary>
+class MipGenerator final {
+public:
+	enum class Filter : uint32_t {
+		/// <summary>
+		/// 縮小後のピクセルが覆う範囲の平均
+		/// </summary>
+		Box,
+		/// <summary>
+		/// カイザー窓をかけたsinc(ボックスよりぼやけにくいが、輪郭が少しにじむ)
+		/// </summary>
+		Kaiser
+	};
+
+	/// <summary>
+	/// 1つのミップ(行の隙間なく詰めたsRGBのRGBA8)
+	/// </summary>
+	struct Mip {
+		uint32_t width = 0;
+		uint32_t height = 0;
+		std::vector<uint8_t> pixels;
+	};
+
+public:
+	/// <summary>
+	/// カイザー窓の半径(縮小後のピクセル数)
+	/// </summary>
+	static constexpr float kKaiserRadius = 2.0f;
+	/// <summary>
+	/// カイザー窓の形(大きいほど窓の端が小さくなる)
+	/// </summary>
+	static constexpr float kKaiserAlpha = 4.0f;
+
+public:
+	/// <summary>
+	/// ミップマップを作る
+	/// </summary>
+	/// <param name="pixels">sRGBのRGBA8の画像</param>
+	/// <param name="width">幅</param>
+	/// <param name="height">高さ</param>
+	/// <param name="rowPitch">1行のバイト数</param>
+	/// <param name="filter">縮小に使うフィルター</param>
+	/// <param name="threadNum">使うスレッド数(0ならハードウェアのスレッド数)</param>
+	/// <returns>1番から1x1までのミップ(0番は元の画像なので含めない。引数が不正なら空)</returns>
+	static std::vector<Mip> Generate(
+		std::span<const uint8_t> pixels,
+		uint32_t width,
+		uint32_t height,
+		size_t rowPitch,
+		Filter filter = Filter::Box,
+		uint32_t threadNum = 0
+	);
+
+	/// <summary>
+	/// 0番も含めた1x1までのミップの数
+	/// </summary>
+	static uint32_t CalcMipNum(uint32_t width, uint32_t height);
+};
@@ -0,0 +1,854 @@
+#include "BlockCompressor.h"
+#include <array>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+	using Pixel = std::array<float, 4>;
+	using BlockPixels = std::array<Pixel, kBlockPixelNum>;
+
+	/// <summary>
+	/// 端点を最小二乗法で詰め直す回数
+	/// </summary>
+	constexpr uint32_t kRefineNum = 2;
+	/// <summary>
+	/// 1スレッドに任せるブロックの最小の行数(小さい画像はスレッドを作る方が遅い)
+	/// </summary>
+	constexpr uint32_t kMinBlockRowPerThread = 8;
+
+	constexpr std::array<uint32_t, 16> kBC7Weights = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+	constexpr uint8_t kBC7Mode6 = 0x40;
+
+	/// <summary>
+	/// 下位ビットから順に書き込む
+	/// </summary>
+	class BitWriter {
+	public:
+		BitWriter(std::span<uint8_t, 16> data_) :
+			data(data_),
+			pos(0)
+		{
+			std::fill(data.begin(), data.end(), uint8_t(0));
+		}
+
+		void Write(uint32_t value, uint32_t bitNum) {
+			for (uint32_t i = 0; i < bitNum; i++, pos++) {
+				data[pos >> 3] |= static_cast<uint8_t>(((value >> i) & 1u) << (pos & 7u));
+			}
+		}
+
+	private:
+		std::span<uint8_t, 16> data;
+		uint32_t pos;
+	};
+
+	class BitReader {
+	public:
+		BitReader(std::span<const uint8_t, 16> data_) :
+			data(data_),
+			pos(0)
+		{}
+
+		uint32_t Read(uint32_t bitNum) {
+			uint32_t value = 0;
+			for (uint32_t i = 0; i < bitNum; i++, pos++) {
+				value |= static_cast<uint32_t>((data[pos >> 3] >> (pos & 7u)) & 1u) << i;
+			}
+			return value;
+		}
+
+	private:
+		std::span<const uint8_t, 16> data;
+		uint32_t pos;
+	};
+
+	BlockPixels LoadPixels(std::span<const uint8_t, kBlockPixelNum * 4> pixels) {
+		BlockPixels result;
+		for (size_t i = 0; i < kBlockPixelNum; i++) {
+			for (size_t c = 0; c < 4; c++) {
+				result[i][c] = static_cast<float>(pixels[i * 4 + c]);
+			}
+		}
+		return result;
+	}
+
+	float Square(float value) {
+		return value * value;
+	}
+
+	/// <summary>
+	/// 主成分の方向(べき乗法)。全て同じ色ならゼロベクトル
+	/// </summary>
+	Pixel CalcPrincipalAxis(const BlockPixels& pixels, size_t channelNum, Pixel& mean) {
+		mean = {};
+		for (auto& pixel : pixels) {
+			for (size_t c = 0; c < channelNum; c++) {
+				mean[c] += pixel[c];
+			}
+		}
+		for (size_t c = 0; c < channelNum; c++) {
+			mean[c] /= static_cast<float>(kBlockPixelNum);
+		}
+
+		std::array<std::array<float, 4>, 4> covariance{};
+		for (auto& pixel : pixels) {
+			for (size_t row = 0; row < channelNum; row++) {
+				for (size_t column = 0; column < channelNum; column++) {
+					covariance[row][column] += (pixel[row] - mean[row]) * (pixel[column] - mean[column]);
+				}
+			}
+		}
+
+		// 分散が一番大きい成分の行から始める
+		size_t maxRow = 0;
+		for (size_t c = 1; c < channelNum; c++) {
+			if (covariance[maxRow][maxRow] < covariance[c][c]) {
+				maxRow = c;
+			}
+		}
+		if (covariance[maxRow][maxRow] < 1.0e-4f) {
+			return Pixel{};
+		}
+
+		Pixel axis = covariance[maxRow];
+		for (int iteration = 0; iteration < 8; iteration++) {
+			Pixel next{};
+			float maxComponent = 0.0f;
+			for (size_t row = 0; row < channelNum; row++) {
+				for (size_t column = 0; column < channelNum; column++) {
+					next[row] += covariance[row][column] * axis[column];
+				}
+				maxComponent = std::max(maxComponent, std::abs(next[row]));
+			}
+			if (maxComponent < 1.0e-8f) {
+				return Pixel{};
+			}
+			for (size_t c = 0; c < channelNum; c++) {
+				axis[c] = next[c] / maxComponent;
+			}
+		}
+
+		float length = 0.0f;
+		for (size_t c = 0; c < channelNum; c++) {
+			length += Square(axis[c]);
+		}
+		length = std::sqrt(length);
+		for (size_t c = 0; c < channelNum; c++) {
+			axis[c] /= length;
+		}
+		return axis;
+	}
+
+	/// <summary>
+	/// 主成分の方向で一番外側にあるピクセルの位置を端点にする
+	/// </summary>
+	void CalcEndpoints(const BlockPixels& pixels, size_t channelNum, const Pixel& mean, const Pixel& axis, Pixel& endpoint0, Pixel& endpoint1) {
+		float minT = std::numeric_limits<float>::max();
+		float maxT = std::numeric_limits<float>::lowest();
+		for (auto& pixel : pixels) {
+			float t = 0.0f;
+			for (size_t c = 0; c < channelNum; c++) {
+				t += (pixel[c] - mean[c]) * axis[c];
+			}
+			minT = std::min(minT, t);
+			maxT = std::max(maxT, t);
+		}
+		for (size_t c = 0; c < channelNum; c++) {
+			endpoint0[c] = std::clamp(mean[c] + axis[c] * minT, 0.0f, 255.0f);
+			endpoint1[c] = std::clamp(mean[c] + axis[c] * maxT, 0.0f, 255.0f);
+		}
+	}
+
+	/// <summary>
+	/// pixel = endpoint0 * (1 - weight) + endpoint1 * weight になるように最小二乗法で端点を求める
+	/// </summary>
+	/// <returns>解けたか(全て同じ重みなら解けない)</returns>
+	bool SolveEndpoints(const BlockPixels& pixels, const std::array<float, kBlockPixelNum>& weights, size_t channelNum, Pixel& endpoint0, Pixel& endpoint1) {
+		float aa = 0.0f;
+		float ab = 0.0f;
+		float bb = 0.0f;
+		Pixel ax{};
+		Pixel bx{};
+		for (size_t i = 0; i < kBlockPixelNum; i++) {
+			const float b = weights[i];
+			const float a = 1.0f - b;
+			aa += a * a;
+			ab += a * b;
+			bb += b * b;
+			for (size_t c = 0; c < channelNum; c++) {
+				ax[c] += a * pixels[i][c];
+				bx[c] += b * pixels[i][c];
+			}
+		}
+
+		const float det = aa * bb - ab * ab;
+		if (std::abs(det) < 1.0e-6f) {
+			return false;
+		}
+		for (size_t c = 0; c < channelNum; c++) {
+			endpoint0[c] = std::clamp((ax[c] * bb - bx[c] * ab) / det, 0.0f, 255.0f);
+			endpoint1[c] = std::clamp((bx[c] * aa - ax[c] * ab) / det, 0.0f, 255.0f);
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// BC1、BC3の色のブロック
+	/// </summary>
+	namespace ColorBlock {
+		constexpr std::array<float, 4> kWeights = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+
+		uint32_t Expand5(uint32_t value) {
+			return (value << 3) | (value >> 2);
+		}
+		uint32_t Expand6(uint32_t value) {
+			return (value << 2) | (value >> 4);
+		}
+
+		uint16_t Pack(const Pixel& color) {
+			const uint32_t r = static_cast<uint32_t>(std::lround(color[0] * 31.0f / 255.0f));
+			const uint32_t g = static_cast<uint32_t>(std::lround(color[1] * 63.0f / 255.0f));
+			const uint32_t b = static_cast<uint32_t>(std::lround(color[2] * 31.0f / 255.0f));
+			return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+		}
+
+		std::array<uint32_t, 3> Unpack(uint16_t color) {
+			return { Expand5(color >> 11), Expand6((color >> 5) & 0x3fu), Expand5(color & 0x1fu) };
+		}
+
+		/// <summary>
+		/// 4色の時のパレット(3色の時はisFourColorをfalseにする)
+		/// </summary>
+		std::array<std::array<uint32_t, 3>, 4> MakePalette(uint16_t color0, uint16_t color1, bool isFourColor) {
+			std::array<std::array<uint32_t, 3>, 4> palette;
+			palette[0] = Unpack(color0);
+			palette[1] = Unpack(color1);
+			for (size_t c = 0; c < 3; c++) {
+				if (isFourColor) {
+					palette[2][c] = (2 * palette[0][c] + palette[1][c] + 1) / 3;
+					palette[3][c] = (palette[0][c] + 2 * palette[1][c] + 1) / 3;
+				}
+				else {
+					palette[2][c] = (palette[0][c] + palette[1][c] + 1) / 2;
+					palette[3][c] = 0;
+				}
+			}
+			return palette;
+		}
+
+		/// <summary>
+		/// 一番近いパレットの色を選ぶ
+		/// </summary>
+		/// <returns>二乗誤差の合計</returns>
+		float FindIndices(const BlockPixels& pixels, uint16_t color0, uint16_t color1, uint32_t& indices) {
+			const auto palette = MakePalette(color0, color1, true);
+			float error = 0.0f;
+			indices = 0;
+			for (size_t i = 0; i < kBlockPixelNum; i++) {
+				float bestError = std::numeric_limits<float>::max();
+				uint32_t bestIndex = 0;
+				for (uint32_t index = 0; index < 4; index++) {
+					float indexError = 0.0f;
+					for (size_t c = 0; c < 3; c++) {
+						indexError += Square(pixels[i][c] - static_cast<float>(palette[index][c]));
+					}
+					if (indexError < bestError) {
+						bestError = indexError;
+						bestIndex = index;
+					}
+				}
+				error += bestError;
+				indices |= bestIndex << (i * 2);
+			}
+			return error;
+		}
+
+		/// <summary>
+		/// 1色だけを表す時に、2:1で補間した色が一番近くなる端点の組
+		/// </summary>
+		struct SingleColorTable {
+			std::array<std::array<uint8_t, 2>, 256> red;
+			std::array<std::array<uint8_t, 2>, 256> green;
+		};
+
+		std::array<std::array<uint8_t, 2>, 256> MakeSingleColorTable(uint32_t bitNum) {
+			std::array<std::array<uint8_t, 2>, 256> table;
+			const uint32_t maxValue = (1u << bitNum) - 1u;
+			for (int value = 0; value < 256; value++) {
+				int bestError = std::numeric_limits<int>::max();
+				for (uint32_t endpoint0 = 0; endpoint0 <= maxValue; endpoint0++) {
+					for (uint32_t endpoint1 = 0; endpoint1 <= maxValue; endpoint1++) {
+						const uint32_t expand0 = bitNum == 5 ? Expand5(endpoint0) : Expand6(endpoint0);
+						const uint32_t expand1 = bitNum == 5 ? Expand5(endpoint1) : Expand6(endpoint1);
+						const int error = std::abs(static_cast<int>((2 * expand0 + expand1 + 1) / 3) - value);
+						if (error < bestError) {
+							bestError = error;
+							table[value] = { static_cast<uint8_t>(endpoint0), static_cast<uint8_t>(endpoint1) };
+						}
+					}
+				}
+			}
+			return table;
+		}
+
+		const SingleColorTable& GetSingleColorTable() {
+			static const SingleColorTable table = { MakeSingleColorTable(5), MakeSingleColorTable(6) };
+			return table;
+		}
+
+		/// <summary>
+		/// 全てのピクセルを1色で表す
+		/// </summary>
+		float EncodeSingleColor(const BlockPixels& pixels, const Pixel& color, uint16_t& color0, uint16_t& color1, uint32_t& indices) {
+			const SingleColorTable& table = GetSingleColorTable();
+			const auto& red = table.red[static_cast<size_t>(std::lround(color[0]))];
+			const auto& green = table.green[static_cast<size_t>(std::lround(color[1]))];
+			const auto& blue = table.red[static_cast<size_t>(std::lround(color[2]))];
+			color0 = static_cast<uint16_t>((red[0] << 11) | (green[0] << 5) | blue[0]);
+			color1 = static_cast<uint16_t>((red[1] << 11) | (green[1] << 5) | blue[1]);
+			if (color0 < color1) {
+				std::swap(color0, color1);
+			}
+			return FindIndices(pixels, color0, color1, indices);
+		}
+
+		/// <summary>
+		/// 4色のモードで圧縮する(color0 <= color1になるのは全て同じ色の時だけで、その時はインデックスを0にする)
+		/// </summary>
+		void Encode(const BlockPixels& pixels, uint16_t& color0, uint16_t& color1, uint32_t& indices) {
+			Pixel mean{};
+			const Pixel axis = CalcPrincipalAxis(pixels, 3, mean);
+			float bestError = EncodeSingleColor(pixels, mean, color0, color1, indices);
+			if (bestError == 0.0f || axis == Pixel{}) {
+				return;
+			}
+
+			Pixel endpoint0{};
+			Pixel endpoint1{};
+			CalcEndpoints(pixels, 3, mean, axis, endpoint0, endpoint1);
+			for (uint32_t refine = 0; refine <= kRefineNum; refine++) {
+				uint16_t packed0 = Pack(endpoint0);
+				uint16_t packed1 = Pack(endpoint1);
+				if (packed0 < packed1) {
+					std::swap(packed0, packed1);
+					std::swap(endpoint0, endpoint1);
+				}
+
+				uint32_t candidateIndices = 0;
+				const float error = FindIndices(pixels, packed0, packed1, candidateIndices);
+				if (error < bestError) {
+					bestError = error;
+					color0 = packed0;
+					color1 = packed1;
+					indices = candidateIndices;
+				}
+				if (bestError == 0.0f || packed0 == packed1 || refine == kRefineNum) {
+					break;
+				}
+
+				std::array<float, kBlockPixelNum> weights;
+				for (size_t i = 0; i < kBlockPixelNum; i++) {
+					weights[i] = kWeights[(candidateIndices >> (i * 2)) & 3u];
+				}
+				if (!SolveEndpoints(pixels, weights, 3, endpoint0, endpoint1)) {
+					break;
+				}
+			}
+
+			if (color0 == color1) {
+				indices = 0;
+			}
+		}
+
+		void Write(uint16_t color0, uint16_t color1, uint32_t indices, std::span<uint8_t, 8> block) {
+			block[0] = static_cast<uint8_t>(color0 & 0xffu);
+			block[1] = static_cast<uint8_t>(color0 >> 8);
+			block[2] = static_cast<uint8_t>(color1 & 0xffu);
+			block[3] = static_cast<uint8_t>(color1 >> 8);
+			for (size_t i = 0; i < 4; i++) {
+				block[4 + i] = static_cast<uint8_t>((indices >> (i * 8)) & 0xffu);
+			}
+		}
+
+		void Decode(std::span<const uint8_t, 8> block, bool isAlwaysFourColor, std::span<uint8_t, kBlockPixelNum * 4> pixels) {
+			const uint16_t color0 = static_cast<uint16_t>(block[0] | (block[1] << 8));
+			const uint16_t color1 = static_cast<uint16_t>(block[2] | (block[3] << 8));
+			const uint32_t indices = static_cast<uint32_t>(block[4]) | (static_cast<uint32_t>(block[5]) << 8)
+				| (static_cast<uint32_t>(block[6]) << 16) | (static_cast<uint32_t>(block[7]) << 24);
+			const bool isFourColor = isAlwaysFourColor || color1 < color0;
+			const auto palette = MakePalette(color0, color1, isFourColor);
+
+			for (size_t i = 0; i < kBlockPixelNum; i++) {
+				const uint32_t index = (indices >> (i * 2)) & 3u;
+				for (size_t c = 0; c < 3; c++) {
+					pixels[i * 4 + c] = static_cast<uint8_t>(palette[index][c]);
+				}
+				// 3色のモードの3番は透明な黒
+				pixels[i * 4 + 3] = (!isFourColor && index == 3) ? 0 : 255;
+			}
+		}
+	}
+
+	/// <summary>
+	/// BC3(BC4)のアルファのブロック
+	/// </summary>
+	namespace AlphaBlock {
+		/// <summary>
+		/// alpha0 > alpha1なら8段階、そうでなければ6段階と0と255
+		/// </summary>
+		std::array<uint32_t, 8> MakePalette(uint32_t alpha0, uint32_t alpha1) {
+			std::array<uint32_t, 8> palette;
+			palette[0] = alpha0;
+			palette[1] = alpha1;
+			if (alpha1 < alpha0) {
+				for (uint32_t i = 2; i < 8; i++) {
+					palette[i] = ((8 - i) * alpha0 + (i - 1) * alpha1 + 3) / 7;
+				}
+			}
+			else {
+				for (uint32_t i = 2; i < 6; i++) {
+					palette[i] = ((6 - i) * alpha0 + (i - 1) * alpha1 + 2) / 5;
+				}
+				palette[6] = 0;
+				palette[7] = 255;
+			}
+			return palette;
+		}
+
+		uint32_t FindIndices(const BlockPixels& pixels, uint32_t alpha0, uint32_t alpha1, uint64_t& indices) {
+			const auto palette = MakePalette(alpha0, alpha1);
+			uint32_t error = 0;
+			indices = 0;
+			for (size_t i = 0; i < kBlockPixelNum; i++) {
+				const int alpha = static_cast<int>(pixels[i][3]);
+				uint32_t bestError = std::numeric_limits<uint32_t>::max();
+				uint64_t bestIndex = 0;
+				for (uint32_t index = 0; index < 8; index++) {
+					const int diff = alpha - static_cast<int>(palette[index]);
+					const uint32_t indexError = static_cast<uint32_t>(diff * diff);
+					if (indexError < bestError) {
+						bestError = indexError;
+						bestIndex = index;
+					}
+				}
+				error += bestError;
+				indices |= bestIndex << (i * 3);
+			}
+			return error;
+		}
+
+		void Encode(const BlockPixels& pixels, std::span<uint8_t, 8> block) {
+			uint32_t minAlpha = 255;
+			uint32_t maxAlpha = 0;
+			// 0と255を除いた範囲(6段階のモードは0と255を別に持っている)
+			uint32_t innerMinAlpha = 255;
+			uint32_t innerMaxAlpha = 0;
+			for (auto& pixel : pixels) {
+				const uint32_t alpha = static_cast<uint32_t>(pixel[3]);
+				minAlpha = std::min(minAlpha, alpha);
+				maxAlpha = std::max(maxAlpha, alpha);
+				if (alpha != 0 && alpha != 255) {
+					innerMinAlpha = std::min(innerMinAlpha, alpha);
+					innerMaxAlpha = std::max(innerMaxAlpha, alpha);
+				}
+			}
+			if (innerMaxAlpha < innerMinAlpha) {
+				innerMinAlpha = innerMaxAlpha = 0;
+			}
+
+			uint32_t alpha0 = maxAlpha;
+			uint32_t alpha1 = minAlpha;
+			uint64_t indices = 0;
+			if (minAlpha != maxAlpha) {
+				const uint32_t error = FindIndices(pixels, alpha0, alpha1, indices);
+
+				uint64_t innerIndices = 0;
+				const uint32_t innerError = FindIndices(pixels, innerMinAlpha, innerMaxAlpha, innerIndices);
+				if (innerError < error) {
+					alpha0 = innerMinAlpha;
+					alpha1 = innerMaxAlpha;
+					indices = innerIndices;
+				}
+			}
+
+			block[0] = static_cast<uint8_t>(alpha0);
+			block[1] = static_cast<uint8_t>(alpha1);
+			for (size_t i = 0; i < 6; i++) {
+				block[2 + i] = static_cast<uint8_t>((indices >> (i * 8)) & 0xffu);
+			}
+		}
+
+		void Decode(std::span<const uint8_t, 8> block, std::span<uint8_t, kBlockPixelNum * 4> pixels) {
+			const auto palette = MakePalette(block[0], block[1]);
+			uint64_t indices = 0;
+			for (size_t i = 0; i < 6; i++) {
+				indices |= static_cast<uint64_t>(block[2 + i]) << (i * 8);
+			}
+			for (size_t i = 0; i < kBlockPixelNum; i++) {
+				pixels[i * 4 + 3] = static_cast<uint8_t>(palette[(indices >> (i * 3)) & 7u]);
+			}
+		}
+	}
+
+	/// <summary>
+	/// BC7のモード6
+	/// </summary>
+	namespace BC7Mode6 {
+		using Endpoint = std::array<uint32_t, 4>;
+
+		/// <summary>
+		/// 7bitの値とpビットから8bitの端点を作る時に、一番近くなる7bitの値
+		/// </summary>
+		Endpoint Quantize(const Pixel& endpoint, uint32_t pBit) {
+			Endpoint result;
+			for (size_t c = 0; c < 4; c++) {
+				const long value = std::lround((endpoint[c] - static_cast<float>(pBit)) * 0.5f);
+				result[c] = static_cast<uint32_t>(std::clamp(value, 0l, 127l));
+			}
+			return result;
+		}
+
+		Endpoint Expand(const Endpoint& endpoint, uint32_t pBit) {
+			Endpoint result;
+			for (size_t c = 0; c < 4; c++) {
+				result[c] = (endpoint[c] << 1) | pBit;
+			}
+			return result;
+		}
+
+		std::array<Endpoint, 16> MakePalette(const Endpoint& endpoint0, const Endpoint& endpoint1) {
+			std::array<Endpoint, 16> palette;
+			for (size_t index = 0; index < 16; index++) {
+				for (size_t c = 0; c < 4; c++) {
+					palette[index][c] = ((64 - kBC7Weights[index]) * endpoint0[c] + kBC7Weights[index] * endpoint1[c] + 32) >> 6;
+				}
+			}
+			return palette;
+		}
+
+		/// <summary>
+		/// 補間の重み(0～64)に一番近いインデックス
+		/// </summary>
+		std::array<uint8_t, 65> MakeNearestIndexTable() {
+			std::array<uint8_t, 65> table{};
+			for (uint32_t weight = 0; weight <= 64; weight++) {
+				for (uint8_t index = 1; index < 16; index++) {
+					if (std::abs(static_cast<int>(kBC7Weights[index]) - static_cast<int>(weight)) < std::abs(static_cast<int>(kBC7Weights[table[weight]]) - static_cast<int>(weight))) {
+						table[weight] = index;
+					}
+				}
+			}
+			return table;
+		}
+
+		uint32_t FindIndices(const BlockPixels& pixels, const Endpoint& endpoint0, const Endpoint& endpoint1, std::array<uint8_t, kBlockPixelNum>& indices) {
+			static const std::array<uint8_t, 65> nearestIndexTable = MakeNearestIndexTable();
+
+			const auto palette = MakePalette(endpoint0, endpoint1);
+			Pixel direction{};
+			float lengthSquared = 0.0f;
+			for (size_t c = 0; c < 4; c++) {
+				direction[c] = static_cast<float>(endpoint1[c]) - static_cast<float>(endpoint0[c]);
+				lengthSquared += Square(direction[c]);
+			}
+			const float weightScale = 0.0f < lengthSquared ? 64.0f / lengthSquared : 0.0f;
+
+			uint32_t error = 0;
+			for (size_t i = 0; i < kBlockPixelNum; i++) {
+				// 端点を結ぶ線に射影して、前後のインデックスだけを調べる
+				float t = 0.0f;
+				for (size_t c = 0; c < 4; c++) {
+					t += (pixels[i][c] - static_cast<float>(endpoint0[c])) * direction[c];
+				}
+				const uint8_t nearestIndex = nearestIndexTable[static_cast<size_t>(std::clamp(std::lround(t * weightScale), 0l, 64l))];
+				const uint8_t firstIndex = static_cast<uint8_t>(std::max(nearestIndex, uint8_t(1)) - 1);
+				const uint8_t lastIndex = std::min(nearestIndex, uint8_t(14)) + 1;
+
+				uint32_t bestError = std::numeric_limits<uint32_t>::max();
+				for (uint8_t index = firstIndex; index <= lastIndex; index++) {
+					uint32_t indexError = 0;
+					for (size_t c = 0; c < 4; c++) {
+						const int diff = static_cast<int>(pixels[i][c]) - static_cast<int>(palette[index][c]);
+						indexError += static_cast<uint32_t>(diff * diff);
+					}
+					if (indexError < bestError) {
+						bestError = indexError;
+						indices[i] = index;
+					}
+				}
+				error += bestError;
+			}
+			return error;
+		}
+
+		void Encode(const BlockPixels& pixels, std::span<uint8_t, 16> block) {
+			Pixel mean{};
+			const Pixel axis = CalcPrincipalAxis(pixels, 4, mean);
+			Pixel endpoint0 = mean;
+			Pixel endpoint1 = mean;
+			if (axis != Pixel{}) {
+				CalcEndpoints(pixels, 4, mean, axis, endpoint0, endpoint1);
+			}
+
+			// 不透明なブロックは両方のpビットを1、αを127にして、255がそのまま出るようにする
+			const bool isOpaque = std::all_of(pixels.begin(), pixels.end(), [](const Pixel& pixel) { return pixel[3] == 255.0f; });
+
+			uint32_t bestError = std::numeric_limits<uint32_t>::max();
+			Endpoint bestEndpoint0{};
+			Endpoint bestEndpoint1{};
+			std::array<uint32_t, 2> bestPBits{};
+			std::array<uint8_t, kBlockPixelNum> bestIndices{};
+			for (uint32_t refine = 0; refine <= kRefineNum; refine++) {
+				// pビットの組み合わせを全て試す
+				uint32_t refineError = std::numeric_limits<uint32_t>::max();
+				std::array<uint8_t, kBlockPixelNum> refineIndices{};
+				for (uint32_t pBit = isOpaque ? 3u : 0u; pBit < 4; pBit++) {
+					const uint32_t pBit0 = pBit & 1u;
+					const uint32_t pBit1 = pBit >> 1;
+					Endpoint quantized0 = Quantize(endpoint0, pBit0);
+					Endpoint quantized1 = Quantize(endpoint1, pBit1);
+					if (isOpaque) {
+						quantized0[3] = 127u;
+						quantized1[3] = 127u;
+					}
+
+					std::array<uint8_t, kBlockPixelNum> indices{};
+					const uint32_t error = FindIndices(pixels, Expand(quantized0, pBit0), Expand(quantized1, pBit1), indices);
+					if (error < refineError) {
+						refineError = error;
+						refineIndices = indices;
+					}
+					if (error < bestError) {
+						bestError = error;
+						bestEndpoint0 = quantized0;
+						bestEndpoint1 = quantized1;
+						bestPBits = { pBit0, pBit1 };
+						bestIndices = indices;
+					}
+				}
+				if (bestError == 0 || refine == kRefineNum) {
+					break;
+				}
+
+				std::array<float, kBlockPixelNum> weights;
+				for (size_t i = 0; i < kBlockPixelNum; i++) {
+					weights[i] = static_cast<float>(kBC7Weights[refineIndices[i]]) / 64.0f;
+				}
+				if (!SolveEndpoints(pixels, weights, 4, endpoint0, endpoint1)) {
+					break;
+				}
+			}
+
+			// 最初のインデックスの最上位ビットは省略するので、0になるように端点を入れ替える
+			if (8 <= bestIndices[0]) {
+				std::swap(bestEndpoint0, bestEndpoint1);
+				std::swap(bestPBits[0], bestPBits[1]);
+				for (auto& index : bestIndices) {
+					index = static_cast<uint8_t>(15 - index);
+				}
+			}
+
+			BitWriter writer(block);
+			writer.Write(kBC7Mode6, 7);
+			for (size_t c = 0; c < 4; c++) {
+				writer.Write(bestEndpoint0[c], 7);
+				writer.Write(bestEndpoint1[c], 7);
+			}
+			writer.Write(bestPBits[0], 1);
+			writer.Write(bestPBits[1], 1);
+			writer.Write(bestIndices[0], 3);
+			for (size_t i = 1; i < kBlockPixelNum; i++) {
+				writer.Write(bestIndices[i], 4);
+			}
+		}
+
+		void Decode(std::span<const uint8_t, 16> block, std::span<uint8_t, kBlockPixelNum * 4> pixels) {
+			BitReader reader(block);
+			if (reader.Read(7) != kBC7Mode6) {
+				std::fill(pixels.begin(), pixels.end(), uint8_t(0));
+				return;
+			}
+
+			Endpoint endpoint0;
+			Endpoint endpoint1;
+			for (size_t c = 0; c < 4; c++) {
+				endpoint0[c] = reader.Read(7);
+				endpoint1[c] = reader.Read(7);
+			}
+			const uint32_t pBit0 = reader.Read(1);
+			const uint32_t pBit1 = reader.Read(1);
+			const auto palette = MakePalette(Expand(endpoint0, pBit0), Expand(endpoint1, pBit1));
+
+			for (size_t i = 0; i < kBlockPixelNum; i++) {
+				const uint32_t index = reader.Read(i == 0 ? 3 : 4);
+				for (size_t c = 0; c < 4; c++) {
+					pixels[i * 4 + c] = static_cast<uint8_t>(palette[index][c]);
+				}
+			}
+		}
+	}
+
+	/// <summary>
+	/// ブロックの行を分けて並列に処理する
+	/// </summary>
+	template<class Func>
+	void ForEachBlockRow(uint32_t blockHeight, uint32_t threadNum, Func func) {
+		if (threadNum == 0) {
+			threadNum = std::max(std::thread::hardware_concurrency(), 1u);
+		}
+		threadNum = std::clamp(blockHeight / kMinBlockRowPerThread, 1u, threadNum);
+		if (threadNum == 1) {
+			func(0u, blockHeight);
+			return;
+		}
+
+		std::vector<std::thread> threads;
+		threads.reserve(threadNum);
+		for (uint32_t i = 0; i < threadNum; i++) {
+			threads.emplace_back(func, blockHeight * i / threadNum, blockHeight * (i + 1) / threadNum);
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+	}
+}
+
+size_t GetBlockSize(BlockFormat format) {
+	return format == BlockFormat::BC1 ? 8 : 16;
+}
+
+size_t CalcCompressedRowPitch(BlockFormat format, uint32_t width) {
+	return static_cast<size_t>(std::max((width + 3u) / 4u, 1u)) * GetBlockSize(format);
+}
+
+size_t CalcCompressedSize(BlockFormat format, uint32_t width, uint32_t height) {
+	return CalcCompressedRowPitch(format, width) * std::max((height + 3u) / 4u, 1u);
+}
+
+void EncodeBC1Block(std::span<const uint8_t, kBlockPixelNum * 4> pixels, std::span<uint8_t, 8> block) {
+	const BlockPixels blockPixels = LoadPixels(pixels);
+	uint16_t color0 = 0;
+	uint16_t color1 = 0;
+	uint32_t indices = 0;
+	ColorBlock::Encode(blockPixels, color0, color1, indices);
+	ColorBlock::Write(color0, color1, indices, block);
+}
+
+void EncodeBC3Block(std::span<const uint8_t, kBlockPixelNum * 4> pixels, std::span<uint8_t, 16> block) {
+	const BlockPixels blockPixels = LoadPixels(pixels);
+	AlphaBlock::Encode(blockPixels, block.first<8>());
+
+	uint16_t color0 = 0;
+	uint16_t color1 = 0;
+	uint32_t indices = 0;
+	ColorBlock::Encode(blockPixels, color0, color1, indices);
+	ColorBlock::Write(color0, color1, indices, block.last<8>());
+}
+
+void EncodeBC7Block(std::span<const uint8_t, kBlockPixelNum * 4> pixels, std::span<uint8_t, 16> block) {
+	BC7Mode6::Encode(LoadPixels(pixels), block);
+}
+
+void DecodeBC1Block(std::span<const uint8_t, 8> block, std::span<uint8_t, kBlockPixelNum * 4> pixels) {
+	ColorBlock::Decode(block, false, pixels);
+}
+
+void DecodeBC3Block(std::span<const uint8_t, 16> block, std::span<uint8_t, kBlockPixelNum * 4> pixels) {
+	ColorBlock::Decode(block.last<8>(), true, pixels);
+	AlphaBlock::Decode(block.first<8>(), pixels);
+}
+
+void DecodeBC7Block(std::span<const uint8_t, 16> block, std::span<uint8_t, kBlockPixelNum * 4> pixels) {
+	BC7Mode6::Decode(block, pixels);
+}
+
+bool CompressImage(BlockFormat format, std::span<const uint8_t> pixels, uint32_t width, uint32_t height, size_t rowPitch, std::span<uint8_t> blocks, uint32_t threadNum) {
+	if (width == 0 || height == 0 || rowPitch < static_cast<size_t>(width) * 4
+		|| pixels.size() < rowPitch * (height - 1) + static_cast<size_t>(width) * 4
+		|| blocks.size() < CalcCompressedSize(format, width, height)
+	) {
+		return false;
+	}
+
+	const uint32_t blockWidth = (width + 3u) / 4u;
+	const uint32_t blockHeight = (height + 3u) / 4u;
+	const size_t blockSize = GetBlockSize(format);
+	const size_t blockRowPitch = CalcCompressedRowPitch(format, width);
+
+	ForEachBlockRow(blockHeight, threadNum,
+		[&](uint32_t begin, uint32_t end) {
+			std::array<uint8_t, kBlockPixelNum * 4> blockPixels;
+			for (uint32_t blockY = begin; blockY < end; blockY++) {
+				for (uint32_t blockX = 0; blockX < blockWidth; blockX++) {
+					for (uint32_t y = 0; y < 4; y++) {
+						const size_t row = std::min(blockY * 4 + y, height - 1);
+						for (uint32_t x = 0; x < 4; x++) {
+							const size_t column = std::min(blockX * 4 + x, width - 1);
+							std::copy_n(pixels.data() + row * rowPitch + column * 4, 4, blockPixels.data() + (y * 4 + x) * 4);
+						}
+					}
+
+					auto block = blocks.subspan(blockY * blockRowPitch + blockX * blockSize);
+					switch (format) {
+					case BlockFormat::BC1:
+						EncodeBC1Block(blockPixels, block.first<8>());
+						break;
+					case BlockFormat::BC3:
+						EncodeBC3Block(blockPixels, block.first<16>());
+						break;
+					case BlockFormat::BC7:
+					default:
+						EncodeBC7Block(blockPixels, block.first<16>());
+						break;
+					}
+				}
+			}
+		}
+	);
+
+	return true;
+}
+
+bool DecompressImage(BlockFormat format, std::span<const uint8_t> blocks, uint32_t width, uint32_t height, std::span<uint8_t> pixels, size_t rowPitch) {
+	if (width == 0 || height == 0 || rowPitch < static_cast<size_t>(width) * 4
+		|| pixels.size() < rowPitch * (height - 1) + static_cast<size_t>(width) * 4
+		|| blocks.size() < CalcCompressedSize(format, width, height)
+	) {
+		return false;
+	}
+
+	const uint32_t blockWidth = (width + 3u) / 4u;
+	const uint32_t blockHeight = (height + 3u) / 4u;
+	const size_t blockSize = GetBlockSize(format);
+	const size_t blockRowPitch = CalcCompressedRowPitch(format, width);
+
+	std::array<uint8_t, kBlockPixelNum * 4> blockPixels;
+	for (uint32_t blockY = 0; blockY < blockHeight; blockY++) {
+		for (uint32_t blockX = 0; blockX < blockWidth; blockX++) {
+			auto block = blocks.subspan(blockY * blockRowPitch + blockX * blockSize);
+			switch (format) {
+			case BlockFormat::BC1:
+				DecodeBC1Block(block.first<8>(), blockPixels);
+				break;
+			case BlockFormat::BC3:
+				DecodeBC3Block(block.first<16>(), blockPixels);
+				break;
+			case BlockFormat::BC7:
+			default:
+				DecodeBC7Block(block.first<16>(), blockPixels);
+				break;
+			}
+
+			for (uint32_t y = 0; y < 4 && blockY * 4 + y < height; y++) {
+				for (uint32_t x = 0; x < 4 && blockX * 4 + x < width; x++) {
+					std::copy_n(blockPixels.data() + (y * 4 + x) * 4, 4, pixels.data() + (blockY * 4 + y) * rowPitch + (blockX * 4 + x) * 4);
+				}
+			}
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include <span>
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// ブロック圧縮の形式(全て4x4ピクセルを1ブロックにする)
+/// </summary>
+enum class BlockFormat : uint32_t {
+	/// <summary>
+	/// RGB565の端点2つと2bitのインデックス(8バイト。アルファは使わない)
+	/// </summary>
+	BC1,
+	/// <summary>
+	/// BC4と同じアルファのブロックとBC1の色のブロック(16バイト)
+	/// </summary>
+	BC3,
+	/// <summary>
+	/// モード6だけを使う(RGBA7777とpビットの端点2つと4bitのインデックス。16バイト)
+	/// </summary>
+	BC7
+};
+
+/// <summary>
+/// 1ブロックのピクセル数
+/// </summary>
+inline constexpr size_t kBlockPixelNum = 16;
+
+/// <summary>
+/// 1ブロックのバイト数
+/// </summary>
+size_t GetBlockSize(BlockFormat format);
+
+/// <summary>
+/// 圧縮後の1行(ブロック1列分)のバイト数
+/// </summary>
+size_t CalcCompressedRowPitch(BlockFormat format, uint32_t width);
+
+/// <summary>
+/// 圧縮後のバイト数
+/// </summary>
+size_t CalcCompressedSize(BlockFormat format, uint32_t width, uint32_t height);
+
+/// <summary>
+/// 1ブロックをBC1に圧縮する(主成分の方向に端点を取り、最小二乗法で詰める)
+/// </summary>
+/// <param name="pixels">左上から行ごとに並べた16ピクセルのRGBA8</param>
+/// <param name="block">書き込み先</param>
+void EncodeBC1Block(std::span<const uint8_t, kBlockPixelNum * 4> pixels, std::span<uint8_t, 8> block);
+
+/// <summary>
+/// 1ブロックをBC3に圧縮する
+/// </summary>
+/// <param name="pixels">左上から行ごとに並べた16ピクセルのRGBA8</param>
+/// <param name="block">書き込み先</param>
+void EncodeBC3Block(std::span<const uint8_t, kBlockPixelNum * 4> pixels, std::span<uint8_t, 16> block);
+
+/// <summary>
+/// 1ブロックをBC7のモード6で圧縮する
+/// </summary>
+/// <param name="pixels">左上から行ごとに並べた16ピクセルのRGBA8</param>
+/// <param name="block">書き込み先</param>
+void EncodeBC7Block(std::span<const uint8_t, kBlockPixelNum * 4> pixels, std::span<uint8_t, 16> block);
+
+void DecodeBC1Block(std::span<const uint8_t, 8> block, std::span<uint8_t, kBlockPixelNum * 4> pixels);
+void DecodeBC3Block(std::span<const uint8_t, 16> block, std::span<uint8_t, kBlockPixelNum * 4> pixels);
+/// <summary>
+/// BC7のブロックを展開する(モード6以外は黒になる)
+/// </summary>
+void DecodeBC7Block(std::span<const uint8_t, 16> block, std::span<uint8_t, kBlockPixelNum * 4> pixels);
+
+/// <summary>
+/// RGBA8の画像を圧縮する(端の足りないブロックは端のピクセルで埋める)
+/// </summary>
+/// <param name="format">圧縮形式</param>
+/// <param name="pixels">RGBA8の画像</param>
+/// <param name="width">幅</param>
+/// <param name="height">高さ</param>
+/// <param name="rowPitch">画像の1行のバイト数</param>
+/// <param name="blocks">書き込み先(CalcCompressedSize()バイト)</param>
+/// <param name="threadNum">使うスレッド数(0ならハードウェアのスレッド数)</param>
+/// <returns>サイズが足りていて圧縮できたか</returns>
+bool CompressImage(BlockFormat format, std::span<const uint8_t> pixels, uint32_t width, uint32_t height, size_t rowPitch, std::span<uint8_t> blocks, uint32_t threadNum = 0);
+
+/// <summary>
+/// 圧縮した画像をRGBA8に展開する
+/// </summary>
+/// <param name="format">圧縮形式</param>
+/// <param name="blocks">圧縮した画像</param>
+/// <param name="width">幅</param>
+/// <param name="height">高さ</param>
+/// <param name="pixels">書き込み先</param>
+/// <param name="rowPitch">書き込み先の1行のバイト数</param>
+/// <returns>サイズが足りていて展開できたか</returns>
+bool DecompressImage(BlockFormat format, std::span<const uint8_t> blocks, uint32_t width, uint32_t height, std::span<uint8_t> pixels, size_t rowPitch);
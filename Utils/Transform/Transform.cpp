@@ -0,0 +1,72 @@
+#include "Transform.h"
+
+Transform::Transform() :
+	scale(Vector3::identity),
+	rotate(Quaternion::identity),
+	translate(),
+	eulerRad(),
+	isEulerValid(true),
+	worldMat(MakeMatrixIndentity()),
+	isDirty(true)
+{}
+
+void Transform::SetScale(const Vector3& scale_) {
+	if (scale != scale_) {
+		scale = scale_;
+		isDirty = true;
+	}
+}
+
+void Transform::SetRotate(const Quaternion& rotate_) {
+	isEulerValid = false;
+	if (rotate != rotate_) {
+		rotate = rotate_;
+		isDirty = true;
+	}
+}
+
+void Transform::SetRotate(const Vector3& rad) {
+	if (isEulerValid && eulerRad == rad) {
+		return;
+	}
+
+	eulerRad = rad;
+	isEulerValid = true;
+	rotate = Quaternion::HoriMakeRotateEuler(rad);
+	isDirty = true;
+}
+
+void Transform::SetTranslate(const Vector3& translate_) {
+	if (translate != translate_) {
+		translate = translate_;
+		isDirty = true;
+	}
+}
+
+const Mat4x4& Transform::GetHoriMatrix() {
+	if (isDirty) {
+		UpdateMatrix();
+	}
+
+	return worldMat;
+}
+
+Mat4x4 Transform::GetVertMatrix() {
+	return MakeMatrixTransepose(GetHoriMatrix());
+}
+
+void Transform::UpdateMatrix() {
+	// 回転行列の各行を拡縮して、最後の行に平行移動を入れる
+	Mat4x4 rotateMat = rotate.GetHoriMatrix();
+
+	worldMat = Mat4x4{
+		std::array<Vector4, 4>{
+			rotateMat[0] * scale.x,
+			rotateMat[1] * scale.y,
+			rotateMat[2] * scale.z,
+			Vector4{ translate, 1.0f }
+		}
+	};
+
+	isDirty = false;
+}
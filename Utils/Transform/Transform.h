@@ -0,0 +1,72 @@
+#pragma once
+#include "Utils/Math/Vector3.h"
+#include "Utils/Math/Quaternion.h"
+#include "Utils/Math/Mat4x4.h"
+
+/// <summary>
+/// 拡縮、回転、平行移動をまとめて持ち、ワールド行列をキャッシュする
+/// 値が変わった時だけ行列を作り直す
+/// </summary>
+class Transform final {
+public:
+	Transform();
+	Transform(const Transform&) = default;
+	Transform(Transform&&) noexcept = default;
+	~Transform() = default;
+
+	Transform& operator=(const Transform&) = default;
+	Transform& operator=(Transform&&) noexcept = default;
+
+public:
+	void SetScale(const Vector3& scale_);
+	void SetRotate(const Quaternion& rotate_);
+	/// <summary>
+	/// オイラー角で回転を設定(HoriMakeMatrixAffinと同じ回転になる)
+	/// </summary>
+	/// <param name="rad">回転量(ラジアン)</param>
+	void SetRotate(const Vector3& rad);
+	void SetTranslate(const Vector3& translate_);
+
+	const Vector3& GetScale() const {
+		return scale;
+	}
+	const Quaternion& GetRotate() const {
+		return rotate;
+	}
+	const Vector3& GetTranslate() const {
+		return translate;
+	}
+
+	/// <summary>
+	/// ワールド行列(横ベクトル用。HoriMakeMatrixAffinと同じ並び)
+	/// </summary>
+	const Mat4x4& GetHoriMatrix();
+	/// <summary>
+	/// ワールド行列(縦ベクトル用。GetHoriMatrix()の転置)
+	/// </summary>
+	Mat4x4 GetVertMatrix();
+
+	/// <summary>
+	/// 前回行列を取得してから値が変わったか
+	/// </summary>
+	bool IsDirty() const {
+		return isDirty;
+	}
+
+private:
+	void UpdateMatrix();
+
+private:
+	Vector3 scale;
+	Quaternion rotate;
+	Vector3 translate;
+
+	/// <summary>
+	/// SetRotate(const Vector3&)で最後に受け取ったオイラー角(同じ値なら三角関数を計算しない)
+	/// </summary>
+	Vector3 eulerRad;
+	bool isEulerValid;
+
+	Mat4x4 worldMat;
+	bool isDirty;
+};